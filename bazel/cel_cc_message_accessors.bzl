@@ -0,0 +1,88 @@
+# Copyright 2025 Google LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Provides the `cel_cc_message_accessors` build rule.
+"""
+
+load("@rules_cc//cc:cc_library.bzl", "cc_library")
+load("//bazel:cel_proto_transitive_descriptor_set.bzl", "cel_proto_transitive_descriptor_set")
+
+def cel_cc_message_accessors(
+        name,
+        proto_deps,
+        cc_proto_deps,
+        messages,
+        function,
+        namespace = "",
+        testonly = False,
+        visibility = None):
+    """Generates field accessors for protocol buffer messages.
+
+    Creates a `cc_library` named `name` with a header `<name>.h`, declaring
+    `void <namespace>::<function>(cel::TypeRegistry& registry)`. It registers
+    accessors for the singular fields of `messages` which read them through
+    the generated C++ classes instead of through reflection.
+
+    Args:
+      name: name of the `cc_library`.
+      proto_deps: `proto_library` targets which define `messages`.
+      cc_proto_deps: `cc_proto_library` targets corresponding to `proto_deps`.
+      messages: fully qualified names of the messages.
+      function: name of the registration function.
+      namespace: C++ namespace of the registration function.
+      testonly: standard attribute.
+      visibility: standard attribute.
+    """
+    cel_proto_transitive_descriptor_set(
+        name = name + "_descriptor_set",
+        deps = proto_deps,
+        testonly = testonly,
+    )
+    native.genrule(
+        name = name + "_gen",
+        srcs = [":" + name + "_descriptor_set"],
+        outs = [name + ".h", name + ".cc"],
+        cmd = " ".join([
+            "$(location //bazel:cel_cc_message_accessors)",
+            "--descriptor_set=$(location :{}_descriptor_set)".format(name),
+            "--messages=" + ",".join(messages),
+            "--function=" + function,
+            "--namespace=" + namespace,
+            "--header=" + _paths_join(native.package_name(), name + ".h"),
+            "--out_h=$(location {}.h)".format(name),
+            "--out_cc=$(location {}.cc)".format(name),
+        ]),
+        tools = ["//bazel:cel_cc_message_accessors"],
+        testonly = testonly,
+    )
+    cc_library(
+        name = name,
+        srcs = [name + ".cc"],
+        hdrs = [name + ".h"],
+        testonly = testonly,
+        visibility = visibility,
+        deps = cc_proto_deps + [
+            "//common:value",
+            "//runtime:generated_message_accessors",
+            "//runtime:type_registry",
+            "@com_google_absl//absl/base",
+            "@com_google_protobuf//:protobuf",
+        ],
+    )
+
+def _paths_join(package, file):
+    if not package:
+        return file
+    return package + "/" + file
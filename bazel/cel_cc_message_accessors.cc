@@ -0,0 +1,357 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Generates C++ field accessors for protocol buffer messages, which are
+// registered with `cel::TypeRegistry` so that field selection does not go
+// through reflection. See cel_cc_message_accessors.bzl.
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "google/protobuf/descriptor.pb.h"
+#include "absl/container/btree_set.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/log/absl_check.h"
+#include "absl/log/initialize.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/str_replace.h"
+#include "absl/strings/string_view.h"
+#include "absl/strings/strip.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/descriptor_database.h"
+
+ABSL_FLAG(std::string, descriptor_set, "",
+          "Serialized google.protobuf.FileDescriptorSet containing the "
+          "messages and their dependencies.");
+ABSL_FLAG(std::vector<std::string>, messages, {},
+          "Fully qualified names of the messages to generate accessors for.");
+ABSL_FLAG(std::string, function, "",
+          "Name of the generated registration function.");
+ABSL_FLAG(std::string, namespace, "",
+          "C++ namespace of the generated registration function.");
+ABSL_FLAG(std::string, header, "",
+          "Include path of the generated header, used by the generated "
+          "source.");
+ABSL_FLAG(std::string, out_h, "", "");
+ABSL_FLAG(std::string, out_cc, "", "");
+
+namespace {
+
+using ::google::protobuf::Descriptor;
+using ::google::protobuf::FieldDescriptor;
+
+std::string ReadFile(const std::string& path) {
+  ABSL_CHECK(!path.empty()) << "--descriptor_set is required";
+  std::ifstream file(path, std::ifstream::binary);
+  ABSL_CHECK(file.is_open()) << path;
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+  ABSL_CHECK(file.good() || file.eof()) << path;
+  return std::move(buffer).str();
+}
+
+void WriteFile(const std::string& path, absl::string_view data) {
+  ABSL_CHECK(!path.empty()) << "--out_h and --out_cc are required";
+  std::ofstream file(path);
+  ABSL_CHECK(file.is_open()) << path;
+  file.write(data.data(), data.size());
+  ABSL_CHECK(file.good());
+  file.flush();
+  ABSL_CHECK(file.good());
+}
+
+// Returns the fully qualified C++ name of a generated message or enum, given
+// its fully qualified protocol buffer name and package.
+std::string ClassName(absl::string_view full_name, absl::string_view package) {
+  absl::string_view name = full_name;
+  if (!package.empty()) {
+    ABSL_CHECK(absl::ConsumePrefix(&name, package) &&
+               absl::ConsumePrefix(&name, "."))
+        << full_name;
+  }
+  return absl::StrCat("::", absl::StrReplaceAll(package, {{".", "::"}}),
+                      package.empty() ? "" : "::",
+                      absl::StrReplaceAll(name, {{".", "_"}}));
+}
+
+// Returns the name protoc gives the accessors of `field`.
+std::string AccessorName(const FieldDescriptor* field) {
+  // The C++ keywords protoc appends an underscore to, from its
+  // `cpp::Keywords()`.
+  static const auto* const kKeywords = new absl::flat_hash_set<std::string>{
+      "alignas",      "alignof",   "and",           "and_eq",
+      "asm",          "assert",    "auto",          "bitand",
+      "bitor",        "bool",      "break",         "case",
+      "catch",        "char",      "char8_t",       "char16_t",
+      "char32_t",     "class",     "co_await",      "co_return",
+      "co_yield",     "compl",     "concept",       "const",
+      "const_cast",   "consteval", "constexpr",     "constinit",
+      "continue",     "decltype",  "default",       "delete",
+      "do",           "double",    "dynamic_cast",  "else",
+      "enum",         "explicit",  "export",        "extern",
+      "false",        "float",     "for",           "friend",
+      "goto",         "if",        "inline",        "int",
+      "long",         "mutable",   "namespace",     "new",
+      "noexcept",     "not",       "not_eq",        "nullptr",
+      "operator",     "or",        "or_eq",         "private",
+      "protected",    "public",    "register",      "reinterpret_cast",
+      "requires",     "return",    "short",         "signed",
+      "sizeof",       "static",    "static_assert", "static_cast",
+      "struct",       "switch",    "template",      "this",
+      "thread_local", "throw",     "true",          "try",
+      "typedef",      "typeid",    "typename",      "union",
+      "unsigned",     "using",     "virtual",       "void",
+      "volatile",     "wchar_t",   "while",         "xor",
+      "xor_eq",
+  };
+  std::string name = absl::AsciiStrToLower(field->name());
+  if (kKeywords->contains(name)) {
+    name.push_back('_');
+  }
+  return name;
+}
+
+// Returns the expression converting the field value `value` of `field` to a
+// `cel::Value`, or an empty string if `field` is left to reflection.
+std::string GetExpression(const FieldDescriptor* field,
+                          absl::string_view value) {
+  switch (field->type()) {
+    case FieldDescriptor::TYPE_DOUBLE:
+    case FieldDescriptor::TYPE_FLOAT:
+      return absl::StrCat("::cel::DoubleValue(", value, ")");
+    case FieldDescriptor::TYPE_INT32:
+    case FieldDescriptor::TYPE_INT64:
+    case FieldDescriptor::TYPE_SINT32:
+    case FieldDescriptor::TYPE_SINT64:
+    case FieldDescriptor::TYPE_SFIXED32:
+    case FieldDescriptor::TYPE_SFIXED64:
+      return absl::StrCat("::cel::IntValue(", value, ")");
+    case FieldDescriptor::TYPE_UINT32:
+    case FieldDescriptor::TYPE_UINT64:
+    case FieldDescriptor::TYPE_FIXED32:
+    case FieldDescriptor::TYPE_FIXED64:
+      return absl::StrCat("::cel::UintValue(", value, ")");
+    case FieldDescriptor::TYPE_BOOL:
+      return absl::StrCat("::cel::BoolValue(", value, ")");
+    case FieldDescriptor::TYPE_STRING:
+      // Fields with a `ctype` of CORD or STRING_PIECE have accessors which do
+      // not return `const std::string&`, which is left to reflection.
+      if (field->cpp_string_type() != FieldDescriptor::CppStringType::kString) {
+        return "";
+      }
+      return absl::StrCat(
+          "::cel::StringValue(::cel::Borrower::Arena(::cel::GeneratedFieldArena("
+          "message, arena)), ",
+          value, ")");
+    case FieldDescriptor::TYPE_BYTES:
+      if (field->cpp_string_type() != FieldDescriptor::CppStringType::kString) {
+        return "";
+      }
+      return absl::StrCat(
+          "::cel::BytesValue(::cel::Borrower::Arena(::cel::GeneratedFieldArena("
+          "message, arena)), ",
+          value, ")");
+    case FieldDescriptor::TYPE_ENUM:
+      return absl::StrCat(
+          "::cel::Value::Enum(::google::protobuf::GetEnumDescriptor<",
+          ClassName(field->enum_type()->full_name(),
+                    field->enum_type()->file()->package()),
+          ">(), ", value, ")");
+    case FieldDescriptor::TYPE_MESSAGE:
+      // Well known types are unwrapped or unpacked into other kinds of
+      // values, which is left to reflection.
+      if (field->message_type()->well_known_type() !=
+          Descriptor::WELLKNOWNTYPE_UNSPECIFIED) {
+        return "";
+      }
+      return absl::StrCat("::cel::ParsedMessageValue(&", value,
+                          ", ::cel::GeneratedFieldArena(message, arena))");
+    default:
+      return "";
+  }
+}
+
+// Returns the expression testing whether `field` is set in `typed`, as `has()`
+// in CEL would.
+std::string HasExpression(const FieldDescriptor* field) {
+  std::string accessor = AccessorName(field);
+  if (field->has_presence()) {
+    return absl::StrCat("typed.has_", accessor, "()");
+  }
+  switch (field->type()) {
+    case FieldDescriptor::TYPE_DOUBLE:
+      return absl::StrCat("::absl::bit_cast<uint64_t>(typed.", accessor,
+                          "()) != 0");
+    case FieldDescriptor::TYPE_FLOAT:
+      return absl::StrCat("::absl::bit_cast<uint32_t>(typed.", accessor,
+                          "()) != 0");
+    case FieldDescriptor::TYPE_STRING:
+    case FieldDescriptor::TYPE_BYTES:
+      return absl::StrCat("!typed.", accessor, "().empty()");
+    case FieldDescriptor::TYPE_BOOL:
+      return absl::StrCat("typed.", accessor, "()");
+    default:
+      return absl::StrCat("typed.", accessor, "() != 0");
+  }
+}
+
+void GenerateMessage(const Descriptor* descriptor, std::string& out_cc,
+                     std::vector<std::string>& registrations) {
+  const std::string class_name =
+      ClassName(descriptor->full_name(), descriptor->file()->package());
+  const std::string symbol =
+      absl::StrReplaceAll(descriptor->full_name(), {{".", "_"}});
+
+  absl::StrAppend(&out_cc, "bool IsInstance_", symbol,
+                  "(const ::google::protobuf::Message& message) {\n",
+                  "  return ::google::protobuf::DynamicCastMessage<", class_name,
+                  ">(&message) != nullptr;\n}\n\n");
+
+  // Fields are emitted in order of their numbers, which the registry relies
+  // on to find them.
+  absl::btree_set<std::pair<int, const FieldDescriptor*>> fields;
+  for (int i = 0; i < descriptor->field_count(); ++i) {
+    fields.insert({descriptor->field(i)->number(), descriptor->field(i)});
+  }
+  std::vector<std::string> entries;
+  for (const auto& [number, field] : fields) {
+    if (field->is_repeated()) {
+      continue;
+    }
+    std::string get = GetExpression(
+        field, absl::StrCat("typed.", AccessorName(field), "()"));
+    if (get.empty()) {
+      continue;
+    }
+    const std::string field_symbol = absl::StrCat(symbol, "_", field->name());
+    absl::StrAppend(
+        &out_cc, "::cel::Value Get_", field_symbol,
+        "(\n    const ::google::protobuf::Message& message,\n"
+        "    const ::google::protobuf::DescriptorPool* descriptor_pool,\n"
+        "    ::google::protobuf::MessageFactory* message_factory,\n"
+        "    ::google::protobuf::Arena* arena) {\n"
+        "  const auto& typed = ::google::protobuf::DownCastMessage<",
+        class_name, ">(message);\n  return ", get, ";\n}\n\n");
+    absl::StrAppend(&out_cc, "bool Has_", field_symbol,
+                    "(const ::google::protobuf::Message& message) {\n"
+                    "  const auto& typed = ::google::protobuf::DownCastMessage<",
+                    class_name, ">(message);\n  return ",
+                    HasExpression(field), ";\n}\n\n");
+    entries.push_back(absl::StrCat("    {", number, ", &IsInstance_", symbol,
+                                   ", &Get_", field_symbol, ", &Has_",
+                                   field_symbol, "},\n"));
+  }
+  if (entries.empty()) {
+    return;
+  }
+  absl::StrAppend(&out_cc, "constexpr ::cel::GeneratedFieldAccessor kFields_",
+                  symbol, "[] = {\n", absl::StrJoin(entries, ""), "};\n\n");
+  registrations.push_back(
+      absl::StrCat("  registry.RegisterGeneratedMessageAccessors(\"",
+                   descriptor->full_name(), "\", kFields_", symbol, ");\n"));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  {
+    auto args = absl::ParseCommandLine(argc, argv);
+    ABSL_CHECK(args.empty() || args.size() == 1)
+        << "unexpected positional args: " << absl::StrJoin(args, ", ");
+  }
+  absl::InitializeLog();
+
+  google::protobuf::FileDescriptorSet file_descriptor_set;
+  ABSL_CHECK(file_descriptor_set.ParseFromString(
+      ReadFile(absl::GetFlag(FLAGS_descriptor_set))));
+  // Transitive descriptor sets are concatenated, so files may be repeated.
+  google::protobuf::SimpleDescriptorDatabase database;
+  absl::flat_hash_set<std::string> file_names;
+  for (const auto& file : file_descriptor_set.file()) {
+    if (file_names.insert(file.name()).second) {
+      ABSL_CHECK(database.Add(file)) << file.name();
+    }
+  }
+  google::protobuf::DescriptorPool pool(&database);
+
+  const std::string function = absl::GetFlag(FLAGS_function);
+  ABSL_CHECK(!function.empty()) << "--function is required";
+  const std::string ns = absl::GetFlag(FLAGS_namespace);
+
+  absl::btree_set<std::string> includes;
+  std::string out_cc;
+  std::vector<std::string> registrations;
+  for (const auto& message : absl::GetFlag(FLAGS_messages)) {
+    const Descriptor* descriptor = pool.FindMessageTypeByName(message);
+    ABSL_CHECK(descriptor != nullptr) << "unknown message: " << message;
+    includes.insert(absl::StrCat(
+        absl::StripSuffix(descriptor->file()->name(), ".proto"), ".pb.h"));
+    GenerateMessage(descriptor, out_cc, registrations);
+  }
+
+  std::string guard = absl::AsciiStrToUpper(absl::StrReplaceAll(
+      absl::GetFlag(FLAGS_header), {{"/", "_"}, {".", "_"}, {"-", "_"}}));
+  std::string out_h = absl::StrCat(
+      "// Generated by cel_cc_message_accessors. DO NOT EDIT!\n\n#ifndef ",
+      guard, "_\n#define ", guard, "_\n\n#include \"runtime/type_registry.h\"\n\n");
+  if (!ns.empty()) {
+    absl::StrAppend(&out_h, "namespace ", ns, " {\n\n");
+  }
+  absl::StrAppend(&out_h,
+                  "// Registers field accessors generated for ",
+                  absl::StrJoin(absl::GetFlag(FLAGS_messages), ", "),
+                  ".\nvoid ", function, "(::cel::TypeRegistry& registry);\n\n");
+  if (!ns.empty()) {
+    absl::StrAppend(&out_h, "}  // namespace ", ns, "\n\n");
+  }
+  absl::StrAppend(&out_h, "#endif  // ", guard, "_\n");
+
+  std::string cc = absl::StrCat(
+      "// Generated by cel_cc_message_accessors. DO NOT EDIT!\n\n#include \"",
+      absl::GetFlag(FLAGS_header),
+      "\"\n\n#include <cstdint>\n\n"
+      "#include \"absl/base/casts.h\"\n"
+      "#include \"common/value.h\"\n"
+      "#include \"runtime/generated_message_accessors.h\"\n"
+      "#include \"runtime/type_registry.h\"\n");
+  for (const auto& include : includes) {
+    absl::StrAppend(&cc, "#include \"", include, "\"\n");
+  }
+  absl::StrAppend(&cc,
+                  "#include \"google/protobuf/arena.h\"\n"
+                  "#include \"google/protobuf/descriptor.h\"\n"
+                  "#include \"google/protobuf/message.h\"\n\n");
+  if (!ns.empty()) {
+    absl::StrAppend(&cc, "namespace ", ns, " {\n\n");
+  }
+  absl::StrAppend(&cc, "namespace {\n\n", out_cc, "}  // namespace\n\nvoid ",
+                  function, "(::cel::TypeRegistry& registry) {\n",
+                  absl::StrJoin(registrations, ""), "}\n");
+  if (!ns.empty()) {
+    absl::StrAppend(&cc, "\n}  // namespace ", ns, "\n");
+  }
+
+  WriteFile(absl::GetFlag(FLAGS_out_h), out_h);
+  WriteFile(absl::GetFlag(FLAGS_out_cc), cc);
+
+  return EXIT_SUCCESS;
+}
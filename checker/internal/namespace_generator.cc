@@ -15,16 +15,17 @@
 #include "checker/internal/namespace_generator.h"
 
 #include <algorithm>
+#include <cstddef>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "absl/container/inlined_vector.h"
 #include "absl/functional/function_ref.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
-#include "absl/strings/str_join.h"
 #include "absl/strings/str_split.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/span.h"
@@ -37,19 +38,28 @@ bool FieldSelectInterpretationCandidates(
     absl::string_view prefix,
     absl::Span<const std::string> partly_qualified_name,
     absl::FunctionRef<bool(absl::string_view, int)> callback) {
+  // Every candidate is a prefix of the fully joined name, so join it once and
+  // hand out truncated views instead of re-joining for each candidate.
+  std::string qualified_name(prefix);
+  absl::InlinedVector<size_t, 8> segment_ends;
+  segment_ends.reserve(partly_qualified_name.size());
+  for (int i = 0; i < partly_qualified_name.size(); ++i) {
+    if (i > 0 || !prefix.empty()) {
+      qualified_name.push_back('.');
+    }
+    qualified_name.append(partly_qualified_name[i]);
+    segment_ends.push_back(qualified_name.size());
+  }
+  size_t start = 0;
+  if (prefix.empty() && absl::StartsWith(qualified_name, ".")) {
+    start = 1;
+  }
+  absl::string_view name = qualified_name;
   for (int i = 0; i < partly_qualified_name.size(); ++i) {
-    std::string buf;
     int count = partly_qualified_name.size() - i;
     auto end_idx = count - 1;
-    auto ident = absl::StrJoin(partly_qualified_name.subspan(0, count), ".");
-    absl::string_view candidate = ident;
-    if (absl::StartsWith(candidate, ".")) {
-      candidate = candidate.substr(1);
-    }
-    if (!prefix.empty()) {
-      buf = absl::StrCat(prefix, ".", candidate);
-      candidate = buf;
-    }
+    absl::string_view candidate =
+        name.substr(start, segment_ends[end_idx] - start);
     if (!callback(candidate, end_idx)) {
       return false;
     }
@@ -89,15 +99,23 @@ absl::StatusOr<NamespaceGenerator> NamespaceGenerator::Create(
 
 void NamespaceGenerator::GenerateCandidates(
     absl::string_view unqualified_name,
-    absl::FunctionRef<bool(absl::string_view)> callback) {
+    absl::FunctionRef<bool(absl::string_view)> callback) const {
   if (absl::StartsWith(unqualified_name, ".")) {
     callback(unqualified_name.substr(1));
     return;
   }
-  for (const auto& prefix : candidates_) {
-    std::string candidate = absl::StrCat(prefix, ".", unqualified_name);
-    if (!callback(candidate)) {
-      return;
+  if (!candidates_.empty()) {
+    // Prefixes are ordered from longest to shortest, so one buffer sized for
+    // the first candidate is reused for all of them.
+    std::string candidate;
+    candidate.reserve(candidates_.front().size() + 1 + unqualified_name.size());
+    for (const auto& prefix : candidates_) {
+      candidate.assign(prefix);
+      candidate.push_back('.');
+      candidate.append(unqualified_name);
+      if (!callback(candidate)) {
+        return;
+      }
     }
   }
   callback(unqualified_name);
@@ -105,7 +123,7 @@ void NamespaceGenerator::GenerateCandidates(
 
 void NamespaceGenerator::GenerateCandidates(
     absl::Span<const std::string> partly_qualified_name,
-    absl::FunctionRef<bool(absl::string_view, int)> callback) {
+    absl::FunctionRef<bool(absl::string_view, int)> callback) const {
   // Special case for explicit root relative name. e.g. '.com.example.Foo'
   if (!partly_qualified_name.empty() &&
       absl::StartsWith(partly_qualified_name[0], ".")) {
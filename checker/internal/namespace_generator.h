@@ -52,7 +52,8 @@ class NamespaceGenerator {
   //
   // com.google.foo, com.foo, foo
   void GenerateCandidates(absl::string_view unqualified_name,
-                          absl::FunctionRef<bool(absl::string_view)> callback);
+                          absl::FunctionRef<bool(absl::string_view)> callback)
+      const;
 
   // For a partially qualified name, generate all the qualified candidates in
   // order of resolution precedence and pass them to the provided callback. The
@@ -74,7 +75,7 @@ class NamespaceGenerator {
   // (Foo).bar, <Foo, 0>
   void GenerateCandidates(
       absl::Span<const std::string> partly_qualified_name,
-      absl::FunctionRef<bool(absl::string_view, int)> callback);
+      absl::FunctionRef<bool(absl::string_view, int)> callback) const;
 
  private:
   explicit NamespaceGenerator(std::vector<std::string> candidates)
@@ -17,8 +17,11 @@
 #include <cstddef>
 #include <cstdint>
 #include <string>
+#include <utility>
 
+#include "absl/base/call_once.h"
 #include "absl/base/nullability.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
@@ -33,8 +36,83 @@
 
 namespace cel::checker_internal {
 
+absl::StatusOr<const FunctionDecl* absl_nonnull>
+TypeCheckEnv::LazyFunction::Get() const {
+  const absl::StatusOr<FunctionDecl>& function_decl = decl->Get();
+  CEL_RETURN_IF_ERROR(function_decl.status());
+  if (validator != nullptr) {
+    absl::call_once(validate_once, [this, &function_decl]() {
+      validation_status = validator(*function_decl);
+    });
+    CEL_RETURN_IF_ERROR(validation_status);
+  }
+  return &*function_decl;
+}
+
+TypeCheckEnv::TypeCheckEnv(TypeCheckEnv&& other)
+    : descriptor_pool_(std::move(other.descriptor_pool_)),
+      arena_(std::move(other.arena_)),
+      container_(std::move(other.container_)),
+      parent_(other.parent_),
+      variables_(std::move(other.variables_)),
+      functions_(std::move(other.functions_)),
+      lazy_functions_(std::move(other.lazy_functions_)),
+      lazy_function_storage_(std::move(other.lazy_function_storage_)),
+      type_providers_(std::move(other.type_providers_)),
+      expected_type_(std::move(other.expected_type_)) {
+  if (other.frozen_) {
+    other.Thaw();
+    Freeze();
+  }
+}
+
+TypeCheckEnv& TypeCheckEnv::operator=(TypeCheckEnv&& other) {
+  if (this == &other) {
+    return *this;
+  }
+  Thaw();
+  descriptor_pool_ = std::move(other.descriptor_pool_);
+  arena_ = std::move(other.arena_);
+  container_ = std::move(other.container_);
+  parent_ = other.parent_;
+  variables_ = std::move(other.variables_);
+  functions_ = std::move(other.functions_);
+  lazy_functions_ = std::move(other.lazy_functions_);
+  lazy_function_storage_ = std::move(other.lazy_function_storage_);
+  type_providers_ = std::move(other.type_providers_);
+  expected_type_ = std::move(other.expected_type_);
+  if (other.frozen_) {
+    other.Thaw();
+    Freeze();
+  }
+  return *this;
+}
+
+void TypeCheckEnv::Freeze() {
+  Thaw();
+  // Walk from the innermost scope outwards so that the first declaration seen
+  // for a name is the one that shadows the rest.
+  for (const TypeCheckEnv* scope = this; scope != nullptr;
+       scope = scope->parent_) {
+    for (const auto& [name, decl] : scope->variables_) {
+      frozen_variables_.insert({name, &decl});
+    }
+    for (const auto& [name, decl] : scope->functions_) {
+      frozen_functions_.insert({name, {&decl, nullptr}});
+    }
+    for (const auto& [name, lazy_decl] : scope->lazy_functions_) {
+      frozen_functions_.insert({name, {nullptr, lazy_decl}});
+    }
+  }
+  frozen_ = true;
+}
+
 const VariableDecl* absl_nullable TypeCheckEnv::LookupVariable(
     absl::string_view name) const {
+  if (frozen_) {
+    auto it = frozen_variables_.find(name);
+    return it != frozen_variables_.end() ? it->second : nullptr;
+  }
   const TypeCheckEnv* scope = this;
   while (scope != nullptr) {
     if (auto it = scope->variables_.find(name); it != scope->variables_.end()) {
@@ -45,13 +123,27 @@ const VariableDecl* absl_nullable TypeCheckEnv::LookupVariable(
   return nullptr;
 }
 
-const FunctionDecl* absl_nullable TypeCheckEnv::LookupFunction(
+absl::StatusOr<const FunctionDecl* absl_nullable> TypeCheckEnv::LookupFunction(
     absl::string_view name) const {
+  if (frozen_) {
+    auto it = frozen_functions_.find(name);
+    if (it == frozen_functions_.end()) {
+      return nullptr;
+    }
+    if (it->second.decl != nullptr) {
+      return it->second.decl;
+    }
+    return it->second.lazy_decl->Get();
+  }
   const TypeCheckEnv* scope = this;
   while (scope != nullptr) {
     if (auto it = scope->functions_.find(name); it != scope->functions_.end()) {
       return &it->second;
     }
+    if (auto it = scope->lazy_functions_.find(name);
+        it != scope->lazy_functions_.end()) {
+      return it->second->Get();
+    }
     scope = scope->parent_;
   }
   return nullptr;
@@ -15,15 +15,19 @@
 #ifndef THIRD_PARTY_CEL_CPP_CHECKER_INTERNAL_TYPE_CHECK_ENV_H_
 #define THIRD_PARTY_CEL_CPP_CHECKER_INTERNAL_TYPE_CHECK_ENV_H_
 
+#include <deque>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "absl/base/attributes.h"
+#include "absl/base/call_once.h"
 #include "absl/base/nullability.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/functional/any_invocable.h"
 #include "absl/memory/memory.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
@@ -82,7 +86,9 @@ class VariableScope {
 // Maintains lookup maps for variables and functions and the set of type
 // providers.
 //
-// This class is thread-compatible.
+// This class is thread-compatible. Once frozen (see `Freeze`), lookups do not
+// touch any mutable state so a single environment may be shared by any number
+// of concurrent type checks.
 class TypeCheckEnv {
  private:
   using VariableDeclPtr = const VariableDecl* absl_nonnull;
@@ -105,8 +111,11 @@ class TypeCheckEnv {
         parent_(nullptr) {}
 
   // Move-only.
-  TypeCheckEnv(TypeCheckEnv&&) = default;
-  TypeCheckEnv& operator=(TypeCheckEnv&&) = default;
+  //
+  // Moving a frozen environment rebuilds its lookup tables, since they point
+  // into the declaration maps.
+  TypeCheckEnv(TypeCheckEnv&& other);
+  TypeCheckEnv& operator=(TypeCheckEnv&& other);
 
   const std::string& container() const { return container_; }
 
@@ -140,15 +149,18 @@ class TypeCheckEnv {
   //
   // Returns true if the variable was inserted, false otherwise.
   bool InsertVariableIfAbsent(VariableDecl decl) {
+    Thaw();
     return variables_.insert({decl.name(), std::move(decl)}).second;
   }
 
   // Inserts a variable declaration into the environment of the current scope.
   // Parent scopes are not searched.
   void InsertOrReplaceVariable(VariableDecl decl) {
+    Thaw();
     variables_[decl.name()] = std::move(decl);
   }
 
+  // Functions declared in this scope, excluding lazily declared ones.
   const absl::flat_hash_map<std::string, FunctionDecl>& functions() const {
     return functions_;
   }
@@ -159,23 +171,75 @@ class TypeCheckEnv {
   //
   // Returns true if the decl was inserted, false otherwise.
   bool InsertFunctionIfAbsent(FunctionDecl decl) {
+    Thaw();
+    if (lazy_functions_.contains(decl.name())) {
+      return false;
+    }
     return functions_.insert({decl.name(), std::move(decl)}).second;
   }
 
   void InsertOrReplaceFunction(FunctionDecl decl) {
+    Thaw();
+    lazy_functions_.erase(decl.name());
     functions_[decl.name()] = std::move(decl);
   }
 
+  // Checks a lazily built function declaration before its first use in this
+  // environment, e.g. against the options of the builder that declared it.
+  using FunctionDeclValidator =
+      absl::AnyInvocable<absl::Status(const FunctionDecl&) const>;
+
+  // Inserts a lazily built function declaration into the environment of the
+  // current scope if it is not already present. The declaration is only built,
+  // and checked by `validator` if set, when first looked up.
+  //
+  // `decl` must outlive the environment.
+  //
+  // Returns true if the decl was inserted, false otherwise.
+  bool InsertLazyFunctionIfAbsent(
+      const LazyFunctionDecl& decl ABSL_ATTRIBUTE_LIFETIME_BOUND,
+      FunctionDeclValidator validator = nullptr) {
+    Thaw();
+    if (functions_.contains(decl.name())) {
+      return false;
+    }
+    auto [it, inserted] = lazy_functions_.try_emplace(decl.name(), nullptr);
+    if (inserted) {
+      it->second =
+          &lazy_function_storage_.emplace_back(decl, std::move(validator));
+    }
+    return inserted;
+  }
+
   const TypeCheckEnv* absl_nullable parent() const { return parent_; }
-  void set_parent(TypeCheckEnv* parent) { parent_ = parent; }
+  void set_parent(TypeCheckEnv* parent) {
+    Thaw();
+    parent_ = parent;
+  }
+
+  // Precomputes a single lookup table for the variables and functions visible
+  // from this environment, with declarations in this scope shadowing those in
+  // parent scopes.
+  //
+  // Lookups on a frozen environment are one hash probe instead of a walk over
+  // the parent chain. Inserting a declaration or changing the parent discards
+  // the table. Parent environments must not be modified while a child is
+  // frozen.
+  void Freeze();
+
+  bool frozen() const { return frozen_; }
 
   // Returns the declaration for the given name if it is found in the current
   // or any parent scope.
   // Note: the returned declaration ptr is only valid as long as no changes are
   // made to the environment.
+  //
+  // Looking up a lazily declared function builds and validates it if needed,
+  // so this is not free of side effects, but it is still safe to call
+  // concurrently. Returns the error from building or validating it, if any.
   const VariableDecl* absl_nullable LookupVariable(
       absl::string_view name) const;
-  const FunctionDecl* absl_nullable LookupFunction(
+  absl::StatusOr<const FunctionDecl* absl_nullable> LookupFunction(
       absl::string_view name) const;
 
   absl::StatusOr<absl::optional<Type>> LookupTypeName(
@@ -204,9 +268,32 @@ class TypeCheckEnv {
         container_(parent != nullptr ? parent->container() : ""),
         parent_(parent) {}
 
+  // A lazily built function declaration and the result of validating it for
+  // this environment.
+  struct LazyFunction {
+    LazyFunction(const LazyFunctionDecl& decl, FunctionDeclValidator validator)
+        : decl(&decl), validator(std::move(validator)) {}
+
+    // Returns the built declaration, validating it on the first call.
+    absl::StatusOr<const FunctionDecl* absl_nonnull> Get() const;
+
+    const LazyFunctionDecl* absl_nonnull decl;
+    FunctionDeclValidator validator;
+    mutable absl::once_flag validate_once;
+    mutable absl::Status validation_status;
+  };
+
   absl::StatusOr<absl::optional<VariableDecl>> LookupEnumConstant(
       absl::string_view type, absl::string_view value) const;
 
+  void Thaw() {
+    if (frozen_) {
+      frozen_ = false;
+      frozen_variables_.clear();
+      frozen_functions_.clear();
+    }
+  }
+
   absl_nonnull std::shared_ptr<const google::protobuf::DescriptorPool> descriptor_pool_;
   // If set, an arena was needed to allocate types in the environment.
   absl_nullable std::shared_ptr<const google::protobuf::Arena> arena_;
@@ -216,11 +303,30 @@ class TypeCheckEnv {
   // Maps fully qualified names to declarations.
   absl::flat_hash_map<std::string, VariableDecl> variables_;
   absl::flat_hash_map<std::string, FunctionDecl> functions_;
+  // Lazily built function declarations, keyed by the names they own. A name is
+  // in at most one of `functions_` and `lazy_functions_`.
+  absl::flat_hash_map<absl::string_view, const LazyFunction* absl_nonnull>
+      lazy_functions_;
+  // Owns the entries of `lazy_functions_`. A deque never moves its elements,
+  // and allocates them in blocks rather than one at a time.
+  std::deque<LazyFunction> lazy_function_storage_;
 
   // Type providers for custom types.
   std::vector<std::shared_ptr<const TypeIntrospector>> type_providers_;
 
   absl::optional<Type> expected_type_;
+
+  // Flattened view of the declarations in this and all parent scopes, keyed by
+  // the names owned by the declaration maps. Only populated while frozen.
+  //
+  // Exactly one of the pointers in a FrozenFunction is set.
+  struct FrozenFunction {
+    const FunctionDecl* absl_nullable decl;
+    const LazyFunction* absl_nullable lazy_decl;
+  };
+  bool frozen_ = false;
+  absl::flat_hash_map<absl::string_view, const VariableDecl*> frozen_variables_;
+  absl::flat_hash_map<absl::string_view, FrozenFunction> frozen_functions_;
 };
 
 }  // namespace cel::checker_internal
@@ -0,0 +1,187 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "checker/internal/type_check_env.h"
+
+#include <string>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "common/decl.h"
+#include "common/type.h"
+#include "internal/testing.h"
+#include "internal/testing_descriptor_pool.h"
+
+namespace cel::checker_internal {
+namespace {
+
+using ::absl_testing::IsOkAndHolds;
+using ::absl_testing::StatusIs;
+using ::cel::internal::GetSharedTestingDescriptorPool;
+using ::testing::IsNull;
+using ::testing::NotNull;
+
+FunctionDecl MakeTestFunction(absl::string_view name, const Type& result) {
+  return MakeFunctionDecl(std::string(name),
+                          MakeOverloadDecl(absl::StrCat(name, "_overload"),
+                                           result, IntType()))
+      .value();
+}
+
+class TypeCheckEnvTest : public ::testing::TestWithParam<bool> {
+ protected:
+  void MaybeFreeze(TypeCheckEnv& env) {
+    if (GetParam()) {
+      env.Freeze();
+    }
+  }
+};
+
+TEST_P(TypeCheckEnvTest, LookupSearchesParents) {
+  TypeCheckEnv parent(GetSharedTestingDescriptorPool());
+  parent.InsertVariableIfAbsent(MakeVariableDecl("x", IntType()));
+  parent.InsertVariableIfAbsent(MakeVariableDecl("y", IntType()));
+  parent.InsertFunctionIfAbsent(MakeTestFunction("f", IntType()));
+
+  TypeCheckEnv env = parent.MakeExtendedEnvironment();
+  env.InsertVariableIfAbsent(MakeVariableDecl("y", StringType()));
+  env.InsertFunctionIfAbsent(MakeTestFunction("g", IntType()));
+  MaybeFreeze(env);
+
+  ASSERT_THAT(env.LookupVariable("x"), NotNull());
+  EXPECT_EQ(env.LookupVariable("x")->type(), IntType());
+  ASSERT_THAT(env.LookupVariable("y"), NotNull());
+  EXPECT_EQ(env.LookupVariable("y")->type(), StringType());
+  EXPECT_THAT(env.LookupVariable("z"), IsNull());
+
+  EXPECT_THAT(env.LookupFunction("f"), IsOkAndHolds(NotNull()));
+  EXPECT_THAT(env.LookupFunction("g"), IsOkAndHolds(NotNull()));
+  EXPECT_THAT(env.LookupFunction("h"), IsOkAndHolds(IsNull()));
+}
+
+TEST_P(TypeCheckEnvTest, InsertAfterFreeze) {
+  TypeCheckEnv env(GetSharedTestingDescriptorPool());
+  env.InsertVariableIfAbsent(MakeVariableDecl("x", IntType()));
+  MaybeFreeze(env);
+
+  env.InsertOrReplaceVariable(MakeVariableDecl("x", StringType()));
+  env.InsertFunctionIfAbsent(MakeTestFunction("f", IntType()));
+  EXPECT_FALSE(env.frozen());
+
+  ASSERT_THAT(env.LookupVariable("x"), NotNull());
+  EXPECT_EQ(env.LookupVariable("x")->type(), StringType());
+  EXPECT_THAT(env.LookupFunction("f"), IsOkAndHolds(NotNull()));
+}
+
+TEST_P(TypeCheckEnvTest, MoveKeepsLookups) {
+  TypeCheckEnv env(GetSharedTestingDescriptorPool());
+  for (int i = 0; i < 100; ++i) {
+    env.InsertVariableIfAbsent(
+        MakeVariableDecl(absl::StrCat("x", i), IntType()));
+  }
+  MaybeFreeze(env);
+
+  TypeCheckEnv moved(std::move(env));
+  EXPECT_EQ(moved.frozen(), GetParam());
+  ASSERT_THAT(moved.LookupVariable("x42"), NotNull());
+  EXPECT_EQ(moved.LookupVariable("x42")->name(), "x42");
+
+  TypeCheckEnv assigned(GetSharedTestingDescriptorPool());
+  assigned = std::move(moved);
+  EXPECT_EQ(assigned.frozen(), GetParam());
+  ASSERT_THAT(assigned.LookupVariable("x99"), NotNull());
+  EXPECT_EQ(assigned.LookupVariable("x99")->name(), "x99");
+}
+
+TEST_P(TypeCheckEnvTest, LazyFunctions) {
+  int builds = 0;
+  LazyFunctionDecl lazy_f("f", [&builds]() {
+    ++builds;
+    return MakeTestFunction("f", IntType());
+  });
+  LazyFunctionDecl lazy_g("g",
+                          []() { return MakeTestFunction("g", IntType()); });
+
+  TypeCheckEnv parent(GetSharedTestingDescriptorPool());
+  ASSERT_TRUE(parent.InsertLazyFunctionIfAbsent(lazy_f));
+  ASSERT_TRUE(parent.InsertLazyFunctionIfAbsent(lazy_g));
+  EXPECT_FALSE(parent.InsertLazyFunctionIfAbsent(lazy_f));
+  EXPECT_FALSE(parent.InsertFunctionIfAbsent(MakeTestFunction("f", IntType())));
+
+  TypeCheckEnv env = parent.MakeExtendedEnvironment();
+  env.InsertFunctionIfAbsent(MakeTestFunction("g", StringType()));
+  MaybeFreeze(env);
+  EXPECT_EQ(builds, 0);
+
+  ASSERT_OK_AND_ASSIGN(const FunctionDecl* f, env.LookupFunction("f"));
+  ASSERT_THAT(f, NotNull());
+  EXPECT_EQ(f, &*lazy_f.Get());
+  EXPECT_THAT(env.LookupFunction("f"), IsOkAndHolds(f));
+  EXPECT_EQ(builds, 1);
+
+  // The eager declaration in the child shadows the lazy one in the parent.
+  ASSERT_OK_AND_ASSIGN(const FunctionDecl* g, env.LookupFunction("g"));
+  ASSERT_THAT(g, NotNull());
+  EXPECT_EQ(g->overloads()[0].result(), StringType());
+
+  parent.InsertOrReplaceFunction(MakeTestFunction("f", StringType()));
+  ASSERT_OK_AND_ASSIGN(f, parent.LookupFunction("f"));
+  ASSERT_THAT(f, NotNull());
+  EXPECT_EQ(f->overloads()[0].result(), StringType());
+}
+
+TEST_P(TypeCheckEnvTest, LazyFunctionErrors) {
+  LazyFunctionDecl lazy_f("f", []() -> absl::StatusOr<FunctionDecl> {
+    return absl::InternalError("no overloads for you");
+  });
+  int validations = 0;
+  LazyFunctionDecl lazy_g("g",
+                          []() { return MakeTestFunction("g", IntType()); });
+
+  TypeCheckEnv env(GetSharedTestingDescriptorPool());
+  ASSERT_TRUE(env.InsertLazyFunctionIfAbsent(lazy_f));
+  ASSERT_TRUE(env.InsertLazyFunctionIfAbsent(
+      lazy_g, [&validations](const FunctionDecl& decl) {
+        ++validations;
+        return absl::InvalidArgumentError(
+            absl::StrCat("invalid declaration: ", decl.name()));
+      }));
+  MaybeFreeze(env);
+
+  EXPECT_THAT(env.LookupFunction("f"),
+              StatusIs(absl::StatusCode::kInternal, "no overloads for you"));
+  EXPECT_THAT(env.LookupFunction("g"),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       "invalid declaration: g"));
+  EXPECT_THAT(env.LookupFunction("g"),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_EQ(validations, 1);
+
+  // Validation is per environment; the shared declaration itself was built.
+  TypeCheckEnv other_env(GetSharedTestingDescriptorPool());
+  ASSERT_TRUE(other_env.InsertLazyFunctionIfAbsent(lazy_g));
+  EXPECT_THAT(other_env.LookupFunction("g"), IsOkAndHolds(NotNull()));
+}
+
+INSTANTIATE_TEST_SUITE_P(TypeCheckEnvTest, TypeCheckEnvTest, ::testing::Bool(),
+                         [](const ::testing::TestParamInfo<bool>& info) {
+                           return info.param ? "Frozen" : "Unfrozen";
+                         });
+
+}  // namespace
+}  // namespace cel::checker_internal
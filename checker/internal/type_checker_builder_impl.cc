@@ -244,6 +244,27 @@ absl::Status TypeCheckerBuilderImpl::ApplyConfig(
   }
 
   for (FunctionDeclRecord& fn : config.functions) {
+    if (fn.lazy_decl != nullptr) {
+      auto validator = [check_type_param_name =
+                            options_.enable_type_parameter_name_validation,
+                        depth_limit = options_.max_type_decl_nesting](
+                           const FunctionDecl& decl) {
+        return ValidateFunctionDecl(decl, check_type_param_name, depth_limit);
+      };
+      if (subset == nullptr) {
+        if (!env.InsertLazyFunctionIfAbsent(*fn.lazy_decl, validator)) {
+          return absl::AlreadyExistsError(absl::StrCat(
+              "function '", fn.lazy_decl->name(), "' declared multiple times"));
+        }
+        continue;
+      }
+      // Filtering needs the overloads, so subsets use a filtered copy.
+      const absl::StatusOr<FunctionDecl>& lazy_decl = fn.lazy_decl->Get();
+      CEL_RETURN_IF_ERROR(lazy_decl.status());
+      CEL_RETURN_IF_ERROR(validator(*lazy_decl));
+      fn.decl = *lazy_decl;
+    }
+
     FunctionDecl decl = std::move(fn.decl);
     if (subset != nullptr) {
       absl::optional<FunctionDecl> filtered =
@@ -264,7 +285,8 @@ absl::Status TypeCheckerBuilderImpl::ApplyConfig(
         break;
       }
       case AddSemantic::kTryMerge: {
-        const FunctionDecl* existing_decl = env.LookupFunction(decl.name());
+        CEL_ASSIGN_OR_RETURN(const FunctionDecl* existing_decl,
+                             env.LookupFunction(decl.name()));
         FunctionDecl to_add = std::move(decl);
         if (existing_decl != nullptr) {
           CEL_ASSIGN_OR_RETURN(
@@ -423,6 +445,13 @@ absl::Status TypeCheckerBuilderImpl::AddFunction(const FunctionDecl& decl) {
   return absl::OkStatus();
 }
 
+absl::Status TypeCheckerBuilderImpl::AddLazyFunction(
+    const LazyFunctionDecl& decl) {
+  target_config_->functions.push_back(
+      {FunctionDecl(), AddSemantic::kInsertIfAbsent, &decl});
+  return absl::OkStatus();
+}
+
 absl::Status TypeCheckerBuilderImpl::MergeFunction(const FunctionDecl& decl) {
   CEL_RETURN_IF_ERROR(
       ValidateFunctionDecl(decl, options_.enable_type_parameter_name_validation,
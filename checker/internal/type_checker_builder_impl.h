@@ -68,6 +68,7 @@ class TypeCheckerBuilderImpl : public TypeCheckerBuilder {
   absl::Status AddContextDeclaration(absl::string_view type) override;
 
   absl::Status AddFunction(const FunctionDecl& decl) override;
+  absl::Status AddLazyFunction(const LazyFunctionDecl& decl) override;
   absl::Status MergeFunction(const FunctionDecl& decl) override;
 
   void SetExpectedType(const Type& type) override;
@@ -107,6 +108,8 @@ class TypeCheckerBuilderImpl : public TypeCheckerBuilder {
   struct FunctionDeclRecord {
     FunctionDecl decl;
     AddSemantic add_semantic;
+    // If set, `decl` is empty and the declaration is built on first use.
+    const LazyFunctionDecl* absl_nullable lazy_decl = nullptr;
   };
 
   // A record of configuration calls.
@@ -40,6 +40,7 @@ namespace {
 
 using ::absl_testing::IsOk;
 using ::absl_testing::StatusIs;
+using ::testing::HasSubstr;
 
 
 struct ContextDeclsTestCase {
@@ -315,5 +316,92 @@ TEST(TypeCheckerBuilderImplTest, ReplaceVariable) {
   EXPECT_EQ(checked_ast.GetReturnType(), TypeSpec(PrimitiveType::kString));
 }
 
+TEST(TypeCheckerBuilderImplTest, LazyFunction) {
+  int builds = 0;
+  LazyFunctionDecl lazy_decl("f", [&builds]() {
+    ++builds;
+    return MakeFunctionDecl(
+        "f", MakeOverloadDecl("f_int", StringType(), IntType()));
+  });
+  TypeCheckerBuilderImpl builder(internal::GetSharedTestingDescriptorPool(),
+                                 {});
+  ASSERT_THAT(builder.AddLazyFunction(lazy_decl), IsOk());
+
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<TypeChecker> type_checker,
+                       builder.Build());
+  EXPECT_EQ(builds, 0);
+  ASSERT_OK_AND_ASSIGN(auto ast, MakeTestParsedAst("f(1)"));
+  ASSERT_OK_AND_ASSIGN(ValidationResult result,
+                       type_checker->Check(std::move(ast)));
+
+  ASSERT_TRUE(result.IsValid());
+  EXPECT_EQ(result.GetAst()->GetReturnType(),
+            TypeSpec(PrimitiveType::kString));
+  EXPECT_EQ(builds, 1);
+}
+
+TEST(TypeCheckerBuilderImplTest, LazyFunctionValidatedOnFirstUse) {
+  google::protobuf::Arena arena;
+  LazyFunctionDecl lazy_decl("f", [&arena]() {
+    return MakeFunctionDecl(
+        "f", MakeOverloadDecl("f_int",
+                              ListType(&arena, ListType(&arena, IntType())),
+                              IntType()));
+  });
+  CheckerOptions options;
+  options.max_type_decl_nesting = 2;
+  TypeCheckerBuilderImpl builder(internal::GetSharedTestingDescriptorPool(),
+                                 options);
+  ASSERT_THAT(builder.AddLazyFunction(lazy_decl), IsOk());
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<TypeChecker> type_checker,
+                       builder.Build());
+
+  ASSERT_OK_AND_ASSIGN(auto ast, MakeTestParsedAst("f(1)"));
+  EXPECT_THAT(type_checker->Check(std::move(ast)),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("type nesting limit of 2 exceeded")));
+
+  // The same declaration is valid under the default options.
+  TypeCheckerBuilderImpl default_builder(
+      internal::GetSharedTestingDescriptorPool(), {});
+  ASSERT_THAT(default_builder.AddLazyFunction(lazy_decl), IsOk());
+  ASSERT_OK_AND_ASSIGN(type_checker, default_builder.Build());
+  ASSERT_OK_AND_ASSIGN(ast, MakeTestParsedAst("f(1)"));
+  ASSERT_OK_AND_ASSIGN(ValidationResult result,
+                       type_checker->Check(std::move(ast)));
+  EXPECT_TRUE(result.IsValid());
+}
+
+TEST(TypeCheckerBuilderImplTest, LazyFunctionFactoryErrorReturnedByCheck) {
+  LazyFunctionDecl lazy_decl("f", []() -> absl::StatusOr<FunctionDecl> {
+    return absl::InternalError("no overloads for you");
+  });
+  TypeCheckerBuilderImpl builder(internal::GetSharedTestingDescriptorPool(),
+                                 {});
+  ASSERT_THAT(builder.AddLazyFunction(lazy_decl), IsOk());
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<TypeChecker> type_checker,
+                       builder.Build());
+
+  ASSERT_OK_AND_ASSIGN(auto ast, MakeTestParsedAst("f(1)"));
+  EXPECT_THAT(type_checker->Check(std::move(ast)),
+              StatusIs(absl::StatusCode::kInternal, "no overloads for you"));
+}
+
+TEST(TypeCheckerBuilderImplTest, ErrorOnLazyFunctionDeclaredTwice) {
+  LazyFunctionDecl lazy_decl("f", []() {
+    return MakeFunctionDecl(
+        "f", MakeOverloadDecl("f_int", StringType(), IntType()));
+  });
+  TypeCheckerBuilderImpl builder(internal::GetSharedTestingDescriptorPool(),
+                                 {});
+  ASSERT_THAT(builder.AddLazyFunction(lazy_decl), IsOk());
+  ASSERT_OK_AND_ASSIGN(
+      FunctionDecl fn_decl,
+      MakeFunctionDecl("f", MakeOverloadDecl("f_int", IntType(), IntType())));
+  ASSERT_THAT(builder.AddFunction(fn_decl), IsOk());
+
+  EXPECT_THAT(builder.Build(), StatusIs(absl::StatusCode::kAlreadyExists));
+}
+
 }  // namespace
 }  // namespace cel::checker_internal
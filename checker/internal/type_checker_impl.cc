@@ -235,13 +235,13 @@ class ResolveVisitor : public AstVisitorBase {
   };
 
   ResolveVisitor(absl::string_view container,
-                 NamespaceGenerator namespace_generator,
+                 const NamespaceGenerator& namespace_generator,
                  const TypeCheckEnv& env, const Ast& ast,
                  TypeInferenceContext& inference_context,
                  std::vector<TypeCheckIssue>& issues,
                  google::protobuf::Arena* absl_nonnull arena)
       : container_(container),
-        namespace_generator_(std::move(namespace_generator)),
+        namespace_generator_(&namespace_generator),
         env_(&env),
         inference_context_(&inference_context),
         issues_(&issues),
@@ -452,7 +452,7 @@ class ResolveVisitor : public AstVisitorBase {
   }
 
   absl::string_view container_;
-  NamespaceGenerator namespace_generator_;
+  const NamespaceGenerator* absl_nonnull namespace_generator_;
   const TypeCheckEnv* absl_nonnull env_;
   TypeInferenceContext* absl_nonnull inference_context_;
   std::vector<TypeCheckIssue>* absl_nonnull issues_;
@@ -689,7 +689,7 @@ void ResolveVisitor::PostVisitStruct(const Expr& expr,
   absl::Status status;
   std::string resolved_name;
   Type resolved_type;
-  namespace_generator_.GenerateCandidates(
+  namespace_generator_->GenerateCandidates(
       create_struct.name(), [&](const absl::string_view name) {
         auto type = env_->LookupTypeName(name);
         if (!type.ok()) {
@@ -903,9 +903,16 @@ const FunctionDecl* ResolveVisitor::ResolveFunctionCallShape(
     const Expr& expr, absl::string_view function_name, int arg_count,
     bool is_receiver) {
   const FunctionDecl* decl = nullptr;
-  namespace_generator_.GenerateCandidates(
+  namespace_generator_->GenerateCandidates(
       function_name, [&, this](absl::string_view candidate) -> bool {
-        decl = env_->LookupFunction(candidate);
+        absl::StatusOr<const FunctionDecl*> candidate_decl =
+            env_->LookupFunction(candidate);
+        if (!candidate_decl.ok()) {
+          status_.Update(candidate_decl.status());
+          decl = nullptr;
+          return false;
+        }
+        decl = *candidate_decl;
         if (decl == nullptr) {
           return true;
         }
@@ -997,7 +1004,7 @@ const VariableDecl* absl_nullable ResolveVisitor::LookupIdentifier(
 void ResolveVisitor::ResolveSimpleIdentifier(const Expr& expr,
                                              absl::string_view name) {
   const VariableDecl* decl = nullptr;
-  namespace_generator_.GenerateCandidates(
+  namespace_generator_->GenerateCandidates(
       name, [&decl, this](absl::string_view candidate) {
         decl = LookupIdentifier(candidate);
         // continue searching.
@@ -1023,7 +1030,7 @@ void ResolveVisitor::ResolveQualifiedIdentifier(
 
   const VariableDecl* absl_nullable decl = nullptr;
   int segment_index_out = -1;
-  namespace_generator_.GenerateCandidates(
+  namespace_generator_->GenerateCandidates(
       qualifiers, [&decl, &segment_index_out, this](absl::string_view candidate,
                                                     int segment_index) {
         decl = LookupIdentifier(candidate);
@@ -1170,13 +1177,18 @@ void ResolveVisitor::HandleOptSelect(const Expr& expr) {
     types_[&expr] = ErrorType();
     return;
   }
-  const FunctionDecl* select_decl = env_->LookupFunction(kOptionalSelect);
+  absl::StatusOr<const FunctionDecl*> select_decl =
+      env_->LookupFunction(kOptionalSelect);
+  if (!select_decl.ok()) {
+    status_.Update(select_decl.status());
+    return;
+  }
   types_[&expr] = OptionalType(arena_, field_type.value());
   // Remove the type annotation for the field now that we've validated it as
   // a valid field access instead of a string literal.
   types_.erase(field);
-  if (select_decl != nullptr) {
-    functions_[&expr] = FunctionResolution{select_decl,
+  if (*select_decl != nullptr) {
+    functions_[&expr] = FunctionResolution{*select_decl,
                                            /*.namespace_rewrite=*/false};
   }
 }
@@ -1263,12 +1275,11 @@ absl::StatusOr<ValidationResult> TypeCheckerImpl::Check(
   google::protobuf::Arena type_arena;
 
   std::vector<TypeCheckIssue> issues;
-  CEL_ASSIGN_OR_RETURN(auto generator,
-                       NamespaceGenerator::Create(env_.container()));
+  CEL_RETURN_IF_ERROR(namespace_generator_.status());
 
   TypeInferenceContext type_inference_context(
       &type_arena, options_.enable_legacy_null_assignment);
-  ResolveVisitor visitor(env_.container(), std::move(generator), env_, *ast,
+  ResolveVisitor visitor(env_.container(), *namespace_generator_, env_, *ast,
                          type_inference_context, issues, &type_arena);
 
   TraversalOptions opts;
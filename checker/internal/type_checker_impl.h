@@ -20,6 +20,7 @@
 
 #include "absl/status/statusor.h"
 #include "checker/checker_options.h"
+#include "checker/internal/namespace_generator.h"
 #include "checker/internal/type_check_env.h"
 #include "checker/type_checker.h"
 #include "checker/validation_result.h"
@@ -33,8 +34,15 @@ namespace cel::checker_internal {
 // See cel::TypeCheckerBuilder for constructing instances.
 class TypeCheckerImpl : public TypeChecker {
  public:
+  // Freezes `env`: the environment is immutable for the lifetime of the
+  // checker, so its lookup tables and namespace candidates are computed once
+  // here rather than on every call to `Check`.
   explicit TypeCheckerImpl(TypeCheckEnv env, CheckerOptions options = {})
-      : env_(std::move(env)), options_(options) {}
+      : env_(std::move(env)),
+        namespace_generator_(NamespaceGenerator::Create(env_.container())),
+        options_(options) {
+    env_.Freeze();
+  }
 
   TypeCheckerImpl(const TypeCheckerImpl&) = delete;
   TypeCheckerImpl& operator=(const TypeCheckerImpl&) = delete;
@@ -46,6 +54,8 @@ class TypeCheckerImpl : public TypeChecker {
 
  private:
   TypeCheckEnv env_;
+  // An invalid container is reported by `Check`.
+  absl::StatusOr<NamespaceGenerator> namespace_generator_;
   google::protobuf::Arena type_arena_;
   CheckerOptions options_;
 };
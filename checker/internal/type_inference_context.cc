@@ -23,6 +23,7 @@
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
 #include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
 #include "absl/types/span.h"
@@ -233,20 +234,102 @@ Type TypeInferenceContext::InstantiateTypeParams(
   }
 }
 
+TypeInferenceContext::TypeVar* absl_nullable TypeInferenceContext::FindTypeVar(
+    absl::string_view name) const {
+  size_t id;
+  if (IsTypeVar(name) && absl::SimpleAtoi(name.substr(2), &id) && id > 0 &&
+      id <= type_vars_.size()) {
+    TypeVar& var = type_vars_[id - 1];
+    if (var.name == name) {
+      return &var;
+    }
+  }
+  if (auto it = uninstantiated_type_vars_.find(name);
+      it != uninstantiated_type_vars_.end()) {
+    return &it->second;
+  }
+  return nullptr;
+}
+
+TypeInferenceContext::TypeVar& TypeInferenceContext::GetOrAddTypeVar(
+    absl::string_view name) {
+  if (TypeVar* var = FindTypeVar(name); var != nullptr) {
+    return *var;
+  }
+  auto [it, inserted] = uninstantiated_type_vars_.try_emplace(name);
+  TypeVar& var = it->second;
+  var.name = std::string(name);
+  var.param_name = var.name;
+  var.instantiated = false;
+  return var;
+}
+
+TypeInferenceContext::TypeVar& TypeInferenceContext::FindRoot(
+    TypeVar& var) const {
+  TypeVar* root = &var;
+  while (root->type.has_value() && root->type->kind() == TypeKind::kTypeParam) {
+    TypeVar* next = FindTypeVar(root->type->GetTypeParam().name());
+    if (next == nullptr || next == root) {
+      break;
+    }
+    root = next;
+  }
+  TypeVar* current = &var;
+  while (current != root) {
+    TypeVar* next = FindTypeVar(current->type->GetTypeParam().name());
+    if (next != root) {
+      current->type = TypeParamType(root->name);
+    }
+    current = next;
+  }
+  return *root;
+}
+
+void TypeInferenceContext::SetProspective(TypeVar& var, Type type) {
+  trail_.push_back({&var, std::move(var.prospective)});
+  var.prospective = std::move(type);
+}
+
+void TypeInferenceContext::Rollback(size_t snapshot) {
+  while (trail_.size() > snapshot) {
+    auto& [var, prospective] = trail_.back();
+    var->prospective = std::move(prospective);
+    trail_.pop_back();
+  }
+}
+
+void TypeInferenceContext::Commit(size_t snapshot) {
+  for (size_t i = snapshot; i < trail_.size(); ++i) {
+    TypeVar* var = trail_[i].first;
+    if (!var->prospective.has_value()) {
+      // Already committed from an earlier entry for the same variable.
+      continue;
+    }
+    if (var->instantiated) {
+      var->type = *std::move(var->prospective);
+    } else {
+      ABSL_LOG(WARNING) << "Uninstantiated type parameter: " << var->name;
+    }
+    var->prospective.reset();
+  }
+  trail_.resize(snapshot);
+}
+
 bool TypeInferenceContext::IsAssignable(const Type& from, const Type& to) {
-  SubstitutionMap prospective_substitutions;
-  bool result = IsAssignableInternal(from, to, prospective_substitutions);
+  size_t snapshot = Snapshot();
+  bool result = IsAssignableInternal(from, to);
   if (result) {
-    UpdateTypeParameterBindings(prospective_substitutions);
+    Commit(snapshot);
+  } else {
+    Rollback(snapshot);
   }
   return result;
 }
 
-bool TypeInferenceContext::IsAssignableInternal(
-    const Type& from, const Type& to,
-    SubstitutionMap& prospective_substitutions) {
-  Type to_subs = Substitute(to, prospective_substitutions);
-  Type from_subs = Substitute(from, prospective_substitutions);
+bool TypeInferenceContext::IsAssignableInternal(const Type& from,
+                                                const Type& to) {
+  Type to_subs = Substitute(to, /*include_prospective=*/true);
+  Type from_subs = Substitute(from, /*include_prospective=*/true);
 
   // Types always assignable to themselves.
   // Remainder is checking for assignability across different types.
@@ -257,8 +340,7 @@ bool TypeInferenceContext::IsAssignableInternal(
   // Resolve free type parameters.
   if (to_subs.kind() == TypeKind::kTypeParam ||
       from_subs.kind() == TypeKind::kTypeParam) {
-    return IsAssignableWithConstraints(from_subs, to_subs,
-                                       prospective_substitutions);
+    return IsAssignableWithConstraints(from_subs, to_subs);
   }
 
   // Maybe widen a prospective type binding if another potential binding is
@@ -266,18 +348,20 @@ bool TypeInferenceContext::IsAssignableInternal(
   if (
       // Checking assignability to a specific type var
       // that has a prospective type assignment.
-      to.kind() == TypeKind::kTypeParam &&
-      prospective_substitutions.contains(to.AsTypeParam()->name())) {
-    auto prospective_subs_cpy(prospective_substitutions);
-    if (CompareGenerality(from_subs, to_subs, prospective_subs_cpy) ==
-        RelativeGenerality::kMoreGeneral) {
-      if (IsAssignableInternal(to_subs, from_subs, prospective_subs_cpy) &&
-          !OccursWithin(to.name(), from_subs, prospective_subs_cpy)) {
-        prospective_subs_cpy[to.AsTypeParam()->name()] = from_subs;
-        prospective_substitutions = prospective_subs_cpy;
-        return true;
-        // otherwise, continue with normal assignability check.
+      to.kind() == TypeKind::kTypeParam) {
+    if (TypeVar* to_var = FindTypeVar(to.AsTypeParam()->name());
+        to_var != nullptr && to_var->prospective.has_value()) {
+      size_t snapshot = Snapshot();
+      if (CompareGenerality(from_subs, to_subs) ==
+          RelativeGenerality::kMoreGeneral) {
+        if (IsAssignableInternal(to_subs, from_subs) &&
+            !OccursWithin(to.name(), from_subs)) {
+          SetProspective(*to_var, from_subs);
+          return true;
+        }
       }
+      // otherwise, continue with normal assignability check.
+      Rollback(snapshot);
     }
   }
 
@@ -285,8 +369,7 @@ bool TypeInferenceContext::IsAssignableInternal(
   if (absl::optional<Type> wrapped_type = WrapperToPrimitive(to_subs);
       wrapped_type.has_value()) {
     return from_subs.IsNull() ||
-           IsAssignableInternal(*wrapped_type, from_subs,
-                                prospective_substitutions);
+           IsAssignableInternal(*wrapped_type, from_subs);
   }
 
   // Wrapper types are assignable to their corresponding primitive type (
@@ -294,8 +377,7 @@ bool TypeInferenceContext::IsAssignableInternal(
   // but there isn't a dedicated syntax for narrowing from the nullable.
   if (auto from_wrapper = WrapperToPrimitive(from_subs);
       from_wrapper.has_value()) {
-    return IsAssignableInternal(*from_wrapper, to_subs,
-                                prospective_substitutions);
+    return IsAssignableInternal(*from_wrapper, to_subs);
   }
 
   if (enable_legacy_null_assignment_) {
@@ -341,29 +423,32 @@ bool TypeInferenceContext::IsAssignableInternal(
     return false;
   }
   for (size_t i = 0; i < params_size; ++i) {
-    if (!IsAssignableInternal(from_params[i], to_params[i],
-                              prospective_substitutions)) {
+    if (!IsAssignableInternal(from_params[i], to_params[i])) {
       return false;
     }
   }
   return true;
 }
 
-Type TypeInferenceContext::Substitute(
-    const Type& type, const SubstitutionMap& substitutions) const {
+Type TypeInferenceContext::Substitute(const Type& type,
+                                      bool include_prospective) const {
   Type subs = type;
   while (subs.kind() == TypeKind::kTypeParam) {
-    TypeParamType t = subs.GetTypeParam();
-    if (auto it = substitutions.find(t.name()); it != substitutions.end()) {
-      subs = it->second;
+    TypeVar* var = FindTypeVar(subs.GetTypeParam().name());
+    if (var == nullptr) {
+      break;
+    }
+    TypeVar& root = FindRoot(*var);
+    if (include_prospective && root.prospective.has_value()) {
+      subs = *root.prospective;
       continue;
     }
-    if (auto it = type_parameter_bindings_.find(t.name());
-        it != type_parameter_bindings_.end()) {
-      if (it->second.type.has_value()) {
-        subs = *it->second.type;
-        continue;
-      }
+    if (root.type.has_value()) {
+      subs = *root.type;
+      continue;
+    }
+    if (&root != var) {
+      subs = TypeParamType(root.name);
     }
     break;
   }
@@ -371,11 +456,10 @@ Type TypeInferenceContext::Substitute(
 }
 
 TypeInferenceContext::RelativeGenerality
-TypeInferenceContext::CompareGenerality(
-    const Type& from, const Type& to,
-    const SubstitutionMap& prospective_substitutions) const {
-  Type from_subs = Substitute(from, prospective_substitutions);
-  Type to_subs = Substitute(to, prospective_substitutions);
+TypeInferenceContext::CompareGenerality(const Type& from,
+                                        const Type& to) const {
+  Type from_subs = Substitute(from, /*include_prospective=*/true);
+  Type to_subs = Substitute(to, /*include_prospective=*/true);
 
   if (from_subs == to_subs) {
     return RelativeGenerality::kEquivalent;
@@ -398,17 +482,14 @@ TypeInferenceContext::CompareGenerality(
   // equivalent and at least one is more general.
   if (from_subs.IsList() && to_subs.IsList()) {
     return CompareGenerality(from_subs.AsList()->GetElement(),
-                             to_subs.AsList()->GetElement(),
-                             prospective_substitutions);
+                             to_subs.AsList()->GetElement());
   }
 
   if (from_subs.IsMap() && to_subs.IsMap()) {
-    RelativeGenerality key_generality =
-        CompareGenerality(from_subs.AsMap()->GetKey(),
-                          to_subs.AsMap()->GetKey(), prospective_substitutions);
+    RelativeGenerality key_generality = CompareGenerality(
+        from_subs.AsMap()->GetKey(), to_subs.AsMap()->GetKey());
     RelativeGenerality value_generality = CompareGenerality(
-        from_subs.AsMap()->GetValue(), to_subs.AsMap()->GetValue(),
-        prospective_substitutions);
+        from_subs.AsMap()->GetValue(), to_subs.AsMap()->GetValue());
     if (key_generality == RelativeGenerality::kLessGeneral ||
         value_generality == RelativeGenerality::kLessGeneral) {
       return RelativeGenerality::kLessGeneral;
@@ -428,7 +509,7 @@ TypeInferenceContext::CompareGenerality(
     for (int i = 0; i < from_subs.AsOpaque()->GetParameters().size(); ++i) {
       RelativeGenerality generality = CompareGenerality(
           from_subs.AsOpaque()->GetParameters()[i],
-          to_subs.AsOpaque()->GetParameters()[i], prospective_substitutions);
+          to_subs.AsOpaque()->GetParameters()[i]);
       if (generality == RelativeGenerality::kLessGeneral) {
         return RelativeGenerality::kLessGeneral;
       }
@@ -445,9 +526,8 @@ TypeInferenceContext::CompareGenerality(
   return RelativeGenerality::kEquivalent;
 }
 
-bool TypeInferenceContext::OccursWithin(
-    absl::string_view var_name, const Type& type,
-    const SubstitutionMap& substitutions) const {
+bool TypeInferenceContext::OccursWithin(absl::string_view var_name,
+                                        const Type& type) const {
   // This is difficult to trigger in normal CEL expressions, but may
   // happen with comprehensions where we can potentially reference a variable
   // with a free type var in different ways.
@@ -458,44 +538,43 @@ bool TypeInferenceContext::OccursWithin(
     if (type.AsTypeParam()->name() == var_name) {
       return true;
     }
-    auto typeSubs = Substitute(type, substitutions);
-    if (typeSubs != type && OccursWithin(var_name, typeSubs, substitutions)) {
+    auto typeSubs = Substitute(type, /*include_prospective=*/true);
+    if (typeSubs != type && OccursWithin(var_name, typeSubs)) {
       return true;
     }
   }
 
   for (const auto& param : type.GetParameters()) {
-    if (OccursWithin(var_name, param, substitutions)) {
+    if (OccursWithin(var_name, param)) {
       return true;
     }
   }
   return false;
 }
 
-bool TypeInferenceContext::IsAssignableWithConstraints(
-    const Type& from, const Type& to,
-    SubstitutionMap& prospective_substitutions) {
+bool TypeInferenceContext::IsAssignableWithConstraints(const Type& from,
+                                                       const Type& to) {
   if (to.kind() == TypeKind::kTypeParam &&
       from.kind() == TypeKind::kTypeParam) {
     if (to.AsTypeParam()->name() != from.AsTypeParam()->name()) {
       // Simple case, bind from to 'to' if both are free.
-      prospective_substitutions[from.AsTypeParam()->name()] = to;
+      SetProspective(GetOrAddTypeVar(from.AsTypeParam()->name()), to);
     }
     return true;
   }
 
   if (to.kind() == TypeKind::kTypeParam) {
     absl::string_view name = to.AsTypeParam()->name();
-    if (!OccursWithin(name, from, prospective_substitutions)) {
-      prospective_substitutions[name] = from;
+    if (!OccursWithin(name, from)) {
+      SetProspective(GetOrAddTypeVar(name), from);
       return true;
     }
   }
 
   if (from.kind() == TypeKind::kTypeParam) {
     absl::string_view name = from.AsTypeParam()->name();
-    if (!OccursWithin(name, to, prospective_substitutions)) {
-      prospective_substitutions[name] = to;
+    if (!OccursWithin(name, to)) {
+      SetProspective(GetOrAddTypeVar(name), to);
       return true;
     }
   }
@@ -526,19 +605,20 @@ TypeInferenceContext::ResolveOverload(const FunctionDecl& decl,
     ABSL_DCHECK_EQ(argument_types.size(),
                    call_type_instance.param_types.size());
     bool is_match = true;
-    SubstitutionMap prospective_substitutions;
+    size_t snapshot = Snapshot();
     for (int i = 0; i < argument_types.size(); ++i) {
       if (!IsAssignableInternal(argument_types[i],
-                                call_type_instance.param_types[i],
-                                prospective_substitutions)) {
+                                call_type_instance.param_types[i])) {
         is_match = false;
         break;
       }
     }
 
-    if (is_match) {
+    if (!is_match) {
+      Rollback(snapshot);
+    } else {
       matching_overloads.push_back(ovl);
-      UpdateTypeParameterBindings(prospective_substitutions);
+      Commit(snapshot);
       if (!result_type.has_value()) {
         result_type = call_type_instance.result_type;
       } else {
@@ -558,22 +638,6 @@ TypeInferenceContext::ResolveOverload(const FunctionDecl& decl,
   };
 }
 
-void TypeInferenceContext::UpdateTypeParameterBindings(
-    const SubstitutionMap& prospective_substitutions) {
-  if (prospective_substitutions.empty()) {
-    return;
-  }
-  for (auto iter = prospective_substitutions.begin();
-       iter != prospective_substitutions.end(); ++iter) {
-    if (auto binding_iter = type_parameter_bindings_.find(iter->first);
-        binding_iter != type_parameter_bindings_.end()) {
-      binding_iter->second.type = iter->second;
-    } else {
-      ABSL_LOG(WARNING) << "Uninstantiated type parameter: " << iter->first;
-    }
-  }
-}
-
 bool TypeInferenceContext::TypeEquivalent(const Type& a, const Type& b) {
   return a == b;
 }
@@ -582,7 +646,7 @@ Type TypeInferenceContext::FullySubstitute(const Type& type,
                                            bool free_to_dyn) const {
   switch (type.kind()) {
     case TypeKind::kTypeParam: {
-      Type subs = Substitute(type, {});
+      Type subs = Substitute(type, /*include_prospective=*/false);
       if (subs.kind() == TypeKind::kTypeParam) {
         if (free_to_dyn) {
           return DynType();
@@ -621,18 +685,16 @@ Type TypeInferenceContext::FullySubstitute(const Type& type,
 
 bool TypeInferenceContext::AssignabilityContext::IsAssignable(const Type& from,
                                                               const Type& to) {
-  return inference_context_.IsAssignableInternal(from, to,
-                                                 prospective_substitutions_);
+  return inference_context_.IsAssignableInternal(from, to);
 }
 
 void TypeInferenceContext::AssignabilityContext::
     UpdateInferredTypeAssignments() {
-  inference_context_.UpdateTypeParameterBindings(
-      std::move(prospective_substitutions_));
+  inference_context_.Commit(snapshot_);
 }
 
 void TypeInferenceContext::AssignabilityContext::Reset() {
-  prospective_substitutions_.clear();
+  inference_context_.Rollback(snapshot_);
 }
 
 }  // namespace cel::checker_internal
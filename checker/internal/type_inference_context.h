@@ -15,13 +15,16 @@
 #ifndef THIRD_PARTY_CEL_CPP_CHECKER_INTERNAL_TYPE_INFERENCE_CONTEXT_H_
 #define THIRD_PARTY_CEL_CPP_CHECKER_INTERNAL_TYPE_INFERENCE_CONTEXT_H_
 
-#include <cstdint>
+#include <cstddef>
+#include <deque>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "absl/base/attributes.h"
+#include "absl/base/nullability.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/node_hash_map.h"
-#include "absl/log/absl_check.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
@@ -50,20 +53,18 @@ class TypeInferenceContext {
     std::vector<OverloadDecl> overloads;
   };
 
- private:
-  // Alias for a map from type var name to the type it is bound to.
-  //
-  // Used for prospective substitutions during type inference to make progress
-  // without affecting final assigned types.
-  using SubstitutionMap = absl::flat_hash_map<absl::string_view, Type>;
-
  public:
   // Helper class for managing several dependent type assignability checks.
   //
-  // Note: while allowed, updating multiple AssignabilityContexts concurrently
-  // can lead to inconsistencies in the final type bindings.
+  // The prospective substitutions made by the checks are recorded in the
+  // parent inference context, so only one AssignabilityContext may be in use
+  // at a time and no other inference should be performed until it has been
+  // applied, reset or destroyed.
   class AssignabilityContext {
    public:
+    // Discards any prospective substitutions that were not applied.
+    ~AssignabilityContext() { Reset(); }
+
     // Checks if `from` is assignable to `to` with the current type
     // substitutions and any additional prospective substitutions in the parent
     // inference context.
@@ -83,7 +84,8 @@ class TypeInferenceContext {
 
    private:
     explicit AssignabilityContext(TypeInferenceContext& inference_context)
-        : inference_context_(inference_context) {}
+        : inference_context_(inference_context),
+          snapshot_(inference_context.Snapshot()) {}
 
     AssignabilityContext(const AssignabilityContext&) = delete;
     AssignabilityContext& operator=(const AssignabilityContext&) = delete;
@@ -93,7 +95,8 @@ class TypeInferenceContext {
     friend class TypeInferenceContext;
 
     TypeInferenceContext& inference_context_;
-    SubstitutionMap prospective_substitutions_;
+    // Substitution trail position in the starting state.
+    size_t snapshot_;
   };
 
   explicit TypeInferenceContext(google::protobuf::Arena* arena,
@@ -105,9 +108,6 @@ class TypeInferenceContext {
   //
   // This is intended for managing several dependent type assignability checks
   // that should only be added to the final type bindings if all checks succeed.
-  //
-  // Note: while allowed, updating multiple AssignabilityContexts concurrently
-  // can lead to inconsistencies in the final type bindings.
   AssignabilityContext CreateAssignabilityContext()
       ABSL_ATTRIBUTE_LIFETIME_BOUND {
     return AssignabilityContext(*this);
@@ -144,20 +144,38 @@ class TypeInferenceContext {
   std::string DebugString() const {
     return absl::StrCat(
         "type_parameter_bindings: ",
-        absl::StrJoin(
-            type_parameter_bindings_, "\n ",
-            [](std::string* out, const auto& binding) {
-              absl::StrAppend(
-                  out, binding.first, " (", binding.second.name, ") -> ",
-                  binding.second.type.value_or(Type(TypeParamType("none")))
-                      .DebugString());
-            }));
+        absl::StrJoin(type_vars_, "\n ",
+                      [](std::string* out, const TypeVar& var) {
+                        absl::StrAppend(
+                            out, var.name, " (", var.param_name, ") -> ",
+                            var.type.value_or(Type(TypeParamType("none")))
+                                .DebugString());
+                      }));
   }
 
  private:
+  // A type variable and its bindings.
+  //
+  // Committed bindings form a union-find forest: a variable bound to another
+  // variable links to it, and only the variable at the root of a chain may be
+  // bound to a concrete type. Committed bindings are only ever made for free
+  // variables, so chains never change once formed and lookups compress them.
+  //
+  // Prospective bindings are made while checking assignability and take
+  // precedence over committed ones. They are recorded on a trail so that a
+  // failed check can be rolled back to a snapshot without copying the set of
+  // substitutions.
   struct TypeVar {
+    // Instance name, "T%<id>".
+    std::string name;
+    // Name of the type parameter this variable was instantiated for.
+    absl::string_view param_name;
+    // nullopt signifies a free type variable.
     absl::optional<Type> type;
-    absl::string_view name;
+    absl::optional<Type> prospective;
+    // False for type parameters that are bound prospectively without having
+    // been instantiated. These are never committed.
+    bool instantiated = true;
   };
 
   // Relative generality between two types.
@@ -170,68 +188,77 @@ class TypeInferenceContext {
   };
 
   absl::string_view NewTypeVar(absl::string_view name = "") {
-    next_type_parameter_id_++;
-    auto inserted = type_parameter_bindings_.insert(
-        {absl::StrCat("T%", next_type_parameter_id_), {absl::nullopt, name}});
-    ABSL_DCHECK(inserted.second);
-    return inserted.first->first;
+    TypeVar& var = type_vars_.emplace_back();
+    var.name = absl::StrCat("T%", type_vars_.size());
+    var.param_name = name;
+    return var.name;
   }
 
+  // Returns the variable for the type parameter `name`, or nullptr if it has
+  // neither been instantiated nor bound.
+  TypeVar* absl_nullable FindTypeVar(absl::string_view name) const;
+
+  // Returns the variable for the type parameter `name`, adding an
+  // uninstantiated one if needed.
+  TypeVar& GetOrAddTypeVar(absl::string_view name);
+
+  // Returns the variable at the end of the chain of committed
+  // variable-to-variable bindings starting at `var`, and links every variable
+  // on the chain directly to it.
+  TypeVar& FindRoot(TypeVar& var) const;
+
+  void SetProspective(TypeVar& var, Type type);
+
+  // Returns a snapshot of the prospective substitutions.
+  size_t Snapshot() const { return trail_.size(); }
+
+  // Discards the prospective substitutions made after `snapshot`.
+  void Rollback(size_t snapshot);
+
+  // Commits the prospective substitutions made after `snapshot`.
+  void Commit(size_t snapshot);
+
   // Returns true if the two types are equivalent with the current type
   // substitutions.
   bool TypeEquivalent(const Type& a, const Type& b);
 
   // Returns true if `from` is assignable to `to` with the current type
-  // substitutions and any additional prospective substitutions.
-  //
-  // `prospective_substitutions` is a map from type var name to the type it
-  // should be bound to in the current context, augmenting any existing
-  // substitutions.
-  //
-  // If the types are not assignable, returns false and leaves
-  // `prospective_substitutions` unmodified.
+  // substitutions and any prospective substitutions.
   //
-  // If the types are assignable, returns true and updates
-  // `prospective_substitutions` with any new type parameter bindings.
-  bool IsAssignableInternal(const Type& from, const Type& to,
-                            SubstitutionMap& prospective_substitutions);
+  // If the types are assignable, returns true and makes prospective
+  // substitutions for any new type parameter bindings. Callers that need to
+  // undo the bindings of a failed check should roll back to a snapshot.
+  bool IsAssignableInternal(const Type& from, const Type& to);
 
-  bool IsAssignableWithConstraints(const Type& from, const Type& to,
-                                   SubstitutionMap& prospective_substitutions);
+  bool IsAssignableWithConstraints(const Type& from, const Type& to);
 
   // Relative generality of `from` as compared to `to` with the current type
-  // substitutions and any additional prospective substitutions.
+  // substitutions and any prospective substitutions.
   //
   // Generality is only defined as a partial ordering. Some types are
   // incomparable. However we only need to know if a type is definitely more
   // general or not.
-  RelativeGenerality CompareGenerality(
-      const Type& from, const Type& to,
-      const SubstitutionMap& prospective_substitutions) const;
-
-  Type Substitute(const Type& type, const SubstitutionMap& substitutions) const;
+  RelativeGenerality CompareGenerality(const Type& from, const Type& to) const;
 
-  bool OccursWithin(absl::string_view var_name, const Type& type,
-                    const SubstitutionMap& substitutions) const;
+  // Follows the bindings of `type` while it is a bound type parameter.
+  Type Substitute(const Type& type, bool include_prospective) const;
 
-  void UpdateTypeParameterBindings(
-      const SubstitutionMap& prospective_substitutions);
+  bool OccursWithin(absl::string_view var_name, const Type& type) const;
 
-  // Map from type var parameter name to the type it is bound to.
-  //
-  // Type var parameters are formatted as "T%<id>" to avoid collisions with
-  // provided type parameter names.
-  //
-  // node_hash_map is used to preserve pointer stability for use with
-  // TypeParamType.
+  // Type variables in instantiation order, so that the variable for "T%<id>"
+  // is found by index. A deque keeps the names, which TypeParamType refers to,
+  // at stable addresses.
   //
   // Type parameter instances should be resolved to a concrete type during type
   // checking to remove the lifecycle dependency on the inference context
   // instance.
   //
-  // nullopt signifies a free type variable.
-  absl::node_hash_map<std::string, TypeVar> type_parameter_bindings_;
-  int64_t next_type_parameter_id_ = 0;
+  // Mutable so that const lookups can compress paths.
+  mutable std::deque<TypeVar> type_vars_;
+  // Type parameters bound prospectively without having been instantiated.
+  mutable absl::node_hash_map<std::string, TypeVar> uninstantiated_type_vars_;
+  // Variables given a prospective binding, with the binding each replaced.
+  std::vector<std::pair<TypeVar*, absl::optional<Type>>> trail_;
   google::protobuf::Arena* arena_;
   bool enable_legacy_null_assignment_;
 };
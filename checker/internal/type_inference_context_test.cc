@@ -469,6 +469,53 @@ TEST(TypeInferenceContextTest, InferencesAccumulate) {
   EXPECT_THAT(resolution2->overloads, ElementsAre(IsOverloadDecl("add_list")));
 }
 
+TEST(TypeInferenceContextTest, InferencesAccumulateOverChains) {
+  google::protobuf::Arena arena;
+  TypeInferenceContext context(&arena);
+
+  std::vector<Type> type_vars;
+  for (int i = 0; i < 100; ++i) {
+    type_vars.push_back(context.InstantiateTypeParams(TypeParamType("A")));
+  }
+  for (int i = 0; i + 1 < type_vars.size(); ++i) {
+    ASSERT_TRUE(context.IsAssignable(type_vars[i], type_vars[i + 1]));
+  }
+  ASSERT_TRUE(context.IsAssignable(IntType(), type_vars.back()));
+
+  for (const Type& type_var : type_vars) {
+    EXPECT_THAT(context.FinalizeType(type_var), IsTypeKind(TypeKind::kInt));
+  }
+}
+
+TEST(TypeInferenceContextTest, ResolveOverloadDiscardsFailedCandidates) {
+  google::protobuf::Arena arena;
+  TypeInferenceContext context(&arena);
+
+  Type list_of_a = ListType(&arena, TypeParamType("A"));
+  ASSERT_OK_AND_ASSIGN(
+      FunctionDecl decl,
+      MakeFunctionDecl(
+          "f",
+          MakeOverloadDecl("f_list_int_int", IntType(),
+                           ListType(&arena, IntType()), IntType()),
+          MakeOverloadDecl("f_list_string", IntType(), list_of_a,
+                           StringType())));
+
+  Type list_of_a_instance = context.InstantiateTypeParams(list_of_a);
+
+  // The first overload binds the list element type before failing on the
+  // second argument. The binding must not leak into the result.
+  absl::optional<TypeInferenceContext::OverloadResolution> resolution =
+      context.ResolveOverload(decl, {list_of_a_instance, StringType()}, false);
+  ASSERT_TRUE(resolution.has_value());
+  EXPECT_THAT(resolution->overloads,
+              ElementsAre(IsOverloadDecl("f_list_string")));
+
+  Type resolved_type = context.FinalizeType(list_of_a_instance);
+  ASSERT_THAT(resolved_type, IsTypeKind(TypeKind::kList));
+  EXPECT_THAT(resolved_type.AsList()->GetElement(), IsTypeKind(TypeKind::kDyn));
+}
+
 TEST(TypeInferenceContextTest, DebugString) {
   google::protobuf::Arena arena;
   TypeInferenceContext context(&arena);
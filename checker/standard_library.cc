@@ -14,10 +14,14 @@
 
 #include "checker/standard_library.h"
 
+#include <deque>
+#include <string>
 #include <utility>
 
 #include "absl/base/no_destructor.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
 #include "checker/internal/builtins_arena.h"
 #include "checker/type_checker_builder.h"
 #include "common/constant.h"
@@ -121,7 +125,7 @@ Type TypeMapType() {
   return *kInstance;
 }
 
-absl::Status AddArithmeticOps(TypeCheckerBuilder& builder) {
+absl::StatusOr<FunctionDecl> AddOpDecl() {
   FunctionDecl add_op;
   add_op.set_name(StandardFunctions::kAdd);
   CEL_RETURN_IF_ERROR(add_op.AddOverload(MakeOverloadDecl(
@@ -150,9 +154,10 @@ absl::Status AddArithmeticOps(TypeCheckerBuilder& builder) {
   // list concat
   CEL_RETURN_IF_ERROR(add_op.AddOverload(MakeOverloadDecl(
       StandardOverloadIds::kAddList, ListOfA(), ListOfA(), ListOfA())));
+  return add_op;
+}
 
-  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(add_op)));
-
+absl::StatusOr<FunctionDecl> SubtractOpDecl() {
   FunctionDecl subtract_op;
   subtract_op.set_name(StandardFunctions::kSubtract);
   CEL_RETURN_IF_ERROR(subtract_op.AddOverload(MakeOverloadDecl(
@@ -172,9 +177,10 @@ absl::Status AddArithmeticOps(TypeCheckerBuilder& builder) {
   CEL_RETURN_IF_ERROR(subtract_op.AddOverload(
       MakeOverloadDecl(StandardOverloadIds::kSubtractTimestampTimestamp,
                        DurationType(), TimestampType(), TimestampType())));
+  return subtract_op;
+}
 
-  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(subtract_op)));
-
+absl::StatusOr<FunctionDecl> MultiplyOpDecl() {
   FunctionDecl multiply_op;
   multiply_op.set_name(StandardFunctions::kMultiply);
   CEL_RETURN_IF_ERROR(multiply_op.AddOverload(MakeOverloadDecl(
@@ -184,8 +190,10 @@ absl::Status AddArithmeticOps(TypeCheckerBuilder& builder) {
   CEL_RETURN_IF_ERROR(multiply_op.AddOverload(
       MakeOverloadDecl(StandardOverloadIds::kMultiplyDouble, DoubleType(),
                        DoubleType(), DoubleType())));
-  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(multiply_op)));
+  return multiply_op;
+}
 
+absl::StatusOr<FunctionDecl> DivisionOpDecl() {
   FunctionDecl division_op;
   division_op.set_name(StandardFunctions::kDivide);
   CEL_RETURN_IF_ERROR(division_op.AddOverload(MakeOverloadDecl(
@@ -195,79 +203,89 @@ absl::Status AddArithmeticOps(TypeCheckerBuilder& builder) {
   CEL_RETURN_IF_ERROR(division_op.AddOverload(
       MakeOverloadDecl(StandardOverloadIds::kDivideDouble, DoubleType(),
                        DoubleType(), DoubleType())));
-  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(division_op)));
+  return division_op;
+}
 
+absl::StatusOr<FunctionDecl> ModuloOpDecl() {
   FunctionDecl modulo_op;
   modulo_op.set_name(StandardFunctions::kModulo);
   CEL_RETURN_IF_ERROR(modulo_op.AddOverload(MakeOverloadDecl(
       StandardOverloadIds::kModuloInt, IntType(), IntType(), IntType())));
   CEL_RETURN_IF_ERROR(modulo_op.AddOverload(MakeOverloadDecl(
       StandardOverloadIds::kModuloUint, UintType(), UintType(), UintType())));
-  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(modulo_op)));
+  return modulo_op;
+}
 
+absl::StatusOr<FunctionDecl> NegateOpDecl() {
   FunctionDecl negate_op;
   negate_op.set_name(StandardFunctions::kNeg);
   CEL_RETURN_IF_ERROR(negate_op.AddOverload(
       MakeOverloadDecl(StandardOverloadIds::kNegateInt, IntType(), IntType())));
   CEL_RETURN_IF_ERROR(negate_op.AddOverload(MakeOverloadDecl(
       StandardOverloadIds::kNegateDouble, DoubleType(), DoubleType())));
-  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(negate_op)));
-
-  return absl::OkStatus();
+  return negate_op;
 }
 
-absl::Status AddLogicalOps(TypeCheckerBuilder& builder) {
+absl::StatusOr<FunctionDecl> NotOpDecl() {
   FunctionDecl not_op;
   not_op.set_name(StandardFunctions::kNot);
   CEL_RETURN_IF_ERROR(not_op.AddOverload(
       MakeOverloadDecl(StandardOverloadIds::kNot, BoolType(), BoolType())));
+  return not_op;
+}
 
-  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(not_op)));
-
+absl::StatusOr<FunctionDecl> AndOpDecl() {
   FunctionDecl and_op;
   and_op.set_name(StandardFunctions::kAnd);
   CEL_RETURN_IF_ERROR(and_op.AddOverload(MakeOverloadDecl(
       StandardOverloadIds::kAnd, BoolType(), BoolType(), BoolType())));
-  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(and_op)));
+  return and_op;
+}
 
+absl::StatusOr<FunctionDecl> OrOpDecl() {
   FunctionDecl or_op;
   or_op.set_name(StandardFunctions::kOr);
   CEL_RETURN_IF_ERROR(or_op.AddOverload(MakeOverloadDecl(
       StandardOverloadIds::kOr, BoolType(), BoolType(), BoolType())));
-  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(or_op)));
+  return or_op;
+}
 
+absl::StatusOr<FunctionDecl> ConditionalOpDecl() {
   FunctionDecl conditional_op;
   conditional_op.set_name(StandardFunctions::kTernary);
   CEL_RETURN_IF_ERROR(conditional_op.AddOverload(
       MakeOverloadDecl(StandardOverloadIds::kConditional, TypeParamA(),
                        BoolType(), TypeParamA(), TypeParamA())));
-  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(conditional_op)));
+  return conditional_op;
+}
 
+absl::StatusOr<FunctionDecl> NotStrictlyFalseDecl() {
   FunctionDecl not_strictly_false;
   not_strictly_false.set_name(StandardFunctions::kNotStrictlyFalse);
   CEL_RETURN_IF_ERROR(not_strictly_false.AddOverload(MakeOverloadDecl(
       StandardOverloadIds::kNotStrictlyFalse, BoolType(), BoolType())));
-  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(not_strictly_false)));
+  return not_strictly_false;
+}
 
+absl::StatusOr<FunctionDecl> NotStrictlyFalseDeprecatedDecl() {
   FunctionDecl not_strictly_false_deprecated;
   not_strictly_false_deprecated.set_name(
       StandardFunctions::kNotStrictlyFalseDeprecated);
   CEL_RETURN_IF_ERROR(not_strictly_false_deprecated.AddOverload(
       MakeOverloadDecl(StandardOverloadIds::kNotStrictlyFalseDeprecated,
                        BoolType(), BoolType())));
-  CEL_RETURN_IF_ERROR(
-      builder.AddFunction(std::move(not_strictly_false_deprecated)));
-
-  return absl::OkStatus();
+  return not_strictly_false_deprecated;
 }
 
-absl::Status AddTypeConversions(TypeCheckerBuilder& builder) {
+absl::StatusOr<FunctionDecl> ToDynDecl() {
   FunctionDecl to_dyn;
   to_dyn.set_name(StandardFunctions::kDyn);
   CEL_RETURN_IF_ERROR(to_dyn.AddOverload(
       MakeOverloadDecl(StandardOverloadIds::kToDyn, DynType(), TypeParamA())));
-  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(to_dyn)));
+  return to_dyn;
+}
 
+absl::StatusOr<FunctionDecl> ToUintDecl() {
   // Uint
   FunctionDecl to_uint;
   to_uint.set_name(StandardFunctions::kUint);
@@ -279,8 +297,10 @@ absl::Status AddTypeConversions(TypeCheckerBuilder& builder) {
       StandardOverloadIds::kDoubleToUint, UintType(), DoubleType())));
   CEL_RETURN_IF_ERROR(to_uint.AddOverload(MakeOverloadDecl(
       StandardOverloadIds::kStringToUint, UintType(), StringType())));
-  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(to_uint)));
+  return to_uint;
+}
 
+absl::StatusOr<FunctionDecl> ToIntDecl() {
   // Int
   FunctionDecl to_int;
   to_int.set_name(StandardFunctions::kInt);
@@ -296,8 +316,10 @@ absl::Status AddTypeConversions(TypeCheckerBuilder& builder) {
       StandardOverloadIds::kTimestampToInt, IntType(), TimestampType())));
   CEL_RETURN_IF_ERROR(to_int.AddOverload(MakeOverloadDecl(
       StandardOverloadIds::kDurationToInt, IntType(), DurationType())));
-  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(to_int)));
+  return to_int;
+}
 
+absl::StatusOr<FunctionDecl> ToDoubleDecl() {
   FunctionDecl to_double;
   to_double.set_name(StandardFunctions::kDouble);
   CEL_RETURN_IF_ERROR(to_double.AddOverload(MakeOverloadDecl(
@@ -308,16 +330,20 @@ absl::Status AddTypeConversions(TypeCheckerBuilder& builder) {
       StandardOverloadIds::kUintToDouble, DoubleType(), UintType())));
   CEL_RETURN_IF_ERROR(to_double.AddOverload(MakeOverloadDecl(
       StandardOverloadIds::kStringToDouble, DoubleType(), StringType())));
-  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(to_double)));
+  return to_double;
+}
 
+absl::StatusOr<FunctionDecl> ToBoolDecl() {
   FunctionDecl to_bool;
   to_bool.set_name("bool");
   CEL_RETURN_IF_ERROR(to_bool.AddOverload(MakeOverloadDecl(
       StandardOverloadIds::kBoolToBool, BoolType(), BoolType())));
   CEL_RETURN_IF_ERROR(to_bool.AddOverload(MakeOverloadDecl(
       StandardOverloadIds::kStringToBool, BoolType(), StringType())));
-  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(to_bool)));
+  return to_bool;
+}
 
+absl::StatusOr<FunctionDecl> ToStringDecl() {
   FunctionDecl to_string;
   to_string.set_name(StandardFunctions::kString);
   CEL_RETURN_IF_ERROR(to_string.AddOverload(MakeOverloadDecl(
@@ -336,16 +362,20 @@ absl::Status AddTypeConversions(TypeCheckerBuilder& builder) {
       StandardOverloadIds::kTimestampToString, StringType(), TimestampType())));
   CEL_RETURN_IF_ERROR(to_string.AddOverload(MakeOverloadDecl(
       StandardOverloadIds::kDurationToString, StringType(), DurationType())));
-  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(to_string)));
+  return to_string;
+}
 
+absl::StatusOr<FunctionDecl> ToBytesDecl() {
   FunctionDecl to_bytes;
   to_bytes.set_name(StandardFunctions::kBytes);
   CEL_RETURN_IF_ERROR(to_bytes.AddOverload(MakeOverloadDecl(
       StandardOverloadIds::kBytesToBytes, BytesType(), BytesType())));
   CEL_RETURN_IF_ERROR(to_bytes.AddOverload(MakeOverloadDecl(
       StandardOverloadIds::kStringToBytes, BytesType(), StringType())));
-  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(to_bytes)));
+  return to_bytes;
+}
 
+absl::StatusOr<FunctionDecl> ToTimestampDecl() {
   FunctionDecl to_timestamp;
   to_timestamp.set_name(StandardFunctions::kTimestamp);
   CEL_RETURN_IF_ERROR(to_timestamp.AddOverload(
@@ -355,8 +385,10 @@ absl::Status AddTypeConversions(TypeCheckerBuilder& builder) {
       StandardOverloadIds::kStringToTimestamp, TimestampType(), StringType())));
   CEL_RETURN_IF_ERROR(to_timestamp.AddOverload(MakeOverloadDecl(
       StandardOverloadIds::kIntToTimestamp, TimestampType(), IntType())));
-  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(to_timestamp)));
+  return to_timestamp;
+}
 
+absl::StatusOr<FunctionDecl> ToDurationDecl() {
   FunctionDecl to_duration;
   to_duration.set_name(StandardFunctions::kDuration);
   CEL_RETURN_IF_ERROR(to_duration.AddOverload(
@@ -366,67 +398,75 @@ absl::Status AddTypeConversions(TypeCheckerBuilder& builder) {
       StandardOverloadIds::kStringToDuration, DurationType(), StringType())));
   CEL_RETURN_IF_ERROR(to_duration.AddOverload(MakeOverloadDecl(
       StandardOverloadIds::kIntToDuration, DurationType(), IntType())));
-  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(to_duration)));
+  return to_duration;
+}
 
+absl::StatusOr<FunctionDecl> ToTypeDecl() {
   FunctionDecl to_type;
   to_type.set_name(StandardFunctions::kType);
   CEL_RETURN_IF_ERROR(to_type.AddOverload(MakeOverloadDecl(
       StandardOverloadIds::kToType, Type(TypeOfA()), TypeParamA())));
-  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(to_type)));
-
-  return absl::OkStatus();
+  return to_type;
 }
 
-absl::Status AddEqualityOps(TypeCheckerBuilder& builder) {
+absl::StatusOr<FunctionDecl> EqualsOpDecl() {
   FunctionDecl equals_op;
   equals_op.set_name(StandardFunctions::kEqual);
   CEL_RETURN_IF_ERROR(equals_op.AddOverload(MakeOverloadDecl(
       StandardOverloadIds::kEquals, BoolType(), TypeParamA(), TypeParamA())));
-  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(equals_op)));
+  return equals_op;
+}
 
+absl::StatusOr<FunctionDecl> NotEqualsOpDecl() {
   FunctionDecl not_equals_op;
   not_equals_op.set_name(StandardFunctions::kInequal);
   CEL_RETURN_IF_ERROR(not_equals_op.AddOverload(
       MakeOverloadDecl(StandardOverloadIds::kNotEquals, BoolType(),
                        TypeParamA(), TypeParamA())));
-  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(not_equals_op)));
-
-  return absl::OkStatus();
+  return not_equals_op;
 }
 
-absl::Status AddContainerOps(TypeCheckerBuilder& builder) {
+absl::StatusOr<FunctionDecl> IndexDecl() {
   FunctionDecl index;
   index.set_name(StandardFunctions::kIndex);
   CEL_RETURN_IF_ERROR(index.AddOverload(MakeOverloadDecl(
       StandardOverloadIds::kIndexList, TypeParamA(), ListOfA(), IntType())));
   CEL_RETURN_IF_ERROR(index.AddOverload(MakeOverloadDecl(
       StandardOverloadIds::kIndexMap, TypeParamB(), MapOfAB(), TypeParamA())));
-  CEL_RETURN_IF_ERROR(builder.MergeFunction(std::move(index)));
+  return index;
+}
 
+absl::StatusOr<FunctionDecl> InOpDecl() {
   FunctionDecl in_op;
   in_op.set_name(StandardFunctions::kIn);
   CEL_RETURN_IF_ERROR(in_op.AddOverload(MakeOverloadDecl(
       StandardOverloadIds::kInList, BoolType(), TypeParamA(), ListOfA())));
   CEL_RETURN_IF_ERROR(in_op.AddOverload(MakeOverloadDecl(
       StandardOverloadIds::kInMap, BoolType(), TypeParamA(), MapOfAB())));
-  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(in_op)));
+  return in_op;
+}
 
+absl::StatusOr<FunctionDecl> InFunctionDeprecatedDecl() {
   FunctionDecl in_function_deprecated;
   in_function_deprecated.set_name(StandardFunctions::kInFunction);
   CEL_RETURN_IF_ERROR(in_function_deprecated.AddOverload(MakeOverloadDecl(
       StandardOverloadIds::kInList, BoolType(), TypeParamA(), ListOfA())));
   CEL_RETURN_IF_ERROR(in_function_deprecated.AddOverload(MakeOverloadDecl(
       StandardOverloadIds::kInMap, BoolType(), TypeParamA(), MapOfAB())));
-  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(in_function_deprecated)));
+  return in_function_deprecated;
+}
 
+absl::StatusOr<FunctionDecl> InOpDeprecatedDecl() {
   FunctionDecl in_op_deprecated;
   in_op_deprecated.set_name(StandardFunctions::kInDeprecated);
   CEL_RETURN_IF_ERROR(in_op_deprecated.AddOverload(MakeOverloadDecl(
       StandardOverloadIds::kInList, BoolType(), TypeParamA(), ListOfA())));
   CEL_RETURN_IF_ERROR(in_op_deprecated.AddOverload(MakeOverloadDecl(
       StandardOverloadIds::kInMap, BoolType(), TypeParamA(), MapOfAB())));
-  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(in_op_deprecated)));
+  return in_op_deprecated;
+}
 
+absl::StatusOr<FunctionDecl> SizeDecl() {
   FunctionDecl size;
   size.set_name(StandardFunctions::kSize);
   CEL_RETURN_IF_ERROR(size.AddOverload(
@@ -445,12 +485,11 @@ absl::Status AddContainerOps(TypeCheckerBuilder& builder) {
       StandardOverloadIds::kSizeString, IntType(), StringType())));
   CEL_RETURN_IF_ERROR(size.AddOverload(MakeMemberOverloadDecl(
       StandardOverloadIds::kSizeStringMember, IntType(), StringType())));
-  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(size)));
-
-  return absl::OkStatus();
+  return size;
 }
 
-absl::Status AddRelationOps(TypeCheckerBuilder& builder) {
+absl::StatusOr<FunctionDecl> LessOpDecl(
+    bool enable_cross_numeric_comparisons) {
   FunctionDecl less_op;
   less_op.set_name(StandardFunctions::kLess);
   // Numeric types
@@ -477,6 +516,30 @@ absl::Status AddRelationOps(TypeCheckerBuilder& builder) {
       MakeOverloadDecl(StandardOverloadIds::kLessTimestamp, BoolType(),
                        TimestampType(), TimestampType())));
 
+  if (enable_cross_numeric_comparisons) {
+    CEL_RETURN_IF_ERROR(less_op.AddOverload(MakeOverloadDecl(
+        StandardOverloadIds::kLessIntUint, BoolType(), IntType(), UintType())));
+    CEL_RETURN_IF_ERROR(less_op.AddOverload(
+        MakeOverloadDecl(StandardOverloadIds::kLessIntDouble, BoolType(),
+                         IntType(), DoubleType())));
+    CEL_RETURN_IF_ERROR(less_op.AddOverload(MakeOverloadDecl(
+        StandardOverloadIds::kLessUintInt, BoolType(), UintType(), IntType())));
+    CEL_RETURN_IF_ERROR(less_op.AddOverload(
+        MakeOverloadDecl(StandardOverloadIds::kLessUintDouble, BoolType(),
+                         UintType(), DoubleType())));
+    CEL_RETURN_IF_ERROR(less_op.AddOverload(
+        MakeOverloadDecl(StandardOverloadIds::kLessDoubleInt, BoolType(),
+                         DoubleType(), IntType())));
+    CEL_RETURN_IF_ERROR(less_op.AddOverload(
+        MakeOverloadDecl(StandardOverloadIds::kLessDoubleUint, BoolType(),
+                         DoubleType(), UintType())));
+  }
+
+  return less_op;
+}
+
+absl::StatusOr<FunctionDecl> GreaterOpDecl(
+    bool enable_cross_numeric_comparisons) {
   FunctionDecl greater_op;
   greater_op.set_name(StandardFunctions::kGreater);
   // Numeric types
@@ -504,6 +567,32 @@ absl::Status AddRelationOps(TypeCheckerBuilder& builder) {
       MakeOverloadDecl(StandardOverloadIds::kGreaterTimestamp, BoolType(),
                        TimestampType(), TimestampType())));
 
+  if (enable_cross_numeric_comparisons) {
+    CEL_RETURN_IF_ERROR(greater_op.AddOverload(
+        MakeOverloadDecl(StandardOverloadIds::kGreaterIntUint, BoolType(),
+                         IntType(), UintType())));
+    CEL_RETURN_IF_ERROR(greater_op.AddOverload(
+        MakeOverloadDecl(StandardOverloadIds::kGreaterIntDouble, BoolType(),
+                         IntType(), DoubleType())));
+    CEL_RETURN_IF_ERROR(greater_op.AddOverload(
+        MakeOverloadDecl(StandardOverloadIds::kGreaterUintInt, BoolType(),
+                         UintType(), IntType())));
+    CEL_RETURN_IF_ERROR(greater_op.AddOverload(
+        MakeOverloadDecl(StandardOverloadIds::kGreaterUintDouble, BoolType(),
+                         UintType(), DoubleType())));
+    CEL_RETURN_IF_ERROR(greater_op.AddOverload(
+        MakeOverloadDecl(StandardOverloadIds::kGreaterDoubleInt, BoolType(),
+                         DoubleType(), IntType())));
+    CEL_RETURN_IF_ERROR(greater_op.AddOverload(
+        MakeOverloadDecl(StandardOverloadIds::kGreaterDoubleUint, BoolType(),
+                         DoubleType(), UintType())));
+  }
+
+  return greater_op;
+}
+
+absl::StatusOr<FunctionDecl> LessEqualsOpDecl(
+    bool enable_cross_numeric_comparisons) {
   FunctionDecl less_equals_op;
   less_equals_op.set_name(StandardFunctions::kLessOrEqual);
   // Numeric types
@@ -533,6 +622,32 @@ absl::Status AddRelationOps(TypeCheckerBuilder& builder) {
       MakeOverloadDecl(StandardOverloadIds::kLessEqualsTimestamp, BoolType(),
                        TimestampType(), TimestampType())));
 
+  if (enable_cross_numeric_comparisons) {
+    CEL_RETURN_IF_ERROR(less_equals_op.AddOverload(
+        MakeOverloadDecl(StandardOverloadIds::kLessEqualsIntUint, BoolType(),
+                         IntType(), UintType())));
+    CEL_RETURN_IF_ERROR(less_equals_op.AddOverload(
+        MakeOverloadDecl(StandardOverloadIds::kLessEqualsIntDouble, BoolType(),
+                         IntType(), DoubleType())));
+    CEL_RETURN_IF_ERROR(less_equals_op.AddOverload(
+        MakeOverloadDecl(StandardOverloadIds::kLessEqualsUintInt, BoolType(),
+                         UintType(), IntType())));
+    CEL_RETURN_IF_ERROR(less_equals_op.AddOverload(
+        MakeOverloadDecl(StandardOverloadIds::kLessEqualsUintDouble, BoolType(),
+                         UintType(), DoubleType())));
+    CEL_RETURN_IF_ERROR(less_equals_op.AddOverload(
+        MakeOverloadDecl(StandardOverloadIds::kLessEqualsDoubleInt, BoolType(),
+                         DoubleType(), IntType())));
+    CEL_RETURN_IF_ERROR(less_equals_op.AddOverload(
+        MakeOverloadDecl(StandardOverloadIds::kLessEqualsDoubleUint, BoolType(),
+                         DoubleType(), UintType())));
+  }
+
+  return less_equals_op;
+}
+
+absl::StatusOr<FunctionDecl> GreaterEqualsOpDecl(
+    bool enable_cross_numeric_comparisons) {
   FunctionDecl greater_equals_op;
   greater_equals_op.set_name(StandardFunctions::kGreaterOrEqual);
   // Numeric types
@@ -562,64 +677,7 @@ absl::Status AddRelationOps(TypeCheckerBuilder& builder) {
       MakeOverloadDecl(StandardOverloadIds::kGreaterEqualsTimestamp, BoolType(),
                        TimestampType(), TimestampType())));
 
-  if (builder.options().enable_cross_numeric_comparisons) {
-    // Less
-    CEL_RETURN_IF_ERROR(less_op.AddOverload(MakeOverloadDecl(
-        StandardOverloadIds::kLessIntUint, BoolType(), IntType(), UintType())));
-    CEL_RETURN_IF_ERROR(less_op.AddOverload(
-        MakeOverloadDecl(StandardOverloadIds::kLessIntDouble, BoolType(),
-                         IntType(), DoubleType())));
-    CEL_RETURN_IF_ERROR(less_op.AddOverload(MakeOverloadDecl(
-        StandardOverloadIds::kLessUintInt, BoolType(), UintType(), IntType())));
-    CEL_RETURN_IF_ERROR(less_op.AddOverload(
-        MakeOverloadDecl(StandardOverloadIds::kLessUintDouble, BoolType(),
-                         UintType(), DoubleType())));
-    CEL_RETURN_IF_ERROR(less_op.AddOverload(
-        MakeOverloadDecl(StandardOverloadIds::kLessDoubleInt, BoolType(),
-                         DoubleType(), IntType())));
-    CEL_RETURN_IF_ERROR(less_op.AddOverload(
-        MakeOverloadDecl(StandardOverloadIds::kLessDoubleUint, BoolType(),
-                         DoubleType(), UintType())));
-    // Greater
-    CEL_RETURN_IF_ERROR(greater_op.AddOverload(
-        MakeOverloadDecl(StandardOverloadIds::kGreaterIntUint, BoolType(),
-                         IntType(), UintType())));
-    CEL_RETURN_IF_ERROR(greater_op.AddOverload(
-        MakeOverloadDecl(StandardOverloadIds::kGreaterIntDouble, BoolType(),
-                         IntType(), DoubleType())));
-    CEL_RETURN_IF_ERROR(greater_op.AddOverload(
-        MakeOverloadDecl(StandardOverloadIds::kGreaterUintInt, BoolType(),
-                         UintType(), IntType())));
-    CEL_RETURN_IF_ERROR(greater_op.AddOverload(
-        MakeOverloadDecl(StandardOverloadIds::kGreaterUintDouble, BoolType(),
-                         UintType(), DoubleType())));
-    CEL_RETURN_IF_ERROR(greater_op.AddOverload(
-        MakeOverloadDecl(StandardOverloadIds::kGreaterDoubleInt, BoolType(),
-                         DoubleType(), IntType())));
-    CEL_RETURN_IF_ERROR(greater_op.AddOverload(
-        MakeOverloadDecl(StandardOverloadIds::kGreaterDoubleUint, BoolType(),
-                         DoubleType(), UintType())));
-    // LessEqual
-    CEL_RETURN_IF_ERROR(less_equals_op.AddOverload(
-        MakeOverloadDecl(StandardOverloadIds::kLessEqualsIntUint, BoolType(),
-                         IntType(), UintType())));
-    CEL_RETURN_IF_ERROR(less_equals_op.AddOverload(
-        MakeOverloadDecl(StandardOverloadIds::kLessEqualsIntDouble, BoolType(),
-                         IntType(), DoubleType())));
-
-    CEL_RETURN_IF_ERROR(less_equals_op.AddOverload(
-        MakeOverloadDecl(StandardOverloadIds::kLessEqualsUintInt, BoolType(),
-                         UintType(), IntType())));
-    CEL_RETURN_IF_ERROR(less_equals_op.AddOverload(
-        MakeOverloadDecl(StandardOverloadIds::kLessEqualsUintDouble, BoolType(),
-                         UintType(), DoubleType())));
-    CEL_RETURN_IF_ERROR(less_equals_op.AddOverload(
-        MakeOverloadDecl(StandardOverloadIds::kLessEqualsDoubleInt, BoolType(),
-                         DoubleType(), IntType())));
-    CEL_RETURN_IF_ERROR(less_equals_op.AddOverload(
-        MakeOverloadDecl(StandardOverloadIds::kLessEqualsDoubleUint, BoolType(),
-                         DoubleType(), UintType())));
-    // GreaterEqual
+  if (enable_cross_numeric_comparisons) {
     CEL_RETURN_IF_ERROR(greater_equals_op.AddOverload(
         MakeOverloadDecl(StandardOverloadIds::kGreaterEqualsIntUint, BoolType(),
                          IntType(), UintType())));
@@ -640,40 +698,37 @@ absl::Status AddRelationOps(TypeCheckerBuilder& builder) {
                          BoolType(), DoubleType(), UintType())));
   }
 
-  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(less_op)));
-  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(greater_op)));
-  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(less_equals_op)));
-  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(greater_equals_op)));
-
-  return absl::OkStatus();
+  return greater_equals_op;
 }
 
-absl::Status AddStringFunctions(TypeCheckerBuilder& builder) {
+absl::StatusOr<FunctionDecl> ContainsDecl() {
   FunctionDecl contains;
   contains.set_name(StandardFunctions::kStringContains);
   CEL_RETURN_IF_ERROR(contains.AddOverload(
       MakeMemberOverloadDecl(StandardOverloadIds::kContainsString, BoolType(),
                              StringType(), StringType())));
-  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(contains)));
+  return contains;
+}
 
+absl::StatusOr<FunctionDecl> StartsWithDecl() {
   FunctionDecl starts_with;
   starts_with.set_name(StandardFunctions::kStringStartsWith);
   CEL_RETURN_IF_ERROR(starts_with.AddOverload(
       MakeMemberOverloadDecl(StandardOverloadIds::kStartsWithString, BoolType(),
                              StringType(), StringType())));
-  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(starts_with)));
+  return starts_with;
+}
 
+absl::StatusOr<FunctionDecl> EndsWithDecl() {
   FunctionDecl ends_with;
   ends_with.set_name(StandardFunctions::kStringEndsWith);
   CEL_RETURN_IF_ERROR(ends_with.AddOverload(
       MakeMemberOverloadDecl(StandardOverloadIds::kEndsWithString, BoolType(),
                              StringType(), StringType())));
-  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(ends_with)));
-
-  return absl::OkStatus();
+  return ends_with;
 }
 
-absl::Status AddRegexFunctions(TypeCheckerBuilder& builder) {
+absl::StatusOr<FunctionDecl> MatchesDecl() {
   FunctionDecl matches;
   matches.set_name(StandardFunctions::kRegexMatch);
   CEL_RETURN_IF_ERROR(matches.AddOverload(
@@ -681,11 +736,10 @@ absl::Status AddRegexFunctions(TypeCheckerBuilder& builder) {
                              StringType(), StringType())));
   CEL_RETURN_IF_ERROR(matches.AddOverload(MakeOverloadDecl(
       StandardOverloadIds::kMatches, BoolType(), StringType(), StringType())));
-  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(matches)));
-  return absl::OkStatus();
+  return matches;
 }
 
-absl::Status AddTimeFunctions(TypeCheckerBuilder& builder) {
+absl::StatusOr<FunctionDecl> GetFullYearDecl() {
   FunctionDecl get_full_year;
   get_full_year.set_name(StandardFunctions::kFullYear);
   CEL_RETURN_IF_ERROR(get_full_year.AddOverload(MakeMemberOverloadDecl(
@@ -693,8 +747,10 @@ absl::Status AddTimeFunctions(TypeCheckerBuilder& builder) {
   CEL_RETURN_IF_ERROR(get_full_year.AddOverload(
       MakeMemberOverloadDecl(StandardOverloadIds::kTimestampToYearWithTz,
                              IntType(), TimestampType(), StringType())));
-  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(get_full_year)));
+  return get_full_year;
+}
 
+absl::StatusOr<FunctionDecl> GetMonthDecl() {
   FunctionDecl get_month;
   get_month.set_name(StandardFunctions::kMonth);
   CEL_RETURN_IF_ERROR(get_month.AddOverload(MakeMemberOverloadDecl(
@@ -702,8 +758,10 @@ absl::Status AddTimeFunctions(TypeCheckerBuilder& builder) {
   CEL_RETURN_IF_ERROR(get_month.AddOverload(
       MakeMemberOverloadDecl(StandardOverloadIds::kTimestampToMonthWithTz,
                              IntType(), TimestampType(), StringType())));
-  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(get_month)));
+  return get_month;
+}
 
+absl::StatusOr<FunctionDecl> GetDayOfYearDecl() {
   FunctionDecl get_day_of_year;
   get_day_of_year.set_name(StandardFunctions::kDayOfYear);
   CEL_RETURN_IF_ERROR(get_day_of_year.AddOverload(MakeMemberOverloadDecl(
@@ -711,8 +769,10 @@ absl::Status AddTimeFunctions(TypeCheckerBuilder& builder) {
   CEL_RETURN_IF_ERROR(get_day_of_year.AddOverload(
       MakeMemberOverloadDecl(StandardOverloadIds::kTimestampToDayOfYearWithTz,
                              IntType(), TimestampType(), StringType())));
-  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(get_day_of_year)));
+  return get_day_of_year;
+}
 
+absl::StatusOr<FunctionDecl> GetDayOfMonthDecl() {
   FunctionDecl get_day_of_month;
   get_day_of_month.set_name(StandardFunctions::kDayOfMonth);
   CEL_RETURN_IF_ERROR(get_day_of_month.AddOverload(
@@ -721,8 +781,10 @@ absl::Status AddTimeFunctions(TypeCheckerBuilder& builder) {
   CEL_RETURN_IF_ERROR(get_day_of_month.AddOverload(
       MakeMemberOverloadDecl(StandardOverloadIds::kTimestampToDayOfMonthWithTz,
                              IntType(), TimestampType(), StringType())));
-  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(get_day_of_month)));
+  return get_day_of_month;
+}
 
+absl::StatusOr<FunctionDecl> GetDateDecl() {
   FunctionDecl get_date;
   get_date.set_name(StandardFunctions::kDate);
   CEL_RETURN_IF_ERROR(get_date.AddOverload(MakeMemberOverloadDecl(
@@ -730,8 +792,10 @@ absl::Status AddTimeFunctions(TypeCheckerBuilder& builder) {
   CEL_RETURN_IF_ERROR(get_date.AddOverload(
       MakeMemberOverloadDecl(StandardOverloadIds::kTimestampToDateWithTz,
                              IntType(), TimestampType(), StringType())));
-  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(get_date)));
+  return get_date;
+}
 
+absl::StatusOr<FunctionDecl> GetDayOfWeekDecl() {
   FunctionDecl get_day_of_week;
   get_day_of_week.set_name(StandardFunctions::kDayOfWeek);
   CEL_RETURN_IF_ERROR(get_day_of_week.AddOverload(MakeMemberOverloadDecl(
@@ -739,8 +803,10 @@ absl::Status AddTimeFunctions(TypeCheckerBuilder& builder) {
   CEL_RETURN_IF_ERROR(get_day_of_week.AddOverload(
       MakeMemberOverloadDecl(StandardOverloadIds::kTimestampToDayOfWeekWithTz,
                              IntType(), TimestampType(), StringType())));
-  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(get_day_of_week)));
+  return get_day_of_week;
+}
 
+absl::StatusOr<FunctionDecl> GetHoursDecl() {
   FunctionDecl get_hours;
   get_hours.set_name(StandardFunctions::kHours);
   CEL_RETURN_IF_ERROR(get_hours.AddOverload(MakeMemberOverloadDecl(
@@ -750,8 +816,10 @@ absl::Status AddTimeFunctions(TypeCheckerBuilder& builder) {
                              IntType(), TimestampType(), StringType())));
   CEL_RETURN_IF_ERROR(get_hours.AddOverload(MakeMemberOverloadDecl(
       StandardOverloadIds::kDurationToHours, IntType(), DurationType())));
-  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(get_hours)));
+  return get_hours;
+}
 
+absl::StatusOr<FunctionDecl> GetMinutesDecl() {
   FunctionDecl get_minutes;
   get_minutes.set_name(StandardFunctions::kMinutes);
   CEL_RETURN_IF_ERROR(get_minutes.AddOverload(MakeMemberOverloadDecl(
@@ -761,8 +829,10 @@ absl::Status AddTimeFunctions(TypeCheckerBuilder& builder) {
                              IntType(), TimestampType(), StringType())));
   CEL_RETURN_IF_ERROR(get_minutes.AddOverload(MakeMemberOverloadDecl(
       StandardOverloadIds::kDurationToMinutes, IntType(), DurationType())));
-  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(get_minutes)));
+  return get_minutes;
+}
 
+absl::StatusOr<FunctionDecl> GetSecondsDecl() {
   FunctionDecl get_seconds;
   get_seconds.set_name(StandardFunctions::kSeconds);
   CEL_RETURN_IF_ERROR(get_seconds.AddOverload(MakeMemberOverloadDecl(
@@ -772,8 +842,10 @@ absl::Status AddTimeFunctions(TypeCheckerBuilder& builder) {
                              IntType(), TimestampType(), StringType())));
   CEL_RETURN_IF_ERROR(get_seconds.AddOverload(MakeMemberOverloadDecl(
       StandardOverloadIds::kDurationToSeconds, IntType(), DurationType())));
-  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(get_seconds)));
+  return get_seconds;
+}
 
+absl::StatusOr<FunctionDecl> GetMillisecondsDecl() {
   FunctionDecl get_milliseconds;
   get_milliseconds.set_name(StandardFunctions::kMilliseconds);
   CEL_RETURN_IF_ERROR(get_milliseconds.AddOverload(
@@ -785,9 +857,135 @@ absl::Status AddTimeFunctions(TypeCheckerBuilder& builder) {
   CEL_RETURN_IF_ERROR(get_milliseconds.AddOverload(
       MakeMemberOverloadDecl(StandardOverloadIds::kDurationToMilliseconds,
                              IntType(), DurationType())));
-  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(get_milliseconds)));
+  return get_milliseconds;
+}
 
-  return absl::OkStatus();
+using FunctionDeclFactory = absl::StatusOr<FunctionDecl> (*)();
+
+struct StandardFunction {
+  absl::string_view name;
+  FunctionDeclFactory factory;
+};
+
+// Functions whose declarations don't depend on the checker options.
+constexpr StandardFunction kStandardFunctions[] = {
+    // Logical
+    {StandardFunctions::kNot, &NotOpDecl},
+    {StandardFunctions::kAnd, &AndOpDecl},
+    {StandardFunctions::kOr, &OrOpDecl},
+    {StandardFunctions::kTernary, &ConditionalOpDecl},
+    {StandardFunctions::kNotStrictlyFalse, &NotStrictlyFalseDecl},
+    {StandardFunctions::kNotStrictlyFalseDeprecated,
+     &NotStrictlyFalseDeprecatedDecl},
+    // Arithmetic
+    {StandardFunctions::kAdd, &AddOpDecl},
+    {StandardFunctions::kSubtract, &SubtractOpDecl},
+    {StandardFunctions::kMultiply, &MultiplyOpDecl},
+    {StandardFunctions::kDivide, &DivisionOpDecl},
+    {StandardFunctions::kModulo, &ModuloOpDecl},
+    {StandardFunctions::kNeg, &NegateOpDecl},
+    // Type conversions
+    {StandardFunctions::kDyn, &ToDynDecl},
+    {StandardFunctions::kUint, &ToUintDecl},
+    {StandardFunctions::kInt, &ToIntDecl},
+    {StandardFunctions::kDouble, &ToDoubleDecl},
+    {"bool", &ToBoolDecl},
+    {StandardFunctions::kString, &ToStringDecl},
+    {StandardFunctions::kBytes, &ToBytesDecl},
+    {StandardFunctions::kTimestamp, &ToTimestampDecl},
+    {StandardFunctions::kDuration, &ToDurationDecl},
+    {StandardFunctions::kType, &ToTypeDecl},
+    // Equality
+    {StandardFunctions::kEqual, &EqualsOpDecl},
+    {StandardFunctions::kInequal, &NotEqualsOpDecl},
+    // Containers
+    {StandardFunctions::kIn, &InOpDecl},
+    {StandardFunctions::kInFunction, &InFunctionDeprecatedDecl},
+    {StandardFunctions::kInDeprecated, &InOpDeprecatedDecl},
+    {StandardFunctions::kSize, &SizeDecl},
+    // Strings
+    {StandardFunctions::kStringContains, &ContainsDecl},
+    {StandardFunctions::kStringStartsWith, &StartsWithDecl},
+    {StandardFunctions::kStringEndsWith, &EndsWithDecl},
+    // Regular expressions
+    {StandardFunctions::kRegexMatch, &MatchesDecl},
+    // Time
+    {StandardFunctions::kFullYear, &GetFullYearDecl},
+    {StandardFunctions::kMonth, &GetMonthDecl},
+    {StandardFunctions::kDayOfYear, &GetDayOfYearDecl},
+    {StandardFunctions::kDayOfMonth, &GetDayOfMonthDecl},
+    {StandardFunctions::kDate, &GetDateDecl},
+    {StandardFunctions::kDayOfWeek, &GetDayOfWeekDecl},
+    {StandardFunctions::kHours, &GetHoursDecl},
+    {StandardFunctions::kMinutes, &GetMinutesDecl},
+    {StandardFunctions::kSeconds, &GetSecondsDecl},
+    {StandardFunctions::kMilliseconds, &GetMillisecondsDecl},
+};
+
+using RelationDeclFactory =
+    absl::StatusOr<FunctionDecl> (*)(bool enable_cross_numeric_comparisons);
+
+struct RelationFunction {
+  absl::string_view name;
+  RelationDeclFactory factory;
+};
+
+constexpr RelationFunction kRelationFunctions[] = {
+    {StandardFunctions::kLess, &LessOpDecl},
+    {StandardFunctions::kGreater, &GreaterOpDecl},
+    {StandardFunctions::kLessOrEqual, &LessEqualsOpDecl},
+    {StandardFunctions::kGreaterOrEqual, &GreaterEqualsOpDecl},
+};
+
+// The function declarations are registered by name and only built when first
+// looked up. They are shared by every type checker using the standard library,
+// so each is built at most once per process.
+const std::deque<LazyFunctionDecl>& LazyStandardFunctionDecls() {
+  static absl::NoDestructor<std::deque<LazyFunctionDecl>> kDecls([] {
+    std::deque<LazyFunctionDecl> decls;
+    for (const StandardFunction& function : kStandardFunctions) {
+      decls.emplace_back(std::string(function.name), function.factory);
+    }
+    return decls;
+  }());
+  return *kDecls;
+}
+
+std::deque<LazyFunctionDecl> MakeLazyRelationDecls(
+    bool enable_cross_numeric_comparisons) {
+  std::deque<LazyFunctionDecl> decls;
+  for (const RelationFunction& function : kRelationFunctions) {
+    decls.emplace_back(
+        std::string(function.name),
+        [factory = function.factory, enable_cross_numeric_comparisons]() {
+          return factory(enable_cross_numeric_comparisons);
+        });
+  }
+  return decls;
+}
+
+const std::deque<LazyFunctionDecl>& LazyRelationDecls(
+    bool enable_cross_numeric_comparisons) {
+  static absl::NoDestructor<std::deque<LazyFunctionDecl>> kDecls(
+      MakeLazyRelationDecls(/*enable_cross_numeric_comparisons=*/false));
+  static absl::NoDestructor<std::deque<LazyFunctionDecl>> kCrossNumericDecls(
+      MakeLazyRelationDecls(/*enable_cross_numeric_comparisons=*/true));
+  return enable_cross_numeric_comparisons ? *kCrossNumericDecls : *kDecls;
+}
+
+absl::Status AddStandardFunctions(TypeCheckerBuilder& builder) {
+  for (const LazyFunctionDecl& decl : LazyStandardFunctionDecls()) {
+    CEL_RETURN_IF_ERROR(builder.AddLazyFunction(decl));
+  }
+  for (const LazyFunctionDecl& decl :
+       LazyRelationDecls(builder.options().enable_cross_numeric_comparisons)) {
+    CEL_RETURN_IF_ERROR(builder.AddLazyFunction(decl));
+  }
+
+  // Merged with any existing overloads rather than added, so this one is
+  // built up front.
+  CEL_ASSIGN_OR_RETURN(FunctionDecl index, IndexDecl());
+  return builder.MergeFunction(std::move(index));
 }
 
 absl::Status AddTypeConstantVariables(TypeCheckerBuilder& builder) {
@@ -843,15 +1041,7 @@ absl::Status AddEnumConstants(TypeCheckerBuilder& builder) {
 }
 
 absl::Status AddStandardLibraryDecls(TypeCheckerBuilder& builder) {
-  CEL_RETURN_IF_ERROR(AddLogicalOps(builder));
-  CEL_RETURN_IF_ERROR(AddArithmeticOps(builder));
-  CEL_RETURN_IF_ERROR(AddTypeConversions(builder));
-  CEL_RETURN_IF_ERROR(AddEqualityOps(builder));
-  CEL_RETURN_IF_ERROR(AddContainerOps(builder));
-  CEL_RETURN_IF_ERROR(AddRelationOps(builder));
-  CEL_RETURN_IF_ERROR(AddStringFunctions(builder));
-  CEL_RETURN_IF_ERROR(AddRegexFunctions(builder));
-  CEL_RETURN_IF_ERROR(AddTimeFunctions(builder));
+  CEL_RETURN_IF_ERROR(AddStandardFunctions(builder));
   CEL_RETURN_IF_ERROR(AddTypeConstantVariables(builder));
   CEL_RETURN_IF_ERROR(AddEnumConstants(builder));
   return absl::OkStatus();
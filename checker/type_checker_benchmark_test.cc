@@ -0,0 +1,320 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "absl/base/no_destructor.h"
+#include "absl/log/absl_check.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/string_view.h"
+#include "checker/standard_library.h"
+#include "checker/type_checker.h"
+#include "checker/type_checker_builder.h"
+#include "checker/type_checker_builder_factory.h"
+#include "checker/validation_result.h"
+#include "common/ast.h"
+#include "common/ast_proto.h"
+#include "common/decl.h"
+#include "common/type.h"
+#include "internal/benchmark.h"
+#include "internal/lexis.h"
+#include "internal/testing.h"
+#include "internal/testing_descriptor_pool.h"
+#include "parser/options.h"
+#include "parser/parser.h"
+#include "google/protobuf/descriptor.h"
+
+namespace cel {
+namespace {
+
+using ::cel::internal::GetSharedTestingDescriptorPool;
+
+struct BenchmarkCase {
+  std::string name;
+  std::string expression;
+};
+
+const std::vector<BenchmarkCase>& BenchmarkCases() {
+  static absl::NoDestructor<std::vector<BenchmarkCase>> cases(
+      std::vector<BenchmarkCase>{
+          {"identifiers", "x + y * 2 - x / (y + 1) > 10"},
+          {"message_fields",
+           "msg.single_int64 + msg.single_nested_message.bb > x && "
+           "msg.repeated_int32.exists(i, i > y)"},
+          {"message_construction",
+           "TestAllTypes{single_int64: x, single_string: 'a'}.single_int64 == "
+           "y"},
+          {"comprehension",
+           "[1, 2, 3].map(v, v * x).filter(v, v % 2 == 0).size() > 0 && "
+           "{'a': x, 'b': y}.all(k, k.startsWith('a') || k.size() == 1)"},
+          {"strings", "string(x) + 'a' in ['1a', '2a'] || name.endsWith('z')"},
+      });
+  return *cases;
+}
+
+// The checker is configured with a container so that every unqualified
+// reference expands into several namespace candidates.
+const TypeChecker& SharedChecker() {
+  static absl::NoDestructor<std::unique_ptr<TypeChecker>> checker([] {
+    auto builder =
+        CreateTypeCheckerBuilder(GetSharedTestingDescriptorPool()).value();
+    builder->set_container("cel.expr.conformance.proto3");
+    ABSL_CHECK_OK(builder->AddLibrary(StandardCheckerLibrary()));
+    ABSL_CHECK_OK(builder->AddVariable(MakeVariableDecl("x", IntType())));
+    ABSL_CHECK_OK(builder->AddVariable(MakeVariableDecl("y", IntType())));
+    ABSL_CHECK_OK(
+        builder->AddVariable(MakeVariableDecl("name", StringType())));
+    const google::protobuf::Descriptor* descriptor =
+        builder->descriptor_pool()->FindMessageTypeByName(
+            "cel.expr.conformance.proto3.TestAllTypes");
+    ABSL_CHECK(descriptor != nullptr);
+    ABSL_CHECK_OK(
+        builder->AddVariable(MakeVariableDecl("msg", MessageType(descriptor))));
+    return builder->Build().value();
+  }());
+  return **checker;
+}
+
+std::unique_ptr<Ast> Parse(absl::string_view expression) {
+  ParserOptions options;
+  // Nesting depth is one of the measured dimensions, so allow more than the
+  // default.
+  options.max_recursion_depth = 1024;
+  auto parsed = google::api::expr::parser::Parse(expression, "<input>", options)
+                    .value();
+  return CreateAstFromParsedExpr(parsed).value();
+}
+
+// The generated expressions below keep their depth bounded (the parser
+// balances `&&` chains) unless depth is what is being measured, so they stay
+// within the parser's recursion limit at every size.
+
+// `n` independent arithmetic comparisons joined with `&&`.
+std::string LargeExpression(int n) {
+  std::vector<std::string> clauses;
+  for (int i = 0; i < n; ++i) {
+    clauses.push_back(absl::StrCat("x + y * ", i, " > ", i));
+  }
+  return absl::StrJoin(clauses, " && ");
+}
+
+// Arithmetic nested `depth` levels deep.
+std::string DeeplyNestedExpression(int depth) {
+  std::string expression = "x";
+  for (int i = 0; i < depth; ++i) {
+    expression = absl::StrCat("(", expression, i % 2 == 0 ? " + " : " * ", i,
+                              ")");
+  }
+  return absl::StrCat(expression, " > 0");
+}
+
+// Arithmetic on `dyn` operands: every operator has to consider all of its
+// overloads.
+std::string DynArithmeticExpression(int n) {
+  std::vector<std::string> clauses;
+  for (int i = 0; i < n; ++i) {
+    clauses.push_back(
+        absl::StrCat("dyn(x) + dyn(y) * dyn(", i, ") - dyn(", i, ") > dyn(x)"));
+  }
+  return absl::StrJoin(clauses, " && ");
+}
+
+// List and map literals alternately nested `depth` levels deep, which
+// exercises generic type inference for the literal element types.
+std::string NestedLiteralExpression(int depth) {
+  std::string literal = "x";
+  for (int i = 0; i < depth; ++i) {
+    literal = i % 2 == 0 ? absl::StrCat("[", literal, ", ", literal, "]")
+                         : absl::StrCat("{'a': ", literal, "}");
+  }
+  return absl::StrCat("size(", literal, ") > 0");
+}
+
+// Presence tests on up to `n` fields of TestAllTypes, plus a message
+// construction and enum constant resolved against the container.
+std::string MessageFieldExpression(int n) {
+  const google::protobuf::Descriptor* descriptor =
+      GetSharedTestingDescriptorPool()->FindMessageTypeByName(
+          "cel.expr.conformance.proto3.TestAllTypes");
+  ABSL_CHECK(descriptor != nullptr);
+  std::vector<std::string> clauses;
+  for (int i = 0; i < descriptor->field_count() && i < n; ++i) {
+    const google::protobuf::FieldDescriptor* field = descriptor->field(i);
+    // Fields named after reserved words can't be selected.
+    if (field->real_containing_oneof() != nullptr ||
+        !internal::LexisIsIdentifier(field->name())) {
+      continue;
+    }
+    clauses.push_back(absl::StrCat("has(msg.", field->name(), ")"));
+  }
+  clauses.push_back(
+      "TestAllTypes{single_int64: x, standalone_enum: "
+      "TestAllTypes.NestedEnum.BAR}.single_int64 == y");
+  return absl::StrJoin(clauses, " && ");
+}
+
+struct GeneratedCase {
+  std::string name;
+  std::string (*generate)(int);
+};
+
+const std::vector<GeneratedCase>& GeneratedCases() {
+  static absl::NoDestructor<std::vector<GeneratedCase>> cases(
+      std::vector<GeneratedCase>{
+          {"large", &LargeExpression},
+          {"deeply_nested", &DeeplyNestedExpression},
+          {"dyn_arithmetic", &DynArithmeticExpression},
+          {"nested_literal", &NestedLiteralExpression},
+          {"message_fields", &MessageFieldExpression},
+      });
+  return *cases;
+}
+
+TEST(TypeCheckerBenchmarkTest, CasesAreValid) {
+  for (const BenchmarkCase& benchmark_case : BenchmarkCases()) {
+    ASSERT_OK_AND_ASSIGN(
+        ValidationResult result,
+        SharedChecker().Check(Parse(benchmark_case.expression)));
+    EXPECT_TRUE(result.IsValid())
+        << benchmark_case.name << ": " << result.FormatError();
+  }
+}
+
+TEST(TypeCheckerBenchmarkTest, GeneratedCasesAreValid) {
+  for (const GeneratedCase& generated_case : GeneratedCases()) {
+    for (int size : {1, 8}) {
+      ASSERT_OK_AND_ASSIGN(
+          ValidationResult result,
+          SharedChecker().Check(Parse(generated_case.generate(size))));
+      EXPECT_TRUE(result.IsValid()) << generated_case.name << "(" << size
+                                    << "): " << result.FormatError();
+    }
+  }
+}
+
+void RunCheckBenchmark(benchmark::State& state, absl::string_view expression) {
+  const TypeChecker& checker = SharedChecker();
+  std::unique_ptr<Ast> ast = Parse(expression);
+
+  // Each iteration copies the parsed AST, since `Check` consumes it. The copy
+  // is small relative to the check itself.
+  for (auto _ : state) {
+    auto result = checker.Check(std::make_unique<Ast>(*ast));
+    ABSL_DCHECK_OK(result);
+    benchmark::DoNotOptimize(result);
+  }
+}
+
+void BM_Check(benchmark::State& state) {
+  const BenchmarkCase& benchmark_case = BenchmarkCases()[state.range(0)];
+  RunCheckBenchmark(state, benchmark_case.expression);
+  state.SetLabel(benchmark_case.name);
+}
+
+BENCHMARK(BM_Check)->DenseRange(0, 4);
+
+void BM_CheckLargeExpression(benchmark::State& state) {
+  RunCheckBenchmark(state, LargeExpression(state.range(0)));
+}
+
+BENCHMARK(BM_CheckLargeExpression)->Range(8, 1024);
+
+void BM_CheckDeeplyNested(benchmark::State& state) {
+  RunCheckBenchmark(state, DeeplyNestedExpression(state.range(0)));
+}
+
+BENCHMARK(BM_CheckDeeplyNested)->Range(8, 64);
+
+void BM_CheckDynArithmetic(benchmark::State& state) {
+  RunCheckBenchmark(state, DynArithmeticExpression(state.range(0)));
+}
+
+BENCHMARK(BM_CheckDynArithmetic)->Range(1, 256);
+
+void BM_CheckNestedLiteral(benchmark::State& state) {
+  RunCheckBenchmark(state, NestedLiteralExpression(state.range(0)));
+}
+
+BENCHMARK(BM_CheckNestedLiteral)->DenseRange(2, 12, 2);
+
+void BM_CheckMessageFields(benchmark::State& state) {
+  RunCheckBenchmark(state, MessageFieldExpression(state.range(0)));
+}
+
+BENCHMARK(BM_CheckMessageFields)->Range(8, 256);
+
+// Checks every case per iteration from several threads sharing one checker,
+// and so one type check environment.
+void BM_CheckSharedEnv(benchmark::State& state) {
+  const TypeChecker& checker = SharedChecker();
+  std::vector<std::unique_ptr<Ast>> asts;
+  for (const BenchmarkCase& benchmark_case : BenchmarkCases()) {
+    asts.push_back(Parse(benchmark_case.expression));
+  }
+
+  for (auto _ : state) {
+    for (const auto& ast : asts) {
+      auto result = checker.Check(std::make_unique<Ast>(*ast));
+      ABSL_DCHECK_OK(result);
+      benchmark::DoNotOptimize(result);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * asts.size());
+}
+
+BENCHMARK(BM_CheckSharedEnv)
+    ->ThreadRange(1, std::thread::hardware_concurrency());
+
+std::unique_ptr<TypeCheckerBuilder> NewStandardBuilder() {
+  auto builder =
+      CreateTypeCheckerBuilder(GetSharedTestingDescriptorPool()).value();
+  ABSL_CHECK_OK(builder->AddLibrary(StandardCheckerLibrary()));
+  ABSL_CHECK_OK(builder->AddVariable(MakeVariableDecl("x", IntType())));
+  ABSL_CHECK_OK(builder->AddVariable(MakeVariableDecl("y", IntType())));
+  return builder;
+}
+
+// Creates a checker with the standard library, as done once per environment
+// at startup.
+void BM_BuildStandardChecker(benchmark::State& state) {
+  for (auto _ : state) {
+    auto checker = NewStandardBuilder()->Build();
+    ABSL_DCHECK_OK(checker);
+    benchmark::DoNotOptimize(checker);
+  }
+}
+
+BENCHMARK(BM_BuildStandardChecker);
+
+// Creates a checker and checks one expression with it, which also pays for
+// any declarations built on first use.
+void BM_BuildStandardCheckerAndCheck(benchmark::State& state) {
+  std::unique_ptr<Ast> ast = Parse(BenchmarkCases()[0].expression);
+
+  for (auto _ : state) {
+    auto checker = NewStandardBuilder()->Build().value();
+    auto result = checker->Check(std::make_unique<Ast>(*ast));
+    ABSL_DCHECK_OK(result);
+    benchmark::DoNotOptimize(result);
+  }
+}
+
+BENCHMARK(BM_BuildStandardCheckerAndCheck);
+
+}  // namespace
+}  // namespace cel
@@ -18,6 +18,7 @@
 #include <memory>
 #include <string>
 
+#include "absl/base/attributes.h"
 #include "absl/base/nullability.h"
 #include "absl/functional/any_invocable.h"
 #include "absl/status/status.h"
@@ -106,6 +107,20 @@ class TypeCheckerBuilder {
   // with the resulting TypeChecker.
   virtual absl::Status AddFunction(const FunctionDecl& decl) = 0;
 
+  // Adds a function declaration whose overloads are only built when a checked
+  // expression first refers to the function. Otherwise equivalent to
+  // `AddFunction`.
+  //
+  // Type checkers refer to `decl` rather than copying it, so a library can
+  // share one declaration between every type checker it is used in. `decl`
+  // must outlive the builder and any TypeChecker built from it.
+  //
+  // The declaration is validated against the builder's options when it is
+  // built. Errors from building or validating it are returned by
+  // `TypeChecker::Check`.
+  virtual absl::Status AddLazyFunction(
+      const LazyFunctionDecl& decl ABSL_ATTRIBUTE_LIFETIME_BOUND) = 0;
+
   // Adds function declaration overloads to the TypeChecker being built.
   //
   // Attempts to merge with any existing overloads for a function decl with the
@@ -507,6 +507,7 @@ absl::Status ExprToProto(const Expr& expr,
 }
 
 absl::Status ExprFromProto(const cel::expr::Expr& proto, Expr& expr) {
+  common_internal::ExprNodeArena expr_node_arena;
   ExprFromProtoState state;
   return state.ExprFromProto(proto, expr);
 }
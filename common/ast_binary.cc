@@ -0,0 +1,991 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Binary AST format
+//
+// All integers are unsigned LEB128 varints; signed integers are zigzag
+// encoded first. Strings are stored once in a table and referenced by index.
+//
+//   header       := "CELA" version:varint flags:varint
+//   string_table := count:varint (length:varint bytes)*
+//   body         := expr_version:str root:expr source_info
+//                   [reference_map type_map]   (if flags & kFlagChecked)
+//
+// Expressions are written in preorder. Each node is its tag, id and kind
+// specific fields, followed by its children in their natural order. Map-like
+// sections are sorted by expression id so that the encoding is deterministic.
+
+#include "common/ast_binary.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/casts.h"
+#include "absl/base/nullability.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/functional/overload.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "absl/types/variant.h"
+#include "common/ast.h"
+#include "common/constant.h"
+#include "common/expr.h"
+
+namespace cel {
+
+namespace {
+
+constexpr absl::string_view kMagic = "CELA";
+
+constexpr uint64_t kFlagChecked = 1;
+
+// Type specifiers are decoded recursively, so bound their nesting.
+constexpr int kMaxTypeSpecDepth = 128;
+
+// The fewest bytes an encoded expression node takes: its tag and its id.
+constexpr size_t kMinNodeSize = 2;
+
+enum class ExprTag : uint8_t {
+  kUnspecified = 0,
+  kConstant = 1,
+  kIdent = 2,
+  kSelect = 3,
+  kCall = 4,
+  kList = 5,
+  kStruct = 6,
+  kMap = 7,
+  kComprehension = 8,
+};
+
+enum class ConstantTag : uint8_t {
+  kUnspecified = 0,
+  kNull = 1,
+  kBool = 2,
+  kInt = 3,
+  kUint = 4,
+  kDouble = 5,
+  kBytes = 6,
+  kString = 7,
+  kDuration = 8,
+  kTimestamp = 9,
+};
+
+enum class TypeSpecTag : uint8_t {
+  kUnset = 0,
+  kDyn = 1,
+  kNull = 2,
+  kPrimitive = 3,
+  kWrapper = 4,
+  kWellKnown = 5,
+  kList = 6,
+  kMap = 7,
+  kFunction = 8,
+  kMessage = 9,
+  kParam = 10,
+  kType = 11,
+  kError = 12,
+  kAbstract = 13,
+};
+
+// Flags shared by optional child slots.
+constexpr uint8_t kFlagOptional = 1 << 0;
+constexpr uint8_t kFlagHasFirst = 1 << 1;
+constexpr uint8_t kFlagHasSecond = 1 << 2;
+
+uint64_t ZigZagEncode(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^
+         static_cast<uint64_t>(value >> 63);
+}
+
+int64_t ZigZagDecode(uint64_t value) {
+  return static_cast<int64_t>((value >> 1) ^ (~(value & 1) + 1));
+}
+
+template <typename Map>
+std::vector<typename Map::const_pointer> SortedById(const Map& map) {
+  std::vector<typename Map::const_pointer> entries;
+  entries.reserve(map.size());
+  for (const auto& entry : map) {
+    entries.push_back(&entry);
+  }
+  std::sort(entries.begin(), entries.end(),
+            [](auto lhs, auto rhs) { return lhs->first < rhs->first; });
+  return entries;
+}
+
+class Encoder {
+ public:
+  std::string Finish(uint64_t flags) && {
+    std::string out;
+    out.reserve(kMagic.size() + 16 + strings_size_ + body_.size());
+    out.append(kMagic.data(), kMagic.size());
+    AppendVarint(out, kBinaryAstFormatVersion);
+    AppendVarint(out, flags);
+    AppendVarint(out, strings_.size());
+    for (absl::string_view string : strings_) {
+      AppendVarint(out, string.size());
+      out.append(string.data(), string.size());
+    }
+    out.append(body_);
+    return out;
+  }
+
+  void Byte(uint8_t value) { body_.push_back(static_cast<char>(value)); }
+
+  void Varint(uint64_t value) { AppendVarint(body_, value); }
+
+  void SignedVarint(int64_t value) { Varint(ZigZagEncode(value)); }
+
+  void Double(double value) {
+    uint64_t bits = absl::bit_cast<uint64_t>(value);
+    for (int i = 0; i < 8; ++i) {
+      Byte(static_cast<uint8_t>(bits >> (8 * i)));
+    }
+  }
+
+  // `value` must remain valid until `Finish` is called.
+  void String(absl::string_view value) {
+    auto [it, inserted] = string_indices_.try_emplace(
+        value, static_cast<uint32_t>(strings_.size()));
+    if (inserted) {
+      strings_.push_back(value);
+      strings_size_ += value.size();
+    }
+    Varint(it->second);
+  }
+
+  void Expression(const Expr& root) {
+    std::vector<const Expr*> stack;
+    stack.push_back(&root);
+    while (!stack.empty()) {
+      const Expr* expr = stack.back();
+      stack.pop_back();
+      size_t first_child = stack.size();
+      Node(*expr, stack);
+      std::reverse(stack.begin() + first_child, stack.end());
+    }
+  }
+
+  void Constant(const cel::Constant& constant) {
+    absl::visit(
+        absl::Overload(
+            [this](absl::monostate) { Tag(ConstantTag::kUnspecified); },
+            [this](std::nullptr_t) { Tag(ConstantTag::kNull); },
+            [this](bool value) {
+              Tag(ConstantTag::kBool);
+              Byte(value ? 1 : 0);
+            },
+            [this](int64_t value) {
+              Tag(ConstantTag::kInt);
+              SignedVarint(value);
+            },
+            [this](uint64_t value) {
+              Tag(ConstantTag::kUint);
+              Varint(value);
+            },
+            [this](double value) {
+              Tag(ConstantTag::kDouble);
+              Double(value);
+            },
+            [this](const BytesConstant& value) {
+              Tag(ConstantTag::kBytes);
+              String(value);
+            },
+            [this](const StringConstant& value) {
+              Tag(ConstantTag::kString);
+              String(value);
+            },
+            [this](absl::Duration value) {
+              absl::Duration remainder;
+              int64_t seconds =
+                  absl::IDivDuration(value, absl::Seconds(1), &remainder);
+              Tag(ConstantTag::kDuration);
+              SignedVarint(seconds);
+              SignedVarint(absl::ToInt64Nanoseconds(remainder));
+            },
+            [this](absl::Time value) {
+              int64_t seconds = absl::ToUnixSeconds(value);
+              Tag(ConstantTag::kTimestamp);
+              SignedVarint(seconds);
+              SignedVarint(absl::ToInt64Nanoseconds(
+                  value - absl::FromUnixSeconds(seconds)));
+            }),
+        constant.kind());
+  }
+
+  void Type(const TypeSpec& type) {
+    absl::visit(
+        absl::Overload(
+            [this](const UnsetTypeSpec&) { Tag(TypeSpecTag::kUnset); },
+            [this](const DynTypeSpec&) { Tag(TypeSpecTag::kDyn); },
+            [this](const NullTypeSpec&) { Tag(TypeSpecTag::kNull); },
+            [this](PrimitiveType primitive) {
+              Tag(TypeSpecTag::kPrimitive);
+              Varint(static_cast<uint64_t>(primitive));
+            },
+            [this](const PrimitiveTypeWrapper& wrapper) {
+              Tag(TypeSpecTag::kWrapper);
+              Varint(static_cast<uint64_t>(wrapper.type()));
+            },
+            [this](WellKnownTypeSpec well_known) {
+              Tag(TypeSpecTag::kWellKnown);
+              Varint(static_cast<uint64_t>(well_known));
+            },
+            [this](const ListTypeSpec& list_type) {
+              Tag(TypeSpecTag::kList);
+              Type(list_type.elem_type());
+            },
+            [this](const MapTypeSpec& map_type) {
+              Tag(TypeSpecTag::kMap);
+              Type(map_type.key_type());
+              Type(map_type.value_type());
+            },
+            [this](const FunctionTypeSpec& function) {
+              Tag(TypeSpecTag::kFunction);
+              Type(function.result_type());
+              Types(function.arg_types());
+            },
+            [this](const MessageTypeSpec& message_type) {
+              Tag(TypeSpecTag::kMessage);
+              String(message_type.type());
+            },
+            [this](const ParamTypeSpec& param_type) {
+              Tag(TypeSpecTag::kParam);
+              String(param_type.type());
+            },
+            [this](const std::unique_ptr<TypeSpec>& type_type) {
+              Tag(TypeSpecTag::kType);
+              Byte(type_type != nullptr ? 1 : 0);
+              if (type_type != nullptr) {
+                Type(*type_type);
+              }
+            },
+            [this](ErrorTypeSpec) { Tag(TypeSpecTag::kError); },
+            [this](const AbstractType& abstract_type) {
+              Tag(TypeSpecTag::kAbstract);
+              String(abstract_type.name());
+              Types(abstract_type.parameter_types());
+            }),
+        type.type_kind());
+  }
+
+ private:
+  static void AppendVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+      out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+      value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+  }
+
+  template <typename T>
+  void Tag(T tag) {
+    Byte(static_cast<uint8_t>(tag));
+  }
+
+  void Types(const std::vector<TypeSpec>& types) {
+    Varint(types.size());
+    for (const auto& type : types) {
+      Type(type);
+    }
+  }
+
+  // Writes the tag, id and fields of `expr` and appends its children to
+  // `children` in their natural order.
+  void Node(const Expr& expr, std::vector<const Expr*>& children) {
+    absl::visit(
+        absl::Overload(
+            [&](const UnspecifiedExpr&) {
+              Tag(ExprTag::kUnspecified);
+              SignedVarint(expr.id());
+            },
+            [&](const cel::Constant& constant) {
+              Tag(ExprTag::kConstant);
+              SignedVarint(expr.id());
+              Constant(constant);
+            },
+            [&](const IdentExpr& ident_expr) {
+              Tag(ExprTag::kIdent);
+              SignedVarint(expr.id());
+              String(ident_expr.name());
+            },
+            [&](const SelectExpr& select_expr) {
+              Tag(ExprTag::kSelect);
+              SignedVarint(expr.id());
+              String(select_expr.field());
+              Byte((select_expr.test_only() ? kFlagOptional : 0) |
+                   (select_expr.has_operand() ? kFlagHasFirst : 0));
+              if (select_expr.has_operand()) {
+                children.push_back(&select_expr.operand());
+              }
+            },
+            [&](const CallExpr& call_expr) {
+              Tag(ExprTag::kCall);
+              SignedVarint(expr.id());
+              String(call_expr.function());
+              Byte(call_expr.has_target() ? kFlagHasFirst : 0);
+              Varint(call_expr.args().size());
+              if (call_expr.has_target()) {
+                children.push_back(&call_expr.target());
+              }
+              for (const auto& arg : call_expr.args()) {
+                children.push_back(&arg);
+              }
+            },
+            [&](const ListExpr& list_expr) {
+              Tag(ExprTag::kList);
+              SignedVarint(expr.id());
+              Varint(list_expr.elements().size());
+              for (const auto& element : list_expr.elements()) {
+                Byte((element.optional() ? kFlagOptional : 0) |
+                     (element.has_expr() ? kFlagHasFirst : 0));
+                if (element.has_expr()) {
+                  children.push_back(&element.expr());
+                }
+              }
+            },
+            [&](const StructExpr& struct_expr) {
+              Tag(ExprTag::kStruct);
+              SignedVarint(expr.id());
+              String(struct_expr.name());
+              Varint(struct_expr.fields().size());
+              for (const auto& field : struct_expr.fields()) {
+                SignedVarint(field.id());
+                String(field.name());
+                Byte((field.optional() ? kFlagOptional : 0) |
+                     (field.has_value() ? kFlagHasFirst : 0));
+                if (field.has_value()) {
+                  children.push_back(&field.value());
+                }
+              }
+            },
+            [&](const MapExpr& map_expr) {
+              Tag(ExprTag::kMap);
+              SignedVarint(expr.id());
+              Varint(map_expr.entries().size());
+              for (const auto& entry : map_expr.entries()) {
+                SignedVarint(entry.id());
+                Byte((entry.optional() ? kFlagOptional : 0) |
+                     (entry.has_key() ? kFlagHasFirst : 0) |
+                     (entry.has_value() ? kFlagHasSecond : 0));
+                if (entry.has_key()) {
+                  children.push_back(&entry.key());
+                }
+                if (entry.has_value()) {
+                  children.push_back(&entry.value());
+                }
+              }
+            },
+            [&](const ComprehensionExpr& comprehension_expr) {
+              Tag(ExprTag::kComprehension);
+              SignedVarint(expr.id());
+              String(comprehension_expr.iter_var());
+              String(comprehension_expr.iter_var2());
+              String(comprehension_expr.accu_var());
+              const Expr* subexpressions[] = {
+                  comprehension_expr.has_iter_range()
+                      ? &comprehension_expr.iter_range()
+                      : nullptr,
+                  comprehension_expr.has_accu_init()
+                      ? &comprehension_expr.accu_init()
+                      : nullptr,
+                  comprehension_expr.has_loop_condition()
+                      ? &comprehension_expr.loop_condition()
+                      : nullptr,
+                  comprehension_expr.has_loop_step()
+                      ? &comprehension_expr.loop_step()
+                      : nullptr,
+                  comprehension_expr.has_result()
+                      ? &comprehension_expr.result()
+                      : nullptr,
+              };
+              uint8_t present = 0;
+              for (int i = 0; i < 5; ++i) {
+                if (subexpressions[i] != nullptr) {
+                  present |= 1 << i;
+                  children.push_back(subexpressions[i]);
+                }
+              }
+              Byte(present);
+            }),
+        expr.kind());
+  }
+
+  std::string body_;
+  std::vector<absl::string_view> strings_;
+  size_t strings_size_ = 0;
+  absl::flat_hash_map<absl::string_view, uint32_t> string_indices_;
+};
+
+// Reads the binary format. Read errors are sticky: once the input is found to
+// be malformed, every subsequent read returns a default value and `ok()`
+// returns false.
+class Decoder {
+ public:
+  explicit Decoder(absl::string_view data) : data_(data) {}
+
+  bool ok() const { return ok_; }
+
+  bool empty() const { return position_ == data_.size(); }
+
+  bool Fail() {
+    ok_ = false;
+    position_ = data_.size();
+    return false;
+  }
+
+  bool Prefix(absl::string_view prefix) {
+    if (data_.substr(position_, prefix.size()) != prefix) {
+      return Fail();
+    }
+    position_ += prefix.size();
+    return true;
+  }
+
+  uint8_t Byte() {
+    if (position_ == data_.size()) {
+      Fail();
+      return 0;
+    }
+    return static_cast<uint8_t>(data_[position_++]);
+  }
+
+  uint64_t Varint() {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      if (position_ == data_.size()) {
+        Fail();
+        return 0;
+      }
+      auto byte = static_cast<uint8_t>(data_[position_++]);
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) {
+        return value;
+      }
+    }
+    Fail();
+    return 0;
+  }
+
+  int64_t SignedVarint() { return ZigZagDecode(Varint()); }
+
+  // Reads an enumerator of `E`, whose enumerators run from zero to `last`.
+  // Out-of-range values are rejected rather than cast into the enum.
+  template <typename E>
+  E Enum(E last) {
+    uint64_t value = Varint();
+    if (value > static_cast<uint64_t>(last)) {
+      Fail();
+      return E();
+    }
+    return static_cast<E>(value);
+  }
+
+  // Reads the number of elements of a sequence. Each element takes at least
+  // one byte, so larger counts are rejected before anything is allocated.
+  size_t Count() {
+    uint64_t count = Varint();
+    if (count > data_.size() - position_) {
+      Fail();
+      return 0;
+    }
+    return static_cast<size_t>(count);
+  }
+
+  // Reads the number of elements of an expression node, each of which takes
+  // at least `element_size` bytes of its own. The `pending` child nodes read
+  // so far are decoded later, taking at least `kMinNodeSize` bytes each, so
+  // the elements must fit in what remains after them. Without this, each of
+  // a chain of nodes could claim nearly all remaining bytes for its children,
+  // allocating quadratically in the size of the input before failing.
+  size_t NodeCount(size_t element_size, size_t pending) {
+    uint64_t count = Varint();
+    size_t remaining = data_.size() - position_;
+    if (pending > remaining / kMinNodeSize ||
+        count > (remaining - pending * kMinNodeSize) / element_size) {
+      Fail();
+      return 0;
+    }
+    return static_cast<size_t>(count);
+  }
+
+  double Double() {
+    if (data_.size() - position_ < 8) {
+      Fail();
+      return 0;
+    }
+    uint64_t bits = 0;
+    for (int i = 0; i < 8; ++i) {
+      bits |= static_cast<uint64_t>(static_cast<uint8_t>(data_[position_++]))
+              << (8 * i);
+    }
+    return absl::bit_cast<double>(bits);
+  }
+
+  bool StringTable() {
+    size_t count = Count();
+    strings_.reserve(count);
+    for (size_t i = 0; i < count && ok_; ++i) {
+      size_t size = Count();
+      strings_.push_back(data_.substr(position_, size));
+      position_ += size;
+    }
+    return ok_;
+  }
+
+  absl::string_view String() {
+    uint64_t index = Varint();
+    if (index >= strings_.size()) {
+      Fail();
+      return absl::string_view();
+    }
+    return strings_[index];
+  }
+
+  bool Expression(Expr& root) {
+    std::vector<Expr*> stack;
+    stack.push_back(&root);
+    while (!stack.empty() && ok_) {
+      Expr* expr = stack.back();
+      stack.pop_back();
+      size_t first_child = stack.size();
+      Node(*expr, stack);
+      std::reverse(stack.begin() + first_child, stack.end());
+    }
+    return ok_;
+  }
+
+  cel::Constant Constant() {
+    cel::Constant constant;
+    switch (static_cast<ConstantTag>(Byte())) {
+      case ConstantTag::kUnspecified:
+        break;
+      case ConstantTag::kNull:
+        constant.set_null_value();
+        break;
+      case ConstantTag::kBool:
+        constant.set_bool_value(Byte() != 0);
+        break;
+      case ConstantTag::kInt:
+        constant.set_int_value(SignedVarint());
+        break;
+      case ConstantTag::kUint:
+        constant.set_uint_value(Varint());
+        break;
+      case ConstantTag::kDouble:
+        constant.set_double_value(Double());
+        break;
+      case ConstantTag::kBytes:
+        constant.set_bytes_value(String());
+        break;
+      case ConstantTag::kString:
+        constant.set_string_value(String());
+        break;
+      case ConstantTag::kDuration: {
+        int64_t seconds = SignedVarint();
+        int64_t nanos = SignedVarint();
+        constant.set_duration_value(absl::Seconds(seconds) +
+                                    absl::Nanoseconds(nanos));
+        break;
+      }
+      case ConstantTag::kTimestamp: {
+        int64_t seconds = SignedVarint();
+        int64_t nanos = SignedVarint();
+        constant.set_timestamp_value(absl::FromUnixSeconds(seconds) +
+                                     absl::Nanoseconds(nanos));
+        break;
+      }
+      default:
+        Fail();
+        break;
+    }
+    return constant;
+  }
+
+  TypeSpec Type(int depth = 0) {
+    if (depth > kMaxTypeSpecDepth) {
+      Fail();
+      return TypeSpec();
+    }
+    switch (static_cast<TypeSpecTag>(Byte())) {
+      case TypeSpecTag::kUnset:
+        return TypeSpec();
+      case TypeSpecTag::kDyn:
+        return TypeSpec(DynTypeSpec());
+      case TypeSpecTag::kNull:
+        return TypeSpec(NullTypeSpec());
+      case TypeSpecTag::kPrimitive:
+        return TypeSpec(Enum(PrimitiveType::kBytes));
+      case TypeSpecTag::kWrapper:
+        return TypeSpec(PrimitiveTypeWrapper(Enum(PrimitiveType::kBytes)));
+      case TypeSpecTag::kWellKnown:
+        return TypeSpec(Enum(WellKnownTypeSpec::kDuration));
+      case TypeSpecTag::kList:
+        return TypeSpec(
+            ListTypeSpec(std::make_unique<TypeSpec>(Type(depth + 1))));
+      case TypeSpecTag::kMap: {
+        auto key_type = std::make_unique<TypeSpec>(Type(depth + 1));
+        auto value_type = std::make_unique<TypeSpec>(Type(depth + 1));
+        return TypeSpec(
+            MapTypeSpec(std::move(key_type), std::move(value_type)));
+      }
+      case TypeSpecTag::kFunction: {
+        auto result_type = std::make_unique<TypeSpec>(Type(depth + 1));
+        return TypeSpec(
+            FunctionTypeSpec(std::move(result_type), Types(depth + 1)));
+      }
+      case TypeSpecTag::kMessage:
+        return TypeSpec(MessageTypeSpec(std::string(String())));
+      case TypeSpecTag::kParam:
+        return TypeSpec(ParamTypeSpec(std::string(String())));
+      case TypeSpecTag::kType:
+        if (Byte() == 0) {
+          return TypeSpec(std::unique_ptr<TypeSpec>());
+        }
+        return TypeSpec(std::make_unique<TypeSpec>(Type(depth + 1)));
+      case TypeSpecTag::kError:
+        return TypeSpec(ErrorTypeSpec::kValue);
+      case TypeSpecTag::kAbstract: {
+        std::string name(String());
+        return TypeSpec(AbstractType(std::move(name), Types(depth + 1)));
+      }
+      default:
+        Fail();
+        return TypeSpec();
+    }
+  }
+
+ private:
+  std::vector<TypeSpec> Types(int depth) {
+    size_t count = Count();
+    std::vector<TypeSpec> types;
+    types.reserve(count);
+    for (size_t i = 0; i < count && ok_; ++i) {
+      types.push_back(Type(depth));
+    }
+    return types;
+  }
+
+  // Reads the tag, id and fields of `expr` and appends the slots for its
+  // children to `children` in their natural order.
+  void Node(Expr& expr, std::vector<Expr*>& children) {
+    auto tag = static_cast<ExprTag>(Byte());
+    expr.set_id(SignedVarint());
+    switch (tag) {
+      case ExprTag::kUnspecified:
+        break;
+      case ExprTag::kConstant:
+        expr.mutable_const_expr() = Constant();
+        break;
+      case ExprTag::kIdent:
+        expr.mutable_ident_expr().set_name(std::string(String()));
+        break;
+      case ExprTag::kSelect: {
+        auto& select_expr = expr.mutable_select_expr();
+        select_expr.set_field(std::string(String()));
+        uint8_t flags = Byte();
+        select_expr.set_test_only((flags & kFlagOptional) != 0);
+        if ((flags & kFlagHasFirst) != 0) {
+          children.push_back(&select_expr.mutable_operand());
+        }
+        break;
+      }
+      case ExprTag::kCall: {
+        auto& call_expr = expr.mutable_call_expr();
+        call_expr.set_function(std::string(String()));
+        uint8_t flags = Byte();
+        if ((flags & kFlagHasFirst) != 0) {
+          children.push_back(&call_expr.mutable_target());
+        }
+        // Arguments are child nodes, with nothing encoded inline.
+        size_t arg_count = NodeCount(kMinNodeSize, children.size());
+        auto& args = call_expr.mutable_args();
+        args.resize(arg_count);
+        for (auto& arg : args) {
+          children.push_back(&arg);
+        }
+        break;
+      }
+      case ExprTag::kList: {
+        auto& elements = expr.mutable_list_expr().mutable_elements();
+        // Flags.
+        elements.resize(NodeCount(1, children.size()));
+        for (auto& element : elements) {
+          uint8_t flags = Byte();
+          element.set_optional((flags & kFlagOptional) != 0);
+          if ((flags & kFlagHasFirst) != 0) {
+            children.push_back(&element.mutable_expr());
+          }
+        }
+        break;
+      }
+      case ExprTag::kStruct: {
+        auto& struct_expr = expr.mutable_struct_expr();
+        struct_expr.set_name(std::string(String()));
+        auto& fields = struct_expr.mutable_fields();
+        // Id, name and flags.
+        fields.resize(NodeCount(3, children.size()));
+        for (auto& field : fields) {
+          field.set_id(SignedVarint());
+          field.set_name(std::string(String()));
+          uint8_t flags = Byte();
+          field.set_optional((flags & kFlagOptional) != 0);
+          if ((flags & kFlagHasFirst) != 0) {
+            children.push_back(&field.mutable_value());
+          }
+        }
+        break;
+      }
+      case ExprTag::kMap: {
+        auto& entries = expr.mutable_map_expr().mutable_entries();
+        // Id and flags.
+        entries.resize(NodeCount(2, children.size()));
+        for (auto& entry : entries) {
+          entry.set_id(SignedVarint());
+          uint8_t flags = Byte();
+          entry.set_optional((flags & kFlagOptional) != 0);
+          if ((flags & kFlagHasFirst) != 0) {
+            children.push_back(&entry.mutable_key());
+          }
+          if ((flags & kFlagHasSecond) != 0) {
+            children.push_back(&entry.mutable_value());
+          }
+        }
+        break;
+      }
+      case ExprTag::kComprehension: {
+        auto& comprehension_expr = expr.mutable_comprehension_expr();
+        comprehension_expr.set_iter_var(std::string(String()));
+        comprehension_expr.set_iter_var2(std::string(String()));
+        comprehension_expr.set_accu_var(std::string(String()));
+        uint8_t present = Byte();
+        if ((present & (1 << 0)) != 0) {
+          children.push_back(&comprehension_expr.mutable_iter_range());
+        }
+        if ((present & (1 << 1)) != 0) {
+          children.push_back(&comprehension_expr.mutable_accu_init());
+        }
+        if ((present & (1 << 2)) != 0) {
+          children.push_back(&comprehension_expr.mutable_loop_condition());
+        }
+        if ((present & (1 << 3)) != 0) {
+          children.push_back(&comprehension_expr.mutable_loop_step());
+        }
+        if ((present & (1 << 4)) != 0) {
+          children.push_back(&comprehension_expr.mutable_result());
+        }
+        break;
+      }
+      default:
+        Fail();
+        break;
+    }
+  }
+
+  absl::string_view data_;
+  size_t position_ = 0;
+  bool ok_ = true;
+  std::vector<absl::string_view> strings_;
+};
+
+void EncodeSourceInfo(const SourceInfo& source_info, Encoder& encoder) {
+  encoder.String(source_info.syntax_version());
+  encoder.String(source_info.location());
+
+  encoder.Varint(source_info.line_offsets().size());
+  for (int32_t line_offset : source_info.line_offsets()) {
+    encoder.SignedVarint(line_offset);
+  }
+
+  encoder.Varint(source_info.positions().size());
+  for (const auto* position : SortedById(source_info.positions())) {
+    encoder.SignedVarint(position->first);
+    encoder.SignedVarint(position->second);
+  }
+
+  encoder.Varint(source_info.macro_calls().size());
+  for (const auto* macro_call : SortedById(source_info.macro_calls())) {
+    encoder.SignedVarint(macro_call->first);
+    encoder.Expression(macro_call->second);
+  }
+
+  encoder.Varint(source_info.extensions().size());
+  for (const auto& extension : source_info.extensions()) {
+    encoder.String(extension.id());
+    encoder.SignedVarint(extension.version().major());
+    encoder.SignedVarint(extension.version().minor());
+    encoder.Varint(extension.affected_components().size());
+    for (auto component : extension.affected_components()) {
+      encoder.Varint(static_cast<uint64_t>(component));
+    }
+  }
+}
+
+bool DecodeSourceInfo(Decoder& decoder, SourceInfo& source_info) {
+  source_info.set_syntax_version(std::string(decoder.String()));
+  source_info.set_location(std::string(decoder.String()));
+
+  size_t count = decoder.Count();
+  auto& line_offsets = source_info.mutable_line_offsets();
+  line_offsets.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    line_offsets.push_back(static_cast<int32_t>(decoder.SignedVarint()));
+  }
+
+  count = decoder.Count();
+  auto& positions = source_info.mutable_positions();
+  positions.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    int64_t id = decoder.SignedVarint();
+    positions[id] = static_cast<int32_t>(decoder.SignedVarint());
+  }
+
+  count = decoder.Count();
+  auto& macro_calls = source_info.mutable_macro_calls();
+  macro_calls.reserve(count);
+  for (size_t i = 0; i < count && decoder.ok(); ++i) {
+    int64_t id = decoder.SignedVarint();
+    decoder.Expression(macro_calls[id]);
+  }
+
+  count = decoder.Count();
+  auto& extensions = source_info.mutable_extensions();
+  extensions.reserve(count);
+  for (size_t i = 0; i < count && decoder.ok(); ++i) {
+    auto& extension = extensions.emplace_back();
+    extension.set_id(std::string(decoder.String()));
+    extension.mutable_version().set_major(decoder.SignedVarint());
+    extension.mutable_version().set_minor(decoder.SignedVarint());
+    size_t component_count = decoder.Count();
+    auto& components = extension.mutable_affected_components();
+    components.reserve(component_count);
+    for (size_t j = 0; j < component_count; ++j) {
+      components.push_back(
+          decoder.Enum(ExtensionSpec::Component::kRuntime));
+    }
+  }
+  return decoder.ok();
+}
+
+}  // namespace
+
+absl::Status AstToBinary(const Ast& ast, std::string* absl_nonnull out) {
+  Encoder encoder;
+  encoder.String(ast.expr_version());
+  encoder.Expression(ast.root_expr());
+  EncodeSourceInfo(ast.source_info(), encoder);
+
+  uint64_t flags = 0;
+  if (ast.is_checked()) {
+    flags |= kFlagChecked;
+
+    encoder.Varint(ast.reference_map().size());
+    for (const auto* reference : SortedById(ast.reference_map())) {
+      encoder.SignedVarint(reference->first);
+      encoder.String(reference->second.name());
+      encoder.Varint(reference->second.overload_id().size());
+      for (const auto& overload_id : reference->second.overload_id()) {
+        encoder.String(overload_id);
+      }
+      encoder.Byte(reference->second.has_value() ? 1 : 0);
+      if (reference->second.has_value()) {
+        encoder.Constant(reference->second.value());
+      }
+    }
+
+    encoder.Varint(ast.type_map().size());
+    for (const auto* type : SortedById(ast.type_map())) {
+      encoder.SignedVarint(type->first);
+      encoder.Type(type->second);
+    }
+  }
+
+  *out = std::move(encoder).Finish(flags);
+  return absl::OkStatus();
+}
+
+absl::StatusOr<std::unique_ptr<Ast>> CreateAstFromBinary(
+    absl::string_view data) {
+  Decoder decoder(data);
+  if (!decoder.Prefix(kMagic)) {
+    return absl::InvalidArgumentError("not a binary CEL AST");
+  }
+  uint64_t version = decoder.Varint();
+  if (decoder.ok() && version != kBinaryAstFormatVersion) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("unsupported binary CEL AST format version: ", version));
+  }
+  uint64_t flags = decoder.Varint();
+
+  Expr root_expr;
+  SourceInfo source_info;
+  common_internal::ExprNodeArena expr_node_arena;
+  decoder.StringTable();
+  std::string expr_version(decoder.String());
+  decoder.Expression(root_expr);
+  DecodeSourceInfo(decoder, source_info);
+
+  if ((flags & kFlagChecked) == 0) {
+    if (!decoder.ok() || !decoder.empty()) {
+      return absl::InvalidArgumentError("malformed binary CEL AST");
+    }
+    auto ast =
+        std::make_unique<Ast>(std::move(root_expr), std::move(source_info));
+    ast->set_expr_version(expr_version);
+    return ast;
+  }
+
+  Ast::ReferenceMap reference_map;
+  size_t count = decoder.Count();
+  reference_map.reserve(count);
+  for (size_t i = 0; i < count && decoder.ok(); ++i) {
+    Reference& reference = reference_map[decoder.SignedVarint()];
+    reference.set_name(std::string(decoder.String()));
+    size_t overload_count = decoder.Count();
+    auto& overload_ids = reference.mutable_overload_id();
+    overload_ids.reserve(overload_count);
+    for (size_t j = 0; j < overload_count; ++j) {
+      overload_ids.push_back(std::string(decoder.String()));
+    }
+    if (decoder.Byte() != 0) {
+      reference.set_value(decoder.Constant());
+    }
+  }
+
+  Ast::TypeMap type_map;
+  count = decoder.Count();
+  type_map.reserve(count);
+  for (size_t i = 0; i < count && decoder.ok(); ++i) {
+    int64_t id = decoder.SignedVarint();
+    type_map[id] = decoder.Type();
+  }
+
+  if (!decoder.ok() || !decoder.empty()) {
+    return absl::InvalidArgumentError("malformed binary CEL AST");
+  }
+  return std::make_unique<Ast>(std::move(root_expr), std::move(source_info),
+                               std::move(reference_map), std::move(type_map),
+                               std::move(expr_version));
+}
+
+}  // namespace cel
@@ -0,0 +1,54 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_COMMON_AST_BINARY_H_
+#define THIRD_PARTY_CEL_CPP_COMMON_AST_BINARY_H_
+
+#include <memory>
+#include <string>
+
+#include "absl/base/nullability.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "common/ast.h"
+
+namespace cel {
+
+// Version of the binary AST format written by `AstToBinary`.
+inline constexpr int kBinaryAstFormatVersion = 1;
+
+// Serializes `ast`, including its source info and, if it is checked, its
+// reference and type maps, to the compact binary AST format.
+//
+// Unlike a serialized `cel::expr::CheckedExpr`, the binary format is decoded
+// directly into a `cel::Ast` without an intermediate message, so it is
+// suitable for loading large numbers of pre-checked expressions, e.g. from a
+// memory mapped file. The encoding is deterministic for a given AST.
+//
+// To skip parsing and checking when a process starts, store the checked ASTs
+// in this format and pass the decoded ASTs to `Runtime::CreateProgram`.
+absl::Status AstToBinary(const Ast& ast, std::string* absl_nonnull out);
+
+// Creates an AST from the binary encoding produced by `AstToBinary`.
+//
+// `data` is only read during the call and need not outlive the result.
+// Returns an InvalidArgument error if `data` is not a well-formed binary AST
+// of a supported format version.
+absl::StatusOr<std::unique_ptr<Ast>> CreateAstFromBinary(
+    absl::string_view data);
+
+}  // namespace cel
+
+#endif  // THIRD_PARTY_CEL_CPP_COMMON_AST_BINARY_H_
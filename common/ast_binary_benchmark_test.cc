@@ -0,0 +1,147 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cel/expr/checked.pb.h"
+#include "absl/base/no_destructor.h"
+#include "absl/log/absl_check.h"
+#include "absl/status/status_matchers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "common/ast.h"
+#include "common/ast_binary.h"
+#include "common/ast_proto.h"
+#include "common/decl.h"
+#include "common/type.h"
+#include "compiler/compiler.h"
+#include "compiler/compiler_factory.h"
+#include "compiler/standard_library.h"
+#include "internal/benchmark.h"
+#include "internal/testing.h"
+#include "internal/testing_descriptor_pool.h"
+
+namespace cel {
+namespace {
+
+using ::absl_testing::IsOk;
+using ::cel::expr::CheckedExpr;
+
+struct BenchmarkCase {
+  std::string name;
+  std::string expression;
+};
+
+std::string LongExpression() {
+  std::string expression = "x";
+  for (int i = 0; i < 200; ++i) {
+    absl::StrAppend(&expression, " + (x * ", i, " > y ? ", i, " : x)");
+  }
+  return expression;
+}
+
+const std::vector<BenchmarkCase>& BenchmarkCases() {
+  static absl::NoDestructor<std::vector<BenchmarkCase>> cases(
+      std::vector<BenchmarkCase>{
+          {"simple", "x + y > 10"},
+          {"comprehension",
+           "[1, 2, 3].map(i, i * x).filter(i, i > y).exists(i, i == 6) && "
+           "{'a': x, 'b': y}.all(k, k.startsWith('a') || k.size() == 1)"},
+          {"long", LongExpression()},
+      });
+  return *cases;
+}
+
+std::unique_ptr<Ast> Compile(absl::string_view expression) {
+  auto builder =
+      cel::NewCompilerBuilder(internal::GetTestingDescriptorPool()).value();
+  ABSL_CHECK_OK(builder->AddLibrary(cel::StandardCompilerLibrary()));
+  ABSL_CHECK_OK(builder->GetCheckerBuilder().AddVariable(
+      MakeVariableDecl("x", IntType())));
+  ABSL_CHECK_OK(builder->GetCheckerBuilder().AddVariable(
+      MakeVariableDecl("y", IntType())));
+  auto compiler = builder->Build().value();
+  auto result = compiler->Compile(expression).value();
+  ABSL_CHECK(result.IsValid()) << result.FormatError();
+  return result.ReleaseAst().value();
+}
+
+TEST(AstBinaryBenchmarkTest, CasesRoundTrip) {
+  for (const BenchmarkCase& benchmark_case : BenchmarkCases()) {
+    std::unique_ptr<Ast> ast = Compile(benchmark_case.expression);
+    std::string binary;
+    ASSERT_THAT(AstToBinary(*ast, &binary), IsOk());
+    ASSERT_OK_AND_ASSIGN(auto decoded, CreateAstFromBinary(binary));
+    EXPECT_EQ(decoded->root_expr(), ast->root_expr()) << benchmark_case.name;
+    EXPECT_EQ(decoded->type_map(), ast->type_map()) << benchmark_case.name;
+  }
+}
+
+// Loads a serialized `CheckedExpr` the way callers do today: parse the
+// message, then convert it to a `cel::Ast`.
+void BM_LoadFromCheckedExpr(benchmark::State& state) {
+  const BenchmarkCase& benchmark_case = BenchmarkCases()[state.range(0)];
+  std::unique_ptr<Ast> ast = Compile(benchmark_case.expression);
+  CheckedExpr checked_expr;
+  ABSL_CHECK_OK(AstToCheckedExpr(*ast, &checked_expr));
+  std::string serialized = checked_expr.SerializeAsString();
+
+  for (auto _ : state) {
+    CheckedExpr parsed;
+    ABSL_CHECK(parsed.ParseFromString(serialized));
+    auto loaded = CreateAstFromCheckedExpr(parsed);
+    ABSL_DCHECK_OK(loaded);
+    benchmark::DoNotOptimize(loaded);
+  }
+  state.SetLabel(benchmark_case.name);
+  state.SetBytesProcessed(state.iterations() * serialized.size());
+}
+
+BENCHMARK(BM_LoadFromCheckedExpr)->DenseRange(0, 2);
+
+void BM_LoadFromBinary(benchmark::State& state) {
+  const BenchmarkCase& benchmark_case = BenchmarkCases()[state.range(0)];
+  std::unique_ptr<Ast> ast = Compile(benchmark_case.expression);
+  std::string binary;
+  ABSL_CHECK_OK(AstToBinary(*ast, &binary));
+
+  for (auto _ : state) {
+    auto loaded = CreateAstFromBinary(binary);
+    ABSL_DCHECK_OK(loaded);
+    benchmark::DoNotOptimize(loaded);
+  }
+  state.SetLabel(benchmark_case.name);
+  state.SetBytesProcessed(state.iterations() * binary.size());
+}
+
+BENCHMARK(BM_LoadFromBinary)->DenseRange(0, 2);
+
+void BM_SaveToBinary(benchmark::State& state) {
+  const BenchmarkCase& benchmark_case = BenchmarkCases()[state.range(0)];
+  std::unique_ptr<Ast> ast = Compile(benchmark_case.expression);
+
+  for (auto _ : state) {
+    std::string binary;
+    ABSL_CHECK_OK(AstToBinary(*ast, &binary));
+    benchmark::DoNotOptimize(binary);
+  }
+  state.SetLabel(benchmark_case.name);
+}
+
+BENCHMARK(BM_SaveToBinary)->DenseRange(0, 2);
+
+}  // namespace
+}  // namespace cel
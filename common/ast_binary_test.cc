@@ -0,0 +1,248 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/ast_binary.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "common/ast.h"
+#include "common/constant.h"
+#include "common/expr.h"
+#include "common/source.h"
+#include "internal/status_macros.h"
+#include "internal/testing.h"
+#include "parser/options.h"
+#include "parser/parser.h"
+
+namespace cel {
+namespace {
+
+using ::absl_testing::IsOk;
+using ::absl_testing::StatusIs;
+using ::testing::HasSubstr;
+using ::testing::Not;
+
+absl::StatusOr<std::unique_ptr<Ast>> Parse(absl::string_view expr) {
+  static const auto* parser = [] {
+    ParserOptions options;
+    options.enable_optional_syntax = true;
+    return cel::NewParserBuilder(options)->Build()->release();
+  }();
+  CEL_ASSIGN_OR_RETURN(auto source, cel::NewSource(expr));
+  return parser->Parse(*source);
+}
+
+void ExpectAstEq(const Ast& actual, const Ast& expected) {
+  EXPECT_EQ(actual.is_checked(), expected.is_checked());
+  EXPECT_EQ(actual.expr_version(), expected.expr_version());
+  EXPECT_EQ(actual.root_expr(), expected.root_expr());
+  EXPECT_EQ(actual.source_info(), expected.source_info());
+  EXPECT_EQ(actual.reference_map(), expected.reference_map());
+  EXPECT_EQ(actual.type_map(), expected.type_map());
+}
+
+std::unique_ptr<Ast> RoundTrip(const Ast& ast) {
+  std::string binary;
+  EXPECT_THAT(AstToBinary(ast, &binary), IsOk());
+  auto decoded = CreateAstFromBinary(binary);
+  EXPECT_THAT(decoded, IsOk());
+  if (!decoded.ok()) {
+    return nullptr;
+  }
+  std::string reencoded;
+  EXPECT_THAT(AstToBinary(**decoded, &reencoded), IsOk());
+  EXPECT_EQ(reencoded, binary);
+  return std::move(decoded).value();
+}
+
+class AstBinaryParsedTest : public testing::TestWithParam<std::string> {};
+
+TEST_P(AstBinaryParsedTest, RoundTrip) {
+  ASSERT_OK_AND_ASSIGN(auto ast, Parse(GetParam()));
+  ast->mutable_source_info().set_syntax_version("cel1");
+  auto& extension =
+      ast->mutable_source_info().mutable_extensions().emplace_back();
+  extension.set_id("optional");
+  extension.mutable_version().set_major(1);
+  extension.mutable_affected_components().push_back(
+      ExtensionSpec::Component::kParser);
+
+  auto decoded = RoundTrip(*ast);
+  ASSERT_NE(decoded, nullptr);
+  ExpectAstEq(*decoded, *ast);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    AstBinaryParsedTest, AstBinaryParsedTest,
+    testing::Values("null", "true", "-42", "42u", "3.25", "b'\\xff\\x00'",
+                    "'caf\\u00e9'", "a.b.c", "has(a.b)", "f(x, y)",
+                    "x.startsWith('a')", "[1, ?x, 3]", "{'a': 1, ?b: c}",
+                    "Msg{field: 1, ?other: x}", "a.?b[?0]",
+                    "[1, 2].exists(x, x > 1) && m.all(k, k == 1)",
+                    "a ? b : c || d\n  && e"));
+
+TEST(AstBinary, CheckedRoundTrip) {
+  ASSERT_OK_AND_ASSIGN(auto parsed, Parse("x + 1 == y"));
+
+  Ast::ReferenceMap reference_map;
+  reference_map[1] = Reference("x", {}, Constant());
+  Constant folded;
+  folded.set_duration_value(absl::Seconds(-3) - absl::Nanoseconds(5));
+  reference_map[2] = Reference("", {"add_int64", "add_double"}, folded);
+  Constant timestamp;
+  timestamp.set_timestamp_value(absl::FromUnixSeconds(-1) +
+                                absl::Nanoseconds(250));
+  reference_map[3] = Reference("y", {}, timestamp);
+
+  Ast::TypeMap type_map;
+  type_map[1] = TypeSpec(PrimitiveType::kInt64);
+  type_map[2] = TypeSpec(DynTypeSpec());
+  type_map[3] = TypeSpec(NullTypeSpec());
+  type_map[4] = TypeSpec(PrimitiveTypeWrapper(PrimitiveType::kString));
+  type_map[5] = TypeSpec(WellKnownTypeSpec::kTimestamp);
+  type_map[6] = TypeSpec(
+      ListTypeSpec(std::make_unique<TypeSpec>(MessageTypeSpec("pkg.Msg"))));
+  type_map[7] =
+      TypeSpec(MapTypeSpec(std::make_unique<TypeSpec>(PrimitiveType::kString),
+                           std::make_unique<TypeSpec>(ParamTypeSpec("T"))));
+  std::vector<TypeSpec> arg_types;
+  arg_types.push_back(TypeSpec(PrimitiveType::kBool));
+  arg_types.push_back(TypeSpec(ErrorTypeSpec::kValue));
+  type_map[8] = TypeSpec(FunctionTypeSpec(
+      std::make_unique<TypeSpec>(PrimitiveType::kDouble),
+      std::move(arg_types)));
+  type_map[9] = TypeSpec(std::make_unique<TypeSpec>(PrimitiveType::kBytes));
+  std::vector<TypeSpec> parameter_types;
+  parameter_types.push_back(TypeSpec(PrimitiveType::kUint64));
+  type_map[10] =
+      TypeSpec(AbstractType("optional_type", std::move(parameter_types)));
+  type_map[11] = TypeSpec();
+
+  Ast ast(parsed->root_expr(), parsed->source_info(), std::move(reference_map),
+          std::move(type_map), "1.0");
+
+  auto decoded = RoundTrip(ast);
+  ASSERT_NE(decoded, nullptr);
+  ExpectAstEq(*decoded, ast);
+}
+
+TEST(AstBinary, EmptyAst) {
+  Ast ast;
+  auto decoded = RoundTrip(ast);
+  ASSERT_NE(decoded, nullptr);
+  ExpectAstEq(*decoded, ast);
+}
+
+TEST(AstBinary, RejectsTruncatedInput) {
+  ASSERT_OK_AND_ASSIGN(auto parsed, Parse("[1, 2].map(x, {'k': x * 2.0})"));
+  Ast::TypeMap type_map;
+  type_map[1] = TypeSpec(
+      ListTypeSpec(std::make_unique<TypeSpec>(PrimitiveType::kInt64)));
+  Ast ast(parsed->root_expr(), parsed->source_info(), {}, std::move(type_map),
+          "");
+  std::string binary;
+  ASSERT_THAT(AstToBinary(ast, &binary), IsOk());
+
+  for (size_t size = 0; size < binary.size(); ++size) {
+    EXPECT_THAT(CreateAstFromBinary(absl::string_view(binary).substr(0, size)),
+                StatusIs(absl::StatusCode::kInvalidArgument))
+        << "size: " << size;
+  }
+  EXPECT_THAT(CreateAstFromBinary(binary + "x"),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(AstBinary, RejectsCorruptInput) {
+  ASSERT_OK_AND_ASSIGN(auto parsed, Parse("a.b(c, [d, {e: f}])"));
+  std::string binary;
+  ASSERT_THAT(AstToBinary(*parsed, &binary), IsOk());
+
+  // Flipping bits must never crash; the result may or may not decode.
+  for (size_t i = 0; i < binary.size(); ++i) {
+    for (int bit = 0; bit < 8; ++bit) {
+      std::string corrupt = binary;
+      corrupt[i] ^= static_cast<char>(1 << bit);
+      (void)CreateAstFromBinary(corrupt);
+    }
+  }
+}
+
+TEST(AstBinary, RejectsOutOfRangeTypeEnums) {
+  ASSERT_OK_AND_ASSIGN(auto parsed, Parse("x"));
+  std::vector<TypeSpec> types;
+  types.push_back(TypeSpec(PrimitiveType::kBytes));
+  types.push_back(TypeSpec(PrimitiveTypeWrapper(PrimitiveType::kBytes)));
+  types.push_back(TypeSpec(WellKnownTypeSpec::kDuration));
+  for (auto& type : types) {
+    Ast::TypeMap type_map;
+    type_map[1] = std::move(type);
+    Ast ast(parsed->root_expr(), parsed->source_info(), {},
+            std::move(type_map), "");
+    std::string binary;
+    ASSERT_THAT(AstToBinary(ast, &binary), IsOk());
+    ASSERT_THAT(CreateAstFromBinary(binary), IsOk());
+
+    // The type is encoded last, ending with its enumerator, which is the
+    // last one of its enum.
+    ++binary.back();
+    EXPECT_THAT(CreateAstFromBinary(binary),
+                StatusIs(absl::StatusCode::kInvalidArgument));
+  }
+}
+
+TEST(AstBinary, RejectsChildCountsExceedingInput) {
+  // A header with one empty string, used as the expression version and as
+  // every function name.
+  std::string binary("CELA");
+  binary.push_back(static_cast<char>(kBinaryAstFormatVersion));
+  binary.append("\x00\x01\x00\x00", 4);
+  // A chain of calls, each claiming half as many arguments as there are bytes
+  // left after it, which the input could hold were it the only call. Nothing
+  // is allocated for arguments the rest of the input cannot hold along with
+  // those already claimed, otherwise this would take tens of gigabytes.
+  constexpr int kCallSize = 7;
+  constexpr int kCalls = 8192;
+  for (int i = 0; i < kCalls; ++i) {
+    binary.append("\x04\x00\x00\x00", 4);  // Tag, id, function, flags.
+    // The argument count, as a varint padded to three bytes.
+    uint64_t arg_count = (kCalls - 1 - i) * kCallSize / 2;
+    binary.push_back(static_cast<char>((arg_count & 0x7f) | 0x80));
+    binary.push_back(static_cast<char>(((arg_count >> 7) & 0x7f) | 0x80));
+    binary.push_back(static_cast<char>(arg_count >> 14));
+  }
+  EXPECT_THAT(CreateAstFromBinary(binary),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(AstBinary, RejectsUnknownFormat) {
+  EXPECT_THAT(CreateAstFromBinary("CELB\x01\x00"),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("not a binary CEL AST")));
+  EXPECT_THAT(CreateAstFromBinary(absl::string_view("CELA\x02\x00", 6)),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("unsupported binary CEL AST format version")));
+  EXPECT_THAT(CreateAstFromBinary(""), Not(IsOk()));
+}
+
+}  // namespace
+}  // namespace cel
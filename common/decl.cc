@@ -19,9 +19,11 @@
 #include <utility>
 #include <vector>
 
+#include "absl/base/call_once.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/log/absl_check.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "common/type.h"
 #include "common/type_kind.h"
@@ -184,4 +186,16 @@ void FunctionDecl::AddOverloadImpl(OverloadDecl&& overload,
                       std::move(overload), status);
 }
 
+const absl::StatusOr<FunctionDecl>& LazyFunctionDecl::Get() const {
+  absl::call_once(once_, [this]() {
+    decl_ = factory_();
+    if (decl_.ok() && decl_->name() != name_) {
+      decl_ = absl::InternalError(
+          absl::StrCat("lazy declaration of function '", name_,
+                       "' built function '", decl_->name(), "'"));
+    }
+  });
+  return decl_;
+}
+
 }  // namespace cel
@@ -22,7 +22,9 @@
 
 #include "absl/algorithm/container.h"
 #include "absl/base/attributes.h"
+#include "absl/base/call_once.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/functional/any_invocable.h"
 #include "absl/hash/hash.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -368,6 +370,41 @@ absl::StatusOr<FunctionDecl> MakeFunctionDecl(std::string name,
   return function_decl;
 }
 
+// `LazyFunctionDecl` is a function declaration whose overloads are only built
+// when first needed.
+//
+// The name is known up front. The declaration itself is built by `factory` on
+// the first call to `Get` and cached, so a single instance (usually with static
+// storage duration) can be shared by any number of environments that declare
+// the function.
+class LazyFunctionDecl final {
+ public:
+  using Factory = absl::AnyInvocable<absl::StatusOr<FunctionDecl>() const>;
+
+  LazyFunctionDecl(std::string name, Factory factory)
+      : name_(std::move(name)), factory_(std::move(factory)) {}
+
+  LazyFunctionDecl(const LazyFunctionDecl&) = delete;
+  LazyFunctionDecl& operator=(const LazyFunctionDecl&) = delete;
+
+  ABSL_MUST_USE_RESULT const std::string& name() const
+      ABSL_ATTRIBUTE_LIFETIME_BOUND {
+    return name_;
+  }
+
+  // Returns the declaration, building it on the first call. Thread-safe.
+  //
+  // It is an error for the factory to build a declaration with a different
+  // name.
+  const absl::StatusOr<FunctionDecl>& Get() const ABSL_ATTRIBUTE_LIFETIME_BOUND;
+
+ private:
+  std::string name_;
+  Factory factory_;
+  mutable absl::once_flag once_;
+  mutable absl::StatusOr<FunctionDecl> decl_;
+};
+
 namespace common_internal {
 
 // Checks whether `from` is assignable to `to`.
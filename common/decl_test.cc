@@ -15,6 +15,7 @@
 #include "common/decl.h"
 
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "common/constant.h"
 #include "common/type.h"
 #include "internal/testing.h"
@@ -23,6 +24,7 @@
 namespace cel {
 namespace {
 
+using ::absl_testing::IsOk;
 using ::absl_testing::StatusIs;
 using ::testing::ElementsAre;
 using ::testing::IsEmpty;
@@ -159,6 +161,32 @@ TEST(FunctionDecl, Overloads) {
               StatusIs(absl::StatusCode::kInvalidArgument));
 }
 
+TEST(LazyFunctionDecl, BuildsOnce) {
+  int calls = 0;
+  LazyFunctionDecl lazy_decl("hello", [&calls]() {
+    ++calls;
+    return MakeFunctionDecl("hello",
+                            MakeOverloadDecl("foo", StringType{}, IntType{}));
+  });
+  EXPECT_EQ(lazy_decl.name(), "hello");
+  EXPECT_EQ(calls, 0);
+
+  const absl::StatusOr<FunctionDecl>& function_decl = lazy_decl.Get();
+  ASSERT_THAT(function_decl, IsOk());
+  EXPECT_THAT(function_decl->overloads(),
+              ElementsAre(Property(&OverloadDecl::id, "foo")));
+  EXPECT_EQ(&lazy_decl.Get(), &function_decl);
+  EXPECT_EQ(calls, 1);
+}
+
+TEST(LazyFunctionDecl, NameMismatch) {
+  LazyFunctionDecl lazy_decl("hello", []() {
+    return MakeFunctionDecl("goodbye",
+                            MakeOverloadDecl("foo", StringType{}, IntType{}));
+  });
+  EXPECT_THAT(lazy_decl.Get(), StatusIs(absl::StatusCode::kInternal));
+}
+
 using common_internal::TypeIsAssignable;
 
 TEST(TypeIsAssignable, BoolWrapper) {
@@ -14,16 +14,130 @@
 
 #include "common/expr.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
 #include <utility>
 #include <vector>
 
+#include "absl/base/attributes.h"
 #include "absl/base/no_destructor.h"
+#include "absl/container/inlined_vector.h"
 #include "absl/functional/overload.h"
 #include "absl/types/variant.h"
 #include "common/constant.h"
 
 namespace cel {
 
+namespace common_internal {
+
+namespace {
+
+// Every node is preceded by a header holding the block it was allocated from,
+// or null if it was allocated from the heap.
+constexpr size_t kNodeHeaderSize = alignof(std::max_align_t);
+
+// Most expressions are small, so blocks start small and grow for larger trees.
+// The cap bounds the memory a long-lived node can keep alive.
+constexpr size_t kMinBlockSize = size_t{1} << 10;
+constexpr size_t kMaxBlockSize = size_t{32} << 10;
+
+// Held on a block while its arena allocates from it. Far larger than the
+// number of nodes a block can hold.
+constexpr int64_t kArenaReference = int64_t{1} << 62;
+
+// The arena `Expr::operator new` allocates from on this thread.
+ABSL_CONST_INIT thread_local ExprNodeArena* current_expr_node_arena = nullptr;
+
+}  // namespace
+
+struct alignas(kNodeHeaderSize) ExprNodeArena::Block {
+  // Each freed node drops one reference. When the arena retires the block, it
+  // trades its own reference for one per node it allocated, so the count
+  // reaches zero with the last node either way.
+  std::atomic<int64_t> references{kArenaReference};
+};
+
+static_assert(alignof(Expr) <= kNodeHeaderSize);
+
+ExprNodeArena::ExprNodeArena()
+    : active_(current_expr_node_arena == nullptr),
+      next_block_size_(kMinBlockSize) {
+  if (active_) {
+    current_expr_node_arena = this;
+  }
+}
+
+ExprNodeArena::~ExprNodeArena() {
+  if (active_) {
+    current_expr_node_arena = nullptr;
+    Retire();
+  }
+}
+
+void* ExprNodeArena::Allocate(size_t size) {
+  if (ExprNodeArena* arena = current_expr_node_arena; arena != nullptr) {
+    return arena->AllocateFromBlock(size);
+  }
+  char* memory = static_cast<char*>(::operator new(kNodeHeaderSize + size));
+  ::new (memory) Block*(nullptr);
+  return memory + kNodeHeaderSize;
+}
+
+void ExprNodeArena::Deallocate(void* node) {
+  char* memory = static_cast<char*>(node) - kNodeHeaderSize;
+  Block* block = *std::launder(reinterpret_cast<Block**>(memory));
+  if (block == nullptr) {
+    ::operator delete(memory);
+    return;
+  }
+  Unref(block, 1);
+}
+
+void ExprNodeArena::Unref(Block* block, int64_t count) {
+  if (block->references.fetch_sub(count, std::memory_order_acq_rel) == count) {
+    block->~Block();
+    ::operator delete(block);
+  }
+}
+
+void* ExprNodeArena::AllocateFromBlock(size_t size) {
+  const size_t needed =
+      kNodeHeaderSize +
+      (size + kNodeHeaderSize - 1) / kNodeHeaderSize * kNodeHeaderSize;
+  if (static_cast<size_t>(end_ - next_) < needed) {
+    Retire();
+    const size_t block_size =
+        std::max(next_block_size_, sizeof(Block) + needed);
+    next_block_size_ = std::min(next_block_size_ * 2, kMaxBlockSize);
+    char* memory = static_cast<char*>(::operator new(block_size));
+    block_ = ::new (memory) Block();
+    next_ = memory + sizeof(Block);
+    end_ = memory + block_size;
+  }
+  char* memory = next_;
+  next_ += needed;
+  ++allocated_;
+  ::new (memory) Block*(block_);
+  return memory + kNodeHeaderSize;
+}
+
+void ExprNodeArena::Retire() {
+  if (block_ == nullptr) {
+    return;
+  }
+  // Frees the block now if its nodes are already gone.
+  Unref(block_, kArenaReference - allocated_);
+  block_ = nullptr;
+  next_ = nullptr;
+  end_ = nullptr;
+  allocated_ = 0;
+}
+
+}  // namespace common_internal
+
 namespace {
 
 struct CopyStackRecord {
@@ -133,6 +247,7 @@ void CopyNode(CopyStackRecord element, std::vector<CopyStackRecord>& stack) {
 }
 
 void CloneImpl(const Expr& expr, Expr& dst) {
+  common_internal::ExprNodeArena arena;
   std::vector<CopyStackRecord> stack;
   stack.push_back({&expr, &dst});
   while (!stack.empty()) {
@@ -142,6 +257,84 @@ void CloneImpl(const Expr& expr, Expr& dst) {
   }
 }
 
+bool HasChildren(const ExprKind& kind) {
+  return !absl::holds_alternative<UnspecifiedExpr>(kind) &&
+         !absl::holds_alternative<Constant>(kind) &&
+         !absl::holds_alternative<IdentExpr>(kind);
+}
+
+// Kinds awaiting destruction. Most nodes have no non-leaf children, so the
+// stack rarely outgrows its inline storage.
+using DetachStack = absl::InlinedVector<ExprKind, 4>;
+
+// Moves the kinds of the non-leaf children of `kind` onto `stack`, leaving
+// `kind` with only leaf children so that destroying it does not recurse.
+void DetachChildren(ExprKind& kind, DetachStack& stack) {
+  auto detach = [&stack](Expr& child) {
+    if (HasChildren(child.kind())) {
+      stack.push_back(child.release_kind());
+    }
+  };
+  absl::visit(
+      absl::Overload(
+          [](UnspecifiedExpr&) {}, [](Constant&) {}, [](IdentExpr&) {},
+          [&](SelectExpr& s) {
+            if (s.has_operand()) {
+              detach(s.mutable_operand());
+            }
+          },
+          [&](CallExpr& c) {
+            if (c.has_target()) {
+              detach(c.mutable_target());
+            }
+            for (auto& arg : c.mutable_args()) {
+              detach(arg);
+            }
+          },
+          [&](ListExpr& l) {
+            for (auto& element : l.mutable_elements()) {
+              if (element.has_expr()) {
+                detach(element.mutable_expr());
+              }
+            }
+          },
+          [&](StructExpr& s) {
+            for (auto& field : s.mutable_fields()) {
+              if (field.has_value()) {
+                detach(field.mutable_value());
+              }
+            }
+          },
+          [&](MapExpr& m) {
+            for (auto& entry : m.mutable_entries()) {
+              if (entry.has_key()) {
+                detach(entry.mutable_key());
+              }
+              if (entry.has_value()) {
+                detach(entry.mutable_value());
+              }
+            }
+          },
+          [&](ComprehensionExpr& c) {
+            if (c.has_iter_range()) {
+              detach(c.mutable_iter_range());
+            }
+            if (c.has_accu_init()) {
+              detach(c.mutable_accu_init());
+            }
+            if (c.has_loop_condition()) {
+              detach(c.mutable_loop_condition());
+            }
+            if (c.has_loop_step()) {
+              detach(c.mutable_loop_step());
+            }
+            if (c.has_result()) {
+              detach(c.mutable_result());
+            }
+          }),
+      kind);
+}
+
 }  // namespace
 
 const UnspecifiedExpr& UnspecifiedExpr::default_instance() {
@@ -201,4 +394,22 @@ Expr& Expr::operator=(const Expr& other) {
 
 Expr::Expr(const Expr& other) { CloneImpl(other, *this); }
 
+Expr::~Expr() {
+  if (HasChildren(kind_)) {
+    DetachSubtree(kind_);
+  }
+}
+
+void Expr::DetachSubtree(ExprKind& kind) {
+  // Nodes whose children are all leaves detach nothing, and return without
+  // allocating.
+  DetachStack stack;
+  DetachChildren(kind, stack);
+  while (!stack.empty()) {
+    ExprKind child = std::move(stack.back());
+    stack.pop_back();
+    DetachChildren(child, stack);
+  }
+}
+
 }  // namespace cel
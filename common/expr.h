@@ -15,6 +15,7 @@
 #ifndef THIRD_PARTY_CEL_CPP_COMMON_EXPR_H_
 #define THIRD_PARTY_CEL_CPP_COMMON_EXPR_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -922,10 +923,77 @@ enum class ExprKindCase {
   kComprehensionExpr,
 };
 
+namespace common_internal {
+
+// While alive, allocates the `Expr` nodes created with `new` on this thread,
+// including the children created by the `mutable_*()` accessors, from shared
+// blocks instead of one heap allocation each. Parsers and decoders use one per
+// tree they build, so that its nodes are cheap to create and free and sit next
+// to each other in memory.
+//
+// Nodes are still owned through `std::unique_ptr<Expr>`, so they may outlive
+// the arena and be freed on any thread. A block is returned to the heap once
+// the arena has moved past it and every node allocated from it is freed.
+//
+// An arena created while another is active on the same thread defers to it.
+// Arenas must be destroyed on the thread that created them.
+class ExprNodeArena final {
+ public:
+  ExprNodeArena();
+  ~ExprNodeArena();
+
+  ExprNodeArena(const ExprNodeArena&) = delete;
+  ExprNodeArena& operator=(const ExprNodeArena&) = delete;
+
+ private:
+  friend class cel::Expr;
+
+  struct Block;
+
+  // Allocates a node of `size` bytes from the current arena of this thread, or
+  // from the heap if there is none.
+  static void* Allocate(size_t size);
+
+  // Frees a node returned by `Allocate()`. Safe to call from any thread.
+  static void Deallocate(void* node);
+
+  // Drops `count` references to `block`, freeing it with the last one.
+  static void Unref(Block* block, int64_t count);
+
+  void* AllocateFromBlock(size_t size);
+
+  // Stops allocating from the current block, which is then freed along with
+  // its last node.
+  void Retire();
+
+  // Whether this is the arena of the thread, rather than deferring to an
+  // enclosing one.
+  const bool active_;
+  Block* block_ = nullptr;
+  char* next_ = nullptr;
+  char* end_ = nullptr;
+  // The number of nodes allocated from `block_`.
+  int64_t allocated_ = 0;
+  size_t next_block_size_;
+};
+
+}  // namespace common_internal
+
 // `Expr` is a node in the Common Expression Language's abstract syntax tree. It
 // is composed of a numeric ID and a kind variant.
 class Expr final {
  public:
+  // Nodes created with `new`, such as the children of other nodes, come from
+  // the current `common_internal::ExprNodeArena` of the thread, if any.
+  static void* operator new(size_t size) {
+    return common_internal::ExprNodeArena::Allocate(size);
+  }
+  static void* operator new(size_t, void* place) noexcept { return place; }
+  static void operator delete(void* node) {
+    common_internal::ExprNodeArena::Deallocate(node);
+  }
+  static void operator delete(void*, void*) noexcept {}
+
   Expr() = default;
   Expr(Expr&&) = default;
   Expr& operator=(Expr&&);
@@ -933,6 +1001,10 @@ class Expr final {
   Expr(const Expr&);
   Expr& operator=(const Expr&);
 
+  // Destroys the subtree rooted at this node without recursing, so that
+  // tearing down deeply nested expressions cannot exhaust the stack.
+  ~Expr();
+
   void Clear();
 
   ABSL_MUST_USE_RESULT ExprId id() const { return id_; }
@@ -944,6 +1016,9 @@ class Expr final {
     return kind_;
   }
 
+  // Replacing the kind through the returned reference destroys the children
+  // of the old kind directly, each of which then tears down its own subtree
+  // without recursing.
   ABSL_MUST_USE_RESULT ExprKind& mutable_kind() ABSL_ATTRIBUTE_LIFETIME_BOUND {
     return kind_;
   }
@@ -1123,12 +1198,21 @@ class Expr final {
 
   static const Expr& default_instance();
 
+  // Detaches the descendants of `kind` one level at a time, so that they and
+  // then `kind` itself are destroyed without recursing.
+  static void DetachSubtree(ExprKind& kind);
+
   template <typename T, typename... Args>
   ABSL_MUST_USE_RESULT T& try_emplace_kind(Args&&... args)
       ABSL_ATTRIBUTE_LIFETIME_BOUND {
     if (auto* alt = absl::get_if<T>(&mutable_kind()); alt) {
       return *alt;
     }
+    if (!absl::holds_alternative<UnspecifiedExpr>(kind_)) {
+      // Leave the current kind with only leaf children, so that replacing it
+      // does not recurse through its subtree.
+      DetachSubtree(kind_);
+    }
     return kind_.emplace<T>(std::forward<Args>(args)...);
   }
 
@@ -1333,12 +1417,25 @@ inline std::vector<MapExprEntry> MapExpr::release_entries() {
 
 inline void Expr::Clear() {
   id_ = 0;
-  mutable_kind().emplace<UnspecifiedExpr>();
+  ExprKind previous = std::exchange(kind_, UnspecifiedExpr());
+  DetachSubtree(previous);
 }
 
-inline Expr& Expr::operator=(Expr&&) = default;
+inline Expr& Expr::operator=(Expr&& other) {
+  if (this != &other) {
+    // `other` may be a descendant of this node. Taking the current subtree out
+    // first keeps it alive until `other` has been moved in.
+    id_ = other.id_;
+    ExprKind previous = std::exchange(kind_, std::move(other.kind_));
+    DetachSubtree(previous);
+  }
+  return *this;
+}
 
-inline void Expr::set_kind(ExprKind kind) { kind_ = std::move(kind); }
+inline void Expr::set_kind(ExprKind kind) {
+  ExprKind previous = std::exchange(kind_, std::move(kind));
+  DetachSubtree(previous);
+}
 
 inline ABSL_MUST_USE_RESULT ExprKind Expr::release_kind() {
   ExprKind kind = std::move(kind_);
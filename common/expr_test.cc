@@ -14,6 +14,8 @@
 
 #include "common/expr.h"
 
+#include <memory>
+#include <thread>
 #include <utility>
 
 #include "internal/testing.h"
@@ -580,6 +582,134 @@ TEST(Expr, CopyAssignChildReference) {
   EXPECT_EQ(expr.call_expr().args()[1].ident_expr().name(), "qux");
 }
 
+TEST(Expr, MoveAssignChildReference) {
+  Expr expr;
+  expr.mutable_select_expr().set_field("foo");
+  Expr& operand = expr.mutable_select_expr().mutable_operand();
+  operand.mutable_call_expr().set_function("bar");
+  auto& args = operand.mutable_call_expr().mutable_args();
+  args.emplace_back().mutable_ident_expr().set_name("baz");
+  expr = std::move(expr.mutable_select_expr().mutable_operand());
+  EXPECT_EQ(expr.call_expr().function(), "bar");
+  ASSERT_EQ(expr.call_expr().args().size(), 1);
+  EXPECT_EQ(expr.call_expr().args()[0].ident_expr().name(), "baz");
+}
+
+TEST(Expr, DestroyDeeplyNested) {
+  // Deep enough that recursive destruction would overflow the stack.
+  constexpr int kDepth = 100000;
+  Expr expr;
+  Expr* node = &expr;
+  for (int i = 0; i < kDepth; ++i) {
+    auto& call = node->mutable_call_expr();
+    call.set_function("_+_");
+    call.mutable_args().emplace_back().mutable_const_expr().set_int_value(i);
+    node = &call.mutable_args().emplace_back();
+  }
+  node->mutable_ident_expr().set_name("x");
+  expr.Clear();
+  EXPECT_EQ(expr, Expr{});
+}
+
+// Makes `expr` a chain of `depth` selects ending in an identifier.
+void MakeDeeplyNested(Expr& expr, int depth) {
+  Expr* node = &expr;
+  for (int i = 0; i < depth; ++i) {
+    node = &node->mutable_select_expr().mutable_operand();
+  }
+  node->mutable_ident_expr().set_name("x");
+}
+
+TEST(Expr, MoveAssignOverDeeplyNested) {
+  constexpr int kDepth = 100000;
+  Expr expr;
+  MakeDeeplyNested(expr, kDepth);
+  Expr replacement;
+  replacement.set_id(1);
+  replacement.mutable_ident_expr().set_name("y");
+  expr = std::move(replacement);
+  EXPECT_EQ(expr.id(), 1);
+  EXPECT_EQ(expr.ident_expr().name(), "y");
+}
+
+TEST(Expr, ReplaceKindOverDeeplyNested) {
+  constexpr int kDepth = 100000;
+  Expr expr;
+  MakeDeeplyNested(expr, kDepth);
+  expr.set_kind(IdentExpr("y"));
+  EXPECT_EQ(expr.ident_expr().name(), "y");
+
+  MakeDeeplyNested(expr, kDepth);
+  expr.mutable_const_expr().set_int_value(1);
+  EXPECT_EQ(expr.const_expr().int_value(), 1);
+
+  MakeDeeplyNested(expr, kDepth);
+  expr.mutable_kind().emplace<UnspecifiedExpr>();
+  EXPECT_EQ(expr, Expr{});
+}
+
+TEST(ExprNodeArena, NodesOutliveArena) {
+  Expr expr;
+  std::unique_ptr<Expr> released;
+  {
+    common_internal::ExprNodeArena arena;
+    // Enough nodes to fill several blocks.
+    auto& list = expr.mutable_list_expr();
+    for (int i = 0; i < 1000; ++i) {
+      auto& call = list.add_elements().mutable_expr().mutable_call_expr();
+      call.set_function("f");
+      call.mutable_target().mutable_ident_expr().set_name("x");
+    }
+    {
+      // Defers to the enclosing arena.
+      common_internal::ExprNodeArena nested;
+      MakeDeeplyNested(expr.mutable_list_expr()
+                           .mutable_elements()[0]
+                           .mutable_expr()
+                           .mutable_call_expr()
+                           .mutable_target(),
+                       100);
+    }
+    released = expr.mutable_list_expr()
+                   .mutable_elements()[1]
+                   .mutable_expr()
+                   .mutable_call_expr()
+                   .release_target();
+  }
+  ASSERT_NE(released, nullptr);
+  EXPECT_EQ(released->ident_expr().name(), "x");
+
+  Expr copy = expr;
+  EXPECT_EQ(copy, expr);
+  expr.Clear();
+  // Nodes may be freed on another thread than the one that allocated them.
+  std::thread([&] {
+    released.reset();
+    copy.Clear();
+  }).join();
+  EXPECT_EQ(copy, Expr{});
+}
+
+TEST(Expr, DestroyShallow) {
+  // Wide trees whose nodes only have leaf children, including empty ones,
+  // which are destroyed without detaching anything.
+  Expr expr;
+  auto& list = expr.mutable_list_expr();
+  for (int i = 0; i < 100; ++i) {
+    auto& call = list.add_elements().mutable_expr().mutable_call_expr();
+    call.set_function("f");
+    call.mutable_args().emplace_back().mutable_const_expr().set_int_value(i);
+    call.mutable_args().emplace_back().mutable_ident_expr().set_name("x");
+    call.mutable_args().emplace_back();
+  }
+  Expr copy = expr;
+  EXPECT_EQ(copy, expr);
+  expr.Clear();
+  EXPECT_EQ(expr, Expr{});
+  copy = Expr{};
+  EXPECT_EQ(copy, Expr{});
+}
+
 TEST(Expr, Id) {
   Expr expr;
   EXPECT_THAT(expr.id(), Eq(0));
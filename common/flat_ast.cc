@@ -0,0 +1,206 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/flat_ast.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "absl/functional/overload.h"
+#include "absl/types/variant.h"
+#include "common/ast.h"
+#include "common/constant.h"
+#include "common/expr.h"
+
+namespace cel {
+
+namespace {
+
+NodeKind GetNodeKind(const Expr& expr) {
+  switch (expr.kind_case()) {
+    case ExprKindCase::kConstant:
+      return NodeKind::kConstant;
+    case ExprKindCase::kIdentExpr:
+      return NodeKind::kIdent;
+    case ExprKindCase::kSelectExpr:
+      return NodeKind::kSelect;
+    case ExprKindCase::kCallExpr:
+      return NodeKind::kCall;
+    case ExprKindCase::kListExpr:
+      return NodeKind::kList;
+    case ExprKindCase::kStructExpr:
+      return NodeKind::kStruct;
+    case ExprKindCase::kMapExpr:
+      return NodeKind::kMap;
+    case ExprKindCase::kComprehensionExpr:
+      return NodeKind::kComprehension;
+    case ExprKindCase::kUnspecifiedExpr:
+    default:
+      return NodeKind::kUnspecified;
+  }
+}
+
+struct PendingChild {
+  const Expr* expr;
+  ChildKind relation;
+};
+
+// Appends the children of `expr` to `children` in their natural order.
+void GetChildren(const Expr& expr, std::vector<PendingChild>& children) {
+  absl::visit(
+      absl::Overload(
+          [](const UnspecifiedExpr&) {}, [](const Constant&) {},
+          [](const IdentExpr&) {},
+          [&](const SelectExpr& select_expr) {
+            if (select_expr.has_operand()) {
+              children.push_back(
+                  {&select_expr.operand(), ChildKind::kSelectOperand});
+            }
+          },
+          [&](const CallExpr& call_expr) {
+            if (call_expr.has_target()) {
+              children.push_back(
+                  {&call_expr.target(), ChildKind::kCallReceiver});
+            }
+            for (const auto& arg : call_expr.args()) {
+              children.push_back({&arg, ChildKind::kCallArg});
+            }
+          },
+          [&](const ListExpr& list_expr) {
+            for (const auto& element : list_expr.elements()) {
+              children.push_back({&element.expr(), ChildKind::kListElem});
+            }
+          },
+          [&](const StructExpr& struct_expr) {
+            for (const auto& field : struct_expr.fields()) {
+              if (field.has_value()) {
+                children.push_back({&field.value(), ChildKind::kStructValue});
+              }
+            }
+          },
+          [&](const MapExpr& map_expr) {
+            for (const auto& entry : map_expr.entries()) {
+              if (entry.has_key()) {
+                children.push_back({&entry.key(), ChildKind::kMapKey});
+              }
+              if (entry.has_value()) {
+                children.push_back({&entry.value(), ChildKind::kMapValue});
+              }
+            }
+          },
+          [&](const ComprehensionExpr& comprehension_expr) {
+            children.push_back({&comprehension_expr.iter_range(),
+                                ChildKind::kComprehensionRange});
+            children.push_back({&comprehension_expr.accu_init(),
+                                ChildKind::kComprehensionInit});
+            children.push_back({&comprehension_expr.loop_condition(),
+                                ChildKind::kComprehensionCondition});
+            children.push_back({&comprehension_expr.loop_step(),
+                                ChildKind::kComprehensionLoopStep});
+            children.push_back({&comprehension_expr.result(),
+                                ChildKind::kComprensionResult});
+          }),
+      expr.kind());
+}
+
+}  // namespace
+
+FlatAst FlatAst::Build(const Ast& ast) {
+  FlatAst flat_ast = Build(ast.root_expr());
+  if (!ast.is_checked()) {
+    return flat_ast;
+  }
+  flat_ast.types_.reserve(flat_ast.size());
+  flat_ast.references_.reserve(flat_ast.size());
+  for (int64_t id : flat_ast.ids_) {
+    flat_ast.types_.push_back(ast.GetType(id));
+    flat_ast.references_.push_back(ast.GetReference(id));
+  }
+  return flat_ast;
+}
+
+FlatAst FlatAst::Build(const Expr& expr) {
+  FlatAst flat_ast;
+
+  struct StackRecord {
+    const Expr* expr;
+    NodeIndex parent;
+    ChildKind relation;
+  };
+
+  // Number the nodes in preorder, recording each node's parent. Children are
+  // pushed in reverse so that they are popped in their natural order.
+  std::vector<StackRecord> stack;
+  std::vector<PendingChild> children;
+  stack.push_back({&expr, kNoNode, ChildKind::kUnspecified});
+  while (!stack.empty()) {
+    StackRecord record = stack.back();
+    stack.pop_back();
+    auto index = static_cast<NodeIndex>(flat_ast.exprs_.size());
+    flat_ast.exprs_.push_back(record.expr);
+    flat_ast.ids_.push_back(record.expr->id());
+    flat_ast.node_kinds_.push_back(GetNodeKind(*record.expr));
+    flat_ast.parent_relations_.push_back(record.relation);
+    flat_ast.parents_.push_back(record.parent);
+    flat_ast.depths_.push_back(
+        record.parent == kNoNode ? 0 : flat_ast.depths_[record.parent] + 1);
+    flat_ast.id_to_node_.try_emplace(record.expr->id(), index);
+
+    children.clear();
+    GetChildren(*record.expr, children);
+    for (auto it = children.rbegin(); it != children.rend(); ++it) {
+      stack.push_back({it->expr, index, it->relation});
+    }
+  }
+
+  const size_t size = flat_ast.exprs_.size();
+
+  // Nodes are visited in preorder, so each parent's children are appended in
+  // their natural order.
+  flat_ast.child_offsets_.assign(size + 1, 0);
+  for (size_t i = 1; i < size; ++i) {
+    ++flat_ast.child_offsets_[flat_ast.parents_[i] + 1];
+  }
+  for (size_t i = 0; i < size; ++i) {
+    flat_ast.child_offsets_[i + 1] += flat_ast.child_offsets_[i];
+  }
+  flat_ast.children_.resize(size == 0 ? 0 : size - 1);
+  std::vector<uint32_t> next_child(flat_ast.child_offsets_.begin(),
+                                   flat_ast.child_offsets_.end() - 1);
+  for (size_t i = 1; i < size; ++i) {
+    flat_ast.children_[next_child[flat_ast.parents_[i]]++] =
+        static_cast<NodeIndex>(i);
+  }
+
+  // Descendants always follow their ancestors in preorder, so a reverse scan
+  // accumulates complete subtree sizes.
+  flat_ast.tree_sizes_.assign(size, 1);
+  for (size_t i = size; i-- > 1;) {
+    flat_ast.tree_sizes_[flat_ast.parents_[i]] += flat_ast.tree_sizes_[i];
+  }
+
+  // A node's subtree starts in postorder after the subtrees that precede it
+  // in preorder, i.e. at its preorder index less its ancestors, and the node
+  // itself comes last.
+  flat_ast.postorder_.resize(size);
+  for (size_t i = 0; i < size; ++i) {
+    flat_ast.postorder_[i - flat_ast.depths_[i] + flat_ast.tree_sizes_[i] -
+                        1] = static_cast<NodeIndex>(i);
+  }
+
+  return flat_ast;
+}
+
+}  // namespace cel
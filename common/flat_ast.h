@@ -0,0 +1,165 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_COMMON_FLAT_AST_H_
+#define THIRD_PARTY_CEL_CPP_COMMON_FLAT_AST_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "absl/base/nullability.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/log/absl_check.h"
+#include "absl/types/span.h"
+#include "common/ast.h"
+#include "common/ast/navigable_ast_kinds.h"  // IWYU pragma: export
+#include "common/expr.h"
+
+namespace cel {
+
+// FlatAst is a compact, read-only view over a CEL AST for analysis passes
+// that make several passes over the tree or need random access to it.
+//
+// Nodes are identified by their 32-bit index in a preorder traversal of the
+// AST, with the root at index 0. Per-node attributes are stored in separate
+// columns indexed by node, so a pass that only looks at node kinds or types
+// does not touch the rest. Because nodes are numbered in preorder, the
+// subtree rooted at `node` occupies the indices
+// `[node, node + tree_size(node))`.
+//
+// Children are traversed in the same order as `cel::NavigableAst`:
+//   - the receiver of a call (if present) followed by its arguments
+//   - list elements and struct field values in order
+//   - map keys and values, alternating per entry
+//   - comprehension range, accu_init, condition, step and result
+//
+// A FlatAst refers to the expressions, types and references of the AST it
+// was built from. It may contain dangling pointers if that AST is mutated or
+// destroyed.
+class FlatAst final {
+ public:
+  using NodeIndex = uint32_t;
+
+  static constexpr NodeIndex kNoNode = std::numeric_limits<NodeIndex>::max();
+
+  // Builds the flat representation of `ast`, including the types and
+  // references if it is checked.
+  static FlatAst Build(const Ast& ast);
+
+  // Builds the flat representation of `expr`. Type and reference lookups
+  // return nullptr.
+  static FlatAst Build(const Expr& expr);
+
+  FlatAst() = default;
+  FlatAst(const FlatAst&) = delete;
+  FlatAst& operator=(const FlatAst&) = delete;
+  FlatAst(FlatAst&&) = default;
+  FlatAst& operator=(FlatAst&&) = default;
+
+  // The number of nodes in the AST.
+  size_t size() const { return exprs_.size(); }
+
+  bool empty() const { return exprs_.empty(); }
+
+  // The index of the root node.
+  NodeIndex root() const {
+    ABSL_DCHECK(!empty());
+    return 0;
+  }
+
+  // The backing expression in the source AST.
+  const Expr& expr(NodeIndex node) const { return *exprs_[node]; }
+
+  int64_t id(NodeIndex node) const { return ids_[node]; }
+
+  // The type of this node, analogous to Expr::ExprKindCase.
+  NodeKind node_kind(NodeIndex node) const { return node_kinds_[node]; }
+
+  // The type of traversal from the parent to this node.
+  ChildKind parent_relation(NodeIndex node) const {
+    return parent_relations_[node];
+  }
+
+  // The parent of this node or `kNoNode` for the root.
+  NodeIndex parent(NodeIndex node) const { return parents_[node]; }
+
+  // The number of ancestors of this node. The root has depth 0.
+  uint32_t depth(NodeIndex node) const { return depths_[node]; }
+
+  // The number of nodes in the tree rooted at this node (including self).
+  uint32_t tree_size(NodeIndex node) const { return tree_sizes_[node]; }
+
+  // The children of this node in their natural order.
+  absl::Span<const NodeIndex> children(NodeIndex node) const {
+    return absl::MakeConstSpan(children_).subspan(
+        child_offsets_[node], child_offsets_[node + 1] - child_offsets_[node]);
+  }
+
+  // The descendants of this node (including self) in postorder. Each node is
+  // listed immediately after all of its descendants.
+  absl::Span<const NodeIndex> DescendantsPostorder(NodeIndex node) const {
+    // Nodes that precede `node` in preorder but not in postorder are exactly
+    // its ancestors.
+    return absl::MakeConstSpan(postorder_).subspan(node - depths_[node],
+                                                   tree_sizes_[node]);
+  }
+
+  // The checked type of this node, or nullptr if the AST is not checked or the
+  // node has dynamic type.
+  const TypeSpec* absl_nullable type(NodeIndex node) const {
+    return types_.empty() ? nullptr : types_[node];
+  }
+
+  // The resolved reference of this node, or nullptr if the AST is not checked
+  // or no reference was resolved.
+  const Reference* absl_nullable reference(NodeIndex node) const {
+    return references_.empty() ? nullptr : references_[node];
+  }
+
+  // Returns the index of the node with the given id, or `kNoNode` if there is
+  // none.
+  //
+  // If ids are non-unique, the first node in preorder with the id is returned.
+  NodeIndex FindId(int64_t id) const {
+    auto it = id_to_node_.find(id);
+    return it == id_to_node_.end() ? kNoNode : it->second;
+  }
+
+  // Returns whether the source AST used unique IDs for each node.
+  bool IdsAreUnique() const { return id_to_node_.size() == size(); }
+
+ private:
+  std::vector<const Expr* absl_nonnull> exprs_;
+  std::vector<int64_t> ids_;
+  std::vector<NodeKind> node_kinds_;
+  std::vector<ChildKind> parent_relations_;
+  std::vector<NodeIndex> parents_;
+  std::vector<uint32_t> depths_;
+  std::vector<uint32_t> tree_sizes_;
+  // The children of node `i` are
+  // `children_[child_offsets_[i], child_offsets_[i + 1])`.
+  std::vector<uint32_t> child_offsets_;
+  std::vector<NodeIndex> children_;
+  std::vector<NodeIndex> postorder_;
+  // Only populated for checked ASTs.
+  std::vector<const TypeSpec* absl_nullable> types_;
+  std::vector<const Reference* absl_nullable> references_;
+  absl::flat_hash_map<int64_t, NodeIndex> id_to_node_;
+};
+
+}  // namespace cel
+
+#endif  // THIRD_PARTY_CEL_CPP_COMMON_FLAT_AST_H_
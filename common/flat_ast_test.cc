@@ -0,0 +1,226 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/flat_ast.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "common/ast.h"
+#include "common/expr.h"
+#include "common/navigable_ast.h"
+#include "common/source.h"
+#include "common/standard_definitions.h"
+#include "internal/status_macros.h"
+#include "internal/testing.h"
+#include "parser/parser.h"
+
+namespace cel {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+using ::testing::Pointee;
+using ::testing::SizeIs;
+
+using NodeIndex = FlatAst::NodeIndex;
+
+absl::StatusOr<std::unique_ptr<Ast>> Parse(absl::string_view expr) {
+  static const auto* parser = cel::NewParserBuilder()->Build()->release();
+  CEL_ASSIGN_OR_RETURN(auto source, cel::NewSource(expr));
+  return parser->Parse(*source);
+}
+
+TEST(FlatAst, Basic) {
+  Expr const_node;
+  const_node.set_id(1);
+  const_node.mutable_const_expr().set_int_value(42);
+
+  FlatAst ast = FlatAst::Build(const_node);
+  ASSERT_EQ(ast.size(), 1);
+  EXPECT_TRUE(ast.IdsAreUnique());
+
+  NodeIndex root = ast.root();
+  EXPECT_EQ(&ast.expr(root), &const_node);
+  EXPECT_EQ(ast.id(root), 1);
+  EXPECT_THAT(ast.children(root), IsEmpty());
+  EXPECT_EQ(ast.parent(root), FlatAst::kNoNode);
+  EXPECT_EQ(ast.depth(root), 0);
+  EXPECT_EQ(ast.tree_size(root), 1);
+  EXPECT_EQ(ast.node_kind(root), NodeKind::kConstant);
+  EXPECT_EQ(ast.parent_relation(root), ChildKind::kUnspecified);
+  EXPECT_EQ(ast.type(root), nullptr);
+  EXPECT_EQ(ast.reference(root), nullptr);
+}
+
+TEST(FlatAst, FindId) {
+  Expr const_node;
+  const_node.set_id(1);
+  const_node.mutable_const_expr().set_int_value(42);
+
+  FlatAst ast = FlatAst::Build(const_node);
+
+  EXPECT_EQ(ast.FindId(1), ast.root());
+  EXPECT_EQ(ast.FindId(-1), FlatAst::kNoNode);
+}
+
+TEST(FlatAst, ToleratesNonUnique) {
+  Expr call_node;
+  call_node.set_id(1);
+  call_node.mutable_call_expr().set_function(cel::StandardFunctions::kNot);
+  Expr* const_node =
+      &call_node.mutable_call_expr().mutable_args().emplace_back();
+  const_node->mutable_const_expr().set_bool_value(false);
+  const_node->set_id(1);
+
+  FlatAst ast = FlatAst::Build(call_node);
+
+  EXPECT_EQ(ast.FindId(1), ast.root());
+  EXPECT_FALSE(ast.IdsAreUnique());
+  EXPECT_THAT(ast.children(ast.root()), SizeIs(1));
+}
+
+TEST(FlatAst, Children) {
+  ASSERT_OK_AND_ASSIGN(auto parsed_expr, Parse("1 + 2"));
+
+  FlatAst ast = FlatAst::Build(*parsed_expr);
+  NodeIndex root = ast.root();
+
+  EXPECT_EQ(ast.node_kind(root), NodeKind::kCall);
+  ASSERT_THAT(ast.children(root), SizeIs(2));
+  NodeIndex lhs = ast.children(root)[0];
+  NodeIndex rhs = ast.children(root)[1];
+  EXPECT_EQ(ast.expr(lhs).const_expr().int64_value(), 1);
+  EXPECT_EQ(ast.expr(rhs).const_expr().int64_value(), 2);
+  EXPECT_EQ(ast.parent(lhs), root);
+  EXPECT_EQ(ast.parent(rhs), root);
+  EXPECT_EQ(ast.parent_relation(lhs), ChildKind::kCallArg);
+  EXPECT_EQ(ast.depth(rhs), 1);
+}
+
+TEST(FlatAst, ParentRelations) {
+  ASSERT_OK_AND_ASSIGN(
+      auto parsed_expr,
+      Parse("a.b(c) + [d].exists(x, x) + {e: f}.g + Msg{h: i}"));
+
+  FlatAst ast = FlatAst::Build(*parsed_expr);
+
+  std::vector<ChildKind> relations;
+  for (NodeIndex node = 0; node < ast.size(); ++node) {
+    relations.push_back(ast.parent_relation(node));
+  }
+  EXPECT_THAT(
+      relations,
+      ElementsAre(
+          ChildKind::kUnspecified, ChildKind::kCallArg, ChildKind::kCallArg,
+          // a.b(c)
+          ChildKind::kCallArg, ChildKind::kCallReceiver, ChildKind::kCallArg,
+          // [d].exists(x, x)
+          ChildKind::kCallArg, ChildKind::kComprehensionRange,
+          ChildKind::kListElem, ChildKind::kComprehensionInit,
+          ChildKind::kComprehensionCondition, ChildKind::kCallArg,
+          ChildKind::kCallArg, ChildKind::kComprehensionLoopStep,
+          ChildKind::kCallArg, ChildKind::kCallArg,
+          ChildKind::kComprensionResult,
+          // {e: f}.g
+          ChildKind::kCallArg, ChildKind::kSelectOperand, ChildKind::kMapKey,
+          ChildKind::kMapValue,
+          // Msg{h: i}
+          ChildKind::kCallArg, ChildKind::kStructValue));
+}
+
+TEST(FlatAst, DescendantsPostorder) {
+  ASSERT_OK_AND_ASSIGN(auto parsed_expr, Parse("1 + (x * 3)"));
+
+  FlatAst ast = FlatAst::Build(*parsed_expr);
+
+  std::vector<NodeKind> node_kinds;
+  for (NodeIndex node : ast.DescendantsPostorder(ast.root())) {
+    node_kinds.push_back(ast.node_kind(node));
+  }
+  EXPECT_THAT(node_kinds, ElementsAre(NodeKind::kConstant, NodeKind::kIdent,
+                                      NodeKind::kConstant, NodeKind::kCall,
+                                      NodeKind::kCall));
+
+  NodeIndex product = ast.children(ast.root())[1];
+  node_kinds.clear();
+  for (NodeIndex node : ast.DescendantsPostorder(product)) {
+    node_kinds.push_back(ast.node_kind(node));
+  }
+  EXPECT_THAT(node_kinds, ElementsAre(NodeKind::kIdent, NodeKind::kConstant,
+                                      NodeKind::kCall));
+}
+
+TEST(FlatAst, MatchesNavigableAst) {
+  ASSERT_OK_AND_ASSIGN(
+      auto parsed_expr,
+      Parse("[1, 2, 3].map(x, {x: x * 2}).all(y, y.size() > 0 && a.b.c)"));
+
+  FlatAst flat_ast = FlatAst::Build(*parsed_expr);
+  NavigableAst navigable_ast = NavigableAst::Build(parsed_expr->root_expr());
+
+  ASSERT_EQ(flat_ast.size(), navigable_ast.Root().tree_size());
+  NodeIndex node = 0;
+  for (const NavigableAstNode& navigable_node :
+       navigable_ast.Root().DescendantsPreorder()) {
+    EXPECT_EQ(&flat_ast.expr(node), navigable_node.expr());
+    EXPECT_EQ(flat_ast.node_kind(node), navigable_node.node_kind());
+    EXPECT_EQ(flat_ast.parent_relation(node),
+              navigable_node.parent_relation());
+    EXPECT_EQ(flat_ast.tree_size(node), navigable_node.tree_size());
+    EXPECT_EQ(flat_ast.children(node).size(),
+              navigable_node.children().size());
+    ++node;
+  }
+}
+
+TEST(FlatAst, CheckedTypesAndReferences) {
+  Expr expr;
+  expr.set_id(1);
+  auto& call = expr.mutable_call_expr();
+  call.set_function("_+_");
+  auto& arg0 = call.mutable_args().emplace_back();
+  arg0.set_id(2);
+  arg0.mutable_ident_expr().set_name("x");
+  auto& arg1 = call.mutable_args().emplace_back();
+  arg1.set_id(3);
+  arg1.mutable_ident_expr().set_name("y");
+
+  Ast::ReferenceMap reference_map;
+  reference_map[1] = Reference("", {"add_int64"}, {});
+  reference_map[2] = Reference("x", {}, {});
+  Ast::TypeMap type_map;
+  type_map[1] = TypeSpec(PrimitiveType::kInt64);
+  type_map[2] = TypeSpec(PrimitiveType::kInt64);
+  Ast ast(std::move(expr), SourceInfo(), std::move(reference_map),
+          std::move(type_map), "");
+
+  FlatAst flat_ast = FlatAst::Build(ast);
+  ASSERT_EQ(flat_ast.size(), 3);
+
+  EXPECT_THAT(flat_ast.type(0), Pointee(TypeSpec(PrimitiveType::kInt64)));
+  EXPECT_THAT(flat_ast.type(1), Pointee(TypeSpec(PrimitiveType::kInt64)));
+  EXPECT_EQ(flat_ast.type(2), nullptr);
+  ASSERT_NE(flat_ast.reference(0), nullptr);
+  EXPECT_THAT(flat_ast.reference(0)->overload_id(), ElementsAre("add_int64"));
+  ASSERT_NE(flat_ast.reference(1), nullptr);
+  EXPECT_EQ(flat_ast.reference(1)->name(), "x");
+  EXPECT_EQ(flat_ast.reference(2), nullptr);
+}
+
+}  // namespace
+}  // namespace cel
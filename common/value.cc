@@ -47,6 +47,7 @@
 #include "common/values/map_value_builder.h"
 #include "common/values/struct_value_builder.h"
 #include "common/values/values.h"
+#include "internal/json.h"
 #include "internal/number.h"
 #include "internal/protobuf_runtime_version.h"
 #include "internal/status_macros.h"
@@ -54,6 +55,7 @@
 #include "runtime/runtime_options.h"
 #include "google/protobuf/arena.h"
 #include "google/protobuf/descriptor.h"
+#include "google/protobuf/io/zero_copy_stream.h"
 #include "google/protobuf/message.h"
 
 namespace cel {
@@ -256,6 +258,132 @@ absl::Status Value::ConvertToJsonObject(
       }));
 }
 
+namespace {
+
+absl::Status ValueToJson(const Value& value,
+                         const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+                         google::protobuf::MessageFactory* absl_nonnull message_factory,
+                         google::protobuf::Arena* absl_nonnull arena,
+                         internal::JsonWriter& writer) {
+  switch (value.kind()) {
+    case ValueKind::kNull:
+      writer.WriteNull();
+      return absl::OkStatus();
+    case ValueKind::kBool:
+      writer.WriteBool(value.GetBool().NativeValue());
+      return absl::OkStatus();
+    case ValueKind::kInt:
+      writer.WriteNumber(value.GetInt().NativeValue());
+      return absl::OkStatus();
+    case ValueKind::kUint:
+      writer.WriteNumber(value.GetUint().NativeValue());
+      return absl::OkStatus();
+    case ValueKind::kDouble:
+      writer.WriteNumber(value.GetDouble().NativeValue());
+      return absl::OkStatus();
+    case ValueKind::kString: {
+      const StringValue& string_value = value.GetString();
+      if (auto flat = string_value.TryFlat(); flat) {
+        writer.WriteString(*flat);
+      } else {
+        writer.WriteString(string_value.ToCord());
+      }
+      return absl::OkStatus();
+    }
+    case ValueKind::kBytes: {
+      const BytesValue& bytes_value = value.GetBytes();
+      if (auto flat = bytes_value.TryFlat(); flat) {
+        writer.WriteBytes(*flat);
+      } else {
+        writer.WriteBytes(bytes_value.ToCord());
+      }
+      return absl::OkStatus();
+    }
+    case ValueKind::kDuration:
+      writer.WriteDuration(value.GetDuration().NativeValue());
+      return absl::OkStatus();
+    case ValueKind::kTimestamp:
+      writer.WriteTimestamp(value.GetTimestamp().NativeValue());
+      return absl::OkStatus();
+    case ValueKind::kList: {
+      if (auto json_list = value.AsParsedJsonList(); json_list) {
+        return writer.WriteMessage(**json_list);
+      }
+      if (auto repeated_field = value.AsParsedRepeatedField(); repeated_field) {
+        return writer.WriteMessageField(repeated_field->message(),
+                                        repeated_field->field());
+      }
+      writer.BeginArray();
+      CEL_RETURN_IF_ERROR(value.GetList().ForEach(
+          [&](const Value& element) -> absl::StatusOr<bool> {
+            CEL_RETURN_IF_ERROR(ValueToJson(element, descriptor_pool,
+                                            message_factory, arena, writer));
+            return true;
+          },
+          descriptor_pool, message_factory, arena));
+      writer.EndArray();
+      return absl::OkStatus();
+    }
+    case ValueKind::kMap: {
+      if (auto json_map = value.AsParsedJsonMap(); json_map) {
+        return writer.WriteMessage(**json_map);
+      }
+      if (auto map_field = value.AsParsedMapField(); map_field) {
+        return writer.WriteMessageField(map_field->message(),
+                                        map_field->field());
+      }
+      std::string scratch;
+      writer.BeginObject();
+      CEL_RETURN_IF_ERROR(value.GetMap().ForEach(
+          [&](const Value& key, const Value& entry) -> absl::StatusOr<bool> {
+            auto string_key = key.AsString();
+            if (!string_key) {
+              return TypeConversionError(key.GetRuntimeType(), StringType())
+                  .NativeValue();
+            }
+            writer.WriteKey(string_key->ToStringView(&scratch));
+            CEL_RETURN_IF_ERROR(ValueToJson(entry, descriptor_pool,
+                                            message_factory, arena, writer));
+            return true;
+          },
+          descriptor_pool, message_factory, arena));
+      writer.EndObject();
+      return absl::OkStatus();
+    }
+    case ValueKind::kStruct:
+      if (auto message = value.AsParsedMessage(); message) {
+        return writer.WriteMessage(**message);
+      }
+      ABSL_FALLTHROUGH_INTENDED;
+    default: {
+      // Custom structs, and values which have no JSON representation, go
+      // through `ConvertToJson`.
+      google::protobuf::Value json;
+      CEL_RETURN_IF_ERROR(
+          value.ConvertToJson(descriptor_pool, message_factory, &json));
+      return writer.WriteMessage(json);
+    }
+  }
+}
+
+}  // namespace
+
+absl::Status Value::SerializeToJson(
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena,
+    google::protobuf::io::ZeroCopyOutputStream* absl_nonnull output) const {
+  ABSL_DCHECK(descriptor_pool != nullptr);
+  ABSL_DCHECK(message_factory != nullptr);
+  ABSL_DCHECK(arena != nullptr);
+  ABSL_DCHECK(output != nullptr);
+
+  internal::JsonWriter writer(descriptor_pool, message_factory, output);
+  CEL_RETURN_IF_ERROR(
+      ValueToJson(*this, descriptor_pool, message_factory, arena, writer));
+  return writer.Finish();
+}
+
 absl::Status Value::Equal(
     const Value& other,
     const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
@@ -380,6 +380,17 @@ class Value final : private common_internal::ValueMixin<Value> {
       google::protobuf::MessageFactory* absl_nonnull message_factory,
       google::protobuf::Message* absl_nonnull json) const;
 
+  // `SerializeToJson` writes the JSON representation of this value, as
+  // `ConvertToJson` would produce it, to `output` as compact JSON text. Lists,
+  // maps and parsed messages are written directly, without building an
+  // intermediate `google.protobuf.Value`. If an error is returned, `output` is
+  // in a valid but unspecified state.
+  absl::Status SerializeToJson(
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena,
+      google::protobuf::io::ZeroCopyOutputStream* absl_nonnull output) const;
+
   absl::Status Equal(const Value& other,
                      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
                      google::protobuf::MessageFactory* absl_nonnull message_factory,
@@ -14,6 +14,9 @@
 
 #include "common/value.h"
 
+#include <string>
+#include <utility>
+
 #include "google/protobuf/struct.pb.h"
 #include "google/protobuf/type.pb.h"
 #include "google/protobuf/descriptor.pb.h"
@@ -21,10 +24,13 @@
 #include "absl/log/die_if_null.h"
 #include "absl/status/status.h"
 #include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
+#include "absl/time/time.h"
 #include "absl/types/optional.h"
 #include "common/type.h"
 #include "common/value_testing.h"
 #include "internal/parse_text_proto.h"
+#include "internal/status_macros.h"
 #include "internal/testing.h"
 #include "internal/testing_descriptor_pool.h"
 #include "internal/testing_message_factory.h"
@@ -32,10 +38,12 @@
 #include "google/protobuf/arena.h"
 #include "google/protobuf/descriptor.h"
 #include "google/protobuf/generated_enum_reflection.h"
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
 
 namespace cel {
 namespace {
 
+using ::absl_testing::IsOk;
 using ::absl_testing::IsOkAndHolds;
 using ::absl_testing::StatusIs;
 using ::cel::internal::DynamicParseTextProto;
@@ -43,6 +51,7 @@ using ::cel::internal::GetTestingDescriptorPool;
 using ::cel::internal::GetTestingMessageFactory;
 using ::testing::An;
 using ::testing::Eq;
+using ::testing::Not;
 using ::testing::NotNull;
 using ::testing::Optional;
 
@@ -994,5 +1003,68 @@ TEST_F(ValueIteratorTest, Empty2) {
               IsOkAndHolds(Eq(absl::nullopt)));
 }
 
+class ValueSerializeToJsonTest : public common_internal::ValueTest<> {
+ public:
+  absl::StatusOr<std::string> SerializeToJson(const Value& value) {
+    std::string output;
+    google::protobuf::io::StringOutputStream stream(&output);
+    CEL_RETURN_IF_ERROR(value.SerializeToJson(
+        descriptor_pool(), message_factory(), arena(), &stream));
+    return output;
+  }
+};
+
+TEST_F(ValueSerializeToJsonTest, Scalars) {
+  auto builder = NewListValueBuilder(arena());
+  ASSERT_THAT(builder->Add(NullValue()), IsOk());
+  ASSERT_THAT(builder->Add(BoolValue(true)), IsOk());
+  ASSERT_THAT(builder->Add(IntValue(1)), IsOk());
+  ASSERT_THAT(builder->Add(UintValue(2)), IsOk());
+  ASSERT_THAT(builder->Add(DoubleValue(0.5)), IsOk());
+  ASSERT_THAT(builder->Add(StringValue("foo")), IsOk());
+  ASSERT_THAT(builder->Add(BytesValue("bar")), IsOk());
+  ASSERT_THAT(builder->Add(DurationValue(absl::Seconds(1))), IsOk());
+  ASSERT_THAT(builder->Add(TimestampValue(absl::UnixEpoch())), IsOk());
+  EXPECT_THAT(
+      SerializeToJson(std::move(*builder).Build()),
+      IsOkAndHolds(
+          R"json([null,true,1,2,0.5,"foo","YmFy","1s","1970-01-01T00:00:00Z"])json"));
+}
+
+TEST_F(ValueSerializeToJsonTest, Map) {
+  auto builder = NewMapValueBuilder(arena());
+  ASSERT_THAT(builder->Put(StringValue("foo"), IntValue(1)), IsOk());
+  EXPECT_THAT(SerializeToJson(std::move(*builder).Build()),
+              IsOkAndHolds(R"json({"foo":1})json"));
+}
+
+TEST_F(ValueSerializeToJsonTest, MapWithNonStringKey) {
+  auto builder = NewMapValueBuilder(arena());
+  ASSERT_THAT(builder->Put(IntValue(1), IntValue(1)), IsOk());
+  EXPECT_THAT(SerializeToJson(std::move(*builder).Build()),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST_F(ValueSerializeToJsonTest, ParsedMessage) {
+  EXPECT_THAT(SerializeToJson(MakeParsedMessage<TestAllTypesProto3>(
+                  R"pb(single_int32: 1
+                       repeated_string: [ "a", "b" ]
+                       map_string_string { key: "foo" value: "bar" })pb")),
+              IsOkAndHolds(
+                  R"json({"singleInt32":1,"repeatedString":["a","b"],"mapStringString":{"foo":"bar"}})json"));
+}
+
+TEST_F(ValueSerializeToJsonTest, BytesValueOutputStream) {
+  BytesValueOutputStream stream(BytesValue(), arena());
+  ASSERT_THAT(IntValue(1).SerializeToJson(descriptor_pool(), message_factory(),
+                                          arena(), &stream),
+              IsOk());
+  EXPECT_EQ(std::move(stream).Consume(), "1");
+}
+
+TEST_F(ValueSerializeToJsonTest, NotJson) {
+  EXPECT_THAT(SerializeToJson(UnknownValue()), Not(IsOk()));
+}
+
 }  // namespace
 }  // namespace cel
@@ -0,0 +1,525 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/values/constant_map_value.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/nullability.h"
+#include "absl/base/optimization.h"
+#include "absl/hash/hash.h"
+#include "absl/log/absl_check.h"
+#include "absl/numeric/bits.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "common/arena.h"
+#include "common/native_type.h"
+#include "common/type.h"
+#include "common/value.h"
+#include "common/value_kind.h"
+#include "internal/status_macros.h"
+#include "internal/well_known_types.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
+
+namespace cel::common_internal {
+
+namespace {
+
+using ::cel::well_known_types::StructReflection;
+
+// The index is a "hash and displace" perfect hash. Keys are first distributed
+// into buckets by their hash. Each bucket then gets a seed, chosen while
+// building, which maps all of the keys in the bucket to distinct free slots.
+// A lookup therefore computes one key hash, reads one seed and probes exactly
+// one slot.
+
+// Average number of keys per bucket. Larger buckets need fewer seeds but take
+// longer to place.
+constexpr size_t kKeysPerBucket = 4;
+
+// Number of seeds tried for a bucket before retrying with more slots.
+constexpr uint32_t kMaxSeed = 1 << 16;
+
+// Number of times the slot count is doubled before giving up.
+constexpr int kMaxAttempts = 8;
+
+uint64_t KeyHash(const Value& key) {
+  switch (key.kind()) {
+    case ValueKind::kBool:
+      return absl::HashOf(ValueKind::kBool, key.GetBool().NativeValue());
+    case ValueKind::kInt:
+      return absl::HashOf(ValueKind::kInt, key.GetInt().NativeValue());
+    case ValueKind::kUint:
+      return absl::HashOf(ValueKind::kUint, key.GetUint().NativeValue());
+    case ValueKind::kString:
+      return absl::HashOf(ValueKind::kString, key.GetString());
+    default:
+      ABSL_UNREACHABLE();
+  }
+}
+
+bool KeyEquals(const Value& lhs, const Value& rhs) {
+  if (lhs.kind() != rhs.kind()) {
+    return false;
+  }
+  switch (lhs.kind()) {
+    case ValueKind::kBool:
+      return lhs.GetBool() == rhs.GetBool();
+    case ValueKind::kInt:
+      return lhs.GetInt() == rhs.GetInt();
+    case ValueKind::kUint:
+      return lhs.GetUint() == rhs.GetUint();
+    case ValueKind::kString:
+      return lhs.GetString().Equals(rhs.GetString());
+    default:
+      ABSL_UNREACHABLE();
+  }
+}
+
+// Mixes `seed` into `hash`, so that each seed gives an independent
+// permutation of the key hashes.
+uint64_t Mix(uint64_t hash, uint32_t seed) {
+  uint64_t x = hash ^ (uint64_t{seed} * uint64_t{0x9e3779b97f4a7c15});
+  x ^= x >> 33;
+  x *= uint64_t{0xff51afd7ed558ccd};
+  x ^= x >> 33;
+  x *= uint64_t{0xc4ceb9fe1a85ec53};
+  x ^= x >> 33;
+  return x;
+}
+
+size_t BucketIndex(uint64_t hash, size_t bucket_mask) {
+  return static_cast<size_t>(Mix(hash, 0) & bucket_mask);
+}
+
+// Seeds used for slots start at one, so that they never coincide with the
+// bucket mapping above.
+size_t SlotIndex(uint64_t hash, uint32_t seed, size_t slot_mask) {
+  return static_cast<size_t>(Mix(hash, seed + 1) & slot_mask);
+}
+
+absl::Status CheckMapValue(const Value& value) {
+  if (auto error_value = value.AsError(); ABSL_PREDICT_FALSE(error_value)) {
+    return error_value->ToStatus();
+  }
+  if (auto unknown_value = value.AsUnknown();
+      ABSL_PREDICT_FALSE(unknown_value)) {
+    return absl::InvalidArgumentError("cannot add unknown value to map");
+  }
+  return absl::OkStatus();
+}
+
+template <typename T>
+T* absl_nonnull AllocateArray(google::protobuf::Arena* absl_nonnull arena, size_t size) {
+  return static_cast<T*>(arena->AllocateAligned(sizeof(T) * size, alignof(T)));
+}
+
+template <typename T>
+T* absl_nonnull CopyArray(absl::Span<const T> array,
+                          google::protobuf::Arena* absl_nonnull arena) {
+  T* copy = AllocateArray<T>(arena, array.size());
+  std::memcpy(copy, array.data(), sizeof(T) * array.size());
+  return copy;
+}
+
+// Finds a seed for each bucket such that every key lands in a distinct slot.
+// `slots` receives the entry index plus one for occupied slots and zero for
+// empty ones. Returns `false` if some bucket could not be placed.
+bool AssignSeeds(absl::Span<const uint64_t> hashes, size_t bucket_count,
+                 size_t slot_count, std::vector<uint32_t>& seeds,
+                 std::vector<uint32_t>& slots) {
+  const size_t bucket_mask = bucket_count - 1;
+  const size_t slot_mask = slot_count - 1;
+  std::vector<std::vector<uint32_t>> buckets(bucket_count);
+  for (size_t i = 0; i < hashes.size(); ++i) {
+    buckets[BucketIndex(hashes[i], bucket_mask)].push_back(
+        static_cast<uint32_t>(i));
+  }
+  // Place the largest buckets first, while most slots are still free.
+  std::vector<uint32_t> order(bucket_count);
+  for (size_t i = 0; i < bucket_count; ++i) {
+    order[i] = static_cast<uint32_t>(i);
+  }
+  std::stable_sort(order.begin(), order.end(), [&](uint32_t lhs, uint32_t rhs) {
+    return buckets[lhs].size() > buckets[rhs].size();
+  });
+
+  seeds.assign(bucket_count, 0);
+  slots.assign(slot_count, 0);
+  std::vector<size_t> candidate;
+  for (uint32_t bucket_index : order) {
+    const std::vector<uint32_t>& bucket = buckets[bucket_index];
+    if (bucket.empty()) {
+      break;
+    }
+    bool placed = false;
+    for (uint32_t seed = 0; seed < kMaxSeed && !placed; ++seed) {
+      candidate.clear();
+      placed = true;
+      for (uint32_t entry : bucket) {
+        const size_t slot = SlotIndex(hashes[entry], seed, slot_mask);
+        if (slots[slot] != 0 || std::find(candidate.begin(), candidate.end(),
+                                          slot) != candidate.end()) {
+          placed = false;
+          break;
+        }
+        candidate.push_back(slot);
+      }
+      if (placed) {
+        seeds[bucket_index] = seed;
+        for (size_t i = 0; i < bucket.size(); ++i) {
+          slots[candidate[i]] = bucket[i] + 1;
+        }
+      }
+    }
+    if (!placed) {
+      return false;
+    }
+  }
+  return true;
+}
+
+class ConstantMapValueIterator final : public ValueIterator {
+ public:
+  ConstantMapValueIterator(const Value* absl_nonnull keys,
+                           const Value* absl_nonnull values, size_t size)
+      : keys_(keys), values_(values), size_(size) {}
+
+  bool HasNext() override { return index_ < size_; }
+
+  absl::Status Next(const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+                    google::protobuf::MessageFactory* absl_nonnull message_factory,
+                    google::protobuf::Arena* absl_nonnull arena,
+                    Value* absl_nonnull result) override {
+    if (ABSL_PREDICT_FALSE(index_ >= size_)) {
+      return absl::FailedPreconditionError(
+          "ValueIterator::Next() called when "
+          "ValueIterator::HasNext() returns false");
+    }
+    *result = keys_[index_++];
+    return absl::OkStatus();
+  }
+
+  absl::StatusOr<bool> Next1(
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena,
+      Value* absl_nonnull key_or_value) override {
+    if (index_ >= size_) {
+      return false;
+    }
+    *key_or_value = keys_[index_++];
+    return true;
+  }
+
+  absl::StatusOr<bool> Next2(
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena, Value* absl_nullable key,
+      Value* absl_nullable value) override {
+    if (index_ >= size_) {
+      return false;
+    }
+    if (key != nullptr) {
+      *key = keys_[index_];
+    }
+    if (value != nullptr) {
+      *value = values_[index_];
+    }
+    ++index_;
+    return true;
+  }
+
+ private:
+  const Value* absl_nonnull const keys_;
+  const Value* absl_nonnull const values_;
+  const size_t size_;
+  size_t index_ = 0;
+};
+
+// The parts of a constant map, all allocated on the same arena.
+struct Table {
+  const uint32_t* absl_nonnull seeds;
+  size_t bucket_count;
+  const uint32_t* absl_nonnull slots;
+  size_t slot_count;
+  const uint64_t* absl_nonnull hashes;
+  Value* absl_nonnull keys;
+  Value* absl_nonnull values;
+  size_t size;
+};
+
+CustomMapValue MakeConstantCustomMapValue(const Table& table,
+                                          google::protobuf::Arena* absl_nonnull arena);
+
+class ConstantMapValue final : public CustomMapValueInterface {
+ public:
+  explicit ConstantMapValue(const Table& table) : table_(table) {}
+
+  // Only run by the arena if some key or value is not trivially destructible.
+  ~ConstantMapValue() override {
+    for (size_t i = 0; i < table_.size; ++i) {
+      table_.keys[i].~Value();
+      table_.values[i].~Value();
+    }
+  }
+
+ private:
+  const Value* absl_nullable Lookup(const Value& key) const {
+    const uint64_t hash = KeyHash(key);
+    const uint32_t seed =
+        table_.seeds[BucketIndex(hash, table_.bucket_count - 1)];
+    const uint32_t slot =
+        table_.slots[SlotIndex(hash, seed, table_.slot_count - 1)];
+    if (slot == 0) {
+      return nullptr;
+    }
+    const size_t entry = slot - 1;
+    if (table_.hashes[entry] != hash || !KeyEquals(table_.keys[entry], key)) {
+      return nullptr;
+    }
+    return &table_.values[entry];
+  }
+
+  std::string DebugString() const override {
+    std::string out = "{";
+    for (size_t i = 0; i < table_.size; ++i) {
+      if (i != 0) {
+        out.append(", ");
+      }
+      out.append(table_.keys[i].DebugString());
+      out.append(": ");
+      out.append(table_.values[i].DebugString());
+    }
+    out.append("}");
+    return out;
+  }
+
+  absl::Status ConvertToJsonObject(
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Message* absl_nonnull json) const override {
+    ABSL_DCHECK(descriptor_pool != nullptr);
+    ABSL_DCHECK(message_factory != nullptr);
+    ABSL_DCHECK(json != nullptr);
+    ABSL_DCHECK_EQ(json->GetDescriptor()->well_known_type(),
+                   google::protobuf::Descriptor::WELLKNOWNTYPE_STRUCT);
+
+    StructReflection reflection;
+    CEL_RETURN_IF_ERROR(reflection.Initialize(json->GetDescriptor()));
+
+    json->Clear();
+    for (size_t i = 0; i < table_.size; ++i) {
+      auto string_key = table_.keys[i].AsString();
+      if (!string_key) {
+        return TypeConversionError(table_.keys[i].GetRuntimeType(),
+                                   StringType())
+            .ToStatus();
+      }
+      CEL_RETURN_IF_ERROR(table_.values[i].ConvertToJson(
+          descriptor_pool, message_factory,
+          reflection.InsertField(json, string_key->NativeString())));
+    }
+    return absl::OkStatus();
+  }
+
+  size_t Size() const override { return table_.size; }
+
+  absl::Status ForEach(
+      ForEachCallback callback,
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena) const override {
+    for (size_t i = 0; i < table_.size; ++i) {
+      CEL_ASSIGN_OR_RETURN(auto ok,
+                           callback(table_.keys[i], table_.values[i]));
+      if (!ok) {
+        break;
+      }
+    }
+    return absl::OkStatus();
+  }
+
+  absl::StatusOr<absl_nonnull ValueIteratorPtr> NewIterator() const override {
+    return std::make_unique<ConstantMapValueIterator>(
+        table_.keys, table_.values, table_.size);
+  }
+
+  CustomMapValue Clone(google::protobuf::Arena* absl_nonnull arena) const override {
+    // The index only depends on the key hashes, so it is copied as is.
+    Table table = table_;
+    table.seeds = CopyArray(
+        absl::MakeConstSpan(table_.seeds, table_.bucket_count), arena);
+    table.slots =
+        CopyArray(absl::MakeConstSpan(table_.slots, table_.slot_count), arena);
+    table.hashes =
+        CopyArray(absl::MakeConstSpan(table_.hashes, table_.size), arena);
+    table.keys = AllocateArray<Value>(arena, table_.size);
+    table.values = AllocateArray<Value>(arena, table_.size);
+    for (size_t i = 0; i < table_.size; ++i) {
+      ::new (&table.keys[i]) Value(table_.keys[i].Clone(arena));
+      ::new (&table.values[i]) Value(table_.values[i].Clone(arena));
+    }
+    return MakeConstantCustomMapValue(table, arena);
+  }
+
+  absl::StatusOr<bool> Find(
+      const Value& key,
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena,
+      Value* absl_nonnull result) const override {
+    CEL_RETURN_IF_ERROR(CheckMapKey(key));
+    if (const Value* value = Lookup(key); value != nullptr) {
+      *result = *value;
+      return true;
+    }
+    return false;
+  }
+
+  absl::StatusOr<bool> Has(
+      const Value& key,
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena) const override {
+    CEL_RETURN_IF_ERROR(CheckMapKey(key));
+    return Lookup(key) != nullptr;
+  }
+
+  NativeTypeId GetNativeTypeId() const override {
+    return NativeTypeId::For<ConstantMapValue>();
+  }
+
+  const Table table_;
+};
+
+// Wraps `table`, whose keys and values have already been constructed on
+// `arena`.
+CustomMapValue MakeConstantCustomMapValue(const Table& table,
+                                          google::protobuf::Arena* absl_nonnull arena) {
+  bool trivially_destructible = true;
+  for (size_t i = 0; i < table.size && trivially_destructible; ++i) {
+    trivially_destructible =
+        ArenaTraits<>::trivially_destructible(table.keys[i]) &&
+        ArenaTraits<>::trivially_destructible(table.values[i]);
+  }
+  auto* map = ::new (arena->AllocateAligned(sizeof(ConstantMapValue),
+                                            alignof(ConstantMapValue)))
+      ConstantMapValue(table);
+  if (!trivially_destructible) {
+    arena->OwnDestructor(map);
+  }
+  return CustomMapValue(map, arena);
+}
+
+// Returns an error if the keys of any two of `entries` are equal.
+absl::Status CheckDistinctKeys(absl::Span<const std::pair<Value, Value>> entries,
+                               absl::Span<const uint64_t> hashes) {
+  std::vector<uint32_t> order(hashes.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    order[i] = static_cast<uint32_t>(i);
+  }
+  std::sort(order.begin(), order.end(), [&](uint32_t lhs, uint32_t rhs) {
+    return hashes[lhs] < hashes[rhs];
+  });
+  for (size_t begin = 0; begin < order.size();) {
+    size_t end = begin + 1;
+    while (end < order.size() && hashes[order[end]] == hashes[order[begin]]) {
+      ++end;
+    }
+    for (size_t i = begin; i < end; ++i) {
+      for (size_t j = i + 1; j < end; ++j) {
+        if (KeyEquals(entries[order[i]].first, entries[order[j]].first)) {
+          return DuplicateKeyError().ToStatus();
+        }
+      }
+    }
+    begin = end;
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+absl::StatusOr<MapValue> MakeConstantMapValue(
+    absl::Span<const std::pair<Value, Value>> entries,
+    google::protobuf::Arena* absl_nonnull arena) {
+  ABSL_DCHECK(arena != nullptr);
+
+  if (entries.empty()) {
+    return MapValue();
+  }
+
+  std::vector<uint64_t> hashes;
+  hashes.reserve(entries.size());
+  for (const auto& entry : entries) {
+    CEL_RETURN_IF_ERROR(CheckMapKey(entry.first));
+    CEL_RETURN_IF_ERROR(CheckMapValue(entry.second));
+    hashes.push_back(KeyHash(entry.first));
+  }
+  CEL_RETURN_IF_ERROR(CheckDistinctKeys(entries, hashes));
+
+  const size_t bucket_count =
+      absl::bit_ceil((entries.size() + kKeysPerBucket - 1) / kKeysPerBucket);
+  // Keep the slot table at most 80% full to start with.
+  size_t slot_count = absl::bit_ceil(entries.size() + entries.size() / 4);
+  std::vector<uint32_t> seeds;
+  std::vector<uint32_t> slots;
+  bool placed = false;
+  for (int attempt = 0; attempt < kMaxAttempts && !placed; ++attempt) {
+    placed = AssignSeeds(hashes, bucket_count, slot_count, seeds, slots);
+    if (!placed) {
+      slot_count *= 2;
+    }
+  }
+  if (ABSL_PREDICT_FALSE(!placed)) {
+    // Only possible if distinct keys have the same hash.
+    return absl::ResourceExhaustedError(
+        "unable to build a perfect hash for map keys");
+  }
+
+  Table table;
+  table.seeds = CopyArray(absl::MakeConstSpan(seeds), arena);
+  table.bucket_count = seeds.size();
+  table.slots = CopyArray(absl::MakeConstSpan(slots), arena);
+  table.slot_count = slots.size();
+  table.hashes = CopyArray(absl::MakeConstSpan(hashes), arena);
+  table.keys = AllocateArray<Value>(arena, entries.size());
+  table.values = AllocateArray<Value>(arena, entries.size());
+  table.size = entries.size();
+  for (size_t i = 0; i < entries.size(); ++i) {
+    ::new (&table.keys[i]) Value(entries[i].first.Clone(arena));
+    ::new (&table.values[i]) Value(entries[i].second.Clone(arena));
+  }
+  return MakeConstantCustomMapValue(table, arena);
+}
+
+bool IsConstantMapValue(const MapValue& value) {
+  auto custom_map_value = value.AsCustom();
+  return custom_map_value &&
+         custom_map_value->GetTypeId() == NativeTypeId::For<ConstantMapValue>();
+}
+
+}  // namespace cel::common_internal
@@ -0,0 +1,48 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_COMMON_VALUES_CONSTANT_MAP_VALUE_H_
+#define THIRD_PARTY_CEL_CPP_COMMON_VALUES_CONSTANT_MAP_VALUE_H_
+
+#include <utility>
+
+#include "absl/base/nullability.h"
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "common/value.h"
+#include "google/protobuf/arena.h"
+
+namespace cel::common_internal {
+
+// Returns an immutable map of `entries`, indexed by a perfect hash function
+// over its keys which is computed once here. Lookups hash the key and probe
+// exactly one slot. Iteration follows the order of `entries`.
+//
+// This is intended for maps which are built once, such as map literals with
+// constant entries, and then shared by many evaluations, possibly on several
+// threads at once. Building the index takes longer than inserting into a
+// `MapValueBuilder`.
+//
+// Keys and values are cloned onto `arena`. Returns an error if a key is not a
+// valid map key, if a value is an error or unknown, or if a key is repeated.
+absl::StatusOr<MapValue> MakeConstantMapValue(
+    absl::Span<const std::pair<Value, Value>> entries,
+    google::protobuf::Arena* absl_nonnull arena);
+
+// Returns `true` if `value` was created by `MakeConstantMapValue()`.
+bool IsConstantMapValue(const MapValue& value);
+
+}  // namespace cel::common_internal
+
+#endif  // THIRD_PARTY_CEL_CPP_COMMON_VALUES_CONSTANT_MAP_VALUE_H_
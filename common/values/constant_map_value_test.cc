@@ -0,0 +1,159 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/values/constant_map_value.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/types/optional.h"
+#include "common/value.h"
+#include "common/value_testing.h"
+#include "internal/testing.h"
+#include "google/protobuf/arena.h"
+
+namespace cel::common_internal {
+namespace {
+
+using ::absl_testing::IsOk;
+using ::absl_testing::IsOkAndHolds;
+using ::absl_testing::StatusIs;
+using ::cel::test::BoolValueIs;
+using ::cel::test::ErrorValueIs;
+using ::cel::test::IntValueIs;
+using ::cel::test::StringValueIs;
+using ::testing::ElementsAre;
+using ::testing::Optional;
+
+using ConstantMapValueTest = common_internal::ValueTest<>;
+
+TEST_F(ConstantMapValueTest, Find) {
+  std::vector<std::pair<Value, Value>> entries = {
+      {StringValue("US"), IntValue(1)},
+      {StringValue("CA"), IntValue(2)},
+      {IntValue(1), StringValue("one")},
+      {UintValue(1), StringValue("uone")},
+      {BoolValue(true), NullValue()},
+  };
+  ASSERT_OK_AND_ASSIGN(MapValue map, MakeConstantMapValue(entries, arena()));
+  EXPECT_TRUE(IsConstantMapValue(map));
+  EXPECT_THAT(map.Size(), IsOkAndHolds(5));
+  EXPECT_THAT(map.Find(StringValue("CA"), descriptor_pool(), message_factory(),
+                       arena()),
+              IsOkAndHolds(Optional(IntValueIs(2))));
+  EXPECT_THAT(map.Find(StringValue("MX"), descriptor_pool(), message_factory(),
+                       arena()),
+              IsOkAndHolds(absl::nullopt));
+  EXPECT_THAT(map.Get(IntValue(1), descriptor_pool(), message_factory(),
+                      arena()),
+              IsOkAndHolds(StringValueIs("one")));
+  EXPECT_THAT(map.Get(UintValue(1), descriptor_pool(), message_factory(),
+                      arena()),
+              IsOkAndHolds(StringValueIs("uone")));
+  EXPECT_THAT(map.Has(BoolValue(true), descriptor_pool(), message_factory(),
+                      arena()),
+              IsOkAndHolds(BoolValueIs(true)));
+  EXPECT_THAT(map.Has(BoolValue(false), descriptor_pool(), message_factory(),
+                      arena()),
+              IsOkAndHolds(BoolValueIs(false)));
+  EXPECT_THAT(
+      map.Get(IntValue(2), descriptor_pool(), message_factory(), arena()),
+      IsOkAndHolds(ErrorValueIs(StatusIs(absl::StatusCode::kNotFound))));
+  EXPECT_EQ(map.DebugString(),
+            "{\"US\": 1, \"CA\": 2, 1: \"one\", 1u: \"uone\", true: null}");
+}
+
+TEST_F(ConstantMapValueTest, Empty) {
+  ASSERT_OK_AND_ASSIGN(MapValue map, MakeConstantMapValue({}, arena()));
+  EXPECT_THAT(map.IsEmpty(), IsOkAndHolds(true));
+}
+
+TEST_F(ConstantMapValueTest, DuplicateKey) {
+  std::vector<std::pair<Value, Value>> entries = {
+      {StringValue("a"), IntValue(1)},
+      {StringValue("b"), IntValue(2)},
+      {StringValue("a"), IntValue(3)},
+  };
+  EXPECT_THAT(MakeConstantMapValue(entries, arena()),
+              StatusIs(absl::StatusCode::kAlreadyExists));
+}
+
+TEST_F(ConstantMapValueTest, RejectsInvalidKeys) {
+  std::vector<std::pair<Value, Value>> entries = {
+      {DoubleValue(1.0), IntValue(1)},
+  };
+  EXPECT_THAT(MakeConstantMapValue(entries, arena()),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST_F(ConstantMapValueTest, Large) {
+  constexpr int64_t kSize = 1000;
+  std::vector<std::pair<Value, Value>> entries;
+  for (int64_t i = 0; i < kSize; ++i) {
+    entries.push_back({StringValue(absl::StrCat("key", i)), IntValue(i)});
+  }
+  ASSERT_OK_AND_ASSIGN(MapValue map, MakeConstantMapValue(entries, arena()));
+  EXPECT_THAT(map.Size(), IsOkAndHolds(kSize));
+  for (int64_t i = 0; i < kSize; ++i) {
+    ASSERT_THAT(map.Get(StringValue(absl::StrCat("key", i)), descriptor_pool(),
+                        message_factory(), arena()),
+                IsOkAndHolds(IntValueIs(i)));
+    ASSERT_THAT(map.Has(StringValue(absl::StrCat("other", i)),
+                        descriptor_pool(), message_factory(), arena()),
+                IsOkAndHolds(BoolValueIs(false)));
+  }
+}
+
+TEST_F(ConstantMapValueTest, Iteration) {
+  std::vector<std::pair<Value, Value>> entries = {
+      {IntValue(3), IntValue(30)},
+      {IntValue(1), IntValue(10)},
+      {IntValue(2), IntValue(20)},
+  };
+  ASSERT_OK_AND_ASSIGN(MapValue map, MakeConstantMapValue(entries, arena()));
+  std::vector<int64_t> keys;
+  ASSERT_THAT(map.ForEach(
+                  [&](const Value& key, const Value& value)
+                      -> absl::StatusOr<bool> {
+                    EXPECT_EQ(value.GetInt().NativeValue(),
+                              key.GetInt().NativeValue() * 10);
+                    keys.push_back(key.GetInt().NativeValue());
+                    return true;
+                  },
+                  descriptor_pool(), message_factory(), arena()),
+              IsOk());
+  EXPECT_THAT(keys, ElementsAre(3, 1, 2));
+}
+
+TEST_F(ConstantMapValueTest, Clone) {
+  std::vector<std::pair<Value, Value>> entries = {
+      {StringValue("foo"), StringValue("bar")},
+  };
+  ASSERT_OK_AND_ASSIGN(MapValue map, MakeConstantMapValue(entries, arena()));
+  google::protobuf::Arena other_arena;
+  Value clone = Value(map).Clone(&other_arena);
+  ASSERT_TRUE(clone.IsMap());
+  EXPECT_TRUE(IsConstantMapValue(clone.GetMap()));
+  EXPECT_THAT(clone.GetMap().Get(StringValue("foo"), descriptor_pool(),
+                                 message_factory(), arena()),
+              IsOkAndHolds(StringValueIs("bar")));
+}
+
+}  // namespace
+}  // namespace cel::common_internal
@@ -179,6 +179,10 @@ class CustomListValueInterfaceIterator final : public ValueIterator {
   }
 
  private:
+  NativeTypeId GetNativeTypeId() const override {
+    return NativeTypeId::For<CustomListValueInterfaceIterator>();
+  }
+
   const CustomListValueInterface& interface_;
   const size_t size_;
   size_t index_ = 0;
@@ -291,17 +295,43 @@ absl::Status CustomListValueInterface::SerializeTo(
   return absl::OkStatus();
 }
 
-absl::Status CustomListValueInterface::ForEach(
-    ForEachWithIndexCallback callback,
+namespace {
+
+// Advances `iterator` to the element at `index` and stores it in `result`, for
+// lists which are only traversable through their iterator.
+absl::Status GetByIterating(
+    ValueIterator& iterator, size_t index,
     const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
     google::protobuf::MessageFactory* absl_nonnull message_factory,
-    google::protobuf::Arena* absl_nonnull arena) const {
-  const size_t size = Size();
-  for (size_t index = 0; index < size; ++index) {
-    Value element;
-    CEL_RETURN_IF_ERROR(
-        Get(index, descriptor_pool, message_factory, arena, &element));
-    CEL_ASSIGN_OR_RETURN(auto ok, callback(index, element));
+    google::protobuf::Arena* absl_nonnull arena, Value* absl_nonnull result) {
+  for (size_t position = 0; position <= index; ++position) {
+    CEL_ASSIGN_OR_RETURN(bool ok, iterator.Next1(descriptor_pool,
+                                                 message_factory, arena, result));
+    if (!ok) {
+      *result = IndexOutOfBoundsError(index);
+      break;
+    }
+  }
+  return absl::OkStatus();
+}
+
+// Invokes `callback` for each element produced by `iterator`, stopping early
+// if it returns `false`.
+absl::Status ForEachByIterating(
+    ValueIterator& iterator,
+    CustomListValueInterface::ForEachWithIndexCallback callback,
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena) {
+  Value element;
+  for (size_t index = 0;; ++index) {
+    CEL_ASSIGN_OR_RETURN(bool ok, iterator.Next1(descriptor_pool,
+                                                 message_factory, arena,
+                                                 &element));
+    if (!ok) {
+      break;
+    }
+    CEL_ASSIGN_OR_RETURN(ok, callback(index, element));
     if (!ok) {
       break;
     }
@@ -309,6 +339,35 @@ absl::Status CustomListValueInterface::ForEach(
   return absl::OkStatus();
 }
 
+}  // namespace
+
+absl::Status CustomListValueInterface::Get(
+    size_t index, const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena, Value* absl_nonnull result) const {
+  CEL_ASSIGN_OR_RETURN(auto iterator, NewIterator());
+  if (iterator->GetNativeTypeId() ==
+      NativeTypeId::For<CustomListValueInterfaceIterator>()) {
+    // Neither `Get()` nor `NewIterator()` is overridden, and the default of
+    // each is implemented in terms of the other.
+    return absl::UnimplementedError(
+        "CustomListValueInterface implementations must override Get() or "
+        "NewIterator()");
+  }
+  return GetByIterating(*iterator, index, descriptor_pool, message_factory,
+                        arena, result);
+}
+
+absl::Status CustomListValueInterface::ForEach(
+    ForEachWithIndexCallback callback,
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena) const {
+  CEL_ASSIGN_OR_RETURN(auto iterator, NewIterator());
+  return ForEachByIterating(*iterator, callback, descriptor_pool,
+                            message_factory, arena);
+}
+
 absl::StatusOr<absl_nonnull ValueIteratorPtr>
 CustomListValueInterface::NewIterator() const {
   return std::make_unique<CustomListValueInterfaceIterator>(*this);
@@ -528,6 +587,12 @@ absl::Status CustomListValue::Get(
     return content.interface->Get(index, descriptor_pool, message_factory,
                                   arena, result);
   }
+  if (dispatcher_->get == nullptr) {
+    CEL_ASSIGN_OR_RETURN(auto iterator,
+                         dispatcher_->new_iterator(dispatcher_, content_));
+    return GetByIterating(*iterator, index, descriptor_pool, message_factory,
+                          arena, result);
+  }
   return dispatcher_->get(dispatcher_, content_, index, descriptor_pool,
                           message_factory, arena, result);
 }
@@ -548,6 +613,12 @@ absl::Status CustomListValue::ForEach(
     return dispatcher_->for_each(dispatcher_, content_, callback,
                                  descriptor_pool, message_factory, arena);
   }
+  if (dispatcher_->get == nullptr) {
+    CEL_ASSIGN_OR_RETURN(auto iterator,
+                         dispatcher_->new_iterator(dispatcher_, content_));
+    return ForEachByIterating(*iterator, callback, descriptor_pool,
+                              message_factory, arena);
+  }
   const size_t size = dispatcher_->size(dispatcher_, content_);
   for (size_t index = 0; index < size; ++index) {
     Value element;
@@ -153,12 +153,17 @@ struct CustomListValueDispatcher {
 
   absl_nonnull Size size;
 
-  absl_nonnull Get get;
+  // May only be null if `new_iterator` is not, in which case random access
+  // advances a fresh iterator. This allows lists backed by a cursor, which
+  // cannot seek, to be used in comprehensions with constant memory.
+  absl_nullable Get get = nullptr;
 
-  // If null, a fallback implementation using `size` and `get` is used.
+  // If null, a fallback implementation using `size` and `get` is used, or
+  // `new_iterator` if `get` is null.
   absl_nullable ForEach for_each = nullptr;
 
-  // If null, a fallback implementation using `size` and `get` is used.
+  // If null, a fallback implementation using `size` and `get` is used. Must
+  // not be null if `get` is null.
   absl_nullable NewIterator new_iterator = nullptr;
 
   // If null, a fallback implementation is used.
@@ -216,17 +221,23 @@ class CustomListValueInterface {
 
   virtual size_t Size() const = 0;
 
+  // Implementations must override at least one of `Get()` and `NewIterator()`.
+  // Lists which can only be traversed sequentially should override
+  // `NewIterator()`; the default `Get()` then advances a fresh iterator to
+  // `index`. If neither is overridden, `Get()` returns `UNIMPLEMENTED`.
   virtual absl::Status Get(
       size_t index, const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
       google::protobuf::MessageFactory* absl_nonnull message_factory,
-      google::protobuf::Arena* absl_nonnull arena, Value* absl_nonnull result) const = 0;
+      google::protobuf::Arena* absl_nonnull arena, Value* absl_nonnull result) const;
 
+  // The default implementation iterates `NewIterator()`.
   virtual absl::Status ForEach(
       ForEachWithIndexCallback callback,
       const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
       google::protobuf::MessageFactory* absl_nonnull message_factory,
       google::protobuf::Arena* absl_nonnull arena) const;
 
+  // The default implementation calls `Get()` for each index up to `Size()`.
   virtual absl::StatusOr<absl_nonnull ValueIteratorPtr> NewIterator() const;
 
   virtual absl::Status Contains(
@@ -391,7 +402,8 @@ class CustomListValue final
     ABSL_DCHECK(dispatcher->get_arena != nullptr);
     ABSL_DCHECK(dispatcher->is_zero_value != nullptr);
     ABSL_DCHECK(dispatcher->size != nullptr);
-    ABSL_DCHECK(dispatcher->get != nullptr);
+    ABSL_DCHECK(dispatcher->get != nullptr ||
+                dispatcher->new_iterator != nullptr);
     ABSL_DCHECK(dispatcher->clone != nullptr);
   }
 
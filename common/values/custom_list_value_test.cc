@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -45,6 +47,7 @@ using ::absl_testing::StatusIs;
 using ::cel::test::BoolValueIs;
 using ::cel::test::ErrorValueIs;
 using ::cel::test::IntValueIs;
+using ::testing::ElementsAre;
 using ::testing::Eq;
 using ::testing::IsEmpty;
 using ::testing::IsNull;
@@ -130,8 +133,139 @@ class CustomListValueInterfaceTest final : public CustomListValueInterface {
   }
 };
 
+// Yields `[true, 1]` one element at a time, standing in for a cursor which
+// cannot seek.
+class CustomListValueStreamingTestIterator final : public ValueIterator {
+ public:
+  bool HasNext() override { return index_ < 2; }
+
+  absl::Status Next(const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+                    google::protobuf::MessageFactory* absl_nonnull message_factory,
+                    google::protobuf::Arena* absl_nonnull arena,
+                    Value* absl_nonnull result) override {
+    if (index_ >= 2) {
+      return absl::FailedPreconditionError(
+          "ValueIterator::Next() called when "
+          "ValueIterator::HasNext() returns false");
+    }
+    *result = index_ == 0 ? Value(TrueValue()) : Value(IntValue(1));
+    ++index_;
+    return absl::OkStatus();
+  }
+
+  absl::StatusOr<bool> Next2(
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena, Value* absl_nullable key,
+      Value* absl_nullable value) override {
+    if (index_ >= 2) {
+      return false;
+    }
+    if (key != nullptr) {
+      *key = IntValue(index_);
+    }
+    if (value != nullptr) {
+      *value = index_ == 0 ? Value(TrueValue()) : Value(IntValue(1));
+    }
+    ++index_;
+    return true;
+  }
+
+ private:
+  int64_t index_ = 0;
+};
+
+// Only supports sequential access through `NewIterator()`.
+class CustomListValueStreamingInterfaceTest final
+    : public CustomListValueInterface {
+ public:
+  std::string DebugString() const override { return "[true, 1]"; }
+
+  absl::Status ConvertToJsonArray(
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Message* absl_nonnull json) const override {
+    return absl::UnimplementedError("not implemented");
+  }
+
+  size_t Size() const override { return 2; }
+
+  CustomListValue Clone(google::protobuf::Arena* absl_nonnull arena) const override {
+    return CustomListValue(
+        (::new (arena->AllocateAligned(
+            sizeof(CustomListValueStreamingInterfaceTest),
+            alignof(CustomListValueStreamingInterfaceTest)))
+             CustomListValueStreamingInterfaceTest()),
+        arena);
+  }
+
+ private:
+  absl::StatusOr<absl_nonnull ValueIteratorPtr> NewIterator() const override {
+    return std::make_unique<CustomListValueStreamingTestIterator>();
+  }
+
+  NativeTypeId GetNativeTypeId() const override {
+    return NativeTypeId::For<CustomListValueStreamingInterfaceTest>();
+  }
+};
+
+// Overrides neither `Get()` nor `NewIterator()`.
+class CustomListValueIncompleteInterfaceTest final
+    : public CustomListValueInterface {
+ public:
+  std::string DebugString() const override { return "[?]"; }
+
+  absl::Status ConvertToJsonArray(
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Message* absl_nonnull json) const override {
+    return absl::UnimplementedError("not implemented");
+  }
+
+  size_t Size() const override { return 1; }
+
+  CustomListValue Clone(google::protobuf::Arena* absl_nonnull arena) const override {
+    return CustomListValue(
+        (::new (arena->AllocateAligned(
+            sizeof(CustomListValueIncompleteInterfaceTest),
+            alignof(CustomListValueIncompleteInterfaceTest)))
+             CustomListValueIncompleteInterfaceTest()),
+        arena);
+  }
+
+ private:
+  NativeTypeId GetNativeTypeId() const override {
+    return NativeTypeId::For<CustomListValueIncompleteInterfaceTest>();
+  }
+};
+
 class CustomListValueTest : public common_internal::ValueTest<> {
  public:
+  CustomListValue MakeStreamingInterface() {
+    return CustomListValue(
+        (::new (arena()->AllocateAligned(
+            sizeof(CustomListValueStreamingInterfaceTest),
+            alignof(CustomListValueStreamingInterfaceTest)))
+             CustomListValueStreamingInterfaceTest()),
+        arena());
+  }
+
+  CustomListValue MakeIncompleteInterface() {
+    return CustomListValue(
+        (::new (arena()->AllocateAligned(
+            sizeof(CustomListValueIncompleteInterfaceTest),
+            alignof(CustomListValueIncompleteInterfaceTest)))
+             CustomListValueIncompleteInterfaceTest()),
+        arena());
+  }
+
+  CustomListValue MakeStreamingDispatcher() {
+    return UnsafeCustomListValue(
+        &streaming_test_dispatcher_,
+        CustomValueContent::From<CustomListValueTestContent>(
+            CustomListValueTestContent{.arena = arena()}));
+  }
+
   CustomListValue MakeInterface() {
     return CustomListValue(
         (::new (arena()->AllocateAligned(sizeof(CustomListValueInterfaceTest),
@@ -232,6 +366,37 @@ class CustomListValueTest : public common_internal::ValueTest<> {
                             CustomListValueTestContent{.arena = arena}));
       },
   };
+
+  CustomListValueDispatcher streaming_test_dispatcher_ = {
+      .get_type_id =
+          [](const CustomListValueDispatcher* absl_nonnull dispatcher,
+             CustomListValueContent content) -> NativeTypeId {
+        return NativeTypeId::For<CustomListValueTest>();
+      },
+      .get_arena =
+          [](const CustomListValueDispatcher* absl_nonnull dispatcher,
+             CustomListValueContent content) -> google::protobuf::Arena* absl_nullable {
+        return content.To<CustomListValueTestContent>().arena;
+      },
+      .is_zero_value =
+          [](const CustomListValueDispatcher* absl_nonnull dispatcher,
+             CustomListValueContent content) -> bool { return false; },
+      .size = [](const CustomListValueDispatcher* absl_nonnull dispatcher,
+                 CustomListValueContent content) -> size_t { return 2; },
+      .new_iterator =
+          [](const CustomListValueDispatcher* absl_nonnull dispatcher,
+             CustomListValueContent content)
+          -> absl::StatusOr<absl_nonnull ValueIteratorPtr> {
+        return std::make_unique<CustomListValueStreamingTestIterator>();
+      },
+      .clone = [](const CustomListValueDispatcher* absl_nonnull dispatcher,
+                  CustomListValueContent content,
+                  google::protobuf::Arena* absl_nonnull arena) -> CustomListValue {
+        return UnsafeCustomListValue(
+            dispatcher, CustomValueContent::From<CustomListValueTestContent>(
+                            CustomListValueTestContent{.arena = arena}));
+      },
+  };
 };
 
 TEST_F(CustomListValueTest, Kind) {
@@ -534,6 +699,81 @@ TEST_F(CustomListValueTest, Interface_Contains) {
               IsOkAndHolds(BoolValueIs(false)));
 }
 
+TEST_F(CustomListValueTest, StreamingDispatcher_Get) {
+  CustomListValue list = MakeStreamingDispatcher();
+  ASSERT_THAT(list.Get(0, descriptor_pool(), message_factory(), arena()),
+              IsOkAndHolds(BoolValueIs(true)));
+  ASSERT_THAT(list.Get(1, descriptor_pool(), message_factory(), arena()),
+              IsOkAndHolds(IntValueIs(1)));
+  ASSERT_THAT(
+      list.Get(2, descriptor_pool(), message_factory(), arena()),
+      IsOkAndHolds(ErrorValueIs(StatusIs(absl::StatusCode::kInvalidArgument))));
+}
+
+TEST_F(CustomListValueTest, StreamingInterface_Get) {
+  CustomListValue list = MakeStreamingInterface();
+  ASSERT_THAT(list.Get(0, descriptor_pool(), message_factory(), arena()),
+              IsOkAndHolds(BoolValueIs(true)));
+  ASSERT_THAT(list.Get(1, descriptor_pool(), message_factory(), arena()),
+              IsOkAndHolds(IntValueIs(1)));
+  ASSERT_THAT(
+      list.Get(2, descriptor_pool(), message_factory(), arena()),
+      IsOkAndHolds(ErrorValueIs(StatusIs(absl::StatusCode::kInvalidArgument))));
+}
+
+TEST_F(CustomListValueTest, StreamingDispatcher_ForEach) {
+  std::vector<std::pair<size_t, Value>> fields;
+  EXPECT_THAT(
+      MakeStreamingDispatcher().ForEach(
+          [&](size_t index, const Value& value) -> absl::StatusOr<bool> {
+            fields.push_back(std::pair{index, value});
+            return true;
+          },
+          descriptor_pool(), message_factory(), arena()),
+      IsOk());
+  EXPECT_THAT(fields, ElementsAre(Pair(0, BoolValueIs(true)),
+                                  Pair(1, IntValueIs(1))));
+}
+
+TEST_F(CustomListValueTest, StreamingInterface_ForEach) {
+  std::vector<std::pair<size_t, Value>> fields;
+  EXPECT_THAT(
+      MakeStreamingInterface().ForEach(
+          [&](size_t index, const Value& value) -> absl::StatusOr<bool> {
+            fields.push_back(std::pair{index, value});
+            return true;
+          },
+          descriptor_pool(), message_factory(), arena()),
+      IsOk());
+  EXPECT_THAT(fields, ElementsAre(Pair(0, BoolValueIs(true)),
+                                  Pair(1, IntValueIs(1))));
+}
+
+TEST_F(CustomListValueTest, StreamingInterface_Contains) {
+  CustomListValue list = MakeStreamingInterface();
+  EXPECT_THAT(list.Contains(IntValue(1), descriptor_pool(), message_factory(),
+                            arena()),
+              IsOkAndHolds(BoolValueIs(true)));
+  EXPECT_THAT(list.Contains(IntValue(2), descriptor_pool(), message_factory(),
+                            arena()),
+              IsOkAndHolds(BoolValueIs(false)));
+}
+
+TEST_F(CustomListValueTest, IncompleteInterface_Unimplemented) {
+  CustomListValue list = MakeIncompleteInterface();
+  EXPECT_THAT(list.Get(0, descriptor_pool(), message_factory(), arena()),
+              StatusIs(absl::StatusCode::kUnimplemented));
+  EXPECT_THAT(list.ForEach(
+                  [](size_t, const Value&) -> absl::StatusOr<bool> {
+                    return true;
+                  },
+                  descriptor_pool(), message_factory(), arena()),
+              StatusIs(absl::StatusCode::kUnimplemented));
+  ASSERT_OK_AND_ASSIGN(auto iterator, list.NewIterator());
+  EXPECT_THAT(iterator->Next1(descriptor_pool(), message_factory(), arena()),
+              StatusIs(absl::StatusCode::kUnimplemented));
+}
+
 TEST_F(CustomListValueTest, Dispatcher) {
   EXPECT_THAT(MakeDispatcher().dispatcher(), NotNull());
   EXPECT_THAT(MakeDispatcher().interface(), IsNull());
@@ -15,6 +15,7 @@
 #include <cstddef>
 #include <memory>
 #include <string>
+#include <utility>
 
 #include "absl/base/attributes.h"
 #include "absl/base/no_destructor.h"
@@ -59,6 +60,28 @@ absl::Status InvalidMapKeyTypeError(ValueKind kind) {
       absl::StrCat("Invalid map key type: '", ValueKindToString(kind), "'"));
 }
 
+// Collects the keys produced by `iterator` into a list, for maps which are only
+// traversable through their iterator.
+absl::Status ListKeysByIterating(
+    ValueIterator& iterator, size_t size,
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena, ListValue* absl_nonnull result) {
+  auto builder = common_internal::NewListValueBuilder(arena);
+  builder->Reserve(size);
+  Value key;
+  while (true) {
+    CEL_ASSIGN_OR_RETURN(bool ok, iterator.Next1(descriptor_pool,
+                                                 message_factory, arena, &key));
+    if (!ok) {
+      break;
+    }
+    CEL_RETURN_IF_ERROR(builder->Add(std::move(key)));
+  }
+  *result = std::move(*builder).Build();
+  return absl::OkStatus();
+}
+
 class EmptyMapValue final : public common_internal::CompatMapValue {
  public:
   static const EmptyMapValue& Get() {
@@ -256,6 +279,10 @@ class CustomMapValueInterfaceIterator final : public ValueIterator {
     return absl::OkStatus();
   }
 
+  NativeTypeId GetNativeTypeId() const override {
+    return NativeTypeId::For<CustomMapValueInterfaceIterator>();
+  }
+
   const CustomMapValueInterface* absl_nonnull const interface_;
   ListValue keys_;
   absl_nullable ValueIteratorPtr keys_iterator_;
@@ -434,6 +461,23 @@ absl::Status CustomMapValueInterface::ForEach(
   return absl::OkStatus();
 }
 
+absl::Status CustomMapValueInterface::ListKeys(
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena, ListValue* absl_nonnull result) const {
+  CEL_ASSIGN_OR_RETURN(auto iterator, NewIterator());
+  if (iterator->GetNativeTypeId() ==
+      NativeTypeId::For<CustomMapValueInterfaceIterator>()) {
+    // Neither `ListKeys()` nor `NewIterator()` is overridden, and the default
+    // of each is implemented in terms of the other.
+    return absl::UnimplementedError(
+        "CustomMapValueInterface implementations must override ListKeys() or "
+        "NewIterator()");
+  }
+  return ListKeysByIterating(*iterator, Size(), descriptor_pool,
+                             message_factory, arena, result);
+}
+
 absl::StatusOr<absl_nonnull ValueIteratorPtr>
 CustomMapValueInterface::NewIterator() const {
   return std::make_unique<CustomMapValueInterfaceIterator>(this);
@@ -753,6 +797,13 @@ absl::Status CustomMapValue::ListKeys(
     return content.interface->ListKeys(descriptor_pool, message_factory, arena,
                                        result);
   }
+  if (dispatcher_->list_keys == nullptr) {
+    CEL_ASSIGN_OR_RETURN(auto iterator,
+                         dispatcher_->new_iterator(dispatcher_, content_));
+    return ListKeysByIterating(*iterator,
+                               dispatcher_->size(dispatcher_, content_),
+                               descriptor_pool, message_factory, arena, result);
+  }
   return dispatcher_->list_keys(dispatcher_, content_, descriptor_pool,
                                 message_factory, arena, result);
 }
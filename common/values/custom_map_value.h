@@ -165,12 +165,17 @@ struct CustomMapValueDispatcher {
 
   absl_nonnull Has has;
 
-  absl_nonnull ListKeys list_keys;
+  // May only be null if `new_iterator` is not, in which case the keys are
+  // collected by iterating. This allows maps backed by a cursor to be used in
+  // comprehensions without materializing their keys.
+  absl_nullable ListKeys list_keys = nullptr;
 
-  // If null, a fallback implementation based on `list_keys` is used.
+  // If null, a fallback implementation based on `new_iterator` is used, or
+  // `list_keys` if `new_iterator` is null.
   absl_nullable ForEach for_each = nullptr;
 
-  // If null, a fallback implementation based on `list_keys` is used.
+  // If null, a fallback implementation based on `list_keys` is used. Must not
+  // be null if `list_keys` is null.
   absl_nullable NewIterator new_iterator = nullptr;
 
   absl_nonnull Clone clone;
@@ -227,11 +232,16 @@ class CustomMapValueInterface {
 
   // See the corresponding member function of `MapValueInterface` for
   // documentation.
+  //
+  // Implementations must override at least one of `ListKeys()` and
+  // `NewIterator()`. The default collects the keys produced by
+  // `NewIterator()`, or returns `UNIMPLEMENTED` if that is not overridden
+  // either.
   virtual absl::Status ListKeys(
       const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
       google::protobuf::MessageFactory* absl_nonnull message_factory,
       google::protobuf::Arena* absl_nonnull arena,
-      ListValue* absl_nonnull result) const = 0;
+      ListValue* absl_nonnull result) const;
 
   // See the corresponding member function of `MapValueInterface` for
   // documentation.
@@ -438,7 +448,8 @@ class CustomMapValue final
     ABSL_DCHECK(dispatcher->size != nullptr);
     ABSL_DCHECK(dispatcher->find != nullptr);
     ABSL_DCHECK(dispatcher->has != nullptr);
-    ABSL_DCHECK(dispatcher->list_keys != nullptr);
+    ABSL_DCHECK(dispatcher->list_keys != nullptr ||
+                dispatcher->new_iterator != nullptr);
     ABSL_DCHECK(dispatcher->clone != nullptr);
   }
 
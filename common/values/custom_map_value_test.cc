@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <cstddef>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -164,8 +165,181 @@ class CustomMapValueInterfaceTest final : public CustomMapValueInterface {
   }
 };
 
+// Yields the entries of `{"foo": true, "bar": 1}` one at a time, standing in
+// for a cursor whose keys are not materialized.
+class CustomMapValueStreamingTestIterator final : public ValueIterator {
+ public:
+  bool HasNext() override { return index_ < 2; }
+
+  absl::Status Next(const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+                    google::protobuf::MessageFactory* absl_nonnull message_factory,
+                    google::protobuf::Arena* absl_nonnull arena,
+                    Value* absl_nonnull result) override {
+    if (index_ >= 2) {
+      return absl::FailedPreconditionError(
+          "ValueIterator::Next() called when "
+          "ValueIterator::HasNext() returns false");
+    }
+    *result = StringValue(index_ == 0 ? "foo" : "bar");
+    ++index_;
+    return absl::OkStatus();
+  }
+
+  absl::StatusOr<bool> Next2(
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena, Value* absl_nullable key,
+      Value* absl_nullable value) override {
+    if (index_ >= 2) {
+      return false;
+    }
+    if (key != nullptr) {
+      *key = StringValue(index_ == 0 ? "foo" : "bar");
+    }
+    if (value != nullptr) {
+      *value = index_ == 0 ? Value(TrueValue()) : Value(IntValue(1));
+    }
+    ++index_;
+    return true;
+  }
+
+ private:
+  int index_ = 0;
+};
+
+// Only supports enumerating entries through `NewIterator()`.
+class CustomMapValueStreamingInterfaceTest final
+    : public CustomMapValueInterface {
+ public:
+  std::string DebugString() const override {
+    return "{\"foo\": true, \"bar\": 1}";
+  }
+
+  absl::Status ConvertToJsonObject(
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Message* absl_nonnull json) const override {
+    return absl::UnimplementedError("not implemented");
+  }
+
+  size_t Size() const override { return 2; }
+
+  CustomMapValue Clone(google::protobuf::Arena* absl_nonnull arena) const override {
+    return CustomMapValue(
+        (::new (arena->AllocateAligned(
+            sizeof(CustomMapValueStreamingInterfaceTest),
+            alignof(CustomMapValueStreamingInterfaceTest)))
+             CustomMapValueStreamingInterfaceTest()),
+        arena);
+  }
+
+ private:
+  absl::StatusOr<absl_nonnull ValueIteratorPtr> NewIterator() const override {
+    return std::make_unique<CustomMapValueStreamingTestIterator>();
+  }
+
+  absl::StatusOr<bool> Find(
+      const Value& key,
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena,
+      Value* absl_nonnull result) const override {
+    if (auto string_key = key.AsString(); string_key) {
+      if (*string_key == "foo") {
+        *result = TrueValue();
+        return true;
+      }
+      if (*string_key == "bar") {
+        *result = IntValue(1);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  absl::StatusOr<bool> Has(
+      const Value& key,
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena) const override {
+    if (auto string_key = key.AsString(); string_key) {
+      return *string_key == "foo" || *string_key == "bar";
+    }
+    return false;
+  }
+
+  NativeTypeId GetNativeTypeId() const override {
+    return NativeTypeId::For<CustomMapValueStreamingInterfaceTest>();
+  }
+};
+
+// Overrides neither `ListKeys()` nor `NewIterator()`.
+class CustomMapValueIncompleteInterfaceTest final
+    : public CustomMapValueInterface {
+ public:
+  std::string DebugString() const override { return "{?}"; }
+
+  absl::Status ConvertToJsonObject(
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Message* absl_nonnull json) const override {
+    return absl::UnimplementedError("not implemented");
+  }
+
+  size_t Size() const override { return 1; }
+
+  CustomMapValue Clone(google::protobuf::Arena* absl_nonnull arena) const override {
+    return CustomMapValue(
+        (::new (arena->AllocateAligned(
+            sizeof(CustomMapValueIncompleteInterfaceTest),
+            alignof(CustomMapValueIncompleteInterfaceTest)))
+             CustomMapValueIncompleteInterfaceTest()),
+        arena);
+  }
+
+ private:
+  absl::StatusOr<bool> Find(
+      const Value& key,
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena,
+      Value* absl_nonnull result) const override {
+    return false;
+  }
+
+  absl::StatusOr<bool> Has(
+      const Value& key,
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena) const override {
+    return false;
+  }
+
+  NativeTypeId GetNativeTypeId() const override {
+    return NativeTypeId::For<CustomMapValueIncompleteInterfaceTest>();
+  }
+};
+
 class CustomMapValueTest : public common_internal::ValueTest<> {
  public:
+  CustomMapValue MakeIncompleteInterface() {
+    return CustomMapValue(
+        (::new (arena()->AllocateAligned(
+            sizeof(CustomMapValueIncompleteInterfaceTest),
+            alignof(CustomMapValueIncompleteInterfaceTest)))
+             CustomMapValueIncompleteInterfaceTest()),
+        arena());
+  }
+
+  CustomMapValue MakeStreamingInterface() {
+    return CustomMapValue(
+        (::new (arena()->AllocateAligned(
+            sizeof(CustomMapValueStreamingInterfaceTest),
+            alignof(CustomMapValueStreamingInterfaceTest)))
+             CustomMapValueStreamingInterfaceTest()),
+        arena());
+  }
+
   CustomMapValue MakeInterface() {
     return CustomMapValue(
         (::new (arena()->AllocateAligned(sizeof(CustomMapValueInterfaceTest),
@@ -628,6 +802,70 @@ TEST_F(CustomMapValueTest, Interface_NewIterator2) {
               IsOkAndHolds(Eq(absl::nullopt)));
 }
 
+TEST_F(CustomMapValueTest, StreamingInterface_ListKeys) {
+  ListValue keys;
+  ASSERT_THAT(MakeStreamingInterface().ListKeys(
+                  descriptor_pool(), message_factory(), arena(), &keys),
+              IsOk());
+  EXPECT_THAT(keys.Size(), IsOkAndHolds(2));
+  EXPECT_THAT(keys.Contains(StringValue("foo"), descriptor_pool(),
+                            message_factory(), arena()),
+              IsOkAndHolds(BoolValueIs(true)));
+  EXPECT_THAT(keys.Contains(StringValue("bar"), descriptor_pool(),
+                            message_factory(), arena()),
+              IsOkAndHolds(BoolValueIs(true)));
+}
+
+TEST_F(CustomMapValueTest, StreamingInterface_ForEach) {
+  std::vector<std::pair<Value, Value>> entries;
+  EXPECT_THAT(
+      MakeStreamingInterface().ForEach(
+          [&](const Value& key, const Value& value) -> absl::StatusOr<bool> {
+            entries.push_back(std::pair{key, value});
+            return true;
+          },
+          descriptor_pool(), message_factory(), arena()),
+      IsOk());
+  EXPECT_THAT(entries, UnorderedElementsAre(
+                           Pair(StringValueIs("foo"), BoolValueIs(true)),
+                           Pair(StringValueIs("bar"), IntValueIs(1))));
+}
+
+TEST_F(CustomMapValueTest, StreamingDispatcher_ListKeys) {
+  CustomMapValueDispatcher streaming_dispatcher = test_dispatcher_;
+  streaming_dispatcher.list_keys = nullptr;
+  streaming_dispatcher.new_iterator =
+      [](const CustomMapValueDispatcher* absl_nonnull dispatcher,
+         CustomMapValueContent content)
+      -> absl::StatusOr<absl_nonnull ValueIteratorPtr> {
+    return std::make_unique<CustomMapValueStreamingTestIterator>();
+  };
+  CustomMapValue map = UnsafeCustomMapValue(
+      &streaming_dispatcher,
+      CustomValueContent::From<CustomMapValueTestContent>(
+          CustomMapValueTestContent{.arena = arena()}));
+  ListValue keys;
+  ASSERT_THAT(map.ListKeys(descriptor_pool(), message_factory(), arena(), &keys),
+              IsOk());
+  EXPECT_THAT(keys.Size(), IsOkAndHolds(2));
+  EXPECT_THAT(keys.Contains(StringValue("bar"), descriptor_pool(),
+                            message_factory(), arena()),
+              IsOkAndHolds(BoolValueIs(true)));
+}
+
+TEST_F(CustomMapValueTest, IncompleteInterface_Unimplemented) {
+  CustomMapValue map = MakeIncompleteInterface();
+  ListValue keys;
+  EXPECT_THAT(map.ListKeys(descriptor_pool(), message_factory(), arena(), &keys),
+              StatusIs(absl::StatusCode::kUnimplemented));
+  EXPECT_THAT(map.ForEach(
+                  [](const Value&, const Value&) -> absl::StatusOr<bool> {
+                    return true;
+                  },
+                  descriptor_pool(), message_factory(), arena()),
+              StatusIs(absl::StatusCode::kUnimplemented));
+}
+
 TEST_F(CustomMapValueTest, Dispatcher) {
   EXPECT_THAT(MakeDispatcher().dispatcher(), NotNull());
   EXPECT_THAT(MakeDispatcher().interface(), IsNull());
@@ -382,6 +382,7 @@ absl::Status ParsedMessageValue::GetField(
     google::protobuf::MessageFactory* absl_nonnull message_factory,
     google::protobuf::Arena* absl_nonnull arena, Value* absl_nonnull result) const {
   ABSL_DCHECK(field != nullptr);
+  ABSL_DCHECK_EQ(field->containing_type(), GetDescriptor());
   ABSL_DCHECK(descriptor_pool != nullptr);
   ABSL_DCHECK(message_factory != nullptr);
   ABSL_DCHECK(arena != nullptr);
@@ -395,6 +396,7 @@ absl::Status ParsedMessageValue::GetField(
 bool ParsedMessageValue::HasField(
     const google::protobuf::FieldDescriptor* absl_nonnull field) const {
   ABSL_DCHECK(field != nullptr);
+  ABSL_DCHECK_EQ(field->containing_type(), GetDescriptor());
 
   const auto* reflection = GetReflection();
   if (field->is_map() || field->is_repeated()) {
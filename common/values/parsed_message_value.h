@@ -153,6 +153,19 @@ class ParsedMessageValue final
 
   absl::StatusOr<bool> HasFieldByNumber(int64_t number) const;
 
+  // Like `GetFieldByName()` and `HasFieldByName()`, for a field which was
+  // already looked up. `field` must belong to `GetDescriptor()`. This lets
+  // callers which resolve a field once, such as the planner, skip the lookup by
+  // name on every access.
+  absl::Status GetField(
+      const google::protobuf::FieldDescriptor* absl_nonnull field,
+      ProtoWrapperTypeOptions unboxing_options,
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena, Value* absl_nonnull result) const;
+
+  bool HasField(const google::protobuf::FieldDescriptor* absl_nonnull field) const;
+
   using ForEachFieldCallback = CustomStructValueInterface::ForEachFieldCallback;
 
   absl::Status ForEachField(
@@ -191,15 +204,6 @@ class ParsedMessageValue final
     return absl::OkStatus();
   }
 
-  absl::Status GetField(
-      const google::protobuf::FieldDescriptor* absl_nonnull field,
-      ProtoWrapperTypeOptions unboxing_options,
-      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
-      google::protobuf::MessageFactory* absl_nonnull message_factory,
-      google::protobuf::Arena* absl_nonnull arena, Value* absl_nonnull result) const;
-
-  bool HasField(const google::protobuf::FieldDescriptor* absl_nonnull field) const;
-
   const google::protobuf::Message* absl_nonnull value_;
   google::protobuf::Arena* absl_nullable arena_;
 };
@@ -0,0 +1,404 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/values/persistent_list_value.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string>
+
+#include "absl/base/nullability.h"
+#include "absl/base/optimization.h"
+#include "absl/log/absl_check.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "common/arena.h"
+#include "common/native_type.h"
+#include "common/value.h"
+#include "internal/casts.h"
+#include "internal/status_macros.h"
+#include "internal/well_known_types.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
+
+namespace cel::common_internal {
+
+namespace {
+
+using ::cel::well_known_types::ListValueReflection;
+
+constexpr size_t kBits = 5;
+constexpr size_t kWidth = size_t{1} << kBits;
+constexpr size_t kMask = kWidth - 1;
+
+// A chunk of `kWidth` elements.
+//
+// The trailing chunk may be shared by lists of different sizes, each of which
+// only observes the prefix up to its own size. `used` is the length of the
+// longest such prefix: a list whose trailing chunk is exactly `used` long can
+// claim the next slot and append in place, any other list has to copy.
+struct Leaf final {
+  explicit Leaf(google::protobuf::Arena* absl_nonnull arena) : arena(arena) {}
+
+  google::protobuf::Arena* absl_nonnull const arena;
+  std::atomic<size_t> used{0};
+  std::atomic<bool> owns_destructor{false};
+  Value values[kWidth];
+};
+
+struct Branch final {
+  // Either all `Branch` or all `Leaf`, depending on the level.
+  const void* absl_nullable children[kWidth] = {};
+};
+
+Leaf* absl_nonnull NewLeaf(google::protobuf::Arena* absl_nonnull arena) {
+  return ::new (arena->AllocateAligned(sizeof(Leaf), alignof(Leaf)))
+      Leaf(arena);
+}
+
+Branch* absl_nonnull NewBranch(google::protobuf::Arena* absl_nonnull arena) {
+  return ::new (arena->AllocateAligned(sizeof(Branch), alignof(Branch)))
+      Branch();
+}
+
+void StoreElement(Leaf* absl_nonnull leaf, size_t index, const Value& element) {
+  leaf->values[index] = element;
+  if (!ArenaTraits<>::trivially_destructible(element) &&
+      !leaf->owns_destructor.exchange(true, std::memory_order_relaxed)) {
+    leaf->arena->OwnDestructor(leaf);
+  }
+}
+
+// Claims slot `index` of `leaf`, which succeeds only if no other list sharing
+// `leaf` has claimed it yet. Elements are only stored in place on the arena
+// which owns `leaf`, as that is where their destructors are registered.
+bool ClaimSlot(Leaf* absl_nonnull leaf, size_t index,
+               google::protobuf::Arena* absl_nonnull arena) {
+  size_t expected = index;
+  return leaf->arena == arena &&
+         leaf->used.compare_exchange_strong(expected, index + 1,
+                                            std::memory_order_relaxed);
+}
+
+// Builds a chain of branches down to `leaf` at `level`.
+const void* absl_nonnull NewPath(size_t level, const Leaf* absl_nonnull leaf,
+                                 google::protobuf::Arena* absl_nonnull arena) {
+  if (level == 0) {
+    return leaf;
+  }
+  Branch* branch = NewBranch(arena);
+  branch->children[0] = NewPath(level - kBits, leaf, arena);
+  return branch;
+}
+
+// Returns a copy of `parent` with `leaf` added as the chunk ending at `size`,
+// copying only the branches along its path.
+const Branch* absl_nonnull PushLeaf(size_t size, size_t level,
+                                    const Branch* absl_nullable parent,
+                                    const Leaf* absl_nonnull leaf,
+                                    google::protobuf::Arena* absl_nonnull arena) {
+  const size_t index = ((size - 1) >> level) & kMask;
+  Branch* branch = NewBranch(arena);
+  if (parent != nullptr) {
+    *branch = *parent;
+  }
+  if (level == kBits) {
+    branch->children[index] = leaf;
+  } else if (const auto* child =
+                 static_cast<const Branch*>(branch->children[index]);
+             child != nullptr) {
+    branch->children[index] =
+        PushLeaf(size, level - kBits, child, leaf, arena);
+  } else {
+    branch->children[index] = NewPath(level - kBits, leaf, arena);
+  }
+  return branch;
+}
+
+// The contents of a persistent list. Full chunks live in a trie of branches
+// rooted at `root`, the remaining elements in `tail`. Copying is cheap and
+// never copies elements.
+struct Trie final {
+  size_t tail_offset() const {
+    return size < kWidth ? 0 : ((size - 1) >> kBits) << kBits;
+  }
+
+  const Leaf* absl_nonnull LeafFor(size_t index) const {
+    ABSL_DCHECK_LT(index, size);
+    if (index >= tail_offset()) {
+      return tail;
+    }
+    const void* node = root;
+    for (size_t level = shift; level > 0; level -= kBits) {
+      node = static_cast<const Branch*>(node)->children[(index >> level) &
+                                                        kMask];
+    }
+    return static_cast<const Leaf*>(node);
+  }
+
+  void Append(const Value& element, google::protobuf::Arena* absl_nonnull arena) {
+    const size_t tail_size = size - tail_offset();
+    if (tail_size == kWidth) {
+      // The trailing chunk is full, move it into the trie.
+      if ((size >> kBits) > (size_t{1} << shift)) {
+        Branch* new_root = NewBranch(arena);
+        new_root->children[0] = root;
+        new_root->children[1] = NewPath(shift, tail, arena);
+        root = new_root;
+        shift += kBits;
+      } else {
+        root = PushLeaf(size, shift, root, tail, arena);
+      }
+      tail = nullptr;
+    } else if (tail != nullptr && ClaimSlot(tail, tail_size, arena)) {
+      StoreElement(tail, tail_size, element);
+      ++size;
+      return;
+    }
+    Leaf* new_tail = NewLeaf(arena);
+    const size_t new_tail_size = tail != nullptr ? tail_size : 0;
+    for (size_t index = 0; index < new_tail_size; ++index) {
+      StoreElement(new_tail, index, tail->values[index]);
+    }
+    StoreElement(new_tail, new_tail_size, element);
+    new_tail->used.store(new_tail_size + 1, std::memory_order_relaxed);
+    tail = new_tail;
+    ++size;
+  }
+
+  const Branch* absl_nullable root = nullptr;
+  size_t shift = kBits;
+  size_t size = 0;
+  Leaf* absl_nullable tail = nullptr;
+};
+
+absl::Status CheckListElement(const Value& value) {
+  if (auto error_value = value.AsError(); ABSL_PREDICT_FALSE(error_value)) {
+    return error_value->ToStatus();
+  }
+  if (auto unknown_value = value.AsUnknown();
+      ABSL_PREDICT_FALSE(unknown_value)) {
+    return absl::InvalidArgumentError("cannot add unknown value to list");
+  }
+  return absl::OkStatus();
+}
+
+class PersistentListValueIterator final : public ValueIterator {
+ public:
+  explicit PersistentListValueIterator(const Trie& trie) : trie_(trie) {}
+
+  bool HasNext() override { return index_ < trie_.size; }
+
+  absl::Status Next(const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+                    google::protobuf::MessageFactory* absl_nonnull message_factory,
+                    google::protobuf::Arena* absl_nonnull arena,
+                    Value* absl_nonnull result) override {
+    if (ABSL_PREDICT_FALSE(index_ >= trie_.size)) {
+      return absl::FailedPreconditionError(
+          "ValueIterator::Next() called when "
+          "ValueIterator::HasNext() returns false");
+    }
+    *result = NextElement();
+    return absl::OkStatus();
+  }
+
+  absl::StatusOr<bool> Next1(
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena,
+      Value* absl_nonnull key_or_value) override {
+    if (index_ >= trie_.size) {
+      return false;
+    }
+    *key_or_value = NextElement();
+    return true;
+  }
+
+  absl::StatusOr<bool> Next2(
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena, Value* absl_nullable key,
+      Value* absl_nullable value) override {
+    if (index_ >= trie_.size) {
+      return false;
+    }
+    if (key != nullptr) {
+      *key = IntValue(static_cast<int64_t>(index_));
+    }
+    if (value != nullptr) {
+      *value = NextElement();
+    } else {
+      ++index_;
+    }
+    return true;
+  }
+
+ private:
+  const Value& NextElement() {
+    if ((index_ & kMask) == 0) {
+      leaf_ = trie_.LeafFor(index_);
+    }
+    return leaf_->values[index_++ & kMask];
+  }
+
+  const Trie trie_;
+  size_t index_ = 0;
+  const Leaf* absl_nullable leaf_ = nullptr;
+};
+
+CustomListValue MakePersistentListValue(const Trie& trie,
+                                        google::protobuf::Arena* absl_nonnull arena);
+
+class PersistentListValue final : public CustomListValueInterface {
+ public:
+  explicit PersistentListValue(const Trie& trie) : trie_(trie) {}
+
+  const Trie& trie() const { return trie_; }
+
+ private:
+  std::string DebugString() const override {
+    std::string out = "[";
+    for (size_t index = 0; index < trie_.size; ++index) {
+      if (index != 0) {
+        out.append(", ");
+      }
+      out.append(Element(index).DebugString());
+    }
+    out.append("]");
+    return out;
+  }
+
+  absl::Status ConvertToJsonArray(
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Message* absl_nonnull json) const override {
+    ABSL_DCHECK(descriptor_pool != nullptr);
+    ABSL_DCHECK(message_factory != nullptr);
+    ABSL_DCHECK(json != nullptr);
+    ABSL_DCHECK_EQ(json->GetDescriptor()->well_known_type(),
+                   google::protobuf::Descriptor::WELLKNOWNTYPE_LISTVALUE);
+
+    ListValueReflection reflection;
+    CEL_RETURN_IF_ERROR(reflection.Initialize(json->GetDescriptor()));
+
+    json->Clear();
+    for (size_t index = 0; index < trie_.size; ++index) {
+      CEL_RETURN_IF_ERROR(Element(index).ConvertToJson(
+          descriptor_pool, message_factory, reflection.AddValues(json)));
+    }
+    return absl::OkStatus();
+  }
+
+  size_t Size() const override { return trie_.size; }
+
+  absl::Status Get(size_t index,
+                   const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+                   google::protobuf::MessageFactory* absl_nonnull message_factory,
+                   google::protobuf::Arena* absl_nonnull arena,
+                   Value* absl_nonnull result) const override {
+    if (ABSL_PREDICT_FALSE(index >= trie_.size)) {
+      *result = IndexOutOfBoundsError(index);
+      return absl::OkStatus();
+    }
+    *result = Element(index);
+    return absl::OkStatus();
+  }
+
+  absl::StatusOr<absl_nonnull ValueIteratorPtr> NewIterator() const override {
+    return std::make_unique<PersistentListValueIterator>(trie_);
+  }
+
+  CustomListValue Clone(google::protobuf::Arena* absl_nonnull arena) const override {
+    Trie trie;
+    for (size_t index = 0; index < trie_.size; ++index) {
+      trie.Append(Element(index).Clone(arena), arena);
+    }
+    return MakePersistentListValue(trie, arena);
+  }
+
+  NativeTypeId GetNativeTypeId() const override {
+    return NativeTypeId::For<PersistentListValue>();
+  }
+
+  const Value& Element(size_t index) const {
+    return trie_.LeafFor(index)->values[index & kMask];
+  }
+
+  const Trie trie_;
+};
+
+CustomListValue MakePersistentListValue(const Trie& trie,
+                                        google::protobuf::Arena* absl_nonnull arena) {
+  // PersistentListValue only holds pointers into the arena, so the arena does
+  // not need to run its destructor. Leaves register their own destructor when
+  // they hold elements that need one.
+  return CustomListValue(
+      ::new (arena->AllocateAligned(sizeof(PersistentListValue),
+                                    alignof(PersistentListValue)))
+          PersistentListValue(trie),
+      arena);
+}
+
+const PersistentListValue* absl_nullable AsPersistentListValue(
+    const ListValue& value) {
+  auto custom_list_value = value.AsCustom();
+  if (!custom_list_value ||
+      custom_list_value->GetTypeId() != NativeTypeId::For<PersistentListValue>()) {
+    return nullptr;
+  }
+  return cel::internal::down_cast<const PersistentListValue*>(
+      custom_list_value->interface());
+}
+
+}  // namespace
+
+absl::StatusOr<ListValue> PersistentListConcat(
+    const ListValue& lhs, const ListValue& rhs,
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena) {
+  ABSL_DCHECK(descriptor_pool != nullptr);
+  ABSL_DCHECK(message_factory != nullptr);
+  ABSL_DCHECK(arena != nullptr);
+
+  Trie trie;
+  auto append = [&](const Value& element) -> absl::StatusOr<bool> {
+    CEL_RETURN_IF_ERROR(CheckListElement(element));
+    trie.Append(element, arena);
+    return true;
+  };
+  if (const auto* persistent = AsPersistentListValue(lhs);
+      persistent != nullptr) {
+    trie = persistent->trie();
+  } else {
+    CEL_RETURN_IF_ERROR(
+        lhs.ForEach(append, descriptor_pool, message_factory, arena));
+  }
+  CEL_RETURN_IF_ERROR(
+      rhs.ForEach(append, descriptor_pool, message_factory, arena));
+  if (trie.size == 0) {
+    return ListValue();
+  }
+  return MakePersistentListValue(trie, arena);
+}
+
+bool IsPersistentListValue(const ListValue& value) {
+  return AsPersistentListValue(value) != nullptr;
+}
+
+}  // namespace cel::common_internal
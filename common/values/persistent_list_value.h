@@ -0,0 +1,47 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_COMMON_VALUES_PERSISTENT_LIST_VALUE_H_
+#define THIRD_PARTY_CEL_CPP_COMMON_VALUES_PERSISTENT_LIST_VALUE_H_
+
+#include "absl/base/nullability.h"
+#include "absl/status/statusor.h"
+#include "common/value.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
+
+namespace cel::common_internal {
+
+// Returns the concatenation of `lhs` and `rhs` as an immutable list which
+// shares structure with `lhs`.
+//
+// The list is a 32-way trie over its elements with a trailing chunk, so `Get()`
+// is O(log32 n). If `lhs` was itself returned by this function, the result is
+// built by appending the elements of `rhs` to it in O(log32 n) each, leaving
+// `lhs` unchanged. Otherwise the elements of `lhs` are copied once. This makes
+// repeated `accu + [x]` linear overall instead of quadratic when the
+// accumulator cannot be mutated in place.
+absl::StatusOr<ListValue> PersistentListConcat(
+    const ListValue& lhs, const ListValue& rhs,
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena);
+
+// Returns `true` if `value` was created by `PersistentListConcat()`.
+bool IsPersistentListValue(const ListValue& value);
+
+}  // namespace cel::common_internal
+
+#endif  // THIRD_PARTY_CEL_CPP_COMMON_VALUES_PERSISTENT_LIST_VALUE_H_
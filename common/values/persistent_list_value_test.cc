@@ -0,0 +1,183 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/values/persistent_list_value.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "absl/base/nullability.h"
+#include "absl/log/absl_check.h"
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
+#include "common/value.h"
+#include "common/value_testing.h"
+#include "common/values/list_value_builder.h"
+#include "internal/testing.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
+
+namespace cel::common_internal {
+namespace {
+
+using ::absl_testing::IsOkAndHolds;
+using ::absl_testing::StatusIs;
+using ::cel::test::BoolValueIs;
+using ::cel::test::ErrorValueIs;
+using ::cel::test::IntValueIs;
+using ::testing::ElementsAreArray;
+
+using PersistentListValueTest = common_internal::ValueTest<>;
+
+ListValue MakeList(std::vector<int64_t> elements,
+                   google::protobuf::Arena* absl_nonnull arena) {
+  auto builder = NewListValueBuilder(arena);
+  for (int64_t element : elements) {
+    ABSL_CHECK_OK(builder->Add(IntValue(element)));
+  }
+  return std::move(*builder).Build();
+}
+
+std::vector<int64_t> ListElements(const ListValue& list,
+                                  const google::protobuf::DescriptorPool* descriptor_pool,
+                                  google::protobuf::MessageFactory* message_factory,
+                                  google::protobuf::Arena* arena) {
+  std::vector<int64_t> elements;
+  ABSL_CHECK_OK(list.ForEach(
+      [&](const Value& element) -> absl::StatusOr<bool> {
+        elements.push_back(element.GetInt().NativeValue());
+        return true;
+      },
+      descriptor_pool, message_factory, arena));
+  return elements;
+}
+
+TEST_F(PersistentListValueTest, Concat) {
+  ASSERT_OK_AND_ASSIGN(
+      ListValue list,
+      PersistentListConcat(MakeList({0, 1}, arena()), MakeList({2}, arena()),
+                           descriptor_pool(), message_factory(), arena()));
+  EXPECT_TRUE(IsPersistentListValue(list));
+  EXPECT_THAT(list.Size(), IsOkAndHolds(3));
+  EXPECT_EQ(list.DebugString(), "[0, 1, 2]");
+  EXPECT_THAT(list.Get(2, descriptor_pool(), message_factory(), arena()),
+              IsOkAndHolds(IntValueIs(2)));
+  EXPECT_THAT(
+      list.Get(3, descriptor_pool(), message_factory(), arena()),
+      IsOkAndHolds(ErrorValueIs(StatusIs(absl::StatusCode::kInvalidArgument))));
+  EXPECT_THAT(list.Equal(MakeList({0, 1, 2}, arena()), descriptor_pool(),
+                         message_factory(), arena()),
+              IsOkAndHolds(BoolValueIs(true)));
+}
+
+TEST_F(PersistentListValueTest, RepeatedAppend) {
+  constexpr int64_t kSize = 2000;
+  ListValue list;
+  std::vector<int64_t> expected;
+  for (int64_t i = 0; i < kSize; ++i) {
+    ASSERT_OK_AND_ASSIGN(list, PersistentListConcat(
+                                   list, MakeList({i}, arena()),
+                                   descriptor_pool(), message_factory(),
+                                   arena()));
+    expected.push_back(i);
+  }
+  EXPECT_THAT(list.Size(), IsOkAndHolds(kSize));
+  for (int64_t i = 0; i < kSize; ++i) {
+    ASSERT_THAT(list.Get(i, descriptor_pool(), message_factory(), arena()),
+                IsOkAndHolds(IntValueIs(i)));
+  }
+  EXPECT_THAT(ListElements(list, descriptor_pool(), message_factory(), arena()),
+              ElementsAreArray(expected));
+}
+
+TEST_F(PersistentListValueTest, EarlierVersionsAreUnchanged) {
+  ASSERT_OK_AND_ASSIGN(
+      ListValue base,
+      PersistentListConcat(MakeList({0}, arena()), MakeList({1}, arena()),
+                           descriptor_pool(), message_factory(), arena()));
+  ASSERT_OK_AND_ASSIGN(
+      ListValue first,
+      PersistentListConcat(base, MakeList({2}, arena()), descriptor_pool(),
+                           message_factory(), arena()));
+  ASSERT_OK_AND_ASSIGN(
+      ListValue second,
+      PersistentListConcat(base, MakeList({3, 4}, arena()), descriptor_pool(),
+                           message_factory(), arena()));
+  EXPECT_EQ(base.DebugString(), "[0, 1]");
+  EXPECT_EQ(first.DebugString(), "[0, 1, 2]");
+  EXPECT_EQ(second.DebugString(), "[0, 1, 3, 4]");
+}
+
+TEST_F(PersistentListValueTest, RejectsErrors) {
+  auto builder = NewListValueBuilder(arena());
+  builder->UnsafeAdd(ErrorValue(absl::InternalError("test")));
+  EXPECT_THAT(PersistentListConcat(MakeList({0}, arena()),
+                                   std::move(*builder).Build(),
+                                   descriptor_pool(), message_factory(),
+                                   arena()),
+              StatusIs(absl::StatusCode::kInternal));
+}
+
+TEST_F(PersistentListValueTest, NewIterator) {
+  ASSERT_OK_AND_ASSIGN(
+      ListValue list,
+      PersistentListConcat(MakeList({0, 1}, arena()), MakeList({2}, arena()),
+                           descriptor_pool(), message_factory(), arena()));
+  ASSERT_OK_AND_ASSIGN(auto iterator, list.NewIterator());
+  std::vector<std::pair<int64_t, int64_t>> entries;
+  Value key;
+  Value value;
+  while (true) {
+    ASSERT_OK_AND_ASSIGN(bool ok, iterator->Next2(descriptor_pool(),
+                                                  message_factory(), arena(),
+                                                  &key, &value));
+    if (!ok) {
+      break;
+    }
+    entries.push_back(
+        {key.GetInt().NativeValue(), value.GetInt().NativeValue()});
+  }
+  EXPECT_THAT(entries,
+              ElementsAreArray(std::vector<std::pair<int64_t, int64_t>>{
+                  {0, 0}, {1, 1}, {2, 2}}));
+}
+
+TEST_F(PersistentListValueTest, Clone) {
+  ASSERT_OK_AND_ASSIGN(
+      ListValue list,
+      PersistentListConcat(MakeList({0, 1}, arena()),
+                           MakeList({2}, arena()), descriptor_pool(),
+                           message_factory(), arena()));
+  google::protobuf::Arena other_arena;
+  Value clone = Value(list).Clone(&other_arena);
+  ASSERT_TRUE(clone.IsList());
+  EXPECT_TRUE(IsPersistentListValue(clone.GetList()));
+  EXPECT_EQ(clone.DebugString(), "[0, 1, 2]");
+}
+
+TEST_F(PersistentListValueTest, IsPersistentListValue) {
+  EXPECT_FALSE(IsPersistentListValue(MakeList({0}, arena())));
+  ASSERT_OK_AND_ASSIGN(
+      ListValue empty,
+      PersistentListConcat(MakeList({}, arena()), MakeList({}, arena()),
+                           descriptor_pool(), message_factory(), arena()));
+  EXPECT_FALSE(IsPersistentListValue(empty));
+  EXPECT_THAT(empty.IsEmpty(), IsOkAndHolds(true));
+}
+
+}  // namespace
+}  // namespace cel::common_internal
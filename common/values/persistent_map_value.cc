@@ -0,0 +1,647 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/values/persistent_map_value.h"
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string>
+
+#include "absl/base/nullability.h"
+#include "absl/base/optimization.h"
+#include "absl/container/inlined_vector.h"
+#include "absl/hash/hash.h"
+#include "absl/log/absl_check.h"
+#include "absl/numeric/bits.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "common/arena.h"
+#include "common/native_type.h"
+#include "common/type.h"
+#include "common/value.h"
+#include "common/value_kind.h"
+#include "internal/casts.h"
+#include "internal/status_macros.h"
+#include "internal/well_known_types.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
+
+namespace cel::common_internal {
+
+namespace {
+
+using ::cel::well_known_types::StructReflection;
+
+constexpr size_t kBits = 5;
+constexpr size_t kMask = (size_t{1} << kBits) - 1;
+constexpr size_t kHashBits = sizeof(size_t) * CHAR_BIT;
+
+struct Entry final {
+  Value key;
+  Value value;
+};
+
+// A node of a compressed hash array mapped trie. `datamap` and `nodemap` are
+// indexed by `kBits` bits of the key hash at the node's level, and record
+// which of those are held as an entry and which as a child node. Once the
+// hash is exhausted, a collision node holds entries with equal hashes in
+// `entries` and both maps are empty.
+//
+// Nodes are never modified after construction, so they can be shared by any
+// number of maps.
+struct Node final {
+  ~Node() {
+    for (uint32_t index = 0; index < entry_count; ++index) {
+      entries[index].~Entry();
+    }
+  }
+
+  uint32_t datamap = 0;
+  uint32_t nodemap = 0;
+  uint32_t entry_count = 0;
+  uint32_t child_count = 0;
+  Entry* absl_nullable entries = nullptr;
+  const Node** absl_nullable children = nullptr;
+};
+
+size_t KeyHash(const Value& key) {
+  switch (key.kind()) {
+    case ValueKind::kBool:
+      return absl::HashOf(ValueKind::kBool, key.GetBool().NativeValue());
+    case ValueKind::kInt:
+      return absl::HashOf(ValueKind::kInt, key.GetInt().NativeValue());
+    case ValueKind::kUint:
+      return absl::HashOf(ValueKind::kUint, key.GetUint().NativeValue());
+    case ValueKind::kString:
+      return absl::HashOf(ValueKind::kString, key.GetString());
+    default:
+      ABSL_UNREACHABLE();
+  }
+}
+
+bool KeyEquals(const Value& lhs, const Value& rhs) {
+  if (lhs.kind() != rhs.kind()) {
+    return false;
+  }
+  switch (lhs.kind()) {
+    case ValueKind::kBool:
+      return lhs.GetBool() == rhs.GetBool();
+    case ValueKind::kInt:
+      return lhs.GetInt() == rhs.GetInt();
+    case ValueKind::kUint:
+      return lhs.GetUint() == rhs.GetUint();
+    case ValueKind::kString:
+      return lhs.GetString().Equals(rhs.GetString());
+    default:
+      ABSL_UNREACHABLE();
+  }
+}
+
+uint32_t HashBit(size_t hash, size_t shift) {
+  return uint32_t{1} << ((hash >> shift) & kMask);
+}
+
+uint32_t BitIndex(uint32_t bitmap, uint32_t bit) {
+  return static_cast<uint32_t>(absl::popcount(bitmap & (bit - 1)));
+}
+
+Node* absl_nonnull NewNode(uint32_t datamap, uint32_t nodemap,
+                           uint32_t entry_count, uint32_t child_count,
+                           google::protobuf::Arena* absl_nonnull arena) {
+  Node* node =
+      ::new (arena->AllocateAligned(sizeof(Node), alignof(Node))) Node();
+  node->datamap = datamap;
+  node->nodemap = nodemap;
+  node->entry_count = entry_count;
+  node->child_count = child_count;
+  if (entry_count != 0) {
+    node->entries = static_cast<Entry*>(
+        arena->AllocateAligned(sizeof(Entry) * entry_count, alignof(Entry)));
+  }
+  if (child_count != 0) {
+    node->children = static_cast<const Node**>(arena->AllocateAligned(
+        sizeof(const Node*) * child_count, alignof(const Node*)));
+  }
+  return node;
+}
+
+// Registers the destructor of `node` with `arena` if any of its entries need
+// it. Must be called once all entries have been constructed.
+const Node* absl_nonnull FinishNode(Node* absl_nonnull node,
+                                    google::protobuf::Arena* absl_nonnull arena) {
+  for (uint32_t index = 0; index < node->entry_count; ++index) {
+    const Entry& entry = node->entries[index];
+    if (!ArenaTraits<>::trivially_destructible(entry.key) ||
+        !ArenaTraits<>::trivially_destructible(entry.value)) {
+      arena->OwnDestructor(node);
+      break;
+    }
+  }
+  return node;
+}
+
+const Entry* absl_nullable FindEntry(const Node* absl_nullable node,
+                                     const Value& key, size_t hash) {
+  for (size_t shift = 0; node != nullptr; shift += kBits) {
+    if (shift >= kHashBits) {
+      for (uint32_t index = 0; index < node->entry_count; ++index) {
+        if (KeyEquals(node->entries[index].key, key)) {
+          return &node->entries[index];
+        }
+      }
+      return nullptr;
+    }
+    const uint32_t bit = HashBit(hash, shift);
+    if ((node->datamap & bit) != 0) {
+      const Entry& entry = node->entries[BitIndex(node->datamap, bit)];
+      return KeyEquals(entry.key, key) ? &entry : nullptr;
+    }
+    if ((node->nodemap & bit) == 0) {
+      return nullptr;
+    }
+    node = node->children[BitIndex(node->nodemap, bit)];
+  }
+  return nullptr;
+}
+
+// Returns a node at `shift` holding the two entries with distinct keys.
+const Node* absl_nonnull MergeEntries(const Entry& first, size_t first_hash,
+                                      const Entry& second, size_t second_hash,
+                                      size_t shift,
+                                      google::protobuf::Arena* absl_nonnull arena) {
+  if (shift >= kHashBits) {
+    Node* node = NewNode(0, 0, 2, 0, arena);
+    ::new (&node->entries[0]) Entry(first);
+    ::new (&node->entries[1]) Entry(second);
+    return FinishNode(node, arena);
+  }
+  const uint32_t first_bit = HashBit(first_hash, shift);
+  const uint32_t second_bit = HashBit(second_hash, shift);
+  if (first_bit == second_bit) {
+    Node* node = NewNode(0, first_bit, 0, 1, arena);
+    node->children[0] = MergeEntries(first, first_hash, second, second_hash,
+                                     shift + kBits, arena);
+    return node;
+  }
+  Node* node = NewNode(first_bit | second_bit, 0, 2, 0, arena);
+  const bool first_is_lower = first_bit < second_bit;
+  ::new (&node->entries[first_is_lower ? 0 : 1]) Entry(first);
+  ::new (&node->entries[first_is_lower ? 1 : 0]) Entry(second);
+  return FinishNode(node, arena);
+}
+
+// Returns a copy of `node` at `shift` with `entry` added, copying only the
+// nodes along its path. Returns `nullptr` if the key is already present.
+const Node* absl_nullable InsertEntry(const Node* absl_nonnull node,
+                                      const Entry& entry, size_t hash,
+                                      size_t shift,
+                                      google::protobuf::Arena* absl_nonnull arena) {
+  if (shift >= kHashBits) {
+    for (uint32_t index = 0; index < node->entry_count; ++index) {
+      if (KeyEquals(node->entries[index].key, entry.key)) {
+        return nullptr;
+      }
+    }
+    Node* copy = NewNode(0, 0, node->entry_count + 1, 0, arena);
+    for (uint32_t index = 0; index < node->entry_count; ++index) {
+      ::new (&copy->entries[index]) Entry(node->entries[index]);
+    }
+    ::new (&copy->entries[node->entry_count]) Entry(entry);
+    return FinishNode(copy, arena);
+  }
+
+  const uint32_t bit = HashBit(hash, shift);
+  if ((node->datamap & bit) != 0) {
+    // The slot holds an entry, which is replaced by a child holding both.
+    const uint32_t entry_index = BitIndex(node->datamap, bit);
+    const Entry& existing = node->entries[entry_index];
+    if (KeyEquals(existing.key, entry.key)) {
+      return nullptr;
+    }
+    const Node* child = MergeEntries(existing, KeyHash(existing.key), entry,
+                                     hash, shift + kBits, arena);
+    Node* copy = NewNode(node->datamap & ~bit, node->nodemap | bit,
+                         node->entry_count - 1, node->child_count + 1, arena);
+    for (uint32_t index = 0, copy_index = 0; index < node->entry_count;
+         ++index) {
+      if (index != entry_index) {
+        ::new (&copy->entries[copy_index++]) Entry(node->entries[index]);
+      }
+    }
+    const uint32_t child_index = BitIndex(copy->nodemap, bit);
+    for (uint32_t index = 0, copy_index = 0; copy_index < copy->child_count;
+         ++copy_index) {
+      copy->children[copy_index] =
+          copy_index == child_index ? child : node->children[index++];
+    }
+    return FinishNode(copy, arena);
+  }
+
+  if ((node->nodemap & bit) != 0) {
+    const uint32_t child_index = BitIndex(node->nodemap, bit);
+    const Node* child = InsertEntry(node->children[child_index], entry, hash,
+                                    shift + kBits, arena);
+    if (child == nullptr) {
+      return nullptr;
+    }
+    Node* copy = NewNode(node->datamap, node->nodemap, node->entry_count,
+                         node->child_count, arena);
+    for (uint32_t index = 0; index < node->entry_count; ++index) {
+      ::new (&copy->entries[index]) Entry(node->entries[index]);
+    }
+    for (uint32_t index = 0; index < node->child_count; ++index) {
+      copy->children[index] =
+          index == child_index ? child : node->children[index];
+    }
+    return FinishNode(copy, arena);
+  }
+
+  const uint32_t entry_index = BitIndex(node->datamap, bit);
+  Node* copy = NewNode(node->datamap | bit, node->nodemap,
+                       node->entry_count + 1, node->child_count, arena);
+  for (uint32_t index = 0, copy_index = 0; copy_index < copy->entry_count;
+       ++copy_index) {
+    if (copy_index == entry_index) {
+      ::new (&copy->entries[copy_index]) Entry(entry);
+    } else {
+      ::new (&copy->entries[copy_index]) Entry(node->entries[index++]);
+    }
+  }
+  for (uint32_t index = 0; index < node->child_count; ++index) {
+    copy->children[index] = node->children[index];
+  }
+  return FinishNode(copy, arena);
+}
+
+absl::Status CheckMapValue(const Value& value) {
+  if (auto error_value = value.AsError(); ABSL_PREDICT_FALSE(error_value)) {
+    return error_value->ToStatus();
+  }
+  if (auto unknown_value = value.AsUnknown();
+      ABSL_PREDICT_FALSE(unknown_value)) {
+    return absl::InvalidArgumentError("cannot add unknown value to map");
+  }
+  return absl::OkStatus();
+}
+
+// The contents of a persistent map. Copying is cheap and never copies entries.
+struct Trie final {
+  absl::Status Insert(const Value& key, const Value& value,
+                      google::protobuf::Arena* absl_nonnull arena) {
+    CEL_RETURN_IF_ERROR(CheckMapKey(key));
+    CEL_RETURN_IF_ERROR(CheckMapValue(value));
+    const size_t hash = KeyHash(key);
+    if (root == nullptr) {
+      Node* node = NewNode(HashBit(hash, 0), 0, 1, 0, arena);
+      ::new (&node->entries[0]) Entry{key, value};
+      root = FinishNode(node, arena);
+    } else {
+      const Node* new_root =
+          InsertEntry(root, Entry{key, value}, hash, /*shift=*/0, arena);
+      if (new_root == nullptr) {
+        return DuplicateKeyError().ToStatus();
+      }
+      root = new_root;
+    }
+    ++size;
+    return absl::OkStatus();
+  }
+
+  const Node* absl_nullable root = nullptr;
+  size_t size = 0;
+};
+
+template <typename Callback>
+absl::StatusOr<bool> ForEachEntry(const Node* absl_nonnull node,
+                                  Callback& callback) {
+  for (uint32_t index = 0; index < node->entry_count; ++index) {
+    CEL_ASSIGN_OR_RETURN(auto ok, callback(node->entries[index]));
+    if (!ok) {
+      return false;
+    }
+  }
+  for (uint32_t index = 0; index < node->child_count; ++index) {
+    CEL_ASSIGN_OR_RETURN(auto ok, ForEachEntry(node->children[index], callback));
+    if (!ok) {
+      return false;
+    }
+  }
+  return true;
+}
+
+class PersistentMapValueIterator final : public ValueIterator {
+ public:
+  explicit PersistentMapValueIterator(const Node* absl_nullable root) {
+    if (root != nullptr) {
+      stack_.push_back(Frame{root});
+    }
+    Advance();
+  }
+
+  bool HasNext() override { return entry_ != nullptr; }
+
+  absl::Status Next(const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+                    google::protobuf::MessageFactory* absl_nonnull message_factory,
+                    google::protobuf::Arena* absl_nonnull arena,
+                    Value* absl_nonnull result) override {
+    if (ABSL_PREDICT_FALSE(entry_ == nullptr)) {
+      return absl::FailedPreconditionError(
+          "ValueIterator::Next() called when "
+          "ValueIterator::HasNext() returns false");
+    }
+    *result = entry_->key;
+    Advance();
+    return absl::OkStatus();
+  }
+
+  absl::StatusOr<bool> Next1(
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena,
+      Value* absl_nonnull key_or_value) override {
+    if (entry_ == nullptr) {
+      return false;
+    }
+    *key_or_value = entry_->key;
+    Advance();
+    return true;
+  }
+
+  absl::StatusOr<bool> Next2(
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena, Value* absl_nullable key,
+      Value* absl_nullable value) override {
+    if (entry_ == nullptr) {
+      return false;
+    }
+    if (key != nullptr) {
+      *key = entry_->key;
+    }
+    if (value != nullptr) {
+      *value = entry_->value;
+    }
+    Advance();
+    return true;
+  }
+
+ private:
+  struct Frame {
+    const Node* absl_nonnull node;
+    uint32_t entry_index = 0;
+    uint32_t child_index = 0;
+  };
+
+  // Moves `entry_` to the next entry in depth-first order, or to `nullptr`
+  // once all entries have been visited.
+  void Advance() {
+    entry_ = nullptr;
+    while (!stack_.empty()) {
+      Frame& frame = stack_.back();
+      if (frame.entry_index < frame.node->entry_count) {
+        entry_ = &frame.node->entries[frame.entry_index++];
+        return;
+      }
+      if (frame.child_index < frame.node->child_count) {
+        const Node* child = frame.node->children[frame.child_index++];
+        stack_.push_back(Frame{child});
+        continue;
+      }
+      stack_.pop_back();
+    }
+  }
+
+  absl::InlinedVector<Frame, 8> stack_;
+  const Entry* absl_nullable entry_ = nullptr;
+};
+
+CustomMapValue MakePersistentMapValue(const Trie& trie,
+                                      google::protobuf::Arena* absl_nonnull arena);
+
+class PersistentMapValue final : public CustomMapValueInterface {
+ public:
+  explicit PersistentMapValue(const Trie& trie) : trie_(trie) {}
+
+  const Trie& trie() const { return trie_; }
+
+ private:
+  std::string DebugString() const override {
+    std::string out = "{";
+    bool first = true;
+    auto append = [&](const Entry& entry) -> absl::StatusOr<bool> {
+      if (!first) {
+        out.append(", ");
+      }
+      first = false;
+      out.append(entry.key.DebugString());
+      out.append(": ");
+      out.append(entry.value.DebugString());
+      return true;
+    };
+    if (trie_.root != nullptr) {
+      ForEachEntry(trie_.root, append).IgnoreError();
+    }
+    out.append("}");
+    return out;
+  }
+
+  absl::Status ConvertToJsonObject(
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Message* absl_nonnull json) const override {
+    ABSL_DCHECK(descriptor_pool != nullptr);
+    ABSL_DCHECK(message_factory != nullptr);
+    ABSL_DCHECK(json != nullptr);
+    ABSL_DCHECK_EQ(json->GetDescriptor()->well_known_type(),
+                   google::protobuf::Descriptor::WELLKNOWNTYPE_STRUCT);
+
+    StructReflection reflection;
+    CEL_RETURN_IF_ERROR(reflection.Initialize(json->GetDescriptor()));
+
+    json->Clear();
+    if (trie_.root == nullptr) {
+      return absl::OkStatus();
+    }
+    auto convert = [&](const Entry& entry) -> absl::StatusOr<bool> {
+      auto string_key = entry.key.AsString();
+      if (!string_key) {
+        return TypeConversionError(entry.key.GetRuntimeType(), StringType())
+            .ToStatus();
+      }
+      CEL_RETURN_IF_ERROR(entry.value.ConvertToJson(
+          descriptor_pool, message_factory,
+          reflection.InsertField(json, string_key->NativeString())));
+      return true;
+    };
+    return ForEachEntry(trie_.root, convert).status();
+  }
+
+  size_t Size() const override { return trie_.size; }
+
+  absl::Status ForEach(
+      ForEachCallback callback,
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena) const override {
+    if (trie_.root == nullptr) {
+      return absl::OkStatus();
+    }
+    auto forward = [&](const Entry& entry) -> absl::StatusOr<bool> {
+      return callback(entry.key, entry.value);
+    };
+    return ForEachEntry(trie_.root, forward).status();
+  }
+
+  absl::StatusOr<absl_nonnull ValueIteratorPtr> NewIterator() const override {
+    return std::make_unique<PersistentMapValueIterator>(trie_.root);
+  }
+
+  CustomMapValue Clone(google::protobuf::Arena* absl_nonnull arena) const override {
+    Trie trie;
+    if (trie_.root != nullptr) {
+      auto insert = [&](const Entry& entry) -> absl::StatusOr<bool> {
+        CEL_RETURN_IF_ERROR(
+            trie.Insert(entry.key.Clone(arena), entry.value.Clone(arena), arena));
+        return true;
+      };
+      // The entries were validated when they were first inserted.
+      ABSL_CHECK_OK(ForEachEntry(trie_.root, insert).status());  // Crash OK
+    }
+    return MakePersistentMapValue(trie, arena);
+  }
+
+  absl::StatusOr<bool> Find(
+      const Value& key,
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena,
+      Value* absl_nonnull result) const override {
+    CEL_RETURN_IF_ERROR(CheckMapKey(key));
+    if (const Entry* entry = FindEntry(trie_.root, key, KeyHash(key));
+        entry != nullptr) {
+      *result = entry->value;
+      return true;
+    }
+    return false;
+  }
+
+  absl::StatusOr<bool> Has(
+      const Value& key,
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena) const override {
+    CEL_RETURN_IF_ERROR(CheckMapKey(key));
+    return FindEntry(trie_.root, key, KeyHash(key)) != nullptr;
+  }
+
+  NativeTypeId GetNativeTypeId() const override {
+    return NativeTypeId::For<PersistentMapValue>();
+  }
+
+  const Trie trie_;
+};
+
+CustomMapValue MakePersistentMapValue(const Trie& trie,
+                                      google::protobuf::Arena* absl_nonnull arena) {
+  // PersistentMapValue only holds pointers into the arena, so the arena does
+  // not need to run its destructor. Nodes register their own destructor when
+  // they hold entries that need one.
+  return CustomMapValue(
+      ::new (arena->AllocateAligned(sizeof(PersistentMapValue),
+                                    alignof(PersistentMapValue)))
+          PersistentMapValue(trie),
+      arena);
+}
+
+const PersistentMapValue* absl_nullable AsPersistentMapValue(
+    const MapValue& value) {
+  auto custom_map_value = value.AsCustom();
+  if (!custom_map_value ||
+      custom_map_value->GetTypeId() != NativeTypeId::For<PersistentMapValue>()) {
+    return nullptr;
+  }
+  return cel::internal::down_cast<const PersistentMapValue*>(
+      custom_map_value->interface());
+}
+
+// Returns the contents of `map`, copying them into a new trie unless `map` is
+// already persistent.
+absl::StatusOr<Trie> ToTrie(
+    const MapValue& map,
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena) {
+  if (const auto* persistent = AsPersistentMapValue(map);
+      persistent != nullptr) {
+    return persistent->trie();
+  }
+  Trie trie;
+  CEL_RETURN_IF_ERROR(map.ForEach(
+      [&](const Value& key, const Value& value) -> absl::StatusOr<bool> {
+        CEL_RETURN_IF_ERROR(trie.Insert(key, value, arena));
+        return true;
+      },
+      descriptor_pool, message_factory, arena));
+  return trie;
+}
+
+}  // namespace
+
+absl::StatusOr<MapValue> PersistentMapInsert(
+    const MapValue& map, const Value& key, const Value& value,
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena) {
+  ABSL_DCHECK(descriptor_pool != nullptr);
+  ABSL_DCHECK(message_factory != nullptr);
+  ABSL_DCHECK(arena != nullptr);
+
+  CEL_ASSIGN_OR_RETURN(
+      Trie trie, ToTrie(map, descriptor_pool, message_factory, arena));
+  CEL_RETURN_IF_ERROR(trie.Insert(key, value, arena));
+  return MakePersistentMapValue(trie, arena);
+}
+
+absl::StatusOr<MapValue> PersistentMapMerge(
+    const MapValue& map, const MapValue& other,
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena) {
+  ABSL_DCHECK(descriptor_pool != nullptr);
+  ABSL_DCHECK(message_factory != nullptr);
+  ABSL_DCHECK(arena != nullptr);
+
+  CEL_ASSIGN_OR_RETURN(
+      Trie trie, ToTrie(map, descriptor_pool, message_factory, arena));
+  CEL_RETURN_IF_ERROR(other.ForEach(
+      [&](const Value& key, const Value& value) -> absl::StatusOr<bool> {
+        CEL_RETURN_IF_ERROR(trie.Insert(key, value, arena));
+        return true;
+      },
+      descriptor_pool, message_factory, arena));
+  if (trie.size == 0) {
+    return MapValue();
+  }
+  return MakePersistentMapValue(trie, arena);
+}
+
+bool IsPersistentMapValue(const MapValue& value) {
+  return AsPersistentMapValue(value) != nullptr;
+}
+
+}  // namespace cel::common_internal
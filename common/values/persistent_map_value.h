@@ -0,0 +1,58 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_COMMON_VALUES_PERSISTENT_MAP_VALUE_H_
+#define THIRD_PARTY_CEL_CPP_COMMON_VALUES_PERSISTENT_MAP_VALUE_H_
+
+#include "absl/base/nullability.h"
+#include "absl/status/statusor.h"
+#include "common/value.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
+
+namespace cel::common_internal {
+
+// Returns `map` with the entry `key: value` added as an immutable map which
+// shares structure with `map`.
+//
+// The map is a hash array mapped trie, so lookups are O(log32 n). If `map` was
+// itself returned by this function or `PersistentMapMerge()`, the entry is
+// inserted by copying only the O(log32 n) nodes along its path, leaving `map`
+// unchanged. Otherwise the entries of `map` are copied once. This makes
+// repeated insertion into an accumulator which cannot be mutated in place
+// linear overall instead of quadratic.
+//
+// Returns the same errors as `MapValueBuilder::Put()`, including when `key` is
+// already present.
+absl::StatusOr<MapValue> PersistentMapInsert(
+    const MapValue& map, const Value& key, const Value& value,
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena);
+
+// Like `PersistentMapInsert()`, but adds every entry of `other`.
+absl::StatusOr<MapValue> PersistentMapMerge(
+    const MapValue& map, const MapValue& other,
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena);
+
+// Returns `true` if `value` was created by `PersistentMapInsert()` or
+// `PersistentMapMerge()`.
+bool IsPersistentMapValue(const MapValue& value);
+
+}  // namespace cel::common_internal
+
+#endif  // THIRD_PARTY_CEL_CPP_COMMON_VALUES_PERSISTENT_MAP_VALUE_H_
@@ -0,0 +1,219 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/values/persistent_map_value.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "absl/base/nullability.h"
+#include "absl/log/absl_check.h"
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
+#include "common/value.h"
+#include "common/value_testing.h"
+#include "common/values/map_value_builder.h"
+#include "internal/testing.h"
+#include "google/protobuf/arena.h"
+
+namespace cel::common_internal {
+namespace {
+
+using ::absl_testing::IsOkAndHolds;
+using ::absl_testing::StatusIs;
+using ::cel::test::BoolValueIs;
+using ::cel::test::ErrorValueIs;
+using ::cel::test::IntValueIs;
+using ::cel::test::StringValueIs;
+using ::testing::Optional;
+using ::testing::UnorderedElementsAreArray;
+
+using PersistentMapValueTest = common_internal::ValueTest<>;
+
+MapValue MakeMap(std::vector<std::pair<int64_t, int64_t>> entries,
+                 google::protobuf::Arena* absl_nonnull arena) {
+  auto builder = NewMapValueBuilder(arena);
+  for (const auto& entry : entries) {
+    ABSL_CHECK_OK(builder->Put(IntValue(entry.first), IntValue(entry.second)));
+  }
+  return std::move(*builder).Build();
+}
+
+TEST_F(PersistentMapValueTest, Insert) {
+  ASSERT_OK_AND_ASSIGN(
+      MapValue map,
+      PersistentMapInsert(MakeMap({{0, 1}}, arena()), IntValue(1), IntValue(2),
+                          descriptor_pool(), message_factory(), arena()));
+  EXPECT_TRUE(IsPersistentMapValue(map));
+  EXPECT_THAT(map.Size(), IsOkAndHolds(2));
+  EXPECT_THAT(map.Find(IntValue(1), descriptor_pool(), message_factory(),
+                       arena()),
+              IsOkAndHolds(Optional(IntValueIs(2))));
+  EXPECT_THAT(map.Find(IntValue(2), descriptor_pool(), message_factory(),
+                       arena()),
+              IsOkAndHolds(absl::nullopt));
+  EXPECT_THAT(map.Has(IntValue(0), descriptor_pool(), message_factory(),
+                      arena()),
+              IsOkAndHolds(BoolValueIs(true)));
+  EXPECT_THAT(
+      map.Get(IntValue(2), descriptor_pool(), message_factory(), arena()),
+      IsOkAndHolds(ErrorValueIs(StatusIs(absl::StatusCode::kNotFound))));
+  EXPECT_THAT(map.Equal(MakeMap({{0, 1}, {1, 2}}, arena()), descriptor_pool(),
+                        message_factory(), arena()),
+              IsOkAndHolds(BoolValueIs(true)));
+}
+
+TEST_F(PersistentMapValueTest, DuplicateKey) {
+  ASSERT_OK_AND_ASSIGN(
+      MapValue map,
+      PersistentMapInsert(MapValue(), IntValue(0), IntValue(0),
+                          descriptor_pool(), message_factory(), arena()));
+  EXPECT_THAT(PersistentMapInsert(map, IntValue(0), IntValue(1),
+                                  descriptor_pool(), message_factory(),
+                                  arena()),
+              StatusIs(absl::StatusCode::kAlreadyExists));
+}
+
+TEST_F(PersistentMapValueTest, RejectsInvalidKeys) {
+  EXPECT_THAT(PersistentMapInsert(MapValue(), DoubleValue(1.0), IntValue(0),
+                                  descriptor_pool(), message_factory(),
+                                  arena()),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST_F(PersistentMapValueTest, RepeatedInsert) {
+  constexpr int64_t kSize = 2000;
+  MapValue map;
+  for (int64_t i = 0; i < kSize; ++i) {
+    ASSERT_OK_AND_ASSIGN(
+        map, PersistentMapInsert(map, IntValue(i), IntValue(i * 2),
+                                 descriptor_pool(), message_factory(),
+                                 arena()));
+  }
+  EXPECT_THAT(map.Size(), IsOkAndHolds(kSize));
+  for (int64_t i = 0; i < kSize; ++i) {
+    ASSERT_THAT(
+        map.Get(IntValue(i), descriptor_pool(), message_factory(), arena()),
+        IsOkAndHolds(IntValueIs(i * 2)));
+  }
+  std::vector<int64_t> keys;
+  ASSERT_THAT(map.ForEach(
+                  [&](const Value& key, const Value& value)
+                      -> absl::StatusOr<bool> {
+                    EXPECT_EQ(value.GetInt().NativeValue(),
+                              key.GetInt().NativeValue() * 2);
+                    keys.push_back(key.GetInt().NativeValue());
+                    return true;
+                  },
+                  descriptor_pool(), message_factory(), arena()),
+              absl_testing::IsOk());
+  std::vector<int64_t> expected;
+  for (int64_t i = 0; i < kSize; ++i) {
+    expected.push_back(i);
+  }
+  EXPECT_THAT(keys, UnorderedElementsAreArray(expected));
+}
+
+TEST_F(PersistentMapValueTest, EarlierVersionsAreUnchanged) {
+  ASSERT_OK_AND_ASSIGN(
+      MapValue base,
+      PersistentMapInsert(MakeMap({{0, 0}}, arena()), IntValue(1), IntValue(1),
+                          descriptor_pool(), message_factory(), arena()));
+  ASSERT_OK_AND_ASSIGN(
+      MapValue first,
+      PersistentMapInsert(base, IntValue(2), IntValue(2), descriptor_pool(),
+                          message_factory(), arena()));
+  ASSERT_OK_AND_ASSIGN(
+      MapValue second,
+      PersistentMapInsert(base, IntValue(3), IntValue(3), descriptor_pool(),
+                          message_factory(), arena()));
+  EXPECT_THAT(base.Size(), IsOkAndHolds(2));
+  EXPECT_THAT(first.Size(), IsOkAndHolds(3));
+  EXPECT_THAT(second.Size(), IsOkAndHolds(3));
+  EXPECT_THAT(base.Has(IntValue(2), descriptor_pool(), message_factory(),
+                       arena()),
+              IsOkAndHolds(BoolValueIs(false)));
+  EXPECT_THAT(first.Has(IntValue(3), descriptor_pool(), message_factory(),
+                        arena()),
+              IsOkAndHolds(BoolValueIs(false)));
+  EXPECT_THAT(second.Has(IntValue(3), descriptor_pool(), message_factory(),
+                         arena()),
+              IsOkAndHolds(BoolValueIs(true)));
+}
+
+TEST_F(PersistentMapValueTest, Merge) {
+  ASSERT_OK_AND_ASSIGN(
+      MapValue map,
+      PersistentMapMerge(MakeMap({{0, 0}}, arena()),
+                         MakeMap({{1, 1}, {2, 2}}, arena()), descriptor_pool(),
+                         message_factory(), arena()));
+  EXPECT_TRUE(IsPersistentMapValue(map));
+  EXPECT_THAT(map.Size(), IsOkAndHolds(3));
+  EXPECT_THAT(PersistentMapMerge(map, MakeMap({{2, 3}}, arena()),
+                                 descriptor_pool(), message_factory(), arena()),
+              StatusIs(absl::StatusCode::kAlreadyExists));
+}
+
+TEST_F(PersistentMapValueTest, NewIterator) {
+  ASSERT_OK_AND_ASSIGN(
+      MapValue map,
+      PersistentMapMerge(MapValue(), MakeMap({{0, 1}, {2, 3}}, arena()),
+                         descriptor_pool(), message_factory(), arena()));
+  ASSERT_OK_AND_ASSIGN(auto iterator, map.NewIterator());
+  std::vector<std::pair<int64_t, int64_t>> entries;
+  Value key;
+  Value value;
+  while (true) {
+    ASSERT_OK_AND_ASSIGN(bool ok, iterator->Next2(descriptor_pool(),
+                                                  message_factory(), arena(),
+                                                  &key, &value));
+    if (!ok) {
+      break;
+    }
+    entries.push_back(
+        {key.GetInt().NativeValue(), value.GetInt().NativeValue()});
+  }
+  EXPECT_THAT(entries,
+              UnorderedElementsAreArray(
+                  std::vector<std::pair<int64_t, int64_t>>{{0, 1}, {2, 3}}));
+}
+
+TEST_F(PersistentMapValueTest, ListKeys) {
+  ASSERT_OK_AND_ASSIGN(
+      MapValue map,
+      PersistentMapInsert(MapValue(), StringValue("foo"), IntValue(1),
+                          descriptor_pool(), message_factory(), arena()));
+  ASSERT_OK_AND_ASSIGN(
+      ListValue keys,
+      map.ListKeys(descriptor_pool(), message_factory(), arena()));
+  EXPECT_THAT(keys.Get(0, descriptor_pool(), message_factory(), arena()),
+              IsOkAndHolds(StringValueIs("foo")));
+}
+
+TEST_F(PersistentMapValueTest, Clone) {
+  ASSERT_OK_AND_ASSIGN(
+      MapValue map,
+      PersistentMapInsert(MakeMap({{0, 0}}, arena()), IntValue(1), IntValue(1),
+                          descriptor_pool(), message_factory(), arena()));
+  google::protobuf::Arena other_arena;
+  Value clone = Value(map).Clone(&other_arena);
+  ASSERT_TRUE(clone.IsMap());
+  EXPECT_TRUE(IsPersistentMapValue(clone.GetMap()));
+  EXPECT_THAT(clone.GetMap().Size(), IsOkAndHolds(2));
+}
+
+}  // namespace
+}  // namespace cel::common_internal
@@ -0,0 +1,482 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/values/primitive_list_value.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "absl/base/nullability.h"
+#include "absl/base/optimization.h"
+#include "absl/log/absl_check.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "absl/types/span.h"
+#include "common/native_type.h"
+#include "common/value.h"
+#include "common/value_kind.h"
+#include "internal/casts.h"
+#include "internal/status_macros.h"
+#include "internal/well_known_types.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
+
+namespace cel::common_internal {
+
+namespace {
+
+using ::cel::well_known_types::ListValueReflection;
+
+// Maps the native element type of an unboxed list to the `Value` alternative
+// its elements are boxed into.
+template <typename T>
+struct PrimitiveListTraits;
+
+template <>
+struct PrimitiveListTraits<int64_t> {
+  using ValueType = IntValue;
+
+  static Value Box(int64_t element, google::protobuf::Arena* absl_nonnull) {
+    return IntValue(element);
+  }
+};
+
+template <>
+struct PrimitiveListTraits<uint64_t> {
+  using ValueType = UintValue;
+
+  static Value Box(uint64_t element, google::protobuf::Arena* absl_nonnull) {
+    return UintValue(element);
+  }
+};
+
+template <>
+struct PrimitiveListTraits<double> {
+  using ValueType = DoubleValue;
+
+  static Value Box(double element, google::protobuf::Arena* absl_nonnull) {
+    return DoubleValue(element);
+  }
+};
+
+template <>
+struct PrimitiveListTraits<bool> {
+  using ValueType = BoolValue;
+
+  static Value Box(bool element, google::protobuf::Arena* absl_nonnull) {
+    return BoolValue(element);
+  }
+};
+
+template <>
+struct PrimitiveListTraits<absl::string_view> {
+  using ValueType = StringValue;
+
+  // The characters live on the arena which owns the list, so they are
+  // borrowed rather than copied.
+  static Value Box(absl::string_view element,
+                   google::protobuf::Arena* absl_nonnull arena) {
+    return StringValue::Wrap(element, arena);
+  }
+};
+
+// Copies `elements` onto `arena`. Strings have their characters copied into a
+// single buffer, so the views point into memory owned by `arena`.
+template <typename T>
+const T* absl_nonnull CopyElements(absl::Span<const T> elements,
+                                   google::protobuf::Arena* absl_nonnull arena) {
+  T* data = static_cast<T*>(
+      arena->AllocateAligned(sizeof(T) * elements.size(), alignof(T)));
+  if constexpr (std::is_same_v<T, absl::string_view>) {
+    size_t total_size = 0;
+    for (absl::string_view element : elements) {
+      total_size += element.size();
+    }
+    char* buffer = total_size == 0 ? nullptr
+                                   : static_cast<char*>(arena->AllocateAligned(
+                                         total_size, alignof(char)));
+    for (size_t i = 0; i < elements.size(); ++i) {
+      if (!elements[i].empty()) {
+        std::memcpy(buffer, elements[i].data(), elements[i].size());
+      }
+      ::new (&data[i]) absl::string_view(buffer, elements[i].size());
+      buffer += elements[i].size();
+    }
+  } else {
+    std::copy(elements.begin(), elements.end(), data);
+  }
+  return data;
+}
+
+template <typename T>
+class PrimitiveListValueIterator final : public ValueIterator {
+ public:
+  PrimitiveListValueIterator(absl::Span<const T> elements,
+                             google::protobuf::Arena* absl_nonnull arena)
+      : elements_(elements), arena_(arena) {}
+
+  bool HasNext() override { return index_ < elements_.size(); }
+
+  absl::Status Next(const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+                    google::protobuf::MessageFactory* absl_nonnull message_factory,
+                    google::protobuf::Arena* absl_nonnull arena,
+                    Value* absl_nonnull result) override {
+    if (ABSL_PREDICT_FALSE(index_ >= elements_.size())) {
+      return absl::FailedPreconditionError(
+          "ValueIterator::Next() called when "
+          "ValueIterator::HasNext() returns false");
+    }
+    *result = PrimitiveListTraits<T>::Box(elements_[index_++], arena_);
+    return absl::OkStatus();
+  }
+
+  absl::StatusOr<bool> Next1(
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena,
+      Value* absl_nonnull key_or_value) override {
+    if (index_ >= elements_.size()) {
+      return false;
+    }
+    *key_or_value = PrimitiveListTraits<T>::Box(elements_[index_++], arena_);
+    return true;
+  }
+
+  absl::StatusOr<bool> Next2(
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena, Value* absl_nullable key,
+      Value* absl_nullable value) override {
+    if (index_ >= elements_.size()) {
+      return false;
+    }
+    if (key != nullptr) {
+      *key = IntValue(static_cast<int64_t>(index_));
+    }
+    if (value != nullptr) {
+      *value = PrimitiveListTraits<T>::Box(elements_[index_], arena_);
+    }
+    ++index_;
+    return true;
+  }
+
+ private:
+  const absl::Span<const T> elements_;
+  google::protobuf::Arena* absl_nonnull const arena_;
+  size_t index_ = 0;
+};
+
+template <typename T>
+CustomListValue MakePrimitiveCustomListValue(absl::Span<const T> elements,
+                                             google::protobuf::Arena* absl_nonnull arena);
+
+template <typename T>
+class PrimitiveListValue final : public CustomListValueInterface {
+ public:
+  using Traits = PrimitiveListTraits<T>;
+
+  PrimitiveListValue(const T* absl_nonnull data, size_t size,
+                     google::protobuf::Arena* absl_nonnull arena)
+      : data_(data), size_(size), arena_(arena) {}
+
+  absl::Span<const T> elements() const { return absl::MakeSpan(data_, size_); }
+
+ private:
+  std::string DebugString() const override {
+    std::string out = "[";
+    for (size_t i = 0; i < size_; ++i) {
+      if (i != 0) {
+        out.append(", ");
+      }
+      out.append(Traits::Box(data_[i], arena_).DebugString());
+    }
+    out.append("]");
+    return out;
+  }
+
+  absl::Status ConvertToJsonArray(
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Message* absl_nonnull json) const override {
+    ABSL_DCHECK(descriptor_pool != nullptr);
+    ABSL_DCHECK(message_factory != nullptr);
+    ABSL_DCHECK(json != nullptr);
+    ABSL_DCHECK_EQ(json->GetDescriptor()->well_known_type(),
+                   google::protobuf::Descriptor::WELLKNOWNTYPE_LISTVALUE);
+
+    ListValueReflection reflection;
+    CEL_RETURN_IF_ERROR(reflection.Initialize(json->GetDescriptor()));
+
+    json->Clear();
+    for (size_t i = 0; i < size_; ++i) {
+      CEL_RETURN_IF_ERROR(Traits::Box(data_[i], arena_).ConvertToJson(
+          descriptor_pool, message_factory, reflection.AddValues(json)));
+    }
+    return absl::OkStatus();
+  }
+
+  absl::Status Equal(const ListValue& other,
+                     const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+                     google::protobuf::MessageFactory* absl_nonnull message_factory,
+                     google::protobuf::Arena* absl_nonnull arena,
+                     Value* absl_nonnull result) const override {
+    if (auto other_list = other.AsCustom();
+        other_list &&
+        other_list->GetTypeId() == NativeTypeId::For<PrimitiveListValue>()) {
+      absl::Span<const T> other_elements =
+          cel::internal::down_cast<const PrimitiveListValue*>(
+              other_list->interface())
+              ->elements();
+      // `==` on the native type matches CEL equality for a single element
+      // type, including NaN never being equal to itself.
+      *result = BoolValue(std::equal(data_, data_ + size_,
+                                     other_elements.begin(),
+                                     other_elements.end()));
+      return absl::OkStatus();
+    }
+    return CustomListValueInterface::Equal(other, descriptor_pool,
+                                           message_factory, arena, result);
+  }
+
+  size_t Size() const override { return size_; }
+
+  absl::Status Get(size_t index,
+                   const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+                   google::protobuf::MessageFactory* absl_nonnull message_factory,
+                   google::protobuf::Arena* absl_nonnull arena,
+                   Value* absl_nonnull result) const override {
+    if (ABSL_PREDICT_FALSE(index >= size_)) {
+      *result = IndexOutOfBoundsError(index);
+      return absl::OkStatus();
+    }
+    *result = Traits::Box(data_[index], arena_);
+    return absl::OkStatus();
+  }
+
+  absl::Status ForEach(
+      ForEachWithIndexCallback callback,
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena) const override {
+    for (size_t i = 0; i < size_; ++i) {
+      CEL_ASSIGN_OR_RETURN(auto ok, callback(i, Traits::Box(data_[i], arena_)));
+      if (!ok) {
+        break;
+      }
+    }
+    return absl::OkStatus();
+  }
+
+  absl::StatusOr<absl_nonnull ValueIteratorPtr> NewIterator() const override {
+    return std::make_unique<PrimitiveListValueIterator<T>>(elements(), arena_);
+  }
+
+  // Searches the native array when `other` has the element type. Otherwise
+  // falls back to heterogeneous equality against each boxed element, so that
+  // for example `1.0 in [1, 2]` still holds.
+  absl::Status Contains(
+      const Value& other,
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena,
+      Value* absl_nonnull result) const override {
+    auto typed_other = other.As<typename Traits::ValueType>();
+    if (!typed_other) {
+      return CustomListValueInterface::Contains(
+          other, descriptor_pool, message_factory, arena, result);
+    }
+    if constexpr (std::is_same_v<T, absl::string_view>) {
+      std::string scratch;
+      *result = BoolValue(std::find(data_, data_ + size_,
+                                    typed_other->ToStringView(&scratch)) !=
+                          data_ + size_);
+    } else {
+      *result = BoolValue(std::find(data_, data_ + size_,
+                                    typed_other->NativeValue()) !=
+                          data_ + size_);
+    }
+    return absl::OkStatus();
+  }
+
+  CustomListValue Clone(google::protobuf::Arena* absl_nonnull arena) const override {
+    return MakePrimitiveCustomListValue(elements(), arena);
+  }
+
+  NativeTypeId GetNativeTypeId() const override {
+    return NativeTypeId::For<PrimitiveListValue>();
+  }
+
+  const T* absl_nonnull const data_;
+  const size_t size_;
+  google::protobuf::Arena* absl_nonnull const arena_;
+};
+
+template <typename T>
+CustomListValue MakePrimitiveCustomListValue(absl::Span<const T> elements,
+                                             google::protobuf::Arena* absl_nonnull arena) {
+  // Both the list and its elements live on the arena and nothing needs to be
+  // released, so the arena does not need to run the destructor.
+  return CustomListValue(
+      ::new (arena->AllocateAligned(sizeof(PrimitiveListValue<T>),
+                                    alignof(PrimitiveListValue<T>)))
+          PrimitiveListValue<T>(CopyElements(elements, arena), elements.size(),
+                                arena),
+      arena);
+}
+
+template <typename T>
+ListValue MakePrimitiveListValue(absl::Span<const T> elements,
+                                 google::protobuf::Arena* absl_nonnull arena) {
+  ABSL_DCHECK(arena != nullptr);
+  if (elements.empty()) {
+    return ListValue();
+  }
+  return MakePrimitiveCustomListValue(elements, arena);
+}
+
+// Unboxes `elements`, all of which are known to be `ValueType`, into a
+// temporary array and copies it onto `arena`.
+template <typename T>
+ListValue MakeUnboxedListValueImpl(absl::Span<const Value> elements,
+                                   google::protobuf::Arena* absl_nonnull arena) {
+  using ValueType = typename PrimitiveListTraits<T>::ValueType;
+  if constexpr (std::is_same_v<T, absl::string_view>) {
+    // Strings which are not flat are copied into `scratch` first, which must
+    // stay put until the views have been copied onto the arena.
+    std::vector<std::string> scratch(elements.size());
+    std::vector<absl::string_view> native(elements.size());
+    for (size_t i = 0; i < elements.size(); ++i) {
+      native[i] = elements[i].GetString().ToStringView(&scratch[i]);
+    }
+    return MakePrimitiveListValue<T>(native, arena);
+  } else if constexpr (std::is_same_v<T, bool>) {
+    // `std::vector<bool>` is not contiguous.
+    std::unique_ptr<bool[]> native(new bool[elements.size()]);
+    for (size_t i = 0; i < elements.size(); ++i) {
+      native[i] = elements[i].template Get<ValueType>().NativeValue();
+    }
+    return MakePrimitiveListValue<T>(
+        absl::MakeConstSpan(native.get(), elements.size()), arena);
+  } else {
+    std::vector<T> native(elements.size());
+    for (size_t i = 0; i < elements.size(); ++i) {
+      native[i] = elements[i].template Get<ValueType>().NativeValue();
+    }
+    return MakePrimitiveListValue<T>(native, arena);
+  }
+}
+
+template <typename T>
+absl::optional<absl::Span<const T>> AsPrimitiveListValue(
+    const ListValue& value) {
+  auto custom_list_value = value.AsCustom();
+  if (!custom_list_value || custom_list_value->GetTypeId() !=
+                                NativeTypeId::For<PrimitiveListValue<T>>()) {
+    return absl::nullopt;
+  }
+  return cel::internal::down_cast<const PrimitiveListValue<T>*>(
+             custom_list_value->interface())
+      ->elements();
+}
+
+}  // namespace
+
+ListValue MakeIntListValue(absl::Span<const int64_t> elements,
+                           google::protobuf::Arena* absl_nonnull arena) {
+  return MakePrimitiveListValue(elements, arena);
+}
+
+ListValue MakeUintListValue(absl::Span<const uint64_t> elements,
+                            google::protobuf::Arena* absl_nonnull arena) {
+  return MakePrimitiveListValue(elements, arena);
+}
+
+ListValue MakeDoubleListValue(absl::Span<const double> elements,
+                              google::protobuf::Arena* absl_nonnull arena) {
+  return MakePrimitiveListValue(elements, arena);
+}
+
+ListValue MakeBoolListValue(absl::Span<const bool> elements,
+                            google::protobuf::Arena* absl_nonnull arena) {
+  return MakePrimitiveListValue(elements, arena);
+}
+
+ListValue MakeStringListValue(absl::Span<const absl::string_view> elements,
+                              google::protobuf::Arena* absl_nonnull arena) {
+  return MakePrimitiveListValue(elements, arena);
+}
+
+absl::optional<ListValue> MakeUnboxedListValue(
+    absl::Span<const Value> elements, google::protobuf::Arena* absl_nonnull arena) {
+  ABSL_DCHECK(arena != nullptr);
+  if (elements.empty()) {
+    return absl::nullopt;
+  }
+  const ValueKind kind = elements.front().kind();
+  for (const Value& element : elements.subspan(1)) {
+    if (element.kind() != kind) {
+      return absl::nullopt;
+    }
+  }
+  switch (kind) {
+    case ValueKind::kInt:
+      return MakeUnboxedListValueImpl<int64_t>(elements, arena);
+    case ValueKind::kUint:
+      return MakeUnboxedListValueImpl<uint64_t>(elements, arena);
+    case ValueKind::kDouble:
+      return MakeUnboxedListValueImpl<double>(elements, arena);
+    case ValueKind::kBool:
+      return MakeUnboxedListValueImpl<bool>(elements, arena);
+    case ValueKind::kString:
+      return MakeUnboxedListValueImpl<absl::string_view>(elements, arena);
+    default:
+      return absl::nullopt;
+  }
+}
+
+absl::optional<absl::Span<const int64_t>> AsIntListValue(
+    const ListValue& value) {
+  return AsPrimitiveListValue<int64_t>(value);
+}
+
+absl::optional<absl::Span<const uint64_t>> AsUintListValue(
+    const ListValue& value) {
+  return AsPrimitiveListValue<uint64_t>(value);
+}
+
+absl::optional<absl::Span<const double>> AsDoubleListValue(
+    const ListValue& value) {
+  return AsPrimitiveListValue<double>(value);
+}
+
+absl::optional<absl::Span<const bool>> AsBoolListValue(const ListValue& value) {
+  return AsPrimitiveListValue<bool>(value);
+}
+
+absl::optional<absl::Span<const absl::string_view>> AsStringListValue(
+    const ListValue& value) {
+  return AsPrimitiveListValue<absl::string_view>(value);
+}
+
+}  // namespace cel::common_internal
@@ -0,0 +1,69 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_COMMON_VALUES_PRIMITIVE_LIST_VALUE_H_
+#define THIRD_PARTY_CEL_CPP_COMMON_VALUES_PRIMITIVE_LIST_VALUE_H_
+
+#include <cstdint>
+
+#include "absl/base/nullability.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "absl/types/span.h"
+#include "common/value.h"
+#include "google/protobuf/arena.h"
+
+namespace cel::common_internal {
+
+// Returns a list whose elements are stored in a contiguous native array
+// allocated on `arena`, rather than as one `Value` each. Elements are boxed
+// into `Value`s on access. `Contains()` and `Equal()` against another list of
+// the same element type work directly on the native array.
+//
+// `elements` is copied, so it does not need to outlive the result. An empty
+// `elements` results in an empty list.
+ListValue MakeIntListValue(absl::Span<const int64_t> elements,
+                           google::protobuf::Arena* absl_nonnull arena);
+ListValue MakeUintListValue(absl::Span<const uint64_t> elements,
+                            google::protobuf::Arena* absl_nonnull arena);
+ListValue MakeDoubleListValue(absl::Span<const double> elements,
+                              google::protobuf::Arena* absl_nonnull arena);
+ListValue MakeBoolListValue(absl::Span<const bool> elements,
+                            google::protobuf::Arena* absl_nonnull arena);
+ListValue MakeStringListValue(absl::Span<const absl::string_view> elements,
+                              google::protobuf::Arena* absl_nonnull arena);
+
+// Returns `elements` as one of the lists above if they are all `int`, all
+// `uint`, all `double`, all `bool` or all `string`. Otherwise, including when
+// `elements` is empty, returns `absl::nullopt` and the caller should fall back
+// to `ListValueBuilder`.
+absl::optional<ListValue> MakeUnboxedListValue(
+    absl::Span<const Value> elements, google::protobuf::Arena* absl_nonnull arena);
+
+// Returns the elements of `value` if it was created by the corresponding
+// function above, so that callers can work on the native array directly. The
+// span is valid as long as `value`.
+absl::optional<absl::Span<const int64_t>> AsIntListValue(
+    const ListValue& value);
+absl::optional<absl::Span<const uint64_t>> AsUintListValue(
+    const ListValue& value);
+absl::optional<absl::Span<const double>> AsDoubleListValue(
+    const ListValue& value);
+absl::optional<absl::Span<const bool>> AsBoolListValue(const ListValue& value);
+absl::optional<absl::Span<const absl::string_view>> AsStringListValue(
+    const ListValue& value);
+
+}  // namespace cel::common_internal
+
+#endif  // THIRD_PARTY_CEL_CPP_COMMON_VALUES_PRIMITIVE_LIST_VALUE_H_
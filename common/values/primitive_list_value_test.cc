@@ -0,0 +1,171 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/values/primitive_list_value.h"
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "common/value.h"
+#include "common/value_testing.h"
+#include "internal/testing.h"
+#include "google/protobuf/arena.h"
+
+namespace cel::common_internal {
+namespace {
+
+using ::absl_testing::IsOk;
+using ::absl_testing::IsOkAndHolds;
+using ::absl_testing::StatusIs;
+using ::cel::test::BoolValueIs;
+using ::cel::test::ErrorValueIs;
+using ::cel::test::IntValueIs;
+using ::cel::test::StringValueIs;
+using ::testing::ElementsAre;
+using ::testing::Optional;
+
+using PrimitiveListValueTest = common_internal::ValueTest<>;
+
+TEST_F(PrimitiveListValueTest, Int) {
+  ListValue value = MakeIntListValue({1, 2, 3}, arena());
+  EXPECT_THAT(value.Size(), IsOkAndHolds(3));
+  EXPECT_EQ(value.DebugString(), "[1, 2, 3]");
+  EXPECT_THAT(value.Get(2, descriptor_pool(), message_factory(), arena()),
+              IsOkAndHolds(IntValueIs(3)));
+  EXPECT_THAT(
+      value.Get(3, descriptor_pool(), message_factory(), arena()),
+      IsOkAndHolds(ErrorValueIs(StatusIs(absl::StatusCode::kInvalidArgument))));
+  EXPECT_THAT(AsIntListValue(value), Optional(ElementsAre(1, 2, 3)));
+  EXPECT_EQ(AsUintListValue(value), absl::nullopt);
+}
+
+TEST_F(PrimitiveListValueTest, String) {
+  std::string owned = "bar";
+  ListValue value = MakeStringListValue({"foo", owned, ""}, arena());
+  owned = "baz";
+  EXPECT_EQ(value.DebugString(), "[\"foo\", \"bar\", \"\"]");
+  EXPECT_THAT(value.Get(1, descriptor_pool(), message_factory(), arena()),
+              IsOkAndHolds(StringValueIs("bar")));
+  EXPECT_THAT(value.Contains(StringValue("bar"), descriptor_pool(),
+                             message_factory(), arena()),
+              IsOkAndHolds(BoolValueIs(true)));
+  EXPECT_THAT(value.Contains(StringValue("baz"), descriptor_pool(),
+                             message_factory(), arena()),
+              IsOkAndHolds(BoolValueIs(false)));
+}
+
+TEST_F(PrimitiveListValueTest, Empty) {
+  EXPECT_THAT(MakeDoubleListValue({}, arena()).IsEmpty(), IsOkAndHolds(true));
+  EXPECT_FALSE(MakeUnboxedListValue({}, arena()).has_value());
+}
+
+TEST_F(PrimitiveListValueTest, Contains) {
+  ListValue value = MakeIntListValue({1, 2, 3}, arena());
+  EXPECT_THAT(value.Contains(IntValue(2), descriptor_pool(), message_factory(),
+                             arena()),
+              IsOkAndHolds(BoolValueIs(true)));
+  EXPECT_THAT(value.Contains(IntValue(4), descriptor_pool(), message_factory(),
+                             arena()),
+              IsOkAndHolds(BoolValueIs(false)));
+  // Other numeric kinds use heterogeneous equality.
+  EXPECT_THAT(value.Contains(DoubleValue(2.0), descriptor_pool(),
+                             message_factory(), arena()),
+              IsOkAndHolds(BoolValueIs(true)));
+  EXPECT_THAT(value.Contains(UintValue(3), descriptor_pool(),
+                             message_factory(), arena()),
+              IsOkAndHolds(BoolValueIs(true)));
+  EXPECT_THAT(value.Contains(StringValue("1"), descriptor_pool(),
+                             message_factory(), arena()),
+              IsOkAndHolds(BoolValueIs(false)));
+}
+
+TEST_F(PrimitiveListValueTest, ContainsNaN) {
+  ListValue value = MakeDoubleListValue({1.0, std::nan("")}, arena());
+  EXPECT_THAT(value.Contains(DoubleValue(std::nan("")), descriptor_pool(),
+                             message_factory(), arena()),
+              IsOkAndHolds(BoolValueIs(false)));
+}
+
+TEST_F(PrimitiveListValueTest, Equal) {
+  ListValue value = MakeUintListValue({1, 2}, arena());
+  EXPECT_THAT(value.Equal(MakeUintListValue({1, 2}, arena()),
+                          descriptor_pool(), message_factory(), arena()),
+              IsOkAndHolds(BoolValueIs(true)));
+  EXPECT_THAT(value.Equal(MakeUintListValue({1}, arena()), descriptor_pool(),
+                          message_factory(), arena()),
+              IsOkAndHolds(BoolValueIs(false)));
+  // Mixed representations compare element by element.
+  EXPECT_THAT(value.Equal(MakeIntListValue({1, 2}, arena()),
+                          descriptor_pool(), message_factory(), arena()),
+              IsOkAndHolds(BoolValueIs(true)));
+  auto builder = NewListValueBuilder(arena());
+  ASSERT_THAT(builder->Add(UintValue(1)), IsOk());
+  ASSERT_THAT(builder->Add(UintValue(2)), IsOk());
+  EXPECT_THAT(value.Equal(std::move(*builder).Build(), descriptor_pool(),
+                          message_factory(), arena()),
+              IsOkAndHolds(BoolValueIs(true)));
+}
+
+TEST_F(PrimitiveListValueTest, NewIterator) {
+  ListValue value = MakeBoolListValue({true, false}, arena());
+  ASSERT_OK_AND_ASSIGN(auto iterator, value.NewIterator());
+  std::vector<bool> elements;
+  while (iterator->HasNext()) {
+    ASSERT_OK_AND_ASSIGN(
+        auto element,
+        iterator->Next(descriptor_pool(), message_factory(), arena()));
+    elements.push_back(element.GetBool().NativeValue());
+  }
+  EXPECT_THAT(elements, ElementsAre(true, false));
+  EXPECT_THAT(iterator->Next(descriptor_pool(), message_factory(), arena()),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+}
+
+TEST_F(PrimitiveListValueTest, MakeUnboxedListValue) {
+  std::vector<Value> ints = {IntValue(1), IntValue(2)};
+  auto int_list = MakeUnboxedListValue(ints, arena());
+  ASSERT_TRUE(int_list.has_value());
+  EXPECT_THAT(AsIntListValue(*int_list), Optional(ElementsAre(1, 2)));
+
+  std::vector<Value> strings = {StringValue("a"), StringValue("b")};
+  auto string_list = MakeUnboxedListValue(strings, arena());
+  ASSERT_TRUE(string_list.has_value());
+  EXPECT_THAT(AsStringListValue(*string_list),
+              Optional(ElementsAre("a", "b")));
+
+  std::vector<Value> mixed = {IntValue(1), UintValue(2)};
+  EXPECT_FALSE(MakeUnboxedListValue(mixed, arena()).has_value());
+
+  std::vector<Value> bytes = {BytesValue("a")};
+  EXPECT_FALSE(MakeUnboxedListValue(bytes, arena()).has_value());
+}
+
+TEST_F(PrimitiveListValueTest, Clone) {
+  ListValue value = MakeStringListValue({"foo", "bar"}, arena());
+  google::protobuf::Arena other_arena;
+  Value clone = Value(value).Clone(&other_arena);
+  ASSERT_TRUE(clone.IsList());
+  EXPECT_THAT(AsStringListValue(clone.GetList()),
+              Optional(ElementsAre("foo", "bar")));
+}
+
+}  // namespace
+}  // namespace cel::common_internal
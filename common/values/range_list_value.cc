@@ -0,0 +1,194 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/values/range_list_value.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string>
+
+#include "absl/base/nullability.h"
+#include "absl/base/optimization.h"
+#include "absl/log/absl_check.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/types/optional.h"
+#include "common/native_type.h"
+#include "common/value.h"
+#include "internal/casts.h"
+#include "internal/status_macros.h"
+#include "internal/well_known_types.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
+
+namespace cel::common_internal {
+
+namespace {
+
+using ::cel::well_known_types::ListValueReflection;
+
+CustomListValue MakeRangeCustomListValue(int64_t size,
+                                         google::protobuf::Arena* absl_nonnull arena);
+
+class RangeListValue final : public CustomListValueInterface {
+ public:
+  explicit RangeListValue(int64_t size) : size_(size) {}
+
+  int64_t size() const { return size_; }
+
+ private:
+  std::string DebugString() const override {
+    std::string out = "[";
+    for (int64_t i = 0; i < size_; ++i) {
+      if (i != 0) {
+        out.append(", ");
+      }
+      absl::StrAppend(&out, i);
+    }
+    out.append("]");
+    return out;
+  }
+
+  absl::Status ConvertToJsonArray(
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Message* absl_nonnull json) const override {
+    ABSL_DCHECK(descriptor_pool != nullptr);
+    ABSL_DCHECK(message_factory != nullptr);
+    ABSL_DCHECK(json != nullptr);
+    ABSL_DCHECK_EQ(json->GetDescriptor()->well_known_type(),
+                   google::protobuf::Descriptor::WELLKNOWNTYPE_LISTVALUE);
+
+    ListValueReflection reflection;
+    CEL_RETURN_IF_ERROR(reflection.Initialize(json->GetDescriptor()));
+
+    json->Clear();
+    for (int64_t i = 0; i < size_; ++i) {
+      CEL_RETURN_IF_ERROR(IntValue(i).ConvertToJson(
+          descriptor_pool, message_factory, reflection.AddValues(json)));
+    }
+    return absl::OkStatus();
+  }
+
+  size_t Size() const override { return static_cast<size_t>(size_); }
+
+  absl::Status Get(size_t index,
+                   const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+                   google::protobuf::MessageFactory* absl_nonnull message_factory,
+                   google::protobuf::Arena* absl_nonnull arena,
+                   Value* absl_nonnull result) const override {
+    if (ABSL_PREDICT_FALSE(index >= Size())) {
+      *result = IndexOutOfBoundsError(index);
+      return absl::OkStatus();
+    }
+    *result = IntValue(static_cast<int64_t>(index));
+    return absl::OkStatus();
+  }
+
+  absl::Status ForEach(
+      ForEachWithIndexCallback callback,
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena) const override {
+    for (int64_t i = 0; i < size_; ++i) {
+      CEL_ASSIGN_OR_RETURN(auto ok,
+                           callback(static_cast<size_t>(i), IntValue(i)));
+      if (!ok) {
+        break;
+      }
+    }
+    return absl::OkStatus();
+  }
+
+  absl::StatusOr<absl_nonnull ValueIteratorPtr> NewIterator() const override {
+    return std::make_unique<RangeListValueIterator>(size_);
+  }
+
+  // Ints are answered directly. Other values go through the same element-wise
+  // equality as a materialized list of ints, so the result for them doesn't
+  // depend on how the list is represented.
+  absl::Status Contains(
+      const Value& other,
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena,
+      Value* absl_nonnull result) const override {
+    if (auto int_value = other.AsInt(); int_value) {
+      *result = BoolValue(int_value->NativeValue() >= 0 &&
+                          int_value->NativeValue() < size_);
+      return absl::OkStatus();
+    }
+    return CustomListValueInterface::Contains(other, descriptor_pool,
+                                              message_factory, arena, result);
+  }
+
+  CustomListValue Clone(google::protobuf::Arena* absl_nonnull arena) const override {
+    return MakeRangeCustomListValue(size_, arena);
+  }
+
+  NativeTypeId GetNativeTypeId() const override {
+    return NativeTypeId::For<RangeListValue>();
+  }
+
+  const int64_t size_;
+};
+
+CustomListValue MakeRangeCustomListValue(int64_t size,
+                                         google::protobuf::Arena* absl_nonnull arena) {
+  // RangeListValue has nothing to release, so the arena does not need to run
+  // its destructor.
+  return CustomListValue(
+      ::new (arena->AllocateAligned(sizeof(RangeListValue),
+                                    alignof(RangeListValue)))
+          RangeListValue(size),
+      arena);
+}
+
+}  // namespace
+
+absl::Status RangeListValueIterator::Next(
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena, Value* absl_nonnull result) {
+  if (ABSL_PREDICT_FALSE(index_ >= size_)) {
+    return absl::FailedPreconditionError(
+        "ValueIterator::Next() called when "
+        "ValueIterator::HasNext() returns false");
+  }
+  *result = IntValue(index_++);
+  return absl::OkStatus();
+}
+
+ListValue MakeRangeListValue(int64_t size,
+                             google::protobuf::Arena* absl_nonnull arena) {
+  ABSL_DCHECK(arena != nullptr);
+  return MakeRangeCustomListValue(size < 0 ? 0 : size, arena);
+}
+
+absl::optional<int64_t> AsRangeListValue(const ListValue& value) {
+  auto custom_list_value = value.AsCustom();
+  if (!custom_list_value ||
+      custom_list_value->GetTypeId() != NativeTypeId::For<RangeListValue>()) {
+    return absl::nullopt;
+  }
+  return cel::internal::down_cast<const RangeListValue*>(
+             custom_list_value->interface())
+      ->size();
+}
+
+}  // namespace cel::common_internal
@@ -0,0 +1,94 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_COMMON_VALUES_RANGE_LIST_VALUE_H_
+#define THIRD_PARTY_CEL_CPP_COMMON_VALUES_RANGE_LIST_VALUE_H_
+
+#include <cstdint>
+
+#include "absl/base/nullability.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/types/optional.h"
+#include "common/value.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
+
+namespace cel::common_internal {
+
+// Returns a list of the integers `[0, size)` whose elements are computed on
+// access instead of being stored. `Size()`, `Get()` and `Contains()` are
+// constant time. A negative `size` results in an empty list.
+ListValue MakeRangeListValue(int64_t size,
+                             google::protobuf::Arena* absl_nonnull arena);
+
+// Returns the size of `value` if it was created by `MakeRangeListValue()`, so
+// that callers can enumerate its elements without going through the list
+// interface.
+absl::optional<int64_t> AsRangeListValue(const ListValue& value);
+
+// Iterator over the elements of a list created by `MakeRangeListValue()`.
+//
+// Exposed so callers can iterate on the stack instead of allocating an
+// iterator with `ListValue::NewIterator()`.
+class RangeListValueIterator final : public ValueIterator {
+ public:
+  explicit RangeListValueIterator(int64_t size) : size_(size) {}
+
+  bool HasNext() override { return index_ < size_; }
+
+  absl::Status Next(const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+                    google::protobuf::MessageFactory* absl_nonnull message_factory,
+                    google::protobuf::Arena* absl_nonnull arena,
+                    Value* absl_nonnull result) override;
+
+  absl::StatusOr<bool> Next1(
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena,
+      Value* absl_nonnull key_or_value) override {
+    if (index_ >= size_) {
+      return false;
+    }
+    *key_or_value = IntValue(index_++);
+    return true;
+  }
+
+  absl::StatusOr<bool> Next2(
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena, Value* absl_nullable key,
+      Value* absl_nullable value) override {
+    if (index_ >= size_) {
+      return false;
+    }
+    if (key != nullptr) {
+      *key = IntValue(index_);
+    }
+    if (value != nullptr) {
+      *value = IntValue(index_);
+    }
+    ++index_;
+    return true;
+  }
+
+ private:
+  const int64_t size_;
+  int64_t index_ = 0;
+};
+
+}  // namespace cel::common_internal
+
+#endif  // THIRD_PARTY_CEL_CPP_COMMON_VALUES_RANGE_LIST_VALUE_H_
@@ -0,0 +1,140 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/values/range_list_value.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/types/optional.h"
+#include "common/value.h"
+#include "common/value_testing.h"
+#include "internal/testing.h"
+
+namespace cel::common_internal {
+namespace {
+
+using ::absl_testing::IsOk;
+using ::absl_testing::IsOkAndHolds;
+using ::absl_testing::StatusIs;
+using ::cel::test::BoolValueIs;
+using ::cel::test::ErrorValueIs;
+using ::cel::test::IntValueIs;
+using ::testing::ElementsAre;
+using ::testing::Optional;
+
+using RangeListValueTest = common_internal::ValueTest<>;
+
+TEST_F(RangeListValueTest, Size) {
+  ListValue value = MakeRangeListValue(3, arena());
+  EXPECT_THAT(value.Size(), IsOkAndHolds(3));
+  EXPECT_THAT(value.IsEmpty(), IsOkAndHolds(false));
+  EXPECT_EQ(value.DebugString(), "[0, 1, 2]");
+}
+
+TEST_F(RangeListValueTest, NegativeSizeIsEmpty) {
+  ListValue value = MakeRangeListValue(-1, arena());
+  EXPECT_THAT(value.IsEmpty(), IsOkAndHolds(true));
+  EXPECT_THAT(AsRangeListValue(value), Optional(0));
+}
+
+TEST_F(RangeListValueTest, Get) {
+  ListValue value = MakeRangeListValue(3, arena());
+  EXPECT_THAT(value.Get(2, descriptor_pool(), message_factory(), arena()),
+              IsOkAndHolds(IntValueIs(2)));
+  EXPECT_THAT(
+      value.Get(3, descriptor_pool(), message_factory(), arena()),
+      IsOkAndHolds(ErrorValueIs(StatusIs(absl::StatusCode::kInvalidArgument))));
+}
+
+TEST_F(RangeListValueTest, Contains) {
+  ListValue value = MakeRangeListValue(3, arena());
+  EXPECT_THAT(value.Contains(IntValue(2), descriptor_pool(), message_factory(),
+                             arena()),
+              IsOkAndHolds(BoolValueIs(true)));
+  EXPECT_THAT(value.Contains(IntValue(-1), descriptor_pool(),
+                             message_factory(), arena()),
+              IsOkAndHolds(BoolValueIs(false)));
+  EXPECT_THAT(value.Contains(UintValue(1), descriptor_pool(),
+                             message_factory(), arena()),
+              IsOkAndHolds(BoolValueIs(true)));
+  EXPECT_THAT(value.Contains(DoubleValue(1.0), descriptor_pool(),
+                             message_factory(), arena()),
+              IsOkAndHolds(BoolValueIs(true)));
+  EXPECT_THAT(value.Contains(DoubleValue(1.5), descriptor_pool(),
+                             message_factory(), arena()),
+              IsOkAndHolds(BoolValueIs(false)));
+  EXPECT_THAT(value.Contains(StringValue("1"), descriptor_pool(),
+                             message_factory(), arena()),
+              IsOkAndHolds(BoolValueIs(false)));
+}
+
+TEST_F(RangeListValueTest, ContainsMatchesMaterializedList) {
+  ListValue value = MakeRangeListValue(3, arena());
+  auto builder = NewListValueBuilder(arena());
+  for (int64_t i = 0; i < 3; ++i) {
+    ASSERT_THAT(builder->Add(IntValue(i)), IsOk());
+  }
+  ListValue materialized = std::move(*builder).Build();
+
+  for (const Value& other :
+       {Value(IntValue(0)), Value(IntValue(3)), Value(UintValue(2)),
+        Value(UintValue(3)), Value(DoubleValue(2.0)), Value(DoubleValue(0.5)),
+        Value(DoubleValue(-0.0)), Value(StringValue("1")), Value(NullValue())}) {
+    SCOPED_TRACE(other.DebugString());
+    ASSERT_OK_AND_ASSIGN(
+        Value expected, materialized.Contains(other, descriptor_pool(),
+                                              message_factory(), arena()));
+    EXPECT_THAT(value.Contains(other, descriptor_pool(), message_factory(),
+                               arena()),
+                IsOkAndHolds(BoolValueIs(expected.GetBool().NativeValue())));
+  }
+}
+
+TEST_F(RangeListValueTest, NewIterator) {
+  ListValue value = MakeRangeListValue(3, arena());
+  ASSERT_OK_AND_ASSIGN(auto iterator, value.NewIterator());
+  std::vector<int64_t> elements;
+  while (iterator->HasNext()) {
+    ASSERT_OK_AND_ASSIGN(
+        auto element,
+        iterator->Next(descriptor_pool(), message_factory(), arena()));
+    elements.push_back(element.GetInt().NativeValue());
+  }
+  EXPECT_THAT(elements, ElementsAre(0, 1, 2));
+  EXPECT_THAT(iterator->Next(descriptor_pool(), message_factory(), arena()),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+}
+
+TEST_F(RangeListValueTest, Equal) {
+  ListValue value = MakeRangeListValue(3, arena());
+  auto builder = NewListValueBuilder(arena());
+  ASSERT_THAT(builder->Add(IntValue(0)), IsOk());
+  ASSERT_THAT(builder->Add(IntValue(1)), IsOk());
+  ASSERT_THAT(builder->Add(IntValue(2)), IsOk());
+  EXPECT_THAT(value.Equal(std::move(*builder).Build(), descriptor_pool(),
+                          message_factory(), arena()),
+              IsOkAndHolds(BoolValueIs(true)));
+}
+
+TEST_F(RangeListValueTest, AsRangeListValue) {
+  EXPECT_THAT(AsRangeListValue(MakeRangeListValue(3, arena())), Optional(3));
+  EXPECT_EQ(AsRangeListValue(ListValue()), absl::nullopt);
+}
+
+}  // namespace
+}  // namespace cel::common_internal
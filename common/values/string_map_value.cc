@@ -0,0 +1,524 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/values/string_map_value.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/nullability.h"
+#include "absl/base/optimization.h"
+#include "absl/hash/hash.h"
+#include "absl/log/absl_check.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "absl/types/span.h"
+#include "common/arena.h"
+#include "common/native_type.h"
+#include "common/value.h"
+#include "common/values/map_value_builder.h"
+#include "common/values/primitive_list_value.h"
+#include "internal/casts.h"
+#include "internal/status_macros.h"
+#include "internal/well_known_types.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
+
+namespace cel::common_internal {
+
+namespace {
+
+using ::cel::well_known_types::StructReflection;
+
+// Slots hold the index of an entry plus one, so that zero marks an empty slot.
+using Slot = uint32_t;
+
+constexpr size_t kMinCapacity = 8;
+
+size_t StringHash(absl::string_view key) {
+  return absl::Hash<absl::string_view>{}(key);
+}
+
+// Returns the smallest power of two capacity which keeps the load factor of a
+// table with `size` entries at or below 2/3, so probe sequences stay short.
+size_t CapacityFor(size_t size) {
+  size_t capacity = kMinCapacity;
+  while (capacity * 2 < size * 3) {
+    capacity *= 2;
+  }
+  return capacity;
+}
+
+// Returns the slot holding the entry for `key`, or the empty slot at which it
+// would be inserted. `keys` is indexable by entry and holds types convertible
+// to `absl::string_view`. The precomputed hash of each entry is compared first,
+// so key bytes are only compared for likely matches.
+template <typename Keys>
+size_t Probe(const Slot* absl_nonnull slots, size_t mask,
+             const size_t* absl_nonnull hashes, const Keys& keys, size_t hash,
+             absl::string_view key) {
+  for (size_t index = hash & mask;; index = (index + 1) & mask) {
+    const Slot slot = slots[index];
+    if (slot == 0) {
+      return index;
+    }
+    const size_t entry = slot - 1;
+    if (hashes[entry] == hash && absl::string_view(keys[entry]) == key) {
+      return index;
+    }
+  }
+}
+
+absl::Status CheckMapValue(const Value& value) {
+  if (auto error_value = value.AsError(); ABSL_PREDICT_FALSE(error_value)) {
+    return error_value->ToStatus();
+  }
+  if (auto unknown_value = value.AsUnknown();
+      ABSL_PREDICT_FALSE(unknown_value)) {
+    return absl::InvalidArgumentError("cannot add unknown value to map");
+  }
+  return absl::OkStatus();
+}
+
+CustomMapValue MakeStringCustomMapValue(absl::Span<const absl::string_view> keys,
+                                        absl::Span<const size_t> hashes,
+                                        absl::Span<Value> values,
+                                        google::protobuf::Arena* absl_nonnull arena);
+
+class StringMapValueIterator final : public ValueIterator {
+ public:
+  StringMapValueIterator(const absl::string_view* absl_nonnull keys,
+                         const Value* absl_nonnull values, size_t size,
+                         google::protobuf::Arena* absl_nonnull arena)
+      : keys_(keys), values_(values), size_(size), arena_(arena) {}
+
+  bool HasNext() override { return index_ < size_; }
+
+  absl::Status Next(const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+                    google::protobuf::MessageFactory* absl_nonnull message_factory,
+                    google::protobuf::Arena* absl_nonnull arena,
+                    Value* absl_nonnull result) override {
+    if (ABSL_PREDICT_FALSE(index_ >= size_)) {
+      return absl::FailedPreconditionError(
+          "ValueIterator::Next() called when "
+          "ValueIterator::HasNext() returns false");
+    }
+    *result = StringValue::Wrap(keys_[index_++], arena_);
+    return absl::OkStatus();
+  }
+
+  absl::StatusOr<bool> Next1(
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena,
+      Value* absl_nonnull key_or_value) override {
+    if (index_ >= size_) {
+      return false;
+    }
+    *key_or_value = StringValue::Wrap(keys_[index_++], arena_);
+    return true;
+  }
+
+  absl::StatusOr<bool> Next2(
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena, Value* absl_nullable key,
+      Value* absl_nullable value) override {
+    if (index_ >= size_) {
+      return false;
+    }
+    if (key != nullptr) {
+      *key = StringValue::Wrap(keys_[index_], arena_);
+    }
+    if (value != nullptr) {
+      *value = values_[index_];
+    }
+    ++index_;
+    return true;
+  }
+
+ private:
+  const absl::string_view* absl_nonnull const keys_;
+  const Value* absl_nonnull const values_;
+  const size_t size_;
+  google::protobuf::Arena* absl_nonnull const arena_;
+  size_t index_ = 0;
+};
+
+// A map whose keys are all strings, stored as parallel arrays on the arena:
+// the key bytes (as views into a single buffer), their hashes and the values,
+// in insertion order. `slots_` is an open-addressed index into those arrays
+// using linear probing.
+class StringMapValue final : public CustomMapValueInterface {
+ public:
+  StringMapValue(const Slot* absl_nonnull slots, size_t capacity,
+                 const size_t* absl_nonnull hashes,
+                 const absl::string_view* absl_nonnull keys,
+                 Value* absl_nonnull values, size_t size,
+                 google::protobuf::Arena* absl_nonnull arena)
+      : slots_(slots),
+        mask_(capacity - 1),
+        hashes_(hashes),
+        keys_(keys),
+        values_(values),
+        size_(size),
+        arena_(arena) {}
+
+  // Only run by the arena if some value is not trivially destructible.
+  ~StringMapValue() override {
+    for (size_t i = 0; i < size_; ++i) {
+      values_[i].~Value();
+    }
+  }
+
+  const Value* absl_nullable Lookup(absl::string_view key) const {
+    const size_t hash = StringHash(key);
+    const Slot slot = slots_[Probe(slots_, mask_, hashes_, keys_, hash, key)];
+    return slot == 0 ? nullptr : &values_[slot - 1];
+  }
+
+ private:
+  std::string DebugString() const override {
+    std::string out = "{";
+    for (size_t i = 0; i < size_; ++i) {
+      if (i != 0) {
+        out.append(", ");
+      }
+      out.append(StringValue::Wrap(keys_[i], arena_).DebugString());
+      out.append(": ");
+      out.append(values_[i].DebugString());
+    }
+    out.append("}");
+    return out;
+  }
+
+  absl::Status ConvertToJsonObject(
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Message* absl_nonnull json) const override {
+    ABSL_DCHECK(descriptor_pool != nullptr);
+    ABSL_DCHECK(message_factory != nullptr);
+    ABSL_DCHECK(json != nullptr);
+    ABSL_DCHECK_EQ(json->GetDescriptor()->well_known_type(),
+                   google::protobuf::Descriptor::WELLKNOWNTYPE_STRUCT);
+
+    StructReflection reflection;
+    CEL_RETURN_IF_ERROR(reflection.Initialize(json->GetDescriptor()));
+
+    json->Clear();
+    for (size_t i = 0; i < size_; ++i) {
+      CEL_RETURN_IF_ERROR(values_[i].ConvertToJson(
+          descriptor_pool, message_factory,
+          reflection.InsertField(json, keys_[i])));
+    }
+    return absl::OkStatus();
+  }
+
+  size_t Size() const override { return size_; }
+
+  absl::Status ListKeys(
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena,
+      ListValue* absl_nonnull result) const override {
+    *result = MakeStringListValue(absl::MakeConstSpan(keys_, size_), arena);
+    return absl::OkStatus();
+  }
+
+  absl::Status ForEach(
+      ForEachCallback callback,
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena) const override {
+    for (size_t i = 0; i < size_; ++i) {
+      CEL_ASSIGN_OR_RETURN(
+          auto ok, callback(StringValue::Wrap(keys_[i], arena_), values_[i]));
+      if (!ok) {
+        break;
+      }
+    }
+    return absl::OkStatus();
+  }
+
+  absl::StatusOr<absl_nonnull ValueIteratorPtr> NewIterator() const override {
+    return std::make_unique<StringMapValueIterator>(keys_, values_, size_,
+                                                    arena_);
+  }
+
+  CustomMapValue Clone(google::protobuf::Arena* absl_nonnull arena) const override {
+    std::vector<Value> values;
+    values.reserve(size_);
+    for (size_t i = 0; i < size_; ++i) {
+      values.push_back(values_[i].Clone(arena));
+    }
+    return MakeStringCustomMapValue(absl::MakeConstSpan(keys_, size_),
+                                    absl::MakeConstSpan(hashes_, size_),
+                                    absl::MakeSpan(values), arena);
+  }
+
+  absl::StatusOr<bool> Find(
+      const Value& key,
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena,
+      Value* absl_nonnull result) const override {
+    CEL_RETURN_IF_ERROR(CheckMapKey(key));
+    auto string_key = key.AsString();
+    if (!string_key) {
+      return false;
+    }
+    std::string scratch;
+    if (const Value* value = Lookup(string_key->ToStringView(&scratch));
+        value != nullptr) {
+      *result = *value;
+      return true;
+    }
+    return false;
+  }
+
+  absl::StatusOr<bool> Has(
+      const Value& key,
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena) const override {
+    CEL_RETURN_IF_ERROR(CheckMapKey(key));
+    auto string_key = key.AsString();
+    if (!string_key) {
+      return false;
+    }
+    std::string scratch;
+    return Lookup(string_key->ToStringView(&scratch)) != nullptr;
+  }
+
+  NativeTypeId GetNativeTypeId() const override {
+    return NativeTypeId::For<StringMapValue>();
+  }
+
+  const Slot* absl_nonnull const slots_;
+  const size_t mask_;
+  const size_t* absl_nonnull const hashes_;
+  const absl::string_view* absl_nonnull const keys_;
+  Value* absl_nonnull const values_;
+  const size_t size_;
+  google::protobuf::Arena* absl_nonnull const arena_;
+};
+
+// Copies `keys` and `hashes` onto `arena`, moves `values` onto it and builds
+// the index. `keys` must be distinct and non-empty.
+CustomMapValue MakeStringCustomMapValue(absl::Span<const absl::string_view> keys,
+                                        absl::Span<const size_t> hashes,
+                                        absl::Span<Value> values,
+                                        google::protobuf::Arena* absl_nonnull arena) {
+  ABSL_DCHECK(!keys.empty());
+  ABSL_DCHECK_EQ(keys.size(), hashes.size());
+  ABSL_DCHECK_EQ(keys.size(), values.size());
+  const size_t size = keys.size();
+
+  size_t total_key_size = 0;
+  for (absl::string_view key : keys) {
+    total_key_size += key.size();
+  }
+  char* key_buffer =
+      total_key_size == 0
+          ? nullptr
+          : static_cast<char*>(arena->AllocateAligned(total_key_size, 1));
+  auto* key_views = static_cast<absl::string_view*>(arena->AllocateAligned(
+      sizeof(absl::string_view) * size, alignof(absl::string_view)));
+  for (size_t i = 0; i < size; ++i) {
+    if (!keys[i].empty()) {
+      std::memcpy(key_buffer, keys[i].data(), keys[i].size());
+    }
+    ::new (&key_views[i]) absl::string_view(key_buffer, keys[i].size());
+    key_buffer += keys[i].size();
+  }
+
+  auto* key_hashes = static_cast<size_t*>(
+      arena->AllocateAligned(sizeof(size_t) * size, alignof(size_t)));
+  std::memcpy(key_hashes, hashes.data(), sizeof(size_t) * size);
+
+  bool values_trivially_destructible = true;
+  auto* map_values = static_cast<Value*>(
+      arena->AllocateAligned(sizeof(Value) * size, alignof(Value)));
+  for (size_t i = 0; i < size; ++i) {
+    ::new (&map_values[i]) Value(std::move(values[i]));
+    values_trivially_destructible =
+        values_trivially_destructible &&
+        ArenaTraits<>::trivially_destructible(map_values[i]);
+  }
+
+  const size_t capacity = CapacityFor(size);
+  auto* slots = static_cast<Slot*>(
+      arena->AllocateAligned(sizeof(Slot) * capacity, alignof(Slot)));
+  std::memset(slots, 0, sizeof(Slot) * capacity);
+  for (size_t i = 0; i < size; ++i) {
+    slots[Probe(slots, capacity - 1, key_hashes, key_views, key_hashes[i],
+                key_views[i])] = static_cast<Slot>(i + 1);
+  }
+
+  auto* map = ::new (arena->AllocateAligned(sizeof(StringMapValue),
+                                            alignof(StringMapValue)))
+      StringMapValue(slots, capacity, key_hashes, key_views, map_values, size,
+                     arena);
+  if (!values_trivially_destructible) {
+    arena->OwnDestructor(map);
+  }
+  return CustomMapValue(map, arena);
+}
+
+// Collects entries while every key is a string, checking for duplicates with
+// the same open-addressed scheme as `StringMapValue`. The staging arrays live
+// on the heap so that growing them does not leave garbage on the arena.
+class StringMapValueBuilder final : public MapValueBuilder {
+ public:
+  explicit StringMapValueBuilder(google::protobuf::Arena* absl_nonnull arena)
+      : arena_(arena), slots_(kMinCapacity, 0) {}
+
+  absl::Status Put(Value key, Value value) override {
+    if (fallback_ == nullptr && !key.IsString()) {
+      CEL_RETURN_IF_ERROR(CheckMapKey(key));
+      Fallback();
+    }
+    if (fallback_ != nullptr) {
+      return fallback_->Put(std::move(key), std::move(value));
+    }
+    CEL_RETURN_IF_ERROR(CheckMapValue(value));
+    std::string scratch;
+    absl::string_view string_key = key.GetString().ToStringView(&scratch);
+    const size_t hash = StringHash(string_key);
+    const size_t index = Probe(slots_.data(), slots_.size() - 1,
+                               hashes_.data(), keys_, hash, string_key);
+    if (ABSL_PREDICT_FALSE(slots_[index] != 0)) {
+      return DuplicateKeyError().ToStatus();
+    }
+    Insert(index, hash, string_key, std::move(value));
+    return absl::OkStatus();
+  }
+
+  void UnsafePut(Value key, Value value) override {
+    if (fallback_ == nullptr && !key.IsString()) {
+      Fallback();
+    }
+    if (fallback_ != nullptr) {
+      fallback_->UnsafePut(std::move(key), std::move(value));
+      return;
+    }
+    std::string scratch;
+    absl::string_view string_key = key.GetString().ToStringView(&scratch);
+    const size_t hash = StringHash(string_key);
+    const size_t index = Probe(slots_.data(), slots_.size() - 1,
+                               hashes_.data(), keys_, hash, string_key);
+    ABSL_DCHECK_EQ(slots_[index], 0);
+    Insert(index, hash, string_key, std::move(value));
+  }
+
+  size_t Size() const override {
+    return fallback_ != nullptr ? fallback_->Size() : keys_.size();
+  }
+
+  void Reserve(size_t capacity) override {
+    if (fallback_ != nullptr) {
+      fallback_->Reserve(capacity);
+      return;
+    }
+    keys_.reserve(capacity);
+    hashes_.reserve(capacity);
+    values_.reserve(capacity);
+    if (CapacityFor(capacity) > slots_.size()) {
+      Rehash(CapacityFor(capacity));
+    }
+  }
+
+  MapValue Build() && override {
+    if (fallback_ != nullptr) {
+      return std::move(*fallback_).Build();
+    }
+    if (keys_.empty()) {
+      return MapValue();
+    }
+    std::vector<absl::string_view> keys(keys_.begin(), keys_.end());
+    return MakeStringCustomMapValue(keys, hashes_, absl::MakeSpan(values_),
+                                    arena_);
+  }
+
+ private:
+  void Insert(size_t index, size_t hash, absl::string_view key, Value value) {
+    keys_.emplace_back(key);
+    hashes_.push_back(hash);
+    values_.push_back(std::move(value));
+    slots_[index] = static_cast<Slot>(keys_.size());
+    if (CapacityFor(keys_.size()) > slots_.size()) {
+      Rehash(slots_.size() * 2);
+    }
+  }
+
+  void Rehash(size_t capacity) {
+    slots_.assign(capacity, 0);
+    for (size_t i = 0; i < keys_.size(); ++i) {
+      slots_[Probe(slots_.data(), capacity - 1, hashes_.data(), keys_,
+                   hashes_[i], keys_[i])] = static_cast<Slot>(i + 1);
+    }
+  }
+
+  // Moves the entries staged so far into a general map builder, which takes
+  // over from here on.
+  void Fallback() {
+    fallback_ = NewMapValueBuilder(arena_);
+    fallback_->Reserve(keys_.size());
+    for (size_t i = 0; i < keys_.size(); ++i) {
+      fallback_->UnsafePut(StringValue::From(std::move(keys_[i]), arena_),
+                           std::move(values_[i]));
+    }
+    keys_.clear();
+    hashes_.clear();
+    values_.clear();
+  }
+
+  google::protobuf::Arena* absl_nonnull const arena_;
+  std::vector<Slot> slots_;
+  std::vector<std::string> keys_;
+  std::vector<size_t> hashes_;
+  std::vector<Value> values_;
+  MapValueBuilderPtr fallback_;
+};
+
+}  // namespace
+
+absl_nonnull MapValueBuilderPtr
+NewStringMapValueBuilder(google::protobuf::Arena* absl_nonnull arena) {
+  ABSL_DCHECK(arena != nullptr);
+  return std::make_unique<StringMapValueBuilder>(arena);
+}
+
+absl::optional<const Value*> FindInStringMapValue(const MapValue& map,
+                                                  absl::string_view key) {
+  auto custom_map_value = map.AsCustom();
+  if (!custom_map_value ||
+      custom_map_value->GetTypeId() != NativeTypeId::For<StringMapValue>()) {
+    return absl::nullopt;
+  }
+  return cel::internal::down_cast<const StringMapValue*>(
+             custom_map_value->interface())
+      ->Lookup(key);
+}
+
+}  // namespace cel::common_internal
@@ -0,0 +1,50 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_COMMON_VALUES_STRING_MAP_VALUE_H_
+#define THIRD_PARTY_CEL_CPP_COMMON_VALUES_STRING_MAP_VALUE_H_
+
+#include "absl/base/nullability.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "common/value.h"
+#include "common/values/map_value_builder.h"
+#include "google/protobuf/arena.h"
+
+namespace cel::common_internal {
+
+// Returns a builder for maps which are specialized for string keys.
+//
+// As long as every key added is a string, `Build()` returns a map which keeps
+// the key bytes, their precomputed hashes and the values in separate arrays on
+// the arena, indexed by an open-addressed table. Lookups hash the key bytes
+// directly instead of dispatching on `Value`, and iteration follows insertion
+// order. Once a key of another kind is added, the builder falls back to
+// `NewMapValueBuilder()` and produces the same map it would.
+absl_nonnull MapValueBuilderPtr
+NewStringMapValueBuilder(google::protobuf::Arena* absl_nonnull arena);
+
+// Looks up `key` in `map` without constructing a `Value` for it.
+//
+// Returns `absl::nullopt` if `map` was not built by a builder from
+// `NewStringMapValueBuilder()`, in which case callers should use
+// `MapValue::Find()`. Otherwise returns a pointer to the value for `key`, or
+// `nullptr` if `map` does not contain `key`. The pointer is valid as long as
+// `map`.
+absl::optional<const Value*> FindInStringMapValue(
+    const MapValue& map, absl::string_view key);
+
+}  // namespace cel::common_internal
+
+#endif  // THIRD_PARTY_CEL_CPP_COMMON_VALUES_STRING_MAP_VALUE_H_
@@ -0,0 +1,184 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/values/string_map_value.h"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/types/optional.h"
+#include "common/value.h"
+#include "common/value_testing.h"
+#include "common/values/map_value_builder.h"
+#include "internal/testing.h"
+#include "google/protobuf/arena.h"
+
+namespace cel::common_internal {
+namespace {
+
+using ::absl_testing::IsOk;
+using ::absl_testing::IsOkAndHolds;
+using ::absl_testing::StatusIs;
+using ::cel::test::BoolValueIs;
+using ::cel::test::ErrorValueIs;
+using ::cel::test::IntValueIs;
+using ::cel::test::StringValueIs;
+using ::testing::ElementsAre;
+using ::testing::IsNull;
+using ::testing::Optional;
+using ::testing::Pointee;
+
+using StringMapValueTest = common_internal::ValueTest<>;
+
+TEST_F(StringMapValueTest, Find) {
+  auto builder = NewStringMapValueBuilder(arena());
+  ASSERT_THAT(builder->Put(StringValue("foo"), IntValue(1)), IsOk());
+  ASSERT_THAT(builder->Put(StringValue("bar"), IntValue(2)), IsOk());
+  ASSERT_THAT(builder->Put(StringValue(""), IntValue(3)), IsOk());
+  MapValue map = std::move(*builder).Build();
+
+  EXPECT_THAT(map.Size(), IsOkAndHolds(3));
+  EXPECT_THAT(map.Find(StringValue("bar"), descriptor_pool(),
+                       message_factory(), arena()),
+              IsOkAndHolds(Optional(IntValueIs(2))));
+  EXPECT_THAT(map.Find(StringValue("baz"), descriptor_pool(),
+                       message_factory(), arena()),
+              IsOkAndHolds(absl::nullopt));
+  EXPECT_THAT(map.Has(StringValue(""), descriptor_pool(), message_factory(),
+                      arena()),
+              IsOkAndHolds(BoolValueIs(true)));
+  EXPECT_THAT(map.Has(IntValue(1), descriptor_pool(), message_factory(),
+                      arena()),
+              IsOkAndHolds(BoolValueIs(false)));
+  EXPECT_THAT(
+      map.Get(StringValue("baz"), descriptor_pool(), message_factory(),
+              arena()),
+      IsOkAndHolds(ErrorValueIs(StatusIs(absl::StatusCode::kNotFound))));
+  EXPECT_THAT(map.Has(DoubleValue(1.0), descriptor_pool(), message_factory(),
+                      arena()),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST_F(StringMapValueTest, FindInStringMapValue) {
+  auto builder = NewStringMapValueBuilder(arena());
+  ASSERT_THAT(builder->Put(StringValue("foo"), IntValue(1)), IsOk());
+  MapValue map = std::move(*builder).Build();
+
+  EXPECT_THAT(FindInStringMapValue(map, "foo"),
+              Optional(Pointee(IntValueIs(1))));
+  EXPECT_THAT(FindInStringMapValue(map, "bar"), Optional(IsNull()));
+
+  auto other_builder = NewMapValueBuilder(arena());
+  ASSERT_THAT(other_builder->Put(StringValue("foo"), IntValue(1)), IsOk());
+  EXPECT_EQ(FindInStringMapValue(std::move(*other_builder).Build(), "foo"),
+            absl::nullopt);
+}
+
+TEST_F(StringMapValueTest, DuplicateKey) {
+  auto builder = NewStringMapValueBuilder(arena());
+  ASSERT_THAT(builder->Put(StringValue("foo"), IntValue(1)), IsOk());
+  EXPECT_THAT(builder->Put(StringValue("foo"), IntValue(2)),
+              StatusIs(absl::StatusCode::kAlreadyExists));
+}
+
+TEST_F(StringMapValueTest, Empty) {
+  auto builder = NewStringMapValueBuilder(arena());
+  MapValue map = std::move(*builder).Build();
+  EXPECT_THAT(map.IsEmpty(), IsOkAndHolds(true));
+  EXPECT_EQ(FindInStringMapValue(map, "foo"), absl::nullopt);
+}
+
+TEST_F(StringMapValueTest, Grow) {
+  constexpr int64_t kSize = 2000;
+  auto builder = NewStringMapValueBuilder(arena());
+  for (int64_t i = 0; i < kSize; ++i) {
+    ASSERT_THAT(builder->Put(StringValue(absl::StrCat("key", i)), IntValue(i)),
+                IsOk());
+  }
+  MapValue map = std::move(*builder).Build();
+  EXPECT_THAT(map.Size(), IsOkAndHolds(kSize));
+  for (int64_t i = 0; i < kSize; ++i) {
+    ASSERT_THAT(map.Get(StringValue(absl::StrCat("key", i)), descriptor_pool(),
+                        message_factory(), arena()),
+                IsOkAndHolds(IntValueIs(i)));
+  }
+}
+
+TEST_F(StringMapValueTest, FallsBackForOtherKeys) {
+  auto builder = NewStringMapValueBuilder(arena());
+  ASSERT_THAT(builder->Put(StringValue("foo"), IntValue(1)), IsOk());
+  ASSERT_THAT(builder->Put(IntValue(2), IntValue(2)), IsOk());
+  EXPECT_THAT(builder->Put(StringValue("foo"), IntValue(3)),
+              StatusIs(absl::StatusCode::kAlreadyExists));
+  EXPECT_EQ(builder->Size(), 2);
+  MapValue map = std::move(*builder).Build();
+  EXPECT_EQ(FindInStringMapValue(map, "foo"), absl::nullopt);
+  EXPECT_THAT(map.Get(StringValue("foo"), descriptor_pool(), message_factory(),
+                      arena()),
+              IsOkAndHolds(IntValueIs(1)));
+  EXPECT_THAT(map.Get(IntValue(2), descriptor_pool(), message_factory(),
+                      arena()),
+              IsOkAndHolds(IntValueIs(2)));
+}
+
+TEST_F(StringMapValueTest, InsertionOrder) {
+  auto builder = NewStringMapValueBuilder(arena());
+  ASSERT_THAT(builder->Put(StringValue("b"), StringValue("x")), IsOk());
+  ASSERT_THAT(builder->Put(StringValue("a"), StringValue("y")), IsOk());
+  MapValue map = std::move(*builder).Build();
+
+  EXPECT_EQ(map.DebugString(), "{\"b\": \"x\", \"a\": \"y\"}");
+  ASSERT_OK_AND_ASSIGN(
+      ListValue keys,
+      map.ListKeys(descriptor_pool(), message_factory(), arena()));
+  EXPECT_THAT(keys.Get(0, descriptor_pool(), message_factory(), arena()),
+              IsOkAndHolds(StringValueIs("b")));
+
+  ASSERT_OK_AND_ASSIGN(auto iterator, map.NewIterator());
+  std::vector<std::pair<std::string, std::string>> entries;
+  Value key;
+  Value value;
+  while (true) {
+    ASSERT_OK_AND_ASSIGN(bool ok, iterator->Next2(descriptor_pool(),
+                                                  message_factory(), arena(),
+                                                  &key, &value));
+    if (!ok) {
+      break;
+    }
+    entries.push_back(
+        {key.GetString().ToString(), value.GetString().ToString()});
+  }
+  EXPECT_THAT(entries,
+              ElementsAre(std::pair<std::string, std::string>{"b", "x"},
+                          std::pair<std::string, std::string>{"a", "y"}));
+}
+
+TEST_F(StringMapValueTest, Clone) {
+  auto builder = NewStringMapValueBuilder(arena());
+  ASSERT_THAT(builder->Put(StringValue("foo"), StringValue("bar")), IsOk());
+  MapValue map = std::move(*builder).Build();
+  google::protobuf::Arena other_arena;
+  Value clone = Value(map).Clone(&other_arena);
+  ASSERT_TRUE(clone.IsMap());
+  EXPECT_THAT(FindInStringMapValue(clone.GetMap(), "foo"),
+              Optional(Pointee(StringValueIs("bar"))));
+}
+
+}  // namespace
+}  // namespace cel::common_internal
@@ -31,6 +31,7 @@
 #include "absl/types/optional.h"
 #include "absl/types/span.h"
 #include "base/attribute.h"
+#include "common/native_type.h"
 #include "runtime/runtime_options.h"
 #include "google/protobuf/arena.h"
 #include "google/protobuf/descriptor.h"
@@ -129,6 +130,14 @@ class ValueIterator {
       const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
       google::protobuf::MessageFactory* absl_nonnull message_factory,
       google::protobuf::Arena* absl_nonnull arena);
+
+ private:
+  friend class CustomListValueInterface;
+  friend class CustomMapValueInterface;
+
+  // Identifies the default iterators of custom lists and maps, which their
+  // interfaces need to recognize. Other iterators have no identity.
+  virtual NativeTypeId GetNativeTypeId() const { return NativeTypeId(); }
 };
 
 namespace common_internal {
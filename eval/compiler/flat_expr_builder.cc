@@ -59,6 +59,7 @@
 #include "common/kind.h"
 #include "common/type.h"
 #include "common/value.h"
+#include "common/values/constant_map_value.h"
 #include "eval/compiler/flat_expr_builder_extensions.h"
 #include "eval/compiler/resolver.h"
 #include "eval/eval/comprehension_step.h"
@@ -81,12 +82,14 @@
 #include "eval/eval/ternary_step.h"
 #include "eval/eval/trace_step.h"
 #include "internal/status_macros.h"
+#include "runtime/generated_message_accessors.h"
 #include "runtime/internal/convert_constant.h"
 #include "runtime/internal/issue_collector.h"
 #include "runtime/runtime_issue.h"
 #include "runtime/runtime_options.h"
 #include "runtime/type_registry.h"
 #include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor.h"
 
 namespace google::api::expr::runtime {
 
@@ -280,14 +283,104 @@ size_t SizeHint(const cel::Expr& expr) {
   return 0;
 }
 
-// Returns whether this comprehension appears to be a standard map/filter
-// macro implementation. It is not exhaustive, so it is unsafe to use with
-// custom comprehensions outside of the standard macros or hand crafted ASTs.
-bool IsOptimizableListAppend(const cel::ComprehensionExpr* comprehension,
-                             bool enable_comprehension_list_append) {
-  if (!enable_comprehension_list_append) {
+bool IsAccuIdent(const cel::Expr& expr, absl::string_view accu_var) {
+  return expr.has_ident_expr() && expr.ident_expr().name() == accu_var;
+}
+
+// Returns whether `expr` contains any reference to the identifier `name`.
+//
+// Shadowing by nested comprehensions is not considered, so this may report
+// false positives.
+bool ReferencesIdent(const cel::Expr& expr, absl::string_view name) {
+  std::vector<const cel::Expr*> stack = {&expr};
+  while (!stack.empty()) {
+    const cel::Expr* next = stack.back();
+    stack.pop_back();
+    switch (next->kind_case()) {
+      case cel::ExprKindCase::kIdentExpr:
+        if (next->ident_expr().name() == name) {
+          return true;
+        }
+        break;
+      case cel::ExprKindCase::kSelectExpr:
+        stack.push_back(&next->select_expr().operand());
+        break;
+      case cel::ExprKindCase::kCallExpr:
+        if (next->call_expr().has_target()) {
+          stack.push_back(&next->call_expr().target());
+        }
+        for (const auto& arg : next->call_expr().args()) {
+          stack.push_back(&arg);
+        }
+        break;
+      case cel::ExprKindCase::kListExpr:
+        for (const auto& element : next->list_expr().elements()) {
+          stack.push_back(&element.expr());
+        }
+        break;
+      case cel::ExprKindCase::kStructExpr:
+        for (const auto& field : next->struct_expr().fields()) {
+          stack.push_back(&field.value());
+        }
+        break;
+      case cel::ExprKindCase::kMapExpr:
+        for (const auto& entry : next->map_expr().entries()) {
+          stack.push_back(&entry.key());
+          stack.push_back(&entry.value());
+        }
+        break;
+      case cel::ExprKindCase::kComprehensionExpr: {
+        const auto& comprehension = next->comprehension_expr();
+        stack.push_back(&comprehension.iter_range());
+        stack.push_back(&comprehension.accu_init());
+        stack.push_back(&comprehension.loop_condition());
+        stack.push_back(&comprehension.loop_step());
+        stack.push_back(&comprehension.result());
+        break;
+      }
+      default:
+        break;
+    }
+  }
+  return false;
+}
+
+// Returns whether the accumulator of a list or map building comprehension is
+// only referenced where the standard macros place it: the updated operand of
+// the loop step, the untaken branch of a filtering ternary and the result.
+//
+// If so, the intermediate accumulator can't escape or alias a value observable
+// by the rest of the expression, so it is safe to update it in place.
+bool IsAccuVarContained(const cel::ComprehensionExpr* comprehension) {
+  absl::string_view accu_var = comprehension->accu_var();
+  if (ReferencesIdent(comprehension->loop_condition(), accu_var)) {
     return false;
   }
+  const cel::CallExpr* update_call = &comprehension->loop_step().call_expr();
+  if (update_call->function() == cel::builtin::kTernary &&
+      update_call->args().size() == 3) {
+    if (ReferencesIdent(update_call->args()[0], accu_var) ||
+        !IsAccuIdent(update_call->args()[2], accu_var)) {
+      return false;
+    }
+    update_call = &update_call->args()[1].call_expr();
+  }
+  if (update_call->has_target()) {
+    return false;
+  }
+  for (size_t i = 1; i < update_call->args().size(); ++i) {
+    if (ReferencesIdent(update_call->args()[i], accu_var)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns whether this comprehension appears to be a standard map/filter
+// macro implementation. It is not exhaustive, so it is unsafe to use with
+// custom comprehensions outside of the standard macros or hand crafted ASTs
+// unless the accumulator is also checked with `IsAccuVarContained()`.
+bool IsListAppendComprehension(const cel::ComprehensionExpr* comprehension) {
   absl::string_view accu_var = comprehension->accu_var();
   if (accu_var.empty() ||
       comprehension->result().ident_expr().name() != accu_var) {
@@ -324,12 +417,11 @@ bool IsOptimizableListAppend(const cel::ComprehensionExpr* comprehension,
          call_expr->args()[1].list_expr().elements().size() == 1;
 }
 
-// Assuming `IsOptimizableListAppend()` return true, return a pointer to the
+// Assuming `IsListAppendComprehension()` return true, return a pointer to the
 // call `accu_var + [elem]`.
 const cel::CallExpr* GetOptimizableListAppendCall(
     const cel::ComprehensionExpr* comprehension) {
-  ABSL_DCHECK(IsOptimizableListAppend(
-      comprehension, /*enable_comprehension_list_append=*/true));
+  ABSL_DCHECK(IsListAppendComprehension(comprehension));
 
   // Macro loop_step for a filter() will contain a ternary:
   //   filter ? accu_var + [elem] : accu_var
@@ -351,14 +443,30 @@ const cel::Expr* GetOptimizableListAppendOperand(
   return &GetOptimizableListAppendCall(comprehension)->args()[1];
 }
 
-// Returns whether this comprehension appears to be a macro implementation for
-// map transformations. It is not exhaustive, so it is unsafe to use with custom
-// comprehensions outside of the standard macros or hand crafted ASTs.
-bool IsOptimizableMapInsert(const cel::ComprehensionExpr* comprehension,
-                            bool enable_comprehension_mutable_map) {
-  if (!enable_comprehension_mutable_map) {
+// Returns whether the accumulator of a map/filter comprehension can be built
+// with an in-place list append.
+//
+// `enable_comprehension_list_append` opts in every comprehension with the
+// macro shape, including hand crafted ASTs. Otherwise the accumulator must be
+// provably contained.
+bool IsOptimizableListAppend(const cel::ComprehensionExpr* comprehension,
+                             const cel::RuntimeOptions& options) {
+  if (!IsListAppendComprehension(comprehension)) {
     return false;
   }
+  if (options.enable_comprehension_list_append) {
+    return true;
+  }
+  // `accu + [elem]` only has the list append semantics if list concatenation
+  // is available.
+  return options.enable_list_concat && IsAccuVarContained(comprehension);
+}
+
+// Returns whether this comprehension appears to be a macro implementation for
+// map transformations. It is not exhaustive, so it is unsafe to use with custom
+// comprehensions outside of the standard macros or hand crafted ASTs unless
+// the accumulator is also checked with `IsAccuVarContained()`.
+bool IsMapInsertComprehension(const cel::ComprehensionExpr* comprehension) {
   if (comprehension->iter_var().empty() || comprehension->iter_var2().empty()) {
     return false;
   }
@@ -389,6 +497,25 @@ bool IsOptimizableMapInsert(const cel::ComprehensionExpr* comprehension,
          call_expr->args()[0].ident_expr().name() == accu_var;
 }
 
+// Returns whether the accumulator of a map transformation comprehension can be
+// built with an in-place map insert.
+//
+// `enable_comprehension_mutable_map` opts in every comprehension with the
+// macro shape, including hand crafted ASTs. Otherwise the accumulator must be
+// provably contained and start out empty, since the mutable map replaces the
+// initializer.
+bool IsOptimizableMapInsert(const cel::ComprehensionExpr* comprehension,
+                            const cel::RuntimeOptions& options) {
+  if (!IsMapInsertComprehension(comprehension)) {
+    return false;
+  }
+  if (options.enable_comprehension_mutable_map) {
+    return true;
+  }
+  return comprehension->accu_init().map_expr().entries().empty() &&
+         IsAccuVarContained(comprehension);
+}
+
 bool IsBind(const cel::ComprehensionExpr* comprehension) {
   static constexpr absl::string_view kUnusedIterVar = "#unused";
 
@@ -402,6 +529,101 @@ bool IsBind(const cel::ComprehensionExpr* comprehension) {
 
 bool IsBlock(const cel::CallExpr* call) { return call->function() == kBlock; }
 
+// Standard macro shapes that are planned as a fused loop step instead of the
+// generic comprehension steps.
+enum class FusedComprehensionKind {
+  kNone,
+  // all(): accu_init = true, step = accu && pred.
+  kAll,
+  // exists(): accu_init = false, step = accu || pred.
+  kExists,
+  // map() and filter(): step = accu + [elem] or pred ? accu + [elem] : accu.
+  kList,
+};
+
+// Returns whether the loop condition is `@not_strictly_false(accu_var)`
+// (negate=false) or `@not_strictly_false(!accu_var)` (negate=true).
+bool IsQuantifierCondition(const cel::Expr& condition,
+                           absl::string_view accu_var, bool negate) {
+  if (!condition.has_call_expr() ||
+      condition.call_expr().function() != cel::builtin::kNotStrictlyFalse ||
+      condition.call_expr().has_target() ||
+      condition.call_expr().args().size() != 1) {
+    return false;
+  }
+  const cel::Expr* operand = &condition.call_expr().args()[0];
+  if (negate) {
+    if (!operand->has_call_expr() ||
+        operand->call_expr().function() != cel::builtin::kNot ||
+        operand->call_expr().has_target() ||
+        operand->call_expr().args().size() != 1) {
+      return false;
+    }
+    operand = &operand->call_expr().args()[0];
+  }
+  return IsAccuIdent(*operand, accu_var);
+}
+
+// Returns the fused plan shape for a comprehension generated by one of the
+// standard all(), exists(), map() or filter() macros.
+//
+// The shape is matched exactly and the user supplied subexpressions must not
+// reference the accumulator, so hand crafted ASTs that match evaluate the
+// same way. map() and filter() additionally require the list append
+// optimization to be enabled since the fused step bypasses `_+_`.
+FusedComprehensionKind GetFusedComprehensionKind(
+    const cel::ComprehensionExpr* comprehension,
+    bool is_optimizable_list_append) {
+  absl::string_view accu_var = comprehension->accu_var();
+  if (accu_var.empty() || !comprehension->iter_var2().empty() ||
+      !IsAccuIdent(comprehension->result(), accu_var) ||
+      !comprehension->loop_step().has_call_expr()) {
+    return FusedComprehensionKind::kNone;
+  }
+  const cel::CallExpr& loop_step = comprehension->loop_step().call_expr();
+
+  if (is_optimizable_list_append) {
+    const cel::Expr& condition = comprehension->loop_condition();
+    if (!condition.has_const_expr() ||
+        !condition.const_expr().has_bool_value() ||
+        !condition.const_expr().bool_value()) {
+      return FusedComprehensionKind::kNone;
+    }
+    if (loop_step.function() == cel::builtin::kTernary &&
+        (!IsAccuIdent(loop_step.args()[2], accu_var) ||
+         ReferencesIdent(loop_step.args()[0], accu_var))) {
+      return FusedComprehensionKind::kNone;
+    }
+    const cel::ListExpr& append_operand =
+        GetOptimizableListAppendOperand(comprehension)->list_expr();
+    if (append_operand.elements()[0].optional() ||
+        ReferencesIdent(append_operand.elements()[0].expr(), accu_var)) {
+      return FusedComprehensionKind::kNone;
+    }
+    return FusedComprehensionKind::kList;
+  }
+
+  const cel::Expr& accu_init = comprehension->accu_init();
+  if (!accu_init.has_const_expr() || !accu_init.const_expr().has_bool_value() ||
+      loop_step.has_target() || loop_step.args().size() != 2 ||
+      !IsAccuIdent(loop_step.args()[0], accu_var) ||
+      ReferencesIdent(loop_step.args()[1], accu_var)) {
+    return FusedComprehensionKind::kNone;
+  }
+  const bool init = accu_init.const_expr().bool_value();
+  if (init && loop_step.function() == cel::builtin::kAnd &&
+      IsQuantifierCondition(comprehension->loop_condition(), accu_var,
+                            /*negate=*/false)) {
+    return FusedComprehensionKind::kAll;
+  }
+  if (!init && loop_step.function() == cel::builtin::kOr &&
+      IsQuantifierCondition(comprehension->loop_condition(), accu_var,
+                            /*negate=*/true)) {
+    return FusedComprehensionKind::kExists;
+  }
+  return FusedComprehensionKind::kNone;
+}
+
 // Visitor for Comprehension expressions.
 class ComprehensionVisitor {
  public:
@@ -506,10 +728,12 @@ class FlatExprVisitor : public cel::AstVisitor {
       const Resolver& resolver, const cel::RuntimeOptions& options,
       std::vector<std::unique_ptr<ProgramOptimizer>> program_optimizers,
       const absl::flat_hash_map<int64_t, cel::Reference>& reference_map,
+      const cel::Ast::TypeMap& type_map, const cel::TypeRegistry& type_registry,
       const cel::TypeProvider& type_provider, IssueCollector& issue_collector,
       ProgramBuilder& program_builder, PlannerContext& extension_context,
       bool enable_optional_types)
       : resolver_(resolver),
+        type_registry_(type_registry),
         type_provider_(type_provider),
         progress_status_(absl::OkStatus()),
         resolved_select_expr_(nullptr),
@@ -518,6 +742,7 @@ class FlatExprVisitor : public cel::AstVisitor {
         issue_collector_(issue_collector),
         program_builder_(program_builder),
         extension_context_(extension_context),
+        type_map_(type_map),
         enable_optional_types_(enable_optional_types) {
     constexpr size_t kCallHandlerSizeHint = 11;
     call_handlers_.reserve(kCallHandlerSizeHint);
@@ -933,6 +1158,15 @@ class FlatExprVisitor : public cel::AstVisitor {
       return;
     }
 
+    const google::protobuf::FieldDescriptor* field_descriptor =
+        ResolveSelectField(select_expr);
+    const cel::GeneratedFieldAccessor* field_accessor =
+        field_descriptor != nullptr
+            ? type_registry_.FindGeneratedFieldAccessor(
+                  field_descriptor->containing_type()->full_name(),
+                  field_descriptor->number())
+            : nullptr;
+
     auto depth = RecursionEligible();
     if (depth.has_value()) {
       auto deps = ExtractRecursiveDependencies();
@@ -947,14 +1181,37 @@ class FlatExprVisitor : public cel::AstVisitor {
           CreateDirectSelectStep(std::move(deps[0]), std::move(field),
                                  select_expr.test_only(), expr.id(),
                                  options_.enable_empty_wrapper_null_unboxing,
-                                 enable_optional_types_),
+                                 enable_optional_types_, field_descriptor,
+                                 field_accessor),
           *depth + 1);
       return;
     }
 
     AddStep(CreateSelectStep(select_expr, expr.id(),
                              options_.enable_empty_wrapper_null_unboxing,
-                             enable_optional_types_));
+                             enable_optional_types_, field_descriptor,
+                             field_accessor));
+  }
+
+  // Returns the descriptor of the field selected by `select_expr` if the type
+  // checker resolved its operand to a message type known to the environment,
+  // so that the select step does not need to look the field up by name.
+  const google::protobuf::FieldDescriptor* absl_nullable ResolveSelectField(
+      const cel::SelectExpr& select_expr) const {
+    if (!select_expr.has_operand()) {
+      return nullptr;
+    }
+    auto it = type_map_.find(select_expr.operand().id());
+    if (it == type_map_.end() || !it->second.has_message_type()) {
+      return nullptr;
+    }
+    const google::protobuf::Descriptor* descriptor =
+        extension_context_.descriptor_pool()->FindMessageTypeByName(
+            it->second.message_type().type());
+    if (descriptor == nullptr) {
+      return nullptr;
+    }
+    return descriptor->FindFieldByName(select_expr.field());
   }
 
   // Call node handler group.
@@ -1131,6 +1388,9 @@ class FlatExprVisitor : public cel::AstVisitor {
           "unexpected number of args for builtin boolean operator &&/||"));
       return;
     }
+    if (MaybeDeferFusedLoopStep(expr)) {
+      return;
+    }
     const cel::Expr* left_expr = &expr->call_expr().args()[0];
     const cel::Expr* right_expr = &expr->call_expr().args()[1];
 
@@ -1235,6 +1495,37 @@ class FlatExprVisitor : public cel::AstVisitor {
         result_depth + 1);
   }
 
+  // Returns true if planning `expr` should be skipped because it is the loop
+  // step (or the list append within a filter() loop step) of a comprehension
+  // that will be planned as a fused step.
+  //
+  // Only taken when the fused step is known to be plannable recursively so the
+  // partially planned loop step is always replaced.
+  bool MaybeDeferFusedLoopStep(const cel::Expr* expr) {
+    if (options_.max_recursion_depth == 0 || !options_.short_circuiting ||
+        comprehension_stack_.empty()) {
+      return false;
+    }
+    ComprehensionStackRecord& record = comprehension_stack_.back();
+    if (record.fused_kind == FusedComprehensionKind::kNone) {
+      return false;
+    }
+    const cel::Expr* loop_step = &record.comprehension->loop_step();
+    if (record.fused_loop_step_deferred) {
+      return expr == loop_step;
+    }
+    const cel::Expr* deferred_node = loop_step;
+    if (record.fused_kind == FusedComprehensionKind::kList &&
+        loop_step->call_expr().function() == cel::builtin::kTernary) {
+      deferred_node = &loop_step->call_expr().args()[1];
+    }
+    if (expr != deferred_node || !FusedComprehensionDepth(record).has_value()) {
+      return false;
+    }
+    record.fused_loop_step_deferred = true;
+    return true;
+  }
+
   void MaybeMakeComprehensionRecursive(
       const cel::Expr* expr, const cel::ComprehensionExpr* comprehension,
       size_t iter_slot, size_t iter2_slot, size_t accu_slot) {
@@ -1242,6 +1533,13 @@ class FlatExprVisitor : public cel::AstVisitor {
       return;
     }
 
+    if (!comprehension_stack_.empty() &&
+        comprehension_stack_.back().comprehension == comprehension &&
+        comprehension_stack_.back().fused_loop_step_deferred) {
+      MakeFusedComprehensionRecursive(expr, comprehension_stack_.back());
+      return;
+    }
+
     auto* accu_plan =
         program_builder_.GetSubexpression(&comprehension->accu_init());
 
@@ -1401,16 +1699,21 @@ class FlatExprVisitor : public cel::AstVisitor {
       // If no bind init subexpression, account normally.
     }
 
+    bool is_optimizable_list_append =
+        IsOptimizableListAppend(&comprehension, options_);
+
     comprehension_stack_.push_back(
         {&expr, &comprehension, iter_slot, iter2_slot, accu_slot, slot_count,
          /*subexpression=*/-1,
-         /*.is_optimizable_list_append=*/
-         IsOptimizableListAppend(&comprehension,
-                                 options_.enable_comprehension_list_append),
+         /*.is_optimizable_list_append=*/is_optimizable_list_append,
          /*.is_optimizable_map_insert=*/
-         IsOptimizableMapInsert(&comprehension,
-                                options_.enable_comprehension_mutable_map),
+         IsOptimizableMapInsert(&comprehension, options_),
          /*.is_optimizable_bind=*/is_bind,
+         /*.fused_kind=*/
+         is_bind ? FusedComprehensionKind::kNone
+                 : GetFusedComprehensionKind(&comprehension,
+                                             is_optimizable_list_append),
+         /*.fused_loop_step_deferred=*/false,
          /*.iter_var_in_scope=*/false,
          /*.iter_var2_in_scope=*/false,
          /*.accu_var_in_scope=*/false,
@@ -1574,11 +1877,13 @@ class FlatExprVisitor : public cel::AstVisitor {
         return;
       }
       auto step = CreateDirectListStep(
-          std::move(deps), MakeOptionalIndicesSet(list_expr), expr.id());
+          std::move(deps), MakeOptionalIndicesSet(list_expr), expr.id(),
+          options_.enable_unboxed_primitive_lists);
       SetRecursiveStep(std::move(step), *depth + 1);
       return;
     }
-    AddStep(CreateCreateListStep(list_expr, expr.id()));
+    AddStep(CreateCreateListStep(list_expr, expr.id(),
+                                 options_.enable_unboxed_primitive_lists));
   }
 
   // CreateStruct node handler.
@@ -1620,6 +1925,59 @@ class FlatExprVisitor : public cel::AstVisitor {
                                    expr.id()));
   }
 
+  // Builds a map literal whose keys and values are all literals once, at plan
+  // time, replacing the steps planned for its entries with a constant. Returns
+  // false if the map should be created at evaluation time instead, including
+  // when creating it would fail, so that the error surfaces as usual.
+  bool PlanConstantMap(const cel::Expr& expr, const cel::MapExpr& map_expr) {
+    if (map_expr.entries().empty()) {
+      return false;
+    }
+    std::vector<std::pair<cel::Value, cel::Value>> entries;
+    entries.reserve(map_expr.entries().size());
+    for (const auto& entry : map_expr.entries()) {
+      if (entry.optional() || !entry.key().has_const_expr() ||
+          !entry.value().has_const_expr()) {
+        return false;
+      }
+      absl::StatusOr<cel::Value> key =
+          ConvertConstant(entry.key().const_expr(), cel::NewDeleteAllocator());
+      absl::StatusOr<cel::Value> value = ConvertConstant(
+          entry.value().const_expr(), cel::NewDeleteAllocator());
+      if (!key.ok() || !value.ok()) {
+        return false;
+      }
+      entries.push_back({*std::move(key), *std::move(value)});
+    }
+    absl::StatusOr<cel::MapValue> map =
+        cel::common_internal::MakeConstantMapValue(
+            entries, extension_context_.MutableArena());
+    if (!map.ok()) {
+      return false;
+    }
+
+    absl::Status status;
+    if (options_.max_recursion_depth != 0) {
+      status = extension_context_.ReplaceSubplan(
+          expr, CreateConstValueDirectStep(*std::move(map), expr.id()), 1);
+    } else {
+      absl::StatusOr<std::unique_ptr<ExpressionStep>> step =
+          CreateConstValueStep(*std::move(map), expr.id(),
+                               /*comes_from_ast=*/false);
+      if (!step.ok()) {
+        SetProgressStatusError(step.status());
+        return true;
+      }
+      ExecutionPath path;
+      path.push_back(*std::move(step));
+      status = extension_context_.ReplaceSubplan(expr, std::move(path));
+    }
+    if (!status.ok()) {
+      SetProgressStatusError(status);
+    }
+    return true;
+  }
+
   void PostVisitMap(const cel::Expr& expr,
                     const cel::MapExpr& map_expr) override {
     for (const auto& entry : map_expr.entries()) {
@@ -1642,6 +2000,11 @@ class FlatExprVisitor : public cel::AstVisitor {
       }
     }
 
+    if (options_.enable_constant_map_literals &&
+        PlanConstantMap(expr, map_expr)) {
+      return;
+    }
+
     auto depth = RecursionEligible();
     if (depth.has_value()) {
       auto deps = ExtractRecursiveDependencies();
@@ -1651,13 +2014,14 @@ class FlatExprVisitor : public cel::AstVisitor {
         return;
       }
       auto step = CreateDirectCreateMapStep(
-          std::move(deps), MakeOptionalIndicesSet(map_expr), expr.id());
+          std::move(deps), MakeOptionalIndicesSet(map_expr), expr.id(),
+          options_.enable_string_keyed_maps);
       SetRecursiveStep(std::move(step), *depth + 1);
       return;
     }
-    AddStep(CreateCreateStructStepForMap(map_expr.entries().size(),
-                                         MakeOptionalIndicesSet(map_expr),
-                                         expr.id()));
+    AddStep(CreateCreateStructStepForMap(
+        map_expr.entries().size(), MakeOptionalIndicesSet(map_expr), expr.id(),
+        options_.enable_string_keyed_maps));
   }
 
   absl::Status progress_status() const { return progress_status_; }
@@ -1825,6 +2189,10 @@ class FlatExprVisitor : public cel::AstVisitor {
     bool is_optimizable_list_append;
     bool is_optimizable_map_insert;
     bool is_optimizable_bind;
+    FusedComprehensionKind fused_kind;
+    // Set when the loop step was left unplanned so its operands can be used
+    // by a fused comprehension step.
+    bool fused_loop_step_deferred;
     bool iter_var_in_scope;
     bool iter_var2_in_scope;
     bool accu_var_in_scope;
@@ -1868,6 +2236,81 @@ class FlatExprVisitor : public cel::AstVisitor {
     return resume_from_suppressed_branch_ != nullptr;
   }
 
+  // Returns the max depth of the subexpressions used by the fused step for
+  // the comprehension, or nullopt if any of them isn't recursively planned.
+  absl::optional<int> FusedComprehensionDepth(
+      const ComprehensionStackRecord& record) {
+    const cel::ComprehensionExpr* comprehension = record.comprehension;
+    const cel::CallExpr& loop_step = comprehension->loop_step().call_expr();
+    std::vector<const cel::Expr*> operands = {&comprehension->iter_range()};
+    if (record.fused_kind == FusedComprehensionKind::kList) {
+      if (loop_step.function() == cel::builtin::kTernary) {
+        operands.push_back(&loop_step.args()[0]);
+      }
+      operands.push_back(GetOptimizableListAppendOperand(comprehension));
+    } else {
+      operands.push_back(&loop_step.args()[1]);
+    }
+
+    int max_depth = 0;
+    for (const cel::Expr* operand : operands) {
+      auto* plan = program_builder_.GetSubexpression(operand);
+      if (plan == nullptr || !plan->IsRecursive()) {
+        return absl::nullopt;
+      }
+      max_depth = std::max(max_depth, plan->recursive_program().depth);
+    }
+    if (options_.max_recursion_depth > 0 &&
+        max_depth >= options_.max_recursion_depth) {
+      return absl::nullopt;
+    }
+    return max_depth;
+  }
+
+  void MakeFusedComprehensionRecursive(const cel::Expr* expr,
+                                       const ComprehensionStackRecord& record) {
+    absl::optional<int> depth = FusedComprehensionDepth(record);
+    if (!depth.has_value()) {
+      SetProgressStatusError(
+          absl::InternalError("unexpected plan for fused comprehension"));
+      return;
+    }
+    const cel::ComprehensionExpr* comprehension = record.comprehension;
+    const cel::CallExpr& loop_step = comprehension->loop_step().call_expr();
+    auto range = program_builder_.GetSubexpression(&comprehension->iter_range())
+                     ->ExtractRecursiveProgram()
+                     .step;
+
+    if (record.fused_kind == FusedComprehensionKind::kList) {
+      std::unique_ptr<DirectExpressionStep> filter;
+      if (loop_step.function() == cel::builtin::kTernary) {
+        filter = program_builder_.GetSubexpression(&loop_step.args()[0])
+                     ->ExtractRecursiveProgram()
+                     .step;
+      }
+      auto element = program_builder_
+                         .GetSubexpression(
+                             GetOptimizableListAppendOperand(comprehension))
+                         ->ExtractRecursiveProgram()
+                         .step;
+      SetRecursiveStep(CreateDirectListComprehensionStep(
+                           record.iter_slot, std::move(range),
+                           std::move(filter), std::move(element), expr->id()),
+                       *depth + 1);
+      return;
+    }
+
+    auto predicate = program_builder_.GetSubexpression(&loop_step.args()[1])
+                         ->ExtractRecursiveProgram()
+                         .step;
+    SetRecursiveStep(
+        CreateDirectQuantifierComprehensionStep(
+            record.iter_slot, std::move(range), std::move(predicate),
+            record.fused_kind == FusedComprehensionKind::kAll,
+            options_.enable_comprehension_chain_shortcircuit, expr->id()),
+        *depth + 1);
+  }
+
   absl::Status MaybeExtractSubexpression(const cel::Expr* expr,
                                          ComprehensionStackRecord& record) {
     if (!record.is_optimizable_bind) {
@@ -1943,6 +2386,7 @@ class FlatExprVisitor : public cel::AstVisitor {
                                                   const cel::CallExpr& call);
 
   const Resolver& resolver_;
+  const cel::TypeRegistry& type_registry_;
   const cel::TypeProvider& type_provider_;
   absl::Status progress_status_;
   absl::flat_hash_map<std::string, CallHandler> call_handlers_;
@@ -1967,6 +2411,7 @@ class FlatExprVisitor : public cel::AstVisitor {
 
   ProgramBuilder& program_builder_;
   PlannerContext extension_context_;
+  const cel::Ast::TypeMap& type_map_;
   IndexManager index_manager_;
 
   bool enable_optional_types_;
@@ -2115,8 +2560,10 @@ FlatExprVisitor::CallHandlerResult FlatExprVisitor::HandleListAppend(
     // Macro loop_step for a map() will contain a list concat operation:
     //   accu_var + [elem]
     if (&loop_step == &expr) {
-      AddResolvedFunctionStep(&call_expr, &expr,
-                              cel::builtin::kRuntimeListAppend);
+      if (!MaybeDeferFusedLoopStep(&expr)) {
+        AddResolvedFunctionStep(&call_expr, &expr,
+                                cel::builtin::kRuntimeListAppend);
+      }
       return CallHandlerResult::kIntercepted;
     }
     // Macro loop_step for a filter() will contain a ternary:
@@ -2125,8 +2572,10 @@ FlatExprVisitor::CallHandlerResult FlatExprVisitor::HandleListAppend(
         loop_step.call_expr().function() == cel::builtin::kTernary &&
         loop_step.call_expr().args().size() == 3 &&
         &(loop_step.call_expr().args()[1]) == &expr) {
-      AddResolvedFunctionStep(&call_expr, &expr,
-                              cel::builtin::kRuntimeListAppend);
+      if (!MaybeDeferFusedLoopStep(&expr)) {
+        AddResolvedFunctionStep(&call_expr, &expr,
+                                cel::builtin::kRuntimeListAppend);
+      }
       return CallHandlerResult::kIntercepted;
     }
   }
@@ -2572,7 +3021,8 @@ absl::StatusOr<FlatExpression> FlatExprBuilder::CreateExpressionImpl(
   // These objects are expected to remain scoped to one build call -- references
   // to them shouldn't be persisted in any part of the result expression.
   FlatExprVisitor visitor(resolver, options_, std::move(optimizers),
-                          ast->reference_map(), GetTypeProvider(),
+                          ast->reference_map(), ast->type_map(),
+                          type_registry_, GetTypeProvider(),
                           issue_collector, program_builder, extension_context,
                           enable_optional_types_);
 
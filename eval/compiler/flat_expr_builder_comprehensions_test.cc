@@ -14,15 +14,22 @@
  * limitations under the License.
  */
 
+#include <memory>
+#include <utility>
 #include <vector>
 
 #include "cel/expr/syntax.pb.h"
 #include "google/protobuf/field_mask.pb.h"
 #include "absl/status/status.h"
 #include "absl/strings/string_view.h"
+#include "common/ast.h"
+#include "common/native_type.h"
 #include "eval/compiler/cel_expression_builder_flat_impl.h"
 #include "eval/compiler/comprehension_vulnerability_check.h"
 #include "eval/compiler/flat_expr_builder.h"
+#include "eval/eval/comprehension_step.h"
+#include "eval/eval/direct_expression_step.h"
+#include "eval/eval/evaluator_core.h"
 #include "eval/public/activation.h"
 #include "eval/public/builtin_func_registrar.h"
 #include "eval/public/cel_attribute.h"
@@ -32,7 +39,10 @@
 #include "eval/public/containers/container_backed_list_impl.h"
 #include "eval/public/testing/matchers.h"
 #include "eval/testutil/test_message.pb.h"
+#include "extensions/protobuf/ast_converters.h"
+#include "internal/casts.h"
 #include "internal/testing.h"
+#include "parser/options.h"
 #include "parser/parser.h"
 #include "runtime/internal/runtime_env_testing.h"
 #include "runtime/runtime_options.h"
@@ -44,10 +54,12 @@ namespace google::api::expr::runtime {
 namespace {
 
 using ::absl_testing::StatusIs;
+using ::cel::ParserOptions;
 using ::cel::runtime_internal::NewTestingRuntimeEnv;
 using ::cel::expr::CheckedExpr;
 using ::cel::expr::ParsedExpr;
 using ::testing::HasSubstr;
+using ::testing::SizeIs;
 
 class CelExpressionBuilderFlatImplComprehensionsTest
     : public testing::TestWithParam<bool> {
@@ -84,6 +96,45 @@ TEST_P(CelExpressionBuilderFlatImplComprehensionsTest, NestedComp) {
   EXPECT_THAT(*result.ListOrDie(), testing::SizeIs(2));
 }
 
+// The standard macros are planned as fused loop steps only when planning
+// recursively.
+TEST_P(CelExpressionBuilderFlatImplComprehensionsTest, PlansFusedMacroSteps) {
+  cel::RuntimeOptions options = GetRuntimeOptions();
+  CelExpressionBuilderFlatImpl builder(NewTestingRuntimeEnv(), options);
+  ASSERT_OK(RegisterBuiltinFunctions(builder.GetRegistry()));
+
+  for (absl::string_view expr : {
+           "[1, 2].all(x, x > 0)",
+           "[1, 2].exists(x, x > 1)",
+           "[1, 2].map(x, x * 2)",
+           "[1, 2].map(x, x > 1, x * 2)",
+           "[1, 2].filter(x, x > 1)",
+           "[1, 2].map(x, x * 2).filter(y, y > 2).exists(z, z == 4)",
+       }) {
+    SCOPED_TRACE(expr);
+    ASSERT_OK_AND_ASSIGN(ParsedExpr parsed_expr, parser::Parse(expr));
+    ASSERT_OK_AND_ASSIGN(std::unique_ptr<cel::Ast> ast,
+                         cel::extensions::CreateAstFromParsedExpr(parsed_expr));
+    ASSERT_OK_AND_ASSIGN(FlatExpression plan,
+                         builder.flat_expr_builder().CreateExpressionImpl(
+                             std::move(ast), /*issues=*/nullptr));
+
+    if (!enable_recursive_planning()) {
+      for (const auto& step : plan.path()) {
+        EXPECT_FALSE(step->GetNativeTypeId() ==
+                     cel::NativeTypeId::For<WrappedDirectStep>());
+      }
+      continue;
+    }
+    ASSERT_THAT(plan.path(), SizeIs(1));
+    ASSERT_TRUE(plan.path()[0]->GetNativeTypeId() ==
+                cel::NativeTypeId::For<WrappedDirectStep>());
+    const auto& root =
+        cel::internal::down_cast<const WrappedDirectStep&>(*plan.path()[0]);
+    EXPECT_TRUE(IsFusedComprehensionStep(*root.wrapped()));
+  }
+}
+
 TEST_P(CelExpressionBuilderFlatImplComprehensionsTest, MapComp) {
   cel::RuntimeOptions options = GetRuntimeOptions();
   CelExpressionBuilderFlatImpl builder(NewTestingRuntimeEnv(), options);
@@ -105,6 +156,280 @@ TEST_P(CelExpressionBuilderFlatImplComprehensionsTest, MapComp) {
               test::EqualsCelValue(CelValue::CreateInt64(4)));
 }
 
+TEST_P(CelExpressionBuilderFlatImplComprehensionsTest, FilterComp) {
+  cel::RuntimeOptions options = GetRuntimeOptions();
+  CelExpressionBuilderFlatImpl builder(NewTestingRuntimeEnv(), options);
+
+  ASSERT_OK_AND_ASSIGN(auto parsed_expr,
+                       parser::Parse("[1, 2, 3, 4].filter(x, x % 2 == 0)"));
+  ASSERT_OK(RegisterBuiltinFunctions(builder.GetRegistry()));
+  ASSERT_OK_AND_ASSIGN(auto cel_expr,
+                       builder.CreateExpression(&parsed_expr.expr(),
+                                                &parsed_expr.source_info()));
+
+  Activation activation;
+  google::protobuf::Arena arena;
+  ASSERT_OK_AND_ASSIGN(CelValue result, cel_expr->Evaluate(activation, &arena));
+  ASSERT_TRUE(result.IsList());
+  EXPECT_THAT(*result.ListOrDie(), testing::SizeIs(2));
+  EXPECT_THAT((*result.ListOrDie())[0],
+              test::EqualsCelValue(CelValue::CreateInt64(2)));
+  EXPECT_THAT((*result.ListOrDie())[1],
+              test::EqualsCelValue(CelValue::CreateInt64(4)));
+}
+
+TEST_P(CelExpressionBuilderFlatImplComprehensionsTest, MapFilterComp) {
+  cel::RuntimeOptions options = GetRuntimeOptions();
+  CelExpressionBuilderFlatImpl builder(NewTestingRuntimeEnv(), options);
+
+  ASSERT_OK_AND_ASSIGN(
+      auto parsed_expr,
+      parser::Parse("{'a': 1, 'b': 2}.map(k, k != 'a', k + k)"));
+  ASSERT_OK(RegisterBuiltinFunctions(builder.GetRegistry()));
+  ASSERT_OK_AND_ASSIGN(auto cel_expr,
+                       builder.CreateExpression(&parsed_expr.expr(),
+                                                &parsed_expr.source_info()));
+
+  Activation activation;
+  google::protobuf::Arena arena;
+  ASSERT_OK_AND_ASSIGN(CelValue result, cel_expr->Evaluate(activation, &arena));
+  ASSERT_TRUE(result.IsList());
+  EXPECT_THAT(*result.ListOrDie(), testing::SizeIs(1));
+  EXPECT_THAT((*result.ListOrDie())[0], test::IsCelString("bb"));
+}
+
+TEST_P(CelExpressionBuilderFlatImplComprehensionsTest, MapCompError) {
+  cel::RuntimeOptions options = GetRuntimeOptions();
+  CelExpressionBuilderFlatImpl builder(NewTestingRuntimeEnv(), options);
+
+  ASSERT_OK_AND_ASSIGN(auto parsed_expr,
+                       parser::Parse("[1, 0, 2].map(x, 4 / x)"));
+  ASSERT_OK(RegisterBuiltinFunctions(builder.GetRegistry()));
+  ASSERT_OK_AND_ASSIGN(auto cel_expr,
+                       builder.CreateExpression(&parsed_expr.expr(),
+                                                &parsed_expr.source_info()));
+
+  Activation activation;
+  google::protobuf::Arena arena;
+  ASSERT_OK_AND_ASSIGN(CelValue result, cel_expr->Evaluate(activation, &arena));
+  ASSERT_TRUE(result.IsError());
+  EXPECT_THAT(result.ErrorOrDie()->message(), HasSubstr("divide by zero"));
+}
+
+TEST_P(CelExpressionBuilderFlatImplComprehensionsTest, ChainedMacros) {
+  cel::RuntimeOptions options = GetRuntimeOptions();
+  CelExpressionBuilderFlatImpl builder(NewTestingRuntimeEnv(), options);
+
+  ASSERT_OK_AND_ASSIGN(
+      auto parsed_expr,
+      parser::Parse("[1, 2, 3, 4].map(x, x * 2).filter(y, y > 2)"
+                    ".exists(z, z == 6)"));
+  ASSERT_OK(RegisterBuiltinFunctions(builder.GetRegistry()));
+  ASSERT_OK_AND_ASSIGN(auto cel_expr,
+                       builder.CreateExpression(&parsed_expr.expr(),
+                                                &parsed_expr.source_info()));
+
+  Activation activation;
+  google::protobuf::Arena arena;
+  ASSERT_OK_AND_ASSIGN(CelValue result, cel_expr->Evaluate(activation, &arena));
+  ASSERT_TRUE(result.IsBool());
+  EXPECT_TRUE(result.BoolOrDie());
+}
+
+TEST_P(CelExpressionBuilderFlatImplComprehensionsTest,
+       ChainedMacrosPropagateErrorAfterDecision) {
+  cel::RuntimeOptions options = GetRuntimeOptions();
+  CelExpressionBuilderFlatImpl builder(NewTestingRuntimeEnv(), options);
+
+  ASSERT_OK_AND_ASSIGN(
+      auto parsed_expr,
+      parser::Parse("[1, 0].map(x, 1 / x).all(y, y == 2)"));
+  ASSERT_OK(RegisterBuiltinFunctions(builder.GetRegistry()));
+  ASSERT_OK_AND_ASSIGN(auto cel_expr,
+                       builder.CreateExpression(&parsed_expr.expr(),
+                                                &parsed_expr.source_info()));
+
+  Activation activation;
+  google::protobuf::Arena arena;
+  ASSERT_OK_AND_ASSIGN(CelValue result, cel_expr->Evaluate(activation, &arena));
+  ASSERT_TRUE(result.IsError());
+  EXPECT_THAT(result.ErrorOrDie()->message(), HasSubstr("divide by zero"));
+}
+
+TEST_P(CelExpressionBuilderFlatImplComprehensionsTest,
+       ChainedMacrosShortcircuit) {
+  cel::RuntimeOptions options = GetRuntimeOptions();
+  options.enable_comprehension_chain_shortcircuit = true;
+  CelExpressionBuilderFlatImpl builder(NewTestingRuntimeEnv(), options);
+
+  ASSERT_OK_AND_ASSIGN(
+      auto parsed_expr,
+      parser::Parse("[1, 0].map(x, 1 / x).all(y, y == 2)"));
+  ASSERT_OK(RegisterBuiltinFunctions(builder.GetRegistry()));
+  ASSERT_OK_AND_ASSIGN(auto cel_expr,
+                       builder.CreateExpression(&parsed_expr.expr(),
+                                                &parsed_expr.source_info()));
+
+  Activation activation;
+  google::protobuf::Arena arena;
+  ASSERT_OK_AND_ASSIGN(CelValue result, cel_expr->Evaluate(activation, &arena));
+  if (enable_recursive_planning()) {
+    // The fused chain stops once all() sees `1 == 2`.
+    ASSERT_TRUE(result.IsBool());
+    EXPECT_FALSE(result.BoolOrDie());
+  } else {
+    ASSERT_TRUE(result.IsError());
+    EXPECT_THAT(result.ErrorOrDie()->message(), HasSubstr("divide by zero"));
+  }
+}
+
+TEST_P(CelExpressionBuilderFlatImplComprehensionsTest, ExistsAbsorbsError) {
+  cel::RuntimeOptions options = GetRuntimeOptions();
+  CelExpressionBuilderFlatImpl builder(NewTestingRuntimeEnv(), options);
+
+  ASSERT_OK_AND_ASSIGN(auto parsed_expr,
+                       parser::Parse("[0, 1].exists(x, 1 / x == 1)"));
+  ASSERT_OK(RegisterBuiltinFunctions(builder.GetRegistry()));
+  ASSERT_OK_AND_ASSIGN(auto cel_expr,
+                       builder.CreateExpression(&parsed_expr.expr(),
+                                                &parsed_expr.source_info()));
+
+  Activation activation;
+  google::protobuf::Arena arena;
+  ASSERT_OK_AND_ASSIGN(CelValue result, cel_expr->Evaluate(activation, &arena));
+  EXPECT_THAT(result, test::IsCelBool(true));
+}
+
+TEST_P(CelExpressionBuilderFlatImplComprehensionsTest, AllPropagatesError) {
+  cel::RuntimeOptions options = GetRuntimeOptions();
+  CelExpressionBuilderFlatImpl builder(NewTestingRuntimeEnv(), options);
+
+  ASSERT_OK_AND_ASSIGN(auto parsed_expr,
+                       parser::Parse("[0, 1].all(x, 1 / x == 1)"));
+  ASSERT_OK(RegisterBuiltinFunctions(builder.GetRegistry()));
+  ASSERT_OK_AND_ASSIGN(auto cel_expr,
+                       builder.CreateExpression(&parsed_expr.expr(),
+                                                &parsed_expr.source_info()));
+
+  Activation activation;
+  google::protobuf::Arena arena;
+  ASSERT_OK_AND_ASSIGN(CelValue result, cel_expr->Evaluate(activation, &arena));
+  ASSERT_TRUE(result.IsError());
+  EXPECT_THAT(result.ErrorOrDie()->message(), HasSubstr("divide by zero"));
+}
+
+TEST_P(CelExpressionBuilderFlatImplComprehensionsTest,
+       ExistsReferencingAccumulator) {
+  ParsedExpr expr;
+  // Hand crafted exists() shape where the predicate reads the accumulator.
+  // This must not be planned as a fused quantifier.
+  ASSERT_TRUE(google::protobuf::TextFormat::ParseFromString(
+      R"pb(
+        expr {
+          comprehension_expr {
+            iter_var: "x"
+            iter_range {
+              list_expr {
+                elements { const_expr { int64_value: 1 } }
+                elements { const_expr { int64_value: 2 } }
+              }
+            }
+            accu_var: "accu"
+            accu_init { const_expr { bool_value: false } }
+            loop_condition {
+              call_expr {
+                function: "@not_strictly_false"
+                args {
+                  call_expr {
+                    function: "!_"
+                    args { ident_expr { name: "accu" } }
+                  }
+                }
+              }
+            }
+            loop_step {
+              call_expr {
+                function: "_||_"
+                args { ident_expr { name: "accu" } }
+                args {
+                  call_expr {
+                    function: "_==_"
+                    args { ident_expr { name: "accu" } }
+                    args { const_expr { bool_value: false } }
+                  }
+                }
+              }
+            }
+            result { ident_expr { name: "accu" } }
+          }
+        })pb",
+      &expr));
+
+  cel::RuntimeOptions options = GetRuntimeOptions();
+  CelExpressionBuilderFlatImpl builder(NewTestingRuntimeEnv(), options);
+  ASSERT_OK(RegisterBuiltinFunctions(builder.GetRegistry()));
+  ASSERT_OK_AND_ASSIGN(auto cel_expr,
+                       builder.CreateExpression(&expr.expr(), nullptr));
+
+  Activation activation;
+  google::protobuf::Arena arena;
+  ASSERT_OK_AND_ASSIGN(CelValue result, cel_expr->Evaluate(activation, &arena));
+  EXPECT_THAT(result, test::IsCelBool(true));
+}
+
+TEST_P(CelExpressionBuilderFlatImplComprehensionsTest,
+       ContainedAccumulatorWithoutListAppendOption) {
+  cel::RuntimeOptions options = GetRuntimeOptions();
+  options.enable_comprehension_list_append = false;
+  CelExpressionBuilderFlatImpl builder(NewTestingRuntimeEnv(), options);
+
+  ASSERT_OK_AND_ASSIGN(
+      auto parsed_expr,
+      parser::Parse("[1, 2, 3].filter(x, x > 1).map(y, y * 2)"));
+  ASSERT_OK(RegisterBuiltinFunctions(builder.GetRegistry()));
+  ASSERT_OK_AND_ASSIGN(auto cel_expr,
+                       builder.CreateExpression(&parsed_expr.expr(),
+                                                &parsed_expr.source_info()));
+
+  Activation activation;
+  google::protobuf::Arena arena;
+  ASSERT_OK_AND_ASSIGN(CelValue result, cel_expr->Evaluate(activation, &arena));
+  ASSERT_TRUE(result.IsList());
+  EXPECT_THAT(*result.ListOrDie(), testing::SizeIs(2));
+  EXPECT_THAT((*result.ListOrDie())[0],
+              test::EqualsCelValue(CelValue::CreateInt64(4)));
+  EXPECT_THAT((*result.ListOrDie())[1],
+              test::EqualsCelValue(CelValue::CreateInt64(6)));
+}
+
+TEST_P(CelExpressionBuilderFlatImplComprehensionsTest,
+       EscapingAccumulatorWithoutListAppendOption) {
+  cel::RuntimeOptions options = GetRuntimeOptions();
+  options.enable_comprehension_list_append = false;
+  CelExpressionBuilderFlatImpl builder(NewTestingRuntimeEnv(), options);
+
+  ParserOptions parser_options;
+  parser_options.enable_hidden_accumulator_var = false;
+  // The accumulator is appended to itself, so it must not be updated in place.
+  ASSERT_OK_AND_ASSIGN(
+      auto parsed_expr,
+      parser::Parse("[1, 2].map(x, __result__)", "<input>", parser_options));
+  ASSERT_OK(RegisterBuiltinFunctions(builder.GetRegistry()));
+  ASSERT_OK_AND_ASSIGN(auto cel_expr,
+                       builder.CreateExpression(&parsed_expr.expr(),
+                                                &parsed_expr.source_info()));
+
+  Activation activation;
+  google::protobuf::Arena arena;
+  ASSERT_OK_AND_ASSIGN(CelValue result, cel_expr->Evaluate(activation, &arena));
+  ASSERT_TRUE(result.IsList());
+  ASSERT_THAT(*result.ListOrDie(), testing::SizeIs(2));
+  ASSERT_TRUE((*result.ListOrDie())[0].IsList());
+  EXPECT_THAT(*(*result.ListOrDie())[0].ListOrDie(), testing::SizeIs(0));
+  ASSERT_TRUE((*result.ListOrDie())[1].IsList());
+  EXPECT_THAT(*(*result.ListOrDie())[1].ListOrDie(), testing::SizeIs(1));
+}
+
 TEST_P(CelExpressionBuilderFlatImplComprehensionsTest, ExistsOneTrue) {
   cel::RuntimeOptions options = GetRuntimeOptions();
   CelExpressionBuilderFlatImpl builder(NewTestingRuntimeEnv(), options);
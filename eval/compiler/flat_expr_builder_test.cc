@@ -1613,6 +1613,50 @@ TEST(FlatExprBuilderTest, MapFieldPresence) {
   }
 }
 
+TEST(FlatExprBuilderTest, ConstantMapLiteral) {
+  ASSERT_OK_AND_ASSIGN(ParsedExpr expr,
+                       parser::Parse("{'US': 1, 'CA': 2, 3: 4}[country]"));
+  ASSERT_OK_AND_ASSIGN(ParsedExpr duplicate_expr,
+                       parser::Parse("{'US': 1, 'US': 2}['US']"));
+
+  for (int max_recursion_depth : {0, -1}) {
+    cel::RuntimeOptions options;
+    options.enable_constant_map_literals = true;
+    options.max_recursion_depth = max_recursion_depth;
+    CelExpressionBuilderFlatImpl builder(NewTestingRuntimeEnv(), options);
+    ASSERT_OK_AND_ASSIGN(auto cel_expr, builder.CreateExpression(
+                                            &expr.expr(), &expr.source_info()));
+
+    google::protobuf::Arena arena;
+    for (const auto& [country, expected] :
+         std::vector<std::pair<std::string, int64_t>>{{"US", 1}, {"CA", 2}}) {
+      Activation activation;
+      activation.InsertValue("country", CelValue::CreateString(&country));
+      ASSERT_OK_AND_ASSIGN(CelValue result,
+                           cel_expr->Evaluate(activation, &arena));
+      EXPECT_THAT(result, test::IsCelInt64(expected));
+    }
+    {
+      std::string country = "MX";
+      Activation activation;
+      activation.InsertValue("country", CelValue::CreateString(&country));
+      ASSERT_OK_AND_ASSIGN(CelValue result,
+                           cel_expr->Evaluate(activation, &arena));
+      EXPECT_THAT(result, test::IsCelError(
+                              StatusIs(absl::StatusCode::kNotFound)));
+    }
+
+    // Maps which fail to build still fail at evaluation time.
+    ASSERT_OK_AND_ASSIGN(
+        auto duplicate_cel_expr,
+        builder.CreateExpression(&duplicate_expr.expr(),
+                                 &duplicate_expr.source_info()));
+    Activation activation;
+    EXPECT_THAT(duplicate_cel_expr->Evaluate(activation, &arena),
+                StatusIs(absl::StatusCode::kAlreadyExists));
+  }
+}
+
 TEST(FlatExprBuilderTest, RepeatedFieldPresence) {
   Expr expr;
   SourceInfo source_info;
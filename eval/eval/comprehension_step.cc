@@ -4,7 +4,9 @@
 #include <cstdint>
 #include <memory>
 #include <utility>
+#include <vector>
 
+#include "absl/algorithm/container.h"
 #include "absl/base/attributes.h"
 #include "absl/base/casts.h"
 #include "absl/base/nullability.h"
@@ -12,16 +14,21 @@
 #include "absl/log/absl_check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/types/optional.h"
 #include "base/attribute.h"
+#include "base/builtins.h"
 #include "common/casting.h"
+#include "common/native_type.h"
 #include "common/value.h"
 #include "common/value_kind.h"
+#include "common/values/range_list_value.h"
 #include "eval/eval/attribute_trail.h"
 #include "eval/eval/comprehension_slots.h"
 #include "eval/eval/direct_expression_step.h"
 #include "eval/eval/evaluator_core.h"
 #include "eval/eval/expression_step_base.h"
 #include "eval/internal/errors.h"
+#include "internal/casts.h"
 #include "internal/status_macros.h"
 
 namespace google::api::expr::runtime {
@@ -116,8 +123,11 @@ class ComprehensionDirectStep final : public DirectExpressionStep {
       ComprehensionSlots::Slot* absl_nonnull iter_slot, Value& result,
       AttributeTrail& trail) const;
 
+  // `Iterator` is either the generic `ValueIterator` or the final
+  // `RangeListValueIterator`, which allows its calls to be devirtualized.
+  template <typename Iterator>
   absl::StatusOr<bool> Evaluate1Known(
-      ExecutionFrameBase& frame, ValueIterator* absl_nonnull range_iter,
+      ExecutionFrameBase& frame, Iterator* absl_nonnull range_iter,
       ComprehensionSlots::Slot* absl_nonnull accu_slot,
       ComprehensionSlots::Slot* absl_nonnull iter_slot, Value& result,
       AttributeTrail& trail) const;
@@ -152,10 +162,18 @@ absl::Status ComprehensionDirectStep::Evaluate1(ExecutionFrameBase& frame,
   }
 
   absl_nullability_unknown ValueIteratorPtr range_iter;
+  // Set for lists from `lists.range()`, which are enumerated on the stack.
+  absl::optional<int64_t> range_list_size;
   IterableKind iterable_kind;
   switch (range.kind()) {
     case ValueKind::kList: {
-      CEL_ASSIGN_OR_RETURN(range_iter, range.GetList().NewIterator());
+      if (!frame.unknown_processing_enabled()) {
+        range_list_size =
+            cel::common_internal::AsRangeListValue(range.GetList());
+      }
+      if (!range_list_size.has_value()) {
+        CEL_ASSIGN_OR_RETURN(range_iter, range.GetList().NewIterator());
+      }
       iterable_kind = IterableKind::kList;
     } break;
     case ValueKind::kMap: {
@@ -171,7 +189,7 @@ absl::Status ComprehensionDirectStep::Evaluate1(ExecutionFrameBase& frame,
       result = cel::ErrorValue(CreateNoMatchingOverloadError("<iter_range>"));
       return absl::OkStatus();
   }
-  ABSL_DCHECK(range_iter != nullptr);
+  ABSL_DCHECK(range_iter != nullptr || range_list_size.has_value());
 
   ComprehensionSlots::Slot* accu_slot =
       frame.comprehension_slots().Get(accu_slot_);
@@ -195,6 +213,12 @@ absl::Status ComprehensionDirectStep::Evaluate1(ExecutionFrameBase& frame,
         should_skip_result,
         Evaluate1Unknown(frame, iterable_kind, range_attr, range_iter.get(),
                          accu_slot, iter_slot, result, trail));
+  } else if (range_list_size.has_value()) {
+    cel::common_internal::RangeListValueIterator range_list_iter(
+        *range_list_size);
+    CEL_ASSIGN_OR_RETURN(should_skip_result,
+                         Evaluate1Known(frame, &range_list_iter, accu_slot,
+                                        iter_slot, result, trail));
   } else {
     CEL_ASSIGN_OR_RETURN(should_skip_result,
                          Evaluate1Known(frame, range_iter.get(), accu_slot,
@@ -278,8 +302,9 @@ absl::StatusOr<bool> ComprehensionDirectStep::Evaluate1Unknown(
   return false;
 }
 
+template <typename Iterator>
 absl::StatusOr<bool> ComprehensionDirectStep::Evaluate1Known(
-    ExecutionFrameBase& frame, ValueIterator* absl_nonnull range_iter,
+    ExecutionFrameBase& frame, Iterator* absl_nonnull range_iter,
     ComprehensionSlots::Slot* absl_nonnull accu_slot,
     ComprehensionSlots::Slot* absl_nonnull iter_slot, Value& result,
     AttributeTrail& trail) const {
@@ -442,6 +467,411 @@ finish:
   return absl::OkStatus();
 }
 
+// Evaluates the range of a fused macro comprehension.
+//
+// Returns false and sets `result` if the range is an error, unknown or not
+// iterable, in which case the comprehension body must not be evaluated.
+absl::StatusOr<bool> EvaluateIterableRange(ExecutionFrameBase& frame,
+                                           const DirectExpressionStep& step,
+                                           Value& range,
+                                           AttributeTrail& range_attr,
+                                           Value& result) {
+  CEL_RETURN_IF_ERROR(step.Evaluate(frame, range, range_attr));
+
+  if (frame.unknown_processing_enabled() && range.IsMap()) {
+    if (frame.attribute_utility().CheckForUnknownPartial(range_attr)) {
+      result =
+          frame.attribute_utility().CreateUnknownSet(range_attr.attribute());
+      return false;
+    }
+  }
+
+  switch (range.kind()) {
+    case ValueKind::kList:
+      ABSL_FALLTHROUGH_INTENDED;
+    case ValueKind::kMap:
+      return true;
+    case ValueKind::kError:
+      ABSL_FALLTHROUGH_INTENDED;
+    case ValueKind::kUnknown:
+      result = std::move(range);
+      return false;
+    default:
+      result = cel::ErrorValue(CreateNoMatchingOverloadError("<iter_range>"));
+      return false;
+  }
+}
+
+// Binds each element of `range` (or key, for maps) to `iter_slot` and invokes
+// `body` until the range is exhausted or `body` returns false.
+template <typename Body>
+absl::Status ForEachIterVar(ExecutionFrameBase& frame, const Value& range,
+                            const AttributeTrail& range_attr,
+                            ComprehensionSlots::Slot* absl_nonnull iter_slot,
+                            Body&& body) {
+  const bool is_list = range.IsList();
+  if (is_list && !frame.unknown_processing_enabled()) {
+    if (absl::optional<int64_t> size =
+            cel::common_internal::AsRangeListValue(range.GetList());
+        size.has_value()) {
+      for (int64_t i = 0; i < *size; ++i) {
+        CEL_RETURN_IF_ERROR(frame.IncrementIterations());
+        *iter_slot->mutable_value() = cel::IntValue(i);
+        CEL_ASSIGN_OR_RETURN(bool should_continue, body());
+        if (!should_continue) {
+          break;
+        }
+      }
+      return absl::OkStatus();
+    }
+  }
+
+  absl_nullability_unknown ValueIteratorPtr range_iter;
+  if (is_list) {
+    CEL_ASSIGN_OR_RETURN(range_iter, range.GetList().NewIterator());
+  } else {
+    CEL_ASSIGN_OR_RETURN(range_iter, range.GetMap().NewIterator());
+  }
+  ABSL_DCHECK(range_iter != nullptr);
+
+  Value index;
+  while (true) {
+    bool ok;
+    if (frame.unknown_processing_enabled()) {
+      Value* key = is_list ? &index : iter_slot->mutable_value();
+      Value* value = is_list ? iter_slot->mutable_value() : nullptr;
+      CEL_ASSIGN_OR_RETURN(
+          ok, range_iter->Next2(frame.descriptor_pool(),
+                                frame.message_factory(), frame.arena(), key,
+                                value));
+      if (!ok) {
+        break;
+      }
+      CEL_RETURN_IF_ERROR(frame.IncrementIterations());
+      *iter_slot->mutable_attribute() =
+          range_attr.Step(AttributeQualifierFromValue(*key));
+      if (frame.attribute_utility().CheckForUnknownExact(
+              iter_slot->attribute())) {
+        *iter_slot->mutable_value() =
+            frame.attribute_utility().CreateUnknownSet(
+                iter_slot->attribute().attribute());
+      }
+    } else {
+      CEL_ASSIGN_OR_RETURN(
+          ok,
+          range_iter->Next1(frame.descriptor_pool(), frame.message_factory(),
+                            frame.arena(), iter_slot->mutable_value()));
+      if (!ok) {
+        break;
+      }
+      CEL_RETURN_IF_ERROR(frame.IncrementIterations());
+    }
+
+    CEL_ASSIGN_OR_RETURN(bool should_continue, body());
+    if (!should_continue) {
+      break;
+    }
+  }
+  return absl::OkStatus();
+}
+
+// Combines a non-boolean predicate result into the running result of an
+// `all()` or `exists()`, matching the fall through case of the logical
+// operators.
+void MergeNonBoolPredicate(ExecutionFrameBase& frame, bool is_all,
+                           Value& result, Value& predicate) {
+  if (frame.unknown_processing_enabled()) {
+    if (result.IsUnknown() && predicate.IsUnknown()) {
+      result = frame.attribute_utility().MergeUnknownValues(
+          result.GetUnknown(), predicate.GetUnknown());
+      return;
+    } else if (result.IsUnknown()) {
+      return;
+    } else if (predicate.IsUnknown()) {
+      result = std::move(predicate);
+      return;
+    }
+  }
+
+  if (result.IsError()) {
+    return;
+  } else if (predicate.IsError()) {
+    result = std::move(predicate);
+    return;
+  }
+
+  result = cel::ErrorValue(CreateNoMatchingOverloadError(
+      is_all ? cel::builtin::kAnd : cel::builtin::kOr));
+}
+
+// The body of a `map()` or `filter()` comprehension in a fused chain.
+struct ListStage {
+  size_t iter_slot;
+  // Null for `map()` without a filter.
+  std::unique_ptr<DirectExpressionStep> filter;
+  std::unique_ptr<DirectExpressionStep> element;
+};
+
+// Evaluates `stage` for the value bound to its iter var. Returns true if
+// `element` was set to a value appended to the stage output.
+//
+// Once an error or unknown is encountered it is stored in `non_list_result`
+// and replaces the stage output, the same way as the expanded `@listAppend`
+// loop step.
+absl::StatusOr<bool> EvaluateListStage(ExecutionFrameBase& frame,
+                                       const ListStage& stage, Value& element,
+                                       absl::optional<Value>& non_list_result) {
+  if (stage.filter != nullptr) {
+    // Same as `filter ? accu + [element] : accu`: errors and unknowns from the
+    // condition always replace the accumulator.
+    Value condition;
+    AttributeTrail condition_attr;
+    CEL_RETURN_IF_ERROR(
+        stage.filter->Evaluate(frame, condition, condition_attr));
+    if (condition.IsError() || condition.IsUnknown()) {
+      non_list_result = std::move(condition);
+      return false;
+    }
+    if (!condition.IsBool()) {
+      non_list_result = cel::ErrorValue(
+          CreateNoMatchingOverloadError(cel::builtin::kTernary));
+      return false;
+    }
+    if (!condition.GetBool().NativeValue()) {
+      return false;
+    }
+  }
+
+  AttributeTrail element_attr;
+  CEL_RETURN_IF_ERROR(stage.element->Evaluate(frame, element, element_attr));
+  if (frame.unknown_processing_enabled() &&
+      frame.attribute_utility().CheckForUnknown(element_attr,
+                                                /*use_partial=*/true)) {
+    element =
+        frame.attribute_utility().CreateUnknownSet(element_attr.attribute());
+  }
+
+  // Same as the strict `@listAppend(accu, element)`: the first error wins,
+  // otherwise unknowns are merged.
+  if (non_list_result.has_value()) {
+    if (non_list_result->IsError()) {
+      return false;
+    }
+    if (element.IsError()) {
+      non_list_result = std::move(element);
+    } else if (element.IsUnknown() && non_list_result->IsUnknown()) {
+      non_list_result = frame.attribute_utility().MergeUnknownValues(
+          non_list_result->GetUnknown(), element.GetUnknown());
+    }
+    return false;
+  }
+  if (element.IsError() || element.IsUnknown()) {
+    non_list_result = std::move(element);
+    return false;
+  }
+  return true;
+}
+
+enum class FusedTerminal {
+  // Collects the output of the last stage into a list.
+  kList,
+  kAll,
+  kExists,
+};
+
+// Evaluates a chain of `map()` and `filter()` comprehensions, optionally
+// followed by `all()` or `exists()`, in a single pass over the innermost
+// range.
+//
+// Each element of the range is passed through the stages in order without
+// materializing the intermediate lists. Elements of an intermediate list have
+// no attribute, so the downstream iter vars are bound without one.
+//
+// The result is the same as evaluating the comprehensions one at a time: the
+// output of the first stage to produce an error or unknown is the result of
+// the chain, since every downstream comprehension would have seen it as its
+// range. For that reason a decided quantifier keeps passing the remaining
+// elements through the stages, unless `shortcircuit_chain` is set.
+class DirectFusedComprehensionStep final : public DirectExpressionStep {
+ public:
+  DirectFusedComprehensionStep(std::unique_ptr<DirectExpressionStep> range,
+                               std::vector<ListStage> stages,
+                               FusedTerminal terminal, size_t terminal_slot,
+                               std::unique_ptr<DirectExpressionStep> predicate,
+                               bool shortcircuit_chain, int64_t expr_id)
+      : DirectExpressionStep(expr_id),
+        range_(std::move(range)),
+        stages_(std::move(stages)),
+        terminal_(terminal),
+        terminal_slot_(terminal_slot),
+        predicate_(std::move(predicate)),
+        shortcircuit_chain_(shortcircuit_chain) {
+    ABSL_DCHECK(terminal_ != FusedTerminal::kList || !stages_.empty());
+    ABSL_DCHECK((terminal_ == FusedTerminal::kList) == (predicate_ == nullptr));
+  }
+
+  absl::Status Evaluate(ExecutionFrameBase& frame, Value& result,
+                        AttributeTrail& trail) const override;
+
+  cel::NativeTypeId GetNativeTypeId() const override {
+    return cel::NativeTypeId::For<DirectFusedComprehensionStep>();
+  }
+
+  bool produces_list() const { return terminal_ == FusedTerminal::kList; }
+
+  // Moves the range and stages out so a downstream comprehension can consume
+  // the output of this step element by element.
+  //
+  // Extract prevents this step from functioning.
+  std::unique_ptr<DirectExpressionStep> ExtractRange() {
+    return std::move(range_);
+  }
+  std::vector<ListStage> ExtractStages() { return std::move(stages_); }
+
+ private:
+  // Evaluates the quantifier predicate for an element emitted by the stages.
+  // Returns true once the result is decided.
+  absl::StatusOr<bool> EvaluatePredicate(ExecutionFrameBase& frame,
+                                         Value& result) const;
+
+  std::unique_ptr<DirectExpressionStep> range_;
+  std::vector<ListStage> stages_;
+  const FusedTerminal terminal_;
+  const size_t terminal_slot_;
+  const std::unique_ptr<DirectExpressionStep> predicate_;
+  const bool shortcircuit_chain_;
+};
+
+absl::Status DirectFusedComprehensionStep::Evaluate(
+    ExecutionFrameBase& frame, Value& result, AttributeTrail& trail) const {
+  trail = AttributeTrail();
+  Value range;
+  AttributeTrail range_attr;
+  CEL_ASSIGN_OR_RETURN(
+      bool iterable,
+      EvaluateIterableRange(frame, *range_, range, range_attr, result));
+  if (!iterable) {
+    return absl::OkStatus();
+  }
+
+  cel::ListValueBuilderPtr builder;
+  if (produces_list()) {
+    builder = cel::NewListValueBuilder(frame.arena());
+    if (absl::c_none_of(stages_, [](const ListStage& stage) {
+          return stage.filter != nullptr;
+        })) {
+      size_t size;
+      if (range.IsList()) {
+        CEL_ASSIGN_OR_RETURN(size, range.GetList().Size());
+      } else {
+        CEL_ASSIGN_OR_RETURN(size, range.GetMap().Size());
+      }
+      builder->Reserve(size);
+    }
+  } else {
+    result = cel::BoolValue(terminal_ == FusedTerminal::kAll);
+  }
+
+  ComprehensionSlots::Slot* source_slot = frame.comprehension_slots().Get(
+      stages_.empty() ? terminal_slot_ : stages_.front().iter_slot);
+  ABSL_DCHECK(source_slot != nullptr);
+  source_slot->Set();
+
+  std::vector<absl::optional<Value>> stage_results(stages_.size());
+  size_t first_failed_stage = stages_.size();
+  bool decided = false;
+  Value element;
+  CEL_RETURN_IF_ERROR(ForEachIterVar(
+      frame, range, range_attr, source_slot, [&]() -> absl::StatusOr<bool> {
+        bool emitted = true;
+        for (size_t i = 0; emitted && i < stages_.size(); ++i) {
+          if (i > 0) {
+            CEL_RETURN_IF_ERROR(frame.IncrementIterations());
+            frame.comprehension_slots().Set(stages_[i].iter_slot,
+                                            std::move(element));
+          }
+          CEL_ASSIGN_OR_RETURN(
+              emitted,
+              EvaluateListStage(frame, stages_[i], element, stage_results[i]));
+          if (stage_results[i].has_value() && i < first_failed_stage) {
+            first_failed_stage = i;
+          }
+        }
+        if (!emitted) {
+          return true;
+        }
+        if (produces_list()) {
+          CEL_RETURN_IF_ERROR(builder->Add(std::move(element)));
+          return true;
+        }
+        if (!decided) {
+          if (!stages_.empty()) {
+            CEL_RETURN_IF_ERROR(frame.IncrementIterations());
+            frame.comprehension_slots().Set(terminal_slot_, std::move(element));
+          }
+          CEL_ASSIGN_OR_RETURN(decided, EvaluatePredicate(frame, result));
+        }
+        return !decided || (!stages_.empty() && !shortcircuit_chain_);
+      }));
+
+  for (const ListStage& stage : stages_) {
+    frame.comprehension_slots().ClearSlot(stage.iter_slot);
+  }
+  if (!produces_list()) {
+    frame.comprehension_slots().ClearSlot(terminal_slot_);
+  }
+
+  if (first_failed_stage < stages_.size()) {
+    result = *std::move(stage_results[first_failed_stage]);
+  } else if (produces_list()) {
+    result = std::move(*builder).Build();
+  }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<bool> DirectFusedComprehensionStep::EvaluatePredicate(
+    ExecutionFrameBase& frame, Value& result) const {
+  const bool is_all = terminal_ == FusedTerminal::kAll;
+  Value predicate;
+  AttributeTrail predicate_attr;
+  CEL_RETURN_IF_ERROR(predicate_->Evaluate(frame, predicate, predicate_attr));
+  if (!predicate.IsBool()) {
+    MergeNonBoolPredicate(frame, is_all, result, predicate);
+    return false;
+  }
+  // `all()` stops on the first false, `exists()` on the first true.
+  if (predicate.GetBool().NativeValue() != is_all) {
+    result = std::move(predicate);
+    return true;
+  }
+  return false;
+}
+
+// Creates a fused step, absorbing `range` into the chain if it is itself a
+// fused step that produces a list.
+std::unique_ptr<DirectExpressionStep> CreateFusedComprehensionStep(
+    std::unique_ptr<DirectExpressionStep> range,
+    absl::optional<ListStage> stage, FusedTerminal terminal,
+    size_t terminal_slot, std::unique_ptr<DirectExpressionStep> predicate,
+    bool shortcircuit_chain, int64_t expr_id) {
+  std::vector<ListStage> stages;
+  if (range->GetNativeTypeId() ==
+      cel::NativeTypeId::For<DirectFusedComprehensionStep>()) {
+    auto& upstream = cel::internal::down_cast<DirectFusedComprehensionStep&>(
+        *range);
+    if (upstream.produces_list()) {
+      stages = upstream.ExtractStages();
+      range = upstream.ExtractRange();
+    }
+  }
+  if (stage.has_value()) {
+    stages.push_back(*std::move(stage));
+  }
+  return std::make_unique<DirectFusedComprehensionStep>(
+      std::move(range), std::move(stages), terminal, terminal_slot,
+      std::move(predicate), shortcircuit_chain, expr_id);
+}
+
 }  // namespace
 
 absl::Status ComprehensionInitStep::Evaluate(ExecutionFrame* frame) const {
@@ -677,6 +1107,32 @@ std::unique_ptr<DirectExpressionStep> CreateDirectComprehensionStep(
       shortcircuiting, expr_id);
 }
 
+std::unique_ptr<DirectExpressionStep> CreateDirectQuantifierComprehensionStep(
+    size_t iter_slot, std::unique_ptr<DirectExpressionStep> range,
+    std::unique_ptr<DirectExpressionStep> predicate, bool is_all,
+    bool shortcircuit_chain, int64_t expr_id) {
+  return CreateFusedComprehensionStep(
+      std::move(range), /*stage=*/absl::nullopt,
+      is_all ? FusedTerminal::kAll : FusedTerminal::kExists, iter_slot,
+      std::move(predicate), shortcircuit_chain, expr_id);
+}
+
+std::unique_ptr<DirectExpressionStep> CreateDirectListComprehensionStep(
+    size_t iter_slot, std::unique_ptr<DirectExpressionStep> range,
+    std::unique_ptr<DirectExpressionStep> filter,
+    std::unique_ptr<DirectExpressionStep> element, int64_t expr_id) {
+  return CreateFusedComprehensionStep(
+      std::move(range),
+      ListStage{iter_slot, std::move(filter), std::move(element)},
+      FusedTerminal::kList, /*terminal_slot=*/0, /*predicate=*/nullptr,
+      /*shortcircuit_chain=*/false, expr_id);
+}
+
+bool IsFusedComprehensionStep(const DirectExpressionStep& step) {
+  return step.GetNativeTypeId() ==
+         cel::NativeTypeId::For<DirectFusedComprehensionStep>();
+}
+
 std::unique_ptr<ExpressionStep> CreateComprehensionFinishStep(size_t accu_slot,
                                                               int64_t expr_id) {
   return std::make_unique<ComprehensionFinishStep>(accu_slot, expr_id);
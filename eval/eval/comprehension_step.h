@@ -108,6 +108,43 @@ std::unique_ptr<DirectExpressionStep> CreateDirectComprehensionStep(
     std::unique_ptr<DirectExpressionStep> result_step, bool shortcircuiting,
     int64_t expr_id);
 
+// Creates a fused step for the standard `all()` (is_all=true) and `exists()`
+// macros.
+//
+// Only evaluates `predicate` for each element of `range` bound to `iter_slot`.
+// The result is tracked locally instead of in an accumulator slot and
+// iteration stops on the first deciding value. Errors and unknowns are
+// absorbed the same way as the expanded `accu && predicate` or
+// `accu || predicate` loop step.
+//
+// If `range` is a fused `map()` / `filter()` step, its elements are streamed
+// into the predicate without building the intermediate list. A decided
+// result still passes the remaining elements through the upstream stages so
+// their errors surface as they would in the unfused chain, unless
+// `shortcircuit_chain` is set.
+std::unique_ptr<DirectExpressionStep> CreateDirectQuantifierComprehensionStep(
+    size_t iter_slot, std::unique_ptr<DirectExpressionStep> range,
+    std::unique_ptr<DirectExpressionStep> predicate, bool is_all,
+    bool shortcircuit_chain, int64_t expr_id);
+
+// Creates a fused step for the standard `map()` and `filter()` macros.
+//
+// For each element of `range` bound to `iter_slot`, evaluates `filter` (if
+// non-null) and appends the result of `element` to a list builder. The builder
+// is presized to the range size when there is no filter. Errors and unknowns
+// replace the result the same way as the expanded `@listAppend` loop step.
+//
+// If `range` is itself a fused `map()` / `filter()` step, the two are chained
+// into a single pass over the innermost range.
+std::unique_ptr<DirectExpressionStep> CreateDirectListComprehensionStep(
+    size_t iter_slot, std::unique_ptr<DirectExpressionStep> range,
+    std::unique_ptr<DirectExpressionStep> filter,
+    std::unique_ptr<DirectExpressionStep> element, int64_t expr_id);
+
+// Returns true if `step` was created by one of the fused comprehension step
+// factories above.
+bool IsFusedComprehensionStep(const DirectExpressionStep& step);
+
 // Creates a cleanup step for the comprehension.
 // Removes the comprehension context then pushes the 'result' sub expression to
 // the top of the stack.
@@ -40,6 +40,7 @@
 namespace google::api::expr::runtime {
 namespace {
 
+using ::absl_testing::IsOkAndHolds;
 using ::absl_testing::StatusIs;
 using ::cel::BoolValue;
 using ::cel::Expr;
@@ -49,6 +50,7 @@ using ::cel::TypeProvider;
 using ::cel::Value;
 using ::cel::runtime_internal::NewTestingRuntimeEnv;
 using ::cel::test::BoolValueIs;
+using ::cel::test::IntValueIs;
 using ::google::protobuf::Struct;
 using ::google::protobuf::Arena;
 using ::testing::_;
@@ -483,5 +485,188 @@ TEST_F(DirectComprehensionTest, Exhaustive) {
   EXPECT_THAT(result, BoolValueIs(false));
 }
 
+TEST_F(DirectComprehensionTest, QuantifierShortcircuit) {
+  cel::RuntimeOptions options;
+
+  ExecutionFrameBase frame(
+      empty_activation_, /*callback=*/nullptr, options, type_provider_,
+      cel::internal::GetTestingDescriptorPool(),
+      cel::internal::GetTestingMessageFactory(), &arena_, slots_);
+
+  auto predicate = std::make_unique<MockDirectStep>();
+  MockDirectStep* mock = predicate.get();
+
+  EXPECT_CALL(*mock, Evaluate(_, _, _))
+      .Times(1)
+      .WillRepeatedly([](ExecutionFrameBase&, Value& result, AttributeTrail&) {
+        result = BoolValue(true);
+        return absl::OkStatus();
+      });
+
+  ASSERT_OK_AND_ASSIGN(auto list, MakeList());
+
+  auto compre_step = CreateDirectQuantifierComprehensionStep(
+      0, /*range=*/CreateConstValueDirectStep(std::move(list)),
+      /*predicate=*/std::move(predicate), /*is_all=*/false,
+      /*shortcircuit_chain=*/false, -1);
+
+  Value result;
+  AttributeTrail trail;
+  ASSERT_OK(compre_step->Evaluate(frame, result, trail));
+  EXPECT_THAT(result, BoolValueIs(true));
+}
+
+TEST_F(DirectComprehensionTest, QuantifierPropagatePredicateNonOkStatus) {
+  cel::RuntimeOptions options;
+
+  ExecutionFrameBase frame(
+      empty_activation_, /*callback=*/nullptr, options, type_provider_,
+      cel::internal::GetTestingDescriptorPool(),
+      cel::internal::GetTestingMessageFactory(), &arena_, slots_);
+
+  auto predicate = std::make_unique<MockDirectStep>();
+  MockDirectStep* mock = predicate.get();
+
+  ON_CALL(*mock, Evaluate(_, _, _))
+      .WillByDefault(Return(absl::InternalError("test predicate error")));
+
+  ASSERT_OK_AND_ASSIGN(auto list, MakeList());
+
+  auto compre_step = CreateDirectQuantifierComprehensionStep(
+      0, /*range=*/CreateConstValueDirectStep(std::move(list)),
+      /*predicate=*/std::move(predicate), /*is_all=*/true,
+      /*shortcircuit_chain=*/false, -1);
+
+  Value result;
+  AttributeTrail trail;
+  EXPECT_THAT(compre_step->Evaluate(frame, result, trail),
+              StatusIs(absl::StatusCode::kInternal, "test predicate error"));
+}
+
+TEST_F(DirectComprehensionTest, ListComprehensionFilter) {
+  cel::RuntimeOptions options;
+
+  ExecutionFrameBase frame(
+      empty_activation_, /*callback=*/nullptr, options, type_provider_,
+      cel::internal::GetTestingDescriptorPool(),
+      cel::internal::GetTestingMessageFactory(), &arena_, slots_);
+
+  auto filter = std::make_unique<MockDirectStep>();
+  MockDirectStep* mock = filter.get();
+
+  EXPECT_CALL(*mock, Evaluate(_, _, _))
+      .Times(2)
+      .WillOnce([](ExecutionFrameBase&, Value& result, AttributeTrail&) {
+        result = BoolValue(false);
+        return absl::OkStatus();
+      })
+      .WillOnce([](ExecutionFrameBase&, Value& result, AttributeTrail&) {
+        result = BoolValue(true);
+        return absl::OkStatus();
+      });
+
+  ASSERT_OK_AND_ASSIGN(auto list, MakeList());
+
+  auto compre_step = CreateDirectListComprehensionStep(
+      0, /*range=*/CreateConstValueDirectStep(std::move(list)),
+      /*filter=*/std::move(filter),
+      /*element=*/CreateDirectSlotIdentStep("x", 0, -1), -1);
+
+  Value result;
+  AttributeTrail trail;
+  ASSERT_OK(compre_step->Evaluate(frame, result, trail));
+  ASSERT_TRUE(result.IsList());
+  EXPECT_THAT(result.GetList().Size(), IsOkAndHolds(1));
+  EXPECT_THAT(result.GetList().Get(0, cel::internal::GetTestingDescriptorPool(),
+                                   cel::internal::GetTestingMessageFactory(),
+                                   &arena_),
+              IsOkAndHolds(IntValueIs(2)));
+}
+
+TEST_F(DirectComprehensionTest, ChainedQuantifierSurfacesUpstreamErrors) {
+  cel::RuntimeOptions options;
+
+  ExecutionFrameBase frame(
+      empty_activation_, /*callback=*/nullptr, options, type_provider_,
+      cel::internal::GetTestingDescriptorPool(),
+      cel::internal::GetTestingMessageFactory(), &arena_, slots_);
+
+  auto element = std::make_unique<MockDirectStep>();
+  EXPECT_CALL(*element, Evaluate(_, _, _))
+      .Times(2)
+      .WillOnce([](ExecutionFrameBase&, Value& result, AttributeTrail&) {
+        result = IntValue(1);
+        return absl::OkStatus();
+      })
+      .WillOnce([](ExecutionFrameBase&, Value& result, AttributeTrail&) {
+        result = cel::ErrorValue(absl::InvalidArgumentError("map error"));
+        return absl::OkStatus();
+      });
+  auto predicate = std::make_unique<MockDirectStep>();
+  EXPECT_CALL(*predicate, Evaluate(_, _, _))
+      .Times(1)
+      .WillRepeatedly([](ExecutionFrameBase&, Value& result, AttributeTrail&) {
+        result = BoolValue(true);
+        return absl::OkStatus();
+      });
+
+  ASSERT_OK_AND_ASSIGN(auto list, MakeList());
+
+  // [1, 2].map(x, <element>).exists(y, <predicate>)
+  auto map_step = CreateDirectListComprehensionStep(
+      0, /*range=*/CreateConstValueDirectStep(std::move(list)),
+      /*filter=*/nullptr, /*element=*/std::move(element), -1);
+  auto compre_step = CreateDirectQuantifierComprehensionStep(
+      1, /*range=*/std::move(map_step), /*predicate=*/std::move(predicate),
+      /*is_all=*/false, /*shortcircuit_chain=*/false, -1);
+
+  Value result;
+  AttributeTrail trail;
+  ASSERT_OK(compre_step->Evaluate(frame, result, trail));
+  ASSERT_TRUE(result.IsError());
+  EXPECT_THAT(result.GetError().NativeValue(),
+              StatusIs(absl::StatusCode::kInvalidArgument, "map error"));
+}
+
+TEST_F(DirectComprehensionTest, ChainedQuantifierShortcircuit) {
+  cel::RuntimeOptions options;
+
+  ExecutionFrameBase frame(
+      empty_activation_, /*callback=*/nullptr, options, type_provider_,
+      cel::internal::GetTestingDescriptorPool(),
+      cel::internal::GetTestingMessageFactory(), &arena_, slots_);
+
+  auto filter = std::make_unique<MockDirectStep>();
+  EXPECT_CALL(*filter, Evaluate(_, _, _))
+      .Times(1)
+      .WillRepeatedly([](ExecutionFrameBase&, Value& result, AttributeTrail&) {
+        result = BoolValue(true);
+        return absl::OkStatus();
+      });
+  auto predicate = std::make_unique<MockDirectStep>();
+  EXPECT_CALL(*predicate, Evaluate(_, _, _))
+      .Times(1)
+      .WillRepeatedly([](ExecutionFrameBase&, Value& result, AttributeTrail&) {
+        result = BoolValue(true);
+        return absl::OkStatus();
+      });
+
+  ASSERT_OK_AND_ASSIGN(auto list, MakeList());
+
+  // [1, 2].filter(x, <filter>).exists(y, <predicate>)
+  auto filter_step = CreateDirectListComprehensionStep(
+      0, /*range=*/CreateConstValueDirectStep(std::move(list)),
+      /*filter=*/std::move(filter),
+      /*element=*/CreateDirectSlotIdentStep("x", 0, -1), -1);
+  auto compre_step = CreateDirectQuantifierComprehensionStep(
+      1, /*range=*/std::move(filter_step), /*predicate=*/std::move(predicate),
+      /*is_all=*/false, /*shortcircuit_chain=*/true, -1);
+
+  Value result;
+  AttributeTrail trail;
+  ASSERT_OK(compre_step->Evaluate(frame, result, trail));
+  EXPECT_THAT(result, BoolValueIs(true));
+}
+
 }  // namespace
 }  // namespace google::api::expr::runtime
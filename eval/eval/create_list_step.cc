@@ -14,6 +14,7 @@
 #include "common/expr.h"
 #include "common/value.h"
 #include "common/values/list_value_builder.h"
+#include "common/values/primitive_list_value.h"
 #include "eval/eval/attribute_trail.h"
 #include "eval/eval/attribute_utility.h"
 #include "eval/eval/direct_expression_step.h"
@@ -31,15 +32,18 @@ using ::cel::InstanceOf;
 using ::cel::ListValueBuilderPtr;
 using ::cel::UnknownValue;
 using ::cel::Value;
+using ::cel::common_internal::MakeUnboxedListValue;
 using ::cel::common_internal::NewListValueBuilder;
 
 class CreateListStep : public ExpressionStepBase {
  public:
   CreateListStep(int64_t expr_id, int list_size,
-                 absl::flat_hash_set<int> optional_indices)
+                 absl::flat_hash_set<int> optional_indices,
+                 bool unbox_primitives)
       : ExpressionStepBase(expr_id),
         list_size_(list_size),
-        optional_indices_(std::move(optional_indices)) {}
+        optional_indices_(std::move(optional_indices)),
+        unbox_primitives_(unbox_primitives) {}
 
   absl::Status Evaluate(ExecutionFrame* frame) const override;
 
@@ -48,6 +52,7 @@ class CreateListStep : public ExpressionStepBase {
 
   int list_size_;
   absl::flat_hash_set<int32_t> optional_indices_;
+  bool unbox_primitives_;
 };
 
 absl::Status CreateListStep::Evaluate(ExecutionFrame* frame) const {
@@ -90,6 +95,13 @@ absl::Status CreateListStep::DoEvaluate(ExecutionFrame* frame,
     }
   }
 
+  if (unbox_primitives_ && optional_indices_.empty()) {
+    if (auto list = MakeUnboxedListValue(args, frame->arena()); list) {
+      *result = *std::move(list);
+      return absl::OkStatus();
+    }
+  }
+
   ListValueBuilderPtr builder = NewListValueBuilder(frame->arena());
   builder->Reserve(args.size());
 
@@ -136,15 +148,27 @@ class CreateListDirectStep : public DirectExpressionStep {
  public:
   CreateListDirectStep(
       std::vector<std::unique_ptr<DirectExpressionStep>> elements,
-      absl::flat_hash_set<int32_t> optional_indices, int64_t expr_id)
+      absl::flat_hash_set<int32_t> optional_indices, bool unbox_primitives,
+      int64_t expr_id)
       : DirectExpressionStep(expr_id),
         elements_(std::move(elements)),
-        optional_indices_(std::move(optional_indices)) {}
+        optional_indices_(std::move(optional_indices)),
+        unbox_primitives_(unbox_primitives) {}
 
   absl::Status Evaluate(ExecutionFrameBase& frame, Value& result,
                         AttributeTrail& attribute_trail) const override {
     ListValueBuilderPtr builder = NewListValueBuilder(frame.arena());
-    builder->Reserve(elements_.size());
+
+    // Elements are staged outside of the builder when unboxing, so that a
+    // homogeneous list of primitives only ever occupies a native array on the
+    // arena.
+    const bool unbox = unbox_primitives_ && optional_indices_.empty();
+    std::vector<Value> staged;
+    if (unbox) {
+      staged.reserve(elements_.size());
+    } else {
+      builder->Reserve(elements_.size());
+    }
 
     AttributeUtility::Accumulator unknowns =
         frame.attribute_utility().CreateAccumulator();
@@ -207,6 +231,10 @@ class CreateListDirectStep : public DirectExpressionStep {
       }
 
       // Otherwise just add.
+      if (unbox) {
+        staged.push_back(std::move(result));
+        continue;
+      }
       CEL_RETURN_IF_ERROR(builder->Add(std::move(result)));
     }
 
@@ -214,6 +242,16 @@ class CreateListDirectStep : public DirectExpressionStep {
       result = std::move(unknowns).Build();
       return absl::OkStatus();
     }
+    if (unbox) {
+      if (auto list = MakeUnboxedListValue(staged, frame.arena()); list) {
+        result = *std::move(list);
+        return absl::OkStatus();
+      }
+      builder->Reserve(staged.size());
+      for (Value& element : staged) {
+        CEL_RETURN_IF_ERROR(builder->Add(std::move(element)));
+      }
+    }
     result = std::move(*builder).Build();
 
     return absl::OkStatus();
@@ -222,6 +260,7 @@ class CreateListDirectStep : public DirectExpressionStep {
  private:
   std::vector<std::unique_ptr<DirectExpressionStep>> elements_;
   absl::flat_hash_set<int32_t> optional_indices_;
+  bool unbox_primitives_;
 };
 
 class MutableListStep : public ExpressionStepBase {
@@ -259,16 +298,18 @@ absl::Status DirectMutableListStep::Evaluate(
 
 std::unique_ptr<DirectExpressionStep> CreateDirectListStep(
     std::vector<std::unique_ptr<DirectExpressionStep>> deps,
-    absl::flat_hash_set<int32_t> optional_indices, int64_t expr_id) {
+    absl::flat_hash_set<int32_t> optional_indices, int64_t expr_id,
+    bool unbox_primitives) {
   return std::make_unique<CreateListDirectStep>(
-      std::move(deps), std::move(optional_indices), expr_id);
+      std::move(deps), std::move(optional_indices), unbox_primitives, expr_id);
 }
 
 absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateCreateListStep(
-    const cel::ListExpr& create_list_expr, int64_t expr_id) {
+    const cel::ListExpr& create_list_expr, int64_t expr_id,
+    bool unbox_primitives) {
   return std::make_unique<CreateListStep>(
       expr_id, create_list_expr.elements().size(),
-      MakeOptionalIndicesSet(create_list_expr));
+      MakeOptionalIndicesSet(create_list_expr), unbox_primitives);
 }
 
 std::unique_ptr<ExpressionStep> CreateMutableListStep(int64_t expr_id) {
@@ -14,13 +14,21 @@
 namespace google::api::expr::runtime {
 
 // Factory method for CreateList that evaluates recursively.
+//
+// If `unbox_primitives` is true, lists whose elements are all `int`, `uint`,
+// `double`, `bool` or `string` store them in a native array.
 std::unique_ptr<DirectExpressionStep> CreateDirectListStep(
     std::vector<std::unique_ptr<DirectExpressionStep>> deps,
-    absl::flat_hash_set<int32_t> optional_indices, int64_t expr_id);
+    absl::flat_hash_set<int32_t> optional_indices, int64_t expr_id,
+    bool unbox_primitives = false);
 
 // Factory method for CreateList which constructs an immutable list.
+//
+// If `unbox_primitives` is true, lists whose elements are all `int`, `uint`,
+// `double`, `bool` or `string` store them in a native array.
 absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateCreateListStep(
-    const cel::ListExpr& create_list_expr, int64_t expr_id);
+    const cel::ListExpr& create_list_expr, int64_t expr_id,
+    bool unbox_primitives = false);
 
 // Factory method for CreateList which constructs a mutable list.
 //
@@ -11,6 +11,7 @@
 #include "absl/status/status_matchers.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
+#include "absl/types/optional.h"
 #include "base/attribute.h"
 #include "base/attribute_set.h"
 #include "base/type_provider.h"
@@ -18,6 +19,7 @@
 #include "common/expr.h"
 #include "common/value.h"
 #include "common/value_testing.h"
+#include "common/values/primitive_list_value.h"
 #include "eval/eval/attribute_trail.h"
 #include "eval/eval/cel_expression_flat_impl.h"
 #include "eval/eval/const_value_step.h"
@@ -63,9 +65,11 @@ using ::cel::Value;
 using ::cel::runtime_internal::NewTestingRuntimeEnv;
 using ::cel::runtime_internal::RuntimeEnv;
 using ::cel::test::IntValueIs;
+using ::testing::ElementsAre;
 using ::testing::Eq;
 using ::testing::HasSubstr;
 using ::testing::Not;
+using ::testing::Optional;
 using ::testing::UnorderedElementsAre;
 
 // Helper method. Creates simple pipeline containing Select step and runs it.
@@ -298,6 +302,66 @@ TEST(CreateDirectListStep, Basic) {
   EXPECT_THAT(Cast<ListValue>(result).Size(), IsOkAndHolds(2));
 }
 
+TEST(CreateDirectListStep, UnboxPrimitives) {
+  google::protobuf::Arena arena;
+  cel::runtime_internal::RuntimeTypeProvider type_provider(
+      cel::internal::GetTestingDescriptorPool());
+
+  cel::Activation activation;
+  cel::RuntimeOptions options;
+
+  ExecutionFrameBase frame(activation, options, type_provider,
+                           cel::internal::GetTestingDescriptorPool(),
+                           cel::internal::GetTestingMessageFactory(), &arena);
+
+  std::vector<std::unique_ptr<DirectExpressionStep>> deps;
+  deps.push_back(CreateConstValueDirectStep(IntValue(1), -1));
+  deps.push_back(CreateConstValueDirectStep(IntValue(2), -1));
+  auto step = CreateDirectListStep(std::move(deps), {}, -1,
+                                   /*unbox_primitives=*/true);
+
+  cel::Value result;
+  AttributeTrail attr;
+
+  ASSERT_OK(step->Evaluate(frame, result, attr));
+
+  ASSERT_TRUE(InstanceOf<ListValue>(result));
+  EXPECT_THAT(cel::common_internal::AsIntListValue(Cast<ListValue>(result)),
+              Optional(ElementsAre(1, 2)));
+}
+
+TEST(CreateDirectListStep, UnboxPrimitivesMixedKinds) {
+  google::protobuf::Arena arena;
+  cel::runtime_internal::RuntimeTypeProvider type_provider(
+      cel::internal::GetTestingDescriptorPool());
+
+  cel::Activation activation;
+  cel::RuntimeOptions options;
+
+  ExecutionFrameBase frame(activation, options, type_provider,
+                           cel::internal::GetTestingDescriptorPool(),
+                           cel::internal::GetTestingMessageFactory(), &arena);
+
+  std::vector<std::unique_ptr<DirectExpressionStep>> deps;
+  deps.push_back(CreateConstValueDirectStep(IntValue(1), -1));
+  deps.push_back(CreateConstValueDirectStep(cel::UintValue(2), -1));
+  auto step = CreateDirectListStep(std::move(deps), {}, -1,
+                                   /*unbox_primitives=*/true);
+
+  cel::Value result;
+  AttributeTrail attr;
+
+  ASSERT_OK(step->Evaluate(frame, result, attr));
+
+  ASSERT_TRUE(InstanceOf<ListValue>(result));
+  auto list = Cast<ListValue>(result);
+  EXPECT_EQ(cel::common_internal::AsIntListValue(list), absl::nullopt);
+  EXPECT_THAT(list.Size(), IsOkAndHolds(2));
+  EXPECT_THAT(list.Get(0, cel::internal::GetTestingDescriptorPool(),
+                       cel::internal::GetTestingMessageFactory(), &arena),
+              IsOkAndHolds(IntValueIs(1)));
+}
+
 TEST(CreateDirectListStep, ForwardFirstError) {
   google::protobuf::Arena arena;
   cel::runtime_internal::RuntimeTypeProvider type_provider(
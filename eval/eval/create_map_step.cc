@@ -28,6 +28,7 @@
 #include "common/casting.h"
 #include "common/value.h"
 #include "common/values/map_value_builder.h"
+#include "common/values/string_map_value.h"
 #include "eval/eval/attribute_trail.h"
 #include "eval/eval/direct_expression_step.h"
 #include "eval/eval/evaluator_core.h"
@@ -48,15 +49,18 @@ using ::cel::UnknownValue;
 using ::cel::Value;
 using ::cel::common_internal::NewMapValueBuilder;
 using ::cel::common_internal::NewMutableMapValue;
+using ::cel::common_internal::NewStringMapValueBuilder;
 
 // `CreateStruct` implementation for map.
 class CreateStructStepForMap final : public ExpressionStepBase {
  public:
   CreateStructStepForMap(int64_t expr_id, size_t entry_count,
-                         absl::flat_hash_set<int32_t> optional_indices)
+                         absl::flat_hash_set<int32_t> optional_indices,
+                         bool string_keys)
       : ExpressionStepBase(expr_id),
         entry_count_(entry_count),
-        optional_indices_(std::move(optional_indices)) {}
+        optional_indices_(std::move(optional_indices)),
+        string_keys_(string_keys) {}
 
   absl::Status Evaluate(ExecutionFrame* frame) const override;
 
@@ -65,6 +69,7 @@ class CreateStructStepForMap final : public ExpressionStepBase {
 
   size_t entry_count_;
   absl::flat_hash_set<int32_t> optional_indices_;
+  bool string_keys_;
 };
 
 absl::StatusOr<Value> CreateStructStepForMap::DoEvaluate(
@@ -86,7 +91,9 @@ absl::StatusOr<Value> CreateStructStepForMap::DoEvaluate(
     }
   }
 
-  MapValueBuilderPtr builder = NewMapValueBuilder(frame->arena());
+  MapValueBuilderPtr builder = string_keys_
+                                   ? NewStringMapValueBuilder(frame->arena())
+                                   : NewMapValueBuilder(frame->arena());
   builder->Reserve(entry_count_);
 
   for (size_t i = 0; i < entry_count_; i += 1) {
@@ -135,11 +142,12 @@ class DirectCreateMapStep : public DirectExpressionStep {
  public:
   DirectCreateMapStep(std::vector<std::unique_ptr<DirectExpressionStep>> deps,
                       absl::flat_hash_set<int32_t> optional_indices,
-                      int64_t expr_id)
+                      int64_t expr_id, bool string_keys)
       : DirectExpressionStep(expr_id),
         deps_(std::move(deps)),
         optional_indices_(std::move(optional_indices)),
-        entry_count_(deps_.size() / 2) {}
+        entry_count_(deps_.size() / 2),
+        string_keys_(string_keys) {}
 
   absl::Status Evaluate(ExecutionFrameBase& frame, Value& result,
                         AttributeTrail& attribute_trail) const override;
@@ -148,6 +156,7 @@ class DirectCreateMapStep : public DirectExpressionStep {
   std::vector<std::unique_ptr<DirectExpressionStep>> deps_;
   absl::flat_hash_set<int32_t> optional_indices_;
   size_t entry_count_;
+  bool string_keys_;
 };
 
 absl::Status DirectCreateMapStep::Evaluate(
@@ -155,7 +164,9 @@ absl::Status DirectCreateMapStep::Evaluate(
     AttributeTrail& attribute_trail) const {
   auto unknowns = frame.attribute_utility().CreateAccumulator();
 
-  MapValueBuilderPtr builder = NewMapValueBuilder(frame.arena());
+  MapValueBuilderPtr builder = string_keys_
+                                   ? NewStringMapValueBuilder(frame.arena())
+                                   : NewMapValueBuilder(frame.arena());
   builder->Reserve(entry_count_);
 
   for (size_t i = 0; i < entry_count_; i += 1) {
@@ -263,17 +274,18 @@ class DirectMutableMapStep final : public DirectExpressionStep {
 
 std::unique_ptr<DirectExpressionStep> CreateDirectCreateMapStep(
     std::vector<std::unique_ptr<DirectExpressionStep>> deps,
-    absl::flat_hash_set<int32_t> optional_indices, int64_t expr_id) {
+    absl::flat_hash_set<int32_t> optional_indices, int64_t expr_id,
+    bool string_keys) {
   return std::make_unique<DirectCreateMapStep>(
-      std::move(deps), std::move(optional_indices), expr_id);
+      std::move(deps), std::move(optional_indices), expr_id, string_keys);
 }
 
 absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateCreateStructStepForMap(
     size_t entry_count, absl::flat_hash_set<int32_t> optional_indices,
-    int64_t expr_id) {
+    int64_t expr_id, bool string_keys) {
   // Make map-creating step.
-  return std::make_unique<CreateStructStepForMap>(expr_id, entry_count,
-                                                  std::move(optional_indices));
+  return std::make_unique<CreateStructStepForMap>(
+      expr_id, entry_count, std::move(optional_indices), string_keys);
 }
 
 absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateMutableMapStep(
@@ -31,14 +31,18 @@ namespace google::api::expr::runtime {
 //
 // Deps must have an even number of elements, that alternate key, value pairs.
 // (key1, value1, key2, value2...).
+//
+// If `string_keys` is true, maps whose keys are all strings are built with
+// `NewStringMapValueBuilder()`.
 std::unique_ptr<DirectExpressionStep> CreateDirectCreateMapStep(
     std::vector<std::unique_ptr<DirectExpressionStep>> deps,
-    absl::flat_hash_set<int32_t> optional_indices, int64_t expr_id);
+    absl::flat_hash_set<int32_t> optional_indices, int64_t expr_id,
+    bool string_keys = false);
 
 // Creates an `ExpressionStep` which performs `CreateStruct` for a map.
 absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateCreateStructStepForMap(
     size_t entry_count, absl::flat_hash_set<int32_t> optional_indices,
-    int64_t expr_id);
+    int64_t expr_id, bool string_keys = false);
 
 // Factory method for CreateMap which constructs a mutable map.
 //
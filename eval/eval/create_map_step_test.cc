@@ -56,7 +56,7 @@ using ::google::protobuf::Arena;
 
 absl::StatusOr<ExecutionPath> CreateStackMachineProgram(
     const std::vector<std::pair<CelValue, CelValue>>& values,
-    Activation& activation) {
+    Activation& activation, bool enable_string_keys) {
   ExecutionPath path;
 
   Expr expr1;
@@ -94,14 +94,15 @@ absl::StatusOr<ExecutionPath> CreateStackMachineProgram(
   }
 
   CEL_ASSIGN_OR_RETURN(
-      auto step1, CreateCreateStructStepForMap(values.size(), {}, expr1.id()));
+      auto step1, CreateCreateStructStepForMap(values.size(), {}, expr1.id(),
+                                               enable_string_keys));
   path.push_back(std::move(step1));
   return path;
 }
 
 absl::StatusOr<ExecutionPath> CreateRecursiveProgram(
     const std::vector<std::pair<CelValue, CelValue>>& values,
-    Activation& activation) {
+    Activation& activation, bool enable_string_keys) {
   ExecutionPath path;
 
   int index = 0;
@@ -120,7 +121,8 @@ absl::StatusOr<ExecutionPath> CreateRecursiveProgram(
     index++;
   }
   path.push_back(std::make_unique<WrappedDirectStep>(
-      CreateDirectCreateMapStep(std::move(deps), {}, -1), -1));
+      CreateDirectCreateMapStep(std::move(deps), {}, -1, enable_string_keys),
+      -1));
 
   return path;
 }
@@ -131,14 +133,17 @@ absl::StatusOr<ExecutionPath> CreateRecursiveProgram(
 absl::StatusOr<CelValue> RunCreateMapExpression(
     const absl_nonnull std::shared_ptr<const RuntimeEnv>& env,
     const std::vector<std::pair<CelValue, CelValue>>& values,
-    google::protobuf::Arena* arena, bool enable_unknowns, bool enable_recursive_program) {
+    google::protobuf::Arena* arena, bool enable_unknowns, bool enable_recursive_program,
+    bool enable_string_keys = false) {
   Activation activation;
 
   ExecutionPath path;
   if (enable_recursive_program) {
-    CEL_ASSIGN_OR_RETURN(path, CreateRecursiveProgram(values, activation));
+    CEL_ASSIGN_OR_RETURN(
+        path, CreateRecursiveProgram(values, activation, enable_string_keys));
   } else {
-    CEL_ASSIGN_OR_RETURN(path, CreateStackMachineProgram(values, activation));
+    CEL_ASSIGN_OR_RETURN(path, CreateStackMachineProgram(values, activation,
+                                                         enable_string_keys));
   }
   cel::RuntimeOptions options;
   if (enable_unknowns) {
@@ -153,17 +158,19 @@ absl::StatusOr<CelValue> RunCreateMapExpression(
 }
 
 class CreateMapStepTest
-    : public testing::TestWithParam<std::tuple<bool, bool>> {
+    : public testing::TestWithParam<std::tuple<bool, bool, bool>> {
  public:
   CreateMapStepTest() : env_(NewTestingRuntimeEnv()) {}
 
   bool enable_unknowns() { return std::get<0>(GetParam()); }
   bool enable_recursive_program() { return std::get<1>(GetParam()); }
+  bool enable_string_keys() { return std::get<2>(GetParam()); }
 
   absl::StatusOr<CelValue> RunMapExpression(
       const std::vector<std::pair<CelValue, CelValue>>& values) {
     return RunCreateMapExpression(env_, values, &arena_, enable_unknowns(),
-                                  enable_recursive_program());
+                                  enable_recursive_program(),
+                                  enable_string_keys());
   }
 
  protected:
@@ -282,7 +289,8 @@ TEST_P(CreateMapStepTest, TestCreateStringMap) {
 }
 
 INSTANTIATE_TEST_SUITE_P(CreateMapStep, CreateMapStepTest,
-                         testing::Combine(testing::Bool(), testing::Bool()));
+                         testing::Combine(testing::Bool(), testing::Bool(),
+                                          testing::Bool()));
 
 }  // namespace
 
@@ -15,12 +15,14 @@
 #include "common/expr.h"
 #include "common/value.h"
 #include "common/value_kind.h"
+#include "common/values/string_map_value.h"
 #include "eval/eval/attribute_trail.h"
 #include "eval/eval/direct_expression_step.h"
 #include "eval/eval/evaluator_core.h"
 #include "eval/eval/expression_step_base.h"
 #include "eval/internal/errors.h"
 #include "internal/status_macros.h"
+#include "runtime/generated_message_accessors.h"
 #include "runtime/runtime_options.h"
 #include "google/protobuf/arena.h"
 #include "google/protobuf/descriptor.h"
@@ -35,6 +37,7 @@ using ::cel::ErrorValue;
 using ::cel::MapValue;
 using ::cel::NullValue;
 using ::cel::OptionalValue;
+using ::cel::ParsedMessageValue;
 using ::cel::ProtoWrapperTypeOptions;
 using ::cel::StringValue;
 using ::cel::StructValue;
@@ -51,6 +54,22 @@ absl::Status InvalidSelectTargetError() {
                       "Applying SELECT to non-message type");
 }
 
+// Looks `field` up directly if `map` was built by `NewStringMapValueBuilder()`,
+// returning whether it was found. Otherwise returns `absl::nullopt` and the
+// caller should fall back to the generic map lookup.
+absl::optional<bool> FindInStringMap(const MapValue& map,
+                                     absl::string_view field, Value& result) {
+  auto value = cel::common_internal::FindInStringMapValue(map, field);
+  if (!value.has_value()) {
+    return absl::nullopt;
+  }
+  if (*value == nullptr) {
+    return false;
+  }
+  result = **value;
+  return true;
+}
+
 absl::optional<Value> CheckForMarkedAttributes(const AttributeTrail& trail,
                                                ExecutionFrameBase& frame) {
   if (frame.unknown_processing_enabled() &&
@@ -76,12 +95,82 @@ absl::optional<Value> CheckForMarkedAttributes(const AttributeTrail& trail,
   return absl::nullopt;
 }
 
+// Returns `value` as a message of the type that `field` belongs to, so that
+// `field` can be accessed without looking it up by name. Returns `nullptr` if
+// no field was bound at plan time or `value` is some other struct.
+const ParsedMessageValue* absl_nullable AsBoundMessage(
+    const StructValue& value,
+    const google::protobuf::FieldDescriptor* absl_nullable field) {
+  if (field == nullptr) {
+    return nullptr;
+  }
+  auto message = value.AsParsedMessage();
+  if (!message || message->GetDescriptor() != field->containing_type()) {
+    return nullptr;
+  }
+  return &*message;
+}
+
+// Returns `value` as a message which `accessor` can read, or `nullptr` if no
+// generated accessor was bound at plan time or `value` is not an instance of
+// the generated class.
+const google::protobuf::Message* absl_nullable AsGeneratedMessage(
+    const StructValue& value,
+    const cel::GeneratedFieldAccessor* absl_nullable accessor) {
+  if (accessor == nullptr) {
+    return nullptr;
+  }
+  auto message = value.AsParsedMessage();
+  if (!message || !accessor->is_instance(**message)) {
+    return nullptr;
+  }
+  return &**message;
+}
+
+absl::Status GetStructField(
+    const StructValue& value, const std::string& name,
+    const google::protobuf::FieldDescriptor* absl_nullable field,
+    const cel::GeneratedFieldAccessor* absl_nullable accessor,
+    ProtoWrapperTypeOptions unboxing_option,
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena, Value* absl_nonnull result) {
+  if (const auto* message = AsGeneratedMessage(value, accessor);
+      message != nullptr) {
+    *result = accessor->get(*message, descriptor_pool, message_factory, arena);
+    return absl::OkStatus();
+  }
+  if (const auto* message = AsBoundMessage(value, field); message != nullptr) {
+    return message->GetField(field, unboxing_option, descriptor_pool,
+                             message_factory, arena, result);
+  }
+  return value.GetFieldByName(name, unboxing_option, descriptor_pool,
+                              message_factory, arena, result);
+}
+
+absl::StatusOr<bool> HasStructField(
+    const StructValue& value, const std::string& name,
+    const google::protobuf::FieldDescriptor* absl_nullable field,
+    const cel::GeneratedFieldAccessor* absl_nullable accessor) {
+  if (const auto* message = AsGeneratedMessage(value, accessor);
+      message != nullptr) {
+    return accessor->has(*message);
+  }
+  if (const auto* message = AsBoundMessage(value, field); message != nullptr) {
+    return message->HasField(field);
+  }
+  return value.HasFieldByName(name);
+}
+
 void TestOnlySelect(const StructValue& msg, const std::string& field,
+                    const google::protobuf::FieldDescriptor* absl_nullable field_descriptor,
+                    const cel::GeneratedFieldAccessor* absl_nullable field_accessor,
                     const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
                     google::protobuf::MessageFactory* absl_nonnull message_factory,
                     google::protobuf::Arena* absl_nonnull arena,
                     Value* absl_nonnull result) {
-  absl::StatusOr<bool> has_field = msg.HasFieldByName(field);
+  absl::StatusOr<bool> has_field =
+      HasStructField(msg, field, field_descriptor, field_accessor);
 
   if (!has_field.ok()) {
     *result = ErrorValue(std::move(has_field).status());
@@ -111,11 +200,16 @@ void TestOnlySelect(const MapValue& map, const StringValue& field_name,
 // message.
 class SelectStep : public ExpressionStepBase {
  public:
-  SelectStep(StringValue value, bool test_field_presence, int64_t expr_id,
+  SelectStep(StringValue value,
+             const google::protobuf::FieldDescriptor* absl_nullable field_descriptor,
+             const cel::GeneratedFieldAccessor* absl_nullable field_accessor,
+             bool test_field_presence, int64_t expr_id,
              bool enable_wrapper_type_null_unboxing, bool enable_optional_types)
       : ExpressionStepBase(expr_id),
         field_value_(std::move(value)),
         field_(field_value_.ToString()),
+        field_descriptor_(field_descriptor),
+        field_accessor_(field_accessor),
         test_field_presence_(test_field_presence),
         unboxing_option_(enable_wrapper_type_null_unboxing
                              ? ProtoWrapperTypeOptions::kUnsetNull
@@ -132,6 +226,8 @@ class SelectStep : public ExpressionStepBase {
 
   cel::StringValue field_value_;
   std::string field_;
+  const google::protobuf::FieldDescriptor* absl_nullable field_descriptor_;
+  const cel::GeneratedFieldAccessor* absl_nullable field_accessor_;
   bool test_field_presence_;
   ProtoWrapperTypeOptions unboxing_option_;
   bool enable_optional_types_;
@@ -227,9 +323,10 @@ absl::Status SelectStep::Evaluate(ExecutionFrame* frame) const {
   switch (arg.kind()) {
     case ValueKind::kStruct: {
       Value result;
-      auto status = arg.GetStruct().GetFieldByName(
-          field_, unboxing_option_, frame->descriptor_pool(),
-          frame->message_factory(), frame->arena(), &result);
+      auto status = GetStructField(
+          arg.GetStruct(), field_, field_descriptor_, field_accessor_,
+          unboxing_option_, frame->descriptor_pool(), frame->message_factory(),
+          frame->arena(), &result);
       if (!status.ok()) {
         result = ErrorValue(std::move(status));
       }
@@ -239,6 +336,14 @@ absl::Status SelectStep::Evaluate(ExecutionFrame* frame) const {
     }
     case ValueKind::kMap: {
       Value result;
+      if (auto found = FindInStringMap(arg.GetMap(), field_, result); found) {
+        if (!*found) {
+          result = cel::NoSuchKeyError(field_value_.DebugString());
+        }
+        frame->value_stack().PopAndPush(std::move(result),
+                                        std::move(result_trail));
+        return absl::OkStatus();
+      }
       auto status =
           arg.GetMap().Get(field_value_, frame->descriptor_pool(),
                            frame->message_factory(), frame->arena(), &result);
@@ -267,7 +372,8 @@ absl::Status SelectStep::PerformTestOnlySelect(ExecutionFrame* frame,
     }
     case ValueKind::kMessage: {
       Value result;
-      TestOnlySelect(arg.GetStruct(), field_, frame->descriptor_pool(),
+      TestOnlySelect(arg.GetStruct(), field_, field_descriptor_,
+                     field_accessor_, frame->descriptor_pool(),
                      frame->message_factory(), frame->arena(), &result);
       frame->value_stack().PopAndPush(std::move(result));
       return absl::OkStatus();
@@ -284,18 +390,24 @@ absl::StatusOr<bool> SelectStep::PerformSelect(ExecutionFrame* frame,
   switch (arg->kind()) {
     case ValueKind::kStruct: {
       const auto& struct_value = arg.GetStruct();
-      CEL_ASSIGN_OR_RETURN(auto ok, struct_value.HasFieldByName(field_));
+      CEL_ASSIGN_OR_RETURN(
+          auto ok, HasStructField(struct_value, field_, field_descriptor_,
+                                  field_accessor_));
       if (!ok) {
         result = NullValue{};
         return false;
       }
-      CEL_RETURN_IF_ERROR(struct_value.GetFieldByName(
-          field_, unboxing_option_, frame->descriptor_pool(),
-          frame->message_factory(), frame->arena(), &result));
+      CEL_RETURN_IF_ERROR(GetStructField(
+          struct_value, field_, field_descriptor_, field_accessor_,
+          unboxing_option_, frame->descriptor_pool(), frame->message_factory(),
+          frame->arena(), &result));
       ABSL_DCHECK(!result.IsUnknown());
       return true;
     }
     case ValueKind::kMap: {
+      if (auto found = FindInStringMap(arg.GetMap(), field_, result); found) {
+        return *found;
+      }
       CEL_ASSIGN_OR_RETURN(
           auto found,
           arg.GetMap().Find(field_value_, frame->descriptor_pool(),
@@ -313,13 +425,17 @@ class DirectSelectStep : public DirectExpressionStep {
  public:
   DirectSelectStep(int64_t expr_id,
                    std::unique_ptr<DirectExpressionStep> operand,
-                   StringValue field, bool test_only,
-                   bool enable_wrapper_type_null_unboxing,
+                   StringValue field,
+                   const google::protobuf::FieldDescriptor* absl_nullable field_descriptor,
+                   const cel::GeneratedFieldAccessor* absl_nullable field_accessor,
+                   bool test_only, bool enable_wrapper_type_null_unboxing,
                    bool enable_optional_types)
       : DirectExpressionStep(expr_id),
         operand_(std::move(operand)),
         field_value_(std::move(field)),
         field_(field_value_.ToString()),
+        field_descriptor_(field_descriptor),
+        field_accessor_(field_accessor),
         test_only_(test_only),
         unboxing_option_(enable_wrapper_type_null_unboxing
                              ? ProtoWrapperTypeOptions::kUnsetNull
@@ -416,6 +532,13 @@ class DirectSelectStep : public DirectExpressionStep {
   StringValue field_value_;
   std::string field_;
 
+  // The field's descriptor, if the planner resolved the operand to a message
+  // type.
+  const google::protobuf::FieldDescriptor* absl_nullable field_descriptor_;
+
+  // The field's generated accessor, if one was registered for that type.
+  const cel::GeneratedFieldAccessor* absl_nullable field_accessor_;
+
   // whether this is a has() expression.
   bool test_only_;
   ProtoWrapperTypeOptions unboxing_option_;
@@ -431,7 +554,8 @@ void DirectSelectStep::PerformTestOnlySelect(ExecutionFrameBase& frame,
                      frame.message_factory(), frame.arena(), &result);
       return;
     case ValueKind::kMessage:
-      TestOnlySelect(value.GetStruct(), field_, frame.descriptor_pool(),
+      TestOnlySelect(value.GetStruct(), field_, field_descriptor_,
+                     field_accessor_, frame.descriptor_pool(),
                      frame.message_factory(), frame.arena(), &result);
       return;
     default:
@@ -447,23 +571,33 @@ absl::Status DirectSelectStep::PerformOptionalSelect(ExecutionFrameBase& frame,
   switch (value.kind()) {
     case ValueKind::kStruct: {
       auto struct_value = value.GetStruct();
-      CEL_ASSIGN_OR_RETURN(auto ok, struct_value.HasFieldByName(field_));
+      CEL_ASSIGN_OR_RETURN(
+          auto ok, HasStructField(struct_value, field_, field_descriptor_,
+                                  field_accessor_));
       if (!ok) {
         result = OptionalValue::None();
         return absl::OkStatus();
       }
-      CEL_RETURN_IF_ERROR(struct_value.GetFieldByName(
-          field_, unboxing_option_, frame.descriptor_pool(),
-          frame.message_factory(), frame.arena(), &result));
+      CEL_RETURN_IF_ERROR(GetStructField(
+          struct_value, field_, field_descriptor_, field_accessor_,
+          unboxing_option_, frame.descriptor_pool(), frame.message_factory(),
+          frame.arena(), &result));
       ABSL_DCHECK(!result.IsUnknown());
       result = OptionalValue::Of(std::move(result), frame.arena());
       return absl::OkStatus();
     }
     case ValueKind::kMap: {
-      CEL_ASSIGN_OR_RETURN(
-          auto found,
-          value.GetMap().Find(field_value_, frame.descriptor_pool(),
-                              frame.message_factory(), frame.arena(), &result));
+      absl::optional<bool> string_map_found =
+          FindInStringMap(value.GetMap(), field_, result);
+      bool found;
+      if (string_map_found.has_value()) {
+        found = *string_map_found;
+      } else {
+        CEL_ASSIGN_OR_RETURN(
+            found, value.GetMap().Find(field_value_, frame.descriptor_pool(),
+                                       frame.message_factory(), frame.arena(),
+                                       &result));
+      }
       if (!found) {
         result = OptionalValue::None();
         return absl::OkStatus();
@@ -483,12 +617,20 @@ absl::Status DirectSelectStep::PerformSelect(ExecutionFrameBase& frame,
                                              Value& result) const {
   switch (value.kind()) {
     case ValueKind::kStruct:
-      CEL_RETURN_IF_ERROR(value.GetStruct().GetFieldByName(
-          field_, unboxing_option_, frame.descriptor_pool(),
-          frame.message_factory(), frame.arena(), &result));
+      CEL_RETURN_IF_ERROR(GetStructField(
+          value.GetStruct(), field_, field_descriptor_, field_accessor_,
+          unboxing_option_, frame.descriptor_pool(), frame.message_factory(),
+          frame.arena(), &result));
       ABSL_DCHECK(!result.IsUnknown());
       return absl::OkStatus();
     case ValueKind::kMap:
+      if (auto found = FindInStringMap(value.GetMap(), field_, result);
+          found) {
+        if (!*found) {
+          result = cel::NoSuchKeyError(field_value_.DebugString());
+        }
+        return absl::OkStatus();
+      }
       CEL_RETURN_IF_ERROR(
           value.GetMap().Get(field_value_, frame.descriptor_pool(),
                              frame.message_factory(), frame.arena(), &result));
@@ -505,19 +647,25 @@ absl::Status DirectSelectStep::PerformSelect(ExecutionFrameBase& frame,
 std::unique_ptr<DirectExpressionStep> CreateDirectSelectStep(
     std::unique_ptr<DirectExpressionStep> operand, StringValue field,
     bool test_only, int64_t expr_id, bool enable_wrapper_type_null_unboxing,
-    bool enable_optional_types) {
+    bool enable_optional_types,
+    const google::protobuf::FieldDescriptor* absl_nullable field_descriptor,
+    const cel::GeneratedFieldAccessor* absl_nullable field_accessor) {
   return std::make_unique<DirectSelectStep>(
-      expr_id, std::move(operand), std::move(field), test_only,
-      enable_wrapper_type_null_unboxing, enable_optional_types);
+      expr_id, std::move(operand), std::move(field), field_descriptor,
+      field_accessor, test_only, enable_wrapper_type_null_unboxing,
+      enable_optional_types);
 }
 
 // Factory method for Select - based Execution step
 absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateSelectStep(
     const cel::SelectExpr& select_expr, int64_t expr_id,
-    bool enable_wrapper_type_null_unboxing, bool enable_optional_types) {
+    bool enable_wrapper_type_null_unboxing, bool enable_optional_types,
+    const google::protobuf::FieldDescriptor* absl_nullable field_descriptor,
+    const cel::GeneratedFieldAccessor* absl_nullable field_accessor) {
   return std::make_unique<SelectStep>(
-      cel::StringValue(select_expr.field()), select_expr.test_only(), expr_id,
-      enable_wrapper_type_null_unboxing, enable_optional_types);
+      cel::StringValue(select_expr.field()), field_descriptor, field_accessor,
+      select_expr.test_only(), expr_id, enable_wrapper_type_null_unboxing,
+      enable_optional_types);
 }
 
 }  // namespace google::api::expr::runtime
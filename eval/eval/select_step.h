@@ -4,24 +4,44 @@
 #include <cstdint>
 #include <memory>
 
+#include "absl/base/nullability.h"
 #include "absl/status/statusor.h"
 #include "common/expr.h"
 #include "common/value.h"
 #include "eval/eval/direct_expression_step.h"
 #include "eval/eval/evaluator_core.h"
+#include "runtime/generated_message_accessors.h"
+#include "google/protobuf/descriptor.h"
 
 namespace google::api::expr::runtime {
 
 // Factory method for recursively evaluated select step.
+//
+// `field_descriptor`, if not null, is the descriptor of the selected field
+// resolved at plan time. Operands which are messages of the type it belongs to
+// then access it directly instead of looking it up by name; other operands
+// are unaffected.
+//
+// `field_accessor`, if not null, is the generated accessor registered for the
+// selected field. Operands which are instances of the generated class then
+// read the field through it instead of through reflection.
 std::unique_ptr<DirectExpressionStep> CreateDirectSelectStep(
     std::unique_ptr<DirectExpressionStep> operand, cel::StringValue field,
     bool test_only, int64_t expr_id, bool enable_wrapper_type_null_unboxing,
-    bool enable_optional_types = false);
+    bool enable_optional_types = false,
+    const google::protobuf::FieldDescriptor* absl_nullable field_descriptor =
+        nullptr,
+    const cel::GeneratedFieldAccessor* absl_nullable field_accessor = nullptr);
 
 // Factory method for Select - based Execution step
+//
+// See `CreateDirectSelectStep()` for `field_descriptor` and `field_accessor`.
 absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateSelectStep(
     const cel::SelectExpr& select_expr, int64_t expr_id,
-    bool enable_wrapper_type_null_unboxing, bool enable_optional_types = false);
+    bool enable_wrapper_type_null_unboxing, bool enable_optional_types = false,
+    const google::protobuf::FieldDescriptor* absl_nullable field_descriptor =
+        nullptr,
+    const cel::GeneratedFieldAccessor* absl_nullable field_accessor = nullptr);
 
 }  // namespace google::api::expr::runtime
 
@@ -43,11 +43,16 @@
 #include "internal/testing_descriptor_pool.h"
 #include "internal/testing_message_factory.h"
 #include "runtime/activation.h"
+#include "runtime/generated_message_accessors.h"
 #include "runtime/internal/runtime_env.h"
 #include "runtime/internal/runtime_env_testing.h"
 #include "runtime/internal/runtime_type_provider.h"
 #include "runtime/runtime_options.h"
 #include "cel/expr/conformance/proto3/test_all_types.pb.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/dynamic_message.h"
+#include "google/protobuf/message.h"
 
 namespace google::api::expr::runtime {
 
@@ -1403,6 +1408,130 @@ TEST_F(DirectSelectStepTest, HasStruct) {
   EXPECT_FALSE(Cast<BoolValue>(result).NativeValue());
 }
 
+TEST_F(DirectSelectStepTest, SelectFromStructWithFieldDescriptor) {
+  cel::Activation activation;
+  RuntimeOptions options;
+
+  TestAllTypes message;
+  message.set_single_int64(1);
+  message.set_single_int32(2);
+  ASSERT_OK_AND_ASSIGN(
+      Value struct_val,
+      ProtoMessageToValue(std::move(message),
+                          cel::internal::GetTestingDescriptorPool(),
+                          cel::internal::GetTestingMessageFactory(), &arena_));
+  ASSERT_TRUE(struct_val.IsParsedMessage());
+  activation.InsertOrAssignValue("test_all_types", struct_val);
+  const google::protobuf::Descriptor* descriptor =
+      struct_val.GetParsedMessage().GetDescriptor();
+
+  ExecutionFrameBase frame(activation, options, type_provider_,
+                           cel::internal::GetTestingDescriptorPool(),
+                           cel::internal::GetTestingMessageFactory(), &arena_);
+
+  // The bound descriptor is used instead of the name, so binding a different
+  // field shows that no lookup by name happens.
+  auto step = CreateDirectSelectStep(
+      CreateDirectIdentStep("test_all_types", -1),
+      cel::StringValue("single_int64"), /*test_only=*/false, -1,
+      /*enable_wrapper_type_null_unboxing=*/true,
+      /*enable_optional_types=*/false,
+      descriptor->FindFieldByName("single_int32"));
+  Value result;
+  AttributeTrail attr;
+  ASSERT_THAT(step->Evaluate(frame, result, attr), IsOk());
+  EXPECT_THAT(result, IntValueIs(2));
+
+  auto has_step = CreateDirectSelectStep(
+      CreateDirectIdentStep("test_all_types", -1),
+      cel::StringValue("single_string"), /*test_only=*/true, -1,
+      /*enable_wrapper_type_null_unboxing=*/true,
+      /*enable_optional_types=*/false,
+      descriptor->FindFieldByName("single_string"));
+  ASSERT_THAT(has_step->Evaluate(frame, result, attr), IsOk());
+  ASSERT_TRUE(InstanceOf<BoolValue>(result));
+  EXPECT_FALSE(Cast<BoolValue>(result).NativeValue());
+
+  // A descriptor of another message type is ignored.
+  auto other_step = CreateDirectSelectStep(
+      CreateDirectIdentStep("test_all_types", -1),
+      cel::StringValue("single_int64"), /*test_only=*/false, -1,
+      /*enable_wrapper_type_null_unboxing=*/true,
+      /*enable_optional_types=*/false,
+      TestAllTypes::NestedMessage::descriptor()->FindFieldByName("bb"));
+  ASSERT_THAT(other_step->Evaluate(frame, result, attr), IsOk());
+  EXPECT_THAT(result, IntValueIs(1));
+}
+
+bool IsTestAllTypes(const google::protobuf::Message& message) {
+  return google::protobuf::DynamicCastMessage<TestAllTypes>(&message) != nullptr;
+}
+
+// Reports a value that reflection would not, so that tests can tell which
+// path was taken.
+cel::Value GetSingleInt64PlusOne(
+    const google::protobuf::Message& message,
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena) {
+  return cel::IntValue(
+      google::protobuf::DownCastMessage<TestAllTypes>(message).single_int64() + 1);
+}
+
+bool HasSingleInt64Inverted(const google::protobuf::Message& message) {
+  return google::protobuf::DownCastMessage<TestAllTypes>(message).single_int64() == 0;
+}
+
+TEST_F(DirectSelectStepTest, SelectFromStructWithGeneratedAccessor) {
+  cel::Activation activation;
+  RuntimeOptions options;
+  const cel::GeneratedFieldAccessor accessor = {
+      TestAllTypes::kSingleInt64FieldNumber, &IsTestAllTypes,
+      &GetSingleInt64PlusOne, &HasSingleInt64Inverted};
+
+  auto* message = google::protobuf::Arena::Create<TestAllTypes>(&arena_);
+  message->set_single_int64(1);
+  activation.InsertOrAssignValue("test_all_types",
+                                 cel::ParsedMessageValue(message, &arena_));
+
+  ExecutionFrameBase frame(activation, options, type_provider_,
+                           cel::internal::GetTestingDescriptorPool(),
+                           cel::internal::GetTestingMessageFactory(), &arena_);
+
+  auto step = CreateDirectSelectStep(
+      CreateDirectIdentStep("test_all_types", -1),
+      cel::StringValue("single_int64"), /*test_only=*/false, -1,
+      /*enable_wrapper_type_null_unboxing=*/true,
+      /*enable_optional_types=*/false, /*field_descriptor=*/nullptr,
+      &accessor);
+  Value result;
+  AttributeTrail attr;
+  ASSERT_THAT(step->Evaluate(frame, result, attr), IsOk());
+  EXPECT_THAT(result, IntValueIs(2));
+
+  auto has_step = CreateDirectSelectStep(
+      CreateDirectIdentStep("test_all_types", -1),
+      cel::StringValue("single_int64"), /*test_only=*/true, -1,
+      /*enable_wrapper_type_null_unboxing=*/true,
+      /*enable_optional_types=*/false, /*field_descriptor=*/nullptr,
+      &accessor);
+  ASSERT_THAT(has_step->Evaluate(frame, result, attr), IsOk());
+  ASSERT_TRUE(InstanceOf<BoolValue>(result));
+  EXPECT_FALSE(Cast<BoolValue>(result).NativeValue());
+
+  // Messages which are not instances of the generated class use reflection.
+  google::protobuf::DynamicMessageFactory dynamic_factory;
+  google::protobuf::Message* dynamic_message =
+      dynamic_factory.GetPrototype(TestAllTypes::descriptor())->New(&arena_);
+  dynamic_message->GetReflection()->SetInt64(
+      dynamic_message,
+      TestAllTypes::descriptor()->FindFieldByName("single_int64"), 1);
+  activation.InsertOrAssignValue(
+      "test_all_types", cel::ParsedMessageValue(dynamic_message, &arena_));
+  ASSERT_THAT(step->Evaluate(frame, result, attr), IsOk());
+  EXPECT_THAT(result, IntValueIs(1));
+}
+
 TEST_F(DirectSelectStepTest, SelectFromUnsupportedType) {
   cel::Activation activation;
   RuntimeOptions options;
@@ -17,19 +17,9 @@
 #include "absl/status/status.h"
 #include "eval/public/cel_function_registry.h"
 #include "eval/public/cel_options.h"
-#include "internal/status_macros.h"
 #include "runtime/function_registry.h"
 #include "runtime/runtime_options.h"
-#include "runtime/standard/arithmetic_functions.h"
-#include "runtime/standard/comparison_functions.h"
-#include "runtime/standard/container_functions.h"
-#include "runtime/standard/container_membership_functions.h"
-#include "runtime/standard/equality_functions.h"
-#include "runtime/standard/logical_functions.h"
-#include "runtime/standard/regex_functions.h"
-#include "runtime/standard/string_functions.h"
-#include "runtime/standard/time_functions.h"
-#include "runtime/standard/type_conversion_functions.h"
+#include "runtime/standard_functions.h"
 
 namespace google::api::expr::runtime {
 
@@ -38,28 +28,7 @@ absl::Status RegisterBuiltinFunctions(CelFunctionRegistry* registry,
   cel::FunctionRegistry& modern_registry = registry->InternalGetRegistry();
   cel::RuntimeOptions runtime_options = ConvertToRuntimeOptions(options);
 
-  CEL_RETURN_IF_ERROR(
-      cel::RegisterLogicalFunctions(modern_registry, runtime_options));
-  CEL_RETURN_IF_ERROR(
-      cel::RegisterComparisonFunctions(modern_registry, runtime_options));
-  CEL_RETURN_IF_ERROR(
-      cel::RegisterContainerFunctions(modern_registry, runtime_options));
-  CEL_RETURN_IF_ERROR(cel::RegisterContainerMembershipFunctions(
-      modern_registry, runtime_options));
-  CEL_RETURN_IF_ERROR(
-      cel::RegisterTypeConversionFunctions(modern_registry, runtime_options));
-  CEL_RETURN_IF_ERROR(
-      cel::RegisterArithmeticFunctions(modern_registry, runtime_options));
-  CEL_RETURN_IF_ERROR(
-      cel::RegisterTimeFunctions(modern_registry, runtime_options));
-  CEL_RETURN_IF_ERROR(
-      cel::RegisterStringFunctions(modern_registry, runtime_options));
-  CEL_RETURN_IF_ERROR(
-      cel::RegisterRegexFunctions(modern_registry, runtime_options));
-  CEL_RETURN_IF_ERROR(
-      cel::RegisterEqualityFunctions(modern_registry, runtime_options));
-
-  return absl::OkStatus();
+  return cel::RegisterStandardFunctions(modern_registry, runtime_options);
 }
 
 }  // namespace google::api::expr::runtime
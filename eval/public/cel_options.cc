@@ -28,6 +28,11 @@ cel::RuntimeOptions ConvertToRuntimeOptions(const InterpreterOptions& options) {
                              options.comprehension_max_iterations,
                              options.enable_comprehension_list_append,
                              options.enable_comprehension_mutable_map,
+                             options.enable_comprehension_chain_shortcircuit,
+                             options.enable_persistent_collections,
+                             options.enable_unboxed_primitive_lists,
+                             options.enable_string_keyed_maps,
+                             options.enable_constant_map_literals,
                              options.enable_regex,
                              options.regex_max_program_size,
                              options.enable_string_conversion,
@@ -70,12 +70,69 @@ struct InterpreterOptions {
 
   // Enable list append within comprehensions. Note, this option is not safe
   // with hand-rolled ASTs.
+  //
+  // Comprehensions with the map() / filter() macro shape whose accumulator is
+  // only referenced by the append and the result use list append regardless
+  // of this option; it extends the optimization to every comprehension with
+  // the macro shape.
   bool enable_comprehension_list_append = false;
 
   // Enable mutable map construction within comprehensions. Note, this option is
   // not safe with hand-rolled ASTs.
+  //
+  // Map transformation comprehensions whose accumulator starts out empty and
+  // is only referenced by the insert and the result use a mutable map
+  // regardless of this option.
   bool enable_comprehension_mutable_map = false;
 
+  // Allow a fused chain of map() / filter() comprehensions that ends in
+  // all() or exists() to stop as soon as the quantifier is decided.
+  //
+  // With recursive planning, chains such as
+  // `xs.map(x, f(x)).filter(y, g(y)).exists(z, h(z))` are evaluated in a
+  // single pass without building the intermediate lists. By default the
+  // remaining elements are still passed through the map() / filter() stages
+  // after the result is decided, so an error from any of them is reported the
+  // same way as in the unfused chain. Enabling this option skips that work,
+  // and such errors are no longer observed.
+  bool enable_comprehension_chain_shortcircuit = false;
+
+  // Represent the results of list concatenation and `cel.@mapInsert` as
+  // structurally shared lists and maps.
+  //
+  // Comprehensions whose accumulator cannot be mutated in place, such as
+  // `accu + [x]` in a hand-written comprehension or transformMap() over a
+  // non-empty initial map, otherwise copy the whole accumulator on every
+  // iteration. With this option each step costs O(log n) instead, and earlier
+  // accumulator values are left unchanged. Indexing into the resulting values
+  // is O(log n) rather than constant.
+  bool enable_persistent_collections = false;
+
+  // Store list literals whose elements are all `int`, `uint`, `double`, `bool`
+  // or `string` in a contiguous native array, boxing elements on access.
+  //
+  // This reduces the memory held per element several times and lets
+  // membership tests, equality between such lists, math.sum(), lists.min(),
+  // lists.max() and sort() work on the native values. Passing such lists to
+  // functions registered through the legacy CelValue API copies them.
+  bool enable_unboxed_primitive_lists = false;
+
+  // Build map literals whose keys are all strings as an open-addressed table
+  // over arrays of key bytes, precomputed hashes and values.
+  //
+  // Field selection and indexing by string then hash the key bytes directly
+  // and compare hashes before key bytes, and iteration follows insertion
+  // order. Passing such maps to functions registered through the legacy
+  // CelValue API copies them.
+  bool enable_string_keyed_maps = false;
+
+  // Build map literals whose keys and values are all literals once, when the
+  // expression is planned, instead of on every evaluation.
+  //
+  // The map is shared by all evaluations of the program and its keys are
+  // indexed by a perfect hash, so that a lookup probes a single slot.
+  bool enable_constant_map_literals = false;
+
   // Enable RE2 match() overload.
   bool enable_regex = true;
 
@@ -184,6 +241,11 @@ struct InterpreterOptions {
   // This does not account for re-entrant evaluation in a client's extension
   // function.
   //
+  // Only recursively planned subexpressions evaluate the standard all(),
+  // exists(), map() and filter() macros with fused loop steps. The stack
+  // machine plan (0, or subexpressions beyond the limit) uses the generic
+  // comprehension steps.
+  //
   // -1 means unbounded.
   int max_recursion_depth = 0;
 
@@ -26,7 +26,12 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "checker/standard_library.h"
+#include "common/decl.h"
 #include "common/minimal_descriptor_pool.h"
+#include "common/type.h"
+#include "compiler/compiler_factory.h"
 #include "eval/public/builtin_func_registrar.h"
 #include "eval/public/cel_expr_builder_factory.h"
 #include "eval/public/cel_expression.h"
@@ -37,6 +42,9 @@
 #include "internal/status_macros.h"
 #include "internal/testing.h"
 #include "parser/parser.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_runtime_builder_factory.h"
+#include "tools/bulk_compiler.h"
 #include "google/protobuf/arena.h"
 
 namespace google::api::expr::runtime {
@@ -411,5 +419,75 @@ void BM_StringConcat32Concurrent(benchmark::State& state) {
 
 BENCHMARK(BM_StringConcat32Concurrent)->ThreadRange(1, 32);
 
+// Policy-like expressions that differ in their constants, so that no two
+// expressions in a batch are identical.
+std::vector<std::string> MakeBulkSources(int count) {
+  std::vector<std::string> sources;
+  sources.reserve(count);
+  for (int i = 0; i < count; ++i) {
+    sources.push_back(absl::StrCat(
+        "request.path.startsWith('/v", i % 7, "/') && request.token in ['t",
+        i, "', 'admin'] && (request.size > ", i,
+        " || request.ip in ['10.0.", i % 256, ".1', '10.0.", i % 256,
+        ".2'])"));
+  }
+  return sources;
+}
+
+void BM_BulkCompile(benchmark::State& state) {
+  const int num_expressions = state.range(0);
+  const int num_threads = state.range(1);
+
+  ASSERT_OK_AND_ASSIGN(
+      auto compiler_builder,
+      cel::NewCompilerBuilder(cel::GetMinimalDescriptorPool()));
+  ASSERT_OK(compiler_builder->AddLibrary(cel::StandardCheckerLibrary()));
+  ASSERT_OK(compiler_builder->GetCheckerBuilder().AddVariable(
+      cel::MakeVariableDecl("request", cel::JsonMapType())));
+  ASSERT_OK_AND_ASSIGN(auto compiler, std::move(*compiler_builder).Build());
+
+  ASSERT_OK_AND_ASSIGN(auto runtime_builder,
+                       cel::CreateStandardRuntimeBuilder(
+                           cel::GetMinimalDescriptorPool(),
+                           cel::RuntimeOptions()));
+  ASSERT_OK_AND_ASSIGN(auto runtime, std::move(runtime_builder).Build());
+
+  std::vector<std::string> sources = MakeBulkSources(num_expressions);
+  cel::BulkCompileOptions options;
+  options.num_threads = num_threads;
+
+  cel::BulkCompileTimings timings;
+  for (auto _ : state) {
+    cel::BulkCompileResult result =
+        cel::BulkCompile(*compiler, *runtime, sources, options);
+    for (const auto& program : result.programs) {
+      ABSL_DCHECK_OK(program);
+    }
+    timings.parse += result.timings.parse;
+    timings.check += result.timings.check;
+    timings.plan += result.timings.plan;
+    benchmark::DoNotOptimize(result);
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_expressions);
+  state.counters["parse_ms"] =
+      benchmark::Counter(absl::ToDoubleMilliseconds(timings.parse),
+                         benchmark::Counter::kAvgIterations);
+  state.counters["check_ms"] =
+      benchmark::Counter(absl::ToDoubleMilliseconds(timings.check),
+                         benchmark::Counter::kAvgIterations);
+  state.counters["plan_ms"] =
+      benchmark::Counter(absl::ToDoubleMilliseconds(timings.plan),
+                         benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BM_BulkCompile)
+    ->ArgNames({"expressions", "threads"})
+    ->Args({10000, 1})
+    ->Args({10000, 4})
+    ->Args({10000, 16})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
 }  // namespace
 }  // namespace google::api::expr::runtime
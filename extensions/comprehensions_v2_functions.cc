@@ -21,6 +21,7 @@
 #include "absl/status/statusor.h"
 #include "common/value.h"
 #include "common/values/map_value_builder.h"
+#include "common/values/persistent_map_value.h"
 #include "eval/public/cel_function_registry.h"
 #include "eval/public/cel_options.h"
 #include "internal/status_macros.h"
@@ -116,6 +117,43 @@ absl::StatusOr<Value> MapInsertMap(
   return std::move(*builder).Build();
 }
 
+// Like MapInsertKeyValue, but the slow path shares structure with `map`
+// instead of copying it.
+absl::StatusOr<Value> PersistentMapInsertKeyValue(
+    const MapValue& map, const Value& key, const Value& value,
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena) {
+  if (common_internal::AsMutableMapValue(map)) {
+    return MapInsertKeyValue(map, key, value, descriptor_pool, message_factory,
+                             arena);
+  }
+  CEL_ASSIGN_OR_RETURN(
+      auto result,
+      common_internal::PersistentMapInsert(map, key, value, descriptor_pool,
+                                           message_factory, arena),
+      _.With(ErrorValueReturn()));
+  return result;
+}
+
+// Like MapInsertMap, but the slow path shares structure with `map` instead of
+// copying it.
+absl::StatusOr<Value> PersistentMapInsertMap(
+    const MapValue& map, const MapValue& value,
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena) {
+  if (common_internal::AsMutableMapValue(map)) {
+    return MapInsertMap(map, value, descriptor_pool, message_factory, arena);
+  }
+  CEL_ASSIGN_OR_RETURN(
+      auto result,
+      common_internal::PersistentMapMerge(map, value, descriptor_pool,
+                                          message_factory, arena),
+      _.With(ErrorValueReturn()));
+  return result;
+}
+
 }  // namespace
 
 absl::Status RegisterComprehensionsV2Functions(FunctionRegistry& registry,
@@ -124,15 +162,19 @@ absl::Status RegisterComprehensionsV2Functions(FunctionRegistry& registry,
       TernaryFunctionAdapter<absl::StatusOr<Value>, MapValue, Value,
                              Value>::CreateDescriptor("cel.@mapInsert",
                                                       /*receiver_style=*/false),
-      TernaryFunctionAdapter<absl::StatusOr<Value>, MapValue, Value,
-                             Value>::WrapFunction(&MapInsertKeyValue)));
+      TernaryFunctionAdapter<absl::StatusOr<Value>, MapValue, Value, Value>::
+          WrapFunction(options.enable_persistent_collections
+                           ? &PersistentMapInsertKeyValue
+                           : &MapInsertKeyValue)));
 
   CEL_RETURN_IF_ERROR(registry.Register(
       BinaryFunctionAdapter<absl::StatusOr<Value>, MapValue, MapValue>::
           CreateDescriptor("cel.@mapInsert",
                            /*receiver_style=*/false),
-      BinaryFunctionAdapter<absl::StatusOr<Value>, MapValue,
-                            MapValue>::WrapFunction(&MapInsertMap)));
+      BinaryFunctionAdapter<absl::StatusOr<Value>, MapValue, MapValue>::
+          WrapFunction(options.enable_persistent_collections
+                           ? &PersistentMapInsertMap
+                           : &MapInsertMap)));
 
   return absl::OkStatus();
 }
@@ -55,7 +55,7 @@ using ::testing::TestWithParam;
 
 absl::StatusOr<std::unique_ptr<Program>> CreateProgram(
     const std::string& expression, bool enable_mutable_accumulator,
-    int max_recursion_depth) {
+    int max_recursion_depth, bool enable_persistent_collections = false) {
   // Configure the compiler
   CEL_ASSIGN_OR_RETURN(
       auto compiler_builder,
@@ -75,6 +75,7 @@ absl::StatusOr<std::unique_ptr<Program>> CreateProgram(
   options.enable_comprehension_list_append = enable_mutable_accumulator;
   options.enable_comprehension_mutable_map = enable_mutable_accumulator;
   options.max_recursion_depth = max_recursion_depth;
+  options.enable_persistent_collections = enable_persistent_collections;
 
   CEL_ASSIGN_OR_RETURN(auto runtime_builder,
                        CreateStandardRuntimeBuilder(
@@ -98,6 +99,7 @@ absl::StatusOr<std::unique_ptr<Program>> CreateProgram(
 struct TestOptions {
   bool enable_mutable_accumulator;
   int max_recursion_depth;
+  bool enable_persistent_collections = false;
 };
 
 struct ComprehensionsV2TestCase {
@@ -116,7 +118,8 @@ TEST_P(ComprehensionsV2Test, Basic) {
 
   absl::StatusOr<std::unique_ptr<Program>> program =
       CreateProgram(test_case.expression, options.enable_mutable_accumulator,
-                    options.max_recursion_depth);
+                    options.max_recursion_depth,
+                    options.enable_persistent_collections);
 
   if (!program.ok()) {
     EXPECT_THAT(program, StatusIs(absl::StatusCode::kInvalidArgument,
@@ -506,6 +509,16 @@ INSTANTIATE_TEST_SUITE_P(
                 .enable_mutable_accumulator = false,
                 .max_recursion_depth = -1,
             },
+            {
+                .enable_mutable_accumulator = false,
+                .max_recursion_depth = 0,
+                .enable_persistent_collections = true,
+            },
+            {
+                .enable_mutable_accumulator = false,
+                .max_recursion_depth = -1,
+                .enable_persistent_collections = true,
+            },
         })));
 
 class ComprehensionsV2TestMutableAccumulator
@@ -14,19 +14,23 @@
 
 #include "extensions/formatting.h"
 
+#include <charconv>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <limits>
 #include <memory>
 #include <optional>
 #include <string>
-#include <tuple>
+#include <system_error>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "absl/base/attributes.h"
 #include "absl/base/nullability.h"
 #include "absl/container/btree_map.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/memory/memory.h"
 #include "absl/numeric/bits.h"
 #include "absl/status/status.h"
@@ -38,11 +42,25 @@
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
 #include "absl/time/time.h"
+#include "common/ast.h"
+#include "common/expr.h"
+#include "common/native_type.h"
+#include "common/reference.h"
 #include "common/value.h"
 #include "common/value_kind.h"
+#include "eval/compiler/flat_expr_builder_extensions.h"
+#include "eval/eval/attribute_trail.h"
+#include "eval/eval/direct_expression_step.h"
+#include "eval/eval/evaluator_core.h"
+#include "eval/eval/expression_step_base.h"
+#include "internal/casts.h"
 #include "internal/status_macros.h"
 #include "runtime/function_adapter.h"
 #include "runtime/function_registry.h"
+#include "runtime/internal/errors.h"
+#include "runtime/internal/runtime_friend_access.h"
+#include "runtime/internal/runtime_impl.h"
+#include "runtime/runtime_builder.h"
 #include "runtime/runtime_options.h"
 #include "google/protobuf/arena.h"
 #include "google/protobuf/descriptor.h"
@@ -52,6 +70,19 @@ namespace cel::extensions {
 
 namespace {
 
+using ::google::api::expr::runtime::AttributeTrail;
+using ::google::api::expr::runtime::DirectExpressionStep;
+using ::google::api::expr::runtime::ExecutionFrame;
+using ::google::api::expr::runtime::ExecutionFrameBase;
+using ::google::api::expr::runtime::ExecutionPath;
+using ::google::api::expr::runtime::ExpressionStepBase;
+using ::google::api::expr::runtime::PlannerContext;
+using ::google::api::expr::runtime::ProgramBuilder;
+using ::google::api::expr::runtime::ProgramOptimizer;
+using ::google::api::expr::runtime::ProgramOptimizerFactory;
+
+using ReferenceMap = absl::flat_hash_map<int64_t, Reference>;
+
 static constexpr int32_t kNanosPerMillisecond = 1000000;
 static constexpr int32_t kNanosPerMicrosecond = 1000;
 
@@ -120,13 +151,26 @@ absl::StatusOr<absl::string_view> FormatDouble(
   } else if (value == -std::numeric_limits<double>::infinity()) {
     return "-Infinity";
   }
-  auto format = absl::StrCat("%.", precision.value_or(kDefaultPrecision),
-                             use_scientific_notation ? "e" : "f");
-  if (use_scientific_notation) {
-    scratch = absl::StrFormat(*absl::ParsedFormat<'e'>::New(format), value);
-  } else {
-    scratch = absl::StrFormat(*absl::ParsedFormat<'f'>::New(format), value);
+  // Upper bounds on the characters needed besides the requested fractional
+  // digits: sign, up to 309 integral digits and the decimal point for fixed
+  // notation; sign, leading digit, decimal point and `e+308` for scientific.
+  static constexpr size_t kMaxFixedOverhead = 311;
+  static constexpr size_t kMaxScientificOverhead = 8;
+  // std::to_chars with an explicit precision produces the same output as
+  // printf's `%.*f` and `%.*e` without building and parsing a format string.
+  const int digits = precision.value_or(kDefaultPrecision);
+  scratch.resize(static_cast<size_t>(digits) +
+                 (use_scientific_notation ? kMaxScientificOverhead
+                                          : kMaxFixedOverhead));
+  auto [end, ec] =
+      std::to_chars(scratch.data(), scratch.data() + scratch.size(), value,
+                    use_scientific_notation ? std::chars_format::scientific
+                                            : std::chars_format::fixed,
+                    digits);
+  if (ec != std::errc()) {
+    return absl::InternalError("failed to format double");
   }
+  scratch.resize(end - scratch.data());
   return scratch;
 }
 
@@ -438,56 +482,77 @@ absl::StatusOr<absl::string_view> FormatScientific(
                       /*use_scientific_notation=*/true, scratch);
 }
 
-absl::StatusOr<std::pair<int64_t, absl::string_view>> ParseAndFormatClause(
-    absl::string_view format, const Value& value,
-    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
-    google::protobuf::MessageFactory* absl_nonnull message_factory,
-    google::protobuf::Arena* absl_nonnull arena,
-    std::string& scratch ABSL_ATTRIBUTE_LIFETIME_BOUND) {
+// A single formatting clause, e.g. `%.3f`, with its verb already validated.
+struct FormatClause {
+  char verb;
+  std::optional<int> precision;
+};
+
+// Parses the clause at the start of `format`, which begins just after the
+// introducing '%'. Returns the index of the verb within `format` along with
+// the parsed clause.
+absl::StatusOr<std::pair<int64_t, FormatClause>> ParseClause(
+    absl::string_view format) {
   CEL_ASSIGN_OR_RETURN(auto precision_pair, ParsePrecision(format));
   auto [read, precision] = precision_pair;
   switch (format[read]) {
-    case 's': {
-      CEL_ASSIGN_OR_RETURN(auto result,
-                           FormatString(value, descriptor_pool, message_factory,
-                                        arena, scratch));
-      return std::pair{read, result};
-    }
-    case 'd': {
-      CEL_ASSIGN_OR_RETURN(auto result, FormatDecimal(value, scratch));
-      return std::pair{read, result};
-    }
-    case 'f': {
-      CEL_ASSIGN_OR_RETURN(auto result, FormatFixed(value, precision, scratch));
-      return std::pair{read, result};
-    }
-    case 'e': {
-      CEL_ASSIGN_OR_RETURN(auto result,
-                           FormatScientific(value, precision, scratch));
-      return std::pair{read, result};
-    }
-    case 'b': {
-      CEL_ASSIGN_OR_RETURN(auto result, FormatBinary(value, scratch));
-      return std::pair{read, result};
-    }
+    case 's':
+    case 'd':
+    case 'f':
+    case 'e':
+    case 'b':
     case 'x':
-    case 'X': {
-      CEL_ASSIGN_OR_RETURN(
-          auto result,
-          FormatHex(value,
-                    /*use_upper_case=*/format[read] == 'X', scratch));
-      return std::pair{read, result};
-    }
-    case 'o': {
-      CEL_ASSIGN_OR_RETURN(auto result, FormatOctal(value, scratch));
-      return std::pair{read, result};
-    }
+    case 'X':
+    case 'o':
+      return std::pair{read, FormatClause{format[read], precision}};
     default:
       return absl::InvalidArgumentError(absl::StrFormat(
           "unrecognized formatting clause \"%c\"", format[read]));
   }
 }
 
+absl::StatusOr<absl::string_view> FormatClauseValue(
+    const FormatClause& clause, const Value& value,
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena,
+    std::string& scratch ABSL_ATTRIBUTE_LIFETIME_BOUND) {
+  switch (clause.verb) {
+    case 's':
+      return FormatString(value, descriptor_pool, message_factory, arena,
+                          scratch);
+    case 'd':
+      return FormatDecimal(value, scratch);
+    case 'f':
+      return FormatFixed(value, clause.precision, scratch);
+    case 'e':
+      return FormatScientific(value, clause.precision, scratch);
+    case 'b':
+      return FormatBinary(value, scratch);
+    case 'x':
+    case 'X':
+      return FormatHex(value, /*use_upper_case=*/clause.verb == 'X', scratch);
+    case 'o':
+      return FormatOctal(value, scratch);
+    default:
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "unrecognized formatting clause \"%c\"", clause.verb));
+  }
+}
+
+absl::StatusOr<std::pair<int64_t, absl::string_view>> ParseAndFormatClause(
+    absl::string_view format, const Value& value,
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena,
+    std::string& scratch ABSL_ATTRIBUTE_LIFETIME_BOUND) {
+  CEL_ASSIGN_OR_RETURN(auto clause, ParseClause(format));
+  CEL_ASSIGN_OR_RETURN(auto result,
+                       FormatClauseValue(clause.second, value, descriptor_pool,
+                                         message_factory, arena, scratch));
+  return std::pair{clause.first, result};
+}
+
 absl::StatusOr<Value> Format(
     const StringValue& format_value, const ListValue& args,
     const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
@@ -529,6 +594,257 @@ absl::StatusOr<Value> Format(
   return StringValue(arena, std::move(result));
 }
 
+// A format string split at plan time into literal text and clauses, so that
+// evaluation does not rescan the format string or reparse its verbs.
+class CompiledFormat final {
+ public:
+  // Returns an error if the format string is malformed. Callers should fall
+  // back to `Format` in that case so that errors are reported in the same
+  // order as for a dynamic format string.
+  static absl::StatusOr<CompiledFormat> Compile(absl::string_view format) {
+    CompiledFormat compiled;
+    std::string literal;
+    for (int64_t i = 0; i < format.size(); ++i) {
+      if (format[i] != '%') {
+        literal.push_back(format[i]);
+        continue;
+      }
+      ++i;
+      if (i >= format.size()) {
+        return absl::InvalidArgumentError("unexpected end of format string");
+      }
+      if (format[i] == '%') {
+        literal.push_back('%');
+        continue;
+      }
+      CEL_ASSIGN_OR_RETURN(auto clause, ParseClause(format.substr(i)));
+      compiled.literal_size_ += literal.size();
+      compiled.segments_.push_back(
+          Segment{std::move(literal), std::move(clause.second)});
+      literal.clear();
+      i += clause.first;
+    }
+    if (!literal.empty()) {
+      compiled.literal_size_ += literal.size();
+      compiled.segments_.push_back(Segment{std::move(literal), std::nullopt});
+    }
+    return compiled;
+  }
+
+  absl::StatusOr<Value> Format(
+      const ListValue& args,
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena) const {
+    CEL_ASSIGN_OR_RETURN(int64_t args_size, args.Size());
+    std::string result;
+    result.reserve(literal_size_);
+    std::string clause_scratch;
+    int64_t arg_index = 0;
+    for (const Segment& segment : segments_) {
+      result.append(segment.literal);
+      if (!segment.clause.has_value()) {
+        continue;
+      }
+      if (arg_index >= args_size) {
+        return absl::InvalidArgumentError(
+            absl::StrFormat("index %d out of range", arg_index));
+      }
+      CEL_ASSIGN_OR_RETURN(auto value, args.Get(arg_index++, descriptor_pool,
+                                                message_factory, arena));
+      clause_scratch.clear();
+      CEL_ASSIGN_OR_RETURN(
+          absl::string_view formatted,
+          FormatClauseValue(*segment.clause, value, descriptor_pool,
+                            message_factory, arena, clause_scratch));
+      result.append(formatted);
+    }
+    return StringValue(arena, std::move(result));
+  }
+
+ private:
+  struct Segment {
+    // Literal text preceding the clause, with `%%` already unescaped.
+    std::string literal;
+    // Absent only for trailing literal text.
+    std::optional<FormatClause> clause;
+  };
+
+  CompiledFormat() = default;
+
+  std::vector<Segment> segments_;
+  size_t literal_size_ = 0;
+};
+
+// Applies a compiled format to the argument list. Errors and unknowns are
+// forwarded, mirroring the strict function call this replaces.
+absl::StatusOr<Value> ApplyCompiledFormat(const CompiledFormat& format,
+                                          const Value& args,
+                                          ExecutionFrameBase& frame) {
+  if (args.IsError() || args.IsUnknown()) {
+    return args;
+  }
+  if (!args.IsList()) {
+    return ErrorValue(runtime_internal::CreateNoMatchingOverloadError(
+        absl::StrCat("format(string, ", args.GetTypeName(), ")")));
+  }
+  return format.Format(args.GetList(), frame.descriptor_pool(),
+                       frame.message_factory(), frame.arena());
+}
+
+class StringFormatStep final : public ExpressionStepBase {
+ public:
+  StringFormatStep(int64_t expr_id,
+                   std::shared_ptr<const CompiledFormat> format)
+      : ExpressionStepBase(expr_id, /*comes_from_ast=*/true),
+        format_(std::move(format)) {}
+
+  absl::Status Evaluate(ExecutionFrame* frame) const override {
+    if (!frame->value_stack().HasEnough(1)) {
+      return absl::InternalError("Value stack underflow");
+    }
+    const AttributeTrail& args_trail = frame->value_stack().PeekAttribute();
+    if (frame->enable_unknowns() &&
+        frame->attribute_utility().CheckForUnknown(args_trail,
+                                                   /*use_partial=*/true)) {
+      Value unknown =
+          frame->attribute_utility().CreateUnknownSet(args_trail.attribute());
+      frame->value_stack().PopAndPush(std::move(unknown));
+      return absl::OkStatus();
+    }
+    CEL_ASSIGN_OR_RETURN(
+        Value result,
+        ApplyCompiledFormat(*format_, frame->value_stack().Peek(), *frame));
+    frame->value_stack().PopAndPush(std::move(result));
+    return absl::OkStatus();
+  }
+
+ private:
+  std::shared_ptr<const CompiledFormat> format_;
+};
+
+class DirectStringFormatStep final : public DirectExpressionStep {
+ public:
+  DirectStringFormatStep(int64_t expr_id,
+                         std::unique_ptr<DirectExpressionStep> args,
+                         std::shared_ptr<const CompiledFormat> format)
+      : DirectExpressionStep(expr_id),
+        args_(std::move(args)),
+        format_(std::move(format)) {}
+
+  absl::Status Evaluate(ExecutionFrameBase& frame, Value& result,
+                        AttributeTrail& attribute) const override {
+    AttributeTrail args_trail;
+    CEL_RETURN_IF_ERROR(args_->Evaluate(frame, result, args_trail));
+    if (frame.unknown_processing_enabled() &&
+        frame.attribute_utility().CheckForUnknown(args_trail,
+                                                  /*use_partial=*/true)) {
+      result =
+          frame.attribute_utility().CreateUnknownSet(args_trail.attribute());
+      return absl::OkStatus();
+    }
+    CEL_ASSIGN_OR_RETURN(result, ApplyCompiledFormat(*format_, result, frame));
+    return absl::OkStatus();
+  }
+
+ private:
+  std::unique_ptr<DirectExpressionStep> args_;
+  std::shared_ptr<const CompiledFormat> format_;
+};
+
+bool IsStringFormatCall(const Expr& expr, const ReferenceMap& reference_map) {
+  if (!expr.has_call_expr()) {
+    return false;
+  }
+  const auto& call_expr = expr.call_expr();
+  if (call_expr.function() != "format" || !call_expr.has_target() ||
+      call_expr.args().size() != 1) {
+    return false;
+  }
+  // Parse-only expressions are assumed to call the extension overload.
+  if (reference_map.empty()) {
+    return true;
+  }
+  auto reference = reference_map.find(expr.id());
+  return reference != reference_map.end() &&
+         reference->second.overload_id().size() == 1 &&
+         reference->second.overload_id().front() == "string_format";
+}
+
+// Replaces `'<constant>'.format(args)` calls with a step that applies the
+// precompiled format string to the evaluated argument list.
+class FormatPrecompilationOptimization final : public ProgramOptimizer {
+ public:
+  explicit FormatPrecompilationOptimization(const ReferenceMap& reference_map)
+      : reference_map_(reference_map) {}
+
+  absl::Status OnPreVisit(PlannerContext& context, const Expr& node) override {
+    return absl::OkStatus();
+  }
+
+  absl::Status OnPostVisit(PlannerContext& context, const Expr& node) override {
+    if (!IsStringFormatCall(node, reference_map_)) {
+      return absl::OkStatus();
+    }
+    const CallExpr& call_expr = node.call_expr();
+    const Expr& format_expr = call_expr.target();
+    if (!format_expr.has_const_expr() ||
+        !format_expr.const_expr().has_string_value()) {
+      return absl::OkStatus();
+    }
+    absl::StatusOr<CompiledFormat> compiled =
+        CompiledFormat::Compile(format_expr.const_expr().string_value());
+    if (!compiled.ok()) {
+      // Leave the call in place so the error surfaces during evaluation.
+      return absl::OkStatus();
+    }
+
+    ProgramBuilder::Subexpression* subexpression =
+        context.program_builder().GetSubexpression(&node);
+    if (subexpression == nullptr || subexpression->IsFlattened()) {
+      // Already modified, can't update further.
+      return absl::OkStatus();
+    }
+    auto format = std::make_shared<const CompiledFormat>(*std::move(compiled));
+
+    if (subexpression->IsRecursive()) {
+      auto program = subexpression->ExtractRecursiveProgram();
+      auto deps = program.step->ExtractDependencies();
+      if (!deps.has_value() || deps->size() != 2) {
+        // Possibly already const-folded, put the plan back.
+        subexpression->set_recursive_program(std::move(program.step),
+                                             program.depth);
+        return absl::OkStatus();
+      }
+      subexpression->set_recursive_program(
+          std::make_unique<DirectStringFormatStep>(
+              node.id(), std::move(deps->at(1)), std::move(format)),
+          program.depth);
+      return absl::OkStatus();
+    }
+
+    const Expr& args_expr = call_expr.args().front();
+    if (context.GetSubplan(args_expr).empty()) {
+      // This subexpression was already optimized, nothing to do.
+      return absl::OkStatus();
+    }
+    CEL_ASSIGN_OR_RETURN(ExecutionPath path, context.ExtractSubplan(args_expr));
+    path.push_back(
+        std::make_unique<StringFormatStep>(node.id(), std::move(format)));
+    return context.ReplaceSubplan(node, std::move(path));
+  }
+
+ private:
+  const ReferenceMap& reference_map_;
+};
+
+ProgramOptimizerFactory CreateFormatPrecompilationOptimizer() {
+  return [](PlannerContext& context, const Ast& ast) {
+    return std::make_unique<FormatPrecompilationOptimization>(
+        ast.reference_map());
+  };
+}
+
 }  // namespace
 
 absl::Status RegisterStringFormattingFunctions(FunctionRegistry& registry,
@@ -548,4 +864,22 @@ absl::Status RegisterStringFormattingFunctions(FunctionRegistry& registry,
   return absl::OkStatus();
 }
 
+absl::Status RegisterStringFormattingFunctions(RuntimeBuilder& builder,
+                                               const RuntimeOptions& options) {
+  CEL_RETURN_IF_ERROR(
+      RegisterStringFormattingFunctions(builder.function_registry(), options));
+  auto& runtime =
+      runtime_internal::RuntimeFriendAccess::GetMutableRuntime(builder);
+  if (runtime_internal::RuntimeFriendAccess::RuntimeTypeId(runtime) !=
+      NativeTypeId::For<runtime_internal::RuntimeImpl>()) {
+    // Format strings are parsed on each call on other implementations.
+    return absl::OkStatus();
+  }
+  auto& runtime_impl =
+      cel::internal::down_cast<runtime_internal::RuntimeImpl&>(runtime);
+  runtime_impl.expr_builder().AddProgramOptimizer(
+      CreateFormatPrecompilationOptimizer());
+  return absl::OkStatus();
+}
+
 }  // namespace cel::extensions
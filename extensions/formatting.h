@@ -17,6 +17,7 @@
 
 #include "absl/status/status.h"
 #include "runtime/function_registry.h"
+#include "runtime/runtime_builder.h"
 #include "runtime/runtime_options.h"
 
 namespace cel::extensions {
@@ -25,6 +26,16 @@ namespace cel::extensions {
 absl::Status RegisterStringFormattingFunctions(FunctionRegistry& registry,
                                                const RuntimeOptions& options);
 
+// Register extension functions for string formatting and enable plan-time
+// compilation of constant format strings.
+//
+// Calls of the form `'<literal>'.format(args)` are planned as a single step
+// that applies the pre-parsed format string, so the literal text and clauses
+// are not rescanned on each evaluation. Malformed format strings are left to
+// fail at evaluation time as they would otherwise.
+absl::Status RegisterStringFormattingFunctions(RuntimeBuilder& builder,
+                                               const RuntimeOptions& options);
+
 }  // namespace cel::extensions
 
 #endif  // THIRD_PARTY_CEL_CPP_EXTENSIONS_FORMATTING_H_
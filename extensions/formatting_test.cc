@@ -16,16 +16,19 @@
 
 #include <cmath>
 #include <cstdint>
+#include <initializer_list>
 #include <limits>
 #include <memory>
 #include <optional>
 #include <string>
 #include <utility>
 #include <variant>
+#include <vector>
 
 #include "cel/expr/syntax.pb.h"
 #include "absl/base/no_destructor.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
 #include "absl/status/status_matchers.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
@@ -46,6 +49,8 @@
 #include "runtime/standard_runtime_builder_factory.h"
 #include "cel/expr/conformance/proto3/test_all_types.pb.h"
 #include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
 
 namespace cel::extensions {
 namespace {
@@ -55,7 +60,9 @@ using ::cel::expr::conformance::proto3::TestAllTypes;
 using ::cel::expr::ParsedExpr;
 using ::google::api::expr::parser::Parse;
 using ::google::api::expr::parser::ParserOptions;
+using ::testing::Contains;
 using ::testing::HasSubstr;
+using ::testing::Not;
 using ::testing::TestWithParam;
 using ::testing::ValuesIn;
 
@@ -88,71 +95,84 @@ ParsedMessageValue MakeMessage(absl::string_view text) {
 using StringFormatTest = TestWithParam<FormattingTestCase>;
 TEST_P(StringFormatTest, TestStringFormatting) {
   const FormattingTestCase& test_case = GetParam();
-  google::protobuf::Arena arena;
-  const RuntimeOptions options;
-  ASSERT_OK_AND_ASSIGN(auto builder,
-                       CreateStandardRuntimeBuilder(
-                           internal::GetTestingDescriptorPool(), options));
-  auto registration_status =
-      RegisterStringFormattingFunctions(builder.function_registry(), options);
-  if (test_case.error.has_value() && !registration_status.ok()) {
-    EXPECT_THAT(registration_status.message(), HasSubstr(*test_case.error));
-    return;
-  } else {
-    ASSERT_THAT(registration_status, IsOk());
-  }
-  ASSERT_OK_AND_ASSIGN(auto runtime, std::move(builder).Build());
+  // Covers the dynamic path and the precompiled format string path for both
+  // the stack machine and recursive planners.
+  for (const auto& [precompile, max_recursion_depth] :
+       std::initializer_list<std::pair<bool, int>>{
+           {false, 0}, {true, 0}, {true, -1}}) {
+    SCOPED_TRACE(absl::StrCat("precompile: ", precompile,
+                              " max_recursion_depth: ", max_recursion_depth));
+    google::protobuf::Arena arena;
+    RuntimeOptions options;
+    options.max_recursion_depth = max_recursion_depth;
+    ASSERT_OK_AND_ASSIGN(auto builder,
+                         CreateStandardRuntimeBuilder(
+                             internal::GetTestingDescriptorPool(), options));
+    auto registration_status =
+        precompile
+            ? RegisterStringFormattingFunctions(builder, options)
+            : RegisterStringFormattingFunctions(builder.function_registry(),
+                                                options);
+    if (test_case.error.has_value() && !registration_status.ok()) {
+      EXPECT_THAT(registration_status.message(), HasSubstr(*test_case.error));
+      return;
+    } else {
+      ASSERT_THAT(registration_status, IsOk());
+    }
+    ASSERT_OK_AND_ASSIGN(auto runtime, std::move(builder).Build());
 
-  auto expr_str = absl::StrFormat("'''%s'''.format([%s])", test_case.format,
-                                  test_case.format_args);
-  ASSERT_OK_AND_ASSIGN(ParsedExpr expr,
-                       Parse(expr_str, "<input>", ParserOptions{}));
-  ASSERT_OK_AND_ASSIGN(std::unique_ptr<Program> program,
-                       ProtobufRuntimeAdapter::CreateProgram(*runtime, expr));
+    auto expr_str = absl::StrFormat("'''%s'''.format([%s])", test_case.format,
+                                    test_case.format_args);
+    ASSERT_OK_AND_ASSIGN(ParsedExpr expr,
+                         Parse(expr_str, "<input>", ParserOptions{}));
+    ASSERT_OK_AND_ASSIGN(std::unique_ptr<Program> program,
+                         ProtobufRuntimeAdapter::CreateProgram(*runtime, expr));
 
-  Activation activation;
-  for (const auto& [name, value] : test_case.dyn_args) {
-    if (std::holds_alternative<std::string>(value)) {
-      activation.InsertOrAssignValue(name,
-                                     StringValue{std::get<std::string>(value)});
-    } else if (std::holds_alternative<bool>(value)) {
-      activation.InsertOrAssignValue(name, BoolValue{std::get<bool>(value)});
-    } else if (std::holds_alternative<int>(value)) {
-      activation.InsertOrAssignValue(name, IntValue{std::get<int>(value)});
-    } else if (std::holds_alternative<int64_t>(value)) {
-      activation.InsertOrAssignValue(name, IntValue{std::get<int64_t>(value)});
-    } else if (std::holds_alternative<uint64_t>(value)) {
-      activation.InsertOrAssignValue(name,
-                                     UintValue{std::get<uint64_t>(value)});
-    } else if (std::holds_alternative<double>(value)) {
-      activation.InsertOrAssignValue(name,
-                                     DoubleValue{std::get<double>(value)});
-    } else if (std::holds_alternative<absl::Duration>(value)) {
-      activation.InsertOrAssignValue(
-          name, DurationValue{std::get<absl::Duration>(value)});
-    } else if (std::holds_alternative<absl::Time>(value)) {
-      activation.InsertOrAssignValue(
-          name, TimestampValue{std::get<absl::Time>(value)});
-    } else if (std::holds_alternative<Value>(value)) {
-      activation.InsertOrAssignValue(name, std::get<Value>(value));
+    Activation activation;
+    for (const auto& [name, value] : test_case.dyn_args) {
+      if (std::holds_alternative<std::string>(value)) {
+        activation.InsertOrAssignValue(
+            name, StringValue{std::get<std::string>(value)});
+      } else if (std::holds_alternative<bool>(value)) {
+        activation.InsertOrAssignValue(name, BoolValue{std::get<bool>(value)});
+      } else if (std::holds_alternative<int>(value)) {
+        activation.InsertOrAssignValue(name, IntValue{std::get<int>(value)});
+      } else if (std::holds_alternative<int64_t>(value)) {
+        activation.InsertOrAssignValue(name,
+                                       IntValue{std::get<int64_t>(value)});
+      } else if (std::holds_alternative<uint64_t>(value)) {
+        activation.InsertOrAssignValue(name,
+                                       UintValue{std::get<uint64_t>(value)});
+      } else if (std::holds_alternative<double>(value)) {
+        activation.InsertOrAssignValue(name,
+                                       DoubleValue{std::get<double>(value)});
+      } else if (std::holds_alternative<absl::Duration>(value)) {
+        activation.InsertOrAssignValue(
+            name, DurationValue{std::get<absl::Duration>(value)});
+      } else if (std::holds_alternative<absl::Time>(value)) {
+        activation.InsertOrAssignValue(
+            name, TimestampValue{std::get<absl::Time>(value)});
+      } else if (std::holds_alternative<Value>(value)) {
+        activation.InsertOrAssignValue(name, std::get<Value>(value));
+      }
     }
-  }
-  auto result = program->Evaluate(&arena, activation);
-  if (test_case.error.has_value()) {
-    if (result.ok()) {
-      EXPECT_THAT(result->DebugString(), HasSubstr(*test_case.error));
+    auto result = program->Evaluate(&arena, activation);
+    if (test_case.error.has_value()) {
+      if (result.ok()) {
+        EXPECT_THAT(result->DebugString(), HasSubstr(*test_case.error));
+      } else {
+        EXPECT_THAT(result.status().message(), HasSubstr(*test_case.error));
+      }
     } else {
-      EXPECT_THAT(result.status().message(), HasSubstr(*test_case.error));
+      if (!result.ok()) {
+        // Make it easier to debug the test case.
+        ASSERT_THAT(result.status().message(), "");
+        // Make sure test case stops here.
+        ASSERT_TRUE(result.ok());
+      }
+      ASSERT_TRUE(result->Is<StringValue>());
+      EXPECT_THAT(result->GetString().ToString(), test_case.expected);
     }
-  } else {
-    if (!result.ok()) {
-      // Make it easier to debug the test case.
-      ASSERT_THAT(result.status().message(), "");
-      // Make sure test case stops here.
-      ASSERT_TRUE(result.ok());
-    }
-    ASSERT_TRUE(result->Is<StringValue>());
-    EXPECT_THAT(result->GetString().ToString(), test_case.expected);
   }
 }
 
@@ -889,5 +909,66 @@ INSTANTIATE_TEST_SUITE_P(
       return info.param.name;
     });
 
+// The format string literal is only evaluated on its own if the call wasn't
+// replaced by a step applying the precompiled format.
+class StringFormatPlanTest
+    : public TestWithParam<std::pair<bool, int>> {};
+
+TEST_P(StringFormatPlanTest, ConstantFormatStringIsPrecompiled) {
+  const auto [precompile, max_recursion_depth] = GetParam();
+  RuntimeOptions options;
+  options.max_recursion_depth = max_recursion_depth;
+  options.enable_recursive_tracing = true;
+  ASSERT_OK_AND_ASSIGN(auto builder,
+                       CreateStandardRuntimeBuilder(
+                           internal::GetTestingDescriptorPool(), options));
+  ASSERT_THAT(precompile ? RegisterStringFormattingFunctions(builder, options)
+                         : RegisterStringFormattingFunctions(
+                               builder.function_registry(), options),
+              IsOk());
+  ASSERT_OK_AND_ASSIGN(auto runtime, std::move(builder).Build());
+
+  ASSERT_OK_AND_ASSIGN(
+      ParsedExpr expr,
+      Parse("'%d-%s'.format([x, 'a'])", "<input>", ParserOptions{}));
+  const int64_t call_id = expr.expr().id();
+  const int64_t format_string_id = expr.expr().call_expr().target().id();
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<TraceableProgram> program,
+                       ProtobufRuntimeAdapter::CreateProgram(*runtime, expr));
+
+  google::protobuf::Arena arena;
+  Activation activation;
+  activation.InsertOrAssignValue("x", IntValue(1));
+  std::vector<int64_t> traced_ids;
+  ASSERT_OK_AND_ASSIGN(
+      Value result,
+      program->Trace(&arena, activation,
+                     [&traced_ids](int64_t expr_id, const Value&,
+                                   const google::protobuf::DescriptorPool*,
+                                   google::protobuf::MessageFactory*,
+                                   google::protobuf::Arena*) {
+                       traced_ids.push_back(expr_id);
+                       return absl::OkStatus();
+                     }));
+  ASSERT_TRUE(result.IsString());
+  EXPECT_EQ(result.GetString().ToString(), "1-a");
+
+  EXPECT_THAT(traced_ids, Contains(call_id));
+  if (precompile) {
+    EXPECT_THAT(traced_ids, Not(Contains(format_string_id)));
+  } else {
+    EXPECT_THAT(traced_ids, Contains(format_string_id));
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    StringFormatPlanTest, StringFormatPlanTest,
+    testing::Values(std::make_pair(false, 0), std::make_pair(false, -1),
+                    std::make_pair(true, 0), std::make_pair(true, -1)),
+    [](const testing::TestParamInfo<StringFormatPlanTest::ParamType>& info) {
+      return absl::StrCat(info.param.first ? "Precompiled" : "Dynamic",
+                          info.param.second == 0 ? "Stack" : "Recursive");
+    });
+
 }  // namespace
 }  // namespace cel::extensions
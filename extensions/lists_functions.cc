@@ -14,6 +14,7 @@
 
 #include "extensions/lists_functions.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <numeric>
@@ -40,6 +41,8 @@
 #include "common/type.h"
 #include "common/value.h"
 #include "common/value_kind.h"
+#include "common/values/primitive_list_value.h"
+#include "common/values/range_list_value.h"
 #include "compiler/compiler.h"
 #include "internal/status_macros.h"
 #include "parser/macro.h"
@@ -227,12 +230,7 @@ absl::StatusOr<ListValue> ListRange(
     int64_t end, const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
     google::protobuf::MessageFactory* absl_nonnull message_factory,
     google::protobuf::Arena* absl_nonnull arena) {
-  auto builder = NewListValueBuilder(arena);
-  builder->Reserve(end);
-  for (int64_t i = 0; i < end; ++i) {
-    CEL_RETURN_IF_ERROR(builder->Add(IntValue(i)));
-  }
-  return std::move(*builder).Build();
+  return common_internal::MakeRangeListValue(end, arena);
 }
 
 absl::StatusOr<ListValue> ListReverse(
@@ -390,6 +388,124 @@ absl::StatusOr<Value> ListSortByAssociatedKeys(
   }
 }
 
+// Finds the least (or greatest) element of a list whose elements must all be
+// of `ValueType`, in a single pass over the list.
+template <typename ValueType, bool kGreatest>
+absl::StatusOr<Value> ListExtremumNative(
+    const ListValue& list, absl::string_view function,
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena) {
+  absl::optional<ValueType> result;
+  absl::Status status = list.ForEach(
+      [&](const Value& value) -> absl::StatusOr<bool> {
+        auto typed_value = value.As<ValueType>();
+        if (!typed_value.has_value()) {
+          return absl::InvalidArgumentError(absl::StrCat(
+              function, "(): list elements must have the same type"));
+        }
+        if (!result.has_value() ||
+            (kGreatest ? *result < *typed_value : *typed_value < *result)) {
+          result = *std::move(typed_value);
+        }
+        return true;
+      },
+      descriptor_pool, message_factory, arena);
+  if (!status.ok()) {
+    return ErrorValue(status);
+  }
+  return *std::move(result);
+}
+
+// Returns the index of the least (or greatest) element of a non-empty native
+// array. Ties resolve to the first occurrence, as in `ListExtremumNative()`.
+template <bool kGreatest, typename T>
+size_t UnboxedListExtremumIndex(absl::Span<const T> elements) {
+  auto it = kGreatest ? std::max_element(elements.begin(), elements.end())
+                      : std::min_element(elements.begin(), elements.end());
+  return static_cast<size_t>(it - elements.begin());
+}
+
+// Returns the index of the least (or greatest) element of `list` if it stores
+// its elements unboxed.
+template <bool kGreatest>
+absl::optional<size_t> UnboxedListExtremumIndex(const ListValue& list) {
+  if (auto elements = common_internal::AsIntListValue(list); elements) {
+    return UnboxedListExtremumIndex<kGreatest>(*elements);
+  }
+  if (auto elements = common_internal::AsUintListValue(list); elements) {
+    return UnboxedListExtremumIndex<kGreatest>(*elements);
+  }
+  if (auto elements = common_internal::AsDoubleListValue(list); elements) {
+    return UnboxedListExtremumIndex<kGreatest>(*elements);
+  }
+  if (auto elements = common_internal::AsBoolListValue(list); elements) {
+    return UnboxedListExtremumIndex<kGreatest>(*elements);
+  }
+  if (auto elements = common_internal::AsStringListValue(list); elements) {
+    return UnboxedListExtremumIndex<kGreatest>(*elements);
+  }
+  return absl::nullopt;
+}
+
+// Implementation of lists.min() and lists.max().
+//
+//  lists.min(<list(T)>) -> T
+//  lists.max(<list(T)>) -> T
+//  T in {int, uint, double, bool, duration, timestamp, string, bytes}
+//
+// Example:
+//
+//  lists.max([3, 1, 2]) -> returns 3
+template <bool kGreatest>
+absl::StatusOr<Value> ListExtremum(
+    const ListValue& list,
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena) {
+  constexpr absl::string_view kFunction =
+      kGreatest ? "lists.max" : "lists.min";
+  CEL_ASSIGN_OR_RETURN(size_t size, list.Size());
+  if (size == 0) {
+    return ErrorValue(absl::InvalidArgumentError(
+        absl::StrCat(kFunction, "(): list must not be empty")));
+  }
+  if (auto index = UnboxedListExtremumIndex<kGreatest>(list); index) {
+    return list.Get(*index, descriptor_pool, message_factory, arena);
+  }
+  CEL_ASSIGN_OR_RETURN(Value first,
+                       list.Get(0, descriptor_pool, message_factory, arena));
+  switch (first.kind()) {
+    case ValueKind::kInt:
+      return ListExtremumNative<IntValue, kGreatest>(
+          list, kFunction, descriptor_pool, message_factory, arena);
+    case ValueKind::kUint:
+      return ListExtremumNative<UintValue, kGreatest>(
+          list, kFunction, descriptor_pool, message_factory, arena);
+    case ValueKind::kDouble:
+      return ListExtremumNative<DoubleValue, kGreatest>(
+          list, kFunction, descriptor_pool, message_factory, arena);
+    case ValueKind::kBool:
+      return ListExtremumNative<BoolValue, kGreatest>(
+          list, kFunction, descriptor_pool, message_factory, arena);
+    case ValueKind::kString:
+      return ListExtremumNative<StringValue, kGreatest>(
+          list, kFunction, descriptor_pool, message_factory, arena);
+    case ValueKind::kTimestamp:
+      return ListExtremumNative<TimestampValue, kGreatest>(
+          list, kFunction, descriptor_pool, message_factory, arena);
+    case ValueKind::kDuration:
+      return ListExtremumNative<DurationValue, kGreatest>(
+          list, kFunction, descriptor_pool, message_factory, arena);
+    case ValueKind::kBytes:
+      return ListExtremumNative<BytesValue, kGreatest>(
+          list, kFunction, descriptor_pool, message_factory, arena);
+    default:
+      return ErrorValue(absl::InvalidArgumentError(absl::StrFormat(
+          "%s(): unsupported type %s", kFunction, first.GetTypeName())));
+  }
+}
+
 // Create an expression equivalent to:
 //   target.map(varIdent, mapExpr)
 absl::optional<Expr> MakeMapComprehension(MacroExprFactory& factory,
@@ -477,11 +593,77 @@ Macro ListSortByMacro() {
   return *sortby_macro;
 }
 
+// This macro transforms an expression like:
+//
+//    mylistExpr.count(e, e > 0)
+//
+// into a comprehension which increments an integer accumulator for each
+// element matching the predicate, without building an intermediate list:
+//
+//    __result__ = 0
+//    for e in mylistExpr:
+//      __result__ = (e > 0) ? __result__ + 1 : __result__
+Macro ListCountMacro() {
+  absl::StatusOr<Macro> count_macro = Macro::Receiver(
+      "count", 2,
+      [](MacroExprFactory& factory, Expr& target,
+         absl::Span<Expr> args) -> absl::optional<Expr> {
+        if (!args[0].has_ident_expr() || args[0].ident_expr().name().empty()) {
+          return factory.ReportErrorAt(
+              args[0], "count() variable name must be a simple identifier");
+        }
+        if (args[0].ident_expr().name() == factory.AccuVarName()) {
+          return factory.ReportErrorAt(
+              args[0], absl::StrCat("count() variable name cannot be ",
+                                    factory.AccuVarName()));
+        }
+        auto inc_step = factory.NewCall(
+            google::api::expr::common::CelOperator::ADD,
+            factory.NewAccuIdent(), factory.NewIntConst(1));
+        auto step = factory.NewCall(
+            google::api::expr::common::CelOperator::CONDITIONAL,
+            std::move(args[1]), std::move(inc_step), factory.NewAccuIdent());
+        auto var_name = args[0].ident_expr().name();
+        return factory.NewComprehension(
+            std::move(var_name), std::move(target), factory.AccuVarName(),
+            factory.NewIntConst(0), factory.NewBoolConst(true),
+            std::move(step), factory.NewAccuIdent());
+      });
+  return *count_macro;
+}
+
+// Sorts a copy of a native array and stores the result unboxed again.
+template <typename T>
+ListValue SortUnboxedList(absl::Span<const T> elements,
+                          ListValue (*make_list)(absl::Span<const T>,
+                                                 google::protobuf::Arena* absl_nonnull),
+                          google::protobuf::Arena* absl_nonnull arena) {
+  std::vector<T> sorted(elements.begin(), elements.end());
+  std::sort(sorted.begin(), sorted.end());
+  return make_list(sorted, arena);
+}
+
 absl::StatusOr<Value> ListSort(
     const ListValue& list,
     const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
     google::protobuf::MessageFactory* absl_nonnull message_factory,
     google::protobuf::Arena* absl_nonnull arena) {
+  if (auto elements = common_internal::AsIntListValue(list); elements) {
+    return SortUnboxedList(*elements, &common_internal::MakeIntListValue,
+                           arena);
+  }
+  if (auto elements = common_internal::AsUintListValue(list); elements) {
+    return SortUnboxedList(*elements, &common_internal::MakeUintListValue,
+                           arena);
+  }
+  if (auto elements = common_internal::AsDoubleListValue(list); elements) {
+    return SortUnboxedList(*elements, &common_internal::MakeDoubleListValue,
+                           arena);
+  }
+  if (auto elements = common_internal::AsStringListValue(list); elements) {
+    return SortUnboxedList(*elements, &common_internal::MakeStringListValue,
+                           arena);
+  }
   return ListSortByAssociatedKeys(list, list, descriptor_pool, message_factory,
                                   arena);
 }
@@ -545,6 +727,18 @@ absl::Status RegisterListSortFunction(FunctionRegistry& registry) {
   return absl::OkStatus();
 }
 
+absl::Status RegisterListExtremumFunctions(FunctionRegistry& registry) {
+  CEL_RETURN_IF_ERROR(
+      (UnaryFunctionAdapter<absl::StatusOr<Value>, const ListValue&>::
+           RegisterGlobalOverload("lists.min", &ListExtremum<false>,
+                                  registry)));
+  CEL_RETURN_IF_ERROR(
+      (UnaryFunctionAdapter<absl::StatusOr<Value>, const ListValue&>::
+           RegisterGlobalOverload("lists.max", &ListExtremum<true>,
+                                  registry)));
+  return absl::OkStatus();
+}
+
 const Type& ListIntType() {
   static absl::NoDestructor<Type> kInstance(
       ListType(BuiltinsArena(), IntType()));
@@ -615,6 +809,21 @@ absl::Status RegisterListsCheckerDecls(TypeCheckerBuilder& builder) {
         ListTypeParamType(), ListTypeParamType(), list_type)));
   }
 
+  FunctionDecl min_decl;
+  min_decl.set_name("lists.min");
+  FunctionDecl max_decl;
+  max_decl.set_name("lists.max");
+
+  for (const Type& list_type : *kSortableListTypes) {
+    const Type& elem_type = list_type.AsList()->GetElement();
+    std::string elem_type_name(elem_type.name());
+
+    CEL_RETURN_IF_ERROR(min_decl.AddOverload(MakeOverloadDecl(
+        absl::StrCat("list_", elem_type_name, "_min"), elem_type, list_type)));
+    CEL_RETURN_IF_ERROR(max_decl.AddOverload(MakeOverloadDecl(
+        absl::StrCat("list_", elem_type_name, "_max"), elem_type, list_type)));
+  }
+
   CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(sort_decl)));
   CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(sort_by_key_decl)));
   CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(distinct_decl)));
@@ -624,10 +833,14 @@ absl::Status RegisterListsCheckerDecls(TypeCheckerBuilder& builder) {
   // defined in strings extension.
   CEL_RETURN_IF_ERROR(builder.MergeFunction(std::move(reverse_decl)));
   CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(slice_decl)));
+  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(min_decl)));
+  CEL_RETURN_IF_ERROR(builder.AddFunction(std::move(max_decl)));
   return absl::OkStatus();
 }
 
-std::vector<Macro> lists_macros() { return {ListSortByMacro()}; }
+std::vector<Macro> lists_macros() {
+  return {ListSortByMacro(), ListCountMacro()};
+}
 
 absl::Status ConfigureParser(ParserBuilder& builder) {
   for (const Macro& macro : lists_macros()) {
@@ -646,6 +859,7 @@ absl::Status RegisterListsFunctions(FunctionRegistry& registry,
   CEL_RETURN_IF_ERROR(RegisterListReverseFunction(registry));
   CEL_RETURN_IF_ERROR(RegisterListSliceFunction(registry));
   CEL_RETURN_IF_ERROR(RegisterListSortFunction(registry));
+  CEL_RETURN_IF_ERROR(RegisterListExtremumFunctions(registry));
   return absl::OkStatus();
 }
 
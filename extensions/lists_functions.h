@@ -29,6 +29,9 @@ namespace cel::extensions {
 //
 // lists.range(n: int) -> list(int)
 //
+// lists.min(<list(T)>) -> T
+// lists.max(<list(T)>) -> T
+//
 // <list(T)>.distinct() -> list(T)
 //
 // <list(dyn)>.flatten() -> list(dyn)
@@ -45,6 +48,7 @@ absl::Status RegisterListsFunctions(FunctionRegistry& registry,
 // Register list macros.
 //
 // <list(T)>.sortBy(<element name>, <element key expression>)
+// <list(T)>.count(<element name>, <predicate expression>) -> int
 absl::Status RegisterListsMacros(MacroRegistry& registry,
                                  const ParserOptions& options);
 
@@ -53,6 +57,9 @@ absl::Status RegisterListsMacros(MacroRegistry& registry,
 //
 // lists.range(n: int) -> list(int)
 //
+// lists.min(<list(T_)>) -> T_ where T_ is partially orderable
+// lists.max(<list(T_)>) -> T_ where T_ is partially orderable
+//
 // <list(T)>.distinct() -> list(T)
 //
 // <list(dyn)>.flatten() -> list(dyn)
@@ -69,6 +76,9 @@ CheckerLibrary ListsCheckerLibrary();
 //
 // lists.range(n: int) -> list(int)
 //
+// lists.min(<list(T_)>) -> T_ where T_ is partially orderable
+// lists.max(<list(T_)>) -> T_ where T_ is partially orderable
+//
 // <list(T)>.distinct() -> list(T)
 //
 // <list(dyn)>.flatten() -> list(dyn)
@@ -22,6 +22,7 @@
 #include "cel/expr/syntax.pb.h"
 #include "absl/status/status.h"
 #include "absl/status/status_matchers.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "checker/validation_result.h"
 #include "common/source.h"
@@ -83,34 +84,40 @@ TEST_P(ListsFunctionsTest, EndToEnd) {
   Expr expr = parsed_expr.expr();
   SourceInfo source_info = parsed_expr.source_info();
 
-  google::protobuf::Arena arena;
-  const auto options = RuntimeOptions{};
-  ASSERT_OK_AND_ASSIGN(auto builder,
-                       CreateStandardRuntimeBuilder(
-                           internal::GetTestingDescriptorPool(), options));
-
-  // Needed to resolve namespaced functions when evaluating a ParsedExpr.
-  ASSERT_THAT(cel::EnableReferenceResolver(
-                  builder, cel::ReferenceResolverEnabled::kAlways),
-              IsOk());
-  EXPECT_THAT(RegisterListsFunctions(builder.function_registry(), options),
-              IsOk());
-  ASSERT_OK_AND_ASSIGN(auto runtime, std::move(builder).Build());
-
-  ASSERT_OK_AND_ASSIGN(std::unique_ptr<Program> program,
-                       ProtobufRuntimeAdapter::CreateProgram(*runtime, expr));
-
-  Activation activation;
-  ASSERT_OK_AND_ASSIGN(Value result, program->Evaluate(&arena, activation));
-  if (!test_info.err.empty()) {
-    EXPECT_THAT(result,
-                ErrorValueIs(StatusIs(testing::_, HasSubstr(test_info.err))));
-    return;
+  // Every case also runs with list literals stored unboxed, which takes
+  // separate paths in lists.min(), lists.max() and sort().
+  for (bool unbox_primitive_lists : {false, true}) {
+    SCOPED_TRACE(unbox_primitive_lists);
+    google::protobuf::Arena arena;
+    RuntimeOptions options;
+    options.enable_unboxed_primitive_lists = unbox_primitive_lists;
+    ASSERT_OK_AND_ASSIGN(auto builder,
+                         CreateStandardRuntimeBuilder(
+                             internal::GetTestingDescriptorPool(), options));
+
+    // Needed to resolve namespaced functions when evaluating a ParsedExpr.
+    ASSERT_THAT(cel::EnableReferenceResolver(
+                    builder, cel::ReferenceResolverEnabled::kAlways),
+                IsOk());
+    EXPECT_THAT(RegisterListsFunctions(builder.function_registry(), options),
+                IsOk());
+    ASSERT_OK_AND_ASSIGN(auto runtime, std::move(builder).Build());
+
+    ASSERT_OK_AND_ASSIGN(std::unique_ptr<Program> program,
+                         ProtobufRuntimeAdapter::CreateProgram(*runtime, expr));
+
+    Activation activation;
+    ASSERT_OK_AND_ASSIGN(Value result, program->Evaluate(&arena, activation));
+    if (!test_info.err.empty()) {
+      EXPECT_THAT(result,
+                  ErrorValueIs(StatusIs(testing::_, HasSubstr(test_info.err))));
+      continue;
+    }
+    ASSERT_TRUE(result.IsBool())
+        << test_info.expr << " -> " << result.DebugString();
+    EXPECT_TRUE(result.GetBool().NativeValue())
+        << test_info.expr << " -> " << result.DebugString();
   }
-  ASSERT_TRUE(result.IsBool())
-      << test_info.expr << " -> " << result.DebugString();
-  EXPECT_TRUE(result.GetBool().NativeValue())
-      << test_info.expr << " -> " << result.DebugString();
 }
 
 INSTANTIATE_TEST_SUITE_P(
@@ -119,6 +126,12 @@ INSTANTIATE_TEST_SUITE_P(
         // lists.range()
         {R"cel(lists.range(4) == [0,1,2,3])cel"},
         {R"cel(lists.range(0) == [])cel"},
+        {R"cel(lists.range(-1) == [])cel"},
+        {R"cel(lists.range(4)[3] == 3)cel"},
+        {R"cel(3 in lists.range(4) && !(4 in lists.range(4)))cel"},
+        {R"cel(2.0 in lists.range(4) && !(2.5 in lists.range(4)))cel"},
+        {R"cel(lists.range(4).map(e, e * 2) == [0, 2, 4, 6])cel"},
+        {R"cel(lists.range(4).exists(e, e == 3))cel"},
 
         // .reverse()
         {R"cel([5,1,2,3].reverse() == [3,2,1,5])cel"},
@@ -225,6 +238,27 @@ INSTANTIATE_TEST_SUITE_P(
         {R"cel([google.api.expr.runtime.TestMessage{}].sortBy(e, e))cel",
          "unsupported type google.api.expr.runtime.TestMessage"},
 
+        // lists.min() / lists.max()
+        {R"cel(lists.min([3, 1, 2]) == 1)cel"},
+        {R"cel(lists.max([3, 1, 2]) == 3)cel"},
+        {R"cel(lists.min([2.5, -1.5, 0.0]) == -1.5)cel"},
+        {R"cel(lists.max([42u, 3u, 1337u]) == 1337u)cel"},
+        {R"cel(lists.min(['b', 'a', 'c']) == 'a')cel"},
+        {R"cel(
+          lists.max([duration('1m'), duration('2s'), duration('3h')])
+          == duration('3h')
+        )cel"},
+        {R"cel(lists.min([]))cel", "lists.min(): list must not be empty"},
+        {R"cel(lists.max([1, 'a']))cel",
+         "lists.max(): list elements must have the same type"},
+        {R"cel(lists.max([[1], [2]]))cel", "unsupported type list"},
+
+        // .count()
+        {R"cel([].count(e, e > 0) == 0)cel"},
+        {R"cel([-1, 2, 3, -4].count(e, e > 0) == 2)cel"},
+        {R"cel(lists.range(10).count(e, e % 3 == 0) == 4)cel"},
+        {R"cel({'a': 1, 'b': 2}.count(k, k == 'a') == 1)cel"},
+
         // .distinct()
         {R"cel([].distinct() == [])cel"},
         {R"cel([1].distinct() == [1])cel"},
@@ -268,6 +302,62 @@ INSTANTIATE_TEST_SUITE_P(
         )cel"},
     }));
 
+// lists.range() answers membership without materializing its elements, so
+// check it against an equivalent list literal under both equality modes.
+TEST(ListsFunctionsTest, RangeMembershipMatchesListLiteral) {
+  MacroRegistry macro_registry;
+  ParserOptions parser_options;
+  ASSERT_THAT(RegisterStandardMacros(macro_registry, parser_options), IsOk());
+
+  for (bool heterogeneous_equality : {false, true}) {
+    SCOPED_TRACE(heterogeneous_equality);
+    RuntimeOptions options;
+    options.enable_heterogeneous_equality = heterogeneous_equality;
+    ASSERT_OK_AND_ASSIGN(auto builder,
+                         CreateStandardRuntimeBuilder(
+                             internal::GetTestingDescriptorPool(), options));
+    ASSERT_THAT(cel::EnableReferenceResolver(
+                    builder, cel::ReferenceResolverEnabled::kAlways),
+                IsOk());
+    ASSERT_THAT(RegisterListsFunctions(builder.function_registry(), options),
+                IsOk());
+    ASSERT_OK_AND_ASSIGN(auto runtime, std::move(builder).Build());
+
+    for (absl::string_view operand :
+         {"0", "3", "-1", "2u", "3u", "1.0", "1.5", "'1'", "null"}) {
+      SCOPED_TRACE(operand);
+      std::string expr_text = absl::StrCat("(", operand,
+                                           " in lists.range(3)) == (", operand,
+                                           " in [0, 1, 2])");
+      ASSERT_OK_AND_ASSIGN(auto source, cel::NewSource(expr_text, "<input>"));
+      ASSERT_OK_AND_ASSIGN(ParsedExpr parsed_expr,
+                           google::api::expr::parser::Parse(
+                               *source, macro_registry, parser_options));
+      ASSERT_OK_AND_ASSIGN(std::unique_ptr<Program> program,
+                           ProtobufRuntimeAdapter::CreateProgram(
+                               *runtime, parsed_expr.expr()));
+
+      google::protobuf::Arena arena;
+      Activation activation;
+      ASSERT_OK_AND_ASSIGN(Value result, program->Evaluate(&arena, activation));
+      ASSERT_TRUE(result.IsBool()) << result.DebugString();
+      EXPECT_TRUE(result.GetBool().NativeValue());
+    }
+  }
+}
+
+TEST(ListsFunctionsTest, ListCountMacroParseError) {
+  ASSERT_OK_AND_ASSIGN(auto source,
+                       cel::NewSource("[1, 2].count(e.f, true)", "<input>"));
+  MacroRegistry macro_registry;
+  ParserOptions parser_options{.add_macro_calls = true};
+  ASSERT_THAT(RegisterListsMacros(macro_registry, parser_options), IsOk());
+  EXPECT_THAT(
+      google::api::expr::parser::Parse(*source, macro_registry, parser_options),
+      StatusIs(absl::StatusCode::kInvalidArgument,
+               HasSubstr("count() variable name must be a simple identifier")));
+}
+
 TEST(ListsFunctionsTest, ListSortByMacroParseError) {
   ASSERT_OK_AND_ASSIGN(auto source,
                        cel::NewSource("100.sortBy(e, e)", "<input>"));
@@ -363,6 +453,15 @@ std::vector<ListCheckerTestCase> createListsCheckerParams() {
       {R"('abc'.sort() == [])", "no matching overload for 'sort'"},
       {R"([1,2,3,4].sort() == 'abc')", "no matching overload for '_==_'"},
       {R"([1,2,3,4].sort(2) == [1,2,3,4])", "undeclared reference"},
+      // lists.min() / lists.max()
+      {R"(lists.min([1,2,3]) == 1)"},
+      {R"(lists.max(['a', 'b']) == 'b')"},
+      {R"(lists.min([1,2,3]) == 'abc')", "no matching overload for '_==_'"},
+      {R"(lists.max([TestAllTypes{}]) == TestAllTypes{})",
+       "no matching overload for 'lists.max'"},
+      // count macro
+      {R"([1,2,3,4].count(x, x > 2) == 2)"},
+      {R"([1,2,3,4].count(x, x) == 2)", "no matching overload for '_?_:_'"},
       // sortBy macro
       {R"([1,2,3,4].sortBy(x, -x) == [4,3,2,1])"},
       {R"([TestAllTypes{}, TestAllTypes{}].sortBy(x, x) == [])",
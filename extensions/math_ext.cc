@@ -15,8 +15,11 @@
 #include "extensions/math_ext.h"
 
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <limits>
+#include <type_traits>
+#include <utility>
 
 #include "absl/base/casts.h"
 #include "absl/base/nullability.h"
@@ -25,11 +28,15 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "common/casting.h"
 #include "common/value.h"
+#include "common/value_kind.h"
+#include "common/values/primitive_list_value.h"
 #include "eval/public/cel_function_registry.h"
 #include "eval/public/cel_number.h"
 #include "eval/public/cel_options.h"
+#include "internal/overflow.h"
 #include "internal/status_macros.h"
 #include "runtime/function_adapter.h"
 #include "runtime/function_registry.h"
@@ -48,6 +55,8 @@ using ::google::api::expr::runtime::InterpreterOptions;
 
 static constexpr char kMathMin[] = "math.@min";
 static constexpr char kMathMax[] = "math.@max";
+static constexpr char kMathSum[] = "math.sum";
+static constexpr char kMathAvg[] = "math.avg";
 
 struct ToValueVisitor {
   Value operator()(uint64_t v) const { return UintValue{v}; }
@@ -171,6 +180,144 @@ absl::StatusOr<Value> MaxList(
   return NumberToValue(min);
 }
 
+// Accumulates the native values of a list whose elements must all be of
+// `ValueType`. Integral sums report overflow as an error.
+template <typename ValueType, typename NativeType>
+absl::StatusOr<Value> SumListNative(
+    const ListValue& values, absl::string_view function,
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena) {
+  NativeType sum = 0;
+  absl::Status status = values.ForEach(
+      [&](const Value& value) -> absl::StatusOr<bool> {
+        auto typed_value = value.As<ValueType>();
+        if (!typed_value.has_value()) {
+          return absl::InvalidArgumentError(absl::StrCat(
+              function, " arguments must be numeric values of the same type"));
+        }
+        if constexpr (std::is_floating_point_v<NativeType>) {
+          sum += typed_value->NativeValue();
+        } else {
+          CEL_ASSIGN_OR_RETURN(
+              sum, cel::internal::CheckedAdd(sum, typed_value->NativeValue()));
+        }
+        return true;
+      },
+      descriptor_pool, message_factory, arena);
+  if (!status.ok()) {
+    return ErrorValue(std::move(status));
+  }
+  return ValueType(sum);
+}
+
+// Like `SumListNative()`, but for lists which store their elements unboxed,
+// so the loop runs over the native array directly.
+template <typename ValueType, typename NativeType>
+Value SumUnboxedList(absl::Span<const NativeType> elements) {
+  NativeType sum = 0;
+  for (NativeType element : elements) {
+    if constexpr (std::is_floating_point_v<NativeType>) {
+      sum += element;
+    } else {
+      absl::StatusOr<NativeType> checked_sum =
+          cel::internal::CheckedAdd(sum, element);
+      if (!checked_sum.ok()) {
+        return ErrorValue(std::move(checked_sum).status());
+      }
+      sum = *checked_sum;
+    }
+  }
+  return ValueType(sum);
+}
+
+// Returns the sum of the native array as a double, used by math.avg().
+template <typename NativeType>
+double SumUnboxedListAsDouble(absl::Span<const NativeType> elements) {
+  double sum = 0;
+  for (NativeType element : elements) {
+    sum += static_cast<double>(element);
+  }
+  return sum;
+}
+
+absl::StatusOr<Value> SumList(
+    const ListValue& values,
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena) {
+  CEL_ASSIGN_OR_RETURN(size_t size, values.Size());
+  if (size == 0) {
+    // The element type of an empty list isn't known at runtime, so there is no
+    // zero of the declared result type to return.
+    return ErrorValue(
+        absl::InvalidArgumentError("math.sum argument must not be empty"));
+  }
+  if (auto elements = common_internal::AsIntListValue(values); elements) {
+    return SumUnboxedList<IntValue>(*elements);
+  }
+  if (auto elements = common_internal::AsUintListValue(values); elements) {
+    return SumUnboxedList<UintValue>(*elements);
+  }
+  if (auto elements = common_internal::AsDoubleListValue(values); elements) {
+    return SumUnboxedList<DoubleValue>(*elements);
+  }
+  CEL_ASSIGN_OR_RETURN(Value first,
+                       values.Get(0, descriptor_pool, message_factory, arena));
+  switch (first.kind()) {
+    case ValueKind::kInt:
+      return SumListNative<IntValue, int64_t>(
+          values, kMathSum, descriptor_pool, message_factory, arena);
+    case ValueKind::kUint:
+      return SumListNative<UintValue, uint64_t>(
+          values, kMathSum, descriptor_pool, message_factory, arena);
+    case ValueKind::kDouble:
+      return SumListNative<DoubleValue, double>(
+          values, kMathSum, descriptor_pool, message_factory, arena);
+    default:
+      return ErrorValue(
+          absl::InvalidArgumentError("math.sum arguments must be numeric"));
+  }
+}
+
+// Computes the arithmetic mean in double precision, so integral lists cannot
+// overflow.
+absl::StatusOr<Value> AvgList(
+    const ListValue& values,
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena) {
+  CEL_ASSIGN_OR_RETURN(size_t size, values.Size());
+  if (size == 0) {
+    return ErrorValue(
+        absl::InvalidArgumentError("math.avg argument must not be empty"));
+  }
+  if (auto elements = common_internal::AsIntListValue(values); elements) {
+    return DoubleValue(SumUnboxedListAsDouble(*elements) /
+                       static_cast<double>(size));
+  }
+  if (auto elements = common_internal::AsUintListValue(values); elements) {
+    return DoubleValue(SumUnboxedListAsDouble(*elements) /
+                       static_cast<double>(size));
+  }
+  if (auto elements = common_internal::AsDoubleListValue(values); elements) {
+    return DoubleValue(SumUnboxedListAsDouble(*elements) /
+                       static_cast<double>(size));
+  }
+  double sum = 0;
+  absl::Status status = values.ForEach(
+      [&](const Value& value) -> absl::StatusOr<bool> {
+        CEL_ASSIGN_OR_RETURN(CelNumber number, ValueToNumber(value, kMathAvg));
+        sum += number.AsDouble();
+        return true;
+      },
+      descriptor_pool, message_factory, arena);
+  if (!status.ok()) {
+    return ErrorValue(std::move(status));
+  }
+  return DoubleValue(sum / static_cast<double>(size));
+}
+
 template <typename T, typename U>
 absl::Status RegisterCrossNumericMin(FunctionRegistry& registry) {
   CEL_RETURN_IF_ERROR(
@@ -361,6 +508,13 @@ absl::Status RegisterMathExtensionFunctions(FunctionRegistry& registry,
                            ListValue>::RegisterGlobalOverload(kMathMax, MaxList,
                                                               registry)));
 
+  CEL_RETURN_IF_ERROR(
+      (UnaryFunctionAdapter<absl::StatusOr<Value>, ListValue>::
+           RegisterGlobalOverload(kMathSum, SumList, registry)));
+  CEL_RETURN_IF_ERROR(
+      (UnaryFunctionAdapter<absl::StatusOr<Value>, ListValue>::
+           RegisterGlobalOverload(kMathAvg, AvgList, registry)));
+
   CEL_RETURN_IF_ERROR(
       (UnaryFunctionAdapter<double, double>::RegisterGlobalOverload(
           "math.ceil", CeilDouble, registry)));
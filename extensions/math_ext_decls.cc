@@ -125,6 +125,31 @@ absl::Status AddMinMaxDecls(TypeCheckerBuilder& builder) {
   return absl::OkStatus();
 }
 
+absl::Status AddAggregateDecls(TypeCheckerBuilder& builder) {
+  const Type kListNumerics[] = {ListIntType(), ListDoubleType(),
+                                ListUintType()};
+
+  FunctionDecl sum_decl;
+  sum_decl.set_name("math.sum");
+
+  FunctionDecl avg_decl;
+  avg_decl.set_name("math.avg");
+
+  for (const Type& type : kListNumerics) {
+    CEL_RETURN_IF_ERROR(sum_decl.AddOverload(
+        MakeOverloadDecl(absl::StrCat("math_sum_", OverloadTypeName(type)),
+                         type.AsList()->GetElement(), type)));
+    CEL_RETURN_IF_ERROR(avg_decl.AddOverload(
+        MakeOverloadDecl(absl::StrCat("math_avg_", OverloadTypeName(type)),
+                         DoubleType(), type)));
+  }
+
+  CEL_RETURN_IF_ERROR(builder.AddFunction(sum_decl));
+  CEL_RETURN_IF_ERROR(builder.AddFunction(avg_decl));
+
+  return absl::OkStatus();
+}
+
 absl::Status AddSignednessDecls(TypeCheckerBuilder& builder) {
   const Type kNumerics[] = {IntType(), DoubleType(), UintType()};
 
@@ -272,6 +297,7 @@ absl::Status AddBitwiseDecls(TypeCheckerBuilder& builder) {
 
 absl::Status AddMathExtensionDeclarations(TypeCheckerBuilder& builder) {
   CEL_RETURN_IF_ERROR(AddMinMaxDecls(builder));
+  CEL_RETURN_IF_ERROR(AddAggregateDecls(builder));
   CEL_RETURN_IF_ERROR(AddSignednessDecls(builder));
   CEL_RETURN_IF_ERROR(AddFloatingPointDecls(builder));
   CEL_RETURN_IF_ERROR(AddBitwiseDecls(builder));
@@ -21,6 +21,7 @@
 #include "cel/expr/syntax.pb.h"
 #include "absl/status/status.h"
 #include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
@@ -41,6 +42,7 @@
 #include "eval/public/testing/matchers.h"
 #include "extensions/math_ext_decls.h"
 #include "extensions/math_ext_macros.h"
+#include "internal/status_macros.h"
 #include "internal/testing.h"
 #include "internal/testing_descriptor_pool.h"
 #include "parser/parser.h"
@@ -415,6 +417,137 @@ TEST_P(MathExtMacroParamsTest, ParserAndCheckerTests) {
   EXPECT_EQ(value.GetBool(), true);
 }
 
+// The aggregates take a separate path for list literals stored unboxed.
+TEST(MathExtTest, UnboxedListAggregates) {
+  ASSERT_OK_AND_ASSIGN(
+      auto compiler_builder,
+      cel::NewCompilerBuilder(internal::GetTestingDescriptorPool()));
+  ASSERT_THAT(compiler_builder->AddLibrary(StandardCheckerLibrary()), IsOk());
+  ASSERT_THAT(compiler_builder->AddLibrary(MathCompilerLibrary()), IsOk());
+  ASSERT_OK_AND_ASSIGN(auto compiler, std::move(*compiler_builder).Build());
+
+  RuntimeOptions opts;
+  opts.enable_unboxed_primitive_lists = true;
+  ASSERT_OK_AND_ASSIGN(
+      auto runtime_builder,
+      CreateStandardRuntimeBuilder(internal::GetTestingDescriptorPool(), opts));
+  ASSERT_THAT(
+      RegisterMathExtensionFunctions(runtime_builder.function_registry(), opts),
+      IsOk());
+  ASSERT_OK_AND_ASSIGN(auto runtime, std::move(runtime_builder).Build());
+
+  for (absl::string_view expr : {
+           "math.sum([1, 2, 3]) == 6",
+           "math.sum([1u, 2u, 3u]) == 6u",
+           "math.sum([1.5, 2.5, -1.0]) == 3.0",
+           "math.avg([1, 2, 3, 4]) == 2.5",
+           "math.avg([2u, 4u]) == 3.0",
+           "math.avg([0.5, 1.5]) == 1.0",
+       }) {
+    SCOPED_TRACE(expr);
+    ASSERT_OK_AND_ASSIGN(auto result, compiler->Compile(expr, "<input>"));
+    ASSERT_TRUE(result.IsValid()) << FormatIssues(result);
+    ASSERT_OK_AND_ASSIGN(auto program,
+                         runtime->CreateProgram(*result.ReleaseAst()));
+    google::protobuf::Arena arena;
+    cel::Activation activation;
+    ASSERT_OK_AND_ASSIGN(auto value, program->Evaluate(&arena, activation));
+    ASSERT_TRUE(value.IsBool()) << value.DebugString();
+    EXPECT_TRUE(value.GetBool());
+  }
+
+  ASSERT_OK_AND_ASSIGN(
+      auto result,
+      compiler->Compile("math.sum([9223372036854775807, 1])", "<input>"));
+  ASSERT_OK_AND_ASSIGN(auto program,
+                       runtime->CreateProgram(*result.ReleaseAst()));
+  google::protobuf::Arena arena;
+  cel::Activation activation;
+  ASSERT_OK_AND_ASSIGN(auto value, program->Evaluate(&arena, activation));
+  EXPECT_TRUE(value.IsError());
+}
+
+TEST(MathExtTest, SumEdgeCases) {
+  ASSERT_OK_AND_ASSIGN(
+      auto compiler_builder,
+      cel::NewCompilerBuilder(internal::GetTestingDescriptorPool()));
+  ASSERT_THAT(compiler_builder->AddLibrary(StandardCheckerLibrary()), IsOk());
+  ASSERT_THAT(compiler_builder->AddLibrary(MathCompilerLibrary()), IsOk());
+  ASSERT_OK_AND_ASSIGN(auto compiler, std::move(*compiler_builder).Build());
+
+  for (bool unboxed : {false, true}) {
+    SCOPED_TRACE(absl::StrCat("unboxed: ", unboxed));
+    RuntimeOptions opts;
+    opts.enable_unboxed_primitive_lists = unboxed;
+    ASSERT_OK_AND_ASSIGN(
+        auto runtime_builder,
+        CreateStandardRuntimeBuilder(internal::GetTestingDescriptorPool(),
+                                     opts));
+    ASSERT_THAT(RegisterMathExtensionFunctions(
+                    runtime_builder.function_registry(), opts),
+                IsOk());
+    ASSERT_OK_AND_ASSIGN(auto runtime, std::move(runtime_builder).Build());
+
+    google::protobuf::Arena arena;
+    auto evaluate = [&](absl::string_view expr) -> absl::StatusOr<Value> {
+      CEL_ASSIGN_OR_RETURN(auto result, compiler->Compile(expr, "<input>"));
+      if (!result.IsValid()) {
+        return absl::InvalidArgumentError(FormatIssues(result));
+      }
+      CEL_ASSIGN_OR_RETURN(auto program,
+                           runtime->CreateProgram(*result.ReleaseAst()));
+      cel::Activation activation;
+      return program->Evaluate(&arena, activation);
+    };
+
+    for (absl::string_view expr : {
+             "math.sum([1]) == 1",
+             "math.sum([9223372036854775807, -1]) == 9223372036854775806",
+             "math.sum([18446744073709551615u, 0u]) == 18446744073709551615u",
+         }) {
+      SCOPED_TRACE(expr);
+      ASSERT_OK_AND_ASSIGN(Value value, evaluate(expr));
+      ASSERT_TRUE(value.IsBool()) << value.DebugString();
+      EXPECT_TRUE(value.GetBool());
+    }
+
+    for (absl::string_view expr : {
+             "math.sum([])",
+             "math.sum(dyn([]))",
+             // The result is declared as double, so an int zero would not
+             // match any overload of _+_.
+             "math.sum([1.0].filter(x, x > 2.0)) + 1.0",
+             "math.sum([1u].filter(x, x > 2u)) + 1u",
+         }) {
+      SCOPED_TRACE(expr);
+      ASSERT_OK_AND_ASSIGN(Value value, evaluate(expr));
+      ASSERT_TRUE(value.IsError()) << value.DebugString();
+      EXPECT_THAT(value.GetError().ToStatus(),
+                  StatusIs(absl::StatusCode::kInvalidArgument,
+                           HasSubstr("math.sum argument must not be empty")));
+    }
+
+    for (absl::string_view expr : {
+             // Overflow.
+             "math.sum([9223372036854775807, 1])",
+             "math.sum([-9223372036854775807, -2])",
+             "math.sum([18446744073709551615u, 1u])",
+             // Mixed numeric types.
+             "math.sum([1, dyn(2u)])",
+             "math.sum([1.0, dyn(2)])",
+             "math.sum([1u, dyn(2.0)])",
+             // Non-numeric elements.
+             "math.sum(dyn([true]))",
+             "math.sum(dyn(['a', 'b']))",
+             "math.sum([1, dyn('a')])",
+         }) {
+      SCOPED_TRACE(expr);
+      ASSERT_OK_AND_ASSIGN(Value value, evaluate(expr));
+      EXPECT_TRUE(value.IsError()) << value.DebugString();
+    }
+  }
+}
+
 INSTANTIATE_TEST_SUITE_P(
     MathExtMacrosParamsTest, MathExtMacroParamsTest,
     testing::ValuesIn<MacroTestCase>(
@@ -571,7 +704,14 @@ INSTANTIATE_TEST_SUITE_P(
          {"math.bitShiftLeft(1, 1) == 2"},
          {"math.bitShiftLeft(1u, 1) == 2u"},
          {"math.bitShiftRight(4, 1) == 2"},
-         {"math.bitShiftRight(4u, 1) == 2u"}}));
+         {"math.bitShiftRight(4u, 1) == 2u"},
+         // Aggregates over lists.
+         {"math.sum([1, 2, 3]) == 6"},
+         {"math.sum([1u, 2u, 3u]) == 6u"},
+         {"math.sum([1.5, 2.5, -1.0]) == 3.0"},
+         {"math.avg([1, 2, 3, 4]) == 2.5"},
+         {"math.avg([2u, 4u]) == 3.0"},
+         {"math.avg([0.5, 1.5]) == 1.0"}}));
 
 }  // namespace
 }  // namespace cel::extensions
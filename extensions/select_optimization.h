@@ -54,6 +54,10 @@ struct SelectOptimizationOptions {
 // Assumes the default runtime implementation, an error with code
 // InvalidArgument is returned if it is not.
 //
+// The default planner already binds the field descriptor for each select on
+// an operand the type checker resolved to a message type. This optimization
+// additionally collapses chains of selects into a single step.
+//
 // Note: implementation in progress -- please consult the CEL team before
 // enabling in an existing environment.
 absl::Status EnableSelectOptimization(
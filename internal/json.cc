@@ -14,8 +14,12 @@
 
 #include "internal/json.h"
 
+#include <algorithm>
+#include <charconv>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <memory>
 #include <string>
 #include <tuple>
@@ -40,12 +44,15 @@
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/time.h"
 #include "absl/types/variant.h"
+#include "common/json.h"
 #include "extensions/protobuf/internal/map_reflection.h"
 #include "internal/status_macros.h"
 #include "internal/strings.h"
 #include "internal/well_known_types.h"
 #include "google/protobuf/descriptor.h"
+#include "google/protobuf/io/zero_copy_stream.h"
 #include "google/protobuf/map_field.h"
 #include "google/protobuf/message.h"
 #include "google/protobuf/message_lite.h"
@@ -2036,4 +2043,736 @@ bool JsonMapEquals(const google::protobuf::MessageLite& lhs,
                        google::protobuf::DownCastMessage<google::protobuf::Message>(rhs));
 }
 
+JsonWriter::~JsonWriter() {
+  if (buffer_size_ > 0) {
+    output_->BackUp(buffer_size_);
+  }
+}
+
+void JsonWriter::WriteNull() {
+  BeginValue();
+  Write("null");
+}
+
+void JsonWriter::WriteBool(bool value) {
+  BeginValue();
+  Write(value ? absl::string_view("true") : absl::string_view("false"));
+}
+
+void JsonWriter::WriteNumber(double value) {
+  if (ABSL_PREDICT_FALSE(!std::isfinite(value))) {
+    if (std::isnan(value)) {
+      WriteString("NaN");
+    } else if (std::signbit(value)) {
+      WriteString("-Infinity");
+    } else {
+      WriteString("Infinity");
+    }
+    return;
+  }
+  // Large enough for the shortest representation of any finite double.
+  char buffer[32];
+  const auto result =
+      std::to_chars(buffer, buffer + sizeof(buffer), value);
+  ABSL_DCHECK(result.ec == std::errc());
+  BeginValue();
+  Write(absl::string_view(buffer, static_cast<size_t>(result.ptr - buffer)));
+}
+
+void JsonWriter::WriteNumber(int64_t value) {
+  char buffer[24];
+  const auto result =
+      std::to_chars(buffer, buffer + sizeof(buffer), value);
+  ABSL_DCHECK(result.ec == std::errc());
+  const absl::string_view digits(buffer,
+                                 static_cast<size_t>(result.ptr - buffer));
+  BeginValue();
+  if (value < kJsonMinInt || value > kJsonMaxInt) {
+    Write('"');
+    Write(digits);
+    Write('"');
+  } else {
+    Write(digits);
+  }
+}
+
+void JsonWriter::WriteNumber(uint64_t value) {
+  char buffer[24];
+  const auto result =
+      std::to_chars(buffer, buffer + sizeof(buffer), value);
+  ABSL_DCHECK(result.ec == std::errc());
+  const absl::string_view digits(buffer,
+                                 static_cast<size_t>(result.ptr - buffer));
+  BeginValue();
+  if (value > kJsonMaxUint) {
+    Write('"');
+    Write(digits);
+    Write('"');
+  } else {
+    Write(digits);
+  }
+}
+
+void JsonWriter::WriteString(absl::string_view value) {
+  BeginValue();
+  WriteQuoted(value);
+}
+
+void JsonWriter::WriteString(const absl::Cord& value) {
+  BeginValue();
+  Write('"');
+  for (absl::string_view chunk : value.Chunks()) {
+    WriteEscaped(chunk);
+  }
+  Write('"');
+}
+
+void JsonWriter::WriteBytes(absl::string_view value) {
+  // Base64 never needs escaping.
+  BeginValue();
+  Write('"');
+  Write(absl::Base64Escape(value));
+  Write('"');
+}
+
+void JsonWriter::WriteBytes(const absl::Cord& value) {
+  if (auto flat = value.TryFlat(); flat) {
+    WriteBytes(*flat);
+    return;
+  }
+  WriteBytes(static_cast<std::string>(value));
+}
+
+void JsonWriter::WriteDuration(absl::Duration value) {
+  google::protobuf::Duration proto;
+  proto.set_seconds(absl::IDivDuration(value, absl::Seconds(1), &value));
+  proto.set_nanos(static_cast<int32_t>(
+      absl::IDivDuration(value, absl::Nanoseconds(1), &value)));
+  ABSL_DCHECK(TimeUtil::IsDurationValid(proto));
+  WriteString(TimeUtil::ToString(proto));
+}
+
+void JsonWriter::WriteTimestamp(absl::Time value) {
+  google::protobuf::Timestamp proto;
+  proto.set_seconds(absl::ToUnixSeconds(value));
+  proto.set_nanos((value - absl::FromUnixSeconds(proto.seconds())) /
+                  absl::Nanoseconds(1));
+  ABSL_DCHECK(TimeUtil::IsTimestampValid(proto));
+  WriteString(TimeUtil::ToString(proto));
+}
+
+void JsonWriter::BeginArray() {
+  BeginValue();
+  Write('[');
+  nesting_.push_back(false);
+}
+
+void JsonWriter::EndArray() {
+  ABSL_DCHECK(!nesting_.empty());
+  ABSL_DCHECK(!after_key_);
+  nesting_.pop_back();
+  Write(']');
+}
+
+void JsonWriter::BeginObject() {
+  BeginValue();
+  Write('{');
+  nesting_.push_back(false);
+}
+
+void JsonWriter::WriteKey(absl::string_view key) {
+  ABSL_DCHECK(!nesting_.empty());
+  ABSL_DCHECK(!after_key_);
+  BeginValue();
+  WriteQuoted(key);
+  Write(':');
+  after_key_ = true;
+}
+
+void JsonWriter::EndObject() {
+  ABSL_DCHECK(!nesting_.empty());
+  ABSL_DCHECK(!after_key_);
+  nesting_.pop_back();
+  Write('}');
+}
+
+absl::Status JsonWriter::WriteMessage(const google::protobuf::Message& message) {
+  const auto* descriptor = message.GetDescriptor();
+  switch (descriptor->well_known_type()) {
+    case Descriptor::WELLKNOWNTYPE_DOUBLEVALUE: {
+      CEL_RETURN_IF_ERROR(reflection_.DoubleValue().Initialize(descriptor));
+      WriteNumber(reflection_.DoubleValue().GetValue(message));
+    } break;
+    case Descriptor::WELLKNOWNTYPE_FLOATVALUE: {
+      CEL_RETURN_IF_ERROR(reflection_.FloatValue().Initialize(descriptor));
+      WriteNumber(
+          static_cast<double>(reflection_.FloatValue().GetValue(message)));
+    } break;
+    case Descriptor::WELLKNOWNTYPE_INT64VALUE: {
+      CEL_RETURN_IF_ERROR(reflection_.Int64Value().Initialize(descriptor));
+      WriteNumber(reflection_.Int64Value().GetValue(message));
+    } break;
+    case Descriptor::WELLKNOWNTYPE_UINT64VALUE: {
+      CEL_RETURN_IF_ERROR(reflection_.UInt64Value().Initialize(descriptor));
+      WriteNumber(reflection_.UInt64Value().GetValue(message));
+    } break;
+    case Descriptor::WELLKNOWNTYPE_INT32VALUE: {
+      CEL_RETURN_IF_ERROR(reflection_.Int32Value().Initialize(descriptor));
+      WriteNumber(
+          static_cast<int64_t>(reflection_.Int32Value().GetValue(message)));
+    } break;
+    case Descriptor::WELLKNOWNTYPE_UINT32VALUE: {
+      CEL_RETURN_IF_ERROR(reflection_.UInt32Value().Initialize(descriptor));
+      WriteNumber(
+          static_cast<uint64_t>(reflection_.UInt32Value().GetValue(message)));
+    } break;
+    case Descriptor::WELLKNOWNTYPE_STRINGVALUE: {
+      CEL_RETURN_IF_ERROR(reflection_.StringValue().Initialize(descriptor));
+      WriteStringValue(reflection_.StringValue().GetValue(message, scratch_));
+    } break;
+    case Descriptor::WELLKNOWNTYPE_BYTESVALUE: {
+      CEL_RETURN_IF_ERROR(reflection_.BytesValue().Initialize(descriptor));
+      WriteBytesValue(reflection_.BytesValue().GetValue(message, scratch_));
+    } break;
+    case Descriptor::WELLKNOWNTYPE_BOOLVALUE: {
+      CEL_RETURN_IF_ERROR(reflection_.BoolValue().Initialize(descriptor));
+      WriteBool(reflection_.BoolValue().GetValue(message));
+    } break;
+    case Descriptor::WELLKNOWNTYPE_ANY: {
+      CEL_ASSIGN_OR_RETURN(auto unpacked,
+                           well_known_types::UnpackAnyFrom(
+                               /*arena=*/nullptr, reflection_.Any(), message,
+                               descriptor_pool_, message_factory_));
+      const auto* unpacked_descriptor = unpacked->GetDescriptor();
+      BeginObject();
+      WriteKey("@type");
+      WriteString(absl::StrCat("type.googleapis.com/",
+                               unpacked_descriptor->full_name()));
+      switch (unpacked_descriptor->well_known_type()) {
+        case Descriptor::WELLKNOWNTYPE_DOUBLEVALUE:
+          ABSL_FALLTHROUGH_INTENDED;
+        case Descriptor::WELLKNOWNTYPE_FLOATVALUE:
+          ABSL_FALLTHROUGH_INTENDED;
+        case Descriptor::WELLKNOWNTYPE_INT64VALUE:
+          ABSL_FALLTHROUGH_INTENDED;
+        case Descriptor::WELLKNOWNTYPE_UINT64VALUE:
+          ABSL_FALLTHROUGH_INTENDED;
+        case Descriptor::WELLKNOWNTYPE_INT32VALUE:
+          ABSL_FALLTHROUGH_INTENDED;
+        case Descriptor::WELLKNOWNTYPE_UINT32VALUE:
+          ABSL_FALLTHROUGH_INTENDED;
+        case Descriptor::WELLKNOWNTYPE_STRINGVALUE:
+          ABSL_FALLTHROUGH_INTENDED;
+        case Descriptor::WELLKNOWNTYPE_BYTESVALUE:
+          ABSL_FALLTHROUGH_INTENDED;
+        case Descriptor::WELLKNOWNTYPE_BOOLVALUE:
+          ABSL_FALLTHROUGH_INTENDED;
+        case Descriptor::WELLKNOWNTYPE_FIELDMASK:
+          ABSL_FALLTHROUGH_INTENDED;
+        case Descriptor::WELLKNOWNTYPE_DURATION:
+          ABSL_FALLTHROUGH_INTENDED;
+        case Descriptor::WELLKNOWNTYPE_TIMESTAMP:
+          ABSL_FALLTHROUGH_INTENDED;
+        case Descriptor::WELLKNOWNTYPE_VALUE:
+          ABSL_FALLTHROUGH_INTENDED;
+        case Descriptor::WELLKNOWNTYPE_LISTVALUE:
+          ABSL_FALLTHROUGH_INTENDED;
+        case Descriptor::WELLKNOWNTYPE_STRUCT:
+          WriteKey("value");
+          CEL_RETURN_IF_ERROR(WriteMessage(*unpacked));
+          break;
+        default:
+          if (unpacked_descriptor->full_name() == "google.protobuf.Empty") {
+            WriteKey("value");
+            BeginObject();
+            EndObject();
+          } else {
+            CEL_RETURN_IF_ERROR(WriteMessageFields(*unpacked));
+          }
+          break;
+      }
+      EndObject();
+    } break;
+    case Descriptor::WELLKNOWNTYPE_FIELDMASK: {
+      CEL_RETURN_IF_ERROR(reflection_.FieldMask().Initialize(descriptor));
+      std::vector<std::string> paths;
+      const int paths_size = reflection_.FieldMask().PathsSize(message);
+      for (int i = 0; i < paths_size; ++i) {
+        CEL_RETURN_IF_ERROR(SnakeCaseToCamelCase(
+            reflection_.FieldMask().Paths(message, i, scratch_),
+            &paths.emplace_back()));
+      }
+      WriteString(absl::StrJoin(paths, ","));
+    } break;
+    case Descriptor::WELLKNOWNTYPE_DURATION: {
+      CEL_RETURN_IF_ERROR(reflection_.Duration().Initialize(descriptor));
+      google::protobuf::Duration duration;
+      duration.set_seconds(reflection_.Duration().GetSeconds(message));
+      duration.set_nanos(reflection_.Duration().GetNanos(message));
+      WriteString(TimeUtil::ToString(duration));
+    } break;
+    case Descriptor::WELLKNOWNTYPE_TIMESTAMP: {
+      CEL_RETURN_IF_ERROR(reflection_.Timestamp().Initialize(descriptor));
+      google::protobuf::Timestamp timestamp;
+      timestamp.set_seconds(reflection_.Timestamp().GetSeconds(message));
+      timestamp.set_nanos(reflection_.Timestamp().GetNanos(message));
+      WriteString(TimeUtil::ToString(timestamp));
+    } break;
+    case Descriptor::WELLKNOWNTYPE_VALUE:
+      return WriteJsonValue(message);
+    case Descriptor::WELLKNOWNTYPE_LISTVALUE:
+      return WriteJsonList(message);
+    case Descriptor::WELLKNOWNTYPE_STRUCT:
+      return WriteJsonMap(message);
+    default:
+      BeginObject();
+      CEL_RETURN_IF_ERROR(WriteMessageFields(message));
+      EndObject();
+      break;
+  }
+  return absl::OkStatus();
+}
+
+absl::Status JsonWriter::WriteMessageField(
+    const google::protobuf::Message& message,
+    const google::protobuf::FieldDescriptor* absl_nonnull field) {
+  if (field->is_map()) {
+    return WriteMapField(message, field);
+  }
+  if (field->is_repeated()) {
+    return WriteRepeatedField(message, field);
+  }
+  return WriteSingularField(message, field);
+}
+
+absl::Status JsonWriter::Finish() {
+  ABSL_DCHECK(nesting_.empty());
+  if (buffer_size_ > 0) {
+    output_->BackUp(buffer_size_);
+    buffer_ = nullptr;
+    buffer_size_ = 0;
+  }
+  if (failed_) {
+    return absl::UnknownError("failed to write JSON to output stream");
+  }
+  return absl::OkStatus();
+}
+
+absl::Status JsonWriter::WriteMessageFields(const google::protobuf::Message& message) {
+  std::vector<const google::protobuf::FieldDescriptor*> fields;
+  message.GetReflection()->ListFields(message, &fields);
+  for (const auto* field : fields) {
+    WriteKey(field->json_name());
+    CEL_RETURN_IF_ERROR(WriteMessageField(message, field));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status JsonWriter::WriteJsonValue(const google::protobuf::Message& message) {
+  CEL_RETURN_IF_ERROR(reflection_.Value().Initialize(message.GetDescriptor()));
+  const auto kind_case = reflection_.Value().GetKindCase(message);
+  switch (kind_case) {
+    case google::protobuf::Value::KIND_NOT_SET:
+      ABSL_FALLTHROUGH_INTENDED;
+    case google::protobuf::Value::kNullValue:
+      WriteNull();
+      break;
+    case google::protobuf::Value::kBoolValue:
+      WriteBool(reflection_.Value().GetBoolValue(message));
+      break;
+    case google::protobuf::Value::kNumberValue:
+      WriteNumber(reflection_.Value().GetNumberValue(message));
+      break;
+    case google::protobuf::Value::kStringValue:
+      WriteStringValue(reflection_.Value().GetStringValue(message, scratch_));
+      break;
+    case google::protobuf::Value::kListValue:
+      return WriteJsonList(reflection_.Value().GetListValue(message));
+    case google::protobuf::Value::kStructValue:
+      return WriteJsonMap(reflection_.Value().GetStructValue(message));
+    default:
+      return absl::InvalidArgumentError(absl::StrCat(
+          "unexpected google.protobuf.Value kind: ", static_cast<int>(kind_case)));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status JsonWriter::WriteJsonList(const google::protobuf::Message& message) {
+  CEL_RETURN_IF_ERROR(
+      reflection_.ListValue().Initialize(message.GetDescriptor()));
+  const int size = reflection_.ListValue().ValuesSize(message);
+  BeginArray();
+  for (int i = 0; i < size; ++i) {
+    CEL_RETURN_IF_ERROR(
+        WriteJsonValue(reflection_.ListValue().Values(message, i)));
+  }
+  EndArray();
+  return absl::OkStatus();
+}
+
+absl::Status JsonWriter::WriteJsonMap(const google::protobuf::Message& message) {
+  CEL_RETURN_IF_ERROR(reflection_.Struct().Initialize(message.GetDescriptor()));
+  const int size = reflection_.Struct().FieldsSize(message);
+  auto iterator = reflection_.Struct().BeginFields(message);
+  BeginObject();
+  for (int i = 0; i < size; ++i, ++iterator) {
+    WriteKey(iterator.GetKey().GetStringValue());
+    CEL_RETURN_IF_ERROR(
+        WriteJsonValue(iterator.GetValueRef().GetMessageValue()));
+  }
+  EndObject();
+  return absl::OkStatus();
+}
+
+absl::Status JsonWriter::WriteSingularField(
+    const google::protobuf::Message& message,
+    const google::protobuf::FieldDescriptor* absl_nonnull field) {
+  ABSL_DCHECK(!field->is_repeated());
+  const auto* reflection = message.GetReflection();
+  switch (field->type()) {
+    case FieldDescriptor::TYPE_DOUBLE:
+      WriteNumber(reflection->GetDouble(message, field));
+      break;
+    case FieldDescriptor::TYPE_FLOAT:
+      WriteNumber(static_cast<double>(reflection->GetFloat(message, field)));
+      break;
+    case FieldDescriptor::TYPE_FIXED64:
+      ABSL_FALLTHROUGH_INTENDED;
+    case FieldDescriptor::TYPE_UINT64:
+      WriteNumber(reflection->GetUInt64(message, field));
+      break;
+    case FieldDescriptor::TYPE_BOOL:
+      WriteBool(reflection->GetBool(message, field));
+      break;
+    case FieldDescriptor::TYPE_STRING:
+      WriteStringValue(
+          well_known_types::GetStringField(message, field, scratch_));
+      break;
+    case FieldDescriptor::TYPE_GROUP:
+      ABSL_FALLTHROUGH_INTENDED;
+    case FieldDescriptor::TYPE_MESSAGE:
+      return WriteMessage(reflection->GetMessage(message, field));
+    case FieldDescriptor::TYPE_BYTES:
+      WriteBytesValue(
+          well_known_types::GetBytesField(message, field, scratch_));
+      break;
+    case FieldDescriptor::TYPE_FIXED32:
+      ABSL_FALLTHROUGH_INTENDED;
+    case FieldDescriptor::TYPE_UINT32:
+      WriteNumber(static_cast<uint64_t>(reflection->GetUInt32(message, field)));
+      break;
+    case FieldDescriptor::TYPE_ENUM:
+      if (field->enum_type()->full_name() == "google.protobuf.NullValue") {
+        WriteNull();
+      } else {
+        WriteEnum(reflection->GetEnum(message, field),
+                  reflection->GetEnumValue(message, field));
+      }
+      break;
+    case FieldDescriptor::TYPE_SFIXED32:
+      ABSL_FALLTHROUGH_INTENDED;
+    case FieldDescriptor::TYPE_SINT32:
+      ABSL_FALLTHROUGH_INTENDED;
+    case FieldDescriptor::TYPE_INT32:
+      WriteNumber(static_cast<int64_t>(reflection->GetInt32(message, field)));
+      break;
+    case FieldDescriptor::TYPE_SFIXED64:
+      ABSL_FALLTHROUGH_INTENDED;
+    case FieldDescriptor::TYPE_SINT64:
+      ABSL_FALLTHROUGH_INTENDED;
+    case FieldDescriptor::TYPE_INT64:
+      WriteNumber(reflection->GetInt64(message, field));
+      break;
+    default:
+      return absl::InvalidArgumentError(absl::StrCat(
+          "unexpected message field type: ", field->type_name()));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status JsonWriter::WriteRepeatedField(
+    const google::protobuf::Message& message,
+    const google::protobuf::FieldDescriptor* absl_nonnull field) {
+  ABSL_DCHECK(!field->is_map() && field->is_repeated());
+  const auto* reflection = message.GetReflection();
+  const int size = reflection->FieldSize(message, field);
+  BeginArray();
+  for (int index = 0; index < size; ++index) {
+    switch (field->type()) {
+      case FieldDescriptor::TYPE_DOUBLE:
+        WriteNumber(reflection->GetRepeatedDouble(message, field, index));
+        break;
+      case FieldDescriptor::TYPE_FLOAT:
+        WriteNumber(static_cast<double>(
+            reflection->GetRepeatedFloat(message, field, index)));
+        break;
+      case FieldDescriptor::TYPE_FIXED64:
+        ABSL_FALLTHROUGH_INTENDED;
+      case FieldDescriptor::TYPE_UINT64:
+        WriteNumber(reflection->GetRepeatedUInt64(message, field, index));
+        break;
+      case FieldDescriptor::TYPE_BOOL:
+        WriteBool(reflection->GetRepeatedBool(message, field, index));
+        break;
+      case FieldDescriptor::TYPE_STRING:
+        WriteStringValue(
+            GetRepeatedStringField(reflection, message, field, index,
+                                   scratch_));
+        break;
+      case FieldDescriptor::TYPE_GROUP:
+        ABSL_FALLTHROUGH_INTENDED;
+      case FieldDescriptor::TYPE_MESSAGE:
+        CEL_RETURN_IF_ERROR(WriteMessage(
+            reflection->GetRepeatedMessage(message, field, index)));
+        break;
+      case FieldDescriptor::TYPE_BYTES:
+        WriteBytesValue(GetRepeatedBytesField(reflection, message, field,
+                                              index, scratch_));
+        break;
+      case FieldDescriptor::TYPE_FIXED32:
+        ABSL_FALLTHROUGH_INTENDED;
+      case FieldDescriptor::TYPE_UINT32:
+        WriteNumber(static_cast<uint64_t>(
+            reflection->GetRepeatedUInt32(message, field, index)));
+        break;
+      case FieldDescriptor::TYPE_ENUM:
+        if (field->enum_type()->full_name() == "google.protobuf.NullValue") {
+          WriteNull();
+        } else {
+          WriteEnum(reflection->GetRepeatedEnum(message, field, index),
+                    reflection->GetRepeatedEnumValue(message, field, index));
+        }
+        break;
+      case FieldDescriptor::TYPE_SFIXED32:
+        ABSL_FALLTHROUGH_INTENDED;
+      case FieldDescriptor::TYPE_SINT32:
+        ABSL_FALLTHROUGH_INTENDED;
+      case FieldDescriptor::TYPE_INT32:
+        WriteNumber(static_cast<int64_t>(
+            reflection->GetRepeatedInt32(message, field, index)));
+        break;
+      case FieldDescriptor::TYPE_SFIXED64:
+        ABSL_FALLTHROUGH_INTENDED;
+      case FieldDescriptor::TYPE_SINT64:
+        ABSL_FALLTHROUGH_INTENDED;
+      case FieldDescriptor::TYPE_INT64:
+        WriteNumber(reflection->GetRepeatedInt64(message, field, index));
+        break;
+      default:
+        return absl::InvalidArgumentError(absl::StrCat(
+            "unexpected message field type: ", field->type_name()));
+    }
+  }
+  EndArray();
+  return absl::OkStatus();
+}
+
+absl::Status JsonWriter::WriteMapField(
+    const google::protobuf::Message& message,
+    const google::protobuf::FieldDescriptor* absl_nonnull field) {
+  ABSL_DCHECK(field->is_map());
+  const auto* reflection = message.GetReflection();
+  BeginObject();
+  if (reflection->FieldSize(message, field) != 0) {
+    const auto key_to_string =
+        GetMapFieldKeyToString(field->message_type()->map_key());
+    const auto* value_field = field->message_type()->map_value();
+    auto begin =
+        extensions::protobuf_internal::MapBegin(*reflection, message, *field);
+    const auto end =
+        extensions::protobuf_internal::MapEnd(*reflection, message, *field);
+    for (; begin != end; ++begin) {
+      WriteKey((*key_to_string)(begin.GetKey()));
+      CEL_RETURN_IF_ERROR(WriteMapFieldValue(begin.GetValueRef(), value_field));
+    }
+  }
+  EndObject();
+  return absl::OkStatus();
+}
+
+absl::Status JsonWriter::WriteMapFieldValue(
+    const google::protobuf::MapValueConstRef& value,
+    const google::protobuf::FieldDescriptor* absl_nonnull field) {
+  ABSL_DCHECK_EQ(value.type(), field->cpp_type());
+  switch (field->type()) {
+    case FieldDescriptor::TYPE_DOUBLE:
+      WriteNumber(value.GetDoubleValue());
+      break;
+    case FieldDescriptor::TYPE_FLOAT:
+      WriteNumber(static_cast<double>(value.GetFloatValue()));
+      break;
+    case FieldDescriptor::TYPE_FIXED64:
+      ABSL_FALLTHROUGH_INTENDED;
+    case FieldDescriptor::TYPE_UINT64:
+      WriteNumber(value.GetUInt64Value());
+      break;
+    case FieldDescriptor::TYPE_BOOL:
+      WriteBool(value.GetBoolValue());
+      break;
+    case FieldDescriptor::TYPE_STRING:
+      WriteString(value.GetStringValue());
+      break;
+    case FieldDescriptor::TYPE_GROUP:
+      ABSL_FALLTHROUGH_INTENDED;
+    case FieldDescriptor::TYPE_MESSAGE:
+      return WriteMessage(value.GetMessageValue());
+    case FieldDescriptor::TYPE_BYTES:
+      WriteBytes(value.GetStringValue());
+      break;
+    case FieldDescriptor::TYPE_FIXED32:
+      ABSL_FALLTHROUGH_INTENDED;
+    case FieldDescriptor::TYPE_UINT32:
+      WriteNumber(static_cast<uint64_t>(value.GetUInt32Value()));
+      break;
+    case FieldDescriptor::TYPE_ENUM:
+      if (field->enum_type()->full_name() == "google.protobuf.NullValue") {
+        WriteNull();
+      } else {
+        WriteEnum(field->enum_type()->FindValueByNumber(value.GetEnumValue()),
+                  value.GetEnumValue());
+      }
+      break;
+    case FieldDescriptor::TYPE_SFIXED32:
+      ABSL_FALLTHROUGH_INTENDED;
+    case FieldDescriptor::TYPE_SINT32:
+      ABSL_FALLTHROUGH_INTENDED;
+    case FieldDescriptor::TYPE_INT32:
+      WriteNumber(static_cast<int64_t>(value.GetInt32Value()));
+      break;
+    case FieldDescriptor::TYPE_SFIXED64:
+      ABSL_FALLTHROUGH_INTENDED;
+    case FieldDescriptor::TYPE_SINT64:
+      ABSL_FALLTHROUGH_INTENDED;
+    case FieldDescriptor::TYPE_INT64:
+      WriteNumber(value.GetInt64Value());
+      break;
+    default:
+      return absl::InvalidArgumentError(absl::StrCat(
+          "unexpected message field type: ", field->type_name()));
+  }
+  return absl::OkStatus();
+}
+
+void JsonWriter::WriteEnum(
+    const google::protobuf::EnumValueDescriptor* absl_nullable descriptor, int number) {
+  if (descriptor != nullptr) {
+    WriteString(descriptor->name());
+  } else {
+    WriteNumber(static_cast<int64_t>(number));
+  }
+}
+
+void JsonWriter::WriteStringValue(const well_known_types::StringValue& value) {
+  absl::visit(absl::Overload(
+                  [&](absl::string_view string) -> void { WriteString(string); },
+                  [&](const absl::Cord& cord) -> void { WriteString(cord); }),
+              AsVariant(value));
+}
+
+void JsonWriter::WriteBytesValue(const well_known_types::BytesValue& value) {
+  absl::visit(absl::Overload(
+                  [&](absl::string_view string) -> void { WriteBytes(string); },
+                  [&](const absl::Cord& cord) -> void { WriteBytes(cord); }),
+              AsVariant(value));
+}
+
+void JsonWriter::BeginValue() {
+  if (after_key_) {
+    after_key_ = false;
+    return;
+  }
+  if (!nesting_.empty()) {
+    if (nesting_.back()) {
+      Write(',');
+    }
+    nesting_.back() = true;
+  }
+}
+
+void JsonWriter::WriteQuoted(absl::string_view value) {
+  Write('"');
+  WriteEscaped(value);
+  Write('"');
+}
+
+void JsonWriter::WriteEscaped(absl::string_view value) {
+  static constexpr char kHexDigits[] = "0123456789abcdef";
+  size_t begin = 0;
+  for (size_t i = 0; i < value.size(); ++i) {
+    const auto c = static_cast<unsigned char>(value[i]);
+    absl::string_view escape;
+    switch (c) {
+      case '"':
+        escape = "\\\"";
+        break;
+      case '\\':
+        escape = "\\\\";
+        break;
+      case '\b':
+        escape = "\\b";
+        break;
+      case '\f':
+        escape = "\\f";
+        break;
+      case '\n':
+        escape = "\\n";
+        break;
+      case '\r':
+        escape = "\\r";
+        break;
+      case '\t':
+        escape = "\\t";
+        break;
+      default:
+        if (ABSL_PREDICT_TRUE(c >= 0x20)) {
+          continue;
+        }
+        break;
+    }
+    Write(value.substr(begin, i - begin));
+    begin = i + 1;
+    if (!escape.empty()) {
+      Write(escape);
+    } else {
+      const char unicode[] = {'\\', 'u', '0', '0', kHexDigits[c >> 4],
+                              kHexDigits[c & 0xf]};
+      Write(absl::string_view(unicode, sizeof(unicode)));
+    }
+  }
+  Write(value.substr(begin));
+}
+
+void JsonWriter::Write(absl::string_view data) {
+  while (!data.empty()) {
+    if (buffer_size_ == 0) {
+      if (failed_) {
+        return;
+      }
+      void* buffer;
+      if (!output_->Next(&buffer, &buffer_size_)) {
+        failed_ = true;
+        buffer_size_ = 0;
+        return;
+      }
+      buffer_ = static_cast<char*>(buffer);
+      continue;
+    }
+    const size_t size =
+        std::min(data.size(), static_cast<size_t>(buffer_size_));
+    std::memcpy(buffer_, data.data(), size);
+    buffer_ += size;
+    buffer_size_ -= static_cast<int>(size);
+    data.remove_prefix(size);
+  }
+}
+
+void JsonWriter::Write(char c) {
+  if (ABSL_PREDICT_TRUE(buffer_size_ > 0)) {
+    *buffer_++ = c;
+    --buffer_size_;
+    return;
+  }
+  Write(absl::string_view(&c, 1));
+}
+
 }  // namespace cel::internal
@@ -15,12 +15,20 @@
 #ifndef THIRD_PARTY_CEL_CPP_INTERNAL_JSON_H_
 #define THIRD_PARTY_CEL_CPP_INTERNAL_JSON_H_
 
+#include <cstdint>
 #include <string>
 
 #include "google/protobuf/struct.pb.h"
 #include "absl/base/nullability.h"
+#include "absl/container/inlined_vector.h"
 #include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "internal/well_known_types.h"
 #include "google/protobuf/descriptor.h"
+#include "google/protobuf/io/zero_copy_stream.h"
+#include "google/protobuf/map_field.h"
 #include "google/protobuf/message.h"
 
 namespace cel::internal {
@@ -136,6 +144,115 @@ bool JsonMapEquals(const google::protobuf::Message& lhs, const google::protobuf:
 bool JsonMapEquals(const google::protobuf::MessageLite& lhs,
                    const google::protobuf::MessageLite& rhs);
 
+// `JsonWriter` writes JSON text directly to a
+// `google::protobuf::io::ZeroCopyOutputStream`. Values are written as `MessageToJson()`
+// and friends would represent them as `google.protobuf.Value`, but without
+// building the intermediate messages. Output is compact, with no insignificant
+// whitespace.
+//
+// Callers are responsible for the structure of the document: every
+// `BeginArray()` and `BeginObject()` must be matched by `EndArray()` and
+// `EndObject()`, and every member of an object must be preceded by
+// `WriteKey()`. Separators are inserted automatically. Errors from the
+// underlying stream are sticky and reported by `Finish()`.
+class JsonWriter final {
+ public:
+  JsonWriter(const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+             google::protobuf::MessageFactory* absl_nonnull message_factory,
+             google::protobuf::io::ZeroCopyOutputStream* absl_nonnull output)
+      : descriptor_pool_(descriptor_pool),
+        message_factory_(message_factory),
+        output_(output) {}
+
+  JsonWriter(const JsonWriter&) = delete;
+  JsonWriter& operator=(const JsonWriter&) = delete;
+
+  ~JsonWriter();
+
+  void WriteNull();
+
+  void WriteBool(bool value);
+
+  // Non-finite values are written as the strings `"NaN"`, `"Infinity"` and
+  // `"-Infinity"`, as in the proto3 JSON mapping.
+  void WriteNumber(double value);
+
+  // Integers which cannot be represented exactly as `double` are written as
+  // strings, see `kJsonMaxInt`.
+  void WriteNumber(int64_t value);
+  void WriteNumber(uint64_t value);
+
+  void WriteString(absl::string_view value);
+  void WriteString(const absl::Cord& value);
+
+  // Writes `value` as a base64 encoded string.
+  void WriteBytes(absl::string_view value);
+  void WriteBytes(const absl::Cord& value);
+
+  void WriteDuration(absl::Duration value);
+
+  void WriteTimestamp(absl::Time value);
+
+  void BeginArray();
+  void EndArray();
+
+  void BeginObject();
+  void WriteKey(absl::string_view key);
+  void EndObject();
+
+  // Writes `message` as `MessageToJson()` converts it to `google.protobuf.Value`.
+  // Well known types use their special JSON representation, other messages are
+  // written as objects.
+  absl::Status WriteMessage(const google::protobuf::Message& message);
+
+  // Writes the field `field` of `message` as `MessageFieldToJson()` converts it
+  // to `google.protobuf.Value`.
+  absl::Status WriteMessageField(const google::protobuf::Message& message,
+                                 const google::protobuf::FieldDescriptor* absl_nonnull field);
+
+  // Returns any unused buffer to the output stream. Returns an error if the
+  // output stream failed at any point. The writer must not be used afterwards.
+  absl::Status Finish();
+
+ private:
+  absl::Status WriteMessageFields(const google::protobuf::Message& message);
+  absl::Status WriteJsonValue(const google::protobuf::Message& message);
+  absl::Status WriteJsonList(const google::protobuf::Message& message);
+  absl::Status WriteJsonMap(const google::protobuf::Message& message);
+  absl::Status WriteSingularField(const google::protobuf::Message& message,
+                                  const google::protobuf::FieldDescriptor* absl_nonnull field);
+  absl::Status WriteRepeatedField(const google::protobuf::Message& message,
+                                  const google::protobuf::FieldDescriptor* absl_nonnull field);
+  absl::Status WriteMapField(const google::protobuf::Message& message,
+                             const google::protobuf::FieldDescriptor* absl_nonnull field);
+  absl::Status WriteMapFieldValue(const google::protobuf::MapValueConstRef& value,
+                                  const google::protobuf::FieldDescriptor* absl_nonnull field);
+  void WriteEnum(const google::protobuf::EnumValueDescriptor* absl_nullable descriptor,
+                 int number);
+  void WriteStringValue(const well_known_types::StringValue& value);
+  void WriteBytesValue(const well_known_types::BytesValue& value);
+
+  // Writes the separator, if any, that must precede the next value.
+  void BeginValue();
+  void WriteQuoted(absl::string_view value);
+  void WriteEscaped(absl::string_view value);
+  void Write(absl::string_view data);
+  void Write(char c);
+
+  const google::protobuf::DescriptorPool* absl_nonnull const descriptor_pool_;
+  google::protobuf::MessageFactory* absl_nonnull const message_factory_;
+  google::protobuf::io::ZeroCopyOutputStream* absl_nonnull const output_;
+  char* buffer_ = nullptr;
+  int buffer_size_ = 0;
+  bool failed_ = false;
+  // One entry for each open array or object, `true` once it has an element.
+  absl::InlinedVector<bool, 8> nesting_;
+  // Whether a key was just written, so the next value needs no separator.
+  bool after_key_ = false;
+  well_known_types::Reflection reflection_;
+  std::string scratch_;
+};
+
 }  // namespace cel::internal
 
 #endif  // THIRD_PARTY_CEL_CPP_INTERNAL_JSON_H_
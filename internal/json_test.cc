@@ -14,6 +14,11 @@
 
 #include "internal/json.h"
 
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+
 #include "google/protobuf/any.pb.h"
 #include "google/protobuf/duration.pb.h"
 #include "google/protobuf/field_mask.pb.h"
@@ -21,25 +26,34 @@
 #include "google/protobuf/timestamp.pb.h"
 #include "google/protobuf/wrappers.pb.h"
 #include "absl/base/nullability.h"
+#include "absl/functional/function_ref.h"
 #include "absl/log/die_if_null.h"
 #include "absl/status/status.h"
 #include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/cord.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "common/json.h"
 #include "internal/equals_text_proto.h"
 #include "internal/message_type_name.h"
 #include "internal/parse_text_proto.h"
+#include "internal/status_macros.h"
 #include "internal/testing.h"
 #include "internal/testing_descriptor_pool.h"
 #include "internal/testing_message_factory.h"
 #include "cel/expr/conformance/proto3/test_all_types.pb.h"
 #include "google/protobuf/arena.h"
 #include "google/protobuf/descriptor.h"
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
 #include "google/protobuf/message.h"
+#include "google/protobuf/util/json_util.h"
 
 namespace cel::internal {
 namespace {
 
 using ::absl_testing::IsOk;
+using ::absl_testing::IsOkAndHolds;
 using ::absl_testing::StatusIs;
 using ::testing::AnyOf;
 using ::testing::HasSubstr;
@@ -2986,5 +3000,204 @@ TEST_F(JsonEqualsTest, Map_Map_Dynamic_Dynamic) {
                             )pb"))));
 }
 
+class JsonWriterTest : public Test {
+ public:
+  google::protobuf::Arena* absl_nonnull arena() { return &arena_; }
+
+  const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool() {
+    return GetTestingDescriptorPool();
+  }
+
+  google::protobuf::MessageFactory* absl_nonnull message_factory() {
+    return GetTestingMessageFactory();
+  }
+
+  template <typename T>
+  auto DynamicParseTextProto(absl::string_view text) {
+    return ::cel::internal::DynamicParseTextProto<T>(
+        arena(), text, descriptor_pool(), message_factory());
+  }
+
+  absl::StatusOr<std::string> WriteJson(
+      absl::FunctionRef<absl::Status(JsonWriter&)> write) {
+    std::string output;
+    google::protobuf::io::StringOutputStream stream(&output);
+    JsonWriter writer(descriptor_pool(), message_factory(), &stream);
+    CEL_RETURN_IF_ERROR(write(writer));
+    CEL_RETURN_IF_ERROR(writer.Finish());
+    return output;
+  }
+
+  // Checks that the JSON written for `message` parses to the same
+  // `google.protobuf.Value` that `MessageToJson()` produces.
+  void ExpectSameAsMessageToJson(const google::protobuf::Message& message) {
+    ASSERT_OK_AND_ASSIGN(auto json, WriteJson([&](JsonWriter& writer) {
+                           return writer.WriteMessage(message);
+                         }));
+    google::protobuf::Value parsed;
+    ASSERT_TRUE(google::protobuf::util::JsonStringToMessage(json, &parsed).ok())
+        << json;
+    google::protobuf::Value expected;
+    ASSERT_THAT(
+        MessageToJson(message, descriptor_pool(), message_factory(), &expected),
+        IsOk());
+    EXPECT_TRUE(JsonEquals(parsed, expected)) << json;
+  }
+
+ private:
+  google::protobuf::Arena arena_;
+};
+
+TEST_F(JsonWriterTest, Scalars) {
+  EXPECT_THAT(WriteJson([](JsonWriter& writer) {
+                writer.BeginArray();
+                writer.WriteNull();
+                writer.WriteBool(true);
+                writer.WriteBool(false);
+                writer.WriteNumber(1.5);
+                writer.WriteNumber(int64_t{-3});
+                writer.WriteNumber(uint64_t{3});
+                writer.WriteNumber(1e21);
+                writer.EndArray();
+                return absl::OkStatus();
+              }),
+              IsOkAndHolds(R"json([null,true,false,1.5,-3,3,1e+21])json"));
+}
+
+TEST_F(JsonWriterTest, NumbersAsStrings) {
+  EXPECT_THAT(
+      WriteJson([](JsonWriter& writer) {
+        writer.BeginArray();
+        writer.WriteNumber(kJsonMaxInt);
+        writer.WriteNumber(kJsonMaxInt + 1);
+        writer.WriteNumber(std::numeric_limits<uint64_t>::max());
+        writer.WriteNumber(std::nan(""));
+        writer.WriteNumber(-std::numeric_limits<double>::infinity());
+        writer.EndArray();
+        return absl::OkStatus();
+      }),
+      IsOkAndHolds(
+          R"json([9007199254740991,"9007199254740992","18446744073709551615","NaN","-Infinity"])json"));
+}
+
+TEST_F(JsonWriterTest, Strings) {
+  EXPECT_THAT(
+      WriteJson([](JsonWriter& writer) {
+        writer.BeginArray();
+        writer.WriteString("a\"b\\c\n\x01");
+        writer.WriteString(absl::Cord("cord"));
+        writer.WriteBytes("foo");
+        writer.WriteDuration(absl::Seconds(90));
+        writer.WriteTimestamp(absl::UnixEpoch());
+        writer.EndArray();
+        return absl::OkStatus();
+      }),
+      IsOkAndHolds(
+          R"json(["a\"b\\c\n\u0001","cord","Zm9v","90s","1970-01-01T00:00:00Z"])json"));
+}
+
+TEST_F(JsonWriterTest, Nesting) {
+  EXPECT_THAT(WriteJson([](JsonWriter& writer) {
+                writer.BeginObject();
+                writer.WriteKey("a");
+                writer.BeginArray();
+                writer.EndArray();
+                writer.WriteKey("b");
+                writer.BeginObject();
+                writer.EndObject();
+                writer.WriteKey("c");
+                writer.BeginArray();
+                writer.BeginObject();
+                writer.EndObject();
+                writer.WriteNumber(1.0);
+                writer.EndArray();
+                writer.EndObject();
+                return absl::OkStatus();
+              }),
+              IsOkAndHolds(R"json({"a":[],"b":{},"c":[{},1]})json"));
+}
+
+TEST_F(JsonWriterTest, Message) {
+  auto message = DynamicParseTextProto<TestAllTypesProto3>(
+      R"pb(single_int32: 1 single_string: "foo" repeated_int64: [ 1, 2 ])pb");
+  EXPECT_THAT(WriteJson([&](JsonWriter& writer) {
+                return writer.WriteMessage(*message);
+              }),
+              IsOkAndHolds(
+                  R"json({"singleInt32":1,"singleString":"foo","repeatedInt64":[1,2]})json"));
+}
+
+TEST_F(JsonWriterTest, MessageField) {
+  auto message = DynamicParseTextProto<TestAllTypesProto3>(
+      R"pb(map_string_string { key: "foo" value: "bar" })pb");
+  const auto* field = ABSL_DIE_IF_NULL(
+      message->GetDescriptor()->FindFieldByName("map_string_string"));
+  EXPECT_THAT(WriteJson([&](JsonWriter& writer) {
+                return writer.WriteMessageField(*message, field);
+              }),
+              IsOkAndHolds(R"json({"foo":"bar"})json"));
+}
+
+TEST_F(JsonWriterTest, Any) {
+  auto message = DynamicParseTextProto<TestAllTypesProto3>(
+      R"pb(single_any {
+             [type.googleapis.com/google.protobuf.Duration] { seconds: 1 }
+           })pb");
+  EXPECT_THAT(
+      WriteJson(
+          [&](JsonWriter& writer) { return writer.WriteMessage(*message); }),
+      IsOkAndHolds(
+          R"json({"singleAny":{"@type":"type.googleapis.com/google.protobuf.Duration","value":"1s"}})json"));
+}
+
+TEST_F(JsonWriterTest, SameAsMessageToJson) {
+  ExpectSameAsMessageToJson(*DynamicParseTextProto<TestAllTypesProto3>(
+      R"pb(
+        single_int32: -1
+        single_int64: 9007199254740993
+        single_uint32: 1
+        single_uint64: 18446744073709551615
+        single_float: 0.5
+        single_double: 1.25
+        single_bool: true
+        single_string: "foo\n"
+        single_bytes: "bar"
+        standalone_enum: BAR
+        single_duration { seconds: 1 nanos: 500000000 }
+        single_timestamp { seconds: 1 }
+        single_int64_wrapper { value: 2 }
+        single_value { string_value: "baz" }
+        single_struct {
+          fields {
+            key: "a"
+            value { list_value { values { number_value: 1 } } }
+          }
+        }
+        list_value { values { bool_value: true } }
+        field_mask { paths: "foo_bar" }
+        null_value: NULL_VALUE
+        repeated_string: [ "a", "b" ]
+        repeated_nested_message { bb: 1 }
+        map_int64_int64 { key: 1 value: 2 }
+        map_bool_string { key: true value: "t" }
+        map_string_message { key: "m" value { bb: 3 } }
+        single_any {
+          [type.googleapis.com/cel.expr.conformance.proto3.TestAllTypes] {
+            single_int32: 1
+          }
+        }
+      )pb"));
+}
+
+TEST_F(JsonWriterTest, OutputFailure) {
+  char buffer[4];
+  google::protobuf::io::ArrayOutputStream stream(buffer, sizeof(buffer));
+  JsonWriter writer(descriptor_pool(), message_factory(), &stream);
+  writer.BeginArray();
+  writer.WriteNumber(int64_t{12345});
+  writer.EndArray();
+  EXPECT_THAT(writer.Finish(), StatusIs(absl::StatusCode::kUnknown));
+}
+
 }  // namespace
 }  // namespace cel::internal
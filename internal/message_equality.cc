@@ -16,6 +16,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <functional>
 #include <limits>
 #include <memory>
@@ -23,14 +24,18 @@
 #include <type_traits>
 
 #include "absl/base/attributes.h"
+#include "absl/base/no_destructor.h"
 #include "absl/base/nullability.h"
 #include "absl/base/optimization.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/functional/overload.h"
 #include "absl/log/absl_check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
 #include "absl/types/variant.h"
 #include "common/memory.h"
@@ -41,6 +46,7 @@
 #include "internal/well_known_types.h"
 #include "google/protobuf/arena.h"
 #include "google/protobuf/descriptor.h"
+#include "google/protobuf/io/zero_copy_stream.h"
 #include "google/protobuf/message.h"
 #include "google/protobuf/util/message_differencer.h"
 
@@ -269,10 +275,180 @@ struct AnyEqualer {
   }
 };
 
+// Properties of a message type, including the types of its message fields,
+// which determine whether two of its messages can be compared by their wire
+// format instead of through reflection.
+struct MessageTypeTraits {
+  // Has a `google.protobuf.Any` field, or may have one as an extension.
+  // `MessageDifferencer` compares their unpacked contents, so equal messages
+  // may have wire formats of different sizes.
+  bool has_any = false;
+  // Has a floating point field, for which NaN is not equal to itself even if
+  // its encoding is, or a map field, whose entries are encoded in an
+  // unspecified order.
+  bool has_float_or_map = false;
+};
+
+void CollectMessageTypeTraits(
+    const Descriptor* absl_nonnull descriptor,
+    absl::flat_hash_set<const Descriptor*>& visited,
+    MessageTypeTraits& traits) {
+  if (!visited.insert(descriptor).second) {
+    return;
+  }
+  if (descriptor->extension_range_count() != 0) {
+    traits.has_any = true;
+    traits.has_float_or_map = true;
+    return;
+  }
+  for (int i = 0; i < descriptor->field_count(); ++i) {
+    const auto* field = descriptor->field(i);
+    if (field->is_map()) {
+      traits.has_float_or_map = true;
+    }
+    switch (field->cpp_type()) {
+      case FieldDescriptor::CPPTYPE_FLOAT:
+        ABSL_FALLTHROUGH_INTENDED;
+      case FieldDescriptor::CPPTYPE_DOUBLE:
+        traits.has_float_or_map = true;
+        break;
+      case FieldDescriptor::CPPTYPE_MESSAGE:
+        if (field->message_type()->well_known_type() ==
+            Descriptor::WELLKNOWNTYPE_ANY) {
+          traits.has_any = true;
+        } else {
+          CollectMessageTypeTraits(field->message_type(), visited, traits);
+        }
+        break;
+      default:
+        break;
+    }
+    if (traits.has_any && traits.has_float_or_map) {
+      return;
+    }
+  }
+}
+
+MessageTypeTraits ComputeMessageTypeTraits(
+    const Descriptor* absl_nonnull descriptor) {
+  MessageTypeTraits traits;
+  absl::flat_hash_set<const Descriptor*> visited;
+  CollectMessageTypeTraits(descriptor, visited, traits);
+  return traits;
+}
+
+// Traits of message types from the generated pool, whose descriptors live until
+// the program exits. Descriptors from other pools may be destroyed and their
+// addresses reused, so their traits are computed on each call instead.
+class MessageTypeTraitsCache final {
+ public:
+  static MessageTypeTraitsCache& Get() {
+    static absl::NoDestructor<MessageTypeTraitsCache> cache;
+    return *cache;
+  }
+
+  MessageTypeTraits Lookup(const Descriptor* absl_nonnull descriptor) {
+    {
+      absl::ReaderMutexLock lock(&mutex_);
+      if (auto it = traits_.find(descriptor); it != traits_.end()) {
+        return it->second;
+      }
+    }
+    MessageTypeTraits traits = ComputeMessageTypeTraits(descriptor);
+    absl::MutexLock lock(&mutex_);
+    traits_.insert({descriptor, traits});
+    return traits;
+  }
+
+ private:
+  absl::Mutex mutex_;
+  absl::flat_hash_map<const Descriptor*, MessageTypeTraits> traits_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+MessageTypeTraits GetMessageTypeTraits(
+    const Descriptor* absl_nonnull descriptor) {
+  if (descriptor->file()->pool() == DescriptorPool::generated_pool()) {
+    return MessageTypeTraitsCache::Get().Lookup(descriptor);
+  }
+  return ComputeMessageTypeTraits(descriptor);
+}
+
+// Output stream which compares what is written to it against `expected`,
+// holding at most one fixed size chunk at a time. Writing fails as soon as
+// the bytes differ, which stops serialization early.
+class ComparingOutputStream final
+    : public google::protobuf::io::ZeroCopyOutputStream {
+ public:
+  explicit ComparingOutputStream(absl::string_view expected)
+      : expected_(expected) {}
+
+  bool Next(void** data, int* size) override {
+    if (!Flush()) {
+      return false;
+    }
+    *data = buffer_;
+    *size = sizeof(buffer_);
+    pending_ = sizeof(buffer_);
+    return true;
+  }
+
+  void BackUp(int count) override { pending_ -= static_cast<size_t>(count); }
+
+  int64_t ByteCount() const override {
+    return static_cast<int64_t>(position_ + pending_);
+  }
+
+  // Returns true if exactly `expected` was written.
+  bool Matches() { return Flush() && position_ == expected_.size(); }
+
+ private:
+  bool Flush() {
+    if (matches_ && pending_ != 0) {
+      matches_ = pending_ <= expected_.size() - position_ &&
+                 std::memcmp(buffer_, expected_.data() + position_,
+                             pending_) == 0;
+      position_ += pending_;
+      pending_ = 0;
+    }
+    return matches_;
+  }
+
+  const absl::string_view expected_;
+  size_t position_ = 0;
+  size_t pending_ = 0;
+  bool matches_ = true;
+  char buffer_[1024];
+};
+
+// Equality between two messages of the same type, which is not a well known
+// type. Equivalent to `MessageDifferencer::Equals()`, but tries to decide
+// from the wire format first, which generated code produces without
+// reflection.
+bool SameTypeMessageEquals(const Message& lhs, const Message& rhs) {
+  ABSL_DCHECK_EQ(lhs.GetDescriptor(), rhs.GetDescriptor());
+  const MessageTypeTraits traits = GetMessageTypeTraits(lhs.GetDescriptor());
+  if (!traits.has_any && lhs.ByteSizeLong() != rhs.ByteSizeLong()) {
+    return false;
+  }
+  if (!traits.has_float_or_map) {
+    // Only `lhs` is materialized; `rhs` is compared against it as it is
+    // serialized.
+    std::string expected;
+    if (lhs.SerializePartialToString(&expected)) {
+      ComparingOutputStream output(expected);
+      if (rhs.SerializePartialToZeroCopyStream(&output) && output.Matches()) {
+        return true;
+      }
+    }
+  }
+  return MessageDifferencer::Equals(lhs, rhs);
+}
+
 struct MessageEqualer {
   bool operator()(EquatableMessage lhs, EquatableMessage rhs) const {
     return lhs.get().GetDescriptor() == rhs.get().GetDescriptor() &&
-           MessageDifferencer::Equals(lhs.get(), rhs.get());
+           SameTypeMessageEquals(lhs.get(), rhs.get());
   }
 
   template <typename T>
@@ -1430,6 +1606,14 @@ absl::StatusOr<bool> MessageEquals(const Message& lhs, const Message& rhs,
   if (&lhs == &rhs) {
     return true;
   }
+  // Messages of the same type, which is not a well known type, are equal as
+  // protocol buffers. This is by far the most common case and does not need
+  // any of the state below.
+  if (const auto* descriptor = lhs.GetDescriptor();
+      descriptor == rhs.GetDescriptor() &&
+      descriptor->well_known_type() == Descriptor::WELLKNOWNTYPE_UNSPECIFIED) {
+    return SameTypeMessageEquals(lhs, rhs);
+  }
   // MessageEqualsState has quite a large size, so we allocate it on the heap.
   // Ideally we should just hold most of the state at runtime in something like
   // `FlatExpressionEvaluatorState`, so we can avoid allocating this repeatedly.
@@ -40,6 +40,7 @@
 #include "internal/testing_descriptor_pool.h"
 #include "internal/testing_message_factory.h"
 #include "internal/well_known_types.h"
+#include "cel/expr/checked.pb.h"
 #include "cel/expr/conformance/proto3/test_all_types.pb.h"
 #include "google/protobuf/arena.h"
 #include "google/protobuf/descriptor.h"
@@ -982,6 +983,92 @@ TEST(MessageEquals, AnyFallback) {
               IsOkAndHolds(IsFalse()));
 }
 
+TEST(MessageEquals, SameType) {
+  const auto* pool = GetTestingDescriptorPool();
+  auto* factory = GetTestingMessageFactory();
+  google::protobuf::Arena arena;
+  auto message1 = DynamicParseTextProto<TestAllTypesProto3::NestedMessage>(
+      &arena, R"pb(bb: 1)pb", pool, factory);
+  auto message2 = DynamicParseTextProto<TestAllTypesProto3::NestedMessage>(
+      &arena, R"pb(bb: 1)pb", pool, factory);
+  auto message3 = DynamicParseTextProto<TestAllTypesProto3::NestedMessage>(
+      &arena, R"pb(bb: 2)pb", pool, factory);
+  auto message4 = DynamicParseTextProto<TestAllTypesProto3::NestedMessage>(
+      &arena, R"pb()pb", pool, factory);
+  EXPECT_THAT(MessageEquals(*message1, *message2, pool, factory),
+              IsOkAndHolds(IsTrue()));
+  EXPECT_THAT(MessageEquals(*message1, *message3, pool, factory),
+              IsOkAndHolds(IsFalse()));
+  EXPECT_THAT(MessageEquals(*message1, *message4, pool, factory),
+              IsOkAndHolds(IsFalse()));
+}
+
+TEST(MessageEquals, SameTypeWithNaN) {
+  const auto* pool = GetTestingDescriptorPool();
+  auto* factory = GetTestingMessageFactory();
+  google::protobuf::Arena arena;
+  // Identical encodings, but NaN is not equal to itself.
+  auto message1 = DynamicParseTextProto<TestAllTypesProto3>(
+      &arena, R"pb(single_double: nan)pb", pool, factory);
+  auto message2 = DynamicParseTextProto<TestAllTypesProto3>(
+      &arena, R"pb(single_double: nan)pb", pool, factory);
+  EXPECT_THAT(MessageEquals(*message1, *message2, pool, factory),
+              IsOkAndHolds(IsFalse()));
+}
+
+TEST(MessageEquals, SameTypeWithAny) {
+  const auto* pool = GetTestingDescriptorPool();
+  auto* factory = GetTestingMessageFactory();
+  google::protobuf::Arena arena;
+  // The same value packed twice, once with a field repeated on the wire, has
+  // encodings of different sizes.
+  auto message1 = DynamicParseTextProto<TestAllTypesProto3>(
+      &arena,
+      R"pb(single_any: {
+             [type.googleapis.com/cel.expr.conformance.proto3.TestAllTypes] {
+               single_int64: 1
+             }
+           })pb",
+      pool, factory);
+  auto message2 = DynamicParseTextProto<TestAllTypesProto3>(
+      &arena,
+      R"pb(single_any: {
+             type_url: "type.googleapis.com/cel.expr.conformance.proto3.TestAllTypes"
+             value: "\x10\x01\x10\x01"
+           })pb",
+      pool, factory);
+  EXPECT_THAT(MessageEquals(*message1, *message2, pool, factory),
+              IsOkAndHolds(IsTrue()));
+}
+
+TEST(MessageEquals, SameTypeLongEncoding) {
+  // Generated type without floating point, map or `Any` fields, whose
+  // encoding spans many chunks of the streaming byte comparison.
+  google::protobuf::Arena arena;
+  auto make_type = [&](absl::string_view last_parameter) {
+    auto* type = google::protobuf::Arena::Create<cel::expr::Type>(&arena);
+    auto* abstract_type = type->mutable_abstract_type();
+    abstract_type->set_name("tuple");
+    for (int i = 0; i < 500; ++i) {
+      abstract_type->add_parameter_types()->set_message_type(
+          absl::StrCat("type", i));
+    }
+    abstract_type->add_parameter_types()->set_message_type(last_parameter);
+    return type;
+  };
+  const auto* pool = google::protobuf::DescriptorPool::generated_pool();
+  auto* factory = google::protobuf::MessageFactory::generated_factory();
+  EXPECT_THAT(
+      MessageEquals(*make_type("last"), *make_type("last"), pool, factory),
+      IsOkAndHolds(IsTrue()));
+  EXPECT_THAT(
+      MessageEquals(*make_type("last"), *make_type("lost"), pool, factory),
+      IsOkAndHolds(IsFalse()));
+  EXPECT_THAT(
+      MessageEquals(*make_type("last"), *make_type("lasts"), pool, factory),
+      IsOkAndHolds(IsFalse()));
+}
+
 TEST(MessageFieldEquals, AnyFallback) {
   const auto* pool = GetTestingDescriptorPool();
   auto* factory = GetTestingMessageFactory();
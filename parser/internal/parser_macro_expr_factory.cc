@@ -0,0 +1,320 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "parser/internal/parser_macro_expr_factory.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/functional/overload.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "absl/types/span.h"
+#include "absl/types/variant.h"
+#include "common/ast.h"
+#include "common/constant.h"
+#include "common/expr.h"
+#include "common/source.h"
+#include "parser/macro_registry.h"
+#include "parser/source_factory.h"
+
+namespace cel {
+
+namespace {
+
+int32_t PositiveOrMax(int32_t value) {
+  return value >= 0 ? value : std::numeric_limits<int32_t>::max();
+}
+
+}  // namespace
+
+std::string DisplayParserError(const cel::Source& source,
+                               const ParserError& error) {
+  auto location =
+      source.GetLocation(error.range.begin).value_or(SourceLocation{});
+  return absl::StrCat(absl::StrFormat("ERROR: %s:%zu:%zu: %s",
+                                      source.description(), location.line,
+                                      // add one to the 0-based column
+                                      location.column + 1, error.message),
+                      source.DisplayErrorLocation(location));
+}
+
+std::string ParserMacroExprFactory::ErrorMessage() {
+  // Errors are collected as they are encountered, not by their location
+  // within the source. To have a more stable error message as implementation
+  // details change, we sort the collected errors by their source location
+  // first.
+  std::stable_sort(errors_.begin(), errors_.end(),
+                   [](const ParserError& lhs, const ParserError& rhs) -> bool {
+                     auto lhs_begin = PositiveOrMax(lhs.range.begin);
+                     auto lhs_end = PositiveOrMax(lhs.range.end);
+                     auto rhs_begin = PositiveOrMax(rhs.range.begin);
+                     auto rhs_end = PositiveOrMax(rhs.range.end);
+                     return lhs_begin < rhs_begin ||
+                            (lhs_begin == rhs_begin && lhs_end < rhs_end);
+                   });
+  // Build the summary error message using the sorted errors.
+  bool errors_truncated = error_count_ > 100;
+  std::vector<std::string> messages;
+  messages.reserve(
+      errors_.size() +
+      errors_truncated);  // Reserve space for the transform and an
+                          // additional element when truncation occurs.
+  std::transform(errors_.begin(), errors_.end(), std::back_inserter(messages),
+                 [this](const ParserError& error) {
+                   return cel::DisplayParserError(source_, error);
+                 });
+  if (errors_truncated) {
+    messages.emplace_back(
+        absl::StrCat(error_count_ - 100, " more errors were truncated."));
+  }
+  return absl::StrJoin(messages, "\n");
+}
+
+Expr ParserMacroExprFactory::BuildMacroCallArg(const Expr& expr) {
+  if (auto it = macro_calls_.find(expr.id()); it != macro_calls_.end()) {
+    return NewUnspecified(expr.id());
+  }
+  return absl::visit(
+      absl::Overload(
+          [this, &expr](const UnspecifiedExpr&) -> Expr {
+            return NewUnspecified(expr.id());
+          },
+          [this, &expr](const Constant& const_expr) -> Expr {
+            return NewConst(expr.id(), const_expr);
+          },
+          [this, &expr](const IdentExpr& ident_expr) -> Expr {
+            return NewIdent(expr.id(), ident_expr.name());
+          },
+          [this, &expr](const SelectExpr& select_expr) -> Expr {
+            return select_expr.test_only()
+                       ? NewPresenceTest(
+                             expr.id(),
+                             BuildMacroCallArg(select_expr.operand()),
+                             select_expr.field())
+                       : NewSelect(expr.id(),
+                                   BuildMacroCallArg(select_expr.operand()),
+                                   select_expr.field());
+          },
+          [this, &expr](const CallExpr& call_expr) -> Expr {
+            std::vector<Expr> macro_arguments;
+            macro_arguments.reserve(call_expr.args().size());
+            for (const auto& argument : call_expr.args()) {
+              macro_arguments.push_back(BuildMacroCallArg(argument));
+            }
+            absl::optional<Expr> macro_target;
+            if (call_expr.has_target()) {
+              macro_target = BuildMacroCallArg(call_expr.target());
+            }
+            return macro_target.has_value()
+                       ? NewMemberCall(expr.id(), call_expr.function(),
+                                       std::move(*macro_target),
+                                       std::move(macro_arguments))
+                       : NewCall(expr.id(), call_expr.function(),
+                                 std::move(macro_arguments));
+          },
+          [this, &expr](const ListExpr& list_expr) -> Expr {
+            std::vector<ListExprElement> macro_elements;
+            macro_elements.reserve(list_expr.elements().size());
+            for (const auto& element : list_expr.elements()) {
+              auto& cloned_element = macro_elements.emplace_back();
+              if (element.has_expr()) {
+                cloned_element.set_expr(BuildMacroCallArg(element.expr()));
+              }
+              cloned_element.set_optional(element.optional());
+            }
+            return NewList(expr.id(), std::move(macro_elements));
+          },
+          [this, &expr](const StructExpr& struct_expr) -> Expr {
+            std::vector<StructExprField> macro_fields;
+            macro_fields.reserve(struct_expr.fields().size());
+            for (const auto& field : struct_expr.fields()) {
+              auto& macro_field = macro_fields.emplace_back();
+              macro_field.set_id(field.id());
+              macro_field.set_name(field.name());
+              macro_field.set_value(BuildMacroCallArg(field.value()));
+              macro_field.set_optional(field.optional());
+            }
+            return NewStruct(expr.id(), struct_expr.name(),
+                             std::move(macro_fields));
+          },
+          [this, &expr](const MapExpr& map_expr) -> Expr {
+            std::vector<MapExprEntry> macro_entries;
+            macro_entries.reserve(map_expr.entries().size());
+            for (const auto& entry : map_expr.entries()) {
+              auto& macro_entry = macro_entries.emplace_back();
+              macro_entry.set_id(entry.id());
+              macro_entry.set_key(BuildMacroCallArg(entry.key()));
+              macro_entry.set_value(BuildMacroCallArg(entry.value()));
+              macro_entry.set_optional(entry.optional());
+            }
+            return NewMap(expr.id(), std::move(macro_entries));
+          },
+          [this, &expr](const ComprehensionExpr& comprehension_expr) -> Expr {
+            return NewComprehension(
+                expr.id(), comprehension_expr.iter_var(),
+                BuildMacroCallArg(comprehension_expr.iter_range()),
+                comprehension_expr.accu_var(),
+                BuildMacroCallArg(comprehension_expr.accu_init()),
+                BuildMacroCallArg(comprehension_expr.loop_condition()),
+                BuildMacroCallArg(comprehension_expr.loop_step()),
+                BuildMacroCallArg(comprehension_expr.result()));
+          }),
+      expr.kind());
+}
+
+cel::SourceInfo ParserMacroExprFactory::ReleaseSourceInfo() {
+  cel::SourceInfo source_info;
+  source_info.set_location(std::string(source_.description()));
+  source_info.mutable_positions().reserve(positions_.size());
+  for (const auto& positions : positions_) {
+    source_info.mutable_positions().insert(
+        std::pair{positions.first, positions.second.begin});
+  }
+  source_info.mutable_line_offsets().reserve(source_.line_offsets().size());
+  for (const auto& line_offset : source_.line_offsets()) {
+    source_info.mutable_line_offsets().push_back(line_offset);
+  }
+
+  source_info.mutable_macro_calls() = release_macro_calls();
+  return source_info;
+}
+
+google::api::expr::parser::EnrichedSourceInfo
+ParserMacroExprFactory::enriched_source_info() const {
+  std::map<int64_t, std::pair<int32_t, int32_t>> offsets;
+  for (const auto& positions : positions_) {
+    offsets.insert(
+        std::pair{positions.first,
+                  std::pair{positions.second.begin, positions.second.end - 1}});
+  }
+  return google::api::expr::parser::EnrichedSourceInfo(std::move(offsets));
+}
+
+}  // namespace cel
+
+namespace cel_parser_internal {
+
+using ::cel::Expr;
+
+ExpressionBalancer::ExpressionBalancer(cel::ParserMacroExprFactory& factory,
+                                       std::string function, Expr expr)
+    : factory_(factory), function_(std::move(function)) {
+  terms_.push_back(std::move(expr));
+}
+
+void ExpressionBalancer::AddTerm(int64_t op, Expr term) {
+  terms_.push_back(std::move(term));
+  ops_.push_back(op);
+}
+
+Expr ExpressionBalancer::Balance() {
+  if (terms_.size() == 1) {
+    return std::move(terms_[0]);
+  }
+  return BalancedTree(0, ops_.size() - 1);
+}
+
+Expr ExpressionBalancer::BalancedTree(int lo, int hi) {
+  int mid = (lo + hi + 1) / 2;
+
+  std::vector<Expr> arguments;
+  arguments.reserve(2);
+
+  if (mid == lo) {
+    arguments.push_back(std::move(terms_[mid]));
+  } else {
+    arguments.push_back(BalancedTree(lo, mid - 1));
+  }
+
+  if (mid == hi) {
+    arguments.push_back(std::move(terms_[mid + 1]));
+  } else {
+    arguments.push_back(BalancedTree(mid + 1, hi));
+  }
+  return factory_.NewCall(ops_[mid], function_, std::move(arguments));
+}
+
+Expr GlobalCallOrMacro(cel::ParserMacroExprFactory& factory,
+                       const cel::MacroRegistry& registry,
+                       bool add_macro_calls, int64_t expr_id,
+                       absl::string_view function, std::vector<Expr> args) {
+  if (auto macro = registry.FindMacro(function, args.size(), false); macro) {
+    std::vector<Expr> macro_args;
+    if (add_macro_calls) {
+      macro_args.reserve(args.size());
+      for (const auto& arg : args) {
+        macro_args.push_back(factory.BuildMacroCallArg(arg));
+      }
+    }
+    factory.BeginMacro(factory.GetSourceRange(expr_id));
+    auto expr = macro->Expand(factory, absl::nullopt, absl::MakeSpan(args));
+    factory.EndMacro();
+    if (expr) {
+      if (add_macro_calls) {
+        factory.AddMacroCall(expr->id(), function, absl::nullopt,
+                             std::move(macro_args));
+      }
+      // We did not end up using `expr_id`. Delete metadata.
+      factory.EraseId(expr_id);
+      return std::move(*expr);
+    }
+  }
+
+  return factory.NewCall(expr_id, function, std::move(args));
+}
+
+Expr ReceiverCallOrMacro(cel::ParserMacroExprFactory& factory,
+                         const cel::MacroRegistry& registry,
+                         bool add_macro_calls, int64_t expr_id,
+                         absl::string_view function, Expr target,
+                         std::vector<Expr> args) {
+  if (auto macro = registry.FindMacro(function, args.size(), true); macro) {
+    Expr macro_target;
+    std::vector<Expr> macro_args;
+    if (add_macro_calls) {
+      macro_args.reserve(args.size());
+      macro_target = factory.BuildMacroCallArg(target);
+      for (const auto& arg : args) {
+        macro_args.push_back(factory.BuildMacroCallArg(arg));
+      }
+    }
+    factory.BeginMacro(factory.GetSourceRange(expr_id));
+    auto expr = macro->Expand(factory, std::ref(target), absl::MakeSpan(args));
+    factory.EndMacro();
+    if (expr) {
+      if (add_macro_calls) {
+        factory.AddMacroCall(expr->id(), function, std::move(macro_target),
+                             std::move(macro_args));
+      }
+      // We did not end up using `expr_id`. Delete metadata.
+      factory.EraseId(expr_id);
+      return std::move(*expr);
+    }
+  }
+  return factory.NewMemberCall(expr_id, function, std::move(target),
+                               std::move(args));
+}
+
+}  // namespace cel_parser_internal
@@ -0,0 +1,1522 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "parser/internal/recursive_descent_parser.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/string_view.h"
+#include "common/expr.h"
+#include "common/operators.h"
+#include "common/source.h"
+#include "internal/lexis.h"
+#include "internal/strings.h"
+#include "parser/internal/parser_macro_expr_factory.h"
+#include "parser/macro_registry.h"
+#include "parser/options.h"
+
+namespace cel_parser_internal {
+
+namespace {
+
+using ::cel::Expr;
+using ::cel::ListExprElement;
+using ::cel::MapExprEntry;
+using ::cel::SourceRange;
+using ::cel::StructExprField;
+using ::google::api::expr::common::CelOperator;
+
+// Token types of Cel.g4, in the order ANTLR numbers them. ANTLR lists expected
+// tokens in this order in its error messages.
+enum class TokenType : int {
+  kEof = 0,
+  kEquals,
+  kNotEquals,
+  kIn,
+  kLess,
+  kLessEquals,
+  kGreaterEquals,
+  kGreater,
+  kLogicalAnd,
+  kLogicalOr,
+  kLBracket,
+  kRBracket,
+  kLBrace,
+  kRBrace,
+  kLParen,
+  kRParen,
+  kDot,
+  kComma,
+  kMinus,
+  kExclam,
+  kQuestionMark,
+  kColon,
+  kPlus,
+  kStar,
+  kSlash,
+  kPercent,
+  kTrue,
+  kFalse,
+  kNull,
+  kNumFloat,
+  kNumInt,
+  kNumUint,
+  kString,
+  kBytes,
+  kIdentifier,
+  kEscIdentifier,
+};
+
+// The names ANTLR uses for each token type in its error messages.
+constexpr absl::string_view kTokenDisplayNames[] = {
+    "<EOF>",     "'=='",       "'!='",      "'in'",      "'<'",
+    "'<='",      "'>='",       "'>'",       "'&&'",      "'||'",
+    "'['",       "']'",        "'{'",       "'}'",       "'('",
+    "')'",       "'.'",        "','",       "'-'",       "'!'",
+    "'\\u003F'", "':'",        "'+'",       "'*'",       "'/'",
+    "'%'",       "'true'",     "'false'",   "'null'",    "NUM_FLOAT",
+    "NUM_INT",   "NUM_UINT",   "STRING",    "BYTES",     "IDENTIFIER",
+    "ESC_IDENTIFIER",
+};
+
+class TokenSet final {
+ public:
+  constexpr TokenSet(std::initializer_list<TokenType> types) {
+    for (TokenType type : types) {
+      bits_ |= Bit(type);
+    }
+  }
+
+  bool Contains(TokenType type) const { return (bits_ & Bit(type)) != 0; }
+
+  TokenSet Union(TokenSet other) const {
+    TokenSet result = *this;
+    result.bits_ |= other.bits_;
+    return result;
+  }
+
+  // Formats the set as ANTLR does in "expecting ..." messages.
+  std::string ToString() const {
+    std::vector<absl::string_view> names;
+    for (size_t i = 0; i < std::size(kTokenDisplayNames); ++i) {
+      if (Contains(static_cast<TokenType>(i))) {
+        names.push_back(kTokenDisplayNames[i]);
+      }
+    }
+    if (names.size() == 1) {
+      return std::string(names[0]);
+    }
+    return absl::StrCat("{", absl::StrJoin(names, ", "), "}");
+  }
+
+ private:
+  static constexpr uint64_t Bit(TokenType type) {
+    return uint64_t{1} << static_cast<int>(type);
+  }
+
+  uint64_t bits_ = 0;
+};
+
+// The tokens which may start a `unary` production.
+constexpr TokenSet kUnaryStart = {
+    TokenType::kLBracket, TokenType::kLBrace,   TokenType::kLParen,
+    TokenType::kDot,      TokenType::kMinus,    TokenType::kExclam,
+    TokenType::kTrue,     TokenType::kFalse,    TokenType::kNull,
+    TokenType::kNumFloat, TokenType::kNumInt,   TokenType::kNumUint,
+    TokenType::kString,   TokenType::kBytes,    TokenType::kIdentifier,
+};
+
+struct Token {
+  TokenType type;
+  // Code point offsets of the token within the source, `end` exclusive.
+  int32_t begin;
+  int32_t end;
+};
+
+SourceRange TokenRange(const Token& token) {
+  return SourceRange{token.begin, token.end};
+}
+
+bool IsDigit(int32_t c) { return c >= '0' && c <= '9'; }
+
+bool IsHexDigit(int32_t c) {
+  return IsDigit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+bool IsLetter(int32_t c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+bool IsIdentifierPart(int32_t c) {
+  return IsLetter(c) || IsDigit(c) || c == '_';
+}
+
+bool IsEscapedIdentifierPart(int32_t c) {
+  return IsIdentifierPart(c) || c == '.' || c == '-' || c == '/' || c == ' ';
+}
+
+bool IsWhitespace(int32_t c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f';
+}
+
+// Quotes text for an error message, escaping whitespace as ANTLR does.
+std::string Quote(absl::string_view text) {
+  std::string result = "'";
+  for (char c : text) {
+    switch (c) {
+      case '\n':
+        result.append("\\n");
+        break;
+      case '\t':
+        result.append("\\t");
+        break;
+      case '\r':
+        result.append("\\r");
+        break;
+      default:
+        result.push_back(c);
+        break;
+    }
+  }
+  result.push_back('\'');
+  return result;
+}
+
+// Splits the source into the tokens of Cel.g4, skipping whitespace and
+// comments. Characters that cannot start a token are reported to the factory
+// as ANTLR's lexer would report them, and are skipped.
+class Lexer final {
+ public:
+  Lexer(cel::SourceContentView content, cel::ParserMacroExprFactory& factory)
+      : content_(content), size_(content.size()), factory_(factory) {}
+
+  Token Next();
+
+  std::string Text(const Token& token) const {
+    return content_.ToString(token.begin, token.end);
+  }
+
+  // Returns the source text between `begin` and `end`, less any characters
+  // skipped after lexing errors. This is the text ANTLR's token stream would
+  // return for the tokens in that range.
+  std::string TextBetween(int32_t begin, int32_t end) const;
+
+  // The number of lexing errors reported.
+  int errors() const { return static_cast<int>(skipped_.size()); }
+
+ private:
+  // Returned by `At()` past the end of the source.
+  static constexpr int32_t kEndOfInput = -1;
+
+  // A candidate token end, or the position of the character at which the
+  // candidate failed to match.
+  struct Match {
+    bool ok;
+    int32_t position;
+  };
+
+  int32_t At(int32_t position) const {
+    return position < size_ ? static_cast<int32_t>(content_.at(position))
+                            : kEndOfInput;
+  }
+
+  Match MatchNumber(int32_t begin, TokenType& type) const;
+  int32_t MatchExponent(int32_t position) const;
+  Match MatchEscapeSequence(int32_t position) const;
+  Match MatchQuoted(int32_t begin, bool raw) const;
+  Match MatchEscapedIdentifier(int32_t begin) const;
+  TokenType MatchIdentifier(int32_t begin, int32_t& end) const;
+
+  void ReportError(int32_t begin, int32_t failed_at);
+
+  const cel::SourceContentView content_;
+  const int32_t size_;
+  cel::ParserMacroExprFactory& factory_;
+  int32_t position_ = 0;
+  // Ranges skipped after lexing errors.
+  std::vector<std::pair<int32_t, int32_t>> skipped_;
+};
+
+Token Lexer::Next() {
+  for (;;) {
+    // Skip whitespace and comments.
+    for (;;) {
+      int32_t c = At(position_);
+      if (IsWhitespace(c)) {
+        ++position_;
+      } else if (c == '/' && At(position_ + 1) == '/') {
+        position_ += 2;
+        while (position_ < size_ && At(position_) != '\n') {
+          ++position_;
+        }
+      } else {
+        break;
+      }
+    }
+    const int32_t begin = position_;
+    if (begin >= size_) {
+      return Token{TokenType::kEof, size_, size_};
+    }
+    auto token = [&](TokenType type, int32_t end) {
+      position_ = end;
+      return Token{type, begin, end};
+    };
+    const int32_t c = At(begin);
+    const int32_t next = At(begin + 1);
+    switch (c) {
+      case '=':
+        if (next == '=') {
+          return token(TokenType::kEquals, begin + 2);
+        }
+        ReportError(begin, begin + 1);
+        continue;
+      case '!':
+        if (next == '=') {
+          return token(TokenType::kNotEquals, begin + 2);
+        }
+        return token(TokenType::kExclam, begin + 1);
+      case '<':
+        if (next == '=') {
+          return token(TokenType::kLessEquals, begin + 2);
+        }
+        return token(TokenType::kLess, begin + 1);
+      case '>':
+        if (next == '=') {
+          return token(TokenType::kGreaterEquals, begin + 2);
+        }
+        return token(TokenType::kGreater, begin + 1);
+      case '&':
+        if (next == '&') {
+          return token(TokenType::kLogicalAnd, begin + 2);
+        }
+        ReportError(begin, begin + 1);
+        continue;
+      case '|':
+        if (next == '|') {
+          return token(TokenType::kLogicalOr, begin + 2);
+        }
+        ReportError(begin, begin + 1);
+        continue;
+      case '[':
+        return token(TokenType::kLBracket, begin + 1);
+      case ']':
+        return token(TokenType::kRBracket, begin + 1);
+      case '{':
+        return token(TokenType::kLBrace, begin + 1);
+      case '}':
+        return token(TokenType::kRBrace, begin + 1);
+      case '(':
+        return token(TokenType::kLParen, begin + 1);
+      case ')':
+        return token(TokenType::kRParen, begin + 1);
+      case ',':
+        return token(TokenType::kComma, begin + 1);
+      case '-':
+        return token(TokenType::kMinus, begin + 1);
+      case '?':
+        return token(TokenType::kQuestionMark, begin + 1);
+      case ':':
+        return token(TokenType::kColon, begin + 1);
+      case '+':
+        return token(TokenType::kPlus, begin + 1);
+      case '*':
+        return token(TokenType::kStar, begin + 1);
+      case '/':
+        return token(TokenType::kSlash, begin + 1);
+      case '%':
+        return token(TokenType::kPercent, begin + 1);
+      case '.':
+        if (!IsDigit(next)) {
+          return token(TokenType::kDot, begin + 1);
+        }
+        break;
+      case '"':
+      case '\'': {
+        Match match = MatchQuoted(begin, /*raw=*/false);
+        if (match.ok) {
+          return token(TokenType::kString, match.position);
+        }
+        ReportError(begin, match.position);
+        continue;
+      }
+      case '`': {
+        Match match = MatchEscapedIdentifier(begin);
+        if (match.ok) {
+          return token(TokenType::kEscIdentifier, match.position);
+        }
+        ReportError(begin, match.position);
+        continue;
+      }
+      default:
+        break;
+    }
+    if (IsDigit(c) || c == '.') {
+      TokenType type;
+      Match match = MatchNumber(begin, type);
+      return token(type, match.position);
+    }
+    if (IsLetter(c) || c == '_') {
+      // String and bytes literals with a prefix. If the literal is malformed,
+      // the prefix is lexed as an identifier instead.
+      Match match{false, 0};
+      TokenType type = TokenType::kString;
+      if ((c == 'r' || c == 'R') && (next == '"' || next == '\'')) {
+        match = MatchQuoted(begin + 1, /*raw=*/true);
+      } else if (c == 'b' || c == 'B') {
+        type = TokenType::kBytes;
+        if (next == '"' || next == '\'') {
+          match = MatchQuoted(begin + 1, /*raw=*/false);
+        } else if ((next == 'r' || next == 'R') &&
+                   (At(begin + 2) == '"' || At(begin + 2) == '\'')) {
+          match = MatchQuoted(begin + 2, /*raw=*/true);
+        }
+      }
+      if (match.ok) {
+        return token(type, match.position);
+      }
+      int32_t end;
+      type = MatchIdentifier(begin, end);
+      return token(type, end);
+    }
+    ReportError(begin, begin);
+  }
+}
+
+Lexer::Match Lexer::MatchNumber(int32_t begin, TokenType& type) const {
+  int32_t position = begin;
+  if (At(position) == '0' && At(position + 1) == 'x' &&
+      IsHexDigit(At(position + 2))) {
+    position += 2;
+    while (IsHexDigit(At(position))) {
+      ++position;
+    }
+  } else {
+    while (IsDigit(At(position))) {
+      ++position;
+    }
+    if (At(position) == '.' && IsDigit(At(position + 1))) {
+      ++position;
+      while (IsDigit(At(position))) {
+        ++position;
+      }
+      type = TokenType::kNumFloat;
+      return Match{true, MatchExponent(position)};
+    }
+    if (int32_t end = MatchExponent(position); end != position) {
+      type = TokenType::kNumFloat;
+      return Match{true, end};
+    }
+  }
+  if (At(position) == 'u' || At(position) == 'U') {
+    type = TokenType::kNumUint;
+    return Match{true, position + 1};
+  }
+  type = TokenType::kNumInt;
+  return Match{true, position};
+}
+
+int32_t Lexer::MatchExponent(int32_t position) const {
+  if (At(position) != 'e' && At(position) != 'E') {
+    return position;
+  }
+  int32_t end = position + 1;
+  if (At(end) == '+' || At(end) == '-') {
+    ++end;
+  }
+  if (!IsDigit(At(end))) {
+    return position;
+  }
+  while (IsDigit(At(end))) {
+    ++end;
+  }
+  return end;
+}
+
+Lexer::Match Lexer::MatchEscapeSequence(int32_t position) const {
+  // `position` is that of the backslash.
+  int32_t c = At(position + 1);
+  int32_t digits = 0;
+  bool (*is_digit)(int32_t) = IsHexDigit;
+  switch (c) {
+    case 'a':
+    case 'b':
+    case 'f':
+    case 'n':
+    case 'r':
+    case 't':
+    case 'v':
+    case '"':
+    case '\'':
+    case '\\':
+    case '?':
+    case '`':
+      return Match{true, position + 2};
+    case '0':
+    case '1':
+    case '2':
+    case '3':
+      digits = 2;
+      is_digit = [](int32_t c) { return c >= '0' && c <= '7'; };
+      break;
+    case 'x':
+    case 'X':
+      digits = 2;
+      break;
+    case 'u':
+      digits = 4;
+      break;
+    case 'U':
+      digits = 8;
+      break;
+    default:
+      return Match{false, position + 1};
+  }
+  ++position;
+  for (int32_t i = 0; i < digits; ++i) {
+    if (!is_digit(At(++position))) {
+      return Match{false, position};
+    }
+  }
+  return Match{true, position + 1};
+}
+
+Lexer::Match Lexer::MatchQuoted(int32_t begin, bool raw) const {
+  const int32_t quote = At(begin);
+  if (At(begin + 1) == quote && At(begin + 2) == quote) {
+    // Triple quoted, which ends at the first unescaped triple quote.
+    int32_t position = begin + 3;
+    for (;;) {
+      int32_t c = At(position);
+      if (c == kEndOfInput) {
+        // Not a triple quoted literal after all, but an empty one.
+        return Match{true, begin + 2};
+      }
+      if (c == quote && At(position + 1) == quote &&
+          At(position + 2) == quote) {
+        return Match{true, position + 3};
+      }
+      if (c == '\\' && !raw) {
+        Match match = MatchEscapeSequence(position);
+        if (!match.ok) {
+          return Match{true, begin + 2};
+        }
+        position = match.position;
+      } else {
+        ++position;
+      }
+    }
+  }
+  int32_t position = begin + 1;
+  for (;;) {
+    int32_t c = At(position);
+    if (c == quote) {
+      return Match{true, position + 1};
+    }
+    if (c == kEndOfInput || c == '\n' || c == '\r') {
+      return Match{false, position};
+    }
+    if (c == '\\' && !raw) {
+      Match match = MatchEscapeSequence(position);
+      if (!match.ok) {
+        return match;
+      }
+      position = match.position;
+    } else {
+      ++position;
+    }
+  }
+}
+
+Lexer::Match Lexer::MatchEscapedIdentifier(int32_t begin) const {
+  int32_t position = begin + 1;
+  if (!IsEscapedIdentifierPart(At(position))) {
+    return Match{false, position};
+  }
+  while (IsEscapedIdentifierPart(At(position))) {
+    ++position;
+  }
+  if (At(position) != '`') {
+    return Match{false, position};
+  }
+  return Match{true, position + 1};
+}
+
+TokenType Lexer::MatchIdentifier(int32_t begin, int32_t& end) const {
+  end = begin + 1;
+  while (IsIdentifierPart(At(end))) {
+    ++end;
+  }
+  switch (end - begin) {
+    case 2:
+      if (At(begin) == 'i' && At(begin + 1) == 'n') {
+        return TokenType::kIn;
+      }
+      break;
+    case 4:
+    case 5: {
+      std::string text = content_.ToString(begin, end);
+      if (text == "true") {
+        return TokenType::kTrue;
+      }
+      if (text == "null") {
+        return TokenType::kNull;
+      }
+      if (text == "false") {
+        return TokenType::kFalse;
+      }
+      break;
+    }
+    default:
+      break;
+  }
+  return TokenType::kIdentifier;
+}
+
+void Lexer::ReportError(int32_t begin, int32_t failed_at) {
+  // ANTLR reports the text from the start of the token through the character
+  // which failed to match, and resumes after it.
+  int32_t end = std::min(failed_at + 1, size_);
+  factory_.ReportError(
+      SourceRange{begin, -1},
+      absl::StrCat("Syntax error: token recognition error at: ",
+                   Quote(content_.ToString(begin, end))));
+  skipped_.push_back({begin, end});
+  position_ = end;
+}
+
+std::string Lexer::TextBetween(int32_t begin, int32_t end) const {
+  std::string text;
+  for (const auto& skipped : skipped_) {
+    if (skipped.second <= begin || skipped.first >= end) {
+      continue;
+    }
+    if (begin < skipped.first) {
+      absl::StrAppend(&text, content_.ToString(begin, skipped.first));
+    }
+    begin = skipped.second;
+  }
+  if (begin < end) {
+    absl::StrAppend(&text, content_.ToString(begin, end));
+  }
+  return text;
+}
+
+// A parsed subexpression.
+struct Term {
+  Expr expr;
+  // How deep the ANTLR based parser recurses when visiting the subexpression,
+  // which is limited by `ParserOptions::max_recursion_depth`.
+  int depth = 1;
+  // Whether this is a conditional expression not enclosed in parentheses.
+  // The ANTLR based parser visits those one level shallower when they are
+  // call arguments or list elements.
+  bool conditional = false;
+};
+
+class Parser final {
+ public:
+  Parser(const cel::Source& source, const cel::MacroRegistry& registry,
+         const cel::ParserOptions& options,
+         cel::ParserMacroExprFactory& factory)
+      : lexer_(source.content(), factory),
+        registry_(registry),
+        options_(options),
+        factory_(factory),
+        end_of_input_{TokenType::kEof, source.content().size(),
+                      source.content().size()} {}
+
+  absl::StatusOr<Expr> Parse();
+
+ private:
+  // Parsing stops at the first syntax error that cannot be recovered from.
+  enum class State {
+    kParsing,
+    // Stopped at a syntax error. The rest of the input is still lexed, to
+    // report lexing errors as the ANTLR based parser would.
+    kSyntaxError,
+    // Stopped at the error recovery limit.
+    kRecoveryLimit,
+    // Stopped at the expression nesting limit.
+    kCancelled,
+  };
+
+  const Token& Peek(size_t lookahead = 0) {
+    if (state_ != State::kParsing) {
+      return end_of_input_;
+    }
+    while (tokens_.size() <= next_ + lookahead) {
+      tokens_.push_back(lexer_.Next());
+    }
+    return tokens_[next_ + lookahead];
+  }
+
+  Token Consume() {
+    Token token = Peek();
+    if (token.type != TokenType::kEof) {
+      ++next_;
+      previous_end_ = token.end;
+    }
+    return token;
+  }
+
+  bool Check(TokenType type) { return Peek().type == type; }
+
+  // Consumes the next token, which is expected to be of the given type. As
+  // ANTLR does, drops a single extraneous token to find it.
+  bool Expect(TokenType type, Token* token = nullptr);
+
+  // Checks that the next token is in `expected` before choosing between
+  // alternatives. As ANTLR does, drops a single extraneous token to find one.
+  bool Sync(TokenSet expected);
+
+  void ReportSyntaxError(const Token& token, absl::string_view message);
+  void ReportMismatchedInput(const Token& token, TokenSet expected);
+  void ReportNoViableAlternative(const Token& start, const Token& token);
+  bool CheckRecoveryLimit();
+
+  Term ErrorTerm() { return Term{factory_.NewUnspecified(0)}; }
+
+  Term ParseExpr();
+  Term ParseConditionalOr();
+  Term ParseConditionalAnd();
+  Term ParseRelation();
+  Term ParseCalc(int min_precedence);
+  Term ParseUnary();
+  Term ParseMember();
+  Term ParsePrimary();
+  Term ParseIdentOrGlobalCall(Token start, bool leading_dot);
+  Term ParseCreateMessage(Token start, bool leading_dot);
+  Term ParseCreateList();
+  Term ParseCreateMap();
+  Term ParseLiteral();
+  bool ParseArguments(std::vector<Expr>& args, int& depth);
+  std::string NormalizeIdentifier(const Token& token);
+
+  Expr GlobalCallOrMacro(int64_t expr_id, absl::string_view function,
+                         std::vector<Expr> args) {
+    return cel_parser_internal::GlobalCallOrMacro(
+        factory_, registry_, options_.add_macro_calls, expr_id, function,
+        std::move(args));
+  }
+
+  Expr GlobalCallOrMacro(int64_t expr_id, absl::string_view function,
+                         Expr arg) {
+    std::vector<Expr> args;
+    args.push_back(std::move(arg));
+    return GlobalCallOrMacro(expr_id, function, std::move(args));
+  }
+
+  Expr GlobalCallOrMacro(int64_t expr_id, absl::string_view function, Expr lhs,
+                         Expr rhs) {
+    std::vector<Expr> args;
+    args.reserve(2);
+    args.push_back(std::move(lhs));
+    args.push_back(std::move(rhs));
+    return GlobalCallOrMacro(expr_id, function, std::move(args));
+  }
+
+  // The depth a call argument or list element adds to its parent.
+  static int ElementDepth(const Term& term) {
+    return term.conditional ? term.depth - 1 : term.depth;
+  }
+
+  Lexer lexer_;
+  const cel::MacroRegistry& registry_;
+  const cel::ParserOptions& options_;
+  cel::ParserMacroExprFactory& factory_;
+  const Token end_of_input_;
+  std::vector<Token> tokens_;
+  size_t next_ = 0;
+  // The end of the last token consumed.
+  int32_t previous_end_ = 0;
+  State state_ = State::kParsing;
+  int expr_nesting_ = 0;
+  int syntax_errors_ = 0;
+  int recovery_attempts_ = 0;
+};
+
+absl::StatusOr<Expr> Parser::Parse() {
+  Term term = ParseExpr();
+  Expect(TokenType::kEof);
+  switch (state_) {
+    case State::kCancelled:
+      if (syntax_errors_ + lexer_.errors() != 0) {
+        return absl::InvalidArgumentError("syntax error");
+      }
+      return absl::CancelledError(
+          absl::StrFormat("Expression recursion limit exceeded. limit: %d",
+                          options_.max_recursion_depth));
+    case State::kSyntaxError:
+      while (lexer_.Next().type != TokenType::kEof) {
+      }
+      break;
+    case State::kParsing:
+      if (term.depth > options_.max_recursion_depth) {
+        factory_.ReportError(
+            absl::StrFormat("Exceeded max recursion depth of %d when parsing.",
+                            options_.max_recursion_depth));
+      }
+      break;
+    case State::kRecoveryLimit:
+      break;
+  }
+  return std::move(term.expr);
+}
+
+bool Parser::Expect(TokenType type, Token* token) {
+  if (Check(type)) {
+    Token consumed = Consume();
+    if (token != nullptr) {
+      *token = consumed;
+    }
+    return true;
+  }
+  if (state_ != State::kParsing) {
+    return false;
+  }
+  if (Peek(1).type == type) {
+    if (!CheckRecoveryLimit()) {
+      return false;
+    }
+    ReportSyntaxError(Peek(), absl::StrCat("extraneous input ",
+                                           Quote(lexer_.Text(Peek())),
+                                           " expecting ",
+                                           TokenSet{type}.ToString()));
+    Consume();
+    Token consumed = Consume();
+    if (token != nullptr) {
+      *token = consumed;
+    }
+    return true;
+  }
+  ReportMismatchedInput(Peek(), TokenSet{type});
+  return false;
+}
+
+bool Parser::Sync(TokenSet expected) {
+  if (expected.Contains(Peek().type)) {
+    return true;
+  }
+  if (state_ != State::kParsing) {
+    return false;
+  }
+  if (expected.Contains(Peek(1).type)) {
+    ReportSyntaxError(Peek(), absl::StrCat("extraneous input ",
+                                           Quote(lexer_.Text(Peek())),
+                                           " expecting ", expected.ToString()));
+    Consume();
+    return true;
+  }
+  ReportMismatchedInput(Peek(), expected);
+  return false;
+}
+
+void Parser::ReportSyntaxError(const Token& token, absl::string_view message) {
+  if (state_ != State::kParsing) {
+    return;
+  }
+  ++syntax_errors_;
+  factory_.ReportError(SourceRange{token.begin, -1},
+                       absl::StrCat("Syntax error: ", message));
+}
+
+void Parser::ReportMismatchedInput(const Token& token, TokenSet expected) {
+  std::string text =
+      token.type == TokenType::kEof ? "<EOF>" : lexer_.Text(token);
+  ReportSyntaxError(token, absl::StrCat("mismatched input ", Quote(text),
+                                        " expecting ", expected.ToString()));
+  if (state_ == State::kParsing) {
+    state_ = State::kSyntaxError;
+  }
+}
+
+void Parser::ReportNoViableAlternative(const Token& start, const Token& token) {
+  std::string text;
+  if (start.type == TokenType::kEof) {
+    text = "<EOF>";
+  } else {
+    // The text of the tokens from `start` through `token`, excluding the end
+    // of input.
+    text = lexer_.TextBetween(start.begin, token.end);
+  }
+  ReportSyntaxError(
+      token, absl::StrCat("no viable alternative at input ", Quote(text)));
+  if (state_ == State::kParsing) {
+    state_ = State::kSyntaxError;
+  }
+}
+
+bool Parser::CheckRecoveryLimit() {
+  if (recovery_attempts_++ >= options_.error_recovery_limit) {
+    ReportSyntaxError(Peek(), absl::StrFormat("More than %d parse errors.",
+                                              options_.error_recovery_limit));
+    state_ = State::kRecoveryLimit;
+    return false;
+  }
+  return true;
+}
+
+Term Parser::ParseExpr() {
+  if (state_ == State::kCancelled) {
+    return ErrorTerm();
+  }
+  if (expr_nesting_ > options_.max_recursion_depth) {
+    state_ = State::kCancelled;
+    return ErrorTerm();
+  }
+  ++expr_nesting_;
+  Term term = ParseConditionalOr();
+  if (Check(TokenType::kQuestionMark)) {
+    Token op = Consume();
+    int64_t op_id = factory_.NextId(TokenRange(op));
+    Term if_true = ParseConditionalOr();
+    Expect(TokenType::kColon);
+    Term if_false = ParseExpr();
+    std::vector<Expr> args;
+    args.reserve(3);
+    args.push_back(std::move(term.expr));
+    args.push_back(std::move(if_true.expr));
+    args.push_back(std::move(if_false.expr));
+    term = Term{
+        factory_.NewCall(op_id, CelOperator::CONDITIONAL, std::move(args)),
+        1 + std::max({term.depth, if_true.depth, if_false.depth}),
+        /*conditional=*/true};
+  }
+  --expr_nesting_;
+  return term;
+}
+
+Term Parser::ParseConditionalOr() {
+  Term term = ParseConditionalAnd();
+  if (!Check(TokenType::kLogicalOr)) {
+    return term;
+  }
+  int depth = term.depth;
+  ExpressionBalancer balancer(factory_, CelOperator::LOGICAL_OR,
+                              std::move(term.expr));
+  while (Check(TokenType::kLogicalOr)) {
+    Token op = Consume();
+    Term next = ParseConditionalAnd();
+    balancer.AddTerm(factory_.NextId(TokenRange(op)), std::move(next.expr));
+    depth = std::max(depth, next.depth);
+  }
+  return Term{balancer.Balance(), depth + 1};
+}
+
+Term Parser::ParseConditionalAnd() {
+  Term term = ParseRelation();
+  if (!Check(TokenType::kLogicalAnd)) {
+    return term;
+  }
+  int depth = term.depth;
+  ExpressionBalancer balancer(factory_, CelOperator::LOGICAL_AND,
+                              std::move(term.expr));
+  while (Check(TokenType::kLogicalAnd)) {
+    Token op = Consume();
+    Term next = ParseRelation();
+    balancer.AddTerm(factory_.NextId(TokenRange(op)), std::move(next.expr));
+    depth = std::max(depth, next.depth);
+  }
+  return Term{balancer.Balance(), depth + 1};
+}
+
+Term Parser::ParseRelation() {
+  Term lhs = ParseCalc(1);
+  for (;;) {
+    absl::string_view function;
+    switch (Peek().type) {
+      case TokenType::kEquals:
+        function = CelOperator::EQUALS;
+        break;
+      case TokenType::kNotEquals:
+        function = CelOperator::NOT_EQUALS;
+        break;
+      case TokenType::kIn:
+        function = CelOperator::IN;
+        break;
+      case TokenType::kLess:
+        function = CelOperator::LESS;
+        break;
+      case TokenType::kLessEquals:
+        function = CelOperator::LESS_EQUALS;
+        break;
+      case TokenType::kGreaterEquals:
+        function = CelOperator::GREATER_EQUALS;
+        break;
+      case TokenType::kGreater:
+        function = CelOperator::GREATER;
+        break;
+      default:
+        return lhs;
+    }
+    Token op = Consume();
+    int64_t op_id = factory_.NextId(TokenRange(op));
+    Term rhs = ParseCalc(1);
+    lhs = Term{GlobalCallOrMacro(op_id, function, std::move(lhs.expr),
+                                 std::move(rhs.expr)),
+               1 + std::max(lhs.depth, rhs.depth)};
+  }
+}
+
+Term Parser::ParseCalc(int min_precedence) {
+  // Multiplicative operators have precedence 2 and additive ones 1.
+  Term lhs = ParseUnary();
+  for (;;) {
+    absl::string_view function;
+    int precedence;
+    switch (Peek().type) {
+      case TokenType::kStar:
+        function = CelOperator::MULTIPLY;
+        precedence = 2;
+        break;
+      case TokenType::kSlash:
+        function = CelOperator::DIVIDE;
+        precedence = 2;
+        break;
+      case TokenType::kPercent:
+        function = CelOperator::MODULO;
+        precedence = 2;
+        break;
+      case TokenType::kPlus:
+        function = CelOperator::ADD;
+        precedence = 1;
+        break;
+      case TokenType::kMinus:
+        function = CelOperator::SUBTRACT;
+        precedence = 1;
+        break;
+      default:
+        return lhs;
+    }
+    if (precedence < min_precedence) {
+      return lhs;
+    }
+    Token op = Consume();
+    int64_t op_id = factory_.NextId(TokenRange(op));
+    Term rhs = ParseCalc(precedence + 1);
+    lhs = Term{GlobalCallOrMacro(op_id, function, std::move(lhs.expr),
+                                 std::move(rhs.expr)),
+               1 + std::max(lhs.depth, rhs.depth)};
+  }
+}
+
+Term Parser::ParseUnary() {
+  if (!Sync(kUnaryStart)) {
+    return ErrorTerm();
+  }
+  TokenType op_type = Peek().type;
+  if (op_type != TokenType::kExclam && op_type != TokenType::kMinus) {
+    return ParseMember();
+  }
+  if (op_type == TokenType::kMinus &&
+      (Peek(1).type == TokenType::kNumInt ||
+       Peek(1).type == TokenType::kNumFloat)) {
+    // A negative number literal.
+    return ParseMember();
+  }
+  Token op = Consume();
+  size_t count = 1;
+  while (Check(op_type)) {
+    Consume();
+    ++count;
+  }
+  if (count % 2 == 0) {
+    Term member = ParseMember();
+    ++member.depth;
+    return member;
+  }
+  int64_t op_id = factory_.NextId(TokenRange(op));
+  Term member = ParseMember();
+  return Term{GlobalCallOrMacro(op_id,
+                                op_type == TokenType::kExclam
+                                    ? CelOperator::LOGICAL_NOT
+                                    : CelOperator::NEGATE,
+                                std::move(member.expr)),
+              1 + member.depth};
+}
+
+Term Parser::ParseMember() {
+  const int32_t begin = Peek().begin;
+  Term term = ParsePrimary();
+  for (;;) {
+    if (Check(TokenType::kDot)) {
+      Token op = Consume();
+      bool optional = false;
+      if (Check(TokenType::kQuestionMark)) {
+        Consume();
+        optional = true;
+      }
+      if (!optional && Check(TokenType::kIdentifier) &&
+          Peek(1).type == TokenType::kLParen) {
+        std::string function = lexer_.Text(Consume());
+        Token open = Consume();
+        int64_t op_id = factory_.NextId(TokenRange(open));
+        std::vector<Expr> args;
+        int depth = term.depth;
+        ParseArguments(args, depth);
+        term = Term{cel_parser_internal::ReceiverCallOrMacro(
+                        factory_, registry_, options_.add_macro_calls, op_id,
+                        function, std::move(term.expr), std::move(args)),
+                    1 + depth};
+        continue;
+      }
+      if (!Check(TokenType::kIdentifier) &&
+          !Check(TokenType::kEscIdentifier)) {
+        if (optional) {
+          ReportNoViableAlternative(Peek(), Peek());
+        } else {
+          ReportNoViableAlternative(op, Peek());
+        }
+        return ErrorTerm();
+      }
+      Token id = Consume();
+      std::string field = NormalizeIdentifier(id);
+      int depth = 1 + term.depth;
+      if (optional) {
+        SourceRange range{begin, id.end};
+        if (!options_.enable_optional_syntax) {
+          term = Term{factory_.ReportError(range, "unsupported syntax '.?'"),
+                      depth};
+          continue;
+        }
+        int64_t op_id = factory_.NextId(TokenRange(op));
+        std::vector<Expr> args;
+        args.reserve(2);
+        args.push_back(std::move(term.expr));
+        args.push_back(
+            factory_.NewStringConst(factory_.NextId(range), std::move(field)));
+        term = Term{factory_.NewCall(op_id, "_?._", std::move(args)), depth};
+        continue;
+      }
+      term = Term{factory_.NewSelect(factory_.NextId(TokenRange(op)),
+                                     std::move(term.expr), std::move(field)),
+                  depth};
+      continue;
+    }
+    if (Check(TokenType::kLBracket)) {
+      Token op = Consume();
+      bool optional = false;
+      if (Check(TokenType::kQuestionMark)) {
+        Consume();
+        optional = true;
+      }
+      int64_t op_id = factory_.NextId(TokenRange(op));
+      Term index = ParseExpr();
+      Token close = end_of_input_;
+      Expect(TokenType::kRBracket, &close);
+      int depth = 1 + std::max(term.depth, index.depth);
+      if (optional && !options_.enable_optional_syntax) {
+        term = Term{factory_.ReportError(SourceRange{begin, close.end},
+                                         "unsupported syntax '.?'"),
+                    depth};
+        continue;
+      }
+      term = Term{GlobalCallOrMacro(
+                      op_id, optional ? "_[?_]" : CelOperator::INDEX,
+                      std::move(term.expr), std::move(index.expr)),
+                  depth};
+      continue;
+    }
+    return term;
+  }
+}
+
+Term Parser::ParsePrimary() {
+  switch (Peek().type) {
+    case TokenType::kDot: {
+      Token start = Consume();
+      if (!Check(TokenType::kIdentifier)) {
+        ReportNoViableAlternative(start, Peek());
+        return ErrorTerm();
+      }
+      if (Peek(1).type == TokenType::kLParen) {
+        return ParseIdentOrGlobalCall(start, /*leading_dot=*/true);
+      }
+      return ParseCreateMessage(start, /*leading_dot=*/true);
+    }
+    case TokenType::kIdentifier:
+      if (Peek(1).type == TokenType::kLParen) {
+        return ParseIdentOrGlobalCall(Peek(), /*leading_dot=*/false);
+      }
+      return ParseCreateMessage(Peek(), /*leading_dot=*/false);
+    case TokenType::kLParen: {
+      Consume();
+      Term term = ParseExpr();
+      Expect(TokenType::kRParen);
+      term.conditional = false;
+      return term;
+    }
+    case TokenType::kLBracket:
+      return ParseCreateList();
+    case TokenType::kLBrace:
+      return ParseCreateMap();
+    case TokenType::kMinus:
+    case TokenType::kTrue:
+    case TokenType::kFalse:
+    case TokenType::kNull:
+    case TokenType::kNumFloat:
+    case TokenType::kNumInt:
+    case TokenType::kNumUint:
+    case TokenType::kString:
+    case TokenType::kBytes:
+      return ParseLiteral();
+    default:
+      ReportNoViableAlternative(Peek(), Peek());
+      return ErrorTerm();
+  }
+}
+
+Term Parser::ParseIdentOrGlobalCall(Token start, bool leading_dot) {
+  Token id = Consume();
+  std::string name = lexer_.Text(id);
+  if (!Check(TokenType::kLParen)) {
+    if (cel::internal::LexisIsReserved(name)) {
+      return Term{factory_.ReportError(
+          SourceRange{start.begin, id.end},
+          absl::StrFormat("reserved identifier: %s", name))};
+    }
+    if (leading_dot) {
+      name.insert(0, ".");
+    }
+    return Term{factory_.NewIdent(factory_.NextId(TokenRange(id)),
+                                  std::move(name))};
+  }
+  Token open = Consume();
+  if (cel::internal::LexisIsReserved(name)) {
+    // Consume the arguments so that parsing can continue after the call.
+    std::vector<Expr> args;
+    int depth = 0;
+    ParseArguments(args, depth);
+    return Term{factory_.ReportError(
+        SourceRange{start.begin, previous_end_},
+        absl::StrFormat("reserved identifier: %s", name))};
+  }
+  if (leading_dot) {
+    name.insert(0, ".");
+  }
+  int64_t op_id = factory_.NextId(TokenRange(open));
+  std::vector<Expr> args;
+  int depth = 0;
+  ParseArguments(args, depth);
+  return Term{GlobalCallOrMacro(op_id, name, std::move(args)), 1 + depth};
+}
+
+bool Parser::ParseArguments(std::vector<Expr>& args, int& depth) {
+  // The opening parenthesis has been consumed.
+  if (!Sync(kUnaryStart.Union({TokenType::kRParen}))) {
+    return false;
+  }
+  if (!Check(TokenType::kRParen)) {
+    for (;;) {
+      Term arg = ParseExpr();
+      depth = std::max(depth, ElementDepth(arg));
+      args.push_back(std::move(arg.expr));
+      if (!Check(TokenType::kComma)) {
+        break;
+      }
+      Consume();
+    }
+  }
+  return Expect(TokenType::kRParen);
+}
+
+Term Parser::ParseCreateMessage(Token start, bool leading_dot) {
+  // Either an identifier or the qualified name of a message type, which is
+  // only known once the opening brace is seen.
+  size_t lookahead = 1;
+  while (Peek(lookahead).type == TokenType::kDot &&
+         Peek(lookahead + 1).type == TokenType::kIdentifier) {
+    lookahead += 2;
+  }
+  if (Peek(lookahead).type != TokenType::kLBrace) {
+    return ParseIdentOrGlobalCall(start, leading_dot);
+  }
+  std::string name = leading_dot ? "." : "";
+  for (size_t i = 0; i < lookahead; ++i) {
+    absl::StrAppend(&name, lexer_.Text(Consume()));
+  }
+  Token open = Consume();
+  int64_t obj_id = factory_.NextId(TokenRange(open));
+  std::vector<StructExprField> fields;
+  int depth = 0;
+  if (Sync({TokenType::kRBrace, TokenType::kComma, TokenType::kQuestionMark,
+            TokenType::kIdentifier, TokenType::kEscIdentifier}) &&
+      !Check(TokenType::kRBrace) && !Check(TokenType::kComma)) {
+    const int32_t begin = Peek().begin;
+    int unsupported = 0;
+    for (;;) {
+      if (!Sync({TokenType::kQuestionMark, TokenType::kIdentifier,
+                 TokenType::kEscIdentifier})) {
+        break;
+      }
+      bool optional = false;
+      if (Check(TokenType::kQuestionMark)) {
+        Consume();
+        optional = true;
+      }
+      if (!Check(TokenType::kIdentifier) &&
+          !Check(TokenType::kEscIdentifier)) {
+        ReportNoViableAlternative(Peek(), Peek());
+        break;
+      }
+      std::string field = NormalizeIdentifier(Consume());
+      Token colon = end_of_input_;
+      if (!Expect(TokenType::kColon, &colon)) {
+        break;
+      }
+      int64_t init_id = factory_.NextId(TokenRange(colon));
+      Term value = ParseExpr();
+      if (optional && !options_.enable_optional_syntax) {
+        ++unsupported;
+      } else {
+        depth = std::max(depth, value.depth);
+        fields.push_back(factory_.NewStructField(
+            init_id, std::move(field), std::move(value.expr), optional));
+      }
+      if (!Check(TokenType::kComma) || Peek(1).type == TokenType::kRBrace) {
+        break;
+      }
+      Consume();
+    }
+    for (int i = 0; i < unsupported; ++i) {
+      factory_.ReportError(SourceRange{begin, previous_end_},
+                           "unsupported syntax '?'");
+    }
+  }
+  if (Sync({TokenType::kRBrace, TokenType::kComma}) &&
+      Check(TokenType::kComma)) {
+    Consume();
+  }
+  Expect(TokenType::kRBrace);
+  return Term{factory_.NewStruct(obj_id, std::move(name), std::move(fields)),
+              1 + depth};
+}
+
+Term Parser::ParseCreateList() {
+  Token open = Consume();
+  int64_t list_id = factory_.NextId(TokenRange(open));
+  std::vector<ListExprElement> elements;
+  int depth = 0;
+  if (Sync(kUnaryStart.Union({TokenType::kQuestionMark, TokenType::kComma,
+                              TokenType::kRBracket})) &&
+      !Check(TokenType::kComma) && !Check(TokenType::kRBracket)) {
+    const int32_t begin = Peek().begin;
+    int unsupported = 0;
+    for (;;) {
+      if (!Sync(kUnaryStart.Union({TokenType::kQuestionMark}))) {
+        break;
+      }
+      bool optional = false;
+      if (Check(TokenType::kQuestionMark)) {
+        Consume();
+        optional = true;
+      }
+      Term element = ParseExpr();
+      if (optional && !options_.enable_optional_syntax) {
+        ++unsupported;
+        elements.push_back(
+            factory_.NewListElement(factory_.NewUnspecified(0), false));
+      } else {
+        depth = std::max(depth, ElementDepth(element));
+        elements.push_back(
+            factory_.NewListElement(std::move(element.expr), optional));
+      }
+      if (!Check(TokenType::kComma) || Peek(1).type == TokenType::kRBracket) {
+        break;
+      }
+      Consume();
+    }
+    for (int i = 0; i < unsupported; ++i) {
+      factory_.ReportError(SourceRange{begin, previous_end_},
+                           "unsupported syntax '?'");
+    }
+  }
+  if (Sync({TokenType::kRBracket, TokenType::kComma}) &&
+      Check(TokenType::kComma)) {
+    Consume();
+  }
+  Expect(TokenType::kRBracket);
+  return Term{factory_.NewList(list_id, std::move(elements)), 1 + depth};
+}
+
+Term Parser::ParseCreateMap() {
+  Token open = Consume();
+  int64_t map_id = factory_.NextId(TokenRange(open));
+  std::vector<MapExprEntry> entries;
+  int depth = 0;
+  if (Sync(kUnaryStart.Union({TokenType::kQuestionMark, TokenType::kComma,
+                              TokenType::kRBrace})) &&
+      !Check(TokenType::kComma) && !Check(TokenType::kRBrace)) {
+    const int32_t begin = Peek().begin;
+    int unsupported = 0;
+    for (;;) {
+      if (!Sync(kUnaryStart.Union({TokenType::kQuestionMark}))) {
+        break;
+      }
+      // The ANTLR based parser assigns the entry's ID before the key's, but
+      // its position is that of the colon following the key.
+      int64_t entry_id = factory_.NextId(SourceRange{});
+      bool optional = false;
+      if (Check(TokenType::kQuestionMark)) {
+        Consume();
+        optional = true;
+      }
+      Term key = ParseExpr();
+      Token colon = end_of_input_;
+      if (!Expect(TokenType::kColon, &colon)) {
+        break;
+      }
+      factory_.SetSourceRange(entry_id, TokenRange(colon));
+      Term value = ParseExpr();
+      if (optional && !options_.enable_optional_syntax) {
+        ++unsupported;
+        entries.push_back(factory_.NewMapEntry(0, factory_.NewUnspecified(0),
+                                               factory_.NewUnspecified(0),
+                                               false));
+      } else {
+        depth = std::max({depth, key.depth, value.depth});
+        entries.push_back(factory_.NewMapEntry(entry_id, std::move(key.expr),
+                                               std::move(value.expr),
+                                               optional));
+      }
+      if (!Check(TokenType::kComma) || Peek(1).type == TokenType::kRBrace) {
+        break;
+      }
+      Consume();
+    }
+    for (int i = 0; i < unsupported; ++i) {
+      factory_.ReportError(SourceRange{begin, previous_end_},
+                           "unsupported syntax '?'");
+    }
+  }
+  if (Sync({TokenType::kRBrace, TokenType::kComma}) &&
+      Check(TokenType::kComma)) {
+    Consume();
+  }
+  Expect(TokenType::kRBrace);
+  return Term{factory_.NewMap(map_id, std::move(entries)), 1 + depth};
+}
+
+Term Parser::ParseLiteral() {
+  Token token = Consume();
+  const int32_t begin = token.begin;
+  std::string sign;
+  if (token.type == TokenType::kMinus) {
+    sign = "-";
+    token = Consume();
+  }
+  const SourceRange range{begin, token.end};
+  std::string text = lexer_.Text(token);
+  switch (token.type) {
+    case TokenType::kNumInt: {
+      std::string value = absl::StrCat(sign, text);
+      int64_t int_value;
+      if (absl::StartsWith(text, "0x")) {
+        if (absl::SimpleHexAtoi(value, &int_value)) {
+          return Term{factory_.NewIntConst(factory_.NextId(range), int_value)};
+        }
+        return Term{factory_.ReportError(range, "invalid hex int literal")};
+      }
+      if (absl::SimpleAtoi(value, &int_value)) {
+        return Term{factory_.NewIntConst(factory_.NextId(range), int_value)};
+      }
+      return Term{factory_.ReportError(range, "invalid int literal")};
+    }
+    case TokenType::kNumUint: {
+      // trim the 'u' designator included in the uint literal.
+      std::string value = text.substr(0, text.size() - 1);
+      uint64_t uint_value;
+      if (absl::StartsWith(text, "0x")) {
+        if (absl::SimpleHexAtoi(value, &uint_value)) {
+          return Term{
+              factory_.NewUintConst(factory_.NextId(range), uint_value)};
+        }
+        return Term{factory_.ReportError(range, "invalid hex uint literal")};
+      }
+      if (absl::SimpleAtoi(value, &uint_value)) {
+        return Term{factory_.NewUintConst(factory_.NextId(range), uint_value)};
+      }
+      return Term{factory_.ReportError(range, "invalid uint literal")};
+    }
+    case TokenType::kNumFloat: {
+      double double_value;
+      if (absl::SimpleAtod(absl::StrCat(sign, text), &double_value)) {
+        return Term{
+            factory_.NewDoubleConst(factory_.NextId(range), double_value)};
+      }
+      return Term{factory_.ReportError(range, "invalid double literal")};
+    }
+    case TokenType::kString: {
+      auto value = cel::internal::ParseStringLiteral(text);
+      if (!value.ok()) {
+        return Term{factory_.ReportError(range, value.status().message())};
+      }
+      return Term{factory_.NewStringConst(factory_.NextId(range),
+                                          std::move(value).value())};
+    }
+    case TokenType::kBytes: {
+      auto value = cel::internal::ParseBytesLiteral(text);
+      if (!value.ok()) {
+        return Term{factory_.ReportError(range, value.status().message())};
+      }
+      return Term{factory_.NewBytesConst(factory_.NextId(range),
+                                         std::move(value).value())};
+    }
+    case TokenType::kTrue:
+      return Term{factory_.NewBoolConst(factory_.NextId(range), true)};
+    case TokenType::kFalse:
+      return Term{factory_.NewBoolConst(factory_.NextId(range), false)};
+    case TokenType::kNull:
+      return Term{factory_.NewNullConst(factory_.NextId(range))};
+    default:
+      // Only reachable after a syntax error.
+      return ErrorTerm();
+  }
+}
+
+std::string Parser::NormalizeIdentifier(const Token& token) {
+  std::string text = lexer_.Text(token);
+  if (token.type != TokenType::kEscIdentifier) {
+    return text;
+  }
+  if (!options_.enable_quoted_identifiers) {
+    factory_.ReportError(TokenRange(token), "unsupported syntax '`'");
+  }
+  return text.substr(1, text.size() - 2);
+}
+
+}  // namespace
+
+absl::StatusOr<Expr> RecursiveDescentParse(
+    const cel::Source& source, const cel::MacroRegistry& registry,
+    const cel::ParserOptions& options, cel::ParserMacroExprFactory& factory) {
+  cel::common_internal::ExprNodeArena expr_node_arena;
+  return Parser(source, registry, options, factory).Parse();
+}
+
+}  // namespace cel_parser_internal
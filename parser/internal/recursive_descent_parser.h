@@ -0,0 +1,46 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_PARSER_INTERNAL_RECURSIVE_DESCENT_PARSER_H_
+#define THIRD_PARTY_CEL_CPP_PARSER_INTERNAL_RECURSIVE_DESCENT_PARSER_H_
+
+#include "absl/status/statusor.h"
+#include "common/expr.h"
+#include "common/source.h"
+#include "parser/internal/parser_macro_expr_factory.h"
+#include "parser/macro_registry.h"
+#include "parser/options.h"
+
+namespace cel_parser_internal {
+
+// Parses `source` with a hand-written lexer and recursive descent parser,
+// building the expression with `factory`.
+//
+// The grammar is the one in Cel.g4 and the result is the same as that of the
+// ANTLR generated parser: the same expression, IDs, positions and macro calls.
+// Syntax errors are reported to `factory` using the messages ANTLR would
+// produce, but parsing stops at the first error that cannot be recovered from
+// by dropping a single token.
+//
+// Returns an error only if parsing was abandoned because the expression
+// nesting exceeds `options.max_recursion_depth`: `kCancelled`, or
+// `kInvalidArgument` if syntax errors had already been reported. Callers
+// should check `factory.HasErrors()` in any case.
+absl::StatusOr<cel::Expr> RecursiveDescentParse(
+    const cel::Source& source, const cel::MacroRegistry& registry,
+    const cel::ParserOptions& options, cel::ParserMacroExprFactory& factory);
+
+}  // namespace cel_parser_internal
+
+#endif  // THIRD_PARTY_CEL_CPP_PARSER_INTERNAL_RECURSIVE_DESCENT_PARSER_H_
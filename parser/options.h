@@ -59,6 +59,13 @@ struct ParserOptions final {
   //
   // Limited to field specifiers in select and message creation.
   bool enable_quoted_identifiers = false;
+
+  // Parse with a hand-written recursive descent parser instead of the ANTLR
+  // generated one. The resulting ASTs are the same, but parsing stops at the
+  // first syntax error that cannot be recovered from by skipping a single
+  // token, so fewer errors may be reported for malformed expressions and the
+  // error recovery limits have little effect.
+  bool enable_recursive_descent_parser = false;
 };
 
 }  // namespace cel
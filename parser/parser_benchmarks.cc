@@ -14,6 +14,7 @@
 
 #include <string>
 #include <thread>
+#include <tuple>
 #include <vector>
 
 #include "cel/expr/syntax.pb.h"
@@ -232,16 +233,18 @@ const std::vector<TestInfo>& GetTestCases() {
   return *kInstance;
 }
 
-class BenchmarkCaseTest : public testing::TestWithParam<TestInfo> {};
+class BenchmarkCaseTest
+    : public testing::TestWithParam<std::tuple<TestInfo, bool>> {};
 
 TEST_P(BenchmarkCaseTest, ExpectedResult) {
   std::vector<Macro> macros = Macro::AllMacros();
   macros.push_back(cel::OptMapMacro());
   macros.push_back(cel::OptFlatMapMacro());
-  const TestInfo& test_info = GetParam();
+  const TestInfo& test_info = std::get<0>(GetParam());
   ParserOptions options;
   options.enable_optional_syntax = true;
   options.enable_quoted_identifiers = true;
+  options.enable_recursive_descent_parser = std::get<1>(GetParam());
 
   auto result = EnrichedParse(test_info.expr, macros, "<input>", options);
   switch (test_info.result) {
@@ -255,18 +258,21 @@ TEST_P(BenchmarkCaseTest, ExpectedResult) {
 }
 
 INSTANTIATE_TEST_SUITE_P(CelParserTest, BenchmarkCaseTest,
-                         testing::ValuesIn(GetTestCases()));
+                         testing::Combine(testing::ValuesIn(GetTestCases()),
+                                          testing::Bool()));
 
 // This is not a proper microbenchmark, but is used to check for major
 // regressions in the ANTLR generated code or concurrency issues. Each benchmark
 // iteration parses all of the basic test cases from the unit-tests.
-void BM_Parse(benchmark::State& state) {
+void RunParseBenchmark(benchmark::State& state,
+                       bool enable_recursive_descent_parser) {
   std::vector<Macro> macros = Macro::AllMacros();
   macros.push_back(cel::OptMapMacro());
   macros.push_back(cel::OptFlatMapMacro());
   ParserOptions options;
   options.enable_optional_syntax = true;
   options.enable_quoted_identifiers = true;
+  options.enable_recursive_descent_parser = enable_recursive_descent_parser;
   for (auto s : state) {
     for (const auto& test_case : GetTestCases()) {
       auto result = ParseWithMacros(test_case.expr, macros, "<input>", options);
@@ -276,7 +282,18 @@ void BM_Parse(benchmark::State& state) {
   }
 }
 
+void BM_Parse(benchmark::State& state) {
+  RunParseBenchmark(state, /*enable_recursive_descent_parser=*/false);
+}
+
 BENCHMARK(BM_Parse)->ThreadRange(1, std::thread::hardware_concurrency());
 
+void BM_ParseRecursiveDescent(benchmark::State& state) {
+  RunParseBenchmark(state, /*enable_recursive_descent_parser=*/true);
+}
+
+BENCHMARK(BM_ParseRecursiveDescent)
+    ->ThreadRange(1, std::thread::hardware_concurrency());
+
 }  // namespace
 }  // namespace google::api::expr::parser
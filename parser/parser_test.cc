@@ -1470,8 +1470,39 @@ std::string ConvertMacroCallsToString(
 
 class ExpressionTest : public testing::TestWithParam<TestInfo> {};
 
-TEST_P(ExpressionTest, Parse) {
-  const TestInfo& test_info = GetParam();
+void ExpectAdornedOutput(const TestInfo& test_info,
+                         const VerboseParsedExpr& result) {
+  if (!test_info.P.empty()) {
+    KindAndIdAdorner kind_and_id_adorner;
+    ExprPrinter w(kind_and_id_adorner);
+    std::string adorned_string = w.PrintProto(result.parsed_expr().expr());
+    EXPECT_EQ(test_info.P, adorned_string) << result.parsed_expr();
+  }
+
+  if (!test_info.L.empty()) {
+    LocationAdorner location_adorner(result.parsed_expr().source_info());
+    ExprPrinter w(location_adorner);
+    std::string adorned_string = w.PrintProto(result.parsed_expr().expr());
+    EXPECT_EQ(test_info.L, adorned_string) << result.parsed_expr();
+  }
+
+  if (!test_info.R.empty()) {
+    EXPECT_EQ(test_info.R, ConvertEnrichedSourceInfoToString(
+                               result.enriched_source_info()));
+  }
+
+  if (!test_info.M.empty()) {
+    EXPECT_EQ(test_info.M,
+              ConvertMacroCallsToString(result.parsed_expr().source_info()))
+        << result.parsed_expr();
+  }
+}
+
+absl::string_view FirstLine(absl::string_view text) {
+  return text.substr(0, text.find('\n'));
+}
+
+ParserOptions ExpressionTestOptions(const TestInfo& test_info) {
   ParserOptions options;
   options.enable_hidden_accumulator_var = true;
   if (!test_info.M.empty()) {
@@ -1479,43 +1510,47 @@ TEST_P(ExpressionTest, Parse) {
   }
   options.enable_optional_syntax = true;
   options.enable_quoted_identifiers = true;
+  return options;
+}
 
+std::vector<Macro> ExpressionTestMacros() {
   std::vector<Macro> macros = Macro::AllMacros();
   macros.push_back(cel::OptMapMacro());
   macros.push_back(cel::OptFlatMapMacro());
-  auto result = EnrichedParse(test_info.I, macros, "<input>", options);
+  return macros;
+}
+
+TEST_P(ExpressionTest, Parse) {
+  const TestInfo& test_info = GetParam();
+  auto result =
+      EnrichedParse(test_info.I, ExpressionTestMacros(), "<input>",
+                    ExpressionTestOptions(test_info));
   if (test_info.E.empty()) {
-    EXPECT_THAT(result, IsOk());
+    ASSERT_THAT(result, IsOk());
+    ExpectAdornedOutput(test_info, *result);
   } else {
     EXPECT_THAT(result, Not(IsOk()));
     EXPECT_EQ(test_info.E, result.status().message());
   }
+}
 
-  if (!test_info.P.empty()) {
-    KindAndIdAdorner kind_and_id_adorner;
-    ExprPrinter w(kind_and_id_adorner);
-    std::string adorned_string = w.PrintProto(result->parsed_expr().expr());
-    EXPECT_EQ(test_info.P, adorned_string) << result->parsed_expr();
-  }
-
-  if (!test_info.L.empty()) {
-    LocationAdorner location_adorner(result->parsed_expr().source_info());
-    ExprPrinter w(location_adorner);
-    std::string adorned_string = w.PrintProto(result->parsed_expr().expr());
-    EXPECT_EQ(test_info.L, adorned_string) << result->parsed_expr();
-    ;
-  }
-
-  if (!test_info.R.empty()) {
-    EXPECT_EQ(test_info.R, ConvertEnrichedSourceInfoToString(
-                               result->enriched_source_info()));
-  }
+class RecursiveDescentExpressionTest
+    : public testing::TestWithParam<TestInfo> {};
 
-  if (!test_info.M.empty()) {
-    EXPECT_EQ(test_info.M, ConvertMacroCallsToString(
-                               result.value().parsed_expr().source_info()))
-        << result->parsed_expr();
-    ;
+TEST_P(RecursiveDescentExpressionTest, Parse) {
+  const TestInfo& test_info = GetParam();
+  ParserOptions options = ExpressionTestOptions(test_info);
+  options.enable_recursive_descent_parser = true;
+  auto result = EnrichedParse(test_info.I, ExpressionTestMacros(), "<input>",
+                              options);
+  if (test_info.E.empty()) {
+    ASSERT_THAT(result, IsOk());
+    ExpectAdornedOutput(test_info, *result);
+  } else {
+    // Parsing stops at the first syntax error, so later errors reported by
+    // the ANTLR based parser may be missing.
+    EXPECT_THAT(result, Not(IsOk()));
+    EXPECT_EQ(FirstLine(test_info.E), FirstLine(result.status().message()));
   }
 }
 
@@ -1626,6 +1661,63 @@ TEST(ExpressionTest, RecursionDepthIgnoresParentheses) {
   EXPECT_THAT(result, IsOk());
 }
 
+TEST(RecursiveDescentParserTest, RecursionDepth) {
+  ParserOptions options;
+  options.enable_recursive_descent_parser = true;
+  options.max_recursion_depth = 16;
+  EXPECT_THAT(Parse("[1, 2, 3, 4, 5, 6, 7, 8, 9, 10]", "", options), IsOk());
+
+  options.max_recursion_depth = 6;
+  EXPECT_THAT(Parse("(((1 + 2 + 3 + 4 + (5 + 6))))", "", options), IsOk());
+  EXPECT_THAT(Parse("1 + 2 + 3 + 4 + 5 + 6 + 7", "", options),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Exceeded max recursion depth of 6 when "
+                                 "parsing.")));
+}
+
+TEST(RecursiveDescentParserTest, ExpressionNestingLimit) {
+  ParserOptions options;
+  options.enable_recursive_descent_parser = true;
+  std::string expr = absl::StrCat(std::string(40, '('), "1",
+                                  std::string(40, ')'));
+  EXPECT_THAT(Parse(expr, "", options),
+              StatusIs(absl::StatusCode::kCancelled,
+                       "Expression recursion limit exceeded. limit: 32"));
+}
+
+TEST(RecursiveDescentParserTest, ExpressionSizeLimit) {
+  ParserOptions options;
+  options.enable_recursive_descent_parser = true;
+  options.expression_size_codepoint_limit = 10;
+  EXPECT_THAT(
+      Parse("...............", "", options),
+      StatusIs(absl::StatusCode::kInvalidArgument,
+               "expression size exceeds codepoint limit. input size: 15, "
+               "limit: 10"));
+}
+
+TEST(RecursiveDescentParserTest, DisableQuotedIdentifiers) {
+  ParserOptions options;
+  options.enable_recursive_descent_parser = true;
+  options.enable_quoted_identifiers = false;
+  auto result = Parse("foo.`bar`", "", options);
+
+  EXPECT_THAT(result, Not(IsOk()));
+  EXPECT_THAT(result.status().message(),
+              HasSubstr("ERROR: :1:5: unsupported syntax '`'\n"
+                        " | foo.`bar`\n"
+                        " | ....^"));
+}
+
+TEST(RecursiveDescentParserTest, TsanOom) {
+  ParserOptions options;
+  options.enable_recursive_descent_parser = true;
+  EXPECT_THAT(Parse(absl::StrCat("[[a([[???[a[[??[a(", std::string(1000, '['),
+                                 "???[a([[????"),
+                    "", options),
+              Not(IsOk()));
+}
+
 const std::vector<TestInfo>& UpdatedAccuVarTestCases() {
   static const std::vector<TestInfo>* kInstance = new std::vector<TestInfo>{
       {"[].exists(x, x > 0)",
@@ -1969,6 +2061,44 @@ TEST(NewParserBuilderTest, ForwardsOptions) {
               StatusIs(absl::StatusCode::kInvalidArgument));
 }
 
+TEST(NewParserBuilderTest, RecursiveDescentParser) {
+  auto builder = cel::NewParserBuilder();
+  builder->GetOptions().enable_recursive_descent_parser = true;
+  ASSERT_OK_AND_ASSIGN(auto parser, std::move(*builder).Build());
+  builder.reset();
+
+  ASSERT_OK_AND_ASSIGN(auto source, cel::NewSource("has(a.b) && [].map(x, x)"));
+  ASSERT_OK_AND_ASSIGN(auto ast, parser->Parse(*source));
+
+  EXPECT_FALSE(ast->IsChecked());
+  KindAndIdAdorner kind_and_id_adorner;
+  ExprPrinter w(kind_and_id_adorner);
+  EXPECT_EQ(w.Print(ast->root_expr()),
+            "_&&_(\n"
+            "  a^#2:Expr.Ident#.b~test-only~^#4:Expr.Select#,\n"
+            "  __comprehension__(\n"
+            "    // Variable\n"
+            "    x,\n"
+            "    // Target\n"
+            "    []^#5:Expr.CreateList#,\n"
+            "    // Accumulator\n"
+            "    @result,\n"
+            "    // Init\n"
+            "    []^#9:Expr.CreateList#,\n"
+            "    // LoopCondition\n"
+            "    true^#10:bool#,\n"
+            "    // LoopStep\n"
+            "    _+_(\n"
+            "      @result^#11:Expr.Ident#,\n"
+            "      [\n"
+            "        x^#8:Expr.Ident#\n"
+            "      ]^#12:Expr.CreateList#\n"
+            "    )^#13:Expr.Call#,\n"
+            "    // Result\n"
+            "    @result^#14:Expr.Ident#)^#15:Expr.Comprehension#\n"
+            ")^#16:Expr.Call#");
+}
+
 std::string TestName(const testing::TestParamInfo<TestInfo>& test_info) {
   std::string name = absl::StrCat(test_info.index, "-", test_info.param.I);
   absl::c_replace_if(name, [](char c) { return !absl::ascii_isalnum(c); }, '_');
@@ -1979,6 +2109,9 @@ std::string TestName(const testing::TestParamInfo<TestInfo>& test_info) {
 INSTANTIATE_TEST_SUITE_P(CelParserTest, ExpressionTest,
                          testing::ValuesIn(test_cases), TestName);
 
+INSTANTIATE_TEST_SUITE_P(CelParserTest, RecursiveDescentExpressionTest,
+                         testing::ValuesIn(test_cases), TestName);
+
 INSTANTIATE_TEST_SUITE_P(UpdatedAccuVarTest, UpdatedAccuVarDisabledTest,
                          testing::ValuesIn(UpdatedAccuVarTestCases()),
                          TestName);
@@ -29,6 +29,7 @@
 #include "absl/types/span.h"
 #include "common/function_descriptor.h"
 #include "common/kind.h"
+#include "internal/status_macros.h"
 #include "runtime/activation_interface.h"
 #include "runtime/function.h"
 #include "runtime/function_overload_reference.h"
@@ -80,15 +81,7 @@ CreateActivationFunctionProvider() {
 absl::Status FunctionRegistry::Register(
     const cel::FunctionDescriptor& descriptor,
     std::unique_ptr<cel::Function> implementation) {
-  if (DescriptorRegistered(descriptor)) {
-    return absl::Status(
-        absl::StatusCode::kAlreadyExists,
-        "CelFunction with specified parameters already registered");
-  }
-  if (!ValidateNonStrictOverload(descriptor)) {
-    return absl::Status(absl::StatusCode::kAlreadyExists,
-                        "Only one overload is allowed for non-strict function");
-  }
+  CEL_RETURN_IF_ERROR(CheckRegistration(descriptor));
 
   auto& overloads = functions_[descriptor.name()];
   overloads.static_overloads.push_back(
@@ -98,15 +91,7 @@ absl::Status FunctionRegistry::Register(
 
 absl::Status FunctionRegistry::RegisterLazyFunction(
     const cel::FunctionDescriptor& descriptor) {
-  if (DescriptorRegistered(descriptor)) {
-    return absl::Status(
-        absl::StatusCode::kAlreadyExists,
-        "CelFunction with specified parameters already registered");
-  }
-  if (!ValidateNonStrictOverload(descriptor)) {
-    return absl::Status(absl::StatusCode::kAlreadyExists,
-                        "Only one overload is allowed for non-strict function");
-  }
+  CEL_RETURN_IF_ERROR(CheckRegistration(descriptor));
   auto& overloads = functions_[descriptor.name()];
 
   overloads.lazy_overloads.push_back(
@@ -115,6 +100,25 @@ absl::Status FunctionRegistry::RegisterLazyFunction(
   return absl::OkStatus();
 }
 
+absl::Status FunctionRegistry::RegisterAll(const FunctionRegistry& other) {
+  if (functions_.empty()) {
+    // Nothing to conflict with, and `other` was validated as it was built.
+    functions_ = other.functions_;
+    return absl::OkStatus();
+  }
+  for (const auto& [name, entry] : other.functions_) {
+    for (const auto& overload : entry.static_overloads) {
+      CEL_RETURN_IF_ERROR(CheckRegistration(*overload.descriptor));
+      functions_[name].static_overloads.push_back(overload);
+    }
+    for (const auto& overload : entry.lazy_overloads) {
+      CEL_RETURN_IF_ERROR(CheckRegistration(*overload.descriptor));
+      functions_[name].lazy_overloads.push_back(overload);
+    }
+  }
+  return absl::OkStatus();
+}
+
 std::vector<cel::FunctionOverloadReference>
 FunctionRegistry::FindStaticOverloads(absl::string_view name,
                                       bool receiver_style,
@@ -218,6 +222,20 @@ FunctionRegistry::ListFunctions() const {
   return descriptor_map;
 }
 
+absl::Status FunctionRegistry::CheckRegistration(
+    const cel::FunctionDescriptor& descriptor) const {
+  if (DescriptorRegistered(descriptor)) {
+    return absl::Status(
+        absl::StatusCode::kAlreadyExists,
+        "CelFunction with specified parameters already registered");
+  }
+  if (!ValidateNonStrictOverload(descriptor)) {
+    return absl::Status(absl::StatusCode::kAlreadyExists,
+                        "Only one overload is allowed for non-strict function");
+  }
+  return absl::OkStatus();
+}
+
 bool FunctionRegistry::DescriptorRegistered(
     const cel::FunctionDescriptor& descriptor) const {
   auto overloads = functions_.find(descriptor.name());
@@ -55,6 +55,8 @@ class FunctionRegistry {
   FunctionRegistry() = default;
 
   // Move-only
+  FunctionRegistry(const FunctionRegistry&) = delete;
+  FunctionRegistry& operator=(const FunctionRegistry&) = delete;
   FunctionRegistry(FunctionRegistry&&) = default;
   FunctionRegistry& operator=(FunctionRegistry&&) = default;
 
@@ -69,6 +71,14 @@ class FunctionRegistry {
   // implementation of cel::ActivationInterface.
   absl::Status RegisterLazyFunction(const cel::FunctionDescriptor& descriptor);
 
+  // Register every function of `other`, static or lazy. The implementations
+  // are shared with `other` rather than copied, so this is much cheaper than
+  // registering them again, and `other` need not outlive this registry.
+  //
+  // Fails if any of the functions could not be registered individually, in
+  // which case only those before it are registered.
+  absl::Status RegisterAll(const FunctionRegistry& other);
+
   // Find subset of cel::Function implementations that match overload conditions
   // As types may not be available during expression compilation,
   // further narrowing of this subset will happen at evaluation stage.
@@ -112,29 +122,29 @@ class FunctionRegistry {
   ListFunctions() const;
 
  private:
+  // Entries are shared with the registries they are copied to by
+  // `RegisterAll`, which never modify them. The descriptors are held through
+  // pointers so that their addresses are stable.
   struct StaticFunctionEntry {
     StaticFunctionEntry(const cel::FunctionDescriptor& descriptor,
                         std::unique_ptr<cel::Function> impl)
-        : descriptor(std::make_unique<cel::FunctionDescriptor>(descriptor)),
+        : descriptor(std::make_shared<cel::FunctionDescriptor>(descriptor)),
           implementation(std::move(impl)) {}
 
-    // Extra indirection needed to preserve pointer stability for the
-    // descriptors.
-    std::unique_ptr<cel::FunctionDescriptor> descriptor;
-    std::unique_ptr<cel::Function> implementation;
+    std::shared_ptr<const cel::FunctionDescriptor> descriptor;
+    std::shared_ptr<const cel::Function> implementation;
   };
 
   struct LazyFunctionEntry {
     LazyFunctionEntry(
         const cel::FunctionDescriptor& descriptor,
         std::unique_ptr<cel::runtime_internal::FunctionProvider> provider)
-        : descriptor(std::make_unique<cel::FunctionDescriptor>(descriptor)),
+        : descriptor(std::make_shared<cel::FunctionDescriptor>(descriptor)),
           function_provider(std::move(provider)) {}
 
-    // Extra indirection needed to preserve pointer stability for the
-    // descriptors.
-    std::unique_ptr<cel::FunctionDescriptor> descriptor;
-    std::unique_ptr<cel::runtime_internal::FunctionProvider> function_provider;
+    std::shared_ptr<const cel::FunctionDescriptor> descriptor;
+    std::shared_ptr<const cel::runtime_internal::FunctionProvider>
+        function_provider;
   };
 
   struct RegistryEntry {
@@ -142,6 +152,10 @@ class FunctionRegistry {
     std::vector<LazyFunctionEntry> lazy_overloads;
   };
 
+  // Returns an error if `descriptor` cannot be added to the registry.
+  absl::Status CheckRegistration(
+      const cel::FunctionDescriptor& descriptor) const;
+
   // Returns whether the descriptor is registered either as a lazy function or
   // as a static function.
   bool DescriptorRegistered(const cel::FunctionDescriptor& descriptor) const;
@@ -185,6 +185,42 @@ TEST(FunctionRegistryTest, DefaultLazyProviderAmbiguousOverload) {
                HasSubstr("Couldn't resolve function")));
 }
 
+TEST(FunctionRegistryTest, RegisterAllSharesImplementations) {
+  FunctionRegistry source;
+  ASSERT_OK(source.Register(ConstIntFunction::MakeDescriptor(),
+                            std::make_unique<ConstIntFunction>()));
+  ASSERT_OK(source.RegisterLazyFunction(
+      FunctionDescriptor("LazyFunction", false, {Kind::kAny})));
+
+  FunctionRegistry empty;
+  ASSERT_OK(empty.RegisterAll(source));
+  FunctionRegistry nonempty;
+  ASSERT_OK(nonempty.RegisterLazyFunction(
+      FunctionDescriptor("LazyFunction", false, {Kind::kInt, Kind::kInt})));
+  ASSERT_OK(nonempty.RegisterAll(source));
+
+  auto expected = source.FindStaticOverloads("ConstFunction", false, {});
+  ASSERT_THAT(expected, SizeIs(1));
+  for (const FunctionRegistry* registry : {&empty, &nonempty}) {
+    auto overloads = registry->FindStaticOverloads("ConstFunction", false, {});
+    ASSERT_THAT(overloads, SizeIs(1));
+    EXPECT_EQ(&overloads[0].implementation, &expected[0].implementation);
+  }
+  EXPECT_THAT(empty.ListFunctions()["LazyFunction"], SizeIs(1));
+  EXPECT_THAT(nonempty.ListFunctions()["LazyFunction"], SizeIs(2));
+}
+
+TEST(FunctionRegistryTest, RegisterAllRejectsRegisteredDescriptors) {
+  FunctionRegistry source;
+  ASSERT_OK(source.Register(ConstIntFunction::MakeDescriptor(),
+                            std::make_unique<ConstIntFunction>()));
+
+  FunctionRegistry registry;
+  ASSERT_OK(registry.RegisterLazyFunction(ConstIntFunction::MakeDescriptor()));
+  EXPECT_THAT(registry.RegisterAll(source),
+              StatusIs(absl::StatusCode::kAlreadyExists));
+}
+
 TEST(FunctionRegistryTest, CanRegisterNonStrictFunction) {
   {
     FunctionRegistry registry;
@@ -0,0 +1,61 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Support for field accessors generated by the `cel_cc_message_accessors`
+// build rule (see bazel/cel_cc_message_accessors.bzl). Generated code uses the
+// definitions here; other code should not need to.
+
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_GENERATED_MESSAGE_ACCESSORS_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_GENERATED_MESSAGE_ACCESSORS_H_
+
+#include "absl/base/nullability.h"
+#include "common/value.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
+
+namespace cel {
+
+// Reads one singular field of a message type through the accessors of its
+// generated C++ class instead of through `google::protobuf::Reflection`.
+struct GeneratedFieldAccessor {
+  // The field number.
+  int number;
+
+  // Returns `true` if `message` is an instance of the generated class, as
+  // opposed to, for example, a `google::protobuf::DynamicMessage` of the same type.
+  // `get` and `has` may only be called with such messages.
+  bool (*is_instance)(const google::protobuf::Message& message);
+
+  // Returns the value of the field, as `Value::WrapField()` would.
+  Value (*get)(const google::protobuf::Message& message,
+               const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+               google::protobuf::MessageFactory* absl_nonnull message_factory,
+               google::protobuf::Arena* absl_nonnull arena);
+
+  // Returns whether the field is set, as `has()` in CEL would.
+  bool (*has)(const google::protobuf::Message& message);
+};
+
+// Returns the arena that values borrowed from `message` should be attributed
+// to.
+inline google::protobuf::Arena* absl_nonnull GeneratedFieldArena(
+    const google::protobuf::Message& message, google::protobuf::Arena* absl_nonnull arena) {
+  google::protobuf::Arena* absl_nullable message_arena = message.GetArena();
+  return message_arena != nullptr ? message_arena : arena;
+}
+
+}  // namespace cel
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_GENERATED_MESSAGE_ACCESSORS_H_
@@ -0,0 +1,125 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/generated_message_accessors.h"
+
+#include "absl/base/nullability.h"
+#include "absl/strings/string_view.h"
+#include "common/value.h"
+#include "internal/testing.h"
+#include "runtime/test_all_types_accessors.h"
+#include "runtime/type_registry.h"
+#include "cel/expr/conformance/proto3/test_all_types.pb.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/dynamic_message.h"
+#include "google/protobuf/message.h"
+
+namespace cel {
+namespace {
+
+using ::cel::expr::conformance::proto3::TestAllTypes;
+using ::testing::IsNull;
+using ::testing::NotNull;
+
+class GeneratedMessageAccessorsTest : public ::testing::Test {
+ protected:
+  GeneratedMessageAccessorsTest() {
+    runtime_internal::RegisterTestAllTypesAccessors(registry_);
+  }
+
+  const GeneratedFieldAccessor* absl_nullable Find(absl::string_view name) {
+    const auto* field = TestAllTypes::descriptor()->FindFieldByName(name);
+    return registry_.FindGeneratedFieldAccessor(
+        TestAllTypes::descriptor()->full_name(), field->number());
+  }
+
+  // Checks that the generated accessor for `name` agrees with reflection.
+  void ExpectMatchesReflection(const TestAllTypes& message,
+                               absl::string_view name) {
+    SCOPED_TRACE(name);
+    const GeneratedFieldAccessor* accessor = Find(name);
+    ASSERT_THAT(accessor, NotNull());
+    ASSERT_TRUE(accessor->is_instance(message));
+    const auto* field = TestAllTypes::descriptor()->FindFieldByName(name);
+    Value expected = Value::WrapField(
+        &message, field, google::protobuf::DescriptorPool::generated_pool(),
+        google::protobuf::MessageFactory::generated_factory(), &arena_);
+    Value actual = accessor->get(
+        message, google::protobuf::DescriptorPool::generated_pool(),
+        google::protobuf::MessageFactory::generated_factory(), &arena_);
+    EXPECT_EQ(actual.DebugString(), expected.DebugString());
+    EXPECT_EQ(accessor->has(message),
+              message.GetReflection()->HasField(message, field));
+  }
+
+  google::protobuf::Arena arena_;
+  TypeRegistry registry_;
+};
+
+TEST_F(GeneratedMessageAccessorsTest, MatchesReflection) {
+  auto* message = google::protobuf::Arena::Create<TestAllTypes>(&arena_);
+  for (absl::string_view name :
+       {"single_int32", "single_int64", "single_uint32", "single_uint64",
+        "single_sint32", "single_fixed64", "single_float", "single_double",
+        "single_bool", "single_string", "single_bytes", "standalone_enum",
+        "single_nested_message", "single_nested_enum"}) {
+    ExpectMatchesReflection(*message, name);
+  }
+
+  message->set_single_int32(-1);
+  message->set_single_int64(-2);
+  message->set_single_uint32(3);
+  message->set_single_uint64(4);
+  message->set_single_sint32(-5);
+  message->set_single_fixed64(6);
+  message->set_single_float(-0.0f);
+  message->set_single_double(7.5);
+  message->set_single_bool(true);
+  message->set_single_string("foo");
+  message->set_single_bytes("bar");
+  message->set_standalone_enum(TestAllTypes::BAR);
+  message->mutable_single_nested_message()->set_bb(8);
+  message->set_single_nested_enum(TestAllTypes::BAZ);
+  for (absl::string_view name :
+       {"single_int32", "single_int64", "single_uint32", "single_uint64",
+        "single_sint32", "single_fixed64", "single_float", "single_double",
+        "single_bool", "single_string", "single_bytes", "standalone_enum",
+        "single_nested_message", "single_nested_enum"}) {
+    ExpectMatchesReflection(*message, name);
+  }
+}
+
+TEST_F(GeneratedMessageAccessorsTest, LeavesOtherFieldsToReflection) {
+  EXPECT_THAT(Find("repeated_int64"), IsNull());
+  EXPECT_THAT(Find("map_string_string"), IsNull());
+  EXPECT_THAT(Find("single_int64_wrapper"), IsNull());
+  EXPECT_THAT(Find("single_any"), IsNull());
+  EXPECT_THAT(Find("single_timestamp"), IsNull());
+  EXPECT_THAT(registry_.FindGeneratedFieldAccessor(
+                  TestAllTypes::NestedMessage::descriptor()->full_name(), 1),
+              IsNull());
+}
+
+TEST_F(GeneratedMessageAccessorsTest, DynamicMessageIsNotAnInstance) {
+  google::protobuf::DynamicMessageFactory factory;
+  const google::protobuf::Message* prototype =
+      factory.GetPrototype(TestAllTypes::descriptor());
+  const GeneratedFieldAccessor* accessor = Find("single_int64");
+  ASSERT_THAT(accessor, NotNull());
+  EXPECT_FALSE(accessor->is_instance(*prototype));
+}
+
+}  // namespace
+}  // namespace cel
@@ -25,6 +25,7 @@
 #include "base/function_adapter.h"
 #include "common/value.h"
 #include "common/values/list_value_builder.h"
+#include "common/values/persistent_list_value.h"
 #include "internal/status_macros.h"
 #include "runtime/function_registry.h"
 #include "runtime/runtime_options.h"
@@ -78,6 +79,24 @@ absl::StatusOr<ListValue> ConcatList(
   return std::move(*list_builder).Build();
 }
 
+// Concatenation for CelList type, sharing structure with `value1`.
+absl::StatusOr<ListValue> PersistentConcatList(
+    const ListValue& value1, const ListValue& value2,
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena) {
+  CEL_ASSIGN_OR_RETURN(auto size1, value1.Size());
+  if (size1 == 0) {
+    return value2;
+  }
+  CEL_ASSIGN_OR_RETURN(auto size2, value2.Size());
+  if (size2 == 0) {
+    return value1;
+  }
+  return common_internal::PersistentListConcat(
+      value1, value2, descriptor_pool, message_factory, arena);
+}
+
 // AppendList will append the elements in value2 to value1.
 //
 // This call will only be invoked within comprehensions where `value1` is an
@@ -121,7 +140,9 @@ absl::Status RegisterContainerFunctions(FunctionRegistry& registry,
             absl::StatusOr<Value>, const ListValue&,
             const ListValue&>::CreateDescriptor(cel::builtin::kAdd, false),
         BinaryFunctionAdapter<absl::StatusOr<Value>, const ListValue&,
-                              const ListValue&>::WrapFunction(ConcatList)));
+                              const ListValue&>::WrapFunction(
+            options.enable_persistent_collections ? &PersistentConcatList
+                                                  : &ConcatList)));
   }
 
   return registry.Register(
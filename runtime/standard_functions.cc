@@ -14,6 +14,11 @@
 
 #include "runtime/standard_functions.h"
 
+#include <array>
+#include <cstddef>
+
+#include "absl/base/call_once.h"
+#include "absl/base/no_destructor.h"
 #include "absl/status/status.h"
 #include "internal/status_macros.h"
 #include "runtime/function_registry.h"
@@ -31,14 +36,43 @@
 
 namespace cel {
 
-absl::Status RegisterStandardFunctions(FunctionRegistry& registry,
-                                       const RuntimeOptions& options) {
+namespace {
+
+// The standard functions depend only on these options, except for `matches`,
+// which captures `regex_max_program_size` and is registered separately. An
+// option read by any of the other functions must be added here.
+size_t StandardFunctionSetIndex(const RuntimeOptions& options) {
+  size_t index = 0;
+  for (bool enabled : {options.enable_fast_builtins,
+                       options.enable_heterogeneous_equality,
+                       options.enable_list_concat,
+                       options.enable_list_contains,
+                       options.enable_persistent_collections,
+                       options.enable_string_concat,
+                       options.enable_string_conversion,
+                       options.enable_timestamp_duration_overflow_errors}) {
+    index = index * 2 + (enabled ? 1 : 0);
+  }
+  return index;
+}
+
+constexpr size_t kStandardFunctionSetCount = size_t{1} << 8;
+
+// The standard functions for one combination of options, built on first use
+// and never modified afterwards, so they can be read without locking.
+struct StandardFunctionSet {
+  absl::once_flag once;
+  absl::Status status;
+  FunctionRegistry registry;
+};
+
+absl::Status RegisterStandardFunctionSet(FunctionRegistry& registry,
+                                         const RuntimeOptions& options) {
   CEL_RETURN_IF_ERROR(RegisterArithmeticFunctions(registry, options));
   CEL_RETURN_IF_ERROR(RegisterComparisonFunctions(registry, options));
   CEL_RETURN_IF_ERROR(RegisterContainerFunctions(registry, options));
   CEL_RETURN_IF_ERROR(RegisterContainerMembershipFunctions(registry, options));
   CEL_RETURN_IF_ERROR(RegisterLogicalFunctions(registry, options));
-  CEL_RETURN_IF_ERROR(RegisterRegexFunctions(registry, options));
   CEL_RETURN_IF_ERROR(RegisterStringFunctions(registry, options));
   CEL_RETURN_IF_ERROR(RegisterTimeFunctions(registry, options));
   CEL_RETURN_IF_ERROR(RegisterEqualityFunctions(registry, options));
@@ -46,4 +80,29 @@ absl::Status RegisterStandardFunctions(FunctionRegistry& registry,
   return RegisterTypeConversionFunctions(registry, options);
 }
 
+const StandardFunctionSet& GetStandardFunctionSet(
+    const RuntimeOptions& options) {
+  static absl::NoDestructor<
+      std::array<StandardFunctionSet, kStandardFunctionSetCount>>
+      sets;
+  StandardFunctionSet& set = (*sets)[StandardFunctionSetIndex(options)];
+  absl::call_once(set.once, [&set, &options]() {
+    set.status = RegisterStandardFunctionSet(set.registry, options);
+  });
+  return set;
+}
+
+}  // namespace
+
+absl::Status RegisterStandardFunctions(FunctionRegistry& registry,
+                                       const RuntimeOptions& options) {
+  // Share the function implementations across registries instead of
+  // creating them for each one.
+  const StandardFunctionSet& set = GetStandardFunctionSet(options);
+  CEL_RETURN_IF_ERROR(set.status);
+  CEL_RETURN_IF_ERROR(registry.RegisterAll(set.registry));
+
+  return RegisterRegexFunctions(registry, options);
+}
+
 }  // namespace cel
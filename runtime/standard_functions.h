@@ -23,6 +23,9 @@ namespace cel {
 
 // Register all CEL standard definitions.
 //
+// The function implementations are created once per combination of the
+// options they depend on and shared by every registry they are registered in.
+//
 // See
 // https://github.com/google/cel-spec/blob/master/doc/langdef.md#standard-definitions
 absl::Status RegisterStandardFunctions(FunctionRegistry& registry,
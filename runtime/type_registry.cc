@@ -14,6 +14,7 @@
 
 #include "runtime/type_registry.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
@@ -21,10 +22,13 @@
 
 #include "absl/base/nullability.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/log/absl_check.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
 #include "common/value.h"
+#include "runtime/generated_message_accessors.h"
 #include "runtime/internal/legacy_runtime_type_provider.h"
 #include "google/protobuf/descriptor.h"
 #include "google/protobuf/message.h"
@@ -51,6 +55,35 @@ void TypeRegistry::RegisterEnum(absl::string_view enum_name,
       Enumeration{std::string(enum_name), std::move(enumerators)};
 }
 
+void TypeRegistry::RegisterGeneratedMessageAccessors(
+    absl::string_view message_name,
+    absl::Span<const GeneratedFieldAccessor> fields) {
+  ABSL_DCHECK(std::is_sorted(fields.begin(), fields.end(),
+                             [](const GeneratedFieldAccessor& lhs,
+                                const GeneratedFieldAccessor& rhs) {
+                               return lhs.number < rhs.number;
+                             }));
+  generated_message_accessors_[message_name] = fields;
+}
+
+const GeneratedFieldAccessor* absl_nullable
+TypeRegistry::FindGeneratedFieldAccessor(absl::string_view message_name,
+                                         int number) const {
+  auto it = generated_message_accessors_.find(message_name);
+  if (it == generated_message_accessors_.end()) {
+    return nullptr;
+  }
+  auto field = std::lower_bound(
+      it->second.begin(), it->second.end(), number,
+      [](const GeneratedFieldAccessor& accessor, int number) {
+        return accessor.number < number;
+      });
+  if (field == it->second.end() || field->number != number) {
+    return nullptr;
+  }
+  return &*field;
+}
+
 std::shared_ptr<const absl::flat_hash_map<std::string, Value>>
 TypeRegistry::GetEnumValueTable() const {
   {
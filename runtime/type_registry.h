@@ -26,9 +26,11 @@
 #include "absl/status/status.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
 #include "base/type_provider.h"
 #include "common/type.h"
 #include "common/value.h"
+#include "runtime/generated_message_accessors.h"
 #include "runtime/internal/legacy_runtime_type_provider.h"
 #include "runtime/internal/runtime_type_provider.h"
 #include "google/protobuf/descriptor.h"
@@ -98,6 +100,22 @@ class TypeRegistry {
     return enum_types_;
   }
 
+  // Registers field accessors generated for the message type `message_name`
+  // by the `cel_cc_message_accessors` build rule. `fields` must be sorted by
+  // field number and must outlive the registry, which generated code ensures.
+  //
+  // Where the type checker determined that the operand of a select is of this
+  // type, selecting one of these fields from an instance of the generated class
+  // then reads it directly instead of through reflection.
+  void RegisterGeneratedMessageAccessors(
+      absl::string_view message_name,
+      absl::Span<const GeneratedFieldAccessor> fields);
+
+  // Returns the generated accessor for field `number` of the message type
+  // `message_name`, or null if none was registered.
+  const GeneratedFieldAccessor* absl_nullable FindGeneratedFieldAccessor(
+      absl::string_view message_name, int number) const;
+
   // Returns the effective type provider.
   const TypeProvider& GetComposedTypeProvider() const { return type_provider_; }
 
@@ -119,6 +137,8 @@ class TypeRegistry {
   absl_nonnull std::shared_ptr<runtime_internal::LegacyRuntimeTypeProvider>
       legacy_type_provider_;
   absl::flat_hash_map<std::string, Enumeration> enum_types_;
+  absl::flat_hash_map<std::string, absl::Span<const GeneratedFieldAccessor>>
+      generated_message_accessors_;
 
   // memoized fully qualified enumerator names.
   //
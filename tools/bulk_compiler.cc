@@ -0,0 +1,131 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tools/bulk_compiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "checker/validation_result.h"
+#include "common/ast.h"
+#include "common/source.h"
+#include "compiler/compiler.h"
+#include "internal/status_macros.h"
+#include "runtime/runtime.h"
+
+namespace cel {
+
+namespace {
+
+class Worker {
+ public:
+  Worker(const Compiler& compiler, const Runtime& runtime)
+      : compiler_(compiler), runtime_(runtime) {}
+
+  absl::StatusOr<std::unique_ptr<TraceableProgram>> Compile(
+      const std::string& expression) {
+    absl::Time start = absl::Now();
+    CEL_ASSIGN_OR_RETURN(auto source, NewSource(expression));
+    absl::StatusOr<std::unique_ptr<Ast>> parsed =
+        compiler_.GetParser().Parse(*source);
+    absl::Time parsed_time = absl::Now();
+    timings_.parse += parsed_time - start;
+    if (!parsed.ok()) {
+      return std::move(parsed).status();
+    }
+
+    absl::StatusOr<ValidationResult> checked =
+        compiler_.GetTypeChecker().Check(*std::move(parsed));
+    absl::Time checked_time = absl::Now();
+    timings_.check += checked_time - parsed_time;
+    if (!checked.ok()) {
+      return std::move(checked).status();
+    }
+    if (!checked->IsValid()) {
+      checked->SetSource(std::move(source));
+      return absl::InvalidArgumentError(checked->FormatError());
+    }
+    CEL_ASSIGN_OR_RETURN(std::unique_ptr<Ast> ast, checked->ReleaseAst());
+
+    auto program = runtime_.CreateTraceableProgram(std::move(ast));
+    timings_.plan += absl::Now() - checked_time;
+    return program;
+  }
+
+  const BulkCompileTimings& timings() const { return timings_; }
+
+ private:
+  const Compiler& compiler_;
+  const Runtime& runtime_;
+  BulkCompileTimings timings_;
+};
+
+}  // namespace
+
+BulkCompileResult BulkCompile(const Compiler& compiler, const Runtime& runtime,
+                              absl::Span<const std::string> sources,
+                              const BulkCompileOptions& options) {
+  absl::Time start = absl::Now();
+
+  BulkCompileResult result;
+  result.programs.resize(sources.size());
+
+  size_t num_threads = options.num_threads > 0
+                           ? static_cast<size_t>(options.num_threads)
+                           : std::max(1u, std::thread::hardware_concurrency());
+  num_threads = std::max<size_t>(1, std::min(num_threads, sources.size()));
+
+  std::vector<Worker> workers(num_threads, Worker(compiler, runtime));
+  std::atomic<size_t> next_source = 0;
+  auto run = [&](Worker& worker) {
+    for (size_t i = next_source.fetch_add(1, std::memory_order_relaxed);
+         i < sources.size();
+         i = next_source.fetch_add(1, std::memory_order_relaxed)) {
+      result.programs[i] = worker.Compile(sources[i]);
+    }
+  };
+
+  // The calling thread acts as the first worker.
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads - 1);
+  for (size_t i = 1; i < num_threads; ++i) {
+    threads.emplace_back(run, std::ref(workers[i]));
+  }
+  run(workers[0]);
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  for (const Worker& worker : workers) {
+    result.timings.parse += worker.timings().parse;
+    result.timings.check += worker.timings().check;
+    result.timings.plan += worker.timings().plan;
+  }
+  result.timings.wall = absl::Now() - start;
+  return result;
+}
+
+}  // namespace cel
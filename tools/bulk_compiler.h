@@ -0,0 +1,65 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_TOOLS_BULK_COMPILER_H_
+#define THIRD_PARTY_CEL_CPP_TOOLS_BULK_COMPILER_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "compiler/compiler.h"
+#include "runtime/runtime.h"
+
+namespace cel {
+
+struct BulkCompileOptions {
+  // Number of worker threads. If zero, uses the hardware concurrency.
+  int num_threads = 0;
+};
+
+// Time spent in each phase, summed over all expressions and worker threads.
+struct BulkCompileTimings {
+  absl::Duration parse;
+  absl::Duration check;
+  absl::Duration plan;
+  // Elapsed time for the whole batch.
+  absl::Duration wall;
+};
+
+struct BulkCompileResult {
+  // One entry per source, in input order.
+  //
+  // Expressions that fail to parse or type check have an InvalidArgument
+  // error with the formatted issues. Planning errors are returned as is.
+  std::vector<absl::StatusOr<std::unique_ptr<TraceableProgram>>> programs;
+  BulkCompileTimings timings;
+};
+
+// Parses, type checks and plans each of `sources` with `compiler` and
+// `runtime`, distributing the expressions over a pool of worker threads.
+//
+// The compiler and runtime are shared by all workers, so their type and
+// function environments are built once for the whole batch. Both must be
+// fully built and must not be modified while the call is in progress.
+BulkCompileResult BulkCompile(const Compiler& compiler, const Runtime& runtime,
+                              absl::Span<const std::string> sources,
+                              const BulkCompileOptions& options = {});
+
+}  // namespace cel
+
+#endif  // THIRD_PARTY_CEL_CPP_TOOLS_BULK_COMPILER_H_
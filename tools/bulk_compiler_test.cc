@@ -0,0 +1,126 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tools/bulk_compiler.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/time/time.h"
+#include "checker/standard_library.h"
+#include "common/decl.h"
+#include "common/type.h"
+#include "common/value.h"
+#include "compiler/compiler.h"
+#include "compiler/compiler_factory.h"
+#include "internal/testing.h"
+#include "internal/testing_descriptor_pool.h"
+#include "runtime/activation.h"
+#include "runtime/runtime.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_runtime_builder_factory.h"
+#include "google/protobuf/arena.h"
+
+namespace cel {
+namespace {
+
+using ::absl_testing::IsOk;
+using ::absl_testing::StatusIs;
+using ::testing::Ge;
+using ::testing::HasSubstr;
+using ::testing::SizeIs;
+
+class BulkCompilerTest : public ::testing::TestWithParam<int> {
+ protected:
+  void SetUp() override {
+    ASSERT_OK_AND_ASSIGN(
+        auto compiler_builder,
+        NewCompilerBuilder(internal::GetTestingDescriptorPool()));
+    ASSERT_THAT(compiler_builder->AddLibrary(StandardCheckerLibrary()),
+                IsOk());
+    ASSERT_THAT(compiler_builder->GetCheckerBuilder().AddVariable(
+                    MakeVariableDecl("x", IntType())),
+                IsOk());
+    ASSERT_OK_AND_ASSIGN(compiler_, std::move(*compiler_builder).Build());
+
+    ASSERT_OK_AND_ASSIGN(
+        auto runtime_builder,
+        CreateStandardRuntimeBuilder(internal::GetTestingDescriptorPool(),
+                                     RuntimeOptions()));
+    ASSERT_OK_AND_ASSIGN(runtime_, std::move(runtime_builder).Build());
+  }
+
+  std::unique_ptr<Compiler> compiler_;
+  std::unique_ptr<const Runtime> runtime_;
+};
+
+TEST_P(BulkCompilerTest, CompilesInInputOrder) {
+  std::vector<std::string> sources;
+  for (int i = 0; i < 200; ++i) {
+    sources.push_back(absl::StrCat("x + ", i));
+  }
+  sources[17] = "x + 'string'";
+  sources[42] = "x +";
+
+  BulkCompileOptions options;
+  options.num_threads = GetParam();
+  BulkCompileResult result =
+      BulkCompile(*compiler_, *runtime_, sources, options);
+  ASSERT_THAT(result.programs, SizeIs(sources.size()));
+
+  EXPECT_THAT(result.programs[17],
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("no matching overload")));
+  EXPECT_THAT(result.programs[42],
+              StatusIs(absl::StatusCode::kInvalidArgument));
+
+  google::protobuf::Arena arena;
+  Activation activation;
+  activation.InsertOrAssignValue("x", IntValue(1000));
+  for (size_t i = 0; i < sources.size(); ++i) {
+    if (i == 17 || i == 42) {
+      continue;
+    }
+    ASSERT_THAT(result.programs[i], IsOk()) << sources[i];
+    ASSERT_OK_AND_ASSIGN(Value value,
+                         (*result.programs[i])->Evaluate(&arena, activation));
+    ASSERT_TRUE(value.IsInt());
+    EXPECT_EQ(value.GetInt().NativeValue(), 1000 + static_cast<int64_t>(i));
+  }
+
+  EXPECT_THAT(result.timings.parse, Ge(absl::ZeroDuration()));
+  EXPECT_THAT(result.timings.check, Ge(absl::ZeroDuration()));
+  EXPECT_THAT(result.timings.plan, Ge(absl::ZeroDuration()));
+  EXPECT_GT(result.timings.wall, absl::ZeroDuration());
+}
+
+TEST_P(BulkCompilerTest, EmptyBatch) {
+  BulkCompileOptions options;
+  options.num_threads = GetParam();
+  BulkCompileResult result = BulkCompile(*compiler_, *runtime_, {}, options);
+  EXPECT_THAT(result.programs, SizeIs(0));
+}
+
+INSTANTIATE_TEST_SUITE_P(BulkCompilerTest, BulkCompilerTest,
+                         testing::Values(0, 1, 4));
+
+}  // namespace
+}  // namespace cel
@@ -21,60 +21,51 @@
 #include "cel/expr/syntax.pb.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/strings/str_join.h"
-#include "tools/navigable_ast.h"
+#include "common/ast/expr_proto.h"
+#include "common/expr.h"
+#include "common/flat_ast.h"
 
 namespace cel {
 
 namespace {
 
-bool IsComprehensionDefinedField(const cel::NavigableProtoAstNode& node) {
-  const cel::NavigableProtoAstNode* current_node = &node;
-
-  while (current_node->parent() != nullptr) {
-    current_node = current_node->parent();
-
-    if (current_node->node_kind() != cel::NodeKind::kComprehension) {
+bool IsComprehensionDefinedField(const FlatAst& ast, FlatAst::NodeIndex node) {
+  const std::string& ident_name = ast.expr(node).ident_expr().name();
+  for (FlatAst::NodeIndex current = ast.parent(node);
+       current != FlatAst::kNoNode; current = ast.parent(current)) {
+    if (ast.node_kind(current) != cel::NodeKind::kComprehension) {
       continue;
     }
-
-    std::string ident_name = node.expr()->ident_expr().name();
-    bool iter_var_match =
-        ident_name == current_node->expr()->comprehension_expr().iter_var();
-    bool iter_var2_match =
-        ident_name == current_node->expr()->comprehension_expr().iter_var2();
-    bool accu_var_match =
-        ident_name == current_node->expr()->comprehension_expr().accu_var();
-
-    if (iter_var_match || iter_var2_match || accu_var_match) {
+    const auto& comprehension = ast.expr(current).comprehension_expr();
+    if (ident_name == comprehension.iter_var() ||
+        ident_name == comprehension.iter_var2() ||
+        ident_name == comprehension.accu_var()) {
       return true;
     }
   }
-
   return false;
 }
 
 }  // namespace
 
-absl::flat_hash_set<std::string> ExtractFieldPaths(
-    const cel::expr::Expr& expr) {
-  NavigableProtoAst ast = NavigableProtoAst::Build(expr);
+absl::flat_hash_set<std::string> ExtractFieldPaths(const Expr& expr) {
+  FlatAst ast = FlatAst::Build(expr);
 
   absl::flat_hash_set<std::string> field_paths;
   std::vector<std::string> fields_in_scope;
 
-  // Preorder traversal works because the select nodes (in a well-formed
-  // expression) always have only one operand, so its operand is visited
-  // next in the loop iteration (which results in the path being extended,
-  // completed, or discarded if uninteresting).
-  for (const cel::NavigableProtoAstNode& node :
-       ast.Root().DescendantsPreorder()) {
-    if (node.node_kind() == cel::NodeKind::kSelect) {
-      fields_in_scope.push_back(node.expr()->select_expr().field());
+  // Nodes are numbered in preorder. Preorder traversal works because the
+  // select nodes (in a well-formed expression) always have only one operand,
+  // so its operand is visited next in the loop iteration (which results in
+  // the path being extended, completed, or discarded if uninteresting).
+  for (FlatAst::NodeIndex node = 0; node < ast.size(); ++node) {
+    if (ast.node_kind(node) == cel::NodeKind::kSelect) {
+      fields_in_scope.push_back(ast.expr(node).select_expr().field());
       continue;
     }
-    if (node.node_kind() == cel::NodeKind::kIdent &&
-        !IsComprehensionDefinedField(node)) {
-      fields_in_scope.push_back(node.expr()->ident_expr().name());
+    if (ast.node_kind(node) == cel::NodeKind::kIdent &&
+        !IsComprehensionDefinedField(ast, node)) {
+      fields_in_scope.push_back(ast.expr(node).ident_expr().name());
       std::reverse(fields_in_scope.begin(), fields_in_scope.end());
       field_paths.insert(absl::StrJoin(fields_in_scope, "."));
     }
@@ -84,4 +75,13 @@ absl::flat_hash_set<std::string> ExtractFieldPaths(
   return field_paths;
 }
 
+absl::flat_hash_set<std::string> ExtractFieldPaths(
+    const cel::expr::Expr& expr) {
+  Expr native_expr;
+  if (!ast_internal::ExprFromProto(expr, native_expr).ok()) {
+    return {};
+  }
+  return ExtractFieldPaths(native_expr);
+}
+
 }  // namespace cel
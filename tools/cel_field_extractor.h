@@ -19,6 +19,7 @@
 
 #include "cel/expr/syntax.pb.h"
 #include "absl/container/flat_hash_set.h"
+#include "common/expr.h"
 
 namespace cel {
 
@@ -62,6 +63,10 @@ namespace cel {
 //   - "request.user.attributes" (because `attr` is a comprehension variable)
 //   - "request.items"
 
+absl::flat_hash_set<std::string> ExtractFieldPaths(const Expr& expr);
+
+// As above, for an expression in its protobuf representation. Returns an
+// empty set if `expr` is malformed.
 absl::flat_hash_set<std::string> ExtractFieldPaths(
     const cel::expr::Expr& expr);
 
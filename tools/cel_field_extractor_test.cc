@@ -20,6 +20,8 @@
 #include "absl/container/flat_hash_set.h"
 #include "absl/log/absl_check.h"
 #include "absl/status/statusor.h"
+#include "common/ast/expr_proto.h"
+#include "common/expr.h"
 #include "internal/testing.h"
 #include "parser/parser.h"
 
@@ -36,7 +38,13 @@ absl::flat_hash_set<std::string> GetExtractedFields(
     const std::string& cel_query) {
   absl::StatusOr<ParsedExpr> parsed_expr_or_status = Parse(cel_query);
   ABSL_CHECK_OK(parsed_expr_or_status);
-  return ExtractFieldPaths(parsed_expr_or_status.value().expr());
+  const cel::expr::Expr& expr = parsed_expr_or_status.value().expr();
+  absl::flat_hash_set<std::string> field_paths = ExtractFieldPaths(expr);
+  // The native overload must agree with the protobuf one.
+  Expr native_expr;
+  ABSL_CHECK_OK(ast_internal::ExprFromProto(expr, native_expr));
+  EXPECT_EQ(ExtractFieldPaths(native_expr), field_paths);
+  return field_paths;
 }
 
 TEST(TestExtractFieldPaths, CelExprWithOneField) {